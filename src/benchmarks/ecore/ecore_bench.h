@@ -0,0 +1,8 @@
+#ifndef ECORE_BENCH_H_
+#define ECORE_BENCH_H_
+
+void ecore_bench_timer(Eina_Benchmark *bench);
+void ecore_bench_main_loop(Eina_Benchmark *bench);
+void ecore_bench_future(Eina_Benchmark *bench);
+
+#endif
@@ -0,0 +1,76 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+
+#include <Eina.h>
+
+#include "Ecore.h"
+#include "ecore_bench.h"
+
+/* PROMISES promises each get a chain of REQUEST thens, like the 3 to 5
+ * futures chained per request by the I/O code. All promises are resolved
+ * before the main loop runs, so their futures are delivered as one batch. */
+
+#define PROMISES 1000
+
+static int _delivered = 0;
+
+static void
+_cancel_cb(void *data EINA_UNUSED, const Eina_Promise *dead EINA_UNUSED)
+{
+}
+
+static Eina_Value
+_then_cb(void *data EINA_UNUSED, const Eina_Value value, const Eina_Future *dead EINA_UNUSED)
+{
+   int v = 0;
+
+   eina_value_get(&value, &v);
+   return eina_value_int_init(v + 1);
+}
+
+static Eina_Value
+_last_cb(void *data EINA_UNUSED, const Eina_Value value, const Eina_Future *dead EINA_UNUSED)
+{
+   _delivered++;
+   return value;
+}
+
+static void
+ecore_bench_future_chain(int request)
+{
+   Eina_Future_Scheduler *sched;
+   Eina_Promise **promises;
+   int i, j;
+
+   promises = calloc(PROMISES, sizeof (Eina_Promise *));
+   if (!promises) return;
+
+   sched = efl_loop_future_scheduler_get(efl_main_loop_get());
+   for (i = 0; i < PROMISES; i++)
+     {
+        Eina_Future *f;
+
+        promises[i] = eina_promise_new(sched, _cancel_cb, NULL);
+        f = eina_future_new(promises[i]);
+        for (j = 0; j < request; j++)
+          f = eina_future_then(f, _then_cb, NULL);
+        eina_future_then(f, _last_cb, NULL);
+     }
+
+   _delivered = 0;
+   for (i = 0; i < PROMISES; i++)
+     eina_promise_resolve(promises[i], eina_value_int_init(i));
+   while (_delivered < PROMISES)
+     ecore_main_loop_iterate();
+
+   free(promises);
+}
+
+void ecore_bench_future(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "future-chain",
+                           EINA_BENCHMARK(ecore_bench_future_chain), 1, 11, 1);
+}
@@ -0,0 +1,147 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include <Eina.h>
+
+#include "Ecore.h"
+#include "ecore_bench.h"
+
+/* REQUEST connected sockets are watched for reading, like the clients of a
+ * server. Only a few of them get data on each main loop iteration, the
+ * others stay idle. Run once as is and once with ECORE_IO_URING=1 to
+ * compare the epoll and io_uring main loop backends. */
+
+#define ITERATIONS 100
+#define ACTIVE_EVERY 16
+
+typedef struct _Bench_Socket Bench_Socket;
+struct _Bench_Socket
+{
+   int fds[2];
+   Ecore_Fd_Handler *handler;
+};
+
+static int _received = 0;
+
+static Eina_Bool
+_socket_read_cb(void *data EINA_UNUSED, Ecore_Fd_Handler *handler)
+{
+   char c;
+
+   if (read(ecore_main_fd_handler_fd_get(handler), &c, 1) == 1)
+     _received++;
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_socket_write_cb(void *data EINA_UNUSED, Ecore_Fd_Handler *handler)
+{
+   // like a connection that flushed its output, stop watching for writes
+   if (write(ecore_main_fd_handler_fd_get(handler), "y", 1) == 1)
+     _received++;
+   ecore_main_fd_handler_active_set(handler, ECORE_FD_READ);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static void
+_nofile_raise(int request)
+{
+   struct rlimit rl;
+
+   if (getrlimit(RLIMIT_NOFILE, &rl) < 0) return;
+   if (rl.rlim_cur >= (rlim_t)(request * 2 + 64)) return;
+   rl.rlim_cur = request * 2 + 64;
+   if (rl.rlim_cur > rl.rlim_max) rl.rlim_cur = rl.rlim_max;
+   setrlimit(RLIMIT_NOFILE, &rl);
+}
+
+static void
+ecore_bench_main_loop_sockets(int request)
+{
+   Bench_Socket *sockets;
+   int i, n, r;
+
+   _nofile_raise(request);
+   sockets = calloc(request, sizeof (Bench_Socket));
+   if (!sockets) return;
+
+   for (n = 0; n < request; n++)
+     {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets[n].fds) < 0) break;
+        sockets[n].handler = ecore_main_fd_handler_add(sockets[n].fds[0],
+                                                       ECORE_FD_READ,
+                                                       _socket_read_cb, NULL,
+                                                       NULL, NULL);
+     }
+
+   _received = 0;
+   for (r = 0; r < ITERATIONS; r++)
+     {
+        for (i = r % ACTIVE_EVERY; i < n; i += ACTIVE_EVERY)
+          if (write(sockets[i].fds[1], "x", 1) != 1) break;
+        ecore_main_loop_iterate();
+     }
+
+   for (i = 0; i < n; i++)
+     {
+        ecore_main_fd_handler_del(sockets[i].handler);
+        close(sockets[i].fds[0]);
+        close(sockets[i].fds[1]);
+     }
+   free(sockets);
+}
+
+/* Same sockets, but instead of getting data a few of them queue output on
+ * each iteration and watch for writes until it is flushed, which changes
+ * the handler flags twice. */
+static void
+ecore_bench_main_loop_write_toggle(int request)
+{
+   Bench_Socket *sockets;
+   int i, n, r;
+
+   _nofile_raise(request);
+   sockets = calloc(request, sizeof (Bench_Socket));
+   if (!sockets) return;
+
+   for (n = 0; n < request; n++)
+     {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets[n].fds) < 0) break;
+        sockets[n].handler = ecore_main_fd_handler_add(sockets[n].fds[0],
+                                                       ECORE_FD_READ,
+                                                       _socket_write_cb, NULL,
+                                                       NULL, NULL);
+     }
+
+   _received = 0;
+   for (r = 0; r < ITERATIONS; r++)
+     {
+        for (i = r % ACTIVE_EVERY; i < n; i += ACTIVE_EVERY)
+          ecore_main_fd_handler_active_set(sockets[i].handler,
+                                           ECORE_FD_READ | ECORE_FD_WRITE);
+        ecore_main_loop_iterate();
+     }
+
+   for (i = 0; i < n; i++)
+     {
+        ecore_main_fd_handler_del(sockets[i].handler);
+        close(sockets[i].fds[0]);
+        close(sockets[i].fds[1]);
+     }
+   free(sockets);
+}
+
+void ecore_bench_main_loop(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "main-loop-sockets",
+                           EINA_BENCHMARK(ecore_bench_main_loop_sockets), 1000, 10001, 1000);
+   eina_benchmark_register(bench, "main-loop-write-toggle",
+                           EINA_BENCHMARK(ecore_bench_main_loop_write_toggle), 1000, 10001, 1000);
+}
@@ -0,0 +1,134 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+
+#include <Eina.h>
+
+#include "Ecore.h"
+#include "ecore_bench.h"
+
+/* REQUEST timers are kept alive at the same time, like per connection
+ * inactivity timers in a server. They are added with intervals spread over
+ * a few seconds so that they never expire during the benchmark, then
+ * re-armed the way they would be on every received packet. */
+
+#define RESET_ROUNDS 10
+
+static Eina_Bool
+_timer_cb(void *data EINA_UNUSED)
+{
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Ecore_Timer **
+_timers_add(int request)
+{
+   Ecore_Timer **timers;
+   int i;
+
+   timers = malloc(request * sizeof (Ecore_Timer *));
+   if (!timers) return NULL;
+
+   for (i = 0; i < request; i++)
+     timers[i] = ecore_timer_add(10.0 + ((i * 7919) % 1000) / 100.0,
+                                 _timer_cb, NULL);
+   return timers;
+}
+
+static void
+_timers_del(Ecore_Timer **timers, int request)
+{
+   int i;
+
+   for (i = 0; i < request; i++)
+     ecore_timer_del(timers[i]);
+   free(timers);
+}
+
+static void
+ecore_bench_timer_add_del(int request)
+{
+   Ecore_Timer **timers;
+
+   timers = _timers_add(request);
+   if (!timers) return;
+
+   _timers_del(timers, request);
+}
+
+static void
+ecore_bench_timer_reset(int request)
+{
+   Ecore_Timer **timers;
+   int i, r;
+
+   timers = _timers_add(request);
+   if (!timers) return;
+
+   for (r = 0; r < RESET_ROUNDS; r++)
+     {
+        for (i = 0; i < request; i++)
+          ecore_timer_reset(timers[(i * 7919) % request]);
+        // let the loop take the re-armed timers into account
+        ecore_main_loop_iterate();
+     }
+
+   _timers_del(timers, request);
+}
+
+static void
+ecore_bench_timer_delay(int request)
+{
+   Ecore_Timer **timers;
+   int i, r;
+
+   timers = _timers_add(request);
+   if (!timers) return;
+
+   for (r = 0; r < RESET_ROUNDS; r++)
+     {
+        for (i = 0; i < request; i++)
+          ecore_timer_delay(timers[i], ((i * r) % 100) / 1000.0);
+        ecore_main_loop_iterate();
+     }
+
+   _timers_del(timers, request);
+}
+
+static int _expired = 0;
+
+static Eina_Bool
+_timer_expire_cb(void *data)
+{
+   int *request = data;
+
+   if (++_expired == *request) ecore_main_loop_quit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+ecore_bench_timer_expire(int request)
+{
+   int i;
+
+   // every timer expires within 10ms, many of them at once
+   _expired = 0;
+   for (i = 0; i < request; i++)
+     ecore_timer_add(((i * 7919) % 100) / 10000.0, _timer_expire_cb, &request);
+
+   ecore_main_loop_begin();
+}
+
+void ecore_bench_timer(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "timer-add-del",
+                           EINA_BENCHMARK(ecore_bench_timer_add_del), 10000, 100001, 10000);
+   eina_benchmark_register(bench, "timer-reset",
+                           EINA_BENCHMARK(ecore_bench_timer_reset), 10000, 100001, 10000);
+   eina_benchmark_register(bench, "timer-delay",
+                           EINA_BENCHMARK(ecore_bench_timer_delay), 10000, 100001, 10000);
+   eina_benchmark_register(bench, "timer-expire",
+                           EINA_BENCHMARK(ecore_bench_timer_expire), 10000, 100001, 10000);
+}
@@ -0,0 +1,6 @@
+#ifndef EET_BENCH_H_
+#define EET_BENCH_H_
+
+void eet_bench_write(Eina_Benchmark *bench);
+
+#endif
@@ -0,0 +1,163 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <Eina.h>
+
+#include "Eet.h"
+#include "eet_bench.h"
+
+/* Many small entries: the file is created with REQUEST entries, then a
+ * sixteenth of them is updated the way a configuration or cache file is,
+ * either with a full rewrite or by appending to the journal.
+ *
+ * Few huge entries: REQUEST compressible entries of HUGE_SIZE bytes are
+ * written, compressed in eet_write() or in parallel when the file is closed.
+ */
+
+#define SMALL_SIZE 100
+#define SMALL_ROUNDS 8
+#define HUGE_SIZE (4 * 1024 * 1024)
+
+static char *
+_tmp_file_new(void)
+{
+   Eina_Tmpstr *tmp = NULL;
+   char *path;
+   int fd;
+
+   fd = eina_file_mkstemp("eet_bench_XXXXXX.eet", &tmp);
+   if (fd < 0) return NULL;
+   close(fd);
+
+   path = strdup(tmp);
+   eina_tmpstr_del(tmp);
+
+   return path;
+}
+
+static void
+_data_fill(char *data, int size, int seed)
+{
+   int i;
+
+   /* compressible but not trivially so */
+   for (i = 0; i < size; i++)
+     data[i] = 'a' + ((i / 7 + seed + (i * seed) % 13) % 26);
+}
+
+static void
+_eet_bench_small(int request, Eina_Bool journal)
+{
+   char data[SMALL_SIZE];
+   char key[32];
+   char *path;
+   Eet_File *ef;
+   int i, r;
+
+   path = _tmp_file_new();
+   if (!path) return;
+
+   ef = eet_open(path, EET_FILE_MODE_WRITE);
+   if (!ef) goto end;
+   for (i = 0; i < request; i++)
+     {
+        snprintf(key, sizeof (key), "/config/%i", i);
+        _data_fill(data, sizeof (data), i);
+        eet_write(ef, key, data, sizeof (data), EINA_TRUE);
+     }
+   eet_close(ef);
+
+   for (r = 0; r < SMALL_ROUNDS; r++)
+     {
+        ef = eet_open(path, EET_FILE_MODE_READ_WRITE);
+        if (!ef) break;
+        eet_journal_set(ef, journal);
+        for (i = r; i < request; i += 16)
+          {
+             snprintf(key, sizeof (key), "/config/%i", i);
+             _data_fill(data, sizeof (data), i + r + 1);
+             eet_write(ef, key, data, sizeof (data), EINA_TRUE);
+          }
+        eet_close(ef);
+     }
+
+ end:
+   unlink(path);
+   free(path);
+}
+
+static void
+_eet_bench_huge(int request, Eina_Bool defer)
+{
+   char key[32];
+   char *data;
+   char *path;
+   Eet_File *ef;
+   int i;
+
+   data = malloc(HUGE_SIZE);
+   if (!data) return;
+
+   path = _tmp_file_new();
+   if (!path) goto end;
+
+   ef = eet_open(path, EET_FILE_MODE_WRITE);
+   if (ef)
+     {
+        eet_compression_defer_set(ef, defer);
+        for (i = 0; i < request; i++)
+          {
+             snprintf(key, sizeof (key), "/blob/%i", i);
+             _data_fill(data, HUGE_SIZE, i);
+             eet_write(ef, key, data, HUGE_SIZE, EET_COMPRESSION_DEFAULT);
+          }
+        eet_close(ef);
+     }
+
+   unlink(path);
+   free(path);
+ end:
+   free(data);
+}
+
+static void
+eet_bench_small_rewrite(int request)
+{
+   _eet_bench_small(request, EINA_FALSE);
+}
+
+static void
+eet_bench_small_journal(int request)
+{
+   _eet_bench_small(request, EINA_TRUE);
+}
+
+static void
+eet_bench_huge_inline(int request)
+{
+   _eet_bench_huge(request, EINA_FALSE);
+}
+
+static void
+eet_bench_huge_deferred(int request)
+{
+   _eet_bench_huge(request, EINA_TRUE);
+}
+
+void eet_bench_write(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "small-rewrite",
+                           EINA_BENCHMARK(eet_bench_small_rewrite), 1000, 20000, 1000);
+   eina_benchmark_register(bench, "small-journal",
+                           EINA_BENCHMARK(eet_bench_small_journal), 1000, 20000, 1000);
+   eina_benchmark_register(bench, "huge-inline",
+                           EINA_BENCHMARK(eet_bench_huge_inline), 1, 9, 1);
+   eina_benchmark_register(bench, "huge-deferred",
+                           EINA_BENCHMARK(eet_bench_huge_deferred), 1, 9, 1);
+}
@@ -40,12 +40,15 @@ static const Eina_Benchmark_Case etc[] = {
    { "Hash_Short_Key", eina_bench_crc_hash_short, EINA_TRUE },
    { "Hash_Medium_Key", eina_bench_crc_hash_medium, EINA_TRUE },
    { "Hash_Large_key", eina_bench_crc_hash_large, EINA_TRUE },
+   { "Hash_Flat", eina_bench_hash_flat, EINA_TRUE },
    { "Array vs List vs Inlist", eina_bench_array, EINA_TRUE },
    { "Stringshare", eina_bench_stringshare, EINA_TRUE },
    { "Convert", eina_bench_convert, EINA_TRUE },
    { "Sort", eina_bench_sort, EINA_TRUE },
    { "Mempool", eina_bench_mempool, EINA_TRUE },
+   { "Mempool_Threads", eina_bench_mempool_threads, EINA_TRUE },
    { "Rectangle_Pool", eina_bench_rectangle_pool, EINA_TRUE },
+   { "Thread_Queue", eina_bench_thread_queue, EINA_TRUE },
    { "Render Loop", eina_bench_quadtree, EINA_FALSE },
    { NULL, NULL, EINA_FALSE }
 };
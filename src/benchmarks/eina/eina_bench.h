@@ -24,6 +24,7 @@
 int key_size;
 
 void eina_bench_hash(Eina_Benchmark *bench);
+void eina_bench_hash_flat(Eina_Benchmark *bench);
 void eina_bench_crc_hash_short(Eina_Benchmark *bench);
 void eina_bench_crc_hash_medium(Eina_Benchmark *bench);
 void eina_bench_crc_hash_large(Eina_Benchmark *bench);
@@ -32,7 +33,9 @@ void eina_bench_stringshare(Eina_Benchmark *bench);
 void eina_bench_convert(Eina_Benchmark *bench);
 void eina_bench_sort(Eina_Benchmark *bench);
 void eina_bench_mempool(Eina_Benchmark *bench);
+void eina_bench_mempool_threads(Eina_Benchmark *bench);
 void eina_bench_rectangle_pool(Eina_Benchmark *bench);
+void eina_bench_thread_queue(Eina_Benchmark *bench);
 void eina_bench_quadtree(Eina_Benchmark *bench);
 void eina_bench_promise(Eina_Benchmark *bench);
 
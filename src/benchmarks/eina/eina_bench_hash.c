@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include <time.h>
 
 #ifdef EINA_BENCH_HAVE_GLIB
@@ -37,6 +38,7 @@
 #include "eina_bench.h"
 #include "eina_rbtree.h"
 #include "eina_convert.h"
+#include "eina_counter.h"
 
 #ifdef CITYHASH_BENCH
 // Hash function for a byte array.
@@ -514,6 +516,156 @@ eina_bench_lookup_ecore(int request)
    ecore_hash_destroy(hash);
 }
 
+typedef enum _Eina_Bench_Hash_Op
+{
+   EINA_BENCH_HASH_INSERT,
+   EINA_BENCH_HASH_LOOKUP,
+   EINA_BENCH_HASH_DELETE,
+   EINA_BENCH_HASH_ITERATE
+} Eina_Bench_Hash_Op;
+
+static Eina_Hash *
+_eina_bench_hash_populate(Eina_Bool flat, unsigned int count)
+{
+   Eina_Hash *hash;
+   unsigned int i;
+
+   if (flat) hash = eina_hash_string_flat_new(NULL);
+   else hash = eina_hash_string_superfast_new(NULL);
+
+   for (i = 0; i < count; ++i)
+     {
+        char tmp_key[16] = "key_";
+
+        eina_convert_xtoa(i, tmp_key + 4);
+        eina_hash_add(hash, tmp_key, (void *)(uintptr_t)(i + 1));
+     }
+
+   return hash;
+}
+
+static void
+_eina_bench_hash_op(Eina_Hash *hash, unsigned int count, Eina_Bench_Hash_Op op)
+{
+   Eina_Iterator *it;
+   unsigned int found = 0;
+   unsigned int i, j;
+
+   switch (op)
+     {
+      case EINA_BENCH_HASH_INSERT:
+        break;
+      case EINA_BENCH_HASH_LOOKUP:
+        srand(time(NULL));
+        for (i = 0; i < count; ++i)
+          {
+             char tmp_key[16] = "key_";
+
+             eina_convert_xtoa(rand() % count, tmp_key + 4);
+             if (eina_hash_find(hash, tmp_key)) found++;
+          }
+        if (found != count)
+          fprintf(stderr, "flat hash bench: %u of %u keys found\n", found, count);
+        break;
+      case EINA_BENCH_HASH_DELETE:
+        for (i = 0; i < count; ++i)
+          {
+             char tmp_key[16] = "key_";
+
+             eina_convert_xtoa(i, tmp_key + 4);
+             eina_hash_del_by_key(hash, tmp_key);
+          }
+        break;
+      case EINA_BENCH_HASH_ITERATE:
+        for (j = 0; j < 10; ++j)
+          {
+             void *data;
+
+             it = eina_hash_iterator_data_new(hash);
+             EINA_ITERATOR_FOREACH(it, data)
+               found++;
+             eina_iterator_free(it);
+          }
+        break;
+     }
+}
+
+/* request is the power of 10 of the number of keys, from 1K to 10M keys */
+static unsigned int
+_eina_bench_hash_count(int request)
+{
+   unsigned int count = 1;
+   int i;
+
+   for (i = 0; i < request; ++i)
+     count *= 10;
+   return count;
+}
+
+/* Inserting is populating, so that one is timed as a whole */
+static void
+eina_bench_hash_insert(int request)
+{
+   eina_hash_free(_eina_bench_hash_populate(EINA_FALSE,
+                                            _eina_bench_hash_count(request)));
+}
+
+static void
+eina_bench_hash_flat_insert(int request)
+{
+   eina_hash_free(_eina_bench_hash_populate(EINA_TRUE,
+                                            _eina_bench_hash_count(request)));
+}
+
+/* The other operations need a populated table, which Eina_Benchmark would
+ * time with them, so they have their own counter started once the table is
+ * filled. */
+static void
+_eina_bench_hash_op_run(const char *name, Eina_Bool flat, Eina_Bench_Hash_Op op)
+{
+   Eina_Counter *cnt;
+   Eina_Hash *hash;
+   unsigned int count;
+   char *result;
+   int request;
+
+   cnt = eina_counter_new(name);
+   if (!cnt) return;
+
+   for (request = 3; request < 8; ++request)
+     {
+        count = _eina_bench_hash_count(request);
+        hash = _eina_bench_hash_populate(flat, count);
+
+        eina_counter_start(cnt);
+        _eina_bench_hash_op(hash, count, op);
+        eina_counter_stop(cnt, request);
+
+        eina_hash_free(hash);
+     }
+
+   result = eina_counter_dump(cnt);
+   fprintf(stderr, "For `%s`:\n%s\n", name, result);
+   free(result);
+
+   eina_counter_free(cnt);
+}
+
+void eina_bench_hash_flat(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "superfast-insert",
+                           EINA_BENCHMARK(eina_bench_hash_insert), 3, 8, 1);
+   eina_benchmark_register(bench, "flat-insert",
+                           EINA_BENCHMARK(eina_bench_hash_flat_insert), 3, 8, 1);
+
+   _eina_bench_hash_op_run("superfast-lookup", EINA_FALSE, EINA_BENCH_HASH_LOOKUP);
+   _eina_bench_hash_op_run("flat-lookup", EINA_TRUE, EINA_BENCH_HASH_LOOKUP);
+   _eina_bench_hash_op_run("superfast-delete", EINA_FALSE, EINA_BENCH_HASH_DELETE);
+   _eina_bench_hash_op_run("flat-delete", EINA_TRUE, EINA_BENCH_HASH_DELETE);
+   _eina_bench_hash_op_run("superfast-iterate", EINA_FALSE, EINA_BENCH_HASH_ITERATE);
+   _eina_bench_hash_op_run("flat-iterate", EINA_TRUE, EINA_BENCH_HASH_ITERATE);
+}
+
 void eina_bench_hash(Eina_Benchmark *bench)
 {
    eina_benchmark_register(bench, "superfast-lookup",
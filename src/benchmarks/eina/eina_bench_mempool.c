@@ -54,6 +54,53 @@ _eina_mempool_bench(Eina_Mempool *mp, int request)
    eina_shutdown();
 }
 
+/* Every thread allocates and frees the same amount of items, so with a
+ * mempool that scales the time stays flat when the thread count (the
+ * request) goes up. */
+#define THREAD_ROUNDS 100
+#define THREAD_ITEMS 1000
+
+static void *
+_eina_mempool_thread_bench(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Eina_Mempool *mp = data;
+   void *items[THREAD_ITEMS];
+   int i;
+   int j;
+
+   for (i = 0; i < THREAD_ROUNDS; ++i)
+     {
+        for (j = 0; j < THREAD_ITEMS; ++j)
+          items[j] = eina_mempool_malloc(mp, sizeof (int));
+
+        for (j = 0; j < THREAD_ITEMS; ++j)
+          eina_mempool_free(mp, items[j]);
+     }
+
+   return NULL;
+}
+
+static void
+_eina_mempool_threads_bench(Eina_Mempool *mp, int request)
+{
+   Eina_Thread *threads;
+   int i;
+   int n;
+
+   threads = malloc(request * sizeof (Eina_Thread));
+   if (!threads) return;
+
+   for (n = 0; n < request; ++n)
+     if (!eina_thread_create(&threads[n], EINA_THREAD_NORMAL, -1,
+                             _eina_mempool_thread_bench, mp))
+       break;
+
+   for (i = 0; i < n; ++i)
+     eina_thread_join(threads[i]);
+
+   free(threads);
+}
+
 #ifdef EINA_BUILD_CHAINED_POOL
 static void
 eina_mempool_chained_mempool(int request)
@@ -64,6 +111,16 @@ eina_mempool_chained_mempool(int request)
    _eina_mempool_bench(mp, request);
    eina_mempool_del(mp);
 }
+
+static void
+eina_mempool_chained_mempool_threads(int request)
+{
+   Eina_Mempool *mp;
+
+   mp = eina_mempool_add("chained_mempool", "test", NULL, sizeof (int), 256);
+   _eina_mempool_threads_bench(mp, request);
+   eina_mempool_del(mp);
+}
 #endif
 
 #ifdef EINA_BUILD_PASS_THROUGH
@@ -76,6 +133,16 @@ eina_mempool_pass_through(int request)
    _eina_mempool_bench(mp, request);
    eina_mempool_del(mp);
 }
+
+static void
+eina_mempool_pass_through_threads(int request)
+{
+   Eina_Mempool *mp;
+
+   mp = eina_mempool_add("pass_through", "test", NULL, sizeof (int), 8, 0);
+   _eina_mempool_threads_bench(mp, request);
+   eina_mempool_del(mp);
+}
 #endif
 
 #ifdef EINA_BENCH_HAVE_GLIB
@@ -127,3 +194,18 @@ eina_bench_mempool(Eina_Benchmark *bench)
                               eina_mempool_glib),            10, 10000, 10);
 #endif
 }
+
+void
+eina_bench_mempool_threads(Eina_Benchmark *bench)
+{
+#ifdef EINA_BUILD_CHAINED_POOL
+   eina_benchmark_register(bench, "chained mempool",
+                           EINA_BENCHMARK(
+                              eina_mempool_chained_mempool_threads), 1, 9, 1);
+#endif
+#ifdef EINA_BUILD_PASS_THROUGH
+   eina_benchmark_register(bench, "pass through",
+                           EINA_BENCHMARK(
+                              eina_mempool_pass_through_threads),    1, 9, 1);
+#endif
+}
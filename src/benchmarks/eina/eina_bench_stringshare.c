@@ -35,6 +35,7 @@
 #include "eina_bench.h"
 #include "eina_convert.h"
 #include "eina_main.h"
+#include "eina_thread.h"
 
 static void
 eina_bench_stringshare_job(int request)
@@ -69,6 +70,85 @@ eina_bench_stringshare_job(int request)
    eina_shutdown();
 }
 
+typedef struct _Bench_Thread Bench_Thread;
+struct _Bench_Thread
+{
+   Eina_Thread thread;
+   int id;
+   int count;
+};
+
+/* Every thread keeps adding and releasing a set of strings used by all
+   threads, plus some of its own, like a threaded parser would. */
+static void *
+_eina_bench_stringshare_thread(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Bench_Thread *bt = data;
+   const char *hot[64];
+   unsigned int j;
+   int i;
+
+   for (i = 0; i < bt->count; ++i)
+     {
+        char build[64] = "string_";
+
+        for (j = 0; j < 64; ++j)
+          {
+             eina_convert_xtoa(j, build + 7);
+             hot[j] = eina_stringshare_add(build);
+          }
+
+        eina_convert_xtoa(bt->id * bt->count + i, build + 7);
+        eina_stringshare_del(eina_stringshare_add(build));
+
+        for (j = 0; j < 64; ++j)
+          eina_stringshare_del(hot[j]);
+     }
+
+   return NULL;
+}
+
+static void
+_eina_bench_stringshare_threads(int request, int threads)
+{
+   Bench_Thread bt[8];
+   const char *hold;
+   int i;
+
+   eina_init();
+
+   /* keep one reference around, like any real application would */
+   hold = eina_stringshare_add("string_0");
+
+   for (i = 0; i < threads; ++i)
+     {
+        bt[i].id = i + 1;
+        bt[i].count = request / threads;
+        if (!eina_thread_create(&(bt[i].thread), EINA_THREAD_NORMAL, -1,
+                                _eina_bench_stringshare_thread, &(bt[i])))
+          break;
+     }
+   threads = i;
+
+   for (i = 0; i < threads; ++i)
+     eina_thread_join(bt[i].thread);
+
+   eina_stringshare_del(hold);
+   eina_shutdown();
+}
+
+#define BENCH_THREADS(Threads) \
+static void \
+eina_bench_stringshare_threads_##Threads(int request) \
+{ \
+   _eina_bench_stringshare_threads(request, Threads); \
+}
+
+BENCH_THREADS(1)
+BENCH_THREADS(2)
+BENCH_THREADS(4)
+BENCH_THREADS(8)
+
 #ifdef EINA_BENCH_HAVE_GLIB
 static void
 eina_bench_stringchunk_job(int request)
@@ -171,6 +251,18 @@ void eina_bench_stringshare(Eina_Benchmark *bench)
    eina_benchmark_register(bench, "stringshare",
                            EINA_BENCHMARK(
                               eina_bench_stringshare_job), 100, 20100, 500);
+   eina_benchmark_register(bench, "stringshare threads-1",
+                           EINA_BENCHMARK(
+                              eina_bench_stringshare_threads_1), 800, 20800, 1000);
+   eina_benchmark_register(bench, "stringshare threads-2",
+                           EINA_BENCHMARK(
+                              eina_bench_stringshare_threads_2), 800, 20800, 1000);
+   eina_benchmark_register(bench, "stringshare threads-4",
+                           EINA_BENCHMARK(
+                              eina_bench_stringshare_threads_4), 800, 20800, 1000);
+   eina_benchmark_register(bench, "stringshare threads-8",
+                           EINA_BENCHMARK(
+                              eina_bench_stringshare_threads_8), 800, 20800, 1000);
 #ifdef EINA_BENCH_HAVE_GLIB
    eina_benchmark_register(bench, "stringchunk (glib)",
                            EINA_BENCHMARK(
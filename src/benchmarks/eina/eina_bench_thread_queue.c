@@ -0,0 +1,126 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "eina_bench.h"
+#include "Eina.h"
+
+typedef struct _Msg Msg;
+struct _Msg
+{
+   Eina_Thread_Queue_Msg head;
+   int value;
+};
+
+typedef struct _Producer Producer;
+struct _Producer
+{
+   Eina_Thread_Queue *thq;
+   Eina_Thread thread;
+   int count;
+};
+
+static void *
+_producer(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Producer *p = data;
+   Msg *msg;
+   void *ref;
+   int i;
+
+   for (i = 0; i < p->count; i++)
+     {
+        msg = eina_thread_queue_send(p->thq, sizeof(Msg), &ref);
+        if (!msg) continue;
+        msg->value = i;
+        eina_thread_queue_send_done(p->thq, ref);
+     }
+   return NULL;
+}
+
+/* Every producer sends its share of request messages, the calling thread
+   reads them all back. */
+static void
+_eina_bench_thread_queue(int request, int producers, Eina_Bool mpsc)
+{
+   Eina_Thread_Queue *thq;
+   Producer p[16];
+   Msg *msg;
+   void *ref;
+   int i, total = 0;
+
+   eina_init();
+
+   if (mpsc) thq = eina_thread_queue_mpsc_new();
+   else thq = eina_thread_queue_new();
+   if (!thq) goto end;
+
+   for (i = 0; i < producers; i++)
+     {
+        p[i].thq = thq;
+        p[i].count = request / producers;
+        total += p[i].count;
+        if (!eina_thread_create(&(p[i].thread), EINA_THREAD_NORMAL, -1,
+                                _producer, &(p[i])))
+          {
+             total -= p[i].count;
+             p[i].count = 0;
+          }
+     }
+
+   for (; total > 0; total--)
+     {
+        msg = eina_thread_queue_wait(thq, &ref);
+        if (msg) eina_thread_queue_wait_done(thq, ref);
+     }
+
+   for (i = 0; i < producers; i++)
+     if (p[i].count) eina_thread_join(p[i].thread);
+
+   eina_thread_queue_free(thq);
+
+end:
+   eina_shutdown();
+}
+
+#define BENCH_QUEUE(Producers) \
+static void \
+eina_bench_thread_queue_##Producers(int request) \
+{ \
+   _eina_bench_thread_queue(request, Producers, EINA_FALSE); \
+} \
+static void \
+eina_bench_thread_queue_mpsc_##Producers(int request) \
+{ \
+   _eina_bench_thread_queue(request, Producers, EINA_TRUE); \
+}
+
+BENCH_QUEUE(1)
+BENCH_QUEUE(2)
+BENCH_QUEUE(4)
+BENCH_QUEUE(8)
+BENCH_QUEUE(16)
+
+void eina_bench_thread_queue(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "queue-1",
+                           EINA_BENCHMARK(eina_bench_thread_queue_1), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "mpsc-1",
+                           EINA_BENCHMARK(eina_bench_thread_queue_mpsc_1), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "queue-2",
+                           EINA_BENCHMARK(eina_bench_thread_queue_2), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "mpsc-2",
+                           EINA_BENCHMARK(eina_bench_thread_queue_mpsc_2), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "queue-4",
+                           EINA_BENCHMARK(eina_bench_thread_queue_4), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "mpsc-4",
+                           EINA_BENCHMARK(eina_bench_thread_queue_mpsc_4), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "queue-8",
+                           EINA_BENCHMARK(eina_bench_thread_queue_8), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "mpsc-8",
+                           EINA_BENCHMARK(eina_bench_thread_queue_mpsc_8), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "queue-16",
+                           EINA_BENCHMARK(eina_bench_thread_queue_16), 10000, 200000, 10000);
+   eina_benchmark_register(bench, "mpsc-16",
+                           EINA_BENCHMARK(eina_bench_thread_queue_mpsc_16), 10000, 200000, 10000);
+}
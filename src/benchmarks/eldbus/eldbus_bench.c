@@ -0,0 +1,96 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/types.h>
+
+#include <Eina.h>
+
+#include "Ecore.h"
+#include "Eldbus.h"
+#include "eldbus_bench.h"
+
+typedef struct _Eina_Benchmark_Case Eina_Benchmark_Case;
+struct _Eina_Benchmark_Case
+{
+   const char *bench_case;
+   void (*build)(Eina_Benchmark *bench);
+};
+
+static const Eina_Benchmark_Case etc[] = {
+   { "Signal", eldbus_bench_signal },
+   { NULL, NULL }
+};
+
+/* The benchmarks flood the bus with signals, so they run on a private
+ * dbus-daemon instead of the user session bus when one can be started. */
+const char *eldbus_bench_address = NULL;
+
+static char _address[1024];
+static pid_t _daemon_pid = 0;
+
+static void
+_bus_start(void)
+{
+   FILE *f;
+   char pid[32];
+
+   f = popen("dbus-daemon --session --fork --print-address=1 --print-pid=1", "r");
+   if (!f) return;
+
+   if ((fgets(_address, sizeof(_address), f)) &&
+       (fgets(pid, sizeof(pid), f)))
+     {
+        _address[strcspn(_address, "\n")] = '\0';
+        _daemon_pid = atoi(pid);
+        if ((_address[0]) && (_daemon_pid > 0))
+          eldbus_bench_address = _address;
+     }
+   pclose(f);
+
+   if (!eldbus_bench_address)
+     fprintf(stderr, "could not start a private bus, using the session bus\n");
+}
+
+static void
+_bus_stop(void)
+{
+   if (_daemon_pid > 0) kill(_daemon_pid, SIGTERM);
+}
+
+int
+main(int argc, char **argv)
+{
+   Eina_Benchmark *test;
+   unsigned int i;
+
+   if (argc != 2)
+      return -1;
+
+   _bus_start();
+   ecore_init();
+   eldbus_init();
+
+   for (i = 0; etc[i].bench_case; ++i)
+     {
+        test = eina_benchmark_new(etc[i].bench_case, argv[1]);
+        if (!test)
+           continue;
+
+        etc[i].build(test);
+
+        eina_benchmark_run(test);
+
+        eina_benchmark_free(test);
+     }
+
+   eldbus_shutdown();
+   ecore_shutdown();
+   _bus_stop();
+
+   return 0;
+}
@@ -0,0 +1,8 @@
+#ifndef ELDBUS_BENCH_H_
+#define ELDBUS_BENCH_H_
+
+extern const char *eldbus_bench_address;
+
+void eldbus_bench_signal(Eina_Benchmark *bench);
+
+#endif
@@ -0,0 +1,152 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <Eina.h>
+
+#include "Ecore.h"
+#include "Eldbus.h"
+#include "eldbus_bench.h"
+
+/* REQUEST signal handlers are registered on the connection, the way a
+ * desktop shell listens to NetworkManager, UPower and MPRIS objects, then a
+ * flood of FLOOD signals matching only one of them is emitted and received
+ * back. The "properties" case spreads the handlers over object paths of
+ * the same interface and member, the "members" case over interfaces and
+ * members. */
+
+#define FLOOD 10000
+#define IFACE_PROPERTIES "org.freedesktop.DBus.Properties"
+#define IFACE_BENCH "org.enlightenment.Bench"
+
+static int _received = 0;
+
+static Eldbus_Connection *
+_connection_get(void)
+{
+   if (eldbus_bench_address)
+     return eldbus_private_address_connection_get(eldbus_bench_address);
+   return eldbus_private_connection_get(ELDBUS_CONNECTION_TYPE_SESSION);
+}
+
+static void
+_signal_cb(void *data EINA_UNUSED, const Eldbus_Message *msg EINA_UNUSED)
+{
+}
+
+static void
+_signal_flood_cb(void *data EINA_UNUSED, const Eldbus_Message *msg EINA_UNUSED)
+{
+   if (++_received == FLOOD) ecore_main_loop_quit();
+}
+
+static Eina_Bool
+_timeout_cb(void *data EINA_UNUSED)
+{
+   fprintf(stderr, "only %d signals out of %d were received\n",
+           _received, FLOOD);
+   ecore_main_loop_quit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_signal_flood(Eldbus_Connection *conn, const char *path,
+              const char *interface, const char *member)
+{
+   Ecore_Timer *timeout;
+   int i;
+
+   _received = 0;
+   for (i = 0; i < FLOOD; i++)
+     {
+        Eldbus_Message *msg;
+
+        msg = eldbus_message_signal_new(path, interface, member);
+        if (!msg) return;
+        eldbus_connection_send(conn, msg, NULL, NULL, -1);
+     }
+
+   timeout = ecore_timer_add(30.0, _timeout_cb, NULL);
+   ecore_main_loop_begin();
+   ecore_timer_del(timeout);
+}
+
+static void
+eldbus_bench_signal_properties(int request)
+{
+   Eldbus_Connection *conn;
+   Eldbus_Signal_Handler **handlers;
+   char path[64];
+   int i;
+
+   conn = _connection_get();
+   if (!conn) return;
+
+   handlers = malloc(request * sizeof (Eldbus_Signal_Handler *));
+   if (!handlers) goto end;
+
+   for (i = 0; i < request; i++)
+     {
+        snprintf(path, sizeof(path), "/org/enlightenment/Bench/%d", i);
+        handlers[i] = eldbus_signal_handler_add(conn, NULL, path,
+                                                IFACE_PROPERTIES,
+                                                "PropertiesChanged",
+                                                i ? _signal_cb : _signal_flood_cb,
+                                                NULL);
+     }
+
+   _signal_flood(conn, "/org/enlightenment/Bench/0",
+                 IFACE_PROPERTIES, "PropertiesChanged");
+
+   for (i = 0; i < request; i++)
+     if (handlers[i]) eldbus_signal_handler_del(handlers[i]);
+   free(handlers);
+
+ end:
+   eldbus_connection_unref(conn);
+}
+
+static void
+eldbus_bench_signal_members(int request)
+{
+   Eldbus_Connection *conn;
+   Eldbus_Signal_Handler **handlers;
+   char interface[64], member[64];
+   int i;
+
+   conn = _connection_get();
+   if (!conn) return;
+
+   handlers = malloc(request * sizeof (Eldbus_Signal_Handler *));
+   if (!handlers) goto end;
+
+   for (i = 0; i < request; i++)
+     {
+        snprintf(interface, sizeof(interface), IFACE_BENCH "%d", i % 16);
+        snprintf(member, sizeof(member), "Changed%d", i / 16);
+        handlers[i] = eldbus_signal_handler_add(conn, NULL, NULL,
+                                                interface, member,
+                                                i ? _signal_cb : _signal_flood_cb,
+                                                NULL);
+     }
+
+   _signal_flood(conn, "/org/enlightenment/Bench", IFACE_BENCH "0", "Changed0");
+
+   for (i = 0; i < request; i++)
+     if (handlers[i]) eldbus_signal_handler_del(handlers[i]);
+   free(handlers);
+
+ end:
+   eldbus_connection_unref(conn);
+}
+
+void eldbus_bench_signal(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "signal-properties",
+                           EINA_BENCHMARK(eldbus_bench_signal_properties), 100, 1001, 100);
+   eina_benchmark_register(bench, "signal-members",
+                           EINA_BENCHMARK(eldbus_bench_signal_members), 100, 1001, 100);
+}
@@ -0,0 +1,207 @@
+#ifdef HAVE_CONFIG_H
+# include "elementary_config.h"
+#endif
+
+#define EFL_BETA_API_SUPPORT
+#include <Elementary.h>
+
+/* Scrolls a genlist (or a gengrid) holding ITEMS items of CLASSES different
+ * item classes, so that items are realized and unrealized through the item
+ * cache on every step. The time spent realizing each step is measured. */
+
+#define ITEMS 100000
+#define CLASSES 8
+#define STEP 97
+
+typedef struct
+{
+   Evas_Object *obj;
+   Ecore_Timer *timer;
+   Eina_Bool grid;
+   int steps, steps_max;
+   Evas_Coord y;
+   unsigned long long total, min, max;
+} Scroll;
+
+static Elm_Genlist_Item_Class *_itcs[CLASSES];
+static Elm_Gengrid_Item_Class *_gitcs[CLASSES];
+
+static char *
+_text_get(void *data, Evas_Object *obj EINA_UNUSED, const char *part EINA_UNUSED)
+{
+   char buf[64];
+
+   snprintf(buf, sizeof(buf), "Item # %i", (int)(uintptr_t)data);
+   return strdup(buf);
+}
+
+static Evas_Object *
+_content_get(void *data, Evas_Object *obj, const char *part)
+{
+   Evas_Object *ic;
+
+   // only some of the classes have contents, like real lists do
+   if (((int)(uintptr_t)data % CLASSES) & 1) return NULL;
+   if (strcmp(part, "elm.swallow.icon")) return NULL;
+
+   ic = elm_icon_add(obj);
+   elm_icon_standard_set(ic, "folder");
+   evas_object_size_hint_aspect_set(ic, EVAS_ASPECT_CONTROL_VERTICAL, 1, 1);
+   return ic;
+}
+
+static unsigned long long
+_now(void)
+{
+   struct timespec t;
+
+   clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+   return ((unsigned long long) t.tv_sec * 1000000000ULL) + t.tv_nsec;
+}
+
+static Eina_Bool
+_scroll_cb(void *data)
+{
+   Scroll *scroll = data;
+   unsigned long long t0, t;
+   unsigned int hits, misses;
+   Evas_Coord w, h;
+
+   evas_object_geometry_get(scroll->obj, NULL, NULL, &w, &h);
+   scroll->y += STEP;
+
+   t0 = _now();
+   elm_scroller_region_show(scroll->obj, 0, scroll->y, w, h);
+   evas_smart_objects_calculate(evas_object_evas_get(scroll->obj));
+   t = _now() - t0;
+
+   if (scroll->min > t) scroll->min = t;
+   if (scroll->max < t) scroll->max = t;
+   scroll->total += t;
+
+   if (++scroll->steps < scroll->steps_max) return ECORE_CALLBACK_RENEW;
+
+   if (scroll->grid)
+     elm_gengrid_item_cache_stats_get(scroll->obj, &hits, &misses);
+   else
+     elm_genlist_item_cache_stats_get(scroll->obj, &hits, &misses);
+
+   printf(" min : %llu nsec, max : %llu nsec\n", scroll->min, scroll->max);
+   printf(" average : %llu nsec (total : %llu nsec / count : %d)\n",
+          scroll->total / scroll->steps, scroll->total, scroll->steps);
+   printf(" item cache : %u hits, %u misses\n", hits, misses);
+
+   scroll->timer = NULL;
+   elm_exit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_scroll_del_cb(void *data, Evas *e EINA_UNUSED,
+               Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Scroll *scroll = data;
+
+   ecore_timer_del(scroll->timer);
+   free(scroll);
+}
+
+static Evas_Object *
+_genlist_add(Evas_Object *win)
+{
+   Evas_Object *gl;
+   int i;
+
+   gl = elm_genlist_add(win);
+   // a big cache, so that lookups in it are not free
+   elm_genlist_block_count_set(gl, 256);
+   elm_genlist_homogeneous_set(gl, EINA_TRUE);
+
+   for (i = 0; i < CLASSES; i++)
+     {
+        _itcs[i] = elm_genlist_item_class_new();
+        _itcs[i]->item_style = (i & 2) ? "double_label" : "default";
+        _itcs[i]->func.text_get = _text_get;
+        _itcs[i]->func.content_get = _content_get;
+     }
+
+   for (i = 0; i < ITEMS; i++)
+     elm_genlist_item_append(gl, _itcs[(i * 7) % CLASSES],
+                             (void *)(uintptr_t)i, NULL,
+                             ELM_GENLIST_ITEM_NONE, NULL, NULL);
+
+   for (i = 0; i < CLASSES; i++)
+     elm_genlist_item_class_free(_itcs[i]);
+
+   return gl;
+}
+
+static Evas_Object *
+_gengrid_add(Evas_Object *win)
+{
+   static const char *styles[] = { "default", "default_style", "up", "album-preview" };
+   Evas_Object *gg;
+   int i;
+
+   gg = elm_gengrid_add(win);
+   elm_gengrid_item_size_set(gg, 80, 80);
+
+   for (i = 0; i < CLASSES; i++)
+     {
+        _gitcs[i] = elm_gengrid_item_class_new();
+        _gitcs[i]->item_style = styles[i % EINA_C_ARRAY_LENGTH(styles)];
+        _gitcs[i]->func.text_get = _text_get;
+        _gitcs[i]->func.content_get = _content_get;
+     }
+
+   for (i = 0; i < ITEMS; i++)
+     elm_gengrid_item_append(gg, _gitcs[(i * 7) % CLASSES],
+                             (void *)(uintptr_t)i, NULL, NULL);
+
+   for (i = 0; i < CLASSES; i++)
+     elm_gengrid_item_class_free(_gitcs[i]);
+
+   return gg;
+}
+
+static void
+item_cache_scroll_test(int steps, Eina_Bool grid)
+{
+   Evas_Object *win;
+   Scroll *scroll;
+
+   scroll = calloc(1, sizeof(Scroll));
+   if (!scroll) return;
+   scroll->min = ULLONG_MAX;
+   scroll->steps_max = steps;
+   scroll->grid = grid;
+
+   win = elm_win_util_standard_add("item-cache-scroll", "Item Cache Scroll");
+   elm_win_autodel_set(win, EINA_TRUE);
+
+   scroll->obj = grid ? _gengrid_add(win) : _genlist_add(win);
+   evas_object_size_hint_weight_set(scroll->obj, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   elm_win_resize_object_add(win, scroll->obj);
+   evas_object_show(scroll->obj);
+
+   evas_object_resize(win, 480, 800);
+   evas_object_show(win);
+
+   evas_object_event_callback_add(win, EVAS_CALLBACK_FREE, _scroll_del_cb, scroll);
+   scroll->timer = ecore_timer_add(0.001, _scroll_cb, scroll);
+
+   elm_run();
+}
+
+EAPI_MAIN int
+elm_main(int argc, char **argv)
+{
+   if (argc < 2) return EXIT_FAILURE;
+
+   setenv("ELM_DISPLAY", "buffer", 1);
+   item_cache_scroll_test(atoi(argv[1]),
+                          (argc > 2) && (!strcmp(argv[2], "gengrid")));
+
+   return EXIT_SUCCESS;
+}
+ELM_MAIN()
@@ -75,10 +75,60 @@ bench_eo_callbacks_call(int request)
      }
 }
 
+static void
+_bench_eo_callbacks_call_count(const Efl_Event_Description *desc, int request)
+{
+   /* Emit on objects holding from 1 up to 64 callbacks. */
+   const int len = 64;
+   int i, j;
+   Eo *obj[len];
+
+   for (i = 0 ; i < len ; i++)
+     {
+        obj[i] = efl_add_ref(SIMPLE_CLASS, NULL);
+
+        for (j = 0 ; j <= i ; j++)
+          {
+             efl_event_callback_priority_add(obj[i], SIMPLE_FOO, (short) j, _cb, NULL);
+          }
+     }
+
+   for (j = 0 ; j < request / len ; j++)
+     {
+        for (i = 0 ; i < len ; i++)
+          {
+             efl_event_callback_call(obj[i], desc, NULL);
+          }
+     }
+
+   for (i = 0 ; i < len ; i++)
+     {
+        efl_unref(obj[i]);
+     }
+}
+
+static void
+bench_eo_callbacks_call_miss(int request)
+{
+   /* Nobody listens to this event, emission should not depend on the
+      amount of callbacks. */
+   _bench_eo_callbacks_call_count(SIMPLE_BAR, request);
+}
+
+static void
+bench_eo_callbacks_call_hit(int request)
+{
+   _bench_eo_callbacks_call_count(SIMPLE_FOO, request);
+}
+
 void eo_bench_callbacks(Eina_Benchmark *bench)
 {
    eina_benchmark_register(bench, "add",
          EINA_BENCHMARK(bench_eo_callbacks_add), _EO_BENCH_TIMES(1000, 10, 2000));
    eina_benchmark_register(bench, "call",
          EINA_BENCHMARK(bench_eo_callbacks_call), _EO_BENCH_TIMES(100000, 10, 500000));
+   eina_benchmark_register(bench, "call-miss-1-64",
+         EINA_BENCHMARK(bench_eo_callbacks_call_miss), _EO_BENCH_TIMES(100000, 10, 500000));
+   eina_benchmark_register(bench, "call-hit-1-64",
+         EINA_BENCHMARK(bench_eo_callbacks_call_hit), _EO_BENCH_TIMES(10000, 10, 50000));
 }
@@ -21,6 +21,11 @@ struct _Evas_Benchmark_Case
 static const Evas_Benchmark_Case etc[] = {
    { "Loader", evas_bench_loader, EINA_TRUE },
    { "Saver", evas_bench_saver, EINA_TRUE },
+   { "Blend", evas_bench_blend, EINA_TRUE },
+   { "Filter", evas_bench_filter, EINA_TRUE },
+   { "Font", evas_bench_font, EINA_TRUE },
+   { "Scale", evas_bench_scale, EINA_TRUE },
+   { "Convert", evas_bench_convert, EINA_TRUE },
    { NULL, NULL, EINA_FALSE }
 };
 
@@ -5,6 +5,11 @@
 
 void evas_bench_loader(Eina_Benchmark *bench);
 void evas_bench_saver(Eina_Benchmark *bench);
+void evas_bench_blend(Eina_Benchmark *bench);
+void evas_bench_filter(Eina_Benchmark *bench);
+void evas_bench_font(Eina_Benchmark *bench);
+void evas_bench_scale(Eina_Benchmark *bench);
+void evas_bench_convert(Eina_Benchmark *bench);
 
 #endif
 
@@ -0,0 +1,160 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Full HD frames, the timings divided by the number of requests give the
+ * time needed to push WIDTH * HEIGHT pixels through one compositing span.
+ * Run with EVAS_CPU_NO_AVX2 or EVAS_CPU_NO_SSE3 set to compare paths. */
+#define WIDTH 1920
+#define HEIGHT 1080
+
+static Evas *
+_setup_evas(void **buffer)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   *buffer = malloc(sizeof (char) * WIDTH * HEIGHT * 4);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = *buffer;
+   einfo->info.dest_buffer_row_bytes = WIDTH * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, WIDTH, HEIGHT);
+   evas_output_viewport_set(evas, 0, 0, WIDTH, HEIGHT);
+
+   return evas;
+}
+
+static Evas_Object *
+_background_add(Evas *e)
+{
+   Evas_Object *o;
+
+   o = evas_object_rectangle_add(e);
+   evas_object_color_set(o, 32, 64, 96, 255);
+   evas_object_geometry_set(o, 0, 0, WIDTH, HEIGHT);
+   evas_object_show(o);
+
+   return o;
+}
+
+static Evas_Object *
+_alpha_image_add(Evas *e)
+{
+   Evas_Object *o;
+   unsigned int *data;
+   int x, y;
+
+   o = evas_object_image_filled_add(e);
+   evas_object_image_size_set(o, WIDTH, HEIGHT);
+   evas_object_image_alpha_set(o, EINA_TRUE);
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   for (y = 0; y < HEIGHT; y++)
+     for (x = 0; x < WIDTH; x++)
+       {
+          unsigned int a = (x + y) & 0xff;
+
+          /* premultiplied, with a few fully opaque and transparent runs */
+          data[(y * WIDTH) + x] = (a << 24) | ((a / 2) << 16) | ((a / 3) << 8) | (a / 4);
+       }
+   evas_object_image_data_set(o, data);
+   evas_object_geometry_set(o, 0, 0, WIDTH, HEIGHT);
+   evas_object_show(o);
+
+   return o;
+}
+
+static void
+_render(Evas *e, int request)
+{
+   int i;
+
+   for (i = 0; i < request; i++)
+     {
+        evas_damage_rectangle_add(e, 0, 0, WIDTH, HEIGHT);
+        evas_render(e);
+     }
+}
+
+static void
+_teardown_evas(Evas *e, void *buffer)
+{
+   evas_free(e);
+   free(buffer);
+}
+
+static void
+evas_bench_blend_pixel(int request)
+{
+   void *buffer;
+   Evas *e = _setup_evas(&buffer);
+
+   _background_add(e);
+   _alpha_image_add(e);
+   _render(e, request);
+
+   _teardown_evas(e, buffer);
+}
+
+static void
+evas_bench_blend_pixel_color(int request)
+{
+   void *buffer;
+   Evas *e = _setup_evas(&buffer);
+   Evas_Object *o;
+
+   _background_add(e);
+   o = _alpha_image_add(e);
+   evas_object_color_set(o, 192, 160, 128, 192);
+   _render(e, request);
+
+   _teardown_evas(e, buffer);
+}
+
+static void
+evas_bench_blend_color(int request)
+{
+   void *buffer;
+   Evas *e = _setup_evas(&buffer);
+   Evas_Object *o;
+
+   _background_add(e);
+   o = evas_object_rectangle_add(e);
+   evas_object_color_set(o, 64, 32, 16, 128);
+   evas_object_geometry_set(o, 0, 0, WIDTH, HEIGHT);
+   evas_object_show(o);
+   _render(e, request);
+
+   _teardown_evas(e, buffer);
+}
+
+static void
+evas_bench_copy_color(int request)
+{
+   void *buffer;
+   Evas *e = _setup_evas(&buffer);
+
+   _background_add(e);
+   _render(e, request);
+
+   _teardown_evas(e, buffer);
+}
+
+void evas_bench_blend(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "blend-pixel", EINA_BENCHMARK(evas_bench_blend_pixel), 10, 200, 10);
+   eina_benchmark_register(bench, "blend-pixel-color", EINA_BENCHMARK(evas_bench_blend_pixel_color), 10, 200, 10);
+   eina_benchmark_register(bench, "blend-color", EINA_BENCHMARK(evas_bench_blend_color), 10, 200, 10);
+   eina_benchmark_register(bench, "copy-color", EINA_BENCHMARK(evas_bench_copy_color), 10, 200, 10);
+}
@@ -0,0 +1,163 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Pushes full HD YUV frames through the software colorspace converters,
+ * like a video object does, and prints the converted Mpixel/s of each run.
+ * The object is drawn small and unsmoothed so that the conversion is most
+ * of the cost. Run with EVAS_CPU_NO_AVX2 or EVAS_CPU_NO_SSE3 set to compare
+ * paths, and with EVAS_YUV_THREADS=1 for row parallel conversion. */
+#define WIDTH 1920
+#define HEIGHT 1080
+
+static unsigned char _y[WIDTH * HEIGHT];
+static unsigned char _u[(WIDTH / 2) * (HEIGHT / 2)];
+static unsigned char _v[(WIDTH / 2) * (HEIGHT / 2)];
+static unsigned char _uv[WIDTH * (HEIGHT / 2)];
+static unsigned char _yuy2[WIDTH * 2 * HEIGHT];
+
+static void
+_planes_fill(void)
+{
+   static Eina_Bool filled = EINA_FALSE;
+   int i;
+
+   if (filled) return;
+   for (i = 0; i < (int)sizeof(_y); i++) _y[i] = i * 7;
+   for (i = 0; i < (int)sizeof(_u); i++) _u[i] = i * 3;
+   for (i = 0; i < (int)sizeof(_v); i++) _v[i] = i * 5;
+   for (i = 0; i < (int)sizeof(_uv); i++) _uv[i] = i * 11;
+   for (i = 0; i < (int)sizeof(_yuy2); i++) _yuy2[i] = i * 13;
+   filled = EINA_TRUE;
+}
+
+static Evas *
+_setup_evas(void **buffer)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   *buffer = malloc(sizeof (char) * WIDTH * HEIGHT * 4);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = *buffer;
+   einfo->info.dest_buffer_row_bytes = WIDTH * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, WIDTH, HEIGHT);
+   evas_output_viewport_set(evas, 0, 0, WIDTH, HEIGHT);
+
+   return evas;
+}
+
+static void
+_rows_set(Evas_Colorspace cs, unsigned char **rows)
+{
+   int i, j = 0;
+
+   switch (cs)
+     {
+      case EVAS_COLORSPACE_YCBCR422P601_PL:
+      case EVAS_COLORSPACE_YCBCR422P709_PL:
+        for (i = 0; i < HEIGHT; i++) rows[j++] = _y + (i * WIDTH);
+        for (i = 0; i < HEIGHT / 2; i++) rows[j++] = _u + (i * (WIDTH / 2));
+        for (i = 0; i < HEIGHT / 2; i++) rows[j++] = _v + (i * (WIDTH / 2));
+        break;
+      case EVAS_COLORSPACE_YCBCR420NV12601_PL:
+        for (i = 0; i < HEIGHT; i++) rows[j++] = _y + (i * WIDTH);
+        for (i = 0; i < HEIGHT / 2; i++) rows[j++] = _uv + (i * WIDTH);
+        break;
+      case EVAS_COLORSPACE_YCBCR422601_PL:
+        for (i = 0; i < HEIGHT; i++) rows[j++] = _yuy2 + (i * WIDTH * 2);
+        break;
+      default:
+        break;
+     }
+}
+
+static void
+_convert(const char *name, Evas_Colorspace cs, int request)
+{
+   struct timespec t0, t1;
+   unsigned char **rows;
+   Evas_Object *o;
+   void *buffer;
+   Evas *e;
+   double dt;
+   int i;
+
+   _planes_fill();
+   e = _setup_evas(&buffer);
+   o = evas_object_image_filled_add(e);
+   evas_object_image_colorspace_set(o, cs);
+   evas_object_image_alpha_set(o, EINA_FALSE);
+   evas_object_image_size_set(o, WIDTH, HEIGHT);
+   evas_object_image_smooth_scale_set(o, EINA_FALSE);
+   evas_object_geometry_set(o, 0, 0, WIDTH / 16, HEIGHT / 16);
+   evas_object_show(o);
+
+   clock_gettime(CLOCK_MONOTONIC, &t0);
+   for (i = 0; i < request; i++)
+     {
+        rows = evas_object_image_data_get(o, EINA_TRUE);
+        if (!rows) break;
+        _rows_set(cs, rows);
+        evas_object_image_data_set(o, rows);
+        evas_object_image_data_update_add(o, 0, 0, WIDTH, HEIGHT);
+        evas_render(e);
+     }
+   clock_gettime(CLOCK_MONOTONIC, &t1);
+
+   dt = (t1.tv_sec - t0.tv_sec) + ((t1.tv_nsec - t0.tv_nsec) / 1000000000.0);
+   if ((i == request) && (dt > 0.0))
+     fprintf(stderr, "convert-%s: %ix%i, %i frames, %.1f Mpixel/s\n",
+             name, WIDTH, HEIGHT, request,
+             ((double)WIDTH * HEIGHT * request) / (dt * 1000000.0));
+
+   evas_free(e);
+   free(buffer);
+}
+
+static void
+evas_bench_convert_yv12_601(int request)
+{
+   _convert("yv12-601", EVAS_COLORSPACE_YCBCR422P601_PL, request);
+}
+
+static void
+evas_bench_convert_yv12_709(int request)
+{
+   _convert("yv12-709", EVAS_COLORSPACE_YCBCR422P709_PL, request);
+}
+
+static void
+evas_bench_convert_nv12(int request)
+{
+   _convert("nv12", EVAS_COLORSPACE_YCBCR420NV12601_PL, request);
+}
+
+static void
+evas_bench_convert_yuy2(int request)
+{
+   _convert("yuy2", EVAS_COLORSPACE_YCBCR422601_PL, request);
+}
+
+void evas_bench_convert(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "convert-yv12-601", EINA_BENCHMARK(evas_bench_convert_yv12_601), 10, 100, 10);
+   eina_benchmark_register(bench, "convert-yv12-709", EINA_BENCHMARK(evas_bench_convert_yv12_709), 10, 100, 10);
+   eina_benchmark_register(bench, "convert-nv12", EINA_BENCHMARK(evas_bench_convert_nv12), 10, 100, 10);
+   eina_benchmark_register(bench, "convert-yuy2", EINA_BENCHMARK(evas_bench_convert_yuy2), 10, 100, 10);
+}
@@ -0,0 +1,112 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#define EFL_BETA_API_SUPPORT
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Renders a drop shadow, a glow and a grow on an image of SIZE x SIZE
+ * pixels, the image being marked as dirty before each frame so that the
+ * filter is run again. Set EVAS_FILTER_THREADS=1 to compare with the single
+ * threaded filters. */
+static const char *_filter_program =
+  "a = buffer ({ 'rgba' })\n"
+  "b = buffer ({ 'rgba' })\n"
+  "blur ({ 12, dst = a, type = 'box', count = 3 })\n"
+  "blur ({ 6, src = a, dst = b, type = 'gaussian' })\n"
+  "blend ({ src = a, dst = b, ox = 4, oy = 4, color = '#0008' })\n"
+  "grow ({ 3, src = b })\n";
+
+static Evas *
+_setup_evas(int size, void **buffer)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   *buffer = malloc(sizeof (char) * size * size * 4);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = *buffer;
+   einfo->info.dest_buffer_row_bytes = size * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, size, size);
+   evas_output_viewport_set(evas, 0, 0, size, size);
+
+   return evas;
+}
+
+static Evas_Object *
+_filtered_image_add(Evas *e, int size)
+{
+   Evas_Object *o;
+   unsigned int *data;
+   int x, y;
+
+   o = evas_object_image_filled_add(e);
+   evas_object_image_size_set(o, size, size);
+   evas_object_image_alpha_set(o, EINA_TRUE);
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   for (y = 0; y < size; y++)
+     for (x = 0; x < size; x++)
+       {
+          /* opaque checkerboard on a transparent background */
+          if (((x / 32) + (y / 32)) & 1)
+            data[(y * size) + x] = 0xff406080;
+          else
+            data[(y * size) + x] = 0x0;
+       }
+   evas_object_image_data_set(o, data);
+   evas_object_geometry_set(o, 0, 0, size, size);
+   efl_gfx_filter_program_set(o, _filter_program, "bench");
+   evas_object_show(o);
+
+   return o;
+}
+
+static void
+_evas_bench_filter(int request, int size)
+{
+   void *buffer;
+   Evas *e = _setup_evas(size, &buffer);
+   Evas_Object *o;
+   int i;
+
+   o = _filtered_image_add(e, size);
+   for (i = 0; i < request; i++)
+     {
+        evas_object_image_data_update_add(o, 0, 0, size, size);
+        evas_render(e);
+     }
+
+   evas_free(e);
+   free(buffer);
+}
+
+#define BENCH_FILTER(Size) \
+static void \
+evas_bench_filter_##Size(int request) \
+{ \
+   _evas_bench_filter(request, Size); \
+}
+
+BENCH_FILTER(256)
+BENCH_FILTER(512)
+BENCH_FILTER(1024)
+BENCH_FILTER(2048)
+
+void evas_bench_filter(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "filter-256", EINA_BENCHMARK(evas_bench_filter_256), 10, 100, 10);
+   eina_benchmark_register(bench, "filter-512", EINA_BENCHMARK(evas_bench_filter_512), 10, 100, 10);
+   eina_benchmark_register(bench, "filter-1024", EINA_BENCHMARK(evas_bench_filter_1024), 10, 100, 10);
+   eina_benchmark_register(bench, "filter-2048", EINA_BENCHMARK(evas_bench_filter_2048), 10, 100, 10);
+}
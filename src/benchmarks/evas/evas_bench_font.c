@@ -0,0 +1,116 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Time to first frame of a window full of text, without the glyph cache,
+ * with an empty one (cold) and with one filled by a previous run (warm).
+ * The font cache is disabled so that every frame loads the fonts again, as
+ * a freshly started process would. */
+
+#define TEST_FONT TESTS_SRC_DIR "/fonts/evas_test_font.ttf"
+#define WIDTH 800
+#define HEIGHT 600
+
+static const char *_text =
+  "The quick brown fox jumps over the lazy dog 0123456789 "
+  "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG !?.,;:'\"()[]{}<>";
+
+static void
+_evas_bench_font_frame(void)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+   Evas_Object *o;
+   void *buffer;
+   int size, y = 0;
+
+   evas = evas_new();
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   buffer = malloc(sizeof (char) * WIDTH * HEIGHT * 4);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = buffer;
+   einfo->info.dest_buffer_row_bytes = WIDTH * sizeof (char) * 4;
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, WIDTH, HEIGHT);
+   evas_output_viewport_set(evas, 0, 0, WIDTH, HEIGHT);
+   evas_font_cache_set(evas, 0);
+
+   for (size = 8; size <= 40; size += 2)
+     {
+        o = evas_object_text_add(evas);
+        evas_object_text_font_set(o, TEST_FONT, size);
+        evas_object_text_text_set(o, _text);
+        evas_object_move(o, 0, y);
+        evas_object_show(o);
+        y += size;
+     }
+   evas_render(evas);
+
+   evas_free(evas);
+   free(buffer);
+}
+
+static void
+evas_bench_font_none(int request)
+{
+   int i;
+
+   unsetenv("EVAS_FONT_GLYPH_CACHE_DIR");
+   for (i = 0; i < request; i++)
+     _evas_bench_font_frame();
+}
+
+static void
+evas_bench_font_cold(int request)
+{
+   char dir[] = "/tmp/evas_bench_font_XXXXXX";
+   char cmd[64];
+   int i;
+
+   for (i = 0; i < request; i++)
+     {
+        strcpy(dir, "/tmp/evas_bench_font_XXXXXX");
+        if (!mkdtemp(dir)) return;
+        setenv("EVAS_FONT_GLYPH_CACHE_DIR", dir, 1);
+        _evas_bench_font_frame();
+        snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+        if (system(cmd) != 0) fprintf(stderr, "Could not remove %s\n", dir);
+     }
+   unsetenv("EVAS_FONT_GLYPH_CACHE_DIR");
+}
+
+static void
+evas_bench_font_warm(int request)
+{
+   char dir[] = "/tmp/evas_bench_font_XXXXXX";
+   char cmd[64];
+   int i;
+
+   if (!mkdtemp(dir)) return;
+   setenv("EVAS_FONT_GLYPH_CACHE_DIR", dir, 1);
+   // fill the cache, then measure
+   _evas_bench_font_frame();
+   for (i = 0; i < request; i++)
+     _evas_bench_font_frame();
+   unsetenv("EVAS_FONT_GLYPH_CACHE_DIR");
+   snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+   if (system(cmd) != 0) fprintf(stderr, "Could not remove %s\n", dir);
+}
+
+void evas_bench_font(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "font-first-frame-none", EINA_BENCHMARK(evas_bench_font_none), 10, 100, 10);
+   eina_benchmark_register(bench, "font-first-frame-cold", EINA_BENCHMARK(evas_bench_font_cold), 10, 100, 10);
+   eina_benchmark_register(bench, "font-first-frame-warm", EINA_BENCHMARK(evas_bench_font_warm), 10, 100, 10);
+}
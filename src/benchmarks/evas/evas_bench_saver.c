@@ -71,7 +71,63 @@ evas_bench_saver_tgv(int request)
    evas_free(e);
 }
 
+/* Encode a request x request generated image, so the cost of ETC packing
+ * dominates over the file loading of the other cases */
+static void
+_bench_saver_etc(int request, const char *flags)
+{
+   Evas *e = _setup_evas();
+   Eina_Tmpstr *dest;
+   Evas_Object *o;
+   unsigned int *data;
+   int fd, x, y;
+
+   fd = eina_file_mkstemp("evas_saver_benchXXXXXX.tgv", &dest);
+   if (fd < 0) return;
+   close(fd);
+
+   o = evas_object_image_add(e);
+   evas_object_image_size_set(o, request, request);
+   evas_object_image_alpha_set(o, EINA_TRUE);
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   for (y = 0; y < request; y++)
+     for (x = 0; x < request; x++)
+       {
+          /* premultiplied gradients with some noise and alpha variation */
+          unsigned int a = 0x80 + ((x * y) & 0x7f);
+          unsigned int noise = (x * 7919 + y * 104729) & 0x1f;
+          unsigned int r = MIN(255, (x * 255) / request + noise);
+          unsigned int g = MIN(255, (y * 255) / request + noise);
+          unsigned int b = (x ^ y) & 0xff;
+
+          data[y * request + x] = (a << 24) |
+            ((r * a / 255) << 16) | ((g * a / 255) << 8) | (b * a / 255);
+       }
+   evas_object_image_data_set(o, data);
+
+   evas_object_image_save(o, dest, NULL, flags);
+
+   unlink(dest);
+   eina_tmpstr_del(dest);
+
+   evas_free(e);
+}
+
+static void
+evas_bench_saver_etc1(int request)
+{
+   _bench_saver_etc(request, "compress=1 quality=100 encoding=etc1+alpha");
+}
+
+static void
+evas_bench_saver_etc2(int request)
+{
+   _bench_saver_etc(request, "compress=1 quality=100 encoding=etc2");
+}
+
 void evas_bench_saver(Eina_Benchmark *bench)
 {
    eina_benchmark_register(bench, "tgv-saver", EINA_BENCHMARK(evas_bench_saver_tgv), 20, 2000, 100);
+   eina_benchmark_register(bench, "etc1-encode", EINA_BENCHMARK(evas_bench_saver_etc1), 128, 1024, 128);
+   eina_benchmark_register(bench, "etc2-encode", EINA_BENCHMARK(evas_bench_saver_etc2), 128, 1024, 128);
 }
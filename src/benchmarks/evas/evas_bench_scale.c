@@ -0,0 +1,139 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Smooth scales an alpha image onto a full HD frame, one case per path of
+ * the scaler, and prints the destination Mpixel/s of each run. The image
+ * is marked dirty before every frame so the scalecache never answers.
+ * Run with EVAS_CPU_NO_AVX2, EVAS_CPU_NO_SSE41 or EVAS_CPU_NO_MMX set to
+ * compare paths, and with EVAS_SCALECACHE_THREADS=1 for banded downscales. */
+#define WIDTH 1920
+#define HEIGHT 1080
+
+static Evas *
+_setup_evas(void **buffer)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   *buffer = malloc(sizeof (char) * WIDTH * HEIGHT * 4);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = *buffer;
+   einfo->info.dest_buffer_row_bytes = WIDTH * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, WIDTH, HEIGHT);
+   evas_output_viewport_set(evas, 0, 0, WIDTH, HEIGHT);
+
+   return evas;
+}
+
+static Evas_Object *
+_image_add(Evas *e, int w, int h)
+{
+   Evas_Object *o;
+   unsigned int *data;
+   int x, y;
+
+   o = evas_object_image_filled_add(e);
+   evas_object_image_size_set(o, w, h);
+   evas_object_image_alpha_set(o, EINA_TRUE);
+   evas_object_image_smooth_scale_set(o, EINA_TRUE);
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   for (y = 0; y < h; y++)
+     for (x = 0; x < w; x++)
+       {
+          unsigned int a = ((x * 3) + y) & 0xff;
+
+          data[(y * w) + x] = (a << 24) | ((a / 2) << 16) | ((a / 3) << 8) | (a / 4);
+       }
+   evas_object_image_data_set(o, data);
+   evas_object_geometry_set(o, 0, 0, WIDTH, HEIGHT);
+   evas_object_show(o);
+
+   return o;
+}
+
+static void
+_scale(const char *name, int w, int h, int request)
+{
+   struct timespec t0, t1;
+   Evas_Object *o;
+   void *buffer;
+   Evas *e;
+   double dt;
+   int i;
+
+   e = _setup_evas(&buffer);
+   o = _image_add(e, w, h);
+
+   clock_gettime(CLOCK_MONOTONIC, &t0);
+   for (i = 0; i < request; i++)
+     {
+        evas_object_image_data_update_add(o, 0, 0, w, h);
+        evas_damage_rectangle_add(e, 0, 0, WIDTH, HEIGHT);
+        evas_render(e);
+     }
+   clock_gettime(CLOCK_MONOTONIC, &t1);
+
+   dt = (t1.tv_sec - t0.tv_sec) + ((t1.tv_nsec - t0.tv_nsec) / 1000000000.0);
+   if (dt > 0.0)
+     fprintf(stderr, "scale-%s: %ix%i -> %ix%i, %i frames, %.1f Mpixel/s\n",
+             name, w, h, WIDTH, HEIGHT, request,
+             ((double)WIDTH * HEIGHT * request) / (dt * 1000000.0));
+
+   evas_free(e);
+   free(buffer);
+}
+
+static void
+evas_bench_scale_up(int request)
+{
+   _scale("up", WIDTH / 4, HEIGHT / 4, request);
+}
+
+static void
+evas_bench_scale_down(int request)
+{
+   _scale("down", WIDTH * 2, HEIGHT * 2, request);
+}
+
+static void
+evas_bench_scale_downx(int request)
+{
+   _scale("downx", WIDTH * 2, HEIGHT, request);
+}
+
+static void
+evas_bench_scale_downy(int request)
+{
+   _scale("downy", WIDTH, HEIGHT * 2, request);
+}
+
+static void
+evas_bench_scale_noscale(int request)
+{
+   _scale("noscale", WIDTH, HEIGHT, request);
+}
+
+void evas_bench_scale(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "scale-up", EINA_BENCHMARK(evas_bench_scale_up), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-down", EINA_BENCHMARK(evas_bench_scale_down), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-downx", EINA_BENCHMARK(evas_bench_scale_downx), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-downy", EINA_BENCHMARK(evas_bench_scale_downy), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-noscale", EINA_BENCHMARK(evas_bench_scale_noscale), 10, 100, 10);
+}
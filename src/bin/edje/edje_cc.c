@@ -45,6 +45,7 @@ int min_quality = 0;
 int max_quality = 100;
 int compress_mode = EET_COMPRESSION_HI;
 int threads = 0;
+int incremental = 0;
 int annotate = 0;
 int no_etc1 = 0;
 int no_etc2 = 0;
@@ -131,6 +132,7 @@ main_help(void)
       "-fastdecomp              Use a faster decompression algorithm (LZ4HC) (mutually exclusive with -fastcomp)\n"
       "-threads                 Compile the edje file using multiple parallel threads (by default)\n"
       "-nothreads               Compile the edje file using only the main loop\n"
+      "-incremental             Reuse unchanged images and scripts from an existing output file\n"
       "-N                       Use the first segment of each group name as a namespace to verify parts/signals\n"
       "-V [--version]           show program version\n"
      , progname);
@@ -300,6 +302,10 @@ main(int argc, char **argv)
           {
              threads = 0;
           }
+        else if (!strcmp(argv[i], "-incremental"))
+          {
+             incremental = 1;
+          }
         else if (!strncmp(argv[i], "-D", 2))
           {
              defines = eina_list_append(defines, mem_strdup(argv[i]));
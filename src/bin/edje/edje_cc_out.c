@@ -243,6 +243,19 @@ static int image_num;
 static Ecore_Evas *buffer_ee;
 static int cur_image_entry;
 
+/* incremental mode: copy of the previous output and the content digests
+ * of the images and scripts it holds (digest -> entry index) */
+static Eet_File *prev_ef = NULL;
+static Eina_Tmpstr *prev_path = NULL;
+static Eina_Hash *prev_images = NULL;
+static Eina_Hash *prev_scripts = NULL;
+static int reused_image_num = 0;
+static int reused_script_num = 0;
+
+#define INCREMENTAL_IMAGES "edje/incremental/images/"
+#define INCREMENTAL_SCRIPTS "edje/incremental/scripts/"
+#define DIGEST_LEN 41
+
 static void data_write_images(void);
 
 void
@@ -256,9 +269,134 @@ error_and_abort(Eet_File *ef EINA_UNUSED, const char *fmt, ...)
    va_end(ap);
    unlink(file_out);
    if (watchfile) unlink(watchfile);
+   if (prev_path) unlink(prev_path);
    exit(-1);
 }
 
+/* sha1 of a file content followed by the parameters it is compiled with,
+ * as an hexadecimal string */
+static Eina_Bool
+incremental_digest(const char *path, const char *params, char digest[DIGEST_LEN])
+{
+   unsigned char sha1[20];
+   Eina_Binbuf *buf;
+   Eina_File *f;
+   void *m;
+   Eina_Bool ret = EINA_FALSE;
+   int i;
+
+   f = eina_file_open(path, EINA_FALSE);
+   if (!f) return EINA_FALSE;
+   m = eina_file_map_all(f, EINA_FILE_SEQUENTIAL);
+   if (!m) goto on_error;
+
+   buf = eina_binbuf_new();
+   eina_binbuf_append_length(buf, m, eina_file_size_get(f));
+   eina_binbuf_append_length(buf, (const unsigned char *)params, strlen(params));
+   if ((!eina_file_map_faulted(f, m)) && (emile_binbuf_sha1(buf, sha1)))
+     {
+        for (i = 0; i < 20; i++)
+          snprintf(digest + (i * 2), 3, "%02x", sha1[i]);
+        ret = EINA_TRUE;
+     }
+   eina_binbuf_free(buf);
+   eina_file_map_free(f, m);
+
+on_error:
+   eina_file_close(f);
+   return ret;
+}
+
+static Eina_Hash *
+incremental_digests_load(const char *prefix)
+{
+   Eina_Hash *hash;
+   char glob[PATH_MAX];
+   char **keys;
+   int i, n = 0;
+
+   hash = eina_hash_string_superfast_new(NULL);
+   snprintf(glob, sizeof(glob), "%s*", prefix);
+   keys = eet_list(prev_ef, glob, &n);
+   for (i = 0; i < n; i++)
+     {
+        char *digest;
+        int size;
+
+        digest = eet_read(prev_ef, keys[i], &size);
+        if (!digest) continue;
+        if ((size == DIGEST_LEN) && (!digest[DIGEST_LEN - 1]))
+          eina_hash_set(hash, digest,
+                        (void *)(intptr_t)(atoi(keys[i] + strlen(prefix)) + 1));
+        free(digest);
+     }
+   free(keys);
+   return hash;
+}
+
+static void
+incremental_write(Eet_File *ef, const char *prefix, int id, const char *digest)
+{
+   char buf[PATH_MAX];
+
+   snprintf(buf, sizeof(buf), "%s%i", prefix, id);
+   eet_write(ef, buf, digest, DIGEST_LEN, 0);
+}
+
+/* returns the entry index the previous output had for this digest, or -1 */
+static int
+incremental_find(Eina_Hash *digests, const char *digest)
+{
+   if (!digests) return -1;
+   return (int)(intptr_t)eina_hash_find(digests, digest) - 1;
+}
+
+static void
+incremental_open(void)
+{
+   int fd;
+
+   if ((!incremental) || (!ecore_file_exists(file_out))) return;
+
+   /* the output is truncated when written, so read from a copy of it */
+   fd = eina_file_mkstemp("edje_cc.edj-prev-XXXXXX", &prev_path);
+   if (fd < 0)
+     {
+        WRN("Unable to create a copy of \"%s\", compiling everything.", file_out);
+        return;
+     }
+   close(fd);
+   if ((!eina_file_copy(file_out, prev_path, EINA_FILE_COPY_DATA, NULL, NULL)) ||
+       (!(prev_ef = eet_open(prev_path, EET_FILE_MODE_READ))))
+     {
+        WRN("Unable to read \"%s\", compiling everything.", file_out);
+        unlink(prev_path);
+        eina_tmpstr_del(prev_path);
+        prev_path = NULL;
+        return;
+     }
+
+   prev_images = incremental_digests_load(INCREMENTAL_IMAGES);
+   prev_scripts = incremental_digests_load(INCREMENTAL_SCRIPTS);
+}
+
+static void
+incremental_close(void)
+{
+   if (prev_ef) eet_close(prev_ef);
+   prev_ef = NULL;
+   if (prev_path)
+     {
+        unlink(prev_path);
+        eina_tmpstr_del(prev_path);
+        prev_path = NULL;
+     }
+   eina_hash_free(prev_images);
+   prev_images = NULL;
+   eina_hash_free(prev_scripts);
+   prev_scripts = NULL;
+}
+
 static void
 thread_end(Eina_Bool img)
 {
@@ -1107,6 +1245,45 @@ show_err:
      file, file_out, errmsg, hint);
 }
 
+/* the encoding the image entry ends up with, its source_param is changed
+ * when the one asked for is not allowed */
+static int
+data_image_mode_get(Edje_Image_Directory_Entry *img)
+{
+   int mode;
+
+   if ((img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_PERFECT) &&
+       (img->source_param == 0))
+     mode = 0;  /* RAW */
+   else if ((img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_PERFECT) &&
+            (img->source_param == 1))
+     mode = 1;  /* COMPRESS */
+   else if (img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_LOSSY_ETC1)
+     mode = 3;  /* LOSSY_ETC1 */
+   else if (img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_LOSSY_ETC2)
+     mode = 4;  /* LOSSY_ETC2 */
+   else
+     mode = 2;  /* LOSSY */
+   if ((mode == 0) && (no_raw))
+     {
+        mode = 1; /* promote compression */
+        img->source_param = 95;
+     }
+   if ((mode == 4) && (no_etc2)) mode = 2;  /* demote etc2 to jpeg */
+   if ((mode == 3) && (no_etc1)) mode = 2;  /* demote etc1 to jpeg */
+   if ((mode == 2) && (no_lossy)) mode = 1;  /* demote compression */
+   if ((mode == 1) && (no_comp))
+     {
+        if (no_lossy) mode = 0;  /* demote compression */
+        else if (no_raw)
+          {
+             img->source_param = 90;
+             mode = 2; /* no choice. lossy */
+          }
+     }
+   return mode;
+}
+
 static void
 data_thread_image(void *data, Ecore_Thread *thread EINA_UNUSED)
 {
@@ -1123,35 +1300,7 @@ data_thread_image(void *data, Ecore_Thread *thread EINA_UNUSED)
 
         snprintf(buf, sizeof(buf), "edje/images/%i", iw->img->id);
         qual = 80;
-        if ((iw->img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_PERFECT) &&
-            (iw->img->source_param == 0))
-          mode = 0;  /* RAW */
-        else if ((iw->img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_PERFECT) &&
-                 (iw->img->source_param == 1))
-          mode = 1;  /* COMPRESS */
-        else if (iw->img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_LOSSY_ETC1)
-          mode = 3;  /* LOSSY_ETC1 */
-        else if (iw->img->source_type == EDJE_IMAGE_SOURCE_TYPE_INLINE_LOSSY_ETC2)
-          mode = 4;  /* LOSSY_ETC2 */
-        else
-          mode = 2;  /* LOSSY */
-        if ((mode == 0) && (no_raw))
-          {
-             mode = 1; /* promote compression */
-             iw->img->source_param = 95;
-          }
-        if ((mode == 4) && (no_etc2)) mode = 2;  /* demote etc2 to jpeg */
-        if ((mode == 3) && (no_etc1)) mode = 2;  /* demote etc1 to jpeg */
-        if ((mode == 2) && (no_lossy)) mode = 1;  /* demote compression */
-        if ((mode == 1) && (no_comp))
-          {
-             if (no_lossy) mode = 0;  /* demote compression */
-             else if (no_raw)
-               {
-                  iw->img->source_param = 90;
-                  mode = 2; /* no choice. lossy */
-               }
-          }
+        mode = data_image_mode_get(iw->img);
         if (mode == 2)
           {
              qual = iw->img->source_param;
@@ -1476,6 +1625,76 @@ data_image_sets_init(void)
      }
 }
 
+static void
+data_image_entry_rename(Edje_Image_Directory_Entry *img)
+{
+   const char *ext;
+
+   if (img->source_type >= EDJE_IMAGE_SOURCE_TYPE_USER) return;
+   ext = strrchr(img->entry, '.');
+   if (ext && (!strcasecmp(ext, ".svg") || !strcasecmp(ext, ".svgz")))
+     {
+        int size = strlen(img->entry) + strlen(".png") + 1;
+        char *tmp = malloc(size);
+        snprintf(tmp, size, "%s.png", img->entry);
+        INF("Vector '%s' used as image, convert to bitmap '%s'", img->entry, tmp);
+        free((void *)img->entry);
+        img->entry = tmp;
+     }
+}
+
+/* copy the encoded image the previous output had for the same source file
+ * and encoding parameters instead of decoding and encoding it again */
+static Eina_Bool
+data_write_image_reuse(Edje_Image_Directory_Entry *img)
+{
+   char digest[DIGEST_LEN];
+   char params[256];
+   char buf[PATH_MAX];
+   const char *path = NULL;
+   Eina_List *ll;
+   char *s;
+   const void *dat;
+   int id, size;
+
+   if (!incremental) return EINA_FALSE;
+
+   EINA_LIST_FOREACH(img_dirs, ll, s)
+     {
+        snprintf(buf, sizeof(buf), "%s/%s", s, img->entry);
+        if (ecore_file_exists(buf))
+          {
+             path = buf;
+             break;
+          }
+     }
+   if ((!path) && (ecore_file_exists(img->entry))) path = img->entry;
+   if (!path) return EINA_FALSE;
+
+   snprintf(params, sizeof(params), "%i:%i:%i:%i:%i:%i:%i:%i:%i:%i",
+            img->source_type, img->source_param, no_lossy, no_comp, no_raw,
+            no_etc1, no_etc2, min_quality, max_quality, compress_mode);
+   if (!incremental_digest(path, params, digest)) return EINA_FALSE;
+   incremental_write(cur_ef, INCREMENTAL_IMAGES, img->id, digest);
+
+   id = incremental_find(prev_images, digest);
+   if (id < 0) return EINA_FALSE;
+   snprintf(buf, sizeof(buf), "edje/images/%i", id);
+   dat = eet_read_direct(prev_ef, buf, &size);
+   if (!dat) return EINA_FALSE;
+   snprintf(buf, sizeof(buf), "edje/images/%i", img->id);
+   /* the entry is already encoded, do not compress it a second time */
+   if (eet_write(cur_ef, buf, dat, size, 0) <= 0) return EINA_FALSE;
+
+   /* the entry in the image directory has to say what the copy is */
+   data_image_mode_get(img);
+   DBG("Reusing image '%s' from previous output", img->entry);
+   using_file(path, 'I');
+   image_num += 1;
+   reused_image_num += 1;
+   return EINA_TRUE;
+}
+
 static void
 data_write_images(void)
 {
@@ -1519,6 +1738,12 @@ data_write_images(void)
                }
           }
 
+        if (data_write_image_reuse(img))
+          {
+             data_image_entry_rename(img);
+             continue;
+          }
+
         iw = calloc(1, sizeof(Image_Write));
         iw->ef = cur_ef;
         iw->img = img;
@@ -1571,19 +1796,7 @@ data_write_images(void)
                }
           }
 
-        if (img->source_type < EDJE_IMAGE_SOURCE_TYPE_USER)
-          {
-             ext = strrchr(img->entry, '.');
-             if (ext && (!strcasecmp(ext, ".svg") || !strcasecmp(ext, ".svgz")))
-               {
-                  int size = strlen(img->entry) + strlen(".png") + 1;
-                  char *tmp = malloc(size);
-                  snprintf(tmp, size, "%s.png", img->entry);
-                  INF("Vector '%s' used as image, convert to bitmap '%s'", img->entry, tmp);
-                  free((void *)img->entry);
-                  img->entry = tmp;
-               }
-          }
+        data_image_entry_rename(img);
         if (threads)
           {
              if (pending_threads + pending_image_threads > (int)max_open_files - 2) break;
@@ -2266,8 +2479,9 @@ typedef struct
    Script_Write *sc;
 } Pending_Script_Write;
 
-#define PENDING_COMMANDS_MAX 8
+#define PENDING_COMMANDS_MIN 8
 
+static int pending_commands_max = 0;
 static int pending_write_commands = 0;
 static Eina_List *pending_script_writes = NULL;
 
@@ -2295,7 +2509,7 @@ data_scripts_exe_del_cb(void *data EINA_UNUSED, int evtype EINA_UNUSED, void *ev
    if (!ev->exe) return ECORE_CALLBACK_RENEW;
    if (ecore_exe_data_get(ev->exe) != sc) return ECORE_CALLBACK_RENEW;
    pending_write_commands--;
-   if (pending_write_commands < PENDING_COMMANDS_MAX)
+   if (pending_write_commands < pending_commands_max)
      {
         if (pending_script_writes)
           {
@@ -2329,7 +2543,7 @@ data_scripts_exe_del_cb(void *data EINA_UNUSED, int evtype EINA_UNUSED, void *ev
 static void
 data_write_script_queue(Script_Write *sc, const char *exeline)
 {
-   if (pending_write_commands >= PENDING_COMMANDS_MAX)
+   if (pending_write_commands >= pending_commands_max)
      {
         Pending_Script_Write *pend = malloc(sizeof(Pending_Script_Write));
         if (pend)
@@ -2361,12 +2575,61 @@ data_write_script_queue(Script_Write *sc, const char *exeline)
      }
 }
 
+/* reuse the bytecode the previous output had for the same script source */
+static Eina_Bool
+data_write_script_reuse(Script_Write *sc, const char *params)
+{
+   char digest[DIGEST_LEN];
+   char buf[PATH_MAX];
+   void *dat;
+   FILE *f;
+   int id, size;
+
+   if (!incremental) return EINA_FALSE;
+   if (!incremental_digest(sc->tmpn, params, digest)) return EINA_FALSE;
+   incremental_write(sc->ef, INCREMENTAL_SCRIPTS, sc->i, digest);
+
+   id = incremental_find(prev_scripts, digest);
+   if (id < 0) return EINA_FALSE;
+   snprintf(buf, sizeof(buf), "edje/scripts/embryo/compiled/%i", id);
+   dat = eet_read(prev_ef, buf, &size);
+   if (!dat) return EINA_FALSE;
+
+   f = fopen(sc->tmpo, "wb");
+   if (!f)
+     {
+        free(dat);
+        return EINA_FALSE;
+     }
+   if (fwrite(dat, size, 1, f) != 1)
+     {
+        fclose(f);
+        free(dat);
+        return EINA_FALSE;
+     }
+   fclose(f);
+   free(dat);
+
+   reused_script_num++;
+   pending_threads++;
+   if (threads)
+     ecore_thread_run(data_thread_script, data_thread_script_end, NULL, sc);
+   else
+     {
+        data_thread_script(sc, NULL);
+        data_thread_script_end(sc, NULL);
+     }
+   return EINA_TRUE;
+}
+
 static void
 data_write_scripts(Eet_File *ef)
 {
    Eina_List *l;
    char embryo_cc_path[PATH_MAX] = "";
    char inc_path[PATH_MAX] = "";
+   char params[PATH_MAX * 2 + 128];
+   struct stat st_cc, st_inc;
    int i;
 
 #ifdef _WIN32
@@ -2398,6 +2661,28 @@ data_write_scripts(Eet_File *ef)
      }
 #undef BIN_EXT
 
+   /* embryo_cc runs are independent, keep every core busy */
+   if (!pending_commands_max)
+     {
+        pending_commands_max = eina_cpu_count();
+        if (pending_commands_max < PENDING_COMMANDS_MIN)
+          pending_commands_max = PENDING_COMMANDS_MIN;
+     }
+
+   /* a script compiles the same as long as its source, the compiler and
+    * the edje include file do not change */
+   if (incremental)
+     {
+        snprintf(params, sizeof(params), "%s/edje.inc", inc_path);
+        if (stat(params, &st_inc)) memset(&st_inc, 0, sizeof(st_inc));
+        if (stat(embryo_cc_path, &st_cc)) memset(&st_cc, 0, sizeof(st_cc));
+        snprintf(params, sizeof(params), "%s:%lli:%lli:%s:%lli:%lli",
+                 embryo_cc_path,
+                 (long long)st_cc.st_size, (long long)st_cc.st_mtime,
+                 inc_path,
+                 (long long)st_inc.st_size, (long long)st_inc.st_mtime);
+     }
+
    for (i = 0, l = codes; l; l = eina_list_next(l), i++)
      {
         Code *cd = eina_list_data_get(l);
@@ -2430,6 +2715,7 @@ data_write_scripts(Eet_File *ef)
         //which have been fetched earlier
         close(fd);
         create_script_file(ef, sc->tmpn, cd, sc->tmpn_fd);
+        if (data_write_script_reuse(sc, params)) continue;
         snprintf(buf, sizeof(buf),
                  "%s -i %s -o %s %s", embryo_cc_path, inc_path,
                  sc->tmpo, sc->tmpn);
@@ -2825,6 +3111,7 @@ data_write(void)
         exit(-1);
      }
 
+   incremental_open();
    cur_ef = ef = eet_open(file_out, EET_FILE_MODE_WRITE);
    if (!ef)
      {
@@ -2937,6 +3224,7 @@ data_write(void)
      }
 
    err = eet_close(ef);
+   incremental_close();
    if (err)
      {
         ERR("Couldn't write file: \"%s\"", file_out);
@@ -2955,6 +3243,9 @@ data_write(void)
                image_num,
                sound_num,
                font_num);
+        if (incremental)
+          printf("  Reused %i images and %i scripts\n",
+                 reused_image_num, reused_script_num);
      }
 }
 
@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
 
 #include "main.h"
 #include "types.h"
@@ -35,13 +37,15 @@ _get_bit_pos(int flag)
 static void
 _print_usage(const char *progn, FILE *outf)
 {
-   fprintf(outf, "Usage: %s [options] [input]\n", progn);
+   fprintf(outf, "Usage: %s [options] [input...]\n", progn);
    fprintf(outf, "Options:\n"
                  "  -I inc        include path \"inc\"\n"
                  "  -S            do not scan system dir for eo files\n"
                  "  -g type       generate file of type \"type\"\n"
                  "  -o name       specify the base name for output\n"
                  "  -o type:name  specify a particular output filename\n"
+                 "  -O dir        write the outputs named after the input to \"dir\"\n"
+                 "  -C dir        keep parsed files cached in \"dir\"\n"
                  "  -h            print this message and exit\n"
                  "  -v            print version and exit\n"
                  "\n"
@@ -58,6 +62,16 @@ _print_usage(const char *progn, FILE *outf)
                  "by default, together with all specified '-I' flags.\n\n"
                  "Output filenames are determined from input .eo filename.\n"
                  "Default output path is where the input file is.\n\n"
+                 "Several input files can be given at once. They share the\n"
+                 "same database, so their common dependencies are parsed and\n"
+                 "validated only once. Output names can not be specified\n"
+                 "with '-o' in that case, use '-O' to put them somewhere else\n"
+                 "than next to the inputs. The one exception is the dependency\n"
+                 "file: '-o d:name' then writes a single rule for all inputs,\n"
+                 "with the first generated file as its target.\n\n"
+                 "The cache directory is created if needed. Files parsed once\n"
+                 "are loaded from there by later runs as long as neither they\n"
+                 "nor anything they depend on has changed.\n\n"
                  "Also, specifying a type-dependent input file automatically\n"
                  "adds it to generated files, so if you specify those, you\n"
                  "don't need to explicitly specify -g for those types anymore.\n\n"
@@ -199,9 +213,46 @@ _get_filename(const char *path)
    return ret2 + 1;
 }
 
+static Eina_Bool
+_file_same(const char *fname, const Eina_Strbuf *buf)
+{
+   Eina_File *f = eina_file_open(fname, EINA_FALSE);
+   if (!f)
+     return EINA_FALSE;
+
+   Eina_Bool ret = EINA_FALSE;
+   size_t bl = eina_strbuf_length_get(buf);
+   if (eina_file_size_get(f) != bl)
+     goto end;
+   if (!bl)
+     {
+        ret = EINA_TRUE;
+        goto end;
+     }
+
+   void *mem = eina_file_map_all(f, EINA_FILE_SEQUENTIAL);
+   if (mem)
+     {
+        ret = !memcmp(mem, eina_strbuf_string_get(buf), bl);
+        eina_file_map_free(f, mem);
+     }
+
+end:
+   eina_file_close(f);
+   return ret;
+}
+
 static Eina_Bool
 _write_file(const char *fname, const Eina_Strbuf *buf)
 {
+   /* leave the file and its timestamp alone when nothing changed, so
+    * that what includes it is not rebuilt for nothing */
+   if (_file_same(fname, buf))
+     {
+        DBG("unchanged: %s", fname);
+        return EINA_TRUE;
+     }
+
    FILE *f = fopen(fname, "wb");
    if (!f)
      {
@@ -432,6 +483,37 @@ _append_dep_line(Eina_Strbuf *buf, Eina_Strbuf *dbuf, char **outs, int gen_what,
    eina_strbuf_append_buffer(buf, dbuf);
 }
 
+static void
+_append_dep(Eina_Strbuf *dbuf, Eina_Hash *seen, const char *dpath)
+{
+   if (seen)
+     {
+        if (eina_hash_find(seen, dpath))
+          return;
+        eina_hash_add(seen, dpath, dpath);
+     }
+   eina_strbuf_append_char(dbuf, ' ');
+   eina_strbuf_append(dbuf, dpath);
+}
+
+/* appends the paths the unit was parsed from, skipping those in "seen" */
+static void
+_append_deps(const Eolian_Unit *un, Eina_Strbuf *dbuf, Eina_Hash *seen)
+{
+   /* every generated file depends on its .eo/.eot file */
+   _append_dep(dbuf, seen, eolian_unit_file_path_get(un));
+
+   const Eolian_Unit *dun;
+   Eina_Iterator *deps = eolian_unit_children_get(un);
+   EINA_ITERATOR_FOREACH(deps, dun)
+     {
+        const char *dpath = eolian_unit_file_path_get(dun);
+        if (dpath)
+          _append_dep(dbuf, seen, dpath);
+     }
+   eina_iterator_free(deps);
+}
+
 static Eina_Bool
 _write_deps(const Eolian_State *eos, const char *ofname, const char *ifname,
             char **outs, int gen_what)
@@ -449,21 +531,8 @@ _write_deps(const Eolian_State *eos, const char *ofname, const char *ifname,
         goto result;
      }
 
-   eina_strbuf_append(dbuf, ": ");
-   /* every generated file depends on its .eo/.eot file */
-   eina_strbuf_append(dbuf, eolian_unit_file_path_get(un));
-
-   const Eolian_Unit *dun;
-   Eina_Iterator *deps = eolian_unit_children_get(un);
-   EINA_ITERATOR_FOREACH(deps, dun)
-     {
-        const char *dpath = eolian_unit_file_path_get(dun);
-        if (!dpath)
-          continue;
-        eina_strbuf_append_char(dbuf, ' ');
-        eina_strbuf_append(dbuf, dpath);
-     }
-   eina_iterator_free(deps);
+   eina_strbuf_append(dbuf, ":");
+   _append_deps(un, dbuf, NULL);
    eina_strbuf_append_char(dbuf, '\n');
 
    _append_dep_line(buf, dbuf, outs, gen_what, GEN_H);
@@ -482,6 +551,54 @@ result:
    return ret;
 }
 
+static Eina_Bool
+_gen_input(Eolian_State *eos, const char *input, char **outs, char *basen,
+           const char *outdir, int gen_what)
+{
+   const char *ext = strrchr(input, '.');
+   if (!ext || (strcmp(ext, ".eo") && strcmp(ext, ".eot")))
+     {
+        fprintf(stderr, "eolian: invalid input file '%s'\n", input);
+        return EINA_FALSE;
+     }
+
+   if (!eolian_state_file_path_parse(eos, input))
+     {
+        fprintf(stderr, "eolian: could not parse file '%s'\n", input);
+        return EINA_FALSE;
+     }
+
+   const char *eobn = _get_filename(input);
+
+   char *dirbasen = NULL;
+   if (!basen && outdir)
+     {
+        dirbasen = malloc(strlen(outdir) + strlen(eobn) + 2);
+        sprintf(dirbasen, "%s/%s", outdir, eobn);
+        *strrchr(dirbasen, '.') = '\0';
+        basen = dirbasen;
+     }
+   _fill_all_outs(outs, input, basen);
+   free(dirbasen);
+
+   Eina_Bool succ = EINA_TRUE;
+   if (gen_what & GEN_H)
+     succ = _write_header(eos, eos, outs[_get_bit_pos(GEN_H)], eobn);
+   if (succ && (gen_what & GEN_H_STUB))
+     succ = _write_stub_header(eos, eos, outs[_get_bit_pos(GEN_H_STUB)], eobn);
+   if (succ && (gen_what & GEN_C))
+     succ = _write_source(eos, outs[_get_bit_pos(GEN_C)], eobn, !strcmp(ext, ".eot"));
+   if (succ && (gen_what & GEN_C_IMPL))
+     succ = _write_impl(eos, outs[_get_bit_pos(GEN_C_IMPL)], eobn);
+
+   if (succ && (gen_what & GEN_D_FULL))
+     succ = _write_deps(eos, outs[_get_bit_pos(GEN_D_FULL)], eobn, outs, gen_what);
+   else if (succ && (gen_what & GEN_D))
+     succ = _write_deps(eos, outs[_get_bit_pos(GEN_D)], eobn, outs, gen_what);
+
+   return succ;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -491,6 +608,10 @@ main(int argc, char **argv)
      NULL, NULL, NULL, NULL, NULL, NULL
    };
    char *basen = NULL;
+   char *depf = NULL, *deptgt = NULL;
+   const char *outdir = NULL;
+   Eina_Strbuf *mdeps = NULL;
+   Eina_Hash *seen = NULL;
    Eina_List *includes = NULL;
 
    eina_init();
@@ -511,7 +632,7 @@ main(int argc, char **argv)
    int gen_what = 0;
    Eina_Bool scan_system = EINA_TRUE;
 
-   for (int opt; (opt = getopt(argc, argv, "SI:g:o:hv")) != -1;)
+   for (int opt; (opt = getopt(argc, argv, "SI:g:o:O:C:hv")) != -1;)
      switch (opt)
        {
         case 0:
@@ -572,6 +693,18 @@ main(int argc, char **argv)
                basen = strdup(optarg);
             }
           break;
+        case 'O':
+          outdir = optarg;
+          break;
+        case 'C':
+          if (mkdir(optarg, S_IRWXU) && (errno != EEXIST))
+            {
+               fprintf(stderr, "eolian: could not create '%s' (%s)\n",
+                       optarg, strerror(errno));
+               goto end;
+            }
+          eolian_state_cache_dir_set(eos, optarg);
+          break;
         case 'h':
           _print_usage(argv[0], stdout);
           pret = 0;
@@ -585,18 +718,30 @@ main(int argc, char **argv)
           goto end;
        }
 
-   const char *input = argv[optind];
-   if (!input)
+   if (optind >= argc)
      {
         fprintf(stderr, "eolian: no input file\n");
         goto end;
      }
 
-   const char *ext = strrchr(input, '.');
-   if (!ext || (strcmp(ext, ".eo") && strcmp(ext, ".eot")))
+   Eina_Bool multi = (argc - optind) > 1;
+   if (multi)
      {
-        fprintf(stderr, "eolian: invalid input file '%s'\n", input);
-        goto end;
+        Eina_Bool named = !!basen;
+        for (size_t i = 0; i < (sizeof(_dexts) / sizeof(char *)); ++i)
+          if ((1 << i) != GEN_D && (1 << i) != GEN_D_FULL)
+            named = named || outs[i];
+        if (named)
+          {
+             fprintf(stderr, "eolian: output names can not be given with several input files\n");
+             goto end;
+          }
+        /* a named dependency file is shared by all the inputs */
+        if (outs[_get_bit_pos(GEN_D)] || outs[_get_bit_pos(GEN_D_FULL)])
+          {
+             mdeps = eina_strbuf_new();
+             seen = eina_hash_string_superfast_new(NULL);
+          }
      }
 
    if (scan_system)
@@ -618,36 +763,53 @@ main(int argc, char **argv)
           }
      }
 
-   if (!eolian_state_file_path_parse(eos, input))
-     {
-        fprintf(stderr, "eolian: could not parse file '%s'\n", input);
-        goto end;
-     }
-
-   _fill_all_outs(outs, input, basen);
-
-   const char *eobn = _get_filename(input);
-
    if (!gen_what)
      gen_what = GEN_H | GEN_C;
 
-   Eina_Bool succ = EINA_TRUE;
-   if (gen_what & GEN_H)
-     succ = _write_header(eos, eos, outs[_get_bit_pos(GEN_H)], eobn);
-   if (succ && (gen_what & GEN_H_STUB))
-     succ = _write_stub_header(eos, eos, outs[_get_bit_pos(GEN_H_STUB)], eobn);
-   if (succ && (gen_what & GEN_C))
-     succ = _write_source(eos, outs[_get_bit_pos(GEN_C)], eobn, !strcmp(ext, ".eot"));
-   if (succ && (gen_what & GEN_C_IMPL))
-     succ = _write_impl(eos, outs[_get_bit_pos(GEN_C_IMPL)], eobn);
+   int dep_what = 0;
+   if (mdeps)
+     {
+        dep_what = GEN_D | GEN_D_FULL;
+        int dpos = _get_bit_pos(outs[_get_bit_pos(GEN_D_FULL)] ? GEN_D_FULL : GEN_D);
+        depf = outs[dpos];
+        outs[dpos] = NULL;
+     }
 
-   if (succ && (gen_what & GEN_D_FULL))
-     succ = _write_deps(eos, outs[_get_bit_pos(GEN_D_FULL)], eobn, outs, gen_what);
-   else if (succ && (gen_what & GEN_D))
-     succ = _write_deps(eos, outs[_get_bit_pos(GEN_D)], eobn, outs, gen_what);
+   for (int i = optind; i < argc; ++i)
+     {
+        if (!_gen_input(eos, argv[i], outs, basen, outdir, gen_what & ~dep_what))
+          goto end;
+        if (mdeps)
+          {
+             const Eolian_Unit *un = eolian_state_unit_by_file_get(eos, _get_filename(argv[i]));
+             if (!un)
+               goto end;
+             _append_deps(un, mdeps, seen);
+          }
+        /* the output names of the next file are derived from its own name */
+        for (size_t j = 0; multi && (j < (sizeof(_dexts) / sizeof(char *))); ++j)
+          {
+             if (!deptgt && ((gen_what & ~dep_what) & (1 << j)))
+               deptgt = strdup(outs[j]);
+             free(outs[j]);
+             outs[j] = NULL;
+          }
+     }
 
-   if (!succ)
-     goto end;
+   if (mdeps)
+     {
+        if (!deptgt)
+          {
+             fprintf(stderr, "eolian: no generated file for the dependencies\n");
+             goto end;
+          }
+        INF("generating deps: %s", depf);
+        eina_strbuf_prepend_char(mdeps, ':');
+        eina_strbuf_prepend(mdeps, deptgt);
+        eina_strbuf_append_char(mdeps, '\n');
+        if (!_write_file(depf, mdeps))
+          goto end;
+     }
 
    pret = 0;
 end:
@@ -661,6 +823,11 @@ end:
    for (size_t i = 0; i < (sizeof(_dexts) / sizeof(char *)); ++i)
      free(outs[i]);
    free(basen);
+   free(depf);
+   free(deptgt);
+   if (mdeps)
+     eina_strbuf_free(mdeps);
+   eina_hash_free(seen);
 
    eolian_state_free(eos);
    eolian_shutdown();
@@ -5,6 +5,9 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <libgen.h>
 
 #include <string>
@@ -33,6 +36,7 @@ namespace eolian_cxx {
 struct options_type
 {
    std::vector<std::string> include_dirs;
+   std::string cache_dir;
    std::vector<std::string> in_files;
    mutable Eolian_State* state;
    mutable Eolian_Unit const* unit;
@@ -372,6 +376,15 @@ state_init(options_type const& opts)
           << "Eolian failed creating state";
         assert(false && "Error creating Eolian state");
      }
+   if (!opts.cache_dir.empty())
+     {
+        if (mkdir(opts.cache_dir.c_str(), S_IRWXU) && (errno != EEXIST))
+          EINA_CXX_DOM_LOG_WARN(eolian_cxx::domain)
+            << "Couldn't create '" << opts.cache_dir << "' ("
+            << strerror(errno) << ").";
+        else
+          ::eolian_state_cache_dir_set(eos, opts.cache_dir.c_str());
+     }
    opts.state = eos;
 }
 
@@ -428,6 +441,7 @@ _usage(const char *progname)
      << "  -c, --class <name>      The Eo class name to generate code for." << std::endl
      << "  -D, --out-dir <dir>     Output directory where generated code will be written." << std::endl
      << "  -I, --in <file/dir>     The source containing the .eo descriptions." << std::endl
+     << "  -C, --cache-dir <dir>   Keep the parsed .eo files cached in <dir>." << std::endl
      << "  -o, --out-file <file>   The output file name. [default: <classname>.eo.hh]" << std::endl
      << "  -n, --namespace <ns>    Wrap generated code in a namespace. [Eg: efl::ecore::file]" << std::endl
      << "  -r, --recurse           Recurse input directories loading .eo files." << std::endl
@@ -454,13 +468,14 @@ opts_get(int argc, char **argv)
    const struct option long_options[] =
      {
        { "in",          required_argument, nullptr, 'I' },
+       { "cache-dir",   required_argument, nullptr, 'C' },
        { "out-file",    required_argument, nullptr, 'o' },
        { "version",     no_argument,       nullptr, 'v' },
        { "help",        no_argument,       nullptr, 'h' },
        { "main-header", no_argument,       nullptr, 'm' },
        { nullptr,       0,                 nullptr,  0  }
      };
-   const char* options = "I:D:o:c::marvh";
+   const char* options = "I:C:D:o:c::marvh";
 
    int c, idx;
    while ( (c = getopt_long(argc, argv, options, long_options, &idx)) != -1)
@@ -469,6 +484,10 @@ opts_get(int argc, char **argv)
           {
              opts.include_dirs.push_back(optarg);
           }
+        else if (c == 'C')
+          {
+             opts.cache_dir = optarg;
+          }
         else if (c == 'o')
           {
              _assert_not_dup("o", opts.out_file);
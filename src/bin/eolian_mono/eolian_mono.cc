@@ -5,6 +5,9 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <libgen.h>
 
 #include <string>
@@ -41,6 +44,7 @@ namespace eolian_mono {
 struct options_type
 {
    std::vector<std::string> include_dirs;
+   std::string cache_dir;
    std::string in_file;
    std::string out_file;
    std::string examples_dir;
@@ -234,6 +238,15 @@ state_init(options_type const& opts)
           << "Eolian failed creating state";
         assert(false && "Error creating state");
      }
+   if (!opts.cache_dir.empty())
+     {
+        if (mkdir(opts.cache_dir.c_str(), S_IRWXU) && (errno != EEXIST))
+          EINA_CXX_DOM_LOG_WARN(eolian_mono::domain)
+            << "Couldn't create '" << opts.cache_dir << "' ("
+            << strerror(errno) << ").";
+        else
+          ::eolian_state_cache_dir_set(eos, opts.cache_dir.c_str());
+     }
    opts.state = eos;
    opts.unit = (Eolian_Unit*)eos;
 }
@@ -291,6 +304,7 @@ _usage(const char *progname)
      << "  -c, --class <name>      The Eo class name to generate code for." << std::endl
      << "  -D, --out-dir <dir>     Output directory where generated code will be written." << std::endl
      << "  -I, --in <file/dir>     The source containing the .eo descriptions." << std::endl
+     << "  -C, --cache-dir <dir>   Keep the parsed .eo files cached in <dir>." << std::endl
      << "  -o, --out-file <file>   The output file name. [default: <classname>.eo.cs]" << std::endl
      << "  -n, --namespace <ns>    Wrap generated code in a namespace. [Eg: Efl.Ui.Widget]" << std::endl
      << "  -r, --recurse           Recurse input directories loading .eo files." << std::endl
@@ -319,6 +333,7 @@ opts_get(int argc, char **argv)
    const struct option long_options[] =
      {
        { "in",        required_argument, 0,  'I' },
+       { "cache-dir", required_argument, 0,  'C' },
        { "out-file",  required_argument, 0,  'o' },
        { "version",   no_argument,       0,  'v' },
        { "help",      no_argument,       0,  'h' },
@@ -330,7 +345,7 @@ opts_get(int argc, char **argv)
        { "example-dir", required_argument, 0,  'e' },
        { 0,           0,                 0,   0  }
      };
-   const char* options = "I:D:o:c:M:m:ar:vhbe:";
+   const char* options = "I:C:D:o:c:M:m:ar:vhbe:";
 
    int c, idx;
    while ( (c = getopt_long(argc, argv, options, long_options, &idx)) != -1)
@@ -339,6 +354,10 @@ opts_get(int argc, char **argv)
           {
              opts.include_dirs.push_back(optarg);
           }
+        else if (c == 'C')
+          {
+             opts.cache_dir = optarg;
+          }
         else if (c == 'o')
           {
              _assert_not_dup("o", opts.out_file);
@@ -10,9 +10,12 @@
 typedef struct _Ecore_Future_Schedule_Entry
 {
    Eina_Future_Schedule_Entry base;
+   EINA_INLIST;
    Eina_Future_Scheduler_Cb cb;
    Eina_Future *future;
    Eina_Value value;
+   unsigned int serial;
+   Eina_Bool queued : 1;
 } Ecore_Future_Schedule_Entry;
 
 //////
@@ -134,39 +137,69 @@ EFL_CALLBACKS_ARRAY_DEFINE(ecore_future_callbacks,
                            { EFL_LOOP_EVENT_IDLE, _future_dispatch_cb },
                            { EFL_EVENT_DEL, _event_del_cb });
 
+static void
+_future_callbacks_update(Efl_Loop_Future_Scheduler *loopsched)
+{
+   if ((!!loopsched->future_entries) == loopsched->future_callbacks) return;
+   loopsched->future_callbacks = !!loopsched->future_entries;
+   if (loopsched->future_callbacks)
+     efl_event_callback_array_add((Eo *) loopsched->loop, ecore_future_callbacks(), loopsched);
+   else
+     efl_event_callback_array_del((Eo *) loopsched->loop, ecore_future_callbacks(), loopsched);
+}
+
+static Ecore_Future_Schedule_Entry *
+_future_entry_pop(Efl_Loop_Future_Scheduler *loopsched)
+{
+   Ecore_Future_Schedule_Entry *entry;
+
+   entry = EINA_INLIST_CONTAINER_GET(loopsched->future_entries,
+                                     Ecore_Future_Schedule_Entry);
+   loopsched->future_entries = eina_inlist_remove(loopsched->future_entries,
+                                                  loopsched->future_entries);
+   entry->queued = EINA_FALSE;
+   return entry;
+}
+
 static void
 _future_dispatch_cb(void *data, const Efl_Event *ev EINA_UNUSED)
 {
    Efl_Loop_Future_Scheduler *loopsched = data;
-   Eina_List *entries = loopsched->future_entries;
    Ecore_Future_Schedule_Entry *entry;
+   unsigned int last = loopsched->future_serial;
 
-   loopsched->future_entries = NULL;
-   efl_event_callback_array_del((Eo *) loopsched->loop, ecore_future_callbacks(), loopsched);
-
-   EINA_LIST_FREE(entries, entry)
+   // Deliver every future resolved so far in one go. The ones resolved by
+   // these callbacks are left for the next idle round, so a callback that
+   // keeps resolving futures can not starve the loop.
+   while (loopsched->future_entries)
      {
+        entry = EINA_INLIST_CONTAINER_GET(loopsched->future_entries,
+                                          Ecore_Future_Schedule_Entry);
+        if ((int)(entry->serial - last) > 0) break;
+
+        _future_entry_pop(loopsched);
         entry->cb(entry->future, entry->value);
         eina_mempool_free(mp_future_schedule_entry, entry);
      }
+
+   _future_callbacks_update(loopsched);
 }
 
 static void
 _event_del_cb(void *data, const Efl_Event *ev EINA_UNUSED)
 {
    Efl_Loop_Future_Scheduler *loopsched = data;
-   Eina_List *entries = loopsched->future_entries;
    Ecore_Future_Schedule_Entry *entry;
 
-   loopsched->future_entries = NULL;
-   efl_event_callback_array_del((Eo *) loopsched->loop, ecore_future_callbacks(), loopsched);
-
-   EINA_LIST_FREE(entries, entry)
+   while (loopsched->future_entries)
      {
+        entry = _future_entry_pop(loopsched);
         eina_future_cancel(entry->future);
         eina_value_flush(&entry->value);
         eina_mempool_free(mp_future_schedule_entry, entry);
      }
+
+   _future_callbacks_update(loopsched);
 }
 
 static Eina_Future_Schedule_Entry *
@@ -184,11 +217,12 @@ ecore_future_schedule(Eina_Future_Scheduler *sched,
    entry->cb = cb;
    entry->future = future;
    entry->value = value;
+   entry->serial = ++loopsched->future_serial;
+   entry->queued = EINA_TRUE;
 
-   if (!loopsched->future_entries)
-     efl_event_callback_array_add((Eo *) loopsched->loop, ecore_future_callbacks(), loopsched);
-
-   loopsched->future_entries = eina_list_append(loopsched->future_entries, entry);
+   loopsched->future_entries = eina_inlist_append(loopsched->future_entries,
+                                                  EINA_INLIST_GET(entry));
+   _future_callbacks_update(loopsched);
    return &entry->base;
 }
 
@@ -197,22 +231,19 @@ ecore_future_recall(Eina_Future_Schedule_Entry *s_entry)
 {
    Ecore_Future_Schedule_Entry *entry = (Ecore_Future_Schedule_Entry *)s_entry;
    Efl_Loop_Future_Scheduler *loopsched;
-   Eina_List *lookup;
 
    if (shutting_down) return;
+   // Already taken out of the queue to be dispatched or cancelled
+   if (!entry->queued) return;
 
    loopsched = (Efl_Loop_Future_Scheduler *) entry->base.scheduler;
 
-   lookup = eina_list_data_find_list(loopsched->future_entries, entry);
-   if (!lookup) return;
-
-   loopsched->future_entries = eina_list_remove_list(loopsched->future_entries, lookup);
-   if (!loopsched->future_entries)
-     efl_event_callback_array_del((Eo *) loopsched->loop, ecore_future_callbacks(), loopsched);
+   loopsched->future_entries = eina_inlist_remove(loopsched->future_entries,
+                                                  EINA_INLIST_GET(entry));
+   _future_callbacks_update(loopsched);
 
    eina_value_flush(&entry->value);
    eina_mempool_free(mp_future_schedule_entry, entry);
-
 }
 
 static Eina_Future_Scheduler ecore_future_scheduler = {
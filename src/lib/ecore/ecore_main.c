@@ -136,6 +136,11 @@ struct _Ecore_Fd_Handler
    Eina_Bool               delete_me : 1;
    Eina_Bool               file : 1;
    Eina_Bool               legacy : 1;
+#ifdef HAVE_IO_URING
+   Eina_Bool               uring_pending : 1;
+   Eina_Bool               uring_queued : 1;
+   Eina_Bool               uring_remove : 1;
+#endif
 };
 GENERIC_ALLOC_SIZE_DECLARE(Ecore_Fd_Handler);
 
@@ -304,6 +309,900 @@ _ecore_poll_events_from_fdh(Ecore_Fd_Handler *fdh)
 }
 #endif
 
+#ifdef HAVE_IO_URING
+// io_uring backend: each fd handler keeps a multishot poll request in the
+// ring that stays armed across events. Fd handlers are level triggered, so
+// a handler that fired gets its poll updated in place on the next
+// iteration, which makes the kernel check the fd again and complete right
+// away if it is still ready. Flag changes are such in place updates too.
+// Kernels without multishot polls (before 5.13) or completion skipping
+// (before 5.17) get one shot polls that are armed again once they fired.
+// Arming, updates, removals and the wait timeout are queued as submission
+// entries and handed to the kernel with a single io_uring_enter() per loop
+// iteration, which is also what sleeps. Completions are then read straight
+// from the shared ring. The backend is opt-in with ECORE_IO_URING=1 and
+// falls back to epoll when unavailable.
+// Efl.Io readers and writers that wait on the loop can also queue their
+// reads and writes in the ring (see _ecore_main_uring_io_read()), the
+// kernel then does them once the fd is ready instead of the loop waking
+// up for the poll and the object doing the syscall.
+// every fd that fired gets an update on the next iteration, so leave room
+// for a busy server's worth of them to go in with a single submit
+# define ECORE_URING_ENTRIES 1024
+// room for many fds becoming active in one go without overflowing
+# define ECORE_URING_CQ_ENTRIES 8192
+// fd handler pointers are never 0 nor odd, so these can't clash
+# define ECORE_URING_DATA_TIMEOUT ((__u64)0)
+# define ECORE_URING_DATA_REMOVE  ((__u64)1)
+// reads and writes: their Ecore_Main_Uring_Io pointer with this or'ed in,
+// which never makes it ECORE_URING_DATA_REMOVE
+# define ECORE_URING_DATA_IO      ((__u64)1)
+# if defined(IORING_POLL_ADD_MULTI) && defined(IORING_FEAT_CQE_SKIP)
+#  define ECORE_URING_MULTISHOT 1
+# endif
+// older headers lack it, the kernels they go with never set it either
+# ifndef IORING_CQE_F_MORE
+#  define IORING_CQE_F_MORE (1U << 1)
+# endif
+
+struct _Ecore_Main_Uring
+{
+   int                   fd;
+   pid_t                 pid;
+
+   void                 *sq_ring;
+   size_t                sq_ring_size;
+   unsigned int         *sq_head;
+   unsigned int         *sq_tail;
+   unsigned int         *sq_array;
+   unsigned int          sq_mask;
+   unsigned int          sq_entries;
+   unsigned int          sq_local_tail;
+   struct io_uring_sqe  *sqes;
+   size_t                sqes_size;
+
+   void                 *cq_ring;
+   size_t                cq_ring_size;
+   unsigned int         *cq_head;
+   unsigned int         *cq_tail;
+   unsigned int          cq_mask;
+   unsigned int          cq_entries;
+   struct io_uring_cqe  *cqes;
+
+   Ecore_Fd_Handler    **arm;
+   unsigned int          arm_count;
+   unsigned int          arm_size;
+
+   Eina_Inlist          *ios; // reads and writes in flight
+   Ecore_Main_Uring_Io  *io_retry; // in flight, waiting for room in the ring
+   Ecore_Main_Uring_Io  *io_done; // completed, callbacks not called yet
+   Ecore_Main_Uring_Io  *io_done_last;
+
+   Eina_Bool             multishot : 1;
+   Eina_Bool             rw : 1;
+   Eina_Bool             closing : 1;
+
+   // same layout as struct __kernel_timespec, which older headers lack
+   struct
+     {
+        long long        tv_sec;
+        long long        tv_nsec;
+     } ts;
+};
+
+struct _Ecore_Main_Uring_Io
+{
+   EINA_INLIST;
+   Ecore_Main_Uring_Io   *next; // in io_retry or io_done
+   Ecore_Main_Uring      *ur;
+   Ecore_Main_Uring_Io_Cb cb;
+   const void            *data;
+   unsigned char         *buf;
+   size_t                 len;
+   size_t                 done; // written so far
+   struct iovec           iov;
+   int                    fd;
+   int                    res;
+   Eina_Bool              write : 1;
+   Eina_Bool              poll : 1; // waiting for the fd to get ready
+   Eina_Bool              pending : 1; // in flight
+   Eina_Bool              retry : 1; // in io_retry
+   Eina_Bool              queued : 1; // in io_done
+};
+
+static void
+_ecore_main_uring_free(Ecore_Main_Uring *ur)
+{
+   if (ur->cq_ring) munmap(ur->cq_ring, ur->cq_ring_size);
+   if (ur->sqes) munmap(ur->sqes, ur->sqes_size);
+   if (ur->sq_ring) munmap(ur->sq_ring, ur->sq_ring_size);
+   if (ur->fd >= 0) close(ur->fd);
+   free(ur->arm);
+   free(ur);
+}
+
+static void *
+_ecore_main_uring_map(int fd, size_t size, off_t offset)
+{
+   void *ptr;
+
+   ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+              fd, offset);
+   if (ptr == MAP_FAILED) return NULL;
+   return ptr;
+}
+
+static Ecore_Main_Uring *
+_ecore_main_uring_new(void)
+{
+   struct io_uring_params p;
+   Ecore_Main_Uring *ur;
+   char *sq, *cq;
+
+   ur = calloc(1, sizeof(Ecore_Main_Uring));
+   if (!ur) return NULL;
+
+   memset(&p, 0, sizeof(p));
+   p.flags = IORING_SETUP_CQSIZE;
+   p.cq_entries = ECORE_URING_CQ_ENTRIES;
+   ur->fd = syscall(__NR_io_uring_setup, ECORE_URING_ENTRIES, &p);
+   if (ur->fd < 0)
+     {
+        WRN("io_uring not available (%s), falling back to epoll",
+            strerror(errno));
+        goto on_error;
+     }
+   if (!(p.features & IORING_FEAT_NODROP))
+     {
+        WRN("io_uring may drop completions, falling back to epoll");
+        goto on_error;
+     }
+   eina_file_close_on_exec(ur->fd, EINA_TRUE);
+# ifdef ECORE_URING_MULTISHOT
+   // updates must not post completions, they would end every sleep early
+   if (p.features & IORING_FEAT_CQE_SKIP) ur->multishot = EINA_TRUE;
+# endif
+# ifdef IORING_FEAT_RW_CUR_POS
+   // reads and writes at the current position of the fd, like read(2)
+   if (p.features & IORING_FEAT_RW_CUR_POS) ur->rw = EINA_TRUE;
+# endif
+
+   ur->sq_ring_size = p.sq_off.array + (p.sq_entries * sizeof(unsigned int));
+   ur->sq_ring = _ecore_main_uring_map(ur->fd, ur->sq_ring_size,
+                                       IORING_OFF_SQ_RING);
+   if (!ur->sq_ring) goto on_error;
+   ur->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+   ur->sqes = _ecore_main_uring_map(ur->fd, ur->sqes_size, IORING_OFF_SQES);
+   if (!ur->sqes) goto on_error;
+   ur->cq_ring_size = p.cq_off.cqes +
+     (p.cq_entries * sizeof(struct io_uring_cqe));
+   ur->cq_ring = _ecore_main_uring_map(ur->fd, ur->cq_ring_size,
+                                       IORING_OFF_CQ_RING);
+   if (!ur->cq_ring) goto on_error;
+
+   sq = ur->sq_ring;
+   ur->sq_head = (unsigned int *)(sq + p.sq_off.head);
+   ur->sq_tail = (unsigned int *)(sq + p.sq_off.tail);
+   ur->sq_array = (unsigned int *)(sq + p.sq_off.array);
+   ur->sq_mask = *(unsigned int *)(sq + p.sq_off.ring_mask);
+   ur->sq_entries = p.sq_entries;
+   ur->sq_local_tail = *ur->sq_tail;
+
+   cq = ur->cq_ring;
+   ur->cq_head = (unsigned int *)(cq + p.cq_off.head);
+   ur->cq_tail = (unsigned int *)(cq + p.cq_off.tail);
+   ur->cq_mask = *(unsigned int *)(cq + p.cq_off.ring_mask);
+   ur->cq_entries = p.cq_entries;
+   ur->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+   ur->pid = getpid();
+   return ur;
+
+on_error:
+   _ecore_main_uring_free(ur);
+   return NULL;
+}
+
+static int
+_ecore_main_uring_submit(Ecore_Main_Uring *ur, unsigned int wait_nr)
+{
+   unsigned int to_submit;
+
+   __atomic_store_n(ur->sq_tail, ur->sq_local_tail, __ATOMIC_RELEASE);
+   to_submit = ur->sq_local_tail - __atomic_load_n(ur->sq_head,
+                                                   __ATOMIC_ACQUIRE);
+   if ((!to_submit) && (!wait_nr)) return 0;
+   return syscall(__NR_io_uring_enter, ur->fd, to_submit, wait_nr,
+                  IORING_ENTER_GETEVENTS, NULL, 0);
+}
+
+static struct io_uring_sqe *
+_ecore_main_uring_sqe_get(Ecore_Main_Uring *ur)
+{
+   struct io_uring_sqe *sqe;
+   unsigned int idx;
+
+   if ((ur->sq_local_tail - __atomic_load_n(ur->sq_head, __ATOMIC_ACQUIRE))
+       >= ur->sq_entries)
+     {
+        // ring is full - hand what we have to the kernel without waiting
+        _ecore_main_uring_submit(ur, 0);
+        if ((ur->sq_local_tail - __atomic_load_n(ur->sq_head,
+                                                 __ATOMIC_ACQUIRE))
+            >= ur->sq_entries)
+          return NULL;
+     }
+   idx = ur->sq_local_tail & ur->sq_mask;
+   sqe = &(ur->sqes[idx]);
+   memset(sqe, 0, sizeof(*sqe));
+   ur->sq_array[idx] = idx;
+   ur->sq_local_tail++;
+   return sqe;
+}
+
+static Eina_Bool
+_ecore_main_uring_queue(Ecore_Main_Uring *ur, Ecore_Fd_Handler *fdh)
+{
+   if (fdh->uring_queued) return EINA_TRUE;
+   if (ur->arm_count == ur->arm_size)
+     {
+        Ecore_Fd_Handler **arm;
+        unsigned int size = ur->arm_size ? ur->arm_size * 2 : 64;
+
+        arm = realloc(ur->arm, size * sizeof(Ecore_Fd_Handler *));
+        if (!arm)
+          {
+             ERR("Cannot queue poll on fd %d", fdh->fd);
+             return EINA_FALSE;
+          }
+        ur->arm = arm;
+        ur->arm_size = size;
+     }
+   ur->arm[ur->arm_count++] = fdh;
+   fdh->uring_queued = EINA_TRUE;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_ecore_main_uring_poll_remove_sqe(Ecore_Main_Uring *ur, Ecore_Fd_Handler *fdh)
+{
+   struct io_uring_sqe *sqe;
+
+   sqe = _ecore_main_uring_sqe_get(ur);
+   if (!sqe) return EINA_FALSE;
+   // the poll completes with -ECANCELED, then gets armed again if needed
+   sqe->opcode = IORING_OP_POLL_REMOVE;
+   sqe->addr = (__u64)(uintptr_t)fdh;
+   sqe->user_data = ECORE_URING_DATA_REMOVE;
+# ifdef ECORE_URING_MULTISHOT
+   if (ur->multishot) sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+# endif
+   fdh->uring_remove = EINA_FALSE;
+   return EINA_TRUE;
+}
+
+static void
+_ecore_main_uring_poll_remove(Ecore_Main_Uring *ur, Ecore_Fd_Handler *fdh)
+{
+   if (!fdh->uring_pending) return;
+   if (_ecore_main_uring_poll_remove_sqe(ur, fdh)) return;
+   // the ring is full even after a submit, try again on the next loop
+   // iteration. the handler is not freed while its poll is pending.
+   fdh->uring_remove = EINA_TRUE;
+   if (!_ecore_main_uring_queue(ur, fdh))
+     WRN("io_uring submission queue full, poll on fd %d stays armed",
+         fdh->fd);
+}
+
+static int
+_ecore_main_uring_poll_events(Ecore_Fd_Handler *fdh)
+{
+   int events = 0;
+
+   if (fdh->flags & ECORE_FD_READ)  events |= POLLIN;
+   if (fdh->flags & ECORE_FD_WRITE) events |= POLLOUT;
+   if (fdh->flags & ECORE_FD_ERROR) events |= POLLERR | POLLPRI;
+   return events;
+}
+
+static Eina_Bool
+_ecore_main_uring_poll_add(Ecore_Main_Uring *ur, Ecore_Fd_Handler *fdh)
+{
+   struct io_uring_sqe *sqe;
+   int events = _ecore_main_uring_poll_events(fdh);
+
+   // nothing to wait for, eg. ECORE_FD_ALWAYS only handlers
+   if (!events) return EINA_TRUE;
+
+   sqe = _ecore_main_uring_sqe_get(ur);
+   if (!sqe) return EINA_FALSE;
+   sqe->opcode = IORING_OP_POLL_ADD;
+   sqe->fd = fdh->fd;
+   sqe->poll_events = events;
+   sqe->user_data = (__u64)(uintptr_t)fdh;
+# ifdef ECORE_URING_MULTISHOT
+   if (ur->multishot) sqe->len = IORING_POLL_ADD_MULTI;
+# endif
+   fdh->uring_pending = EINA_TRUE;
+   return EINA_TRUE;
+}
+
+# ifdef ECORE_URING_MULTISHOT
+static Eina_Bool
+_ecore_main_uring_poll_update(Ecore_Main_Uring *ur, Ecore_Fd_Handler *fdh)
+{
+   struct io_uring_sqe *sqe;
+   int events = _ecore_main_uring_poll_events(fdh);
+
+   if (!events)
+     {
+        if (_ecore_main_uring_poll_remove_sqe(ur, fdh)) return EINA_TRUE;
+        fdh->uring_remove = EINA_TRUE;
+        return EINA_FALSE;
+     }
+   sqe = _ecore_main_uring_sqe_get(ur);
+   if (!sqe) return EINA_FALSE;
+   // the kernel re-arms the poll with the new events and checks the fd
+   // again, so this completes the poll at once if the fd is still ready.
+   // if the poll ended meanwhile this fails, the poll's own completion
+   // without IORING_CQE_F_MORE then arms it again.
+   sqe->opcode = IORING_OP_POLL_REMOVE;
+   sqe->addr = (__u64)(uintptr_t)fdh;
+   sqe->len = IORING_POLL_UPDATE_EVENTS | IORING_POLL_ADD_MULTI;
+   sqe->poll_events = events;
+   sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+   sqe->user_data = ECORE_URING_DATA_REMOVE;
+   return EINA_TRUE;
+}
+# endif
+
+static void
+_ecore_main_uring_io_retry(Ecore_Main_Uring *ur, Ecore_Main_Uring_Io *io)
+{
+   io->next = ur->io_retry;
+   ur->io_retry = io;
+   io->retry = EINA_TRUE;
+}
+
+static void
+_ecore_main_uring_io_retry_del(Ecore_Main_Uring *ur, Ecore_Main_Uring_Io *io)
+{
+   Ecore_Main_Uring_Io **io_prev;
+
+   for (io_prev = &(ur->io_retry); *io_prev; io_prev = &((*io_prev)->next))
+     {
+        if (*io_prev != io) continue;
+        *io_prev = io->next;
+        break;
+     }
+   io->next = NULL;
+   io->retry = EINA_FALSE;
+}
+
+static Eina_Bool
+_ecore_main_uring_io_sqe(Ecore_Main_Uring *ur, Ecore_Main_Uring_Io *io)
+{
+   struct io_uring_sqe *sqe;
+
+   sqe = _ecore_main_uring_sqe_get(ur);
+   if (!sqe) return EINA_FALSE;
+   sqe->fd = io->fd;
+   sqe->user_data = (__u64)(uintptr_t)io | ECORE_URING_DATA_IO;
+   if (io->poll)
+     {
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->poll_events = io->write ? POLLOUT : POLLIN;
+        return EINA_TRUE;
+     }
+   io->iov.iov_base = io->buf + io->done;
+   io->iov.iov_len = io->len - io->done;
+   sqe->opcode = io->write ? IORING_OP_WRITEV : IORING_OP_READV;
+   sqe->addr = (__u64)(uintptr_t)&(io->iov);
+   sqe->len = 1;
+   sqe->off = (__u64)-1;
+   return EINA_TRUE;
+}
+
+static void
+_ecore_main_uring_io_complete(Ecore_Main_Uring *ur, Ecore_Main_Uring_Io *io,
+                              int res)
+{
+   Eina_Bool again = EINA_FALSE;
+
+   if (io->poll)
+     {
+        // the fd got ready, now the read or write
+        io->poll = EINA_FALSE;
+        again = (res > 0);
+     }
+   else if (res == -EAGAIN)
+     {
+        // older kernels don't wait on O_NONBLOCK fds, poll first then
+        io->poll = EINA_TRUE;
+        again = EINA_TRUE;
+     }
+   else if ((io->write) && (res > 0))
+     {
+        io->done += res;
+        // short write, send the rest
+        again = (io->done < io->len);
+        res = io->done;
+     }
+   if (again)
+     {
+        if (!ur->closing)
+          {
+             if (!_ecore_main_uring_io_sqe(ur, io))
+               _ecore_main_uring_io_retry(ur, io);
+             return;
+          }
+        res = -ECANCELED;
+     }
+   else if ((io->write) && (res == 0)) res = -EIO;
+
+   io->pending = EINA_FALSE;
+   ur->ios = eina_inlist_remove(ur->ios, EINA_INLIST_GET(io));
+   if (!io->cb)
+     {
+        free(io);
+        return;
+     }
+   io->res = res;
+   io->queued = EINA_TRUE;
+   io->next = NULL;
+   if (ur->io_done_last) ur->io_done_last->next = io;
+   else ur->io_done = io;
+   ur->io_done_last = io;
+}
+
+static int
+_ecore_main_uring_io_dispatch(Ecore_Main_Uring *ur)
+{
+   Ecore_Main_Uring_Io *io;
+   int count = 0;
+
+   // callbacks may queue or delete more of them
+   while ((io = ur->io_done))
+     {
+        ur->io_done = io->next;
+        if (!ur->io_done) ur->io_done_last = NULL;
+        io->next = NULL;
+        io->queued = EINA_FALSE;
+        // deleted after it completed, before getting here
+        if (!io->cb)
+          {
+             free(io);
+             continue;
+          }
+        io->cb((void *)io->data, io, io->res);
+        count++;
+     }
+   return count;
+}
+
+static Eina_Bool
+_ecore_main_uring_io_cancel(Ecore_Main_Uring *ur, Ecore_Main_Uring_Io *io)
+{
+   struct io_uring_sqe *sqe;
+
+   sqe = _ecore_main_uring_sqe_get(ur);
+   if (!sqe) return EINA_FALSE;
+   sqe->opcode = IORING_OP_ASYNC_CANCEL;
+   sqe->addr = (__u64)(uintptr_t)io | ECORE_URING_DATA_IO;
+   sqe->user_data = ECORE_URING_DATA_REMOVE;
+# ifdef ECORE_URING_MULTISHOT
+   if (ur->multishot) sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+# endif
+   return EINA_TRUE;
+}
+
+static Ecore_Main_Uring_Io *
+_ecore_main_uring_io_new(Eo *loop, int fd, size_t len, Eina_Bool write,
+                         Ecore_Main_Uring_Io_Cb cb, const void *data)
+{
+   Efl_Loop_Data *pd;
+   Ecore_Main_Uring *ur;
+   Ecore_Main_Uring_Io *io;
+
+   if ((fd < 0) || (len == 0) || (!cb)) return NULL;
+   pd = efl_data_scope_safe_get(loop, EFL_LOOP_CLASS);
+   if ((!pd) || (!pd->uring) || (!pd->uring->rw)) return NULL;
+   ur = pd->uring;
+   // a forked child has yet to get its own ring, a custom select function
+   // never waits on it
+   if ((ur->pid != getpid()) || (main_loop_select != general_loop_select))
+     return NULL;
+
+   io = calloc(1, sizeof(Ecore_Main_Uring_Io) + len);
+   if (!io) return NULL;
+   io->ur = ur;
+   io->cb = cb;
+   io->data = data;
+   io->buf = (unsigned char *)(io + 1);
+   io->len = len;
+   io->fd = fd;
+   io->write = write;
+   io->pending = EINA_TRUE;
+   return io;
+}
+
+static Ecore_Main_Uring_Io *
+_ecore_main_uring_io_queue(Ecore_Main_Uring_Io *io)
+{
+   if (!_ecore_main_uring_io_sqe(io->ur, io))
+     {
+        free(io);
+        return NULL;
+     }
+   io->ur->ios = eina_inlist_append(io->ur->ios, EINA_INLIST_GET(io));
+   return io;
+}
+
+static Eina_Bool
+_ecore_main_uring_io_reap(Ecore_Main_Uring *ur)
+{
+   unsigned int head, tail;
+
+   if (_ecore_main_uring_submit(ur, 1) < 0) return (errno == EINTR);
+   head = *ur->cq_head;
+   tail = __atomic_load_n(ur->cq_tail, __ATOMIC_ACQUIRE);
+   for (; head != tail; head++)
+     {
+        struct io_uring_cqe *cqe = &(ur->cqes[head & ur->cq_mask]);
+
+        if ((!(cqe->user_data & ECORE_URING_DATA_IO)) ||
+            (cqe->user_data == ECORE_URING_DATA_REMOVE))
+          continue;
+        _ecore_main_uring_io_complete
+          (ur, (Ecore_Main_Uring_Io *)(uintptr_t)
+           (cqe->user_data & ~ECORE_URING_DATA_IO), cqe->res);
+     }
+   __atomic_store_n(ur->cq_head, head, __ATOMIC_RELEASE);
+   return EINA_TRUE;
+}
+
+static void
+_ecore_main_uring_io_clear(Ecore_Main_Uring *ur)
+{
+   Ecore_Main_Uring_Io *io;
+   Eina_Bool wait = EINA_TRUE;
+
+   if (!ur->ios) return;
+   // nothing goes round again from here on
+   ur->closing = EINA_TRUE;
+   while ((io = ur->io_retry))
+     {
+        _ecore_main_uring_io_retry_del(ur, io);
+        _ecore_main_uring_io_complete(ur, io, -ECANCELED);
+     }
+   // a forked child shares the ring with its parent, leave that alone.
+   // otherwise wait for the kernel to let go of the buffers.
+   if (ur->pid != getpid()) wait = EINA_FALSE;
+   else
+     {
+        EINA_INLIST_FOREACH(ur->ios, io)
+          {
+             if (!_ecore_main_uring_io_cancel(ur, io)) wait = EINA_FALSE;
+          }
+     }
+   while ((wait) && (ur->ios))
+     wait = _ecore_main_uring_io_reap(ur);
+   while (ur->ios)
+     {
+        io = EINA_INLIST_CONTAINER_GET(ur->ios, Ecore_Main_Uring_Io);
+        _ecore_main_uring_io_complete(ur, io, -ECANCELED);
+     }
+}
+
+EAPI Ecore_Main_Uring_Io *
+_ecore_main_uring_io_read(Eo *loop, int fd, size_t len,
+                          Ecore_Main_Uring_Io_Cb cb, const void *data)
+{
+   Ecore_Main_Uring_Io *io;
+
+   io = _ecore_main_uring_io_new(loop, fd, len, EINA_FALSE, cb, data);
+   if (!io) return NULL;
+   return _ecore_main_uring_io_queue(io);
+}
+
+EAPI Ecore_Main_Uring_Io *
+_ecore_main_uring_io_write(Eo *loop, int fd, const void *mem, size_t len,
+                           Ecore_Main_Uring_Io_Cb cb, const void *data)
+{
+   Ecore_Main_Uring_Io *io;
+
+   io = _ecore_main_uring_io_new(loop, fd, len, EINA_TRUE, cb, data);
+   if (!io) return NULL;
+   memcpy(io->buf, mem, len);
+   return _ecore_main_uring_io_queue(io);
+}
+
+EAPI void *
+_ecore_main_uring_io_buf_get(const Ecore_Main_Uring_Io *io)
+{
+   return io->buf;
+}
+
+EAPI void
+_ecore_main_uring_io_del(Ecore_Main_Uring_Io *io)
+{
+   if (!io) return;
+   io->cb = NULL;
+   io->data = NULL;
+   // completed, the dispatch frees it
+   if (io->queued) return;
+   if (!io->pending)
+     {
+        free(io);
+        return;
+     }
+   if ((!io->write) && (io->retry))
+     {
+        // not in the kernel, between its poll and the read
+        _ecore_main_uring_io_retry_del(io->ur, io);
+        _ecore_main_uring_io_complete(io->ur, io, -ECANCELED);
+        return;
+     }
+   // freed once it ends. a read is cancelled, a write goes on so what the
+   // caller was told got written does. without room the read ends when
+   // data comes in, it is freed then.
+   if (!io->write) _ecore_main_uring_io_cancel(io->ur, io);
+   _ecore_main_uring_submit(io->ur, 0);
+}
+
+EAPI void
+_ecore_main_uring_io_flush(Eo *loop)
+{
+   Efl_Loop_Data *pd = efl_data_scope_safe_get(loop, EFL_LOOP_CLASS);
+
+   // queued requests name fds by number, the kernel must get them before
+   // the fd is closed and its number reused
+   if ((pd) && (pd->uring) && (pd->uring->pid == getpid()))
+     _ecore_main_uring_submit(pd->uring, 0);
+}
+
+static void
+_ecore_main_uring_setup(Efl_Loop_Data *pd)
+{
+   Ecore_Fd_Handler *fdh;
+   const char *s;
+
+   s = getenv("ECORE_IO_URING");
+   if ((!s) || (!atoi(s))) return;
+
+   pd->uring = _ecore_main_uring_new();
+   if (!pd->uring) return;
+   // queue polls on all our file descriptors
+   EINA_INLIST_FOREACH(pd->fd_handlers, fdh)
+     {
+        fdh->uring_pending = EINA_FALSE;
+        fdh->uring_queued = EINA_FALSE;
+        fdh->uring_remove = EINA_FALSE;
+        if (fdh->delete_me) continue;
+        _ecore_main_uring_queue(pd->uring, fdh);
+     }
+}
+
+static void
+_ecore_main_uring_clear(Efl_Loop_Data *pd)
+{
+   Ecore_Main_Uring *ur = pd->uring;
+   Ecore_Fd_Handler *fdh;
+
+   if (!ur) return;
+   _ecore_main_uring_io_clear(ur);
+   pd->uring = NULL;
+   // the kernel dropped all our polls with the ring
+   EINA_INLIST_FOREACH(pd->fd_handlers, fdh)
+     {
+        fdh->uring_pending = EINA_FALSE;
+        fdh->uring_queued = EINA_FALSE;
+        fdh->uring_remove = EINA_FALSE;
+     }
+   // reads and writes end with -ECANCELED, their owners go on without
+   // the ring
+   _ecore_main_uring_io_dispatch(ur);
+   _ecore_main_uring_free(ur);
+}
+
+static int
+_ecore_main_uring_wait(Eo *obj, Efl_Loop_Data *pd, struct timeval *t)
+{
+   Ecore_Main_Uring *ur = pd->uring;
+   struct io_uring_sqe *sqe;
+   unsigned int i, n, head, tail, wait_nr = 1;
+   int ret, err_no, count = 0;
+   Eina_Bool bad = EINA_FALSE, full;
+   Ecore_Main_Uring_Io *io, **io_prev;
+
+   // reads and writes that did not fit in the ring when going round
+   for (io_prev = &(ur->io_retry); (io = *io_prev);)
+     {
+        if (!_ecore_main_uring_io_sqe(ur, io)) break;
+        *io_prev = io->next;
+        io->retry = EINA_FALSE;
+     }
+
+   // arm new polls and update the ones that fired or changed flags, what
+   // does not fit stays queued
+   for (i = 0, n = 0; i < ur->arm_count; i++)
+     {
+        Ecore_Fd_Handler *fdh = ur->arm[i];
+        Eina_Bool ok = EINA_TRUE;
+
+        if (fdh->uring_remove)
+          {
+             // a removal that did not fit, the handler may be gone
+             if (fdh->uring_pending)
+               ok = _ecore_main_uring_poll_remove_sqe(ur, fdh);
+             else fdh->uring_remove = EINA_FALSE;
+          }
+        else if ((!fdh->delete_me) && (!fdh->uring_pending))
+          ok = _ecore_main_uring_poll_add(ur, fdh);
+# ifdef ECORE_URING_MULTISHOT
+        else if ((!fdh->delete_me) && (ur->multishot))
+          ok = _ecore_main_uring_poll_update(ur, fdh);
+# endif
+        if (!ok)
+          {
+             ur->arm[n++] = fdh;
+             continue;
+          }
+        fdh->uring_queued = EINA_FALSE;
+     }
+   ur->arm_count = n;
+
+   if ((t) && (!t->tv_sec) && (!t->tv_usec)) wait_nr = 0;
+   else if (t)
+     {
+        sqe = _ecore_main_uring_sqe_get(ur);
+        if (sqe)
+          {
+             // the kernel copies the timespec at submit time
+             ur->ts.tv_sec = t->tv_sec;
+             ur->ts.tv_nsec = (long long)t->tv_usec * 1000;
+             sqe->opcode = IORING_OP_TIMEOUT;
+             sqe->addr = (__u64)(uintptr_t)&(ur->ts);
+             sqe->len = 1;
+             // also completes as soon as any poll completes
+             sqe->off = 1;
+             sqe->user_data = ECORE_URING_DATA_TIMEOUT;
+          }
+        else wait_nr = 0;
+     }
+
+   ret = _ecore_main_uring_submit(ur, wait_nr);
+   err_no = errno;
+   if ((ret < 0) && (err_no != EINTR) && (err_no != EBUSY))
+     ERR("io_uring_enter failed: %s", strerror(err_no));
+
+   do
+     {
+        head = *ur->cq_head;
+        tail = __atomic_load_n(ur->cq_tail, __ATOMIC_ACQUIRE);
+        full = ((tail - head) >= ur->cq_entries);
+        for (; head != tail; head++)
+          {
+             struct io_uring_cqe *cqe = &(ur->cqes[head & ur->cq_mask]);
+             Ecore_Fd_Handler *fdh;
+             int res = cqe->res;
+
+             if ((cqe->user_data == ECORE_URING_DATA_TIMEOUT) ||
+                 (cqe->user_data == ECORE_URING_DATA_REMOVE))
+               continue;
+             if (cqe->user_data & ECORE_URING_DATA_IO)
+               {
+                  _ecore_main_uring_io_complete
+                    (ur, (Ecore_Main_Uring_Io *)(uintptr_t)
+                     (cqe->user_data & ~ECORE_URING_DATA_IO), res);
+                  continue;
+               }
+             fdh = (Ecore_Fd_Handler *)(uintptr_t)cqe->user_data;
+             // a multishot poll stays armed as long as this is set
+             if (!(cqe->flags & IORING_CQE_F_MORE))
+               {
+                  fdh->uring_pending = EINA_FALSE;
+                  fdh->uring_remove = EINA_FALSE;
+               }
+             if (fdh->delete_me) continue;
+             if (res == -ECANCELED)
+               {
+                  // removed by a flags change, arm with the new flags
+                  _ecore_main_uring_queue(ur, fdh);
+                  continue;
+               }
+             if (res == -EBADF)
+               {
+                  // bads_rem() deletes it if the fd is still closed on arming
+                  bad = EINA_TRUE;
+                  _ecore_main_uring_queue(ur, fdh);
+                  continue;
+               }
+             if (res < 0)
+               {
+                  ERR("Poll on fd %d failed: %s", fdh->fd, strerror(-res));
+                  fdh->error_active = EINA_TRUE;
+               }
+             else
+               {
+                  // report what select() would: a hang up or an error
+                  // makes the fd readable and an error writable, only
+                  // urgent data is an error. the kernel reports POLLHUP
+                  // and POLLERR even when not asked for, readers like
+                  // Efl.Io.Stdin take an error for the end of the stream
+                  // and would drop what is still buffered in the fd.
+                  if ((fdh->flags & ECORE_FD_READ) &&
+                      (res & (POLLIN | POLLHUP | POLLERR)))
+                    fdh->read_active = EINA_TRUE;
+                  if ((fdh->flags & ECORE_FD_WRITE) &&
+                      (res & (POLLOUT | POLLERR)))
+                    fdh->write_active = EINA_TRUE;
+                  if ((fdh->flags & ECORE_FD_ERROR) && (res & POLLPRI))
+                    fdh->error_active = EINA_TRUE;
+                  // nothing this handler waits for, eg. a hang up while
+                  // only errors are watched: leave it until its flags
+                  // change rather than have the poll fire over and over
+                  if ((!fdh->read_active) && (!fdh->write_active) &&
+                      (!fdh->error_active))
+                    continue;
+                  _ecore_main_uring_queue(ur, fdh);
+               }
+             if (!(fdh->flags & ECORE_FD_ALWAYS))
+               _ecore_try_add_to_call_list(obj, pd, fdh);
+             count++;
+          }
+        __atomic_store_n(ur->cq_head, head, __ATOMIC_RELEASE);
+        // a full completion ring means more can wait in the kernel
+        if (full)
+          syscall(__NR_io_uring_enter, ur->fd, 0, 0, IORING_ENTER_GETEVENTS,
+                  NULL, 0);
+     }
+   while (full);
+
+   if (bad) _ecore_main_fd_handlers_bads_rem(obj, pd);
+   // that may have reset the loop, which already called them
+   if (pd->uring) count += _ecore_main_uring_io_dispatch(pd->uring);
+   if (count > 0) return count;
+   if ((ret < 0) && (err_no == EINTR)) return -1;
+   return 0;
+}
+#else
+EAPI Ecore_Main_Uring_Io *
+_ecore_main_uring_io_read(Eo *loop EINA_UNUSED, int fd EINA_UNUSED,
+                          size_t len EINA_UNUSED,
+                          Ecore_Main_Uring_Io_Cb cb EINA_UNUSED,
+                          const void *data EINA_UNUSED)
+{
+   return NULL;
+}
+
+EAPI Ecore_Main_Uring_Io *
+_ecore_main_uring_io_write(Eo *loop EINA_UNUSED, int fd EINA_UNUSED,
+                           const void *mem EINA_UNUSED,
+                           size_t len EINA_UNUSED,
+                           Ecore_Main_Uring_Io_Cb cb EINA_UNUSED,
+                           const void *data EINA_UNUSED)
+{
+   return NULL;
+}
+
+EAPI void *
+_ecore_main_uring_io_buf_get(const Ecore_Main_Uring_Io *io EINA_UNUSED)
+{
+   return NULL;
+}
+
+EAPI void
+_ecore_main_uring_io_del(Ecore_Main_Uring_Io *io EINA_UNUSED)
+{
+}
+
+EAPI void
+_ecore_main_uring_io_flush(Eo *loop EINA_UNUSED)
+{
+}
+#endif
+
 #ifdef USE_G_MAIN_LOOP
 static inline int
 _gfd_events_from_fdh(Ecore_Fd_Handler *fdh)
@@ -372,6 +1271,14 @@ _ecore_main_fdh_poll_add(Efl_Loop_Data *pd EINA_UNUSED, Ecore_Fd_Handler *fdh)
    DBG("_ecore_main_fdh_poll_add");
    int r = 0;
 
+#ifdef HAVE_IO_URING
+   if (pd->uring)
+     {
+        if (!_ecore_main_uring_queue(pd->uring, fdh)) return -1;
+        return 0;
+     }
+#endif
+
 #ifdef HAVE_SYS_EPOLL_H
 # ifdef HAVE_LIBUV
    if (!_dl_uv_run)
@@ -427,6 +1334,17 @@ _ecore_main_fdh_poll_add(Efl_Loop_Data *pd EINA_UNUSED, Ecore_Fd_Handler *fdh)
 static inline void
 _ecore_main_fdh_poll_del(Efl_Loop_Data *pd, Ecore_Fd_Handler *fdh)
 {
+#ifdef HAVE_IO_URING
+   if ((pd) && (pd->uring))
+     {
+        // the poll holds a reference to the file, hand the removal to the
+        // kernel now so closing the fd right after this really closes it,
+        // eg. a socket peer sees the end of the stream
+        _ecore_main_uring_poll_remove(pd->uring, fdh);
+        _ecore_main_uring_submit(pd->uring, 0);
+        return;
+     }
+#endif
 #ifdef HAVE_SYS_EPOLL_H
 # ifdef HAVE_LIBUV
    if (!_dl_uv_run)
@@ -485,6 +1403,17 @@ _ecore_main_fdh_poll_modify(Efl_Loop_Data *pd EINA_UNUSED, Ecore_Fd_Handler *fdh
 {
    DBG("_ecore_main_fdh_poll_modify %p", fdh);
    int r = 0;
+#ifdef HAVE_IO_URING
+   if (pd->uring)
+     {
+        // one shot polls get removed and armed again, multishot polls
+        // are updated in place
+        if ((fdh->uring_pending) && (!pd->uring->multishot))
+          _ecore_main_uring_poll_remove(pd->uring, fdh);
+        else if (!_ecore_main_uring_queue(pd->uring, fdh)) r = -1;
+        return r;
+     }
+#endif
 #ifdef HAVE_SYS_EPOLL_H
 # ifdef HAVE_LIBUV
    if (!_dl_uv_run)
@@ -909,26 +1838,32 @@ _ecore_main_loop_setup(Eo *obj, Efl_Loop_Data *pd)
 {
    // Please note that this function is being also called in case of a bad
    // fd to reset the main loop.
-#ifdef HAVE_SYS_EPOLL_H
-   pd->epoll_fd = epoll_create(1);
-   if (pd->epoll_fd < 0) WRN("Failed to create epoll fd!");
-   else
+#ifdef HAVE_IO_URING
+   if (obj == ML_OBJ) _ecore_main_uring_setup(pd);
+   if (!pd->uring)
+#endif
      {
-        eina_file_close_on_exec(pd->epoll_fd, EINA_TRUE);
+#ifdef HAVE_SYS_EPOLL_H
+        pd->epoll_fd = epoll_create(1);
+        if (pd->epoll_fd < 0) WRN("Failed to create epoll fd!");
+        else
+          {
+             eina_file_close_on_exec(pd->epoll_fd, EINA_TRUE);
 
-        pd->epoll_pid = getpid();
+             pd->epoll_pid = getpid();
 
-        // add polls on all our file descriptors
-        Ecore_Fd_Handler *fdh;
-        EINA_INLIST_FOREACH(pd->fd_handlers, fdh)
-          {
-             if (fdh->delete_me) continue;
-             _ecore_epoll_add(pd->epoll_fd, fdh->fd,
-                              _ecore_poll_events_from_fdh(fdh), fdh);
-             _ecore_main_fdh_poll_add(pd, fdh);
+             // add polls on all our file descriptors
+             Ecore_Fd_Handler *fdh;
+             EINA_INLIST_FOREACH(pd->fd_handlers, fdh)
+               {
+                  if (fdh->delete_me) continue;
+                  _ecore_epoll_add(pd->epoll_fd, fdh->fd,
+                                   _ecore_poll_events_from_fdh(fdh), fdh);
+                  _ecore_main_fdh_poll_add(pd, fdh);
+               }
           }
-     }
 #endif
+     }
 
    if (obj == ML_OBJ)
      {
@@ -1068,6 +2003,9 @@ _ecore_main_loop_clear(Eo *obj, Efl_Loop_Data *pd)
           }
 #endif
      }
+#ifdef HAVE_IO_URING
+   _ecore_main_uring_clear(pd);
+#endif
 # ifdef HAVE_SYS_EPOLL_H
    if (pd->epoll_fd >= 0)
      {
@@ -1786,6 +2724,30 @@ _ecore_main_select(Eo *obj, Efl_Loop_Data *pd, double timeout)
    // call the prepare callback for all handlers
    if (pd->fd_handlers_with_prep) _ecore_main_prepare_handlers(obj, pd);
 
+#ifdef HAVE_IO_URING
+   if ((pd->uring) && (pd->uring->pid != getpid()))
+     { // forked - the child needs its own ring
+        _ecore_main_loop_clear(obj, pd);
+        _ecore_main_loop_setup(obj, pd);
+     }
+   // a custom select function has to see the fds, so no ring then
+   if ((pd->uring) && (main_loop_select == general_loop_select))
+     {
+        if (_ecore_signal_count_get(obj, pd)) return -1;
+
+        eina_evlog("<RUN", NULL, 0.0, NULL);
+        eina_evlog("!SLEEP", NULL, 0.0, t ? "timeout" : "forever");
+        ret = _ecore_main_uring_wait(obj, pd, t);
+        eina_evlog("!WAKE", NULL, 0.0, NULL);
+        eina_evlog(">RUN", NULL, 0.0, NULL);
+
+        _update_loop_time(pd);
+        if (ret < 0) outval = -1;
+        else outval = (ret > 0);
+        goto BAIL;
+     }
+#endif
+
 #ifdef HAVE_SYS_EPOLL_H
    if (pd->epoll_fd < 0)
      {
@@ -2026,6 +2988,10 @@ _ecore_main_fd_handlers_cleanup(Eo *obj EINA_UNUSED, Efl_Loop_Data *pd)
              continue;
           }
         if (fdh->references) continue;
+#ifdef HAVE_IO_URING
+        // the ring still points at it until its poll completed
+        if ((fdh->uring_pending) || (fdh->uring_queued)) continue;
+#endif
         if (pd->fd_handlers_to_call_current == fdh)
           pd->fd_handlers_to_call_current = NULL;
         if (fdh->buf_func && pd->fd_handlers_with_buffer)
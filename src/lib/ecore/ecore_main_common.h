@@ -94,3 +94,18 @@ timerfd_settime(int                      fd EINA_UNUSED,
    return -1;
 }
 #endif /* HAVE_TIMERFD_CREATE */
+
+//////////////////////////////////////////////////////////////////////////
+#ifdef HAVE_LINUX_IO_URING_H
+# include <linux/io_uring.h>
+# include <sys/syscall.h>
+# include <sys/mman.h>
+# include <sys/uio.h>
+# include <poll.h>
+/* need at least a 5.5 kernel header: completions must never be dropped,
+ * and the glib and libuv integrations have their own way of polling */
+# if defined(__NR_io_uring_setup) && defined(IORING_FEAT_NODROP) && \
+  !defined(USE_G_MAIN_LOOP) && !defined(HAVE_LIBUV)
+#  define HAVE_IO_URING 1
+# endif
+#endif /* HAVE_LINUX_IO_URING_H */
@@ -88,6 +88,8 @@ typedef struct _Ecore_Factorized_Idle Ecore_Factorized_Idle;
 typedef struct _Efl_Loop_Promise_Simple_Data Efl_Loop_Promise_Simple_Data;
 
 typedef struct _Efl_Loop_Timer_Data Efl_Loop_Timer_Data;
+typedef struct _Ecore_Main_Uring Ecore_Main_Uring;
+typedef struct _Ecore_Main_Uring_Io Ecore_Main_Uring_Io;
 typedef struct _Efl_Loop_Future_Scheduler Efl_Loop_Future_Scheduler;
 typedef struct _Efl_Loop_Data Efl_Loop_Data;
 
@@ -110,7 +112,9 @@ struct _Efl_Loop_Future_Scheduler
    const Eo              *loop;
    Efl_Loop_Data         *loop_data;
 
-   Eina_List             *future_entries;
+   Eina_Inlist           *future_entries;
+   unsigned int           future_serial;
+   Eina_Bool              future_callbacks : 1;
 };
 
 struct _Efl_Loop_Data
@@ -152,13 +156,17 @@ struct _Efl_Loop_Data
 
    int                  epoll_fd;
    pid_t                epoll_pid;
+   Ecore_Main_Uring    *uring;
    int                  timer_fd;
 
    double               last_check;
-   Eina_Inlist         *timers;
+   Efl_Loop_Timer_Data **timers; // 4-ary min-heap ordered by expiry time
+   unsigned int         timers_count;
+   unsigned int         timers_size;
+   unsigned int         timers_serial;
+   Eina_Inlist         *timers_added;
    Eina_Inlist         *suspended;
    Efl_Loop_Timer_Data *timer_current;
-   int                  timers_added;
 
    Eina_Value           exit_code;
 
@@ -295,6 +303,32 @@ EAPI void _ecore_magic_fail(const void *d,
                             Ecore_Magic req_m,
                             const char *fname);
 
+/* reads and writes queued in the io_uring of the loop (ECORE_IO_URING=1),
+ * they return NULL when there is none so the caller does the syscall.
+ * the callback gets the bytes read or written, or -errno, then the buffer
+ * is the caller's until _ecore_main_uring_io_del(). deleting a read in
+ * flight cancels it, a write in flight still goes out.
+ */
+typedef void (*Ecore_Main_Uring_Io_Cb)(void *data, Ecore_Main_Uring_Io *io, int res);
+
+EAPI Ecore_Main_Uring_Io *_ecore_main_uring_io_read(Eo *loop, int fd, size_t len, Ecore_Main_Uring_Io_Cb cb, const void *data);
+EAPI Ecore_Main_Uring_Io *_ecore_main_uring_io_write(Eo *loop, int fd, const void *mem, size_t len, Ecore_Main_Uring_Io_Cb cb, const void *data);
+EAPI void *_ecore_main_uring_io_buf_get(const Ecore_Main_Uring_Io *io);
+EAPI void  _ecore_main_uring_io_del(Ecore_Main_Uring_Io *io);
+/* hands what is queued to the kernel, call before closing an fd */
+EAPI void  _ecore_main_uring_io_flush(Eo *loop);
+
+/* Efl.Io.Reader_Fd and Efl.Io.Writer_Fd reading and writing through the
+ * loop's io_uring, for the classes that wait on Efl.Loop.Fd events. they
+ * return EINA_FALSE when the caller has to wait for the event and do the
+ * syscall itself.
+ */
+EAPI Eina_Bool _efl_io_reader_fd_ring_wait(Eo *o);
+EAPI Eina_Bool _efl_io_reader_fd_ring_read(Eo *o, Eina_Rw_Slice *rw_slice, Eina_Error *err);
+EAPI Eina_Bool _efl_io_reader_fd_ring_busy(const Eo *o);
+EAPI Eina_Bool _efl_io_writer_fd_ring_write(Eo *o, Eina_Slice *ro_slice, Eina_Slice *remaining, Eina_Error *err);
+EAPI Eina_Bool _efl_io_writer_fd_ring_busy(const Eo *o);
+
 void         _ecore_time_init(void);
 
 void        *_efl_loop_timer_del(Ecore_Timer *timer);
@@ -15,6 +15,22 @@
 
 #define ECORE_TIMER_CHECK(obj) if (!efl_isa((obj), MY_CLASS)) return
 
+/* Running timers are kept in a 4-ary min-heap ordered by expiry time, so
+ * that adding, delaying or removing one is O(log n) and the next one to
+ * expire is always at the top. Timers added during the current loop
+ * iteration wait in a separate list until _efl_loop_timer_enable_new(). */
+#define TIMER_HEAP_ARITY 4
+#define TIMER_HEAP_PARENT(Index) (((Index) - 1) / TIMER_HEAP_ARITY)
+#define TIMER_HEAP_CHILD(Index) (((Index) * TIMER_HEAP_ARITY) + 1)
+
+typedef enum _Efl_Loop_Timer_Queue
+{
+   TIMER_QUEUE_NONE = 0,
+   TIMER_QUEUE_HEAP,
+   TIMER_QUEUE_ADDED,
+   TIMER_QUEUE_SUSPENDED
+} Efl_Loop_Timer_Queue;
+
 struct _Ecore_Timer_Legacy
 {
    Ecore_Task_Cb func;
@@ -39,6 +55,10 @@ struct _Efl_Loop_Timer_Data
 
    int        listening;
 
+   unsigned int serial;
+   unsigned int heap_index;
+   Efl_Loop_Timer_Queue queue;
+
    Eina_Bool  just_added  : 1;
    Eina_Bool  frozen      : 1;
    Eina_Bool  initialized : 1;
@@ -51,6 +71,7 @@ typedef struct _Ecore_Timer_Legacy Ecore_Timer_Legacy;
 
 static void _efl_loop_timer_util_delay(Efl_Loop_Timer_Data *timer, double add);
 static void _efl_loop_timer_util_instanciate(Efl_Loop_Data *loop, Efl_Loop_Timer_Data *timer);
+static void _efl_loop_timer_util_loop_clear(Efl_Loop_Timer_Data *pd);
 static void _efl_loop_timer_set(Efl_Loop_Timer_Data *timer, double at, double in);
 
 static double precision = 10.0 / 1000000.0;
@@ -369,11 +390,7 @@ _efl_loop_timer_efl_object_event_thaw(Eo *obj, Efl_Loop_Timer_Data *timer)
    if (!timer->frozen) return; // Timer not frozen
    timer->frozen = 0;
 
-   if (timer->loop_data)
-     {
-        timer->loop_data->suspended = eina_inlist_remove
-          (timer->loop_data->suspended, EINA_INLIST_GET(timer));
-     }
+   _efl_loop_timer_util_loop_clear(timer);
    now = ecore_time_get();
    _efl_loop_timer_set(timer, timer->pending + now, timer->in);
 }
@@ -384,32 +401,140 @@ ecore_timer_dump(void)
    return NULL;
 }
 
+static inline Eina_Bool
+_efl_loop_timer_heap_before(const Efl_Loop_Timer_Data *a,
+                            const Efl_Loop_Timer_Data *b)
+{
+   if (a->at < b->at) return EINA_TRUE;
+   if (a->at > b->at) return EINA_FALSE;
+   // Same expiry time, the first one to be queued goes first
+   return ((int)(a->serial - b->serial)) < 0;
+}
+
+static inline void
+_efl_loop_timer_heap_place(Efl_Loop_Data *loop, Efl_Loop_Timer_Data *timer,
+                           unsigned int idx)
+{
+   loop->timers[idx] = timer;
+   timer->heap_index = idx;
+}
+
+static void
+_efl_loop_timer_heap_up(Efl_Loop_Data *loop, unsigned int idx)
+{
+   Efl_Loop_Timer_Data *timer = loop->timers[idx];
+
+   while (idx > 0)
+     {
+        unsigned int parent = TIMER_HEAP_PARENT(idx);
+
+        if (!_efl_loop_timer_heap_before(timer, loop->timers[parent])) break;
+        _efl_loop_timer_heap_place(loop, loop->timers[parent], idx);
+        idx = parent;
+     }
+   _efl_loop_timer_heap_place(loop, timer, idx);
+}
+
+static void
+_efl_loop_timer_heap_down(Efl_Loop_Data *loop, unsigned int idx)
+{
+   Efl_Loop_Timer_Data *timer = loop->timers[idx];
+
+   while (1)
+     {
+        unsigned int child, end, best;
+
+        child = TIMER_HEAP_CHILD(idx);
+        if (child >= loop->timers_count) break;
+        end = child + TIMER_HEAP_ARITY;
+        if (end > loop->timers_count) end = loop->timers_count;
+
+        for (best = child++; child < end; child++)
+          if (_efl_loop_timer_heap_before(loop->timers[child],
+                                          loop->timers[best]))
+            best = child;
+
+        if (!_efl_loop_timer_heap_before(loop->timers[best], timer)) break;
+        _efl_loop_timer_heap_place(loop, loop->timers[best], idx);
+        idx = best;
+     }
+   _efl_loop_timer_heap_place(loop, timer, idx);
+}
+
+static Eina_Bool
+_efl_loop_timer_heap_insert(Efl_Loop_Data *loop, Efl_Loop_Timer_Data *timer)
+{
+   if (loop->timers_count == loop->timers_size)
+     {
+        Efl_Loop_Timer_Data **tmp;
+        unsigned int size;
+
+        size = loop->timers_size ? loop->timers_size * 2 : 32;
+        tmp = realloc(loop->timers, size * sizeof (Efl_Loop_Timer_Data *));
+        if (!tmp)
+          {
+             ERR("Failed to grow the timer heap to %u entries.", size);
+             return EINA_FALSE;
+          }
+        loop->timers = tmp;
+        loop->timers_size = size;
+     }
+
+   timer->serial = loop->timers_serial++;
+   timer->queue = TIMER_QUEUE_HEAP;
+   loop->timers[loop->timers_count] = timer;
+   _efl_loop_timer_heap_up(loop, loop->timers_count++);
+   return EINA_TRUE;
+}
+
+static void
+_efl_loop_timer_heap_remove(Efl_Loop_Data *loop, Efl_Loop_Timer_Data *timer)
+{
+   Efl_Loop_Timer_Data *last;
+   unsigned int idx = timer->heap_index;
+
+   last = loop->timers[--loop->timers_count];
+   if (last == timer) return;
+
+   // Move the last timer in the hole and restore the heap around it
+   _efl_loop_timer_heap_place(loop, last, idx);
+   if ((idx > 0) &&
+       _efl_loop_timer_heap_before(last, loop->timers[TIMER_HEAP_PARENT(idx)]))
+     _efl_loop_timer_heap_up(loop, idx);
+   else
+     _efl_loop_timer_heap_down(loop, idx);
+}
+
 static void
 _efl_loop_timer_util_loop_clear(Efl_Loop_Timer_Data *pd)
 {
-   Eina_Inlist *first;
+   Efl_Loop_Data *loop = pd->loop_data;
 
-   if (!pd->loop_data) return;
-   // Check if we are the current timer, if so move along
-   if (pd->loop_data->timer_current == pd)
-     pd->loop_data->timer_current = (Efl_Loop_Timer_Data *)
-       EINA_INLIST_GET(pd)->next;
+   if (!loop) return;
 
-   // Remove the timer from all possible pending list
-   first = eina_inlist_first(EINA_INLIST_GET(pd));
-   if (first == pd->loop_data->timers)
-     pd->loop_data->timers = eina_inlist_remove
-       (pd->loop_data->timers, EINA_INLIST_GET(pd));
-   else if (first == pd->loop_data->suspended)
-     pd->loop_data->suspended = eina_inlist_remove
-       (pd->loop_data->suspended, EINA_INLIST_GET(pd));
+   // Remove the timer from the queue it is in
+   switch (pd->queue)
+     {
+      case TIMER_QUEUE_HEAP:
+        _efl_loop_timer_heap_remove(loop, pd);
+        break;
+      case TIMER_QUEUE_ADDED:
+        loop->timers_added = eina_inlist_remove
+          (loop->timers_added, EINA_INLIST_GET(pd));
+        break;
+      case TIMER_QUEUE_SUSPENDED:
+        loop->suspended = eina_inlist_remove
+          (loop->suspended, EINA_INLIST_GET(pd));
+        break;
+      default:
+        break;
+     }
+   pd->queue = TIMER_QUEUE_NONE;
 }
 
 static void
 _efl_loop_timer_util_instanciate(Efl_Loop_Data *loop, Efl_Loop_Timer_Data *timer)
 {
-   Efl_Loop_Timer_Data *t2;
-
    if (!loop) return;
    _efl_loop_timer_util_loop_clear(timer);
 
@@ -419,6 +544,7 @@ _efl_loop_timer_util_instanciate(Efl_Loop_Data *loop, Efl_Loop_Timer_Data *timer
      {
         loop->suspended = eina_inlist_prepend(loop->suspended,
                                               EINA_INLIST_GET(timer));
+        timer->queue = TIMER_QUEUE_SUSPENDED;
         return;
      }
 
@@ -428,17 +554,14 @@ _efl_loop_timer_util_instanciate(Efl_Loop_Data *loop, Efl_Loop_Timer_Data *timer
         return;
      }
 
-   EINA_INLIST_REVERSE_FOREACH(loop->timers, t2)
+   // New timers only join the heap once the loop enables them, and so do
+   // the ones that could not fit in it
+   if (timer->just_added || !_efl_loop_timer_heap_insert(loop, timer))
      {
-        if (timer->at > t2->at)
-          {
-             loop->timers = eina_inlist_append_relative(loop->timers,
-                                                        EINA_INLIST_GET(timer),
-                                                        EINA_INLIST_GET(t2));
-             return;
-          }
+        loop->timers_added = eina_inlist_append(loop->timers_added,
+                                                EINA_INLIST_GET(timer));
+        timer->queue = TIMER_QUEUE_ADDED;
      }
-   loop->timers = eina_inlist_prepend(loop->timers, EINA_INLIST_GET(timer));
 }
 
 static void
@@ -460,20 +583,12 @@ _efl_loop_timer_util_delay(Efl_Loop_Timer_Data *timer, double add)
 EOLIAN static void
 _efl_loop_timer_efl_object_parent_set(Eo *obj, Efl_Loop_Timer_Data *pd, Efl_Object *parent)
 {
-   Eina_Inlist *first;
-
    efl_parent_set(efl_super(obj, EFL_LOOP_TIMER_CLASS), parent);
 
    if ((!pd->constructed) || (!pd->finalized)) return;
 
    // Remove the timer from all possible pending list
-   first = eina_inlist_first(EINA_INLIST_GET(pd));
-   if (first == pd->loop_data->timers)
-     pd->loop_data->timers = eina_inlist_remove
-       (pd->loop_data->timers, EINA_INLIST_GET(pd));
-   else if (first == pd->loop_data->suspended)
-     pd->loop_data->suspended = eina_inlist_remove
-       (pd->loop_data->suspended, EINA_INLIST_GET(pd));
+   _efl_loop_timer_util_loop_clear(pd);
 
    if (efl_invalidated_get(obj)) return;
 
@@ -494,6 +609,8 @@ _efl_loop_timer_efl_object_parent_set(Eo *obj, Efl_Loop_Timer_Data *pd, Efl_Obje
 EOLIAN static void
 _efl_loop_timer_efl_object_destructor(Eo *obj, Efl_Loop_Timer_Data *pd)
 {
+   if (pd->loop_data && (pd->loop_data->timer_current == pd))
+     pd->loop_data->timer_current = NULL;
    _efl_loop_timer_util_loop_clear(pd);
    efl_destructor(efl_super(obj, MY_CLASS));
 }
@@ -503,59 +620,56 @@ _efl_loop_timer_enable_new(Eo *obj EINA_UNUSED, Efl_Loop_Data *pd)
 {
    Efl_Loop_Timer_Data *timer;
 
-   if (!pd->timers_added) return;
-   pd->timers_added = 0;
-   EINA_INLIST_FOREACH(pd->timers, timer) timer->just_added = 0;
+   while (pd->timers_added)
+     {
+        timer = EINA_INLIST_CONTAINER_GET(pd->timers_added,
+                                          Efl_Loop_Timer_Data);
+        if (!_efl_loop_timer_heap_insert(pd, timer)) break;
+        pd->timers_added = eina_inlist_remove(pd->timers_added,
+                                              pd->timers_added);
+        timer->just_added = 0;
+     }
 }
 
 int
 _efl_loop_timers_exists(Eo *obj EINA_UNUSED, Efl_Loop_Data *pd)
 {
-   return !!pd->timers;
+   return pd->timers_count || pd->timers_added;
 }
 
-static inline Ecore_Timer *
-_efl_loop_timer_first_get(Eo *ob EINA_UNUSED, Efl_Loop_Data *pd)
+static void
+_efl_loop_timer_heap_latest_get(Efl_Loop_Data *pd, unsigned int idx,
+                                double maxtime, double *latest)
 {
-   Efl_Loop_Timer_Data *timer;
-
-   EINA_INLIST_FOREACH(pd->timers, timer)
-     {
-        if (!timer->just_added) return timer->object;
-     }
-   return NULL;
-}
+   unsigned int child, end;
 
-static inline Efl_Loop_Timer_Data *
-_efl_loop_timer_after_get(Efl_Loop_Timer_Data *base)
-{
-   Efl_Loop_Timer_Data *timer;
-   Efl_Loop_Timer_Data *valid_timer = base;
-   double maxtime = base->at + precision;
+   // Children never expire before their parent, prune the whole subtree
+   if (pd->timers[idx]->at >= maxtime) return;
+   if (pd->timers[idx]->at > *latest) *latest = pd->timers[idx]->at;
 
-   EINA_INLIST_FOREACH(EINA_INLIST_GET(base)->next, timer)
-     {
-        if (EINA_UNLIKELY(!timer->initialized)) continue; // This shouldn't happen
-        if (timer->at >= maxtime) break;
-        if (!timer->just_added) valid_timer = timer;
-     }
-   return valid_timer;
+   child = TIMER_HEAP_CHILD(idx);
+   end = child + TIMER_HEAP_ARITY;
+   if (end > pd->timers_count) end = pd->timers_count;
+   for (; child < end; child++)
+     _efl_loop_timer_heap_latest_get(pd, child, maxtime, latest);
 }
 
 double
 _efl_loop_timer_next_get(Eo *obj, Efl_Loop_Data *pd)
 {
-   Ecore_Timer *object;
-   Efl_Loop_Timer_Data *first;
    double now;
+   double at;
    double in;
 
-   object = _efl_loop_timer_first_get(obj, pd);
-   if (!object) return -1;
+   if (!pd->timers_count) return -1;
+
+   // Wake up for the last timer expiring within precision of the first one
+   // so that they are all handled together
+   at = pd->timers[0]->at;
+   _efl_loop_timer_heap_latest_get(pd, 0, at + precision, &at);
 
-   first = _efl_loop_timer_after_get(efl_data_scope_get(object, MY_CLASS));
    now = efl_loop_time_get(obj);
-   in = first->at - now;
+   in = at - now;
    if (in < 0) in = 0;
    return in;
 }
@@ -563,14 +677,11 @@ _efl_loop_timer_next_get(Eo *obj, Efl_Loop_Data *pd)
 static inline void
 _efl_loop_timer_reschedule(Efl_Loop_Timer_Data *timer, double when)
 {
-   if (timer->frozen || efl_invalidated_get(timer->object)) return;
-
-   if (timer->loop_data &&
-       (EINA_INLIST_GET(timer)->next || EINA_INLIST_GET(timer)->prev))
+   if (timer->frozen) return;
+   if (efl_invalidated_get(timer->object))
      {
-        if (timer->loop_data->timers && (!timer->noparent))
-          timer->loop_data->timers = eina_inlist_remove
-            (timer->loop_data->timers, EINA_INLIST_GET(timer));
+        _efl_loop_timer_util_loop_clear(timer);
+        return;
      }
 
    /* if the timer would have gone off more than 15 seconds ago,
@@ -598,56 +709,49 @@ _efl_loop_timer_expired_timers_call(Eo *obj, Efl_Loop_Data *pd, double when)
 int
 _efl_loop_timer_expired_call(Eo *obj EINA_UNUSED, Efl_Loop_Data *pd, double when)
 {
-   if (!pd->timers) return 0;
-   if (pd->last_check > when)
-     {
-        Efl_Loop_Timer_Data *timer;
-        // User set time backwards
-        EINA_INLIST_FOREACH(pd->timers, timer)
-          timer->at -= (pd->last_check - when);
-     }
-   pd->last_check = when;
-
-   if (!pd->timer_current) // regular main loop, start from head
-     pd->timer_current = (Efl_Loop_Timer_Data *)pd->timers;
-   else
+   if (pd->timer_current)
      {
-        // recursive main loop, continue from where we were
+        // recursive main loop, reschedule the timer we were called from
         Efl_Loop_Timer_Data *timer_old = pd->timer_current;
 
-        pd->timer_current = (Efl_Loop_Timer_Data *)
-          EINA_INLIST_GET(pd->timer_current)->next;
+        pd->timer_current = NULL;
         _efl_loop_timer_reschedule(timer_old, when);
      }
 
-   while (pd->timer_current)
+   if (!_efl_loop_timers_exists(obj, pd)) return 0;
+   if (pd->last_check > when)
      {
-        Efl_Loop_Timer_Data *timer = pd->timer_current;
+        Efl_Loop_Timer_Data *timer;
+        unsigned int i;
 
-        if (timer->at > when)
-          {
-             pd->timer_current = NULL; // ended walk, next should restart.
-             return 0;
-          }
+        // User set time backwards, moving every timer by the same amount
+        // keeps the heap ordered
+        for (i = 0; i < pd->timers_count; i++)
+          pd->timers[i]->at -= (pd->last_check - when);
+        EINA_INLIST_FOREACH(pd->timers_added, timer)
+          timer->at -= (pd->last_check - when);
+     }
+   pd->last_check = when;
 
-        if (timer->just_added)
-          {
-             pd->timer_current = (Efl_Loop_Timer_Data *)
-               EINA_INLIST_GET(pd->timer_current)->next;
-             continue;
-          }
+   // timers added since the loop last enabled them are not in the heap
+   while (pd->timers_count)
+     {
+        Efl_Loop_Timer_Data *timer = pd->timers[0];
+
+        if (timer->at > when) return 0;
 
+        pd->timer_current = timer;
         efl_ref(timer->object);
         eina_evlog("+timer", timer, 0.0, NULL);
         efl_event_callback_call(timer->object, EFL_LOOP_TIMER_EVENT_TIMER_TICK, NULL);
         eina_evlog("-timer", timer, 0.0, NULL);
 
-        // may have changed in recursive main loops
-        // this current timer can not die yet as we hold a reference on it
-        if (pd->timer_current)
-          pd->timer_current = (Efl_Loop_Timer_Data *)
-            EINA_INLIST_GET(pd->timer_current)->next;
-        _efl_loop_timer_reschedule(timer, when);
+        // a recursive main loop may already have rescheduled it
+        if (pd->timer_current == timer)
+          {
+             pd->timer_current = NULL;
+             _efl_loop_timer_reschedule(timer, when);
+          }
         efl_unref(timer->object);
      }
    return 0;
@@ -657,7 +761,6 @@ static void
 _efl_loop_timer_set(Efl_Loop_Timer_Data *timer, double at, double in)
 {
    if (!timer->loop_data) return;
-   timer->loop_data->timers_added = 1;
    timer->in = in;
    timer->just_added = 1;
    timer->initialized = 1;
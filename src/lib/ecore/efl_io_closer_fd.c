@@ -49,6 +49,8 @@ _efl_io_closer_fd_efl_io_closer_close(Eo *o, Efl_Io_Closer_Fd_Data *pd EINA_UNUS
    EINA_SAFETY_ON_TRUE_RETURN_VAL(fd < 0, EBADF);
 
    efl_io_closer_fd_set(o, -1);
+   /* reads and writes queued in the loop's io_uring name the fd */
+   _ecore_main_uring_io_flush(efl_main_loop_get());
    if (close(fd) < 0) err = errno;
    efl_event_callback_call(o, EFL_IO_CLOSER_EVENT_CLOSED, NULL);
    return err;
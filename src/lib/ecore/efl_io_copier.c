@@ -1,14 +1,25 @@
 #define EFL_IO_COPIER_PROTECTED 1
+#define EFL_IO_READER_PROTECTED 1
+#define EFL_IO_WRITER_PROTECTED 1
 
 #ifdef HAVE_CONFIG_H
 # include <config.h>
 #endif
 
+#ifdef HAVE_SPLICE
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/socket.h>
+#endif
+
 #include <Ecore.h>
 #include "ecore_private.h"
 
 #define MY_CLASS EFL_IO_COPIER_CLASS
 #define DEF_READ_CHUNK_SIZE 4096
+#define DEF_SPLICE_PIPE_SIZE (256 * 1024)
 
 typedef struct _Efl_Io_Copier_Data
 {
@@ -29,6 +40,19 @@ typedef struct _Efl_Io_Copier_Data
    Eina_Bool force_dispatch;
    Eina_Bool close_on_exec;
    Eina_Bool close_on_invalidate;
+#ifdef HAVE_SPLICE
+   struct {
+      int pipefd[2];
+      size_t size; /* pipe capacity */
+      size_t pending; /* bytes read from source still in the pipe */
+      int source_fd, destination_fd; /* last checked */
+      Eina_Bool fds_usable;
+      Eina_Bool unsupported;
+   } splice;
+   struct {
+      unsigned int data, line;
+   } watchers;
+#endif
 } Efl_Io_Copier_Data;
 
 static void _efl_io_copier_write(Eo *o, Efl_Io_Copier_Data *pd);
@@ -120,7 +144,7 @@ _efl_io_copier_job(Eo *o, void *data EINA_UNUSED, const Eina_Value v)
    if (!pd->source || efl_io_reader_eos_get(pd->source))
      {
         if ((!pd->done) &&
-            ((!pd->destination) || (eina_binbuf_length_get(pd->buf) == 0)))
+            ((!pd->destination) || (efl_io_copier_pending_size_get(o) == 0)))
           efl_io_copier_done_set(o, EINA_TRUE);
      }
 
@@ -149,6 +173,256 @@ _efl_io_copier_job_schedule(Eo *o, Efl_Io_Copier_Data *pd)
      }
 }
 
+#ifdef HAVE_SPLICE
+/* Zero-copy path: when both ends are file descriptors the data is moved
+ * from source to destination using splice(2) through a pipe owned by the
+ * copier, never reaching user space. This is only done while nobody
+ * needs to see the data, ie: no line delimiter and no "data" or "line"
+ * event listeners, otherwise the pipe is drained into pd->buf and the
+ * regular buffered path is used.
+ *
+ * Data is never in both pd->buf and the pipe at the same time, this
+ * keeps it ordered.
+ */
+static Eina_Bool
+_efl_io_copier_splice_fd_check(int fd)
+{
+   struct stat st;
+   socklen_t len;
+   int type;
+
+   if (fd < 0) return EINA_FALSE;
+   if (fstat(fd, &st) != 0) return EINA_FALSE;
+   if (S_ISREG(st.st_mode) || S_ISFIFO(st.st_mode)) return EINA_TRUE;
+   if (!S_ISSOCK(st.st_mode)) return EINA_FALSE;
+
+   /* datagram boundaries would be lost */
+   len = sizeof(type);
+   if (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) != 0)
+     return EINA_FALSE;
+   return type == SOCK_STREAM;
+}
+
+static Eina_Bool
+_efl_io_copier_splice_pipe_new(Efl_Io_Copier_Data *pd)
+{
+   if (pipe(pd->splice.pipefd) != 0)
+     {
+        WRN("could not create splice pipe: %s", strerror(errno));
+        pd->splice.pipefd[0] = -1;
+        pd->splice.pipefd[1] = -1;
+        pd->splice.unsupported = EINA_TRUE;
+        return EINA_FALSE;
+     }
+   eina_file_close_on_exec(pd->splice.pipefd[0], EINA_TRUE);
+   eina_file_close_on_exec(pd->splice.pipefd[1], EINA_TRUE);
+
+   pd->splice.size = 65536;
+#if defined(F_SETPIPE_SZ) && defined(F_GETPIPE_SZ)
+   if (fcntl(pd->splice.pipefd[1], F_SETPIPE_SZ, DEF_SPLICE_PIPE_SIZE) < 0)
+     DBG("could not resize splice pipe: %s", strerror(errno));
+   else
+     {
+        int size = fcntl(pd->splice.pipefd[1], F_GETPIPE_SZ);
+        if (size > 0) pd->splice.size = size;
+     }
+#endif
+   return EINA_TRUE;
+}
+
+static void
+_efl_io_copier_splice_pipe_del(Efl_Io_Copier_Data *pd)
+{
+   if (pd->splice.pipefd[0] < 0) return;
+   close(pd->splice.pipefd[0]);
+   close(pd->splice.pipefd[1]);
+   pd->splice.pipefd[0] = -1;
+   pd->splice.pipefd[1] = -1;
+   pd->splice.pending = 0;
+}
+
+static Eina_Bool
+_efl_io_copier_splice_usable(Efl_Io_Copier_Data *pd)
+{
+   int source_fd, destination_fd;
+
+   if (pd->splice.unsupported) return EINA_FALSE;
+   if ((!pd->source) || (!pd->destination)) return EINA_FALSE;
+   if ((pd->line_delimiter.len > 0) ||
+       (pd->watchers.data > 0) || (pd->watchers.line > 0))
+     return EINA_FALSE;
+   if (eina_binbuf_length_get(pd->buf) > 0) return EINA_FALSE;
+   if ((!efl_isa(pd->source, EFL_IO_READER_FD_MIXIN)) ||
+       (!efl_isa(pd->destination, EFL_IO_WRITER_FD_MIXIN)))
+     return EINA_FALSE;
+   /* data read or written through the loop's io_uring would be overtaken */
+   if (_efl_io_reader_fd_ring_busy(pd->source) ||
+       _efl_io_writer_fd_ring_busy(pd->destination))
+     return EINA_FALSE;
+
+   /* sockets are usually connected, thus given a fd, after being set */
+   source_fd = efl_io_reader_fd_get(pd->source);
+   destination_fd = efl_io_writer_fd_get(pd->destination);
+   if ((source_fd != pd->splice.source_fd) ||
+       (destination_fd != pd->splice.destination_fd))
+     {
+        pd->splice.source_fd = source_fd;
+        pd->splice.destination_fd = destination_fd;
+        pd->splice.fds_usable =
+          _efl_io_copier_splice_fd_check(source_fd) &&
+          _efl_io_copier_splice_fd_check(destination_fd);
+     }
+   if (!pd->splice.fds_usable) return EINA_FALSE;
+
+   if (pd->splice.pipefd[0] < 0)
+     return _efl_io_copier_splice_pipe_new(pd);
+   return EINA_TRUE;
+}
+
+/* moves whatever is in the pipe to pd->buf, so the buffered path
+ * can take over.
+ */
+static void
+_efl_io_copier_splice_drain(Eo *o, Efl_Io_Copier_Data *pd)
+{
+   Eina_Error err;
+
+   while (pd->splice.pending > 0)
+     {
+        Eina_Rw_Slice rw_slice;
+        ssize_t r;
+
+        rw_slice = eina_binbuf_expand(pd->buf, pd->splice.pending);
+        if (rw_slice.len == 0)
+          {
+             err = ENOMEM;
+             efl_event_callback_call(o, EFL_IO_COPIER_EVENT_ERROR, &err);
+             return;
+          }
+
+        r = read(pd->splice.pipefd[0], rw_slice.mem, rw_slice.len);
+        if (r < 0)
+          {
+             if (errno == EINTR) continue;
+             err = errno;
+             efl_event_callback_call(o, EFL_IO_COPIER_EVENT_ERROR, &err);
+             return;
+          }
+        else if (r == 0)
+          {
+             CRI("copier %p splice pipe is empty, expected %zd bytes",
+                 o, pd->splice.pending);
+             pd->splice.pending = 0;
+             return;
+          }
+
+        eina_binbuf_use(pd->buf, r);
+        pd->splice.pending -= r;
+     }
+}
+
+/* returns EINA_FALSE if splice() can't be used for these fds */
+static Eina_Bool
+_efl_io_copier_splice_read(Eo *o, Efl_Io_Copier_Data *pd)
+{
+   Eina_Error err;
+   size_t len;
+   ssize_t r;
+
+   len = pd->splice.size;
+   if ((pd->buffer_limit > 0) && (pd->buffer_limit < len))
+     len = pd->buffer_limit;
+   if (len <= pd->splice.pending) return EINA_TRUE;
+   len -= pd->splice.pending;
+
+   /* never block on the source: readers like Efl.Io.Stdin keep a
+    * blocking fd and wait for the loop once their read() cleared
+    * can_read, which splice() skips. Nor wait for our own pipe to drain.
+    */
+   do
+     r = splice(pd->splice.source_fd, NULL, pd->splice.pipefd[1], NULL, len,
+                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+   while ((r < 0) && (errno == EINTR));
+
+   if (r < 0)
+     {
+        err = errno;
+        if (err == EAGAIN)
+          {
+             /* if the pipe has data it may be the one that is full */
+             if (pd->splice.pending == 0)
+               efl_io_reader_can_read_set(pd->source, EINA_FALSE);
+             return EINA_TRUE;
+          }
+        else if ((err == EINVAL) || (err == ENOSYS))
+          {
+             DBG("copier %p source %p can't splice, use buffered copy",
+                 o, pd->source);
+             pd->splice.unsupported = EINA_TRUE;
+             return EINA_FALSE;
+          }
+        efl_event_callback_call(o, EFL_IO_COPIER_EVENT_ERROR, &err);
+        return EINA_TRUE;
+     }
+   else if (r == 0)
+     {
+        efl_io_reader_can_read_set(pd->source, EINA_FALSE);
+        efl_io_reader_eos_set(pd->source, EINA_TRUE);
+        return EINA_TRUE;
+     }
+
+   pd->splice.pending += r;
+   pd->progress.read += r;
+   efl_io_copier_done_set(o, EINA_FALSE);
+
+   _efl_io_copier_job_schedule(o, pd);
+   return EINA_TRUE;
+}
+
+/* returns EINA_FALSE if splice() can't be used for these fds */
+static Eina_Bool
+_efl_io_copier_splice_write(Eo *o, Efl_Io_Copier_Data *pd)
+{
+   Eina_Error err;
+   ssize_t r;
+
+   /* the pipe has data, so this only blocks like write() would */
+   do
+     r = splice(pd->splice.pipefd[0], NULL, pd->splice.destination_fd, NULL,
+                pd->splice.pending, SPLICE_F_MOVE);
+   while ((r < 0) && (errno == EINTR));
+
+   if (r < 0)
+     {
+        err = errno;
+        if (err == EAGAIN)
+          {
+             efl_io_writer_can_write_set(pd->destination, EINA_FALSE);
+             return EINA_TRUE;
+          }
+        else if ((err == EINVAL) || (err == ENOSYS))
+          {
+             DBG("copier %p destination %p can't splice, use buffered copy",
+                 o, pd->destination);
+             pd->splice.unsupported = EINA_TRUE;
+             _efl_io_copier_splice_drain(o, pd);
+             return EINA_FALSE;
+          }
+        efl_event_callback_call(o, EFL_IO_COPIER_EVENT_ERROR, &err);
+        return EINA_TRUE;
+     }
+   else if (r == 0)
+     return EINA_TRUE;
+
+   pd->splice.pending -= r;
+   pd->progress.written += r;
+   efl_io_copier_done_set(o, EINA_FALSE);
+
+   _efl_io_copier_job_schedule(o, pd);
+   return EINA_TRUE;
+}
+#endif
+
 /* NOTE: the returned slice may be smaller than requested since the
  * internal binbuf may be modified from inside event calls.
  *
@@ -218,6 +492,14 @@ _efl_io_copier_read(Eo *o, Efl_Io_Copier_Data *pd)
 
    EINA_SAFETY_ON_TRUE_RETURN(pd->closed);
 
+#ifdef HAVE_SPLICE
+   if (_efl_io_copier_splice_usable(pd) &&
+       _efl_io_copier_splice_read(o, pd))
+     return;
+   /* what is in the pipe must be written before reading more */
+   if (pd->splice.pending > 0) return;
+#endif
+
    expand_size = pd->read_chunk_size;
    used = eina_binbuf_length_get(pd->buf);
    if (pd->buffer_limit > 0)
@@ -286,6 +568,11 @@ _efl_io_copier_write(Eo *o, Efl_Io_Copier_Data *pd)
    EINA_SAFETY_ON_TRUE_RETURN(pd->closed);
    EINA_SAFETY_ON_NULL_RETURN(pd->buf);
 
+#ifdef HAVE_SPLICE
+   if ((pd->splice.pending > 0) && _efl_io_copier_splice_write(o, pd))
+     return;
+#endif
+
    ro_slice = eina_binbuf_slice_get(pd->buf);
    if (ro_slice.len == 0)
      {
@@ -410,6 +697,14 @@ _efl_io_copier_source_set(Eo *o, Efl_Io_Copier_Data *pd, Efl_Io_Reader *source)
 {
    if (pd->source == source) return;
 
+#ifdef HAVE_SPLICE
+   /* pipe data was read for the old pair, write it the regular way */
+   _efl_io_copier_splice_drain(o, pd);
+   pd->splice.source_fd = -2;
+   pd->splice.destination_fd = -2;
+   pd->splice.unsupported = EINA_FALSE;
+#endif
+
    if (pd->source)
      {
         if (efl_isa(pd->source, EFL_IO_SIZER_MIXIN))
@@ -473,7 +768,7 @@ _efl_io_copier_destination_closed(void *data, const Efl_Event *event EINA_UNUSED
 
    _COPIER_DBG(o, pd);
 
-   if (eina_binbuf_length_get(pd->buf) == 0)
+   if (efl_io_copier_pending_size_get(o) == 0)
      {
         if (!pd->done)
           efl_io_copier_done_set(o, EINA_TRUE);
@@ -483,7 +778,7 @@ _efl_io_copier_destination_closed(void *data, const Efl_Event *event EINA_UNUSED
         Eina_Error err = EBADF;
         if (pd->inactivity_timer) eina_future_cancel(pd->inactivity_timer);
         WRN("copier %p destination %p closed with %zd bytes pending...",
-            o, pd->destination, eina_binbuf_length_get(pd->buf));
+            o, pd->destination, efl_io_copier_pending_size_get(o));
         efl_event_callback_call(o, EFL_IO_COPIER_EVENT_ERROR, &err);
      }
 }
@@ -502,6 +797,14 @@ _efl_io_copier_destination_set(Eo *o, Efl_Io_Copier_Data *pd, Efl_Io_Writer *des
 {
    if (pd->destination == destination) return;
 
+#ifdef HAVE_SPLICE
+   /* pipe data was read for the old pair, write it the regular way */
+   _efl_io_copier_splice_drain(o, pd);
+   pd->splice.source_fd = -2;
+   pd->splice.destination_fd = -2;
+   pd->splice.unsupported = EINA_FALSE;
+#endif
+
    if (pd->destination)
      {
         efl_event_callback_array_del(pd->destination, destination_cbs(), o);
@@ -560,6 +863,10 @@ _efl_io_copier_buffer_limit_get(const Eo *o EINA_UNUSED, Efl_Io_Copier_Data *pd)
 EOLIAN static void
 _efl_io_copier_line_delimiter_set(Eo *o EINA_UNUSED, Efl_Io_Copier_Data *pd, Eina_Slice slice)
 {
+#ifdef HAVE_SPLICE
+   if (slice.len > 0) _efl_io_copier_splice_drain(o, pd);
+#endif
+
    if (pd->line_delimiter.mem == slice.mem)
      {
         pd->line_delimiter.len = slice.len;
@@ -610,6 +917,11 @@ _efl_io_copier_efl_io_closer_close(Eo *o, Efl_Io_Copier_Data *pd)
 
    _COPIER_DBG(o, pd);
 
+#ifdef HAVE_SPLICE
+   /* final write goes through the buffered path */
+   _efl_io_copier_splice_drain(o, pd);
+#endif
+
    while (pd->buf)
      {
         size_t pending = eina_binbuf_length_get(pd->buf);
@@ -679,6 +991,9 @@ _efl_io_copier_efl_io_closer_close(Eo *o, Efl_Io_Copier_Data *pd)
      }
 
    pd->closed = EINA_TRUE;
+#ifdef HAVE_SPLICE
+   _efl_io_copier_splice_pipe_del(pd);
+#endif
    efl_event_callback_call(o, EFL_IO_CLOSER_EVENT_CLOSED, NULL);
 
    if (pd->buf)
@@ -771,7 +1086,7 @@ _efl_io_copier_flush(Eo *o, Efl_Io_Copier_Data *pd, Eina_Bool may_block, Eina_Bo
    if (!pd->source || efl_io_reader_eos_get(pd->source))
      {
         if ((!pd->done) &&
-            ((!pd->destination) || (eina_binbuf_length_get(pd->buf) == 0)))
+            ((!pd->destination) || (efl_io_copier_pending_size_get(o) == 0)))
           efl_io_copier_done_set(o, EINA_TRUE);
      }
 
@@ -781,7 +1096,11 @@ _efl_io_copier_flush(Eo *o, Efl_Io_Copier_Data *pd, Eina_Bool may_block, Eina_Bo
 EOLIAN static size_t
 _efl_io_copier_pending_size_get(const Eo *o EINA_UNUSED, Efl_Io_Copier_Data *pd)
 {
-   return pd->buf ? eina_binbuf_length_get(pd->buf) : 0;
+   size_t pending = pd->buf ? eina_binbuf_length_get(pd->buf) : 0;
+#ifdef HAVE_SPLICE
+   pending += pd->splice.pending;
+#endif
+   return pending;
 }
 
 EOLIAN static Eina_Bool
@@ -789,7 +1108,7 @@ _efl_io_copier_done_get(const Eo *o, Efl_Io_Copier_Data *pd)
 {
    DBG("%p done=%d pending=%zd source={%p %s, eos=%d, closed=%d}, destination={%p %s, closed=%d}",
        o, pd->done,
-       pd->buf ? eina_binbuf_length_get(pd->buf) : 0,
+       efl_io_copier_pending_size_get(o),
        pd->source,
        pd->source ? efl_class_name_get(pd->source) : "",
        pd->source ? efl_io_reader_eos_get(pd->source) : 1,
@@ -812,6 +1131,48 @@ _efl_io_copier_done_set(Eo *o, Efl_Io_Copier_Data *pd, Eina_Bool value)
 }
 
 
+#ifdef HAVE_SPLICE
+static void
+_efl_io_copier_event_catcher_add(void *data, const Efl_Event *event)
+{
+   const Efl_Callback_Array_Item_Full *array = event->info;
+   Efl_Io_Copier_Data *pd = data;
+   int i;
+
+   for (i = 0; array[i].desc != NULL; i++)
+     {
+        if (array[i].desc == EFL_IO_COPIER_EVENT_DATA)
+          pd->watchers.data++;
+        else if (array[i].desc == EFL_IO_COPIER_EVENT_LINE)
+          pd->watchers.line++;
+        else continue;
+
+        /* listeners must see the data, stop splicing */
+        _efl_io_copier_splice_drain(event->object, pd);
+     }
+}
+
+static void
+_efl_io_copier_event_catcher_del(void *data, const Efl_Event *event)
+{
+   const Efl_Callback_Array_Item_Full *array = event->info;
+   Efl_Io_Copier_Data *pd = data;
+   int i;
+
+   for (i = 0; array[i].desc != NULL; i++)
+     {
+        if (array[i].desc == EFL_IO_COPIER_EVENT_DATA)
+          pd->watchers.data--;
+        else if (array[i].desc == EFL_IO_COPIER_EVENT_LINE)
+          pd->watchers.line--;
+     }
+}
+
+EFL_CALLBACKS_ARRAY_DEFINE(copier_watch,
+                          { EFL_EVENT_CALLBACK_ADD, _efl_io_copier_event_catcher_add },
+                          { EFL_EVENT_CALLBACK_DEL, _efl_io_copier_event_catcher_del });
+#endif
+
 EOLIAN static Eo *
 _efl_io_copier_efl_object_constructor(Eo *o, Efl_Io_Copier_Data *pd)
 {
@@ -819,6 +1180,13 @@ _efl_io_copier_efl_object_constructor(Eo *o, Efl_Io_Copier_Data *pd)
    pd->close_on_exec = EINA_TRUE;
    pd->close_on_invalidate = EINA_TRUE;
    pd->timeout_inactivity = 0.0;
+#ifdef HAVE_SPLICE
+   pd->splice.pipefd[0] = -1;
+   pd->splice.pipefd[1] = -1;
+   pd->splice.source_fd = -2;
+   pd->splice.destination_fd = -2;
+   efl_event_callback_array_add(o, copier_watch(), pd);
+#endif
 
    EINA_SAFETY_ON_NULL_RETURN_VAL(pd->buf, NULL);
 
@@ -876,6 +1244,10 @@ _efl_io_copier_efl_object_destructor(Eo *o, Efl_Io_Copier_Data *pd)
 
    efl_destructor(efl_super(o, MY_CLASS));
 
+#ifdef HAVE_SPLICE
+   _efl_io_copier_splice_pipe_del(pd);
+#endif
+
    if (pd->buf)
      {
         eina_binbuf_free(pd->buf);
@@ -8,18 +8,143 @@
 #include <Ecore.h>
 #include "ecore_private.h"
 
-#define MY_CLASS EFL_IO_READER_FD_CLASS
+#define MY_CLASS EFL_IO_READER_FD_MIXIN
+
+/* what a read queued in the loop's io_uring asks for, the most a reader
+ * gets per wake up like Efl.Io.Copier's default read chunk */
+#define RING_READ_SIZE 4096
 
 typedef struct _Efl_Io_Reader_Fd_Data
 {
    int fd;
    Eina_Bool can_read;
    Eina_Bool eos;
+   struct {
+      Ecore_Main_Uring_Io *io;
+      size_t used;
+      int res;
+      Eina_Bool pending : 1;
+      Eina_Bool failed : 1;
+      Eina_Bool del_cb : 1;
+   } ring;
 } Efl_Io_Reader_Fd_Data;
 
+static void
+_efl_io_reader_fd_ring_drop(Efl_Io_Reader_Fd_Data *pd)
+{
+   _ecore_main_uring_io_del(pd->ring.io);
+   pd->ring.io = NULL;
+   pd->ring.pending = EINA_FALSE;
+}
+
+static void
+_efl_io_reader_fd_ring_done(void *data, Ecore_Main_Uring_Io *io EINA_UNUSED, int res)
+{
+   Eo *o = data;
+   Efl_Io_Reader_Fd_Data *pd = efl_data_scope_get(o, MY_CLASS);
+
+   pd->ring.pending = EINA_FALSE;
+   pd->ring.res = res;
+   pd->ring.used = 0;
+   /* the loop lost its ring, have the user read() and wait as before */
+   if (res == -ECANCELED) _efl_io_reader_fd_ring_drop(pd);
+   efl_io_reader_can_read_set(o, EINA_TRUE);
+}
+
+static void
+_efl_io_reader_fd_ring_del(void *data EINA_UNUSED, const Efl_Event *event)
+{
+   Efl_Io_Reader_Fd_Data *pd = efl_data_scope_get(event->object, MY_CLASS);
+
+   _efl_io_reader_fd_ring_drop(pd);
+}
+
+EAPI Eina_Bool
+_efl_io_reader_fd_ring_wait(Eo *o)
+{
+   Efl_Io_Reader_Fd_Data *pd = efl_data_scope_get(o, MY_CLASS);
+
+   if (pd->ring.io) return EINA_TRUE;
+   if ((pd->fd < 0) || (pd->eos) || (pd->ring.failed)) return EINA_FALSE;
+
+   pd->ring.io = _ecore_main_uring_io_read(efl_loop_get(o), pd->fd,
+                                           RING_READ_SIZE,
+                                           _efl_io_reader_fd_ring_done, o);
+   if (!pd->ring.io) return EINA_FALSE;
+   pd->ring.pending = EINA_TRUE;
+   if (!pd->ring.del_cb)
+     {
+        efl_event_callback_add(o, EFL_EVENT_DEL, _efl_io_reader_fd_ring_del, NULL);
+        pd->ring.del_cb = EINA_TRUE;
+     }
+   return EINA_TRUE;
+}
+
+EAPI Eina_Bool
+_efl_io_reader_fd_ring_read(Eo *o, Eina_Rw_Slice *rw_slice, Eina_Error *err)
+{
+   Efl_Io_Reader_Fd_Data *pd = efl_data_scope_get(o, MY_CLASS);
+   const unsigned char *buf;
+   size_t len;
+
+   if (!pd->ring.io) return EINA_FALSE;
+   EINA_SAFETY_ON_NULL_RETURN_VAL(rw_slice, EINA_FALSE);
+
+   *err = 0;
+   if (pd->ring.pending)
+     {
+        /* read(2) now could get data ahead of what the ring gets */
+        rw_slice->len = 0;
+        rw_slice->mem = NULL;
+        *err = EAGAIN;
+        efl_io_reader_can_read_set(o, EINA_FALSE);
+        return EINA_TRUE;
+     }
+   if (pd->ring.res <= 0)
+     {
+        rw_slice->len = 0;
+        rw_slice->mem = NULL;
+        _efl_io_reader_fd_ring_drop(pd);
+        if (pd->ring.res < 0)
+          {
+             /* errors are reported once, then it is up to read(2) */
+             *err = -pd->ring.res;
+             pd->ring.failed = EINA_TRUE;
+          }
+        else efl_io_reader_eos_set(o, EINA_TRUE);
+        efl_io_reader_can_read_set(o, EINA_FALSE);
+        return EINA_TRUE;
+     }
+
+   buf = _ecore_main_uring_io_buf_get(pd->ring.io);
+   len = pd->ring.res - pd->ring.used;
+   if (rw_slice->len < len) len = rw_slice->len;
+   memcpy(rw_slice->mem, buf + pd->ring.used, len);
+   rw_slice->len = len;
+   pd->ring.used += len;
+   if (pd->ring.used == (size_t)pd->ring.res)
+     {
+        /* queues the next read */
+        _efl_io_reader_fd_ring_drop(pd);
+        efl_io_reader_can_read_set(o, EINA_FALSE);
+     }
+   return EINA_TRUE;
+}
+
+EAPI Eina_Bool
+_efl_io_reader_fd_ring_busy(const Eo *o)
+{
+   Efl_Io_Reader_Fd_Data *pd = efl_data_scope_get(o, MY_CLASS);
+
+   return !!pd->ring.io;
+}
+
 EOLIAN static void
 _efl_io_reader_fd_reader_fd_set(Eo *o EINA_UNUSED, Efl_Io_Reader_Fd_Data *pd, int fd)
 {
+   if (pd->fd == fd) return;
+   _efl_io_reader_fd_ring_drop(pd);
+   pd->ring.failed = EINA_FALSE;
    pd->fd = fd;
 }
 
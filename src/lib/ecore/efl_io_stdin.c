@@ -50,6 +50,7 @@ _efl_io_stdin_efl_io_reader_read(Eo *o, void *pd EINA_UNUSED, Eina_Rw_Slice *rw_
 {
    Eina_Error ret;
 
+   if (_efl_io_reader_fd_ring_read(o, rw_slice, &ret)) return ret;
    ret = efl_io_reader_read(efl_super(o, MY_CLASS), rw_slice);
    if (rw_slice && rw_slice->len > 0)
      efl_io_reader_can_read_set(o, EINA_FALSE); /* wait Efl.Loop.Fd "read" */
@@ -72,8 +73,10 @@ _efl_io_stdin_efl_io_reader_can_read_set(Eo *o, void *pd EINA_UNUSED, Eina_Bool
      }
    else
      {
-        /* kernel flag is clear, resume monitoring the FD */
-        efl_event_callback_add(o, EFL_LOOP_FD_EVENT_READ, _efl_io_stdin_event_read, NULL);
+        /* kernel flag is clear, resume monitoring the FD, unless the
+         * loop's io_uring reads once there is something */
+        if (!_efl_io_reader_fd_ring_wait(o))
+          efl_event_callback_add(o, EFL_LOOP_FD_EVENT_READ, _efl_io_stdin_event_read, NULL);
      }
 }
 
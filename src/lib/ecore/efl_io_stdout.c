@@ -48,6 +48,7 @@ _efl_io_stdout_efl_io_writer_write(Eo *o, void *pd EINA_UNUSED, Eina_Slice *ro_s
 {
    Eina_Error ret;
 
+   if (_efl_io_writer_fd_ring_write(o, ro_slice, remaining, &ret)) return ret;
    ret = efl_io_writer_write(efl_super(o, MY_CLASS), ro_slice, remaining);
    if (ro_slice && ro_slice->len > 0)
      efl_io_writer_can_write_set(o, EINA_FALSE); /* wait Efl.Loop.Fd "write" */
@@ -70,8 +71,10 @@ _efl_io_stdout_efl_io_writer_can_write_set(Eo *o, void *pd EINA_UNUSED, Eina_Boo
      }
    else
      {
-        /* kernel flag is clear, resume monitoring the FD */
-        efl_event_callback_add(o, EFL_LOOP_FD_EVENT_WRITE, _efl_io_stdout_event_write, NULL);
+        /* kernel flag is clear, resume monitoring the FD, unless the
+         * write is in the loop's io_uring */
+        if (!_efl_io_writer_fd_ring_busy(o))
+          efl_event_callback_add(o, EFL_LOOP_FD_EVENT_WRITE, _efl_io_stdout_event_write, NULL);
      }
 }
 
@@ -8,17 +8,111 @@
 #include <Ecore.h>
 #include "ecore_private.h"
 
-#define MY_CLASS EFL_IO_WRITER_FD_CLASS
+#define MY_CLASS EFL_IO_WRITER_FD_MIXIN
+
+/* the most a write queued in the loop's io_uring takes, it is copied */
+#define RING_WRITE_SIZE (64 * 1024)
 
 typedef struct _Efl_Io_Writer_Fd_Data
 {
    int fd;
    Eina_Bool can_write;
+   struct {
+      Ecore_Main_Uring_Io *io;
+      Eina_Error error;
+      Eina_Bool del_cb : 1;
+   } ring;
 } Efl_Io_Writer_Fd_Data;
 
+static void
+_efl_io_writer_fd_ring_drop(Efl_Io_Writer_Fd_Data *pd)
+{
+   if (!pd->ring.io) return;
+   /* the write goes on, the kernel must know the fd before it is closed,
+    * ring reads and writes only happen on the main loop */
+   _ecore_main_uring_io_del(pd->ring.io);
+   _ecore_main_uring_io_flush(efl_main_loop_get());
+   pd->ring.io = NULL;
+}
+
+static void
+_efl_io_writer_fd_ring_done(void *data, Ecore_Main_Uring_Io *io, int res)
+{
+   Eo *o = data;
+   Efl_Io_Writer_Fd_Data *pd = efl_data_scope_get(o, MY_CLASS);
+
+   _ecore_main_uring_io_del(io);
+   pd->ring.io = NULL;
+   /* the user was told it got written, so the next write reports it */
+   if (res < 0) pd->ring.error = -res;
+   efl_io_writer_can_write_set(o, EINA_TRUE);
+}
+
+static void
+_efl_io_writer_fd_ring_del(void *data EINA_UNUSED, const Efl_Event *event)
+{
+   Efl_Io_Writer_Fd_Data *pd = efl_data_scope_get(event->object, MY_CLASS);
+
+   _efl_io_writer_fd_ring_drop(pd);
+}
+
+EAPI Eina_Bool
+_efl_io_writer_fd_ring_write(Eo *o, Eina_Slice *ro_slice, Eina_Slice *remaining, Eina_Error *err)
+{
+   Efl_Io_Writer_Fd_Data *pd = efl_data_scope_get(o, MY_CLASS);
+   size_t len;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(ro_slice, EINA_FALSE);
+   *err = 0;
+   if ((pd->ring.io) || (pd->ring.error))
+     {
+        *err = pd->ring.io ? EAGAIN : pd->ring.error;
+        pd->ring.error = 0;
+        if (remaining) *remaining = *ro_slice;
+        ro_slice->len = 0;
+        ro_slice->mem = NULL;
+        efl_io_writer_can_write_set(o, EINA_FALSE);
+        return EINA_TRUE;
+     }
+   if ((pd->fd < 0) || (ro_slice->len == 0)) return EINA_FALSE;
+
+   len = ro_slice->len;
+   if (len > RING_WRITE_SIZE) len = RING_WRITE_SIZE;
+   pd->ring.io = _ecore_main_uring_io_write(efl_loop_get(o), pd->fd,
+                                            ro_slice->mem, len,
+                                            _efl_io_writer_fd_ring_done, o);
+   if (!pd->ring.io) return EINA_FALSE;
+   if (!pd->ring.del_cb)
+     {
+        efl_event_callback_add(o, EFL_EVENT_DEL, _efl_io_writer_fd_ring_del, NULL);
+        pd->ring.del_cb = EINA_TRUE;
+     }
+
+   if (remaining)
+     {
+        remaining->len = ro_slice->len - len;
+        remaining->bytes = ro_slice->bytes + len;
+     }
+   ro_slice->len = len;
+   /* until the kernel is done with it */
+   efl_io_writer_can_write_set(o, EINA_FALSE);
+   return EINA_TRUE;
+}
+
+EAPI Eina_Bool
+_efl_io_writer_fd_ring_busy(const Eo *o)
+{
+   Efl_Io_Writer_Fd_Data *pd = efl_data_scope_get(o, MY_CLASS);
+
+   return !!pd->ring.io;
+}
+
 EOLIAN static void
 _efl_io_writer_fd_writer_fd_set(Eo *o EINA_UNUSED, Efl_Io_Writer_Fd_Data *pd, int fd)
 {
+   if (pd->fd == fd) return;
+   _efl_io_writer_fd_ring_drop(pd);
+   pd->ring.error = 0;
    pd->fd = fd;
 }
 
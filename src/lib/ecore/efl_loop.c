@@ -323,6 +323,11 @@ _efl_loop_efl_object_destructor(Eo *obj, Efl_Loop_Data *pd)
 {
    pd->future_message_handler = NULL;
 
+   free(pd->timers);
+   pd->timers = NULL;
+   pd->timers_count = 0;
+   pd->timers_size = 0;
+
    efl_destructor(efl_super(obj, EFL_LOOP_CLASS));
 }
 
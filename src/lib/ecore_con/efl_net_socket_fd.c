@@ -174,6 +174,8 @@ _efl_net_socket_fd_efl_io_closer_close(Eo *o, Efl_Net_Socket_Fd_Data *pd EINA_UN
    efl_loop_fd_set(efl_super(o, MY_CLASS), SOCKET_TO_LOOP_FD(INVALID_SOCKET));
 
    efl_io_closer_fd_set(o, SOCKET_TO_LOOP_FD(INVALID_SOCKET));
+   /* reads and writes queued in the loop's io_uring name the fd */
+   _ecore_main_uring_io_flush(efl_main_loop_get());
    if (!((pd->family == AF_UNSPEC) && (fd == 0))) /* if nothing is set, fds are all zero, avoid closing STDOUT */
      if (closesocket(fd) != 0) ret = efl_net_socket_error_get();
    efl_event_callback_call(o, EFL_IO_CLOSER_EVENT_CLOSED, NULL);
@@ -196,9 +198,11 @@ _efl_net_socket_fd_efl_io_reader_read(Eo *o, Efl_Net_Socket_Fd_Data *pd EINA_UNU
 {
    SOCKET fd = efl_io_reader_fd_get(o);
    ssize_t r;
+   Eina_Error ret;
 
    EINA_SAFETY_ON_NULL_RETURN_VAL(rw_slice, EINVAL);
    if (fd == INVALID_SOCKET) goto error;
+   if (_efl_io_reader_fd_ring_read(o, rw_slice, &ret)) return ret;
    do
      {
         r = recv(fd, rw_slice->mem, rw_slice->len, 0);
@@ -246,8 +250,10 @@ _efl_net_socket_fd_efl_io_reader_can_read_set(Eo *o, Efl_Net_Socket_Fd_Data *pd
      }
    else
      {
-        /* kernel flag is clear, resume monitoring the FD */
-        efl_event_callback_add(o, EFL_LOOP_FD_EVENT_READ, _efl_net_socket_fd_event_read, NULL);
+        /* kernel flag is clear, resume monitoring the FD, unless the
+         * loop's io_uring reads once there is something */
+        if (!_efl_io_reader_fd_ring_wait(o))
+          efl_event_callback_add(o, EFL_LOOP_FD_EVENT_READ, _efl_net_socket_fd_event_read, NULL);
      }
 }
 
@@ -271,9 +277,11 @@ _efl_net_socket_fd_efl_io_writer_write(Eo *o, Efl_Net_Socket_Fd_Data *pd EINA_UN
 {
    SOCKET fd = efl_io_writer_fd_get(o);
    ssize_t r;
+   Eina_Error ret;
 
    EINA_SAFETY_ON_NULL_RETURN_VAL(ro_slice, EINVAL);
    if (fd == INVALID_SOCKET) goto error;
+   if (_efl_io_writer_fd_ring_write(o, ro_slice, remaining, &ret)) return ret;
 
    do
      {
@@ -326,8 +334,10 @@ _efl_net_socket_fd_efl_io_writer_can_write_set(Eo *o, Efl_Net_Socket_Fd_Data *pd
      }
    else
      {
-        /* kernel flag is clear, resume monitoring the FD */
-        efl_event_callback_add(o, EFL_LOOP_FD_EVENT_WRITE, _efl_net_socket_fd_event_write, NULL);
+        /* kernel flag is clear, resume monitoring the FD, unless the
+         * write is in the loop's io_uring */
+        if (!_efl_io_writer_fd_ring_busy(o))
+          efl_event_callback_add(o, EFL_LOOP_FD_EVENT_WRITE, _efl_net_socket_fd_event_write, NULL);
      }
 }
 
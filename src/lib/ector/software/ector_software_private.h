@@ -6,6 +6,34 @@
 #include "sw_ft_stroker.h"
 #include "../ector_private.h"
 
+#ifdef EAPI
+# undef EAPI
+#endif
+
+#ifdef _WIN32
+# ifdef EFL_BUILD
+#  ifdef DLL_EXPORT
+#   define EAPI __declspec(dllexport)
+#  else
+#   define EAPI
+#  endif
+# else
+#  define EAPI __declspec(dllimport)
+# endif
+#else
+# ifdef __GNUC__
+#  if __GNUC__ >= 4
+#   define EAPI __attribute__ ((visibility("default")))
+#  else
+#   define EAPI
+#  endif
+# else
+#  define EAPI
+# endif
+#endif
+
+#define ECTOR_SOFTWARE_THREAD_MAX 8
+
 typedef struct _Ector_Software_Surface_Data Ector_Software_Surface_Data;
 typedef struct _Ector_Software_Thread Ector_Software_Thread;
 
@@ -140,6 +168,30 @@ void ector_software_rasterizer_draw_rle_data(Software_Rasterizer *rasterizer,
 
 void ector_software_rasterizer_destroy_rle_data(Shape_Rle_Data *rle);
 
+// Number of bands big shapes are drawn in, 0 for one per thread, 1 to draw
+// them at once. Tests compare the banded output with the serial one.
+EAPI void ector_software_rasterizer_draw_bands_set(int bands);
+
+// Span compositors used with a mask buffer
+typedef void (*Ector_Comp_Alpha_Func)(uint32_t *dest, const uint32_t *src, const uint32_t *mask, int length);
+typedef void (*Ector_Comp_Mask_Func)(uint32_t *mask, const uint32_t *src, int length);
+
+EAPI void _comp_alpha_generic(uint32_t *dest, const uint32_t *src, const uint32_t *mask, int length);
+EAPI void _comp_alpha_inv_generic(uint32_t *dest, const uint32_t *src, const uint32_t *mask, int length);
+EAPI void _comp_mask_add_generic(uint32_t *mask, const uint32_t *src, int length);
+EAPI void _comp_mask_sub_generic(uint32_t *mask, const uint32_t *src, int length);
+EAPI void _comp_mask_ins_generic(uint32_t *mask, const uint32_t *src, int length);
+EAPI void _comp_mask_diff_generic(uint32_t *mask, const uint32_t *src, int length);
+
+#ifdef BUILD_AVX2
+EAPI void _comp_alpha_avx2(uint32_t *dest, const uint32_t *src, const uint32_t *mask, int length);
+EAPI void _comp_alpha_inv_avx2(uint32_t *dest, const uint32_t *src, const uint32_t *mask, int length);
+EAPI void _comp_mask_add_avx2(uint32_t *mask, const uint32_t *src, int length);
+EAPI void _comp_mask_sub_avx2(uint32_t *mask, const uint32_t *src, int length);
+EAPI void _comp_mask_ins_avx2(uint32_t *mask, const uint32_t *src, int length);
+EAPI void _comp_mask_diff_avx2(uint32_t *mask, const uint32_t *src, int length);
+#endif
+
 
 // Gradient Api
 void destroy_color_table(Ector_Renderer_Software_Gradient_Data *gdata);
@@ -153,6 +205,7 @@ typedef void (*Ector_Thread_Worker_Cb)(void *data, Ector_Software_Thread *thread
 
 void ector_software_wait(Ector_Thread_Worker_Cb cb, Eina_Free_Cb done, void *data);
 void ector_software_schedule(Ector_Thread_Worker_Cb cb, Eina_Free_Cb done, void *data);
+unsigned int ector_software_thread_count(void);
 
 void ector_software_gradient_color_update(Ector_Renderer_Software_Gradient_Data *gdata);
 
@@ -26,6 +26,68 @@ typedef enum _EFL_CANVAS_VG_NODE_BLEND_TYPE
 }EFL_CANVAS_VG_NODE_BLEND_TYPE;
 //
 
+// dest = src * mask alpha + dest * (1 - alpha)
+EAPI void
+_comp_alpha_generic(uint32_t *dest, const uint32_t *src, const uint32_t *mask, int length)
+{
+   for (int i = 0; i < length; i++)
+     {
+        uint32_t temp = draw_mul_256(mask[i] >> 24, src[i]);
+        int alpha = 255 - (temp >> 24);
+        dest[i] = temp + draw_mul_256(alpha, dest[i]);
+     }
+}
+
+// dest = src * (1 - mask alpha) + dest * (1 - alpha), where mask is set
+EAPI void
+_comp_alpha_inv_generic(uint32_t *dest, const uint32_t *src, const uint32_t *mask, int length)
+{
+   for (int i = 0; i < length; i++)
+     {
+        uint32_t temp = src[i];
+        if (mask[i])
+          temp = draw_mul_256(255 - (mask[i] >> 24), temp);
+        int alpha = 255 - (temp >> 24);
+        dest[i] = temp + draw_mul_256(alpha, dest[i]);
+     }
+}
+
+EAPI void
+_comp_mask_add_generic(uint32_t *mask, const uint32_t *src, int length)
+{
+   for (int i = 0; i < length; i++)
+     mask[i] = draw_mul_256(0xFF - (src[i] >> 24), mask[i]) + src[i];
+}
+
+EAPI void
+_comp_mask_sub_generic(uint32_t *mask, const uint32_t *src, int length)
+{
+   for (int i = 0; i < length; i++)
+     mask[i] = draw_mul_256(0xFF - (src[i] >> 24), mask[i]);
+}
+
+EAPI void
+_comp_mask_ins_generic(uint32_t *mask, const uint32_t *src, int length)
+{
+   for (int i = 0; i < length; i++)
+     mask[i] = draw_mul_256(src[i] >> 24, mask[i]);
+}
+
+EAPI void
+_comp_mask_diff_generic(uint32_t *mask, const uint32_t *src, int length)
+{
+   for (int i = 0; i < length; i++)
+     mask[i] = draw_mul_256(0xFF - (mask[i] >> 24), src[i]) +
+               draw_mul_256(0xFF - (src[i] >> 24), mask[i]);
+}
+
+static Ector_Comp_Alpha_Func _comp_alpha = _comp_alpha_generic;
+static Ector_Comp_Alpha_Func _comp_alpha_inv = _comp_alpha_inv_generic;
+static Ector_Comp_Mask_Func _comp_mask_add = _comp_mask_add_generic;
+static Ector_Comp_Mask_Func _comp_mask_sub = _comp_mask_sub_generic;
+static Ector_Comp_Mask_Func _comp_mask_ins = _comp_mask_ins_generic;
+static Ector_Comp_Mask_Func _comp_mask_diff = _comp_mask_diff_generic;
+
 static void
 _blend_argb(int count, const SW_FT_Span *spans, void *user_data)
 {
@@ -73,20 +135,11 @@ _blend_alpha(int count, const SW_FT_Span *spans, void *user_data)
         uint32_t *target = buffer + ((pix_stride * spans->y) + spans->x);
         uint32_t *mtarget =
               mbuffer + ((mask->generic->w * spans->y) + spans->x);
-        uint32_t *temp = tbuffer;
-        memset(temp, 0x00, sizeof(uint32_t) * spans->len);
-        comp_func(temp, spans->len, color, spans->coverage);
+        memset(tbuffer, 0x00, sizeof(uint32_t) * spans->len);
+        comp_func(tbuffer, spans->len, color, spans->coverage);
 
         //masking
-        for (int i = 0; i < spans->len; i++)
-          {
-             *temp = draw_mul_256(((*mtarget)>>24), *temp);
-             int alpha = 255 - ((*temp) >> 24);
-             *target = *temp + draw_mul_256(alpha, *target);
-             ++temp;
-             ++mtarget;
-             ++target;
-          }
+        _comp_alpha(target, tbuffer, mtarget, spans->len);
         ++spans;
      }
 }
@@ -116,21 +169,11 @@ _blend_alpha_inv(int count, const SW_FT_Span *spans, void *user_data)
         uint32_t *target = buffer + ((pix_stride * spans->y) + spans->x);
         uint32_t *mtarget =
               mbuffer + ((mask->generic->w * spans->y) + spans->x);
-        uint32_t *temp = tbuffer;
-        memset(temp, 0x00, sizeof(uint32_t) * spans->len);
-        comp_func(temp, spans->len, color, spans->coverage);
+        memset(tbuffer, 0x00, sizeof(uint32_t) * spans->len);
+        comp_func(tbuffer, spans->len, color, spans->coverage);
 
         //masking
-        for (int i = 0; i < spans->len; i++)
-          {
-             if (*mtarget)
-                *temp = draw_mul_256((255 - ((*mtarget)>>24)), *temp);
-             int alpha = 255 - ((*temp) >> 24);
-             *target = *temp + draw_mul_256(alpha, *target);
-             ++temp;
-             ++mtarget;
-             ++target;
-          }
+        _comp_alpha_inv(target, tbuffer, mtarget, spans->len);
         ++spans;
      }
 }
@@ -153,8 +196,7 @@ _blend_mask_add(int count, const SW_FT_Span *spans, void *user_data)
         uint32_t *mtarget = mbuffer + ((mask->generic->w * spans->y) + spans->x);
         memset(ttarget, 0x00, sizeof(uint32_t) * spans->len);
         comp_func(ttarget, spans->len, color, spans->coverage);
-        for (int i = 0; i < spans->len; i++)
-          mtarget[i] = draw_mul_256(0xFF - (ttarget[i]>>24), mtarget[i]) + ttarget[i];
+        _comp_mask_add(mtarget, ttarget, spans->len);
         ++spans;
      }
 }
@@ -177,8 +219,7 @@ _blend_mask_sub(int count, const SW_FT_Span *spans, void *user_data)
         uint32_t *mtarget = mbuffer + ((mask->generic->w * spans->y) + spans->x);
         memset(ttarget, 0x00, sizeof(uint32_t) * spans->len);
         comp_func(ttarget, spans->len, color, spans->coverage);
-        for (int i = 0; i < spans->len; i++)
-          mtarget[i] = draw_mul_256(0xFF - (ttarget[i]>>24), mtarget[i]);
+        _comp_mask_sub(mtarget, ttarget, spans->len);
         ++spans;
      }
 }
@@ -207,8 +248,7 @@ _blend_mask_ins(int count, const SW_FT_Span *spans, void *user_data)
                   memset(ttarget, 0x00, sizeof(uint32_t) * spans->len);
                   uint32_t *mtarget = mbuffer + ((mask->generic->w * spans->y) + spans->x);
                   comp_func(ttarget, spans->len, color, spans->coverage);
-                  for (int c = 0; c < spans->len; c++)
-                    mtarget[c] = draw_mul_256(ttarget[c]>>24, mtarget[c]);
+                  _comp_mask_ins(mtarget, ttarget, spans->len);
                   x += spans->len - 1;
                   ++spans;
                   --count;
@@ -240,8 +280,7 @@ _blend_mask_diff(int count, const SW_FT_Span *spans, void *user_data)
         memset(ttarget, 0x00, sizeof(uint32_t) * spans->len);
         uint32_t *mtarget = mbuffer + ((mask->generic->w * spans->y) + spans->x);
         comp_func(ttarget, spans->len, color, spans->coverage);
-        for (int i = 0; i < spans->len; i++)
-          mtarget[i] = draw_mul_256(0xFF - (mtarget[i]>>24), ttarget[i]) + draw_mul_256(0xFF - (ttarget[i]>>24), mtarget[i]);
+        _comp_mask_diff(mtarget, ttarget, spans->len);
         ++spans;
      }
 }
@@ -328,16 +367,10 @@ _blend_gradient_alpha(int count, const SW_FT_Span *spans, void *user_data)
              int l = MIN(length, BLEND_GRADIENT_BUFFER_SIZE);
              fetchfunc(gradientbuffer, data, spans->y, spans->x, l);
              comp_func(temp, gradientbuffer, l, data->mul_col, spans->coverage);
-
-             for (int i = 0; i < l; i++)
-               {
-                  *temp = draw_mul_256(((*mtarget)>>24), *temp);
-                  int alpha = 255 - ((*temp) >> 24);
-                  *target = *temp + draw_mul_256(alpha, *target);
-                  ++temp;
-                  ++mtarget;
-                  ++target;
-               }
+             _comp_alpha(target, temp, mtarget, l);
+             temp += l;
+             mtarget += l;
+             target += l;
              length -= l;
           }
         ++spans;
@@ -385,17 +418,10 @@ _blend_gradient_alpha_inv(int count, const SW_FT_Span *spans, void *user_data)
              int l = MIN(length, BLEND_GRADIENT_BUFFER_SIZE);
              fetchfunc(gradientbuffer, data, spans->y, spans->x, l);
              comp_func(temp, gradientbuffer, l, data->mul_col, spans->coverage);
-
-             for (int i = 0; i < l; i++)
-               {
-                  if (*mtarget)
-                    *temp = draw_mul_256((255 - ((*mtarget)>>24)), *temp);
-                  int alpha = 255 - ((*temp) >> 24);
-                  *target = *temp + draw_mul_256(alpha, *target);
-                  ++temp;
-                  ++mtarget;
-                  ++target;
-               }
+             _comp_alpha_inv(target, temp, mtarget, l);
+             temp += l;
+             mtarget += l;
+             target += l;
              length -= l;
           }
         ++spans;
@@ -661,6 +687,25 @@ void ector_software_thread_init(Ector_Software_Thread *thread)
                      SW_FT_STROKER_LINECAP_BUTT, SW_FT_STROKER_LINEJOIN_MITER, 0);
 }
 
+static void
+_comp_funcs_init(void)
+{
+   static int i = 0;
+   if (i++) return;
+
+#ifdef BUILD_AVX2
+   if (eina_cpu_features_get() & EINA_CPU_AVX2)
+     {
+        _comp_alpha = _comp_alpha_avx2;
+        _comp_alpha_inv = _comp_alpha_inv_avx2;
+        _comp_mask_add = _comp_mask_add_avx2;
+        _comp_mask_sub = _comp_mask_sub_avx2;
+        _comp_mask_ins = _comp_mask_ins_avx2;
+        _comp_mask_diff = _comp_mask_diff_avx2;
+     }
+#endif
+}
+
 void ector_software_rasterizer_init(Software_Rasterizer *rasterizer)
 {
    //initialize the span data.
@@ -669,6 +714,7 @@ void ector_software_rasterizer_init(Software_Rasterizer *rasterizer)
    rasterizer->fill_data.blend = 0;
    efl_draw_init();
    ector_software_gradient_init();
+   _comp_funcs_init();
 }
 
 void ector_software_thread_shutdown(Ector_Software_Thread *thread)
@@ -897,6 +943,92 @@ ector_software_rasterizer_radial_gradient_set(Software_Rasterizer *rasterizer,
    rasterizer->fill_data.type = RadialGradient;
 }
 
+/* Spans are sorted on y and each band only touches its own rows of the
+ * target and of the mask, so big shapes are filled by the preparing
+ * threads in horizontal bands while the calling thread does the first one.
+ */
+#define DRAW_BAND_MIN_SPANS 256
+
+static int _draw_bands = 0;
+
+EAPI void
+ector_software_rasterizer_draw_bands_set(int bands)
+{
+   if (bands > ECTOR_SOFTWARE_THREAD_MAX + 1)
+     bands = ECTOR_SOFTWARE_THREAD_MAX + 1;
+   _draw_bands = bands;
+}
+
+typedef struct _Span_Band
+{
+   Span_Data       *data;
+   const SW_FT_Span *spans;
+   int              count;
+   Eina_Bool        done;
+} Span_Band;
+
+static void
+_draw_band(void *data, Ector_Software_Thread *thread EINA_UNUSED)
+{
+   Span_Band *band = data;
+
+   band->data->blend(band->count, band->spans, band->data);
+}
+
+static void
+_draw_band_done(void *data)
+{
+   Span_Band *band = data;
+
+   band->done = EINA_TRUE;
+}
+
+static void
+_draw_spans(Span_Data *data, const SW_FT_Span *spans, int count)
+{
+   Span_Band bands[ECTOR_SOFTWARE_THREAD_MAX + 1];
+   int nbands, size, start, end, i;
+
+   // forced bands are drawn one after the other without threads
+   nbands = _draw_bands ? _draw_bands : (int)ector_software_thread_count() + 1;
+   if (nbands > count / DRAW_BAND_MIN_SPANS)
+     nbands = count / DRAW_BAND_MIN_SPANS;
+
+   // intersect touches every pixel of the mask, not only the spans
+   if ((nbands < 2) ||
+       (data->mask && (data->mask_op == EFL_CANVAS_VG_NODE_BLEND_TYPE_MASK_INTERSECT)))
+     {
+        data->blend(count, spans, data);
+        return;
+     }
+
+   size = count / nbands;
+   for (i = 0, start = 0; (i < nbands) && (start < count); i++, start = end)
+     {
+        end = (i == nbands - 1) ? count : start + size;
+        if (end > count) end = count;
+        // never split a row between two bands
+        while ((end < count) && (spans[end].y == spans[end - 1].y)) end++;
+
+        bands[i].data = data;
+        bands[i].spans = spans + start;
+        bands[i].count = end - start;
+        bands[i].done = EINA_FALSE;
+     }
+   nbands = i;
+
+   for (i = 1; i < nbands; i++)
+     ector_software_schedule(_draw_band, _draw_band_done, &bands[i]);
+
+   _draw_band(&bands[0], NULL);
+
+   for (i = 1; i < nbands; i++)
+     {
+        if (!bands[i].done)
+          ector_software_wait(_draw_band, _draw_band_done, &bands[i]);
+     }
+}
+
 void
 ector_software_rasterizer_draw_rle_data(Software_Rasterizer *rasterizer,
                                         int x, int y, uint32_t mul_col,
@@ -918,5 +1050,5 @@ ector_software_rasterizer_draw_rle_data(Software_Rasterizer *rasterizer,
    _adjust_span_fill_methods(&rasterizer->fill_data);
 
    if (rasterizer->fill_data.blend)
-     rasterizer->fill_data.blend(rle->size, rle->spans, &rasterizer->fill_data);
+     _draw_spans(&rasterizer->fill_data, rle->spans, rle->size);
 }
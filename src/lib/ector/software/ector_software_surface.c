@@ -79,7 +79,7 @@ _ector_software_init(void)
         ector_software_thread_init(&render_thread);
         return ;
      }
-   cpu = cpu > 8 ? 8 : cpu;
+   cpu = cpu > ECTOR_SOFTWARE_THREAD_MAX ? ECTOR_SOFTWARE_THREAD_MAX : cpu;
    cpu_core = cpu;
 
    render_queue = eina_thread_queue_new();
@@ -160,6 +160,13 @@ ector_software_schedule(Ector_Thread_Worker_Cb cb, Eina_Free_Cb done, void *data
    eina_thread_queue_send_done(t->queue, ref);
 }
 
+unsigned int
+ector_software_thread_count(void)
+{
+   if (!ths) return 0;
+   return cpu_core;
+}
+
 // Do not call this function if the done function has already called
 void
 ector_software_wait(Ector_Thread_Worker_Cb cb, Eina_Free_Cb done, void *data)
@@ -687,6 +687,64 @@ eet_close(Eet_File *ef);
 EAPI Eet_Error
 eet_sync(Eet_File *ef);
 
+/**
+ * @ingroup Eet_File_Group
+ * @brief Enables or disables the journal of an eet file handle.
+ * @param ef A valid eet file handle opened for writing.
+ * @param journal @c EINA_TRUE to append changes, @c EINA_FALSE to rewrite
+ *        the whole file on each flush (the default).
+ * @return @c EINA_TRUE on success, @c EINA_FALSE otherwise.
+ *
+ * When the journal is enabled, eet_sync() and eet_close() append the new,
+ * modified and deleted entries at the end of the file instead of writing
+ * it all again. The file is fully rewritten (compacted) when the journal
+ * grows bigger than the rest of the file, when eet_compact() is called or
+ * when the file is signed.
+ *
+ * @warning Versions of eet older than 1.23 ignore the journal, they see the
+ * content of the file as it was at the last compaction.
+ *
+ * @see eet_compact()
+ *
+ * @since 1.23
+ */
+EAPI Eina_Bool
+eet_journal_set(Eet_File *ef, Eina_Bool journal);
+
+/**
+ * @ingroup Eet_File_Group
+ * @brief Rewrites the whole content of an eet file handle.
+ * @param ef A valid eet file handle opened for writing.
+ * @return An eet error identifier.
+ *
+ * This flushes pending writes like eet_sync() does, but always writes a
+ * complete file, dropping the journal and the space used by old entries.
+ *
+ * @see eet_journal_set()
+ *
+ * @since 1.23
+ */
+EAPI Eet_Error
+eet_compact(Eet_File *ef);
+
+/**
+ * @ingroup Eet_File_Group
+ * @brief Defers the compression of the entries written to a file.
+ * @param ef A valid eet file handle opened for writing.
+ * @param defer @c EINA_TRUE to compress at flush time.
+ * @return @c EINA_TRUE on success, @c EINA_FALSE otherwise.
+ *
+ * By default eet_write() compresses the data before returning. When the
+ * compression is deferred, the data is kept as is until eet_sync() or
+ * eet_close(), which compress all the pending entries in parallel. In this
+ * case eet_write() returns the uncompressed size of the data. Ciphered
+ * entries are always compressed right away.
+ *
+ * @since 1.23
+ */
+EAPI Eina_Bool
+eet_compression_defer_set(Eet_File *ef, Eina_Bool defer);
+
 /**
  * @ingroup Eet_File_Group
  * @brief Returns a handle to the shared string dictionary of the Eet file
@@ -93,11 +93,19 @@ struct _Eet_File
    unsigned int         signature_length;
    int                  sha1_length;
 
+   /* journal: entries appended after the last full write of the file */
+   Eina_List           *journal_deleted; /* names deleted since last flush */
+   unsigned long int    journal_offset; /* where the journal starts on disk */
+   unsigned long int    journal_end; /* size of the file on disk */
+   int                  journal_dictionary_count; /* strings on disk */
+
    Eina_Lock            file_lock;
 
    unsigned char        writes_pending : 1;
    unsigned char        delete_me_now : 1;
    unsigned char        readfp_owned : 1;
+   unsigned char        journal : 1;
+   unsigned char        defer_compression : 1;
 };
 
 struct _Eet_File_Header
@@ -125,11 +133,13 @@ struct _Eet_File_Node
    unsigned int      data_size;
 
    unsigned char     compression_type;
+   unsigned char     deferred_compression; /* compressed at flush time */
 
    unsigned char     free_name : 1;
    unsigned char     compression : 1;
    unsigned char     ciphered : 1;
    unsigned char     alias : 1;
+   unsigned char     dirty : 1; /* not written to disk yet */
 };
 
 #if 0
@@ -188,6 +198,34 @@ char signature[signature_length]; /* The signature. */
 char x509[x509_length]; /* The public certificate. */
 #endif /* if 0 */
 
+#if 0
+/* Journal, appended to a version 3 file that is not signed */
+/* NB: all int's are stored in network byte order on disk */
+/* zero or more segments, each starting on an 8 bytes boundary: */
+int magic; /* magic number ie 0x1ee7a9e1 */
+int num_directory_entries; /* number of directory entries to follow */
+int num_dictionary_entries; /* number of new dictionary entries to follow */
+int segment_size; /* size of the whole segment, including padding */
+struct
+{
+   int data_offset; /* bytes offset into file for data chunk */
+   int size; /* size of the data chunk */
+   int data_size; /* size of the (uncompressed) data chunk */
+   int name_offset; /* bytes offset into file for name string */
+   int name_size; /* length in bytes of the name field */
+   int flags; /* same as version 3, plus:
+                 bit 11 => entry deleted (no data)
+               */
+} directory[num_directory_entries]; /* applied in order, last one wins */
+struct
+{
+   int offset; /* bytes offset into file for the string */
+   int size; /* length in bytes of the string, including the \0 */
+} dictionary[num_dictionary_entries]; /* appended to the dictionary */
+/* then the names, the strings and the data stream. */
+/* A segment that goes past the end of the file is ignored. */
+#endif /* if 0 */
+
 /*
  * variable and macros used for the eina_log module
  */
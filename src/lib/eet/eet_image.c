@@ -772,6 +772,158 @@ _alpha_to_greyscale_convert(uint32_t *data, int len)
      }
 }
 
+typedef struct _Eet_Etc_Encode Eet_Etc_Encode;
+struct _Eet_Etc_Encode
+{
+   rg_etc1_pack_params param;
+   Eet_Colorspace cspace;
+   uint32_t *data;
+   uint8_t *blocks; // raw ETC data, one macro block after the other
+   Eina_Binbuf **comp; // LZ4 data of each macro block
+   int image_stride, image_height;
+   int macro_block_width, macro_block_height;
+   int macro_block_cols, macro_block_rows;
+   int macro_block_size, etc_block_size;
+   Eina_Bool compress;
+   Eina_Bool error;
+};
+
+static Eina_Bool
+_eet_etc_macro_block_encode(Eet_Etc_Encode *enc, int x, int y, uint8_t *offset)
+{
+   uint32_t *data = enc->data;
+   uint32_t *input, *last_col, *last_row, *last_pix;
+   int image_stride = enc->image_stride;
+   int image_height = enc->image_height;
+   int macro_block_width = enc->macro_block_width;
+   int macro_block_height = enc->macro_block_height;
+   int real_x, real_y;
+
+   if (y == 0) real_y = 0;
+   else if (y < image_height + 1) real_y = y - 1;
+   else real_y = image_height - 1;
+
+   if (x == 0) real_x = 0;
+   else if (x < image_stride + 1) real_x = x - 1;
+   else real_x = image_stride - 1;
+
+   input = data + real_y * image_stride + real_x;
+   last_row = data + image_stride * (image_height - 1) + real_x;
+   last_col = data + (real_y + 1) * image_stride - 1;
+   last_pix = data + image_height * image_stride - 1;
+
+   for (int by = 0; by < macro_block_height; by += 4)
+     {
+        int dup_top = ((y + by) == 0) ? 1 : 0;
+        int max_row = MAX(0, MIN(4, image_height - real_y - by));
+        int oy = (y == 0) ? 1 : 0;
+
+        for (int bx = 0; bx < macro_block_width; bx += 4)
+          {
+             int dup_left = ((x + bx) == 0) ? 1 : 0;
+             int max_col = MAX(0, MIN(4, image_stride - real_x - bx));
+             uint32_t todo[16] = { 0 };
+             int row, col;
+             int ox = (x == 0) ? 1 : 0;
+
+             if (dup_left)
+               {
+                  // Duplicate left column
+                  for (row = 0; row < max_row; row++)
+                    todo[row * 4] = input[row * image_stride];
+                  for (row = max_row; row < 4; row++)
+                    todo[row * 4] = last_row[0];
+               }
+
+             if (dup_top)
+               {
+                  // Duplicate top row
+                  for (col = 0; col < max_col; col++)
+                    todo[col] = input[MAX(col + bx - ox, 0)];
+                  for (col = max_col; col < 4; col++)
+                    todo[col] = last_col[0];
+               }
+
+             for (row = dup_top; row < 4; row++)
+               {
+                  for (col = dup_left; col < max_col; col++)
+                    {
+                       if (row < max_row)
+                         {
+                            // Normal copy
+                            todo[row * 4 + col] = input[(row + by - oy) * image_stride + bx + col - ox];
+                         }
+                       else
+                         {
+                            // Copy last line
+                            todo[row * 4 + col] = last_row[col + bx - ox];
+                         }
+                    }
+                  for (col = max_col; col < 4; col++)
+                    {
+                       // Right edge
+                       if (row < max_row)
+                         {
+                            // Duplicate last column
+                            todo[row * 4 + col] = last_col[MAX(row + by - oy, 0) * image_stride];
+                         }
+                       else
+                         {
+                            // Duplicate very last pixel again and again
+                            todo[row * 4 + col] = *last_pix;
+                         }
+                    }
+               }
+
+             switch (enc->cspace)
+               {
+                case EET_COLORSPACE_ETC1:
+                case EET_COLORSPACE_ETC1_ALPHA:
+                  rg_etc1_pack_block(offset, (uint32_t *) todo, &enc->param);
+                  break;
+                case EET_COLORSPACE_RGB8_ETC2:
+                  etc2_rgb8_block_pack(offset, (uint32_t *) todo, &enc->param);
+                  break;
+                case EET_COLORSPACE_RGBA8_ETC2_EAC:
+                  etc2_rgba8_block_pack(offset, (uint32_t *) todo, &enc->param);
+                  break;
+                default: return EINA_FALSE;
+               }
+
+             offset += enc->etc_block_size;
+          }
+     }
+
+   return EINA_TRUE;
+}
+
+static void
+_eet_etc_stripe_encode(void *data, unsigned int stripe)
+{
+   Eet_Etc_Encode *enc = data;
+   int y = stripe * enc->macro_block_height;
+
+   for (int col = 0; col < enc->macro_block_cols; col++)
+     {
+        int idx = stripe * enc->macro_block_cols + col;
+        uint8_t *offset = enc->blocks + (size_t)idx * enc->macro_block_size;
+
+        if (!_eet_etc_macro_block_encode(enc, col * enc->macro_block_width, y, offset))
+          {
+             enc->error = EINA_TRUE;
+             return;
+          }
+        if (enc->compress)
+          {
+             Eina_Binbuf *in;
+
+             in = eina_binbuf_manage_new(offset, enc->macro_block_size, EINA_TRUE);
+             enc->comp[idx] = emile_compress(in, EMILE_LZ4HC, EMILE_COMPRESSOR_BEST);
+             eina_binbuf_free(in);
+          }
+     }
+}
+
 static void *
 eet_data_image_etc1_compressed_convert(int         *size,
                                        const unsigned char *data8,
@@ -782,12 +934,13 @@ eet_data_image_etc1_compressed_convert(int         *size,
                                        Eet_Image_Encoding lossy)
 {
    rg_etc1_pack_params param;
-   uint8_t *buffer;
+   Eet_Etc_Encode enc;
    uint32_t *data;
    uint32_t nl_width, nl_height;
    uint8_t header[8] = "TGV1";
    int block_width, block_height, macro_block_width, macro_block_height;
    int block_count, image_stride, image_height, etc_block_size;
+   int macro_block_num = 0;
    int num_planes = 1;
    Eet_Colorspace cspace;
    Eina_Bool unpremul = EINA_FALSE, alpha_texture = EINA_FALSE;
@@ -796,6 +949,7 @@ eet_data_image_etc1_compressed_convert(int         *size,
    const char *codec;
 
    data = NULL;
+   memset(&enc, 0, sizeof(enc));
    r = eina_binbuf_new();
    if (!r) return NULL;
 
@@ -875,7 +1029,26 @@ eet_data_image_etc1_compressed_convert(int         *size,
 
    // Number of ETC1 blocks in a compressed block
    block_count = (macro_block_width * macro_block_height) / (4 * 4);
-   buffer = alloca(block_count * etc_block_size);
+
+   enc.param = param;
+   enc.cspace = cspace;
+   enc.image_stride = image_stride;
+   enc.image_height = image_height;
+   enc.macro_block_width = macro_block_width;
+   enc.macro_block_height = macro_block_height;
+   enc.macro_block_cols = (image_stride + 2 + macro_block_width - 1) / macro_block_width;
+   enc.macro_block_rows = (image_height + 2 + macro_block_height - 1) / macro_block_height;
+   enc.macro_block_size = block_count * etc_block_size;
+   enc.etc_block_size = etc_block_size;
+   enc.compress = compress;
+   macro_block_num = enc.macro_block_cols * enc.macro_block_rows;
+   enc.blocks = malloc((size_t)macro_block_num * enc.macro_block_size);
+   if (!enc.blocks) goto finish;
+   if (compress)
+     {
+        enc.comp = calloc(macro_block_num, sizeof(Eina_Binbuf *));
+        if (!enc.comp) goto finish;
+     }
 
    // Write a whole plane (RGB or Alpha)
    for (int plane = 0; plane < num_planes; plane++)
@@ -900,169 +1073,63 @@ eet_data_image_etc1_compressed_convert(int         *size,
              _alpha_to_greyscale_convert(data, image_stride * image_height);
           }
 
-        // Write macro block
-        for (int y = 0; y < image_height + 2; y += macro_block_height)
-          {
-             uint32_t *input, *last_col, *last_row, *last_pix;
-             int real_y;
+        // Encode the macro block rows in parallel
+        enc.data = data;
+        rg_etc_jobs_run(enc.macro_block_rows, 0, _eet_etc_stripe_encode, &enc);
+        if (enc.error) goto finish;
 
-             if (y == 0) real_y = 0;
-             else if (y < image_height + 1) real_y = y - 1;
-             else real_y = image_height - 1;
+        // Write macro blocks, in the same order they were always written
+        for (int idx = 0; idx < macro_block_num; idx++)
+          {
+             const unsigned char *comp = NULL;
+             unsigned int wlen = 0;
 
-             for (int x = 0; x < image_stride + 2; x += macro_block_width)
+             if (compress)
                {
-                  Eina_Binbuf *in;
-                  uint8_t *offset = buffer;
-                  int real_x = x;
-
-                  if (x == 0) real_x = 0;
-                  else if (x < image_stride + 1) real_x = x - 1;
-                  else real_x = image_stride - 1;
-
-                  input = data + real_y * image_stride + real_x;
-                  last_row = data + image_stride * (image_height - 1) + real_x;
-                  last_col = data + (real_y + 1) * image_stride - 1;
-                  last_pix = data + image_height * image_stride - 1;
-
-                  for (int by = 0; by < macro_block_height; by += 4)
+                  if (enc.comp[idx])
                     {
-                       int dup_top = ((y + by) == 0) ? 1 : 0;
-                       int max_row = MAX(0, MIN(4, image_height - real_y - by));
-                       int oy = (y == 0) ? 1 : 0;
-
-                       for (int bx = 0; bx < macro_block_width; bx += 4)
-                         {
-                            int dup_left = ((x + bx) == 0) ? 1 : 0;
-                            int max_col = MAX(0, MIN(4, image_stride - real_x - bx));
-                            uint32_t todo[16] = { 0 };
-                            int row, col;
-                            int ox = (x == 0) ? 1 : 0;
-
-                            if (dup_left)
-                              {
-                                 // Duplicate left column
-                                 for (row = 0; row < max_row; row++)
-                                   todo[row * 4] = input[row * image_stride];
-                                 for (row = max_row; row < 4; row++)
-                                   todo[row * 4] = last_row[0];
-                              }
-
-                            if (dup_top)
-                              {
-                                 // Duplicate top row
-                                 for (col = 0; col < max_col; col++)
-                                   todo[col] = input[MAX(col + bx - ox, 0)];
-                                 for (col = max_col; col < 4; col++)
-                                   todo[col] = last_col[0];
-                              }
-
-                            for (row = dup_top; row < 4; row++)
-                              {
-                                 for (col = dup_left; col < max_col; col++)
-                                   {
-                                      if (row < max_row)
-                                        {
-                                           // Normal copy
-                                           todo[row * 4 + col] = input[(row + by - oy) * image_stride + bx + col - ox];
-                                        }
-                                      else
-                                        {
-                                           // Copy last line
-                                           todo[row * 4 + col] = last_row[col + bx - ox];
-                                        }
-                                   }
-                                 for (col = max_col; col < 4; col++)
-                                   {
-                                      // Right edge
-                                      if (row < max_row)
-                                        {
-                                           // Duplicate last column
-                                           todo[row * 4 + col] = last_col[MAX(row + by - oy, 0) * image_stride];
-                                        }
-                                      else
-                                        {
-                                           // Duplicate very last pixel again and again
-                                           todo[row * 4 + col] = *last_pix;
-                                        }
-                                   }
-                              }
-
-                            switch (cspace)
-                              {
-                               case EET_COLORSPACE_ETC1:
-                               case EET_COLORSPACE_ETC1_ALPHA:
-                                 rg_etc1_pack_block(offset, (uint32_t *) todo, &param);
-                                 break;
-                               case EET_COLORSPACE_RGB8_ETC2:
-                                 etc2_rgb8_block_pack(offset, (uint32_t *) todo, &param);
-                                 break;
-                               case EET_COLORSPACE_RGBA8_ETC2_EAC:
-                                 etc2_rgba8_block_pack(offset, (uint32_t *) todo, &param);
-                                 break;
-                               default: return 0;
-                              }
-
-#ifdef DEBUG_STATS
-                            if (plane == 0)
-                              {
-                                 // Decode to compute PSNR, this is slow.
-                                 uint32_t done[16];
-
-                                 if (alpha)
-                                   rg_etc2_rgba8_decode_block(offset, done);
-                                 else
-                                    rg_etc2_rgb8_decode_block(offset, done);
-
-                                 for (int k = 0; k < 16; k++)
-                                   {
-                                      const int r = (R_VAL(&(todo[k])) - R_VAL(&(done[k])));
-                                      const int g = (G_VAL(&(todo[k])) - G_VAL(&(done[k])));
-                                      const int b = (B_VAL(&(todo[k])) - B_VAL(&(done[k])));
-                                      const int a = (A_VAL(&(todo[k])) - A_VAL(&(done[k])));
-                                      mse += r*r + g*g + b*b;
-                                      if (alpha) mse_alpha += a*a;
-                                      mse_div++;
-                                   }
-                              }
-#endif
-
-                            offset += etc_block_size;
-                         }
+                       comp = eina_binbuf_string_get(enc.comp[idx]);
+                       wlen = eina_binbuf_length_get(enc.comp[idx]);
                     }
+               }
+             else
+               {
+                  comp = enc.blocks + (size_t)idx * enc.macro_block_size;
+                  wlen = enc.macro_block_size;
+               }
 
-                  in = eina_binbuf_manage_new(buffer, block_count * etc_block_size, EINA_TRUE);
-                  if (compress)
-                    {
-                       Eina_Binbuf *out;
-
-                       out = emile_compress(in, EMILE_LZ4HC, EMILE_COMPRESSOR_BEST);
-                       eina_binbuf_free(in);
-                       in = out;
-                    }
+             if (wlen > 0)
+               {
+                  unsigned int blen = wlen;
 
-                  if (eina_binbuf_length_get(in) > 0)
+                  while (blen)
                     {
-                       unsigned int blen = eina_binbuf_length_get(in);
-
-                       while (blen)
-                         {
-                            unsigned char plen;
+                       unsigned char plen;
 
-                            plen = blen & 0x7F;
-                            blen = blen >> 7;
+                       plen = blen & 0x7F;
+                       blen = blen >> 7;
 
-                            if (blen) plen = 0x80 | plen;
-                            eina_binbuf_append_length(r, &plen, 1);
-                         }
-                       eina_binbuf_append_buffer(r, in);
+                       if (blen) plen = 0x80 | plen;
+                       eina_binbuf_append_length(r, &plen, 1);
                     }
-                  eina_binbuf_free(in);
-               } // 4 rows
+                  eina_binbuf_append_length(r, comp, wlen);
+               }
+             if (compress && enc.comp[idx])
+               {
+                  eina_binbuf_free(enc.comp[idx]);
+                  enc.comp[idx] = NULL;
+               }
           } // macroblocks
      } // planes
 
 finish:
+   if (enc.comp)
+     {
+        for (int idx = 0; idx < macro_block_num; idx++)
+          if (enc.comp[idx]) eina_binbuf_free(enc.comp[idx]);
+     }
+   free(enc.comp);
+   free(enc.blocks);
    if (alpha_texture) free(data);
    *size = eina_binbuf_length_get(r);
    result = eina_binbuf_string_steal(r);
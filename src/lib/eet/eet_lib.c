@@ -33,6 +33,7 @@ EAPI Eet_Version *eet_version = &_version;
 #define EET_MAGIC_FILE_HEADER 0x1ee7ff01
 
 #define EET_MAGIC_FILE2       0x1ee70f42
+#define EET_MAGIC_JOURNAL     0x1ee7a9e1
 
 #define EET_FILE2_HEADER_COUNT           3
 #define EET_FILE2_DIRECTORY_ENTRY_COUNT  6
@@ -45,9 +46,24 @@ EAPI Eet_Version *eet_version = &_version;
 #define EET_FILE2_DICTIONARY_ENTRY_SIZE  (sizeof(int) * \
                                           EET_FILE2_DICTIONARY_ENTRY_COUNT)
 
+#define EET_JOURNAL_HEADER_COUNT           4
+#define EET_JOURNAL_DICTIONARY_ENTRY_COUNT 2
+
+#define EET_JOURNAL_HEADER_SIZE           (sizeof(int) * \
+                                           EET_JOURNAL_HEADER_COUNT)
+#define EET_JOURNAL_DICTIONARY_ENTRY_SIZE (sizeof(int) * \
+                                           EET_JOURNAL_DICTIONARY_ENTRY_COUNT)
+
+#define EET_JOURNAL_FLAG_DELETED (1 << 11)
+
 // force data alignmenmt in the eet file so direct mmap can work without
 // copies and we can work with alignment
 #define ALIGN 8
+#define ALIGN_PAD(Offset) \
+  ((((Offset) + (ALIGN - 1)) / ALIGN) * ALIGN - (Offset))
+
+// below this amount of data to compress, threads are not worth it
+#define EET_COMPRESS_THREAD_MIN (64 * 1024)
 
 /* prototypes of internal calls */
 static Eet_File *
@@ -79,6 +95,9 @@ static Eet_File_Node *
 static Eina_Binbuf *
 read_binbuf_from_disk(Eet_File      *ef,
                       Eet_File_Node *efn);
+static Eina_Bool
+remove_node_by_name(Eet_File   *ef,
+                    const char *name);
 
 static Eet_Error
 eet_internal_close(Eet_File *ef, Eina_Bool locked, Eina_Bool shutdown);
@@ -287,6 +306,376 @@ eet_string_match(const char *s1,
     return !strcmp(s1, s2);
 }
 
+static Eet_Error
+eet_write_error_get(void)
+{
+   switch (errno)
+     {
+      case EFBIG: return EET_ERROR_WRITE_ERROR_FILE_TOO_BIG;
+
+      case EIO: return EET_ERROR_WRITE_ERROR_IO_ERROR;
+
+      case ENOSPC: return EET_ERROR_WRITE_ERROR_OUT_OF_SPACE;
+
+      case EPIPE: return EET_ERROR_WRITE_ERROR_FILE_CLOSED;
+
+      default: return EET_ERROR_WRITE_ERROR;
+     }
+}
+
+typedef struct _Eet_Compress_Job Eet_Compress_Job;
+struct _Eet_Compress_Job
+{
+   Eet_File_Node **nodes;
+   int             count;
+   int             next;
+   Eina_Lock       lock;
+};
+
+static void
+eet_node_compress(Eet_File_Node *efn)
+{
+   Eina_Binbuf *in;
+   Eina_Binbuf *out;
+   int comp = efn->deferred_compression;
+
+   efn->deferred_compression = 0;
+
+   in = eina_binbuf_manage_new(efn->data, efn->size, EINA_TRUE);
+   if (!in) return;
+
+   out = emile_compress(in, eet_2_emile_compressor(comp), EMILE_COMPRESSOR_BEST);
+   eina_binbuf_free(in);
+   if (!out) return;
+
+   /* same as eet_write_cipher(), keep it uncompressed if it doesn't help */
+   if (eina_binbuf_length_get(out) < efn->size)
+     {
+        free(efn->data);
+        efn->compression = 1;
+        efn->compression_type = comp;
+        efn->size = eina_binbuf_length_get(out);
+        efn->data = eina_binbuf_string_steal(out);
+     }
+   eina_binbuf_free(out);
+}
+
+static void *
+eet_compress_thread(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Eet_Compress_Job *job = data;
+   Eet_File_Node *efn;
+
+   while (1)
+     {
+        eina_lock_take(&job->lock);
+        efn = (job->next < job->count) ? job->nodes[job->next++] : NULL;
+        eina_lock_release(&job->lock);
+
+        if (!efn) break;
+        eet_node_compress(efn);
+     }
+
+   return NULL;
+}
+
+/* compress the entries written with a deferred compression, spreading them
+ * over as many threads as we have cpus */
+static void
+eet_flush_compress(Eet_File *ef)
+{
+   Eet_Compress_Job job;
+   Eet_File_Node *efn;
+   Eina_Thread *threads = NULL;
+   unsigned long int bytes = 0;
+   int num;
+   int max;
+   int started = 0;
+   int i;
+
+   job.count = 0;
+   num = (1 << ef->header->directory->size);
+   for (i = 0; i < num; i++)
+     for (efn = ef->header->directory->nodes[i]; efn; efn = efn->next)
+       if (efn->deferred_compression)
+         {
+            job.count++;
+            bytes += efn->size;
+         }
+   if (!job.count) return;
+
+   job.nodes = malloc(job.count * sizeof (Eet_File_Node *));
+   if (!job.nodes)
+     {
+        for (i = 0; i < num; i++)
+          for (efn = ef->header->directory->nodes[i]; efn; efn = efn->next)
+            if (efn->deferred_compression)
+              eet_node_compress(efn);
+        return;
+     }
+
+   job.count = 0;
+   job.next = 0;
+   for (i = 0; i < num; i++)
+     for (efn = ef->header->directory->nodes[i]; efn; efn = efn->next)
+       if (efn->deferred_compression)
+         job.nodes[job.count++] = efn;
+
+   max = eina_cpu_count();
+   if (max > job.count) max = job.count;
+   if (bytes < EET_COMPRESS_THREAD_MIN) max = 1;
+   if (max > 1) threads = malloc((max - 1) * sizeof (Eina_Thread));
+
+   eina_lock_new(&job.lock);
+   for (i = 0; threads && (i < max - 1); i++)
+     {
+        if (!eina_thread_create(&threads[started], EINA_THREAD_NORMAL, -1,
+                                eet_compress_thread, &job))
+          break;
+        started++;
+     }
+
+   /* this thread does its share too */
+   eet_compress_thread(&job, eina_thread_self());
+
+   for (i = 0; i < started; i++)
+     eina_thread_join(threads[i]);
+   eina_lock_free(&job.lock);
+
+   free(threads);
+   free(job.nodes);
+}
+
+/* append the entries modified since the last flush to the file. Returns
+ * EINA_FALSE if the whole file has to be written again instead. */
+static Eina_Bool
+eet_flush_journal(Eet_File *ef, Eet_Error *error)
+{
+   Eet_File_Node **nodes = NULL;
+   Eet_File_Node *efn;
+   Eina_List *l;
+   const char *name;
+   FILE *fp;
+   struct stat st;
+   unsigned long int segment_offset;
+   unsigned long int name_offset;
+   unsigned long int data_offset;
+   unsigned long int offset;
+   unsigned long int size;
+   int head[EET_JOURNAL_HEADER_COUNT];
+   int num_directory_entries;
+   int num_dictionary_entries = 0;
+   int num_nodes = 0;
+   int num;
+   int pad;
+   int fd;
+   int i;
+   unsigned char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+   if ((!ef->journal) || (!ef->journal_end) || (ef->key) || (ef->x509_der))
+     return EINA_FALSE;
+
+   /* time to compact: the journal takes more room than the rest */
+   if ((ef->journal_end > ef->journal_offset) &&
+       ((ef->journal_end - ef->journal_offset) > ef->journal_offset))
+     return EINA_FALSE;
+
+   num = (1 << ef->header->directory->size);
+   for (i = 0; i < num; i++)
+     for (efn = ef->header->directory->nodes[i]; efn; efn = efn->next)
+       if (efn->dirty) num_nodes++;
+
+   if (num_nodes)
+     {
+        nodes = malloc(num_nodes * sizeof (Eet_File_Node *));
+        if (!nodes) return EINA_FALSE;
+
+        num_nodes = 0;
+        for (i = 0; i < num; i++)
+          for (efn = ef->header->directory->nodes[i]; efn; efn = efn->next)
+            if (efn->dirty) nodes[num_nodes++] = efn;
+     }
+
+   if (ef->ed)
+     num_dictionary_entries = ef->ed->count - ef->journal_dictionary_count;
+   num_directory_entries = eina_list_count(ef->journal_deleted) + num_nodes;
+
+   /* layout: header, directory, dictionary, names, strings, then data */
+   segment_offset = ef->journal_end + ALIGN_PAD(ef->journal_end);
+   name_offset = segment_offset + EET_JOURNAL_HEADER_SIZE +
+     num_directory_entries * EET_FILE2_DIRECTORY_ENTRY_SIZE +
+     num_dictionary_entries * EET_JOURNAL_DICTIONARY_ENTRY_SIZE;
+   offset = name_offset;
+   EINA_LIST_FOREACH(ef->journal_deleted, l, name)
+     offset += strlen(name) + 1;
+   for (i = 0; i < num_nodes; i++)
+     offset += nodes[i]->name_size;
+   for (i = 0; i < num_dictionary_entries; i++)
+     offset += ef->ed->all[ef->journal_dictionary_count + i].len;
+   offset += ALIGN_PAD(offset);
+   data_offset = offset;
+   for (i = 0; i < num_nodes; i++)
+     {
+        offset += nodes[i]->size;
+        offset += ALIGN_PAD(offset);
+     }
+   size = offset - segment_offset;
+
+   /* the offsets are stored on 32 bits */
+   if (offset > 0x7fffffff) goto on_fallback;
+
+   /* make sure nobody replaced the file since we last wrote it */
+   fd = open(ef->path, O_WRONLY | O_APPEND | O_BINARY);
+   if (fd < 0) goto on_fallback;
+   if ((fstat(fd, &st) != 0) ||
+       ((unsigned long int)st.st_size != ef->journal_end))
+     {
+        close(fd);
+        goto on_fallback;
+     }
+
+   fp = fdopen(fd, "ab");
+   if (!fp)
+     {
+        close(fd);
+        goto on_fallback;
+     }
+
+   if (!eina_file_close_on_exec(fd, EINA_TRUE)) ERR("can't set CLOEXEC on write fd");
+
+   pad = segment_offset - ef->journal_end;
+   if ((pad > 0) && (fwrite(zeros, pad, 1, fp) != 1))
+     goto write_error;
+
+   head[0] = (int)eina_htonl((unsigned int)EET_MAGIC_JOURNAL);
+   head[1] = (int)eina_htonl((unsigned int)num_directory_entries);
+   head[2] = (int)eina_htonl((unsigned int)num_dictionary_entries);
+   head[3] = (int)eina_htonl((unsigned int)size);
+   if (fwrite(head, sizeof (head), 1, fp) != 1)
+     goto write_error;
+
+   /* deletions first, an entry can be deleted then written again */
+   offset = name_offset;
+   EINA_LIST_FOREACH(ef->journal_deleted, l, name)
+     {
+        int ibuf[EET_FILE2_DIRECTORY_ENTRY_COUNT];
+
+        ibuf[0] = 0;
+        ibuf[1] = 0;
+        ibuf[2] = 0;
+        ibuf[3] = (int)eina_htonl((unsigned int)offset);
+        ibuf[4] = (int)eina_htonl((unsigned int)(strlen(name) + 1));
+        ibuf[5] = (int)eina_htonl((unsigned int)EET_JOURNAL_FLAG_DELETED);
+
+        offset += strlen(name) + 1;
+
+        if (fwrite(ibuf, sizeof (ibuf), 1, fp) != 1)
+          goto write_error;
+     }
+   for (i = 0; i < num_nodes; i++)
+     {
+        int ibuf[EET_FILE2_DIRECTORY_ENTRY_COUNT];
+        unsigned int flag;
+
+        efn = nodes[i];
+        flag = (efn->alias << 2) | (efn->ciphered << 1) | efn->compression;
+        flag |= efn->compression_type << 3;
+
+        ibuf[0] = (int)eina_htonl((unsigned int)data_offset);
+        ibuf[1] = (int)eina_htonl((unsigned int)efn->size);
+        ibuf[2] = (int)eina_htonl((unsigned int)efn->data_size);
+        ibuf[3] = (int)eina_htonl((unsigned int)offset);
+        ibuf[4] = (int)eina_htonl((unsigned int)efn->name_size);
+        ibuf[5] = (int)eina_htonl((unsigned int)flag);
+
+        offset += efn->name_size;
+        data_offset += efn->size;
+        data_offset += ALIGN_PAD(data_offset);
+
+        if (fwrite(ibuf, sizeof (ibuf), 1, fp) != 1)
+          goto write_error;
+     }
+
+   for (i = 0; i < num_dictionary_entries; i++)
+     {
+        int sbuf[EET_JOURNAL_DICTIONARY_ENTRY_COUNT];
+        const Eet_String *str = &ef->ed->all[ef->journal_dictionary_count + i];
+
+        sbuf[0] = (int)eina_htonl((unsigned int)offset);
+        sbuf[1] = (int)eina_htonl((unsigned int)str->len);
+
+        offset += str->len;
+
+        if (fwrite(sbuf, sizeof (sbuf), 1, fp) != 1)
+          goto write_error;
+     }
+
+   EINA_LIST_FOREACH(ef->journal_deleted, l, name)
+     if (fwrite(name, strlen(name) + 1, 1, fp) != 1)
+       goto write_error;
+   for (i = 0; i < num_nodes; i++)
+     if (fwrite(nodes[i]->name, nodes[i]->name_size, 1, fp) != 1)
+       goto write_error;
+   for (i = 0; i < num_dictionary_entries; i++)
+     {
+        const Eet_String *str = &ef->ed->all[ef->journal_dictionary_count + i];
+
+        if (fwrite(str->str, str->len, 1, fp) != 1)
+          goto write_error;
+     }
+
+   pad = ALIGN_PAD(offset);
+   if ((pad > 0) && (fwrite(zeros, pad, 1, fp) != 1))
+     goto write_error;
+   offset += pad;
+
+   for (i = 0; i < num_nodes; i++)
+     {
+        if (fwrite(nodes[i]->data, nodes[i]->size, 1, fp) != 1)
+          goto write_error;
+
+        offset += nodes[i]->size;
+        pad = ALIGN_PAD(offset);
+        if ((pad > 0) && (fwrite(zeros, pad, 1, fp) != 1))
+          goto write_error;
+        offset += pad;
+     }
+
+   /* a segment is only valid once completely written */
+   if (fclose(fp) != 0)
+     {
+        *error = eet_write_error_get();
+        goto on_error;
+     }
+
+   for (i = 0; i < num_nodes; i++)
+     nodes[i]->dirty = 0;
+   EINA_LIST_FREE(ef->journal_deleted, name)
+     eina_stringshare_del(name);
+   if (ef->ed) ef->journal_dictionary_count = ef->ed->count;
+   ef->journal_end = segment_offset + size;
+   ef->writes_pending = 0;
+
+   free(nodes);
+   *error = EET_ERROR_NONE;
+   return EINA_TRUE;
+
+write_error:
+   ERR("Error during write on '%s'.", ef->path);
+   *error = eet_write_error_get();
+   fclose(fp);
+on_error:
+   /* the file doesn't end where we expect anymore, next flush will write
+    * it all again */
+   ef->journal_end = 0;
+   free(nodes);
+   return EINA_TRUE;
+
+on_fallback:
+   free(nodes);
+   return EINA_FALSE;
+}
+
 /* flush out writes to a v2 eet file */
 static Eet_Error
 eet_flush2(Eet_File *ef)
@@ -309,6 +698,7 @@ eet_flush2(Eet_File *ef)
    int i;
    int j;
    unsigned char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+   const char *name;
 
    if (eet_check_pointer(ef))
      return EET_ERROR_BAD_OBJECT;
@@ -319,6 +709,12 @@ eet_flush2(Eet_File *ef)
    if (!ef->writes_pending)
      return EET_ERROR_NONE;
 
+   eet_flush_compress(ef);
+
+   if (eet_flush_journal(ef, &error))
+     return error;
+   ef->journal_end = 0;
+
    if ((ef->mode == EET_FILE_MODE_READ_WRITE)
        || (ef->mode == EET_FILE_MODE_WRITE))
      {
@@ -492,15 +888,25 @@ eet_flush2(Eet_File *ef)
 
              data_offset += efn->size;
              pad = (((data_offset + (ALIGN - 1)) / ALIGN) * ALIGN) - data_offset;
+             efn->dirty = 0;
           }
      }
 
    /* flush all write to the file. */
    fflush(fp);
 
+   /* the journal, if any, starts from here */
+   EINA_LIST_FREE(ef->journal_deleted, name)
+     eina_stringshare_del(name);
+   ef->journal_dictionary_count = ef->ed ? ef->ed->count : 0;
+   ef->journal_end = ftell(fp);
+   ef->journal_offset = ef->journal_end + ALIGN_PAD(ef->journal_end);
+
    /* append signature if required */
    if (ef->key)
      {
+        /* nothing can be appended after the signature */
+        ef->journal_end = 0;
         error = eet_identity_sign(fp, ef->key);
         if (error != EET_ERROR_NONE)
           goto sign_error;
@@ -517,18 +923,7 @@ write_error:
    if (ferror(fp))
      {
         ERR("Error during write on '%s'.", ef->path);
-        switch (errno)
-          {
-           case EFBIG: error = EET_ERROR_WRITE_ERROR_FILE_TOO_BIG; break;
-
-           case EIO: error = EET_ERROR_WRITE_ERROR_IO_ERROR; break;
-
-           case ENOSPC: error = EET_ERROR_WRITE_ERROR_OUT_OF_SPACE; break;
-
-           case EPIPE: error = EET_ERROR_WRITE_ERROR_FILE_CLOSED; break;
-
-           default: error = EET_ERROR_WRITE_ERROR; break;
-          }
+        error = eet_write_error_get();
      }
 
 sign_error:
@@ -670,6 +1065,65 @@ eet_sync(Eet_File *ef)
    return ret;
 }
 
+EAPI Eina_Bool
+eet_journal_set(Eet_File *ef, Eina_Bool journal)
+{
+   if (eet_check_pointer(ef))
+     return EINA_FALSE;
+
+   if ((ef->mode != EET_FILE_MODE_WRITE) &&
+       (ef->mode != EET_FILE_MODE_READ_WRITE))
+     return EINA_FALSE;
+
+   LOCK_FILE(ef);
+   ef->journal = !!journal;
+   UNLOCK_FILE(ef);
+
+   return EINA_TRUE;
+}
+
+EAPI Eet_Error
+eet_compact(Eet_File *ef)
+{
+   Eet_Error ret;
+   unsigned char journal;
+
+   if (eet_check_pointer(ef))
+     return EET_ERROR_BAD_OBJECT;
+
+   if ((ef->mode != EET_FILE_MODE_WRITE) &&
+       (ef->mode != EET_FILE_MODE_READ_WRITE))
+     return EET_ERROR_NOT_WRITABLE;
+
+   LOCK_FILE(ef);
+
+   journal = ef->journal;
+   ef->journal = 0;
+   ef->writes_pending = 1;
+   ret = eet_flush2(ef);
+   ef->journal = journal;
+
+   UNLOCK_FILE(ef);
+   return ret;
+}
+
+EAPI Eina_Bool
+eet_compression_defer_set(Eet_File *ef, Eina_Bool defer)
+{
+   if (eet_check_pointer(ef))
+     return EINA_FALSE;
+
+   if ((ef->mode != EET_FILE_MODE_WRITE) &&
+       (ef->mode != EET_FILE_MODE_READ_WRITE))
+     return EINA_FALSE;
+
+   LOCK_FILE(ef);
+   ef->defer_compression = !!defer;
+   UNLOCK_FILE(ef);
+
+   return EINA_TRUE;
+}
+
 EAPI void
 eet_clearcache(void)
 {
@@ -728,7 +1182,197 @@ eet_clearcache(void)
    UNLOCK_CACHE;
 }
 
+/* check a journal segment is complete and all it refers to is inside it */
+static Eina_Bool
+eet_journal_segment_check(const Eet_File    *ef,
+                          unsigned long int  offset,
+                          unsigned long int *segment_end)
+{
+   const char *start = (const char *)ef->data;
+   const int *data = (const int *)(start + offset);
+   const int *dico;
+   unsigned long int num_directory_entries;
+   unsigned long int num_dictionary_entries;
+   unsigned long int segment_size;
+   unsigned long int bytes;
+   unsigned long int i;
+
+   if (offset + EET_JOURNAL_HEADER_SIZE > ef->data_size) return EINA_FALSE;
+   if ((int)eina_ntohl(data[0]) != EET_MAGIC_JOURNAL) return EINA_FALSE;
+   num_directory_entries = eina_ntohl(data[1]);
+   num_dictionary_entries = eina_ntohl(data[2]);
+   segment_size = eina_ntohl(data[3]);
+   data += EET_JOURNAL_HEADER_COUNT;
+
+   if (segment_size > ef->data_size - offset) return EINA_FALSE;
+   if ((num_directory_entries > segment_size) ||
+       (num_dictionary_entries > segment_size))
+     return EINA_FALSE;
+   bytes = EET_JOURNAL_HEADER_SIZE +
+     num_directory_entries * EET_FILE2_DIRECTORY_ENTRY_SIZE +
+     num_dictionary_entries * EET_JOURNAL_DICTIONARY_ENTRY_SIZE;
+   if (bytes > segment_size) return EINA_FALSE;
+   bytes += offset;
+   *segment_end = offset + segment_size;
+
+   for (i = 0; i < num_directory_entries; i++)
+     {
+        unsigned long int data_offset = eina_ntohl(data[0]);
+        unsigned long int size = eina_ntohl(data[1]);
+        unsigned long int name_offset = eina_ntohl(data[3]);
+        unsigned long int name_size = eina_ntohl(data[4]);
+        unsigned int flag = eina_ntohl(data[5]);
+
+        data += EET_FILE2_DIRECTORY_ENTRY_COUNT;
+        if ((name_size == 0) || (name_offset < bytes) ||
+            (name_offset + name_size > *segment_end) ||
+            (start[name_offset + name_size - 1] != '\0'))
+          return EINA_FALSE;
+        if (flag & EET_JOURNAL_FLAG_DELETED) continue;
+        if ((size == 0) || (data_offset < bytes) ||
+            (data_offset + size > *segment_end))
+          return EINA_FALSE;
+     }
+
+   dico = data;
+   for (i = 0; i < num_dictionary_entries; i++)
+     {
+        unsigned long int str_offset = eina_ntohl(dico[0]);
+        unsigned long int len = eina_ntohl(dico[1]);
+
+        dico += EET_JOURNAL_DICTIONARY_ENTRY_COUNT;
+        if ((len == 0) || (str_offset < bytes) ||
+            (str_offset + len > *segment_end) ||
+            (start[str_offset + len - 1] != '\0'))
+          return EINA_FALSE;
+     }
+
+   return EINA_TRUE;
+}
+
 /* FIXME: MMAP race condition in READ_WRITE_MODE */
+/* apply the journal segments appended after the end of a v3 eet file. a
+ * segment that was not completely written or is damaged ends the replay,
+ * the file is then seen as it was after the last good segment, and the
+ * next flush rewrites it as the tail does not match journal_end */
+static Eina_Bool
+eet_internal_read_journal(Eet_File         *ef,
+                          unsigned long int base_end)
+{
+   const char *start = (const char *)ef->data;
+   unsigned long int offset;
+   unsigned long int segment_end;
+
+   ef->journal_end = base_end;
+   offset = base_end + ALIGN_PAD(base_end);
+   ef->journal_offset = offset;
+
+   while (eet_journal_segment_check(ef, offset, &segment_end))
+     {
+        const int *data = (const int *)(start + offset);
+        unsigned long int num_directory_entries;
+        unsigned long int num_dictionary_entries;
+        unsigned long int i;
+
+        num_directory_entries = eina_ntohl(data[1]);
+        num_dictionary_entries = eina_ntohl(data[2]);
+        data += EET_JOURNAL_HEADER_COUNT;
+
+        if (num_dictionary_entries && !ef->ed)
+          {
+             ef->ed = eet_dictionary_add();
+             if (!ef->ed) return EINA_FALSE;
+          }
+
+        /* strings come after the directory but are referenced by index */
+        for (i = 0; i < num_dictionary_entries; i++)
+          {
+             const int *dico = data + num_directory_entries *
+               EET_FILE2_DIRECTORY_ENTRY_COUNT +
+               i * EET_JOURNAL_DICTIONARY_ENTRY_COUNT;
+             int expected = ef->ed->count;
+
+             /* all the strings written to the journal are new */
+             if (eet_dictionary_string_add(ef->ed, start + eina_ntohl(dico[0])) !=
+                 expected)
+               goto on_damaged;
+          }
+
+        for (i = 0; i < num_directory_entries; i++)
+          {
+             Eet_File_Node *efn;
+             const char *name;
+             unsigned int flag;
+             int hash;
+
+             name = start + eina_ntohl(data[3]);
+             flag = eina_ntohl(data[5]);
+
+             if (flag & EET_JOURNAL_FLAG_DELETED)
+               {
+                  remove_node_by_name(ef, name);
+                  data += EET_FILE2_DIRECTORY_ENTRY_COUNT;
+                  continue;
+               }
+
+             efn = find_node_by_name(ef, name);
+             if (!efn)
+               {
+                  efn = eet_file_node_malloc(1);
+                  if (!efn) return EINA_FALSE;
+
+                  efn->free_name = 0;
+                  efn->name = (char *)name;
+                  efn->name_size = eina_ntohl(data[4]);
+                  efn->data = NULL;
+
+                  hash = _eet_hash_gen(efn->name, ef->header->directory->size);
+                  efn->next = ef->header->directory->nodes[hash];
+                  ef->header->directory->nodes[hash] = efn;
+               }
+             else if (efn->data)
+               {
+                  free(efn->data);
+                  efn->data = NULL;
+                  ef->header->directory->free_count--;
+               }
+
+             efn->offset = eina_ntohl(data[0]);
+             efn->size = eina_ntohl(data[1]);
+             efn->data_size = eina_ntohl(data[2]);
+             efn->compression = flag & 0x1 ? 1 : 0;
+             efn->ciphered = flag & 0x2 ? 1 : 0;
+             efn->alias = flag & 0x4 ? 1 : 0;
+             efn->compression_type = (flag >> 3) & 0xff;
+             efn->deferred_compression = 0;
+             efn->dirty = 0;
+             data += EET_FILE2_DIRECTORY_ENTRY_COUNT;
+
+             /* read-write mode - read everything into ram */
+             if (ef->mode != EET_FILE_MODE_READ)
+               {
+                  efn->data = malloc(efn->size);
+                  if (efn->data)
+                    {
+                       memcpy(efn->data, ef->data + efn->offset, efn->size);
+                       ef->header->directory->free_count++;
+                    }
+               }
+          }
+
+        offset = segment_end;
+        ef->journal_end = segment_end;
+     }
+
+   /* only padding after the last segment */
+   if (offset >= ef->data_size)
+     ef->journal_end = ef->data_size;
+
+on_damaged:
+   ef->journal_dictionary_count = ef->ed ? ef->ed->count : 0;
+   return EINA_TRUE;
+}
+
 static Eet_File *
 eet_internal_read2(Eet_File *ef)
 {
@@ -738,6 +1382,7 @@ eet_internal_read2(Eet_File *ef)
    unsigned long int bytes_directory_entries;
    unsigned long int bytes_dictionary_entries;
    unsigned long int signature_base_offset;
+   unsigned long int journal_offset;
    unsigned long int num_directory_entries;
    unsigned long int num_dictionary_entries;
    unsigned int i;
@@ -799,6 +1444,7 @@ eet_internal_read2(Eet_File *ef)
      {
         signature_base_offset = ef->data_size;
      }
+   journal_offset = bytes_directory_entries + bytes_dictionary_entries;
 
    /* actually read the directory block - all of it, into ram */
    for (i = 0; i < num_directory_entries; ++i)
@@ -833,6 +1479,8 @@ eet_internal_read2(Eet_File *ef)
         efn->ciphered = flag & 0x2 ? 1 : 0;
         efn->alias = flag & 0x4 ? 1 : 0;
         efn->compression_type = (flag >> 3) & 0xff;
+        efn->deferred_compression = 0;
+        efn->dirty = 0;
 
 #define EFN_TEST(Test, Ef, Efn) \
   if (eet_test_close(Test, Ef)) \
@@ -882,6 +1530,12 @@ eet_internal_read2(Eet_File *ef)
         /* compute the possible position of a signature */
         if (signature_base_offset < (efn->offset + efn->size))
           signature_base_offset = efn->offset + efn->size;
+
+        /* and of the journal */
+        if (journal_offset < (efn->offset + efn->size))
+          journal_offset = efn->offset + efn->size;
+        if (journal_offset < (name_offset + name_size))
+          journal_offset = name_offset + name_size;
      }
 
    ef->ed = NULL;
@@ -967,16 +1621,25 @@ eet_internal_read2(Eet_File *ef)
              /* compute the possible position of a signature */
              if (signature_base_offset < offset + ef->ed->all[j].len)
                signature_base_offset = offset + ef->ed->all[j].len;
+
+             if (journal_offset < offset + ef->ed->all[j].len)
+               journal_offset = offset + ef->ed->all[j].len;
           }
      }
 
+   /* apply the changes appended to the file since it was written */
+   if (eet_test_close(!eet_internal_read_journal(ef, journal_offset), ef))
+     return NULL;
+
    /* Check if the file is signed */
    ef->x509_der = NULL;
    ef->x509_length = 0;
    ef->signature = NULL;
    ef->signature_length = 0;
 
-   if (signature_base_offset < ef->data_size)
+   /* a journal is never appended after a signature */
+   if ((signature_base_offset < ef->data_size) &&
+       (ef->journal_end <= ef->journal_offset))
      {
 #ifdef HAVE_SIGNATURE
         const unsigned char *buffer = ((const unsigned char *)ef->data) +
@@ -1140,6 +1803,8 @@ eet_internal_read1(Eet_File *ef)
         efn->name_size = name_size;
         efn->ciphered = 0;
         efn->alias = 0;
+        efn->deferred_compression = 0;
+        efn->dirty = 0;
 
         /* invalid size */
         if (eet_test_close(efn->size <= 0, ef))
@@ -1260,6 +1925,7 @@ eet_internal_close(Eet_File *ef,
                    Eina_Bool locked, Eina_Bool shutdown)
 {
    Eet_Error err = EET_ERROR_NONE;
+   const char *name;
 
    /* check to see its' an eet file pointer */
    if (eet_check_pointer(ef))
@@ -1356,6 +2022,9 @@ eet_internal_close(Eet_File *ef,
 
    eet_dictionary_free(ef->ed);
 
+   EINA_LIST_FREE(ef->journal_deleted, name)
+     eina_stringshare_del(name);
+
    if (ef->sha1)
      free(ef->sha1);
 
@@ -1414,6 +2083,12 @@ eet_memopen_read(const void *data,
    ef->sha1 = NULL;
    ef->sha1_length = 0;
    ef->readfp_owned = EINA_FALSE;
+   ef->journal_deleted = NULL;
+   ef->journal_offset = 0;
+   ef->journal_end = 0;
+   ef->journal_dictionary_count = 0;
+   ef->journal = 0;
+   ef->defer_compression = 0;
 
    ef = eet_internal_read(ef);
    UNLOCK_CACHE;
@@ -1473,6 +2148,13 @@ eet_mmap(const Eina_File *file)
    ef->sha1 = NULL;
    ef->sha1_length = 0;
    ef->readfp_owned = EINA_TRUE;
+   ef->x509_der = NULL;
+   ef->journal_deleted = NULL;
+   ef->journal_offset = 0;
+   ef->journal_end = 0;
+   ef->journal_dictionary_count = 0;
+   ef->journal = 0;
+   ef->defer_compression = 0;
 
    ef->data_size = eina_file_size_get(ef->readfp);
    ef->data = eina_file_map_all(ef->readfp, EINA_FILE_SEQUENTIAL);
@@ -1620,6 +2302,13 @@ open_error:
    ef->sha1 = NULL;
    ef->sha1_length = 0;
    ef->readfp_owned = EINA_TRUE;
+   ef->x509_der = NULL;
+   ef->journal_deleted = NULL;
+   ef->journal_offset = 0;
+   ef->journal_end = 0;
+   ef->journal_dictionary_count = 0;
+   ef->journal = 0;
+   ef->defer_compression = 0;
 
    ef->ed = (mode == EET_FILE_MODE_WRITE)
      || (!ef->readfp && mode == EET_FILE_MODE_READ_WRITE) ?
@@ -2095,8 +2784,9 @@ eet_read_direct(Eet_File   *ef,
         return eet_read_direct(ef, data, size_ret);
      }
    else
-   /* uncompressed data */
-   if ((efn->compression == 0) && (efn->ciphered == 0))
+   /* uncompressed data, not going to be compressed by next flush */
+   if ((efn->compression == 0) && (efn->ciphered == 0) &&
+       (efn->deferred_compression == 0))
      data = efn->data ? efn->data : ef->data + efn->offset;  /* compressed data */
    else
      data = NULL;
@@ -2209,6 +2899,8 @@ eet_define_data(Eet_File *ef, Eet_File_Node *efn, Eina_Binbuf *data, int origina
    efn->ciphered = ciphered;
    efn->compression = !!comp;
    efn->compression_type = comp;
+   efn->deferred_compression = 0;
+   efn->dirty = 1;
    efn->size = eina_binbuf_length_get(data);
    efn->data_size = original_size;
    efn->data = efn->size ? eina_binbuf_string_steal(data) : NULL;
@@ -2349,6 +3041,7 @@ eet_write_cipher(Eet_File   *ef,
    Eina_Binbuf *in;
    Eet_File_Node *efn;
    int exists_already = 0;
+   int deferred = 0;
    int hash;
 
    /* check to see its' an eet file pointer */
@@ -2401,6 +3094,12 @@ eet_write_cipher(Eet_File   *ef,
    UNLOCK_FILE(ef);
 
    in = eina_binbuf_manage_new(data, size, EINA_TRUE);
+   if (comp && !cipher_key && ef->defer_compression)
+     {
+        /* compressed in parallel with the others by eet_flush2() */
+        deferred = comp;
+        comp = 0;
+     }
    if (comp)
      {
         Eina_Binbuf *out;
@@ -2449,6 +3148,7 @@ eet_write_cipher(Eet_File   *ef,
         if ((efn->name) && (eet_string_match(efn->name, name)))
           {
              eet_define_data(ef, efn, in, size, comp, !!cipher_key);
+             efn->deferred_compression = deferred;
              exists_already = 1;
              break;
           }
@@ -2472,6 +3172,7 @@ eet_write_cipher(Eet_File   *ef,
         ef->header->directory->nodes[hash] = efn;
 
         eet_define_data(ef, efn, in, size, comp, !!cipher_key);
+        efn->deferred_compression = deferred;
         ef->header->directory->free_count++;
      }
 
@@ -2502,9 +3203,6 @@ EAPI int
 eet_delete(Eet_File   *ef,
            const char *name)
 {
-   Eet_File_Node *efn;
-   Eet_File_Node *pefn;
-   int hash;
    int exists_already = 0;
 
    /* check to see its' an eet file pointer */
@@ -2523,36 +3221,16 @@ eet_delete(Eet_File   *ef,
 
    LOCK_FILE(ef);
 
-   /* figure hash bucket */
-   hash = _eet_hash_gen(name, ef->header->directory->size);
-
-   /* Does this node already exist? */
-   for (pefn = NULL, efn = ef->header->directory->nodes[hash];
-        efn;
-        pefn = efn, efn = efn->next)
-     {
-        /* if it matches */
-         if (eet_string_match(efn->name, name))
-           {
-              if (efn->data)
-                free(efn->data);
-
-              if (!pefn)
-                ef->header->directory->nodes[hash] = efn->next;
-              else
-                pefn->next = efn->next;
-
-              if (efn->free_name)
-                free(efn->name);
+   exists_already = remove_node_by_name(ef, name);
 
-              eet_file_node_mp_free(efn);
-              exists_already = 1;
-              break;
-           }
-     }
    /* flags that writes are pending */
    if (exists_already)
-     ef->writes_pending = 1;
+     {
+        ef->writes_pending = 1;
+        /* remember it for the journal */
+        ef->journal_deleted = eina_list_append(ef->journal_deleted,
+                                               eina_stringshare_add(name));
+     }
 
    UNLOCK_FILE(ef);
 
@@ -2815,6 +3493,44 @@ find_node_by_name(Eet_File   *ef,
    return NULL;
 }
 
+static Eina_Bool
+remove_node_by_name(Eet_File   *ef,
+                    const char *name)
+{
+   Eet_File_Node *efn;
+   Eet_File_Node *pefn;
+   int hash;
+
+   /* figure hash bucket */
+   hash = _eet_hash_gen(name, ef->header->directory->size);
+
+   /* Does this node already exist? */
+   for (pefn = NULL, efn = ef->header->directory->nodes[hash];
+        efn;
+        pefn = efn, efn = efn->next)
+     {
+        /* if it matches */
+         if (eet_string_match(efn->name, name))
+           {
+              if (efn->data)
+                free(efn->data);
+
+              if (!pefn)
+                ef->header->directory->nodes[hash] = efn->next;
+              else
+                pefn->next = efn->next;
+
+              if (efn->free_name)
+                free(efn->name);
+
+              eet_file_node_mp_free(efn);
+              return EINA_TRUE;
+           }
+     }
+
+   return EINA_FALSE;
+}
+
 static Eina_Binbuf *
 read_binbuf_from_disk(Eet_File      *ef,
                       Eet_File_Node *efn)
@@ -78,16 +78,31 @@ static inline void _x86_cpuid(int op, int *a, int *b, int *c, int *d)
 #else
       "popl %%ebx       \n\t" /* restore the old %ebx */
 #endif
-      : "=a" (*a), "=r" (*b), "=c" (*c), "=d" (*d)
+      : "=a" (*a), "=r" (*b), "+c" (*c), "=d" (*d)
       : "a" (op)
       : "cc");
 }
 
+/* XCR0 tells whether the OS saves the extended register state */
+static inline unsigned int _x86_xgetbv(void)
+{
+   unsigned int a, d;
+
+   __asm__ volatile (
+      "xgetbv           \n\t"
+      : "=a" (a), "=d" (d)
+      : "c" (0));
+   return a;
+}
+
 static
 void _x86_simd(Eina_Cpu_Features *features)
 {
-   int a, b, c, d;
+   int a, b, c = 0, d;
+   int max;
 
+   _x86_cpuid(0, &max, &b, &c, &d);
+   c = 0;
    _x86_cpuid(1, &a, &b, &c, &d);
    /*
     * edx
@@ -102,6 +117,8 @@ void _x86_simd(Eina_Cpu_Features *features)
     * 9 = SSSE3
     * 19 = SSE4.1
     * 20 = SSE4.2
+    * 27 = OSXSAVE
+    * 28 = AVX
     */
    if ((d >> 23) & 1)
       *features |= EINA_CPU_MMX;
@@ -123,6 +140,20 @@ void _x86_simd(Eina_Cpu_Features *features)
 
    if ((c >> 20) & 1)
       *features |= EINA_CPU_SSE42;
+
+   /* AVX2 needs the OS to save the ymm registers (XCR0 bits 1 and 2) */
+   if ((max >= 7) && ((c >> 27) & 1) && ((c >> 28) & 1) &&
+       ((_x86_xgetbv() & 0x6) == 0x6))
+     {
+        /*
+         * leaf 7, subleaf 0, ebx
+         * 5 = AVX2
+         */
+        c = 0;
+        _x86_cpuid(7, &a, &b, &c, &d);
+        if ((b >> 5) & 1)
+           *features |= EINA_CPU_AVX2;
+     }
 }
 #endif
 
@@ -56,7 +56,8 @@ typedef enum _Eina_Cpu_Features
    EINA_CPU_SSSE3   = 0x00000080,
    EINA_CPU_SSE41   = 0x00000100,
    EINA_CPU_SSE42   = 0x00000200,
-   EINA_CPU_SVE     = 0x00000400
+   EINA_CPU_SVE     = 0x00000400,
+   EINA_CPU_AVX2    = 0x00000800 /**< @since 1.23 */
 } Eina_Cpu_Features;
 
 /**
@@ -24,8 +24,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
 #include "eina_config.h"
 #include "eina_private.h"
 #include "eina_rbtree.h"
@@ -63,8 +70,33 @@
 
 #define EINA_HASH_RBTREE_MASK       0xFFFF
 
+/* The flat table probes 16 control bytes at once. A control byte is either
+   empty, deleted, or the 7 lower bits of the hash of a full slot. */
+#define EINA_HASH_FLAT_GROUP        16
+#define EINA_HASH_FLAT_EMPTY        ((signed char)-128)
+#define EINA_HASH_FLAT_DELETED      ((signed char)-2)
+#define EINA_HASH_FLAT_H1(h)        ((h) >> 7)
+#define EINA_HASH_FLAT_H2(h)        ((signed char)((h) & 0x7F))
+/* at most 7/8 of the slots are used, counting deleted ones */
+#define EINA_HASH_FLAT_GROWTH(cap)  ((cap) - (cap) / 8)
+
+#if defined(__SSE2__)
+/* one bit per slot */
+# define EINA_HASH_FLAT_MASK_SHIFT  0
+# define EINA_HASH_FLAT_MASK_ALL    0xFFFFULL
+#elif defined(__ARM_NEON)
+/* one bit out of four per slot */
+# define EINA_HASH_FLAT_MASK_SHIFT  2
+# define EINA_HASH_FLAT_MASK_ALL    0x8888888888888888ULL
+#else
+# define EINA_HASH_FLAT_MASK_SHIFT  0
+# define EINA_HASH_FLAT_MASK_ALL    0xFFFFULL
+#endif
+
 typedef struct _Eina_Hash_Head         Eina_Hash_Head;
 typedef struct _Eina_Hash_Element      Eina_Hash_Element;
+typedef struct _Eina_Hash_Flat         Eina_Hash_Flat;
+typedef struct _Eina_Hash_Flat_Slot    Eina_Hash_Flat_Slot;
 typedef struct _Eina_Hash_Foreach_Data Eina_Hash_Foreach_Data;
 typedef struct _Eina_Iterator_Hash     Eina_Iterator_Hash;
 typedef struct _Eina_Hash_Each         Eina_Hash_Each;
@@ -84,9 +116,26 @@ struct _Eina_Hash
 
    int             buckets_power_size;
 
+   Eina_Hash_Flat *flat; /* set for hash created by eina_hash_flat_new() */
+
    EINA_MAGIC
 };
 
+struct _Eina_Hash_Flat
+{
+   Eina_Hash_Flat_Slot *slots;
+   signed char         *ctrl; /* mask + 1 + EINA_HASH_FLAT_GROUP bytes, the first group is mirrored at the end */
+   unsigned int         mask; /* number of slots - 1 */
+   unsigned int         growth_left; /* empty slots that can still be used before growing */
+};
+
+struct _Eina_Hash_Flat_Slot
+{
+   Eina_Hash_Tuple tuple;
+   int             hash;
+   Eina_Bool       own_key : 1;
+};
+
 struct _Eina_Hash_Head
 {
    EINA_RBTREE;
@@ -123,6 +172,7 @@ struct _Eina_Iterator_Hash
    Eina_Iterator                     *list;
    Eina_Hash_Head                    *hash_head;
    Eina_Hash_Element                 *hash_element;
+   Eina_Hash_Tuple                   *tuple;
    int                                bucket;
 
    int                                index;
@@ -203,6 +253,344 @@ _eina_hash_key_rbtree_cmp_node(const Eina_Hash_Element *left,
    return EINA_RBTREE_RIGHT;
 }
 
+static inline unsigned int
+_eina_hash_flat_ctz(uint64_t mask)
+{
+#ifdef __GNUC__
+   return __builtin_ctzll(mask);
+#else
+   unsigned int i = 0;
+
+   while (!(mask & 1))
+     {
+        mask >>= 1;
+        i++;
+     }
+   return i;
+#endif
+}
+
+static inline unsigned int
+_eina_hash_flat_last(uint64_t mask)
+{
+#ifdef __GNUC__
+   return 63 - __builtin_clzll(mask);
+#else
+   unsigned int i = 0;
+
+   while (mask >>= 1) i++;
+   return i;
+#endif
+}
+
+/* first and last slot of a non empty group mask */
+#define EINA_HASH_FLAT_MASK_IDX(Mask) \
+  (_eina_hash_flat_ctz(Mask) >> EINA_HASH_FLAT_MASK_SHIFT)
+#define EINA_HASH_FLAT_MASK_LAST(Mask) \
+  (_eina_hash_flat_last(Mask) >> EINA_HASH_FLAT_MASK_SHIFT)
+
+#ifdef __ARM_NEON
+static inline uint64_t
+_eina_hash_flat_neon_mask(uint8x16_t v)
+{
+   uint8x8_t n = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+
+   return vget_lane_u64(vreinterpret_u64_u8(n), 0) & EINA_HASH_FLAT_MASK_ALL;
+}
+#endif
+
+/* Slots of the group at ctrl whose control byte is h2 */
+static inline uint64_t
+_eina_hash_flat_match(const signed char *ctrl, signed char h2)
+{
+#if defined(__SSE2__)
+   __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+
+   return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+#elif defined(__ARM_NEON)
+   int8x16_t group = vld1q_s8(ctrl);
+
+   return _eina_hash_flat_neon_mask(vceqq_s8(group, vdupq_n_s8(h2)));
+#else
+   uint64_t r = 0;
+   int i;
+
+   for (i = 0; i < EINA_HASH_FLAT_GROUP; i++)
+     if (ctrl[i] == h2) r |= 1ULL << i;
+   return r;
+#endif
+}
+
+/* Slots of the group at ctrl that are empty or deleted */
+static inline uint64_t
+_eina_hash_flat_match_free(const signed char *ctrl)
+{
+#if defined(__SSE2__)
+   __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+
+   return (unsigned int)_mm_movemask_epi8(_mm_cmplt_epi8(group, _mm_set1_epi8(-1)));
+#elif defined(__ARM_NEON)
+   int8x16_t group = vld1q_s8(ctrl);
+
+   return _eina_hash_flat_neon_mask(vcltq_s8(group, vdupq_n_s8(-1)));
+#else
+   uint64_t r = 0;
+   int i;
+
+   for (i = 0; i < EINA_HASH_FLAT_GROUP; i++)
+     if (ctrl[i] < -1) r |= 1ULL << i;
+   return r;
+#endif
+}
+
+static inline uint64_t
+_eina_hash_flat_match_empty(const signed char *ctrl)
+{
+   return _eina_hash_flat_match(ctrl, EINA_HASH_FLAT_EMPTY);
+}
+
+/* Hash functions provided to eina_hash are not always good in all bits,
+   so mix them before splitting them in position and control byte. */
+static inline unsigned int
+_eina_hash_flat_mix(int key_hash)
+{
+   unsigned int h = (unsigned int)key_hash;
+
+   h ^= h >> 16;
+   h *= 0x45d9f3b;
+   h ^= h >> 16;
+   return h;
+}
+
+static inline void
+_eina_hash_flat_ctrl_set(Eina_Hash_Flat *flat, unsigned int idx, signed char c)
+{
+   flat->ctrl[idx] = c;
+   if (idx < EINA_HASH_FLAT_GROUP - 1)
+     flat->ctrl[flat->mask + 1 + idx] = c;
+}
+
+static unsigned int
+_eina_hash_flat_free_find(const Eina_Hash_Flat *flat, unsigned int h)
+{
+   unsigned int pos = EINA_HASH_FLAT_H1(h) & flat->mask;
+   unsigned int step = 0;
+   uint64_t m;
+
+   while (!(m = _eina_hash_flat_match_free(flat->ctrl + pos)))
+     {
+        step += EINA_HASH_FLAT_GROUP;
+        pos = (pos + step) & flat->mask;
+     }
+
+   return (pos + EINA_HASH_FLAT_MASK_IDX(m)) & flat->mask;
+}
+
+static Eina_Bool
+_eina_hash_flat_resize(Eina_Hash *hash, unsigned int capacity)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   Eina_Hash_Flat_Slot *slots = flat->slots;
+   signed char *ctrl = flat->ctrl;
+   unsigned int old_capacity = ctrl ? flat->mask + 1 : 0;
+   unsigned int i;
+
+   flat->slots = malloc(capacity * sizeof (Eina_Hash_Flat_Slot) +
+                        capacity + EINA_HASH_FLAT_GROUP);
+   if (!flat->slots)
+     {
+        flat->slots = slots;
+        return EINA_FALSE;
+     }
+   flat->ctrl = (signed char *)(flat->slots + capacity);
+   memset(flat->ctrl, EINA_HASH_FLAT_EMPTY, capacity + EINA_HASH_FLAT_GROUP);
+   flat->mask = capacity - 1;
+   flat->growth_left = EINA_HASH_FLAT_GROWTH(capacity) - hash->population;
+
+   for (i = 0; i < old_capacity; i++)
+     {
+        unsigned int h, idx;
+
+        if (ctrl[i] < 0) continue;
+
+        h = _eina_hash_flat_mix(slots[i].hash);
+        idx = _eina_hash_flat_free_find(flat, h);
+        _eina_hash_flat_ctrl_set(flat, idx, EINA_HASH_FLAT_H2(h));
+        flat->slots[idx] = slots[i];
+     }
+
+   free(slots);
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eina_hash_flat_add(Eina_Hash *hash,
+                    const void *key, int key_length, int alloc_length,
+                    int key_hash,
+                    const void *data)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   Eina_Hash_Flat_Slot *slot;
+   unsigned int h = _eina_hash_flat_mix(key_hash);
+   unsigned int idx;
+   void *copy = NULL;
+
+   if (alloc_length > 0)
+     {
+        copy = malloc(alloc_length);
+        if (!copy) return EINA_FALSE;
+        memcpy(copy, key, alloc_length);
+     }
+
+   if (!flat->ctrl &&
+       !_eina_hash_flat_resize(hash, EINA_HASH_FLAT_GROUP))
+     goto on_error;
+
+   idx = _eina_hash_flat_free_find(flat, h);
+   if (!flat->growth_left && flat->ctrl[idx] == EINA_HASH_FLAT_EMPTY)
+     {
+        unsigned int capacity = flat->mask + 1;
+
+        /* only grow if the table isn't just full of deleted slots */
+        if ((unsigned int)hash->population >= EINA_HASH_FLAT_GROWTH(capacity) / 2)
+          capacity *= 2;
+        if (!_eina_hash_flat_resize(hash, capacity))
+          goto on_error;
+        idx = _eina_hash_flat_free_find(flat, h);
+     }
+
+   if (flat->ctrl[idx] == EINA_HASH_FLAT_EMPTY)
+     flat->growth_left--;
+   _eina_hash_flat_ctrl_set(flat, idx, EINA_HASH_FLAT_H2(h));
+
+   slot = flat->slots + idx;
+   slot->tuple.key = copy ? copy : key;
+   slot->tuple.key_length = key_length;
+   slot->tuple.data = (void *)data;
+   slot->hash = key_hash;
+   slot->own_key = !!copy;
+
+   hash->population++;
+   return EINA_TRUE;
+
+on_error:
+   free(copy);
+   return EINA_FALSE;
+}
+
+static Eina_Hash_Tuple *
+_eina_hash_flat_find(const Eina_Hash *hash,
+                     const Eina_Hash_Tuple *tuple,
+                     int key_hash)
+{
+   const Eina_Hash_Flat *flat = hash->flat;
+   unsigned int h, pos, step = 0;
+
+   if (!flat->ctrl) return NULL;
+
+   h = _eina_hash_flat_mix(key_hash);
+   pos = EINA_HASH_FLAT_H1(h) & flat->mask;
+   for (;;)
+     {
+        const signed char *group = flat->ctrl + pos;
+        uint64_t m;
+
+        for (m = _eina_hash_flat_match(group, EINA_HASH_FLAT_H2(h)); m; m &= m - 1)
+          {
+             Eina_Hash_Flat_Slot *slot;
+
+             slot = flat->slots + ((pos + EINA_HASH_FLAT_MASK_IDX(m)) & flat->mask);
+             if (slot->hash != key_hash) continue;
+             if (hash->key_cmp_cb(slot->tuple.key, slot->tuple.key_length,
+                                  tuple->key, tuple->key_length))
+               continue;
+             if (tuple->data && tuple->data != slot->tuple.data) continue;
+
+             return &slot->tuple;
+          }
+
+        /* an empty slot ends the probe sequence of any key */
+        if (_eina_hash_flat_match_empty(group)) return NULL;
+
+        step += EINA_HASH_FLAT_GROUP;
+        pos = (pos + step) & flat->mask;
+     }
+}
+
+static Eina_Hash_Tuple *
+_eina_hash_flat_find_by_data(const Eina_Hash *hash, const void *data)
+{
+   const Eina_Hash_Flat *flat = hash->flat;
+   unsigned int i;
+
+   if (!flat->ctrl) return NULL;
+
+   for (i = 0; i <= flat->mask; i++)
+     if (flat->ctrl[i] >= 0 && flat->slots[i].tuple.data == data)
+       return &flat->slots[i].tuple;
+
+   return NULL;
+}
+
+static void
+_eina_hash_flat_slot_free(Eina_Hash *hash, Eina_Hash_Flat_Slot *slot)
+{
+   if (hash->data_free_cb)
+     hash->data_free_cb(slot->tuple.data);
+   if (slot->own_key)
+     free((void *)slot->tuple.key);
+}
+
+static void
+_eina_hash_flat_free(Eina_Hash *hash)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   unsigned int i;
+
+   if (!flat->ctrl) return;
+
+   for (i = 0; i <= flat->mask; i++)
+     if (flat->ctrl[i] >= 0)
+       _eina_hash_flat_slot_free(hash, flat->slots + i);
+
+   free(flat->slots);
+   flat->slots = NULL;
+   flat->ctrl = NULL;
+   flat->mask = 0;
+   flat->growth_left = 0;
+   hash->population = 0;
+}
+
+static void
+_eina_hash_flat_del(Eina_Hash *hash, Eina_Hash_Tuple *tuple)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   Eina_Hash_Flat_Slot *slot = (Eina_Hash_Flat_Slot *)tuple;
+   unsigned int idx = slot - flat->slots;
+   unsigned int before = (idx - EINA_HASH_FLAT_GROUP) & flat->mask;
+   uint64_t empty_before, empty_after;
+
+   /* If no window of a group that covers this slot could have been full,
+      no probe sequence went past it and it can be made empty again. */
+   empty_after = _eina_hash_flat_match_empty(flat->ctrl + idx);
+   empty_before = _eina_hash_flat_match_empty(flat->ctrl + before);
+   if (empty_before && empty_after &&
+       (EINA_HASH_FLAT_MASK_IDX(empty_after) +
+        EINA_HASH_FLAT_GROUP - 1 - EINA_HASH_FLAT_MASK_LAST(empty_before)) < EINA_HASH_FLAT_GROUP)
+     {
+        _eina_hash_flat_ctrl_set(flat, idx, EINA_HASH_FLAT_EMPTY);
+        flat->growth_left++;
+     }
+   else
+     _eina_hash_flat_ctrl_set(flat, idx, EINA_HASH_FLAT_DELETED);
+
+   _eina_hash_flat_slot_free(hash, slot);
+
+   hash->population--;
+   if (hash->population == 0)
+     _eina_hash_flat_free(hash);
+}
+
 static inline Eina_Bool
 eina_hash_add_alloc_by_hash(Eina_Hash *hash,
                             const void *key, int key_length, int alloc_length,
@@ -218,6 +606,10 @@ eina_hash_add_alloc_by_hash(Eina_Hash *hash,
    EINA_SAFETY_ON_NULL_RETURN_VAL(data, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
+   if (hash->flat)
+     return _eina_hash_flat_add(hash, key, key_length, alloc_length,
+                                key_hash, data);
+
    /* Apply eina mask to hash. */
    hash_num = key_hash & hash->mask;
    key_hash >>= hash->buckets_power_size;
@@ -314,7 +706,7 @@ _eina_hash_rbtree_each(EINA_UNUSED const Eina_Rbtree *container,
    return found;
 }
 
-static inline Eina_Hash_Element *
+static inline Eina_Hash_Tuple *
 _eina_hash_find_by_hash(const Eina_Hash *hash,
                         Eina_Hash_Tuple *tuple,
                         int key_hash,
@@ -324,6 +716,10 @@ _eina_hash_find_by_hash(const Eina_Hash *hash,
    int rb_hash = (key_hash >> hash->buckets_power_size)
      & EINA_HASH_RBTREE_MASK;
 
+   *hash_head = NULL;
+   if (hash->flat)
+     return _eina_hash_flat_find(hash, tuple, key_hash);
+
    key_hash &= hash->mask;
 
    if (!hash->buckets)
@@ -344,11 +740,13 @@ _eina_hash_find_by_hash(const Eina_Hash *hash,
                                EINA_RBTREE_CMP_KEY_CB(
                                  _eina_hash_key_rbtree_cmp_key_data),
                                (const void *)hash->key_cmp_cb);
+   if (!hash_element)
+     return NULL;
 
-   return hash_element;
+   return &hash_element->tuple;
 }
 
-static inline Eina_Hash_Element *
+static inline Eina_Hash_Tuple *
 _eina_hash_find_by_data(const Eina_Hash *hash,
                         const void *data,
                         int *key_hash,
@@ -358,6 +756,11 @@ _eina_hash_find_by_data(const Eina_Hash *hash,
    Eina_Iterator *it;
    int hash_num;
 
+   *hash_head = NULL;
+   *key_hash = 0;
+   if (hash->flat)
+     return _eina_hash_flat_find_by_data(hash, data);
+
    if (!hash->buckets)
      return NULL;
 
@@ -377,7 +780,7 @@ _eina_hash_find_by_data(const Eina_Hash *hash,
           {
              *key_hash = hash_num;
              *hash_head = each.hash_head;
-             return (Eina_Hash_Element *)each.hash_element;
+             return (Eina_Hash_Tuple *)&each.hash_element->tuple;
           }
      }
 
@@ -402,10 +805,20 @@ _eina_hash_head_free(Eina_Hash_Head *hash_head, Eina_Hash *hash)
 
 static Eina_Bool
 _eina_hash_del_by_hash_el(Eina_Hash *hash,
-                          Eina_Hash_Element *hash_element,
+                          Eina_Hash_Tuple *hash_tuple,
                           Eina_Hash_Head *hash_head,
                           int key_hash)
 {
+   Eina_Hash_Element *hash_element;
+
+   if (hash->flat)
+     {
+        _eina_hash_flat_del(hash, hash_tuple);
+        return EINA_TRUE;
+     }
+
+   hash_element = (Eina_Hash_Element *)
+     ((char *)hash_tuple - offsetof(Eina_Hash_Element, tuple));
    hash_head->head = eina_rbtree_inline_remove(hash_head->head, EINA_RBTREE_GET(
                                                  hash_element), EINA_RBTREE_CMP_NODE_CB(
                                                  _eina_hash_key_rbtree_cmp_node),
@@ -441,7 +854,7 @@ _eina_hash_del_by_key_hash(Eina_Hash *hash,
                            int key_hash,
                            const void *data)
 {
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    Eina_Hash_Head *hash_head;
    Eina_Hash_Tuple tuple;
 
@@ -449,18 +862,18 @@ _eina_hash_del_by_key_hash(Eina_Hash *hash,
    EINA_SAFETY_ON_NULL_RETURN_VAL(key, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
-   if (!hash->buckets)
+   if (!hash->population)
      return EINA_FALSE;
 
    tuple.key = (void *)key;
    tuple.key_length = key_length;
    tuple.data = (void *)data;
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
-   if (!hash_element)
+   hash_tuple = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+   if (!hash_tuple)
      return EINA_FALSE;
 
-   return _eina_hash_del_by_hash_el(hash, hash_element, hash_head, key_hash);
+   return _eina_hash_del_by_hash_el(hash, hash_tuple, hash_head, key_hash);
 }
 
 static void
@@ -479,7 +892,7 @@ _eina_hash_del_by_key(Eina_Hash *hash, const void *key, const void *data)
    EINA_SAFETY_ON_NULL_RETURN_VAL(key, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
-   if (!hash->buckets)
+   if (!hash->population)
      return EINA_FALSE;
 
    _eina_hash_compute(hash, key, &key_length, &key_hash);
@@ -578,46 +991,72 @@ _eina_foreach_cb(const Eina_Hash *hash,
 static void *
 _eina_hash_iterator_data_get_content(Eina_Iterator_Hash *it)
 {
-   Eina_Hash_Element *stuff;
+   Eina_Hash_Tuple *stuff;
 
    EINA_MAGIC_CHECK_HASH_ITERATOR(it, NULL);
 
-   stuff = it->hash_element;
+   stuff = it->tuple;
 
    if (!stuff)
      return NULL;
 
-   return stuff->tuple.data;
+   return stuff->data;
 }
 
 static void *
 _eina_hash_iterator_key_get_content(Eina_Iterator_Hash *it)
 {
-   Eina_Hash_Element *stuff;
+   Eina_Hash_Tuple *stuff;
 
    EINA_MAGIC_CHECK_HASH_ITERATOR(it, NULL);
 
-   stuff = it->hash_element;
+   stuff = it->tuple;
 
    if (!stuff)
      return NULL;
 
-   return (void *)stuff->tuple.key;
+   return (void *)stuff->key;
 }
 
 static Eina_Hash_Tuple *
 _eina_hash_iterator_tuple_get_content(Eina_Iterator_Hash *it)
 {
-   Eina_Hash_Element *stuff;
-
    EINA_MAGIC_CHECK_HASH_ITERATOR(it, NULL);
 
-   stuff = it->hash_element;
+   return it->tuple;
+}
 
-   if (!stuff)
-     return NULL;
+static Eina_Bool
+_eina_hash_flat_iterator_next(Eina_Iterator_Hash *it, void **data)
+{
+   const Eina_Hash_Flat *flat = it->hash->flat;
+   unsigned int idx = it->bucket;
+
+   if (!flat->ctrl)
+     return EINA_FALSE;
+
+   /* walk the control bytes a group at a time, groups being aligned here */
+   while (idx <= flat->mask)
+     {
+        unsigned int group = idx & ~(EINA_HASH_FLAT_GROUP - 1);
+        uint64_t m;
 
-   return &stuff->tuple;
+        m = ~_eina_hash_flat_match_free(flat->ctrl + group) & EINA_HASH_FLAT_MASK_ALL;
+        m >>= (idx - group) << EINA_HASH_FLAT_MASK_SHIFT;
+        if (m)
+          {
+             idx += EINA_HASH_FLAT_MASK_IDX(m);
+             it->tuple = &flat->slots[idx].tuple;
+             it->bucket = idx + 1;
+             it->index++;
+             *data = it->get_content(it);
+             return EINA_TRUE;
+          }
+        idx = group + EINA_HASH_FLAT_GROUP;
+     }
+
+   it->bucket = idx;
+   return EINA_FALSE;
 }
 
 static Eina_Bool
@@ -626,6 +1065,9 @@ _eina_hash_iterator_next(Eina_Iterator_Hash *it, void **data)
    Eina_Bool ok;
    int bucket;
 
+   if (it->hash->flat)
+     return _eina_hash_flat_iterator_next(it, data);
+
    if (!(it->index < it->hash->population))
      return EINA_FALSE;
 
@@ -691,7 +1133,10 @@ _eina_hash_iterator_next(Eina_Iterator_Hash *it, void **data)
    it->bucket = bucket;
 
    if (ok)
-     *data = it->get_content(it);
+     {
+        it->tuple = &it->hash_element->tuple;
+        *data = it->get_content(it);
+     }
 
    return ok;
 }
@@ -764,6 +1209,7 @@ eina_hash_new(Eina_Key_Length key_length_cb,
    new->data_free_cb = data_free_cb;
    new->buckets = NULL;
    new->population = 0;
+   new->flat = NULL;
 
    new->size = 1 << buckets_power_size;
    new->mask = new->size - 1;
@@ -775,6 +1221,42 @@ on_error:
    return NULL;
 }
 
+EAPI Eina_Hash *
+eina_hash_flat_new(Eina_Key_Length key_length_cb,
+                   Eina_Key_Cmp key_cmp_cb,
+                   Eina_Key_Hash key_hash_cb,
+                   Eina_Free_Cb data_free_cb)
+{
+   Eina_Hash *new;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(key_cmp_cb, NULL);
+   EINA_SAFETY_ON_NULL_RETURN_VAL(key_hash_cb, NULL);
+
+   /* the table itself is only allocated on first add */
+   new = calloc(1, sizeof (Eina_Hash) + sizeof (Eina_Hash_Flat));
+   if (!new)
+     return NULL;
+
+   EINA_MAGIC_SET(new, EINA_MAGIC_HASH);
+
+   new->key_length_cb = key_length_cb;
+   new->key_cmp_cb = key_cmp_cb;
+   new->key_hash_cb = key_hash_cb;
+   new->data_free_cb = data_free_cb;
+   new->flat = (Eina_Hash_Flat *)(new + 1);
+
+   return new;
+}
+
+EAPI Eina_Hash *
+eina_hash_string_flat_new(Eina_Free_Cb data_free_cb)
+{
+   return eina_hash_flat_new(EINA_KEY_LENGTH(_eina_string_key_length),
+                             EINA_KEY_CMP(_eina_string_key_cmp),
+                             EINA_KEY_HASH(eina_hash_superfast),
+                             data_free_cb);
+}
+
 EAPI Eina_Hash *
 eina_hash_string_djb2_new(Eina_Free_Cb data_free_cb)
 {
@@ -872,7 +1354,9 @@ eina_hash_free(Eina_Hash *hash)
 
    EINA_MAGIC_CHECK_HASH(hash);
 
-   if (hash->buckets)
+   if (hash->flat)
+     _eina_hash_flat_free(hash);
+   else if (hash->buckets)
      {
         for (i = 0; i < hash->size; i++)
           eina_rbtree_delete(hash->buckets[i], EINA_RBTREE_FREE_CB(_eina_hash_head_free), hash);
@@ -890,7 +1374,9 @@ eina_hash_free_buckets(Eina_Hash *hash)
 
    EINA_MAGIC_CHECK_HASH(hash);
 
-   if (hash->buckets)
+   if (hash->flat)
+     _eina_hash_flat_free(hash);
+   else if (hash->buckets)
      {
         for (i = 0; i < hash->size; i++)
           eina_rbtree_delete(hash->buckets[i],
@@ -984,7 +1470,7 @@ eina_hash_del_by_key(Eina_Hash *hash, const void *key)
 EAPI Eina_Bool
 eina_hash_del_by_data(Eina_Hash *hash, const void *data)
 {
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    Eina_Hash_Head *hash_head;
    int key_hash;
 
@@ -992,14 +1478,14 @@ eina_hash_del_by_data(Eina_Hash *hash, const void *data)
    EINA_SAFETY_ON_NULL_RETURN_VAL(data, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
-   hash_element = _eina_hash_find_by_data(hash, data, &key_hash, &hash_head);
-   if (!hash_element)
+   hash_tuple = _eina_hash_find_by_data(hash, data, &key_hash, &hash_head);
+   if (!hash_tuple)
      goto error;
 
-   if (hash_element->tuple.data != data)
+   if (hash_tuple->data != data)
      goto error;
 
-   return _eina_hash_del_by_hash_el(hash, hash_element, hash_head, key_hash);
+   return _eina_hash_del_by_hash_el(hash, hash_tuple, hash_head, key_hash);
 
 error:
    return EINA_FALSE;
@@ -1044,7 +1530,7 @@ eina_hash_find_by_hash(const Eina_Hash *hash,
                        int key_hash)
 {
    Eina_Hash_Head *hash_head;
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    Eina_Hash_Tuple tuple;
 
    if (!hash)
@@ -1057,9 +1543,9 @@ eina_hash_find_by_hash(const Eina_Hash *hash,
    tuple.key_length = key_length;
    tuple.data = NULL;
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
-   if (hash_element)
-     return hash_element->tuple.data;
+   hash_tuple = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+   if (hash_tuple)
+     return hash_tuple->data;
 
    return NULL;
 }
@@ -1090,7 +1576,7 @@ eina_hash_modify_by_hash(Eina_Hash *hash,
                          const void *data)
 {
    Eina_Hash_Head *hash_head;
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    void *old_data = NULL;
    Eina_Hash_Tuple tuple;
 
@@ -1103,11 +1589,11 @@ eina_hash_modify_by_hash(Eina_Hash *hash,
    tuple.key_length = key_length;
    tuple.data = NULL;
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
-   if (hash_element)
+   hash_tuple = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+   if (hash_tuple)
      {
-        old_data = hash_element->tuple.data;
-        hash_element->tuple.data = (void *)data;
+        old_data = hash_tuple->data;
+        hash_tuple->data = (void *)data;
      }
 
    return old_data;
@@ -1118,7 +1604,7 @@ eina_hash_set(Eina_Hash *hash, const void *key, const void *data)
 {
    Eina_Hash_Tuple tuple;
    Eina_Hash_Head *hash_head;
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    int key_length;
    int key_hash;
 
@@ -1133,22 +1619,22 @@ eina_hash_set(Eina_Hash *hash, const void *key, const void *data)
    tuple.key_length = key_length;
    tuple.data = NULL;
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
-   if (hash_element)
+   hash_tuple = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+   if (hash_tuple)
      {
         void *old_data = NULL;
 
-        old_data = hash_element->tuple.data;
+        old_data = hash_tuple->data;
 
         if (data)
           {
-             hash_element->tuple.data = (void *)data;
+             hash_tuple->data = (void *)data;
           }
         else
           {
              Eina_Free_Cb cb = hash->data_free_cb;
              hash->data_free_cb = NULL;
-             _eina_hash_del_by_hash_el(hash, hash_element, hash_head, key_hash);
+             _eina_hash_del_by_hash_el(hash, hash_tuple, hash_head, key_hash);
              hash->data_free_cb = cb;
           }
 
@@ -1379,7 +1865,7 @@ eina_hash_list_append(Eina_Hash *hash, const void *key, const void *data)
 {
    Eina_Hash_Tuple tuple;
    Eina_Hash_Head *hash_head;
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    int key_length;
    int key_hash;
 
@@ -1395,9 +1881,9 @@ eina_hash_list_append(Eina_Hash *hash, const void *key, const void *data)
    tuple.key_length = key_length;
    tuple.data = NULL;
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
-   if (hash_element)
-      hash_element->tuple.data = eina_list_append(hash_element->tuple.data, data);
+   hash_tuple = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+   if (hash_tuple)
+      hash_tuple->data = eina_list_append(hash_tuple->data, data);
    else
      eina_hash_add_alloc_by_hash(hash,
                             key,
@@ -1412,7 +1898,7 @@ eina_hash_list_prepend(Eina_Hash *hash, const void *key, const void *data)
 {
    Eina_Hash_Tuple tuple;
    Eina_Hash_Head *hash_head;
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    int key_length;
    int key_hash;
 
@@ -1428,9 +1914,9 @@ eina_hash_list_prepend(Eina_Hash *hash, const void *key, const void *data)
    tuple.key_length = key_length;
    tuple.data = NULL;
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
-   if (hash_element)
-      hash_element->tuple.data = eina_list_prepend(hash_element->tuple.data, data);
+   hash_tuple = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+   if (hash_tuple)
+      hash_tuple->data = eina_list_prepend(hash_tuple->data, data);
    else
      eina_hash_add_alloc_by_hash(hash,
                             key,
@@ -1445,7 +1931,7 @@ eina_hash_list_remove(Eina_Hash *hash, const void *key, const void *data)
 {
    Eina_Hash_Tuple tuple;
    Eina_Hash_Head *hash_head;
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Tuple *hash_tuple;
    int key_length;
    int key_hash;
 
@@ -1461,9 +1947,9 @@ eina_hash_list_remove(Eina_Hash *hash, const void *key, const void *data)
    tuple.key_length = key_length;
    tuple.data = NULL;
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
-   if (!hash_element) return;
-   hash_element->tuple.data = eina_list_remove(hash_element->tuple.data, data);
-   if (!hash_element->tuple.data)
-     _eina_hash_del_by_hash_el(hash, hash_element, hash_head, key_hash);
+   hash_tuple = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+   if (!hash_tuple) return;
+   hash_tuple->data = eina_list_remove(hash_tuple->data, data);
+   if (!hash_tuple->data)
+     _eina_hash_del_by_hash_el(hash, hash_tuple, hash_head, key_hash);
 }
@@ -532,6 +532,54 @@ EAPI Eina_Hash *eina_hash_pointer_new(Eina_Free_Cb data_free_cb);
  */
 EAPI Eina_Hash *eina_hash_stringshared_new(Eina_Free_Cb data_free_cb);
 
+/**
+ * @brief Creates a new open addressing hash table.
+ *
+ * @param[in] key_length_cb The function called when getting the size of the key.
+ * @param[in] key_cmp_cb The function called when comparing the keys.
+ * @param[in] key_hash_cb The function called when getting the values.
+ * @param[in] data_free_cb The function called on each value when the hash table is
+ * freed, or when an item is deleted from it. @c NULL can be passed as a
+ * callback.
+ * @return The new hash table, or @c NULL on failure.
+ *
+ * This function creates a new hash table with the same callbacks and the
+ * same behavior as eina_hash_new(), but instead of fixed buckets holding
+ * trees of entries, all entries are stored in a single array that grows
+ * with the population. Lookups compare the hash of many entries at once
+ * and touch much less memory, which makes this kind of hash faster for
+ * large tables, at the cost of having to rehash everything when growing.
+ *
+ * The full hash returned by @p key_hash_cb is used, so the functions
+ * taking a precomputed hash, like eina_hash_find_by_hash(), must be given
+ * the same value. Adding or removing entries invalidates the
+ * #Eina_Hash_Tuple pointers returned by iterators, but not the keys.
+ *
+ * If @p key_cmp_cb or @p key_hash_cb are @c NULL, @c NULL is returned.
+ *
+ * @see eina_hash_new()
+ * @since 1.23
+ */
+EAPI Eina_Hash *eina_hash_flat_new(Eina_Key_Length key_length_cb,
+                                   Eina_Key_Cmp    key_cmp_cb,
+                                   Eina_Key_Hash   key_hash_cb,
+                                   Eina_Free_Cb    data_free_cb) EINA_MALLOC EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(2, 3);
+
+/**
+ * @brief Creates a new open addressing hash table for use with strings.
+ *
+ * @param[in] data_free_cb The function called on each value when the hash table
+ * is freed, or when an item is deleted from it. @c NULL can be passed as
+ * callback.
+ * @return The new hash table, or @c NULL on failure.
+ *
+ * This is the same as eina_hash_string_superfast_new(), but using a hash
+ * table created with eina_hash_flat_new().
+ *
+ * @since 1.23
+ */
+EAPI Eina_Hash *eina_hash_string_flat_new(Eina_Free_Cb data_free_cb);
+
 /**
  * @brief Adds an entry to the given hash table.
  *
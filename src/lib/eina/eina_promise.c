@@ -6,6 +6,7 @@
 #include "eina_lock.h"
 #include "eina_promise.h"
 #include "eina_mempool.h"
+#include "eina_inlist.h"
 #include "eina_promise_private.h"
 #include "eina_internal.h"
 
@@ -107,6 +108,7 @@ struct _Eina_Promise {
 };
 
 struct _Eina_Future {
+   EINA_INLIST; /* in _pending_futures while scheduled */
    Eina_Promise *promise;
    Eina_Future *next;
    Eina_Future *prev;
@@ -119,7 +121,7 @@ struct _Eina_Future {
 static Eina_Mempool *_promise_mp = NULL;
 static Eina_Mempool *_future_mp = NULL;
 static Eina_Lock _pending_futures_lock;
-static Eina_List *_pending_futures = NULL;
+static Eina_Inlist *_pending_futures = NULL;
 static int _promise_log_dom = -1;
 
 static void _eina_promise_cancel(Eina_Promise *p);
@@ -428,7 +430,7 @@ _scheduled_entry_cb(Eina_Future *f, Eina_Value value)
    Eina_Future_Scheduler *scheduler = f->scheduled_entry->scheduler;
 
    eina_lock_take(&_pending_futures_lock);
-   _pending_futures = eina_list_remove(_pending_futures, f);
+   _pending_futures = eina_inlist_remove(_pending_futures, EINA_INLIST_GET(f));
    eina_lock_release(&_pending_futures_lock);
    f->scheduled_entry = NULL;
    _eina_future_dispatch(scheduler, f, value);
@@ -459,7 +461,7 @@ _eina_future_cancel(Eina_Future *f, int err)
         eina_future_schedule_entry_recall(f->scheduled_entry);
         f->scheduled_entry = NULL;
         eina_lock_take(&_pending_futures_lock);
-        _pending_futures = eina_list_remove(_pending_futures, f);
+        _pending_futures = eina_inlist_remove(_pending_futures, EINA_INLIST_GET(f));
         eina_lock_release(&_pending_futures_lock);
      }
 
@@ -502,7 +504,7 @@ _eina_future_schedule(Eina_Promise *p,
    EINA_SAFETY_ON_NULL_GOTO(f->scheduled_entry, err);
    assert(f->scheduled_entry->scheduler != NULL);
    eina_lock_take(&_pending_futures_lock);
-   _pending_futures = eina_list_append(_pending_futures, f);
+   _pending_futures = eina_inlist_append(_pending_futures, EINA_INLIST_GET(f));
    eina_lock_release(&_pending_futures_lock);
    DBG("The promise %p schedule the future %p with cb: %p and data: %p",
        p, f, f->cb, f->data);
@@ -575,18 +577,19 @@ __eina_promise_cancel_all(void)
 {
    eina_lock_take(&_pending_futures_lock);
    while (_pending_futures)
-     _eina_future_cancel(_pending_futures->data, ECANCELED);
+     _eina_future_cancel(EINA_INLIST_CONTAINER_GET(_pending_futures, Eina_Future),
+                         ECANCELED);
    eina_lock_release(&_pending_futures_lock);
 }
 
 EAPI void
 __eina_promise_cancel_data(void *data)
 {
-   Eina_List *del = NULL, *l;
+   Eina_List *del = NULL;
    Eina_Future *f;
 
    eina_lock_take(&_pending_futures_lock);
-   EINA_LIST_FOREACH(_pending_futures, l, f)
+   EINA_INLIST_FOREACH(_pending_futures, f)
      {
         if (f->data == data)
           {
@@ -68,6 +68,7 @@
 #include "eina_hash.h"
 #include "eina_rbtree.h"
 #include "eina_lock.h"
+#include "eina_log.h"
 
 /* undefs EINA_ARG_NONULL() so NULL checks are not compiled out! */
 #include "eina_safety_checks.h"
@@ -94,6 +95,26 @@ extern int _eina_share_stringshare_log_dom;
 #define EINA_SHARE_COMMON_BUCKET_IDX(h) ((h >> 8) & EINA_SHARE_COMMON_MASK)
 #define EINA_SHARE_COMMON_NODE_HASH(h) (h & EINA_SHARE_COMMON_MASK)
 
+/* buckets are spread over independently locked shards */
+#define EINA_SHARE_COMMON_SHARDS 16
+#define EINA_SHARE_COMMON_SHARD_IDX(h) (EINA_SHARE_COMMON_BUCKET_IDX(h) & (EINA_SHARE_COMMON_SHARDS - 1))
+
+#ifdef __ATOMIC_RELAXED
+/* with atomic references, each thread keeps a small cache of the shared
+ * strings it added recently, holding one reference on each of them, so
+ * adding them again does not need to take any lock */
+# define EINA_SHARE_COMMON_CACHE 1
+# define EINA_SHARE_COMMON_CACHE_SIZE 64
+# define EINA_SHARE_COMMON_CACHE_IDX(h) ((h >> 16) & (EINA_SHARE_COMMON_CACHE_SIZE - 1))
+/* cache hits are accounted in the share only every so many hits */
+# define EINA_SHARE_COMMON_CACHE_HITS_FLUSH 256
+# define EINA_SHARE_COMMON_REF_INC(n) __atomic_add_fetch(&((n)->references), 1, __ATOMIC_RELAXED)
+# define EINA_SHARE_COMMON_REF_DEC(n) __atomic_sub_fetch(&((n)->references), 1, __ATOMIC_ACQ_REL)
+#else
+# define EINA_SHARE_COMMON_REF_INC(n) (++((n)->references))
+# define EINA_SHARE_COMMON_REF_DEC(n) (--((n)->references))
+#endif
+
 static const char EINA_MAGIC_SHARE_STR[] = "Eina Share";
 static const char EINA_MAGIC_SHARE_HEAD_STR[] = "Eina Share Head";
 
@@ -128,6 +149,7 @@ struct _Eina_Share_Common_Population
 #endif
 
 typedef struct _Eina_Share_Common Eina_Share_Common;
+typedef struct _Eina_Share_Common_Shard Eina_Share_Common_Shard;
 typedef struct _Eina_Share_Common_Node Eina_Share_Common_Node;
 typedef struct _Eina_Share_Common_Head Eina_Share_Common_Head;
 
@@ -142,9 +164,19 @@ struct _Eina_Share
 #endif
 };
 
+struct _Eina_Share_Common_Shard
+{
+   Eina_Spinlock lock;
+   unsigned int strings; /* live nodes in the buckets of this shard */
+   unsigned long long lookups;
+   unsigned long long contended;
+};
+
 struct _Eina_Share_Common
 {
    Eina_Share_Common_Head *buckets[EINA_SHARE_COMMON_BUCKETS];
+   Eina_Share_Common_Shard shards[EINA_SHARE_COMMON_SHARDS];
+   unsigned long long cache_hits;
 
    EINA_MAGIC
 };
@@ -177,8 +209,33 @@ struct _Eina_Share_Common_Head
 
 Eina_Bool _share_common_threads_activated = EINA_FALSE;
 
+/* only protects population statistics, the table is locked per shard */
 static Eina_Spinlock _mutex_big;
 
+#ifdef EINA_SHARE_COMMON_CACHE
+typedef struct _Eina_Share_Common_Cache Eina_Share_Common_Cache;
+typedef struct _Eina_Share_Common_Cache_Entry Eina_Share_Common_Cache_Entry;
+
+struct _Eina_Share_Common_Cache_Entry
+{
+   Eina_Share *share;
+   Eina_Share_Common_Node *node;
+   int hash;
+   unsigned int hits;
+};
+
+struct _Eina_Share_Common_Cache
+{
+   Eina_Share_Common_Cache_Entry entries[EINA_SHARE_COMMON_CACHE_SIZE];
+   unsigned int generation;
+};
+
+static Eina_TLS _eina_share_common_cache_key;
+/* bumped on every shutdown, caches from an older generation point to
+ * strings that were already freed along with their share */
+static unsigned int _eina_share_common_generation = 1;
+#endif
+
 #ifdef EINA_STRINGSHARE_USAGE
 
 static void
@@ -336,6 +393,38 @@ static void _eina_share_common_population_head_del(
 }
 #endif
 
+static Eina_Share_Common_Shard *
+_eina_share_common_shard_take(Eina_Share *share, int hash)
+{
+   Eina_Share_Common_Shard *shard;
+
+   shard = share->share->shards + EINA_SHARE_COMMON_SHARD_IDX(hash);
+   if (eina_spinlock_take_try(&shard->lock) != EINA_LOCK_SUCCEED)
+     {
+        eina_spinlock_take(&shard->lock);
+        shard->contended++;
+     }
+   return shard;
+}
+
+static void
+_eina_share_common_shards_take(Eina_Share *share)
+{
+   unsigned int i;
+
+   for (i = 0; i < EINA_SHARE_COMMON_SHARDS; i++)
+     eina_spinlock_take(&share->share->shards[i].lock);
+}
+
+static void
+_eina_share_common_shards_release(Eina_Share *share)
+{
+   unsigned int i;
+
+   for (i = 0; i < EINA_SHARE_COMMON_SHARDS; i++)
+     eina_spinlock_release(&share->share->shards[i].lock);
+}
+
 static int
 _eina_share_common_cmp(const Eina_Share_Common_Head *ed,
                        const int *hash,
@@ -580,6 +669,66 @@ eina_iterator_array_check(const Eina_Rbtree *rbtree EINA_UNUSED,
    return EINA_TRUE;
 }
 
+#ifdef EINA_SHARE_COMMON_CACHE
+static void
+_eina_share_common_cache_entry_flush(Eina_Share_Common_Cache_Entry *entry)
+{
+   if (entry->hits)
+     __atomic_add_fetch(&entry->share->share->cache_hits, entry->hits,
+                        __ATOMIC_RELAXED);
+   entry->hits = 0;
+}
+
+static void
+_eina_share_common_cache_free(void *data)
+{
+   Eina_Share_Common_Cache *cache = data;
+   unsigned int i;
+
+   if (!cache) return;
+
+   /* release the references held by this thread */
+   if (cache->generation == _eina_share_common_generation)
+     for (i = 0; i < EINA_SHARE_COMMON_CACHE_SIZE; i++)
+       {
+          Eina_Share_Common_Cache_Entry *entry = cache->entries + i;
+
+          if (!entry->node) continue;
+          _eina_share_common_cache_entry_flush(entry);
+          if (!eina_share_common_del(entry->share, entry->node->str))
+            EINA_LOG_ERR("Failed to release cached shared string");
+       }
+   free(cache);
+}
+
+static Eina_Share_Common_Cache *
+_eina_share_common_cache_get(void)
+{
+   Eina_Share_Common_Cache *cache;
+
+   cache = eina_tls_get(_eina_share_common_cache_key);
+   if (EINA_LIKELY(cache != NULL))
+     {
+        if (EINA_LIKELY(cache->generation == _eina_share_common_generation))
+          return cache;
+        /* strings from an older generation were freed with their share */
+        memset(cache->entries, 0, sizeof(cache->entries));
+     }
+   else
+     {
+        cache = calloc(1, sizeof(Eina_Share_Common_Cache));
+        if (!cache) return NULL;
+        if (!eina_tls_set(_eina_share_common_cache_key, cache))
+          {
+             free(cache);
+             return NULL;
+          }
+     }
+   cache->generation = _eina_share_common_generation;
+   return cache;
+}
+#endif
+
 /**
  * @endcond
  */
@@ -606,6 +755,7 @@ eina_share_common_init(Eina_Share **_share,
                        const char *node_magic_STR)
 {
    Eina_Share *share;
+   unsigned int i;
 
    share = *_share = calloc(1, sizeof(Eina_Share));
    if (!share) goto on_error;
@@ -621,6 +771,9 @@ eina_share_common_init(Eina_Share **_share,
 #undef EMS
    EINA_MAGIC_SET(share->share, EINA_MAGIC_SHARE);
 
+   for (i = 0; i < EINA_SHARE_COMMON_SHARDS; i++)
+     eina_spinlock_new(&share->share->shards[i].lock);
+
    _eina_share_common_population_init(share);
 
    /* below is the common part among other all eina_share_common user */
@@ -628,6 +781,11 @@ eina_share_common_init(Eina_Share **_share,
      return EINA_TRUE;
 
    eina_spinlock_new(&_mutex_big);
+#ifdef EINA_SHARE_COMMON_CACHE
+   if (!eina_tls_cb_new(&_eina_share_common_cache_key,
+                        _eina_share_common_cache_free))
+     goto on_error;
+#endif
    return EINA_TRUE;
 
  on_error:
@@ -652,7 +810,13 @@ eina_share_common_shutdown(Eina_Share **_share)
    unsigned int i;
    Eina_Share *share = *_share;
 
+#ifdef EINA_SHARE_COMMON_CACHE
+   /* invalidate all thread caches, their strings are freed below */
+   _eina_share_common_generation++;
+#endif
+
    eina_spinlock_take(&_mutex_big);
+   _eina_share_common_shards_take(share);
 
    _eina_share_common_population_stats(share);
 
@@ -665,6 +829,9 @@ eina_share_common_shutdown(Eina_Share **_share)
                               _eina_share_common_head_free), NULL);
         share->share->buckets[i] = NULL;
      }
+   _eina_share_common_shards_release(share);
+   for (i = 0; i < EINA_SHARE_COMMON_SHARDS; i++)
+     eina_spinlock_free(&share->share->shards[i].lock);
    MAGIC_FREE(share->share);
 
    _eina_share_common_population_shutdown(share);
@@ -678,6 +845,12 @@ eina_share_common_shutdown(Eina_Share **_share)
    if (--_eina_share_common_count != 0)
      return EINA_TRUE;
 
+#ifdef EINA_SHARE_COMMON_CACHE
+   /* other threads caches are leaked if they outlive eina */
+   _eina_share_common_cache_free(eina_tls_get(_eina_share_common_cache_key));
+   eina_tls_set(_eina_share_common_cache_key, NULL);
+   eina_tls_free(_eina_share_common_cache_key);
+#endif
    eina_spinlock_free(&_mutex_big);
 
    return EINA_TRUE;
@@ -733,6 +906,11 @@ eina_share_common_add_length(Eina_Share *share,
 {
    Eina_Share_Common_Head **p_bucket, *ed;
    Eina_Share_Common_Node *el;
+   Eina_Share_Common_Shard *shard;
+#ifdef EINA_SHARE_COMMON_CACHE
+   Eina_Share_Common_Cache *cache;
+   Eina_Share_Common_Cache_Entry *entry = NULL, evicted = { NULL, NULL, 0, 0 };
+#endif
    int hash;
 
    if (!str)
@@ -745,7 +923,25 @@ eina_share_common_add_length(Eina_Share *share,
 
    hash = eina_hash_superfast(str, slen);
 
-   eina_spinlock_take(&_mutex_big);
+#ifdef EINA_SHARE_COMMON_CACHE
+   cache = _eina_share_common_cache_get();
+   if (cache)
+     {
+        entry = cache->entries + EINA_SHARE_COMMON_CACHE_IDX(hash);
+        /* the cache holds a reference, so the node can't go away */
+        if ((entry->share == share) && (entry->hash == hash) &&
+            _eina_share_common_node_eq(entry->node, str, slen))
+          {
+             EINA_SHARE_COMMON_REF_INC(entry->node);
+             if (++entry->hits == EINA_SHARE_COMMON_CACHE_HITS_FLUSH)
+               _eina_share_common_cache_entry_flush(entry);
+             return entry->node->str;
+          }
+     }
+#endif
+
+   shard = _eina_share_common_shard_take(share, hash);
+   shard->lookups++;
    p_bucket = share->share->buckets + EINA_SHARE_COMMON_BUCKET_IDX(hash);
 
    ed = _eina_share_common_find_hash(*p_bucket, EINA_SHARE_COMMON_NODE_HASH(hash));
@@ -757,27 +953,49 @@ eina_share_common_add_length(Eina_Share *share,
                                                     str,
                                                     slen,
                                                     null_size);
-        eina_spinlock_release(&_mutex_big);
+        if (s) shard->strings++;
+        eina_spinlock_release(&shard->lock);
         return s;
      }
 
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, eina_spinlock_release(&_mutex_big), NULL);
+   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, eina_spinlock_release(&shard->lock), NULL);
 
    el = _eina_share_common_head_find(ed, str, slen);
    if (el)
      {
         EINA_MAGIC_CHECK_SHARE_COMMON_NODE
           (el, share->node_magic,
-           eina_spinlock_release(&_mutex_big); return NULL);
-        el->references++;
-        eina_spinlock_release(&_mutex_big);
+           eina_spinlock_release(&shard->lock); return NULL);
+        if (EINA_SHARE_COMMON_REF_INC(el) == 1)
+          shard->strings++;
+#ifdef EINA_SHARE_COMMON_CACHE
+        /* the string is shared already, so likely hot: keep it around */
+        else if (entry)
+          {
+             EINA_SHARE_COMMON_REF_INC(el);
+             evicted = *entry;
+             entry->share = share;
+             entry->node = el;
+             entry->hash = hash;
+             entry->hits = 0;
+          }
+#endif
+        eina_spinlock_release(&shard->lock);
+#ifdef EINA_SHARE_COMMON_CACHE
+        if (evicted.node)
+          {
+             _eina_share_common_cache_entry_flush(&evicted);
+             if (!eina_share_common_del(evicted.share, evicted.node->str))
+               EINA_LOG_ERR("Failed to release cached shared string");
+          }
+#endif
         return el->str;
      }
 
    el = _eina_share_common_node_alloc(slen, null_size);
    if (!el)
      {
-                                           eina_spinlock_release(&_mutex_big);
+        eina_spinlock_release(&shard->lock);
         return NULL;
      }
 
@@ -785,8 +1003,9 @@ eina_share_common_add_length(Eina_Share *share,
    el->next = ed->head;
    ed->head = el;
    _eina_share_common_population_head_add(share, ed);
+   shard->strings++;
 
-   eina_spinlock_release(&_mutex_big);
+   eina_spinlock_release(&shard->lock);
 
    return el->str;
 }
@@ -795,22 +1014,28 @@ const char *
 eina_share_common_ref(Eina_Share *share, const char *str)
 {
    Eina_Share_Common_Node *node;
+#ifndef EINA_SHARE_COMMON_CACHE
+   Eina_Share_Common_Shard *shard;
+#endif
 
    if (!str)
       return NULL;
 
-   eina_spinlock_take(&_mutex_big);
    node = _eina_share_common_node_from_str(str, share->node_magic);
    if (!node)
-     {
-        eina_spinlock_release(&_mutex_big);
-        return str;
-     }
-   node->references++;
-
-   eina_share_common_population_nolock_add(share, node->length);
+     return str;
+
+   /* the caller holds a reference already, so the node is alive */
+#ifdef EINA_SHARE_COMMON_CACHE
+   EINA_SHARE_COMMON_REF_INC(node);
+#else
+   shard = _eina_share_common_shard_take
+     (share, eina_hash_superfast(node->str, node->length));
+   EINA_SHARE_COMMON_REF_INC(node);
+   eina_spinlock_release(&shard->lock);
+#endif
 
-   eina_spinlock_release(&_mutex_big);
+   eina_share_common_population_add(share, node->length);
 
    return str;
 }
@@ -823,32 +1048,35 @@ eina_share_common_del(Eina_Share *share, const char *str)
    Eina_Share_Common_Head *ed;
    Eina_Share_Common_Head **p_bucket;
    Eina_Share_Common_Node *node;
+   Eina_Share_Common_Shard *shard;
 
    if (!str)
       return EINA_TRUE;
 
-   eina_spinlock_take(&_mutex_big);
-
    node = _eina_share_common_node_from_str(str, share->node_magic);
    if (!node)
-      goto on_error;
+      return EINA_FALSE;
 
    slen = node->length;
-   eina_share_common_population_nolock_del(share, slen);
-   if (node->references > 1)
+   eina_share_common_population_del(share, slen);
+
+   /* references only ever drop to 0 with the shard locked, so a node
+    * can't be found and revived while being freed here */
+   shard = _eina_share_common_shard_take
+     (share, eina_hash_superfast(node->str, slen));
+   if (EINA_SHARE_COMMON_REF_DEC(node) > 0)
      {
-        node->references--;
-        eina_spinlock_release(&_mutex_big);
+        eina_spinlock_release(&shard->lock);
         return EINA_TRUE;
      }
 
-   node->references = 0;
+   shard->strings--;
 
    ed = _eina_share_common_head_from_node(node);
    if (!ed)
       goto on_error;
 
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, eina_spinlock_release(&_mutex_big), EINA_FALSE);
+   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, eina_spinlock_release(&shard->lock), EINA_FALSE);
 
    if (node != &ed->builtin_node)
      {
@@ -865,16 +1093,41 @@ eina_share_common_del(Eina_Share *share, const char *str)
    else
       _eina_share_common_population_head_del(share, ed);
 
-   eina_spinlock_release(&_mutex_big);
+   eina_spinlock_release(&shard->lock);
 
    return EINA_TRUE;
 
 on_error:
-   eina_spinlock_release(&_mutex_big);
+   eina_spinlock_release(&shard->lock);
    /* possible segfault happened before here, but... */
    return EINA_FALSE;
 }
 
+void
+eina_share_common_stats_get(Eina_Share *share, Eina_Share_Common_Stats *stats)
+{
+   unsigned int i;
+
+   memset(stats, 0, sizeof(*stats));
+   stats->shards = EINA_SHARE_COMMON_SHARDS;
+   for (i = 0; i < EINA_SHARE_COMMON_SHARDS; i++)
+     {
+        Eina_Share_Common_Shard *shard = share->share->shards + i;
+
+        eina_spinlock_take(&shard->lock);
+        stats->strings += shard->strings;
+        if (shard->strings > stats->shard_max)
+          stats->shard_max = shard->strings;
+        stats->lookups += shard->lookups;
+        stats->contended += shard->contended;
+        eina_spinlock_release(&shard->lock);
+     }
+#ifdef EINA_SHARE_COMMON_CACHE
+   stats->cache_hits = __atomic_load_n(&share->share->cache_hits,
+                                       __ATOMIC_RELAXED);
+#endif
+}
+
 int
 eina_share_common_length(EINA_UNUSED Eina_Share *share, const char *str)
 {
@@ -905,6 +1158,7 @@ eina_share_common_dump(Eina_Share *share, void (*additional_dump)(
    di.unique = 0;
 
    eina_spinlock_take(&_mutex_big);
+   _eina_share_common_shards_take(share);
    for (i = 0; i < EINA_SHARE_COMMON_BUCKETS; i++)
      {
         if (!share->share->buckets[i])
@@ -945,6 +1199,7 @@ eina_share_common_dump(Eina_Share *share, void (*additional_dump)(
                       share->population_group[i].max);
 #endif
 
+   _eina_share_common_shards_release(share);
    eina_spinlock_release(&_mutex_big);
 }
 
@@ -61,6 +61,17 @@ struct dumpinfo
    int used, saved, dups, unique;
 };
 
+typedef struct _Eina_Share_Common_Stats Eina_Share_Common_Stats;
+struct _Eina_Share_Common_Stats
+{
+   unsigned int strings;
+   unsigned int shards;
+   unsigned int shard_max;
+   unsigned long long lookups;
+   unsigned long long contended;
+   unsigned long long cache_hits;
+};
+
 Eina_Bool   eina_share_common_init(Eina_Share **share,
                                    Eina_Magic node_magic,
                                    const char *node_magic_STR);
@@ -77,6 +88,8 @@ int         eina_share_common_length(Eina_Share *share,
 EINA_WARN_UNUSED_RESULT;
 void        eina_share_common_dump(Eina_Share *share, void (*additional_dump)(
                                       struct dumpinfo *), int used);
+void        eina_share_common_stats_get(Eina_Share *share,
+                                        Eina_Share_Common_Stats *stats);
 
 
 /* Population functions */
@@ -747,6 +747,25 @@ eina_stringshare_strlen(Eina_Stringshare *str)
    return len;
 }
 
+EAPI Eina_Bool
+eina_stringshare_stats_get(Eina_Stringshare_Stats *stats)
+{
+   Eina_Share_Common_Stats st;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(stats, EINA_FALSE);
+   EINA_SAFETY_ON_NULL_RETURN_VAL(stringshare_share, EINA_FALSE);
+
+   eina_share_common_stats_get(stringshare_share, &st);
+   stats->strings = st.strings;
+   stats->shards = st.shards;
+   stats->shard_max = st.shard_max;
+   stats->lookups = st.lookups;
+   stats->contended = st.contended;
+   stats->cache_hits = st.cache_hits;
+
+   return EINA_TRUE;
+}
+
 EAPI void
 eina_stringshare_dump(void)
 {
@@ -334,6 +334,49 @@ EAPI int                eina_stringshare_strlen(Eina_Stringshare *str) EINA_PURE
  */
 EAPI void               eina_stringshare_dump(void);
 
+/**
+ * @typedef Eina_Stringshare_Stats
+ * Statistics about the shared string table, see eina_stringshare_stats_get().
+ *
+ * @since 1.23
+ */
+typedef struct _Eina_Stringshare_Stats Eina_Stringshare_Stats;
+
+/**
+ * @struct _Eina_Stringshare_Stats
+ * Statistics about the shared string table, see eina_stringshare_stats_get().
+ *
+ * The table is split in independently locked shards, @c contended counts
+ * the lookups that had to wait for another thread holding the same shard.
+ * Strings shorter than 4 bytes are not stored in the table and so are not
+ * accounted here.
+ *
+ * @since 1.23
+ */
+struct _Eina_Stringshare_Stats
+{
+   unsigned int strings; /**< number of distinct shared strings */
+   unsigned int shards; /**< number of independently locked shards */
+   unsigned int shard_max; /**< number of strings in the most populated shard */
+   unsigned long long lookups; /**< number of lookups that locked a shard */
+   unsigned long long contended; /**< number of lookups that waited on a shard lock */
+   unsigned long long cache_hits; /**< number of adds served by the per thread cache, without locking */
+};
+
+/**
+ * @brief Retrieves statistics about the shared string table.
+ *
+ * @param[out] stats The structure to fill.
+ * @return #EINA_TRUE on success, #EINA_FALSE otherwise.
+ *
+ * This is meant to tune and debug applications using a lot of shared
+ * strings from many threads. Cache hits are accounted lazily, so they may
+ * lag behind a bit.
+ *
+ * @since 1.23
+ */
+EAPI Eina_Bool          eina_stringshare_stats_get(Eina_Stringshare_Stats *stats) EINA_ARG_NONNULL(1);
+
 static inline Eina_Bool eina_stringshare_replace(Eina_Stringshare **p_str, const char *news) EINA_ARG_NONNULL(1);
 static inline Eina_Bool eina_stringshare_replace_length(Eina_Stringshare **p_str, const char *news, unsigned int slen) EINA_ARG_NONNULL(1);
 
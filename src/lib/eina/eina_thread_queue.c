@@ -2,7 +2,14 @@
 # include "config.h"
 #endif
 
+#include <stddef.h>
 #include <unistd.h>
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <sched.h>
+#endif
 #include "Eina.h"
 #include "eina_thread_queue.h"
 #include "eina_safety_checks.h"
@@ -34,6 +41,14 @@
 #endif
 
 typedef struct _Eina_Thread_Queue_Msg_Block Eina_Thread_Queue_Msg_Block;
+typedef struct _Eina_Thread_Queue_Msg_Node Eina_Thread_Queue_Msg_Node;
+
+// header put in front of every message of a mpsc queue
+struct _Eina_Thread_Queue_Msg_Node
+{
+   Eina_Thread_Queue_Msg_Node   *next; // next message sent
+   Eina_Thread_Queue_Msg_Block  *blk; // block this message lives in
+};
 
 struct _Eina_Thread_Queue
 {
@@ -49,6 +64,17 @@ struct _Eina_Thread_Queue
 #endif
    int                           pending; // how many messages left to read
    int                           fd; // optional fd to write byte to on msg
+   // fields below are only used in mpsc mode
+   Eina_Thread_Queue_Msg_Node   *head; // last message sent
+   Eina_Thread_Queue_Msg_Node   *tail; // next message to read
+   Eina_Thread_Queue_Msg_Node    stub; // placeholder node when empty
+   Eina_Thread_Queue_Msg_Block  *retired; // blocks no longer referenced
+   Eina_Thread_Queue_Msg_Block  *reclaim; // retired blocks waiting on epoch
+   int                           senders[2]; // sends in progress per epoch
+   int                           epoch; // bumped by reader to reclaim blocks
+   int                           reclaim_epoch; // epoch to wait to reclaim
+   int                           waiting; // the reader sleeps on sem
+   Eina_Bool                     mpsc : 1; // lock-free mpsc mode
 };
 
 struct _Eina_Thread_Queue_Msg_Block
@@ -63,6 +89,7 @@ struct _Eina_Thread_Queue_Msg_Block
    int                           size; // the total allocated bytes of data[]
    int                           first; // the byte pos of the first msg
    int                           last; // the byte pos just after the last msg
+   int                           retired; // mpsc: is on the retired list
    Eina_Bool                     full : 1; // is this block full yet?
    Eina_Thread_Queue_Msg         data[1]; // data in memory beyond struct end
 };
@@ -318,6 +345,264 @@ _eina_thread_queue_msg_fetch_done(Eina_Thread_Queue_Msg_Block *blk)
      _eina_thread_queue_msg_block_free(blk);
 }
 
+#ifdef ATOMIC
+// lock-free multiple producer single consumer mode. space for messages is
+// still carved out of pooled blocks, but reserved with an atomic add on
+// the write position of the current block, and sent messages are linked
+// into an intrusive list (Dmitry Vyukov's mpsc queue) so senders never
+// take a lock or wait on each other. blocks hold one ref per message in
+// them plus one while they are the current block to write to. once
+// unreferenced they are freed by the reader after every sender that may
+// still look at them is done (tracked with a 2 epoch sender count).
+
+#ifdef _WIN32
+# define MPSC_YIELD() Sleep(0)
+#else
+# define MPSC_YIELD() sched_yield()
+#endif
+
+// nodes hold pointers that are accessed atomically so keep them aligned
+#define MPSC_PAD ((int)((8 - (offsetof(Eina_Thread_Queue_Msg_Block, data) & 0x7)) & 0x7))
+
+static void
+_eina_thread_queue_mpsc_block_list_push(Eina_Thread_Queue *thq, Eina_Thread_Queue_Msg_Block *first, Eina_Thread_Queue_Msg_Block *last)
+{
+   Eina_Thread_Queue_Msg_Block *head;
+
+   head = __atomic_load_n(&(thq->retired), __ATOMIC_RELAXED);
+   do last->next = head;
+   while (!__atomic_compare_exchange_n(&(thq->retired), &head, first,
+                                       EINA_TRUE, __ATOMIC_RELEASE,
+                                       __ATOMIC_RELAXED));
+}
+
+static void
+_eina_thread_queue_mpsc_block_unref(Eina_Thread_Queue *thq, Eina_Thread_Queue_Msg_Block *blk)
+{
+   if (__atomic_sub_fetch(&(blk->ref), 1, __ATOMIC_ACQ_REL) != 0) return;
+   // a late sender that saw this block as current may bounce the ref
+   // through 0 again when failing to reserve in it, so retire only once
+   if (__atomic_exchange_n(&(blk->retired), 1, __ATOMIC_ACQ_REL)) return;
+   _eina_thread_queue_mpsc_block_list_push(thq, blk, blk);
+}
+
+static void
+_eina_thread_queue_mpsc_block_list_free(Eina_Thread_Queue_Msg_Block *blk)
+{
+   Eina_Thread_Queue_Msg_Block *next;
+
+   for (; blk; blk = next)
+     {
+        next = blk->next;
+        _eina_thread_queue_msg_block_free(blk);
+     }
+}
+
+// only ever called from the reader
+static void
+_eina_thread_queue_mpsc_reclaim(Eina_Thread_Queue *thq)
+{
+   int epoch;
+
+   if (thq->reclaim)
+     {
+        if (__atomic_load_n(&(thq->senders[thq->reclaim_epoch]),
+                            __ATOMIC_SEQ_CST) != 0) return;
+        _eina_thread_queue_mpsc_block_list_free(thq->reclaim);
+        thq->reclaim = NULL;
+     }
+   if (!__atomic_load_n(&(thq->retired), __ATOMIC_RELAXED)) return;
+   thq->reclaim = __atomic_exchange_n(&(thq->retired), NULL, __ATOMIC_SEQ_CST);
+   // senders that may have fetched one of these blocks as current did so
+   // before the exchange above so counted themselves in the old epoch.
+   // new senders go to the new one so the old count drains quickly. the
+   // epoch is not flipped again until the old count drained, so a sender
+   // counted in it can never be mistaken for one of a later epoch
+   epoch = thq->epoch;
+   __atomic_store_n(&(thq->epoch), epoch + 1, __ATOMIC_SEQ_CST);
+   thq->reclaim_epoch = epoch & 1;
+   if (__atomic_load_n(&(thq->senders[thq->reclaim_epoch]),
+                       __ATOMIC_SEQ_CST) != 0) return;
+   _eina_thread_queue_mpsc_block_list_free(thq->reclaim);
+   thq->reclaim = NULL;
+}
+
+static Eina_Thread_Queue_Msg_Node *
+_eina_thread_queue_mpsc_msg_alloc(Eina_Thread_Queue *thq, int size)
+{
+   Eina_Thread_Queue_Msg_Block *blk, *nblk;
+   Eina_Thread_Queue_Msg_Node *node = NULL;
+   int epoch, pos;
+
+   // add the node header and round up to nearest 8
+   size = ((size + (int)sizeof(Eina_Thread_Queue_Msg_Node) + 7) >> 3) << 3;
+   // enter an epoch. the reader may flip it between our load and the
+   // count going up and then find the old count empty, so check it did
+   // not change once counted and else count again in the new one
+   for (;;)
+     {
+        epoch = __atomic_load_n(&(thq->epoch), __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&(thq->senders[epoch & 1]), 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&(thq->epoch), __ATOMIC_SEQ_CST) == epoch) break;
+        __atomic_sub_fetch(&(thq->senders[epoch & 1]), 1, __ATOMIC_SEQ_CST);
+     }
+   epoch &= 1;
+   for (;;)
+     {
+        blk = __atomic_load_n(&(thq->last), __ATOMIC_ACQUIRE);
+        if (blk)
+          {
+             __atomic_add_fetch(&(blk->ref), 1, __ATOMIC_ACQ_REL);
+             pos = __atomic_fetch_add(&(blk->last), size, __ATOMIC_ACQ_REL);
+             if ((pos + size) <= blk->size)
+               {
+                  node = (Eina_Thread_Queue_Msg_Node *)
+                    ((char *)(&(blk->data[0])) + pos);
+                  break;
+               }
+             // the block is full, the current ref is dropped by whoever
+             // manages to replace it
+             _eina_thread_queue_mpsc_block_unref(thq, blk);
+          }
+        nblk = _eina_thread_queue_msg_block_new(MAX(MPSC_PAD + size, MIN_SIZE));
+        if (!nblk) break;
+        // one ref for being the current block and one for our message
+        nblk->ref = 2;
+        nblk->last = MPSC_PAD + size;
+        if (__atomic_compare_exchange_n(&(thq->last), &blk, nblk, EINA_FALSE,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+          {
+             if (blk) _eina_thread_queue_mpsc_block_unref(thq, blk);
+             blk = nblk;
+             node = (Eina_Thread_Queue_Msg_Node *)
+               ((char *)(&(blk->data[0])) + MPSC_PAD);
+             break;
+          }
+        // another sender replaced the block first, so use that one
+        _eina_thread_queue_msg_block_free(nblk);
+     }
+   __atomic_sub_fetch(&(thq->senders[epoch]), 1, __ATOMIC_SEQ_CST);
+   if (!node) return NULL;
+   node->next = NULL;
+   node->blk = blk;
+   ((Eina_Thread_Queue_Msg *)(node + 1))->size =
+     size - (int)sizeof(Eina_Thread_Queue_Msg_Node);
+   return node;
+}
+
+static void
+_eina_thread_queue_mpsc_push(Eina_Thread_Queue *thq, Eina_Thread_Queue_Msg_Node *node)
+{
+   Eina_Thread_Queue_Msg_Node *prev;
+
+   __atomic_store_n(&(node->next), NULL, __ATOMIC_RELAXED);
+   prev = __atomic_exchange_n(&(thq->head), node, __ATOMIC_ACQ_REL);
+   __atomic_store_n(&(prev->next), node, __ATOMIC_RELEASE);
+}
+
+static Eina_Thread_Queue_Msg_Node *
+_eina_thread_queue_mpsc_pop(Eina_Thread_Queue *thq)
+{
+   Eina_Thread_Queue_Msg_Node *tail = thq->tail, *next, *head;
+
+   next = __atomic_load_n(&(tail->next), __ATOMIC_ACQUIRE);
+   if (tail == &(thq->stub))
+     {
+        if (!next) return NULL;
+        thq->tail = next;
+        tail = next;
+        next = __atomic_load_n(&(next->next), __ATOMIC_ACQUIRE);
+     }
+   if (next)
+     {
+        thq->tail = next;
+        return tail;
+     }
+   // a sender swapped head already but did not link its message in yet
+   head = __atomic_load_n(&(thq->head), __ATOMIC_ACQUIRE);
+   if (tail != head) return NULL;
+   // put the stub back so tail can move on without the list going empty
+   _eina_thread_queue_mpsc_push(thq, &(thq->stub));
+   next = __atomic_load_n(&(tail->next), __ATOMIC_ACQUIRE);
+   if (next)
+     {
+        thq->tail = next;
+        return tail;
+     }
+   return NULL;
+}
+
+static void
+_eina_thread_queue_mpsc_sleep(Eina_Thread_Queue *thq)
+{
+   __atomic_store_n(&(thq->waiting), 1, __ATOMIC_SEQ_CST);
+   if (__atomic_load_n(&(thq->pending), __ATOMIC_SEQ_CST) > 0)
+     {
+        // if a sender saw us waiting already it posted, so eat that
+        if (!__atomic_exchange_n(&(thq->waiting), 0, __ATOMIC_SEQ_CST))
+          _eina_thread_queue_wait(thq);
+        return;
+     }
+   _eina_thread_queue_wait(thq);
+}
+
+static Eina_Thread_Queue_Msg *
+_eina_thread_queue_mpsc_msg_fetch(Eina_Thread_Queue *thq, Eina_Bool block, void **allocref)
+{
+   Eina_Thread_Queue_Msg_Node *node;
+
+   for (;;)
+     {
+        node = _eina_thread_queue_mpsc_pop(thq);
+        if (node) break;
+        // messages are counted before being linked in, so if any are
+        // pending a sender is about to finish linking, spin until it does
+        if (__atomic_load_n(&(thq->pending), __ATOMIC_SEQ_CST) > 0)
+          {
+             MPSC_YIELD();
+             continue;
+          }
+        if (!block) return NULL;
+        _eina_thread_queue_mpsc_sleep(thq);
+     }
+   __atomic_sub_fetch(&(thq->pending), 1, __ATOMIC_SEQ_CST);
+   *allocref = node;
+   return (Eina_Thread_Queue_Msg *)(node + 1);
+}
+
+static void
+_eina_thread_queue_mpsc_send_done(Eina_Thread_Queue *thq, Eina_Thread_Queue_Msg_Node *node)
+{
+   int pending;
+
+   pending = __atomic_add_fetch(&(thq->pending), 1, __ATOMIC_SEQ_CST);
+   _eina_thread_queue_mpsc_push(thq, node);
+   // wake the reader only once per batch, not for every message
+   if (__atomic_exchange_n(&(thq->waiting), 0, __ATOMIC_SEQ_CST))
+     _eina_thread_queue_wake(thq);
+   if ((thq->fd >= 0) && (pending == 1))
+     {
+        char dummy = 0;
+        if (write(thq->fd, &dummy, 1) != 1)
+          ERR("Eina Threadqueue write to fd %i failed", thq->fd);
+     }
+}
+
+static void
+_eina_thread_queue_mpsc_free(Eina_Thread_Queue *thq)
+{
+   Eina_Thread_Queue_Msg_Node *node;
+   Eina_Thread_Queue_Msg_Block *blk;
+
+   while ((node = _eina_thread_queue_mpsc_pop(thq)))
+     _eina_thread_queue_mpsc_block_unref(thq, node->blk);
+   blk = thq->last;
+   thq->last = NULL;
+   if (blk) _eina_thread_queue_mpsc_block_unref(thq, blk);
+   _eina_thread_queue_mpsc_block_list_free(thq->reclaim);
+   _eina_thread_queue_mpsc_block_list_free(thq->retired);
+}
+#endif
 
 //////////////////////////////////////////////////////////////////////////////
 Eina_Bool
@@ -374,11 +659,29 @@ eina_thread_queue_new(void)
    return thq;
 }
 
+EAPI Eina_Thread_Queue *
+eina_thread_queue_mpsc_new(void)
+{
+   Eina_Thread_Queue *thq;
+
+   thq = eina_thread_queue_new();
+#ifdef ATOMIC
+   if (!thq) return NULL;
+   thq->mpsc = EINA_TRUE;
+   thq->head = thq->tail = &(thq->stub);
+#endif
+   return thq;
+}
+
 EAPI void
 eina_thread_queue_free(Eina_Thread_Queue *thq)
 {
    if (!thq) return;
 
+#ifdef ATOMIC
+   if (thq->mpsc) _eina_thread_queue_mpsc_free(thq);
+#endif
+
 #ifndef ATOMIC
    eina_spinlock_free(&(thq->lock_pending));
 #endif
@@ -394,6 +697,17 @@ eina_thread_queue_send(Eina_Thread_Queue *thq, int size, void **allocref)
    Eina_Thread_Queue_Msg *msg;
    Eina_Thread_Queue_Msg_Block *blk;
 
+#ifdef ATOMIC
+   if (thq->mpsc)
+     {
+        Eina_Thread_Queue_Msg_Node *node;
+
+        node = _eina_thread_queue_mpsc_msg_alloc(thq, size);
+        if (!node) return NULL;
+        *allocref = node;
+        return node + 1;
+     }
+#endif
    RWLOCK_LOCK(&(thq->lock_write));
    msg = _eina_thread_queue_msg_alloc(thq, size, &blk);
    RWLOCK_UNLOCK(&(thq->lock_write));
@@ -411,8 +725,15 @@ eina_thread_queue_send(Eina_Thread_Queue *thq, int size, void **allocref)
 EAPI void
 eina_thread_queue_send_done(Eina_Thread_Queue *thq, void *allocref)
 {
-   _eina_thread_queue_msg_alloc_done(allocref);
-   _eina_thread_queue_wake(thq);
+#ifdef ATOMIC
+   if (thq->mpsc)
+     _eina_thread_queue_mpsc_send_done(thq, allocref);
+   else
+#endif
+     {
+        _eina_thread_queue_msg_alloc_done(allocref);
+        _eina_thread_queue_wake(thq);
+     }
    if (thq->parent)
      {
         void *ref;
@@ -426,6 +747,9 @@ eina_thread_queue_send_done(Eina_Thread_Queue *thq, void *allocref)
              eina_thread_queue_send_done(thq->parent, ref);
           }
      }
+#ifdef ATOMIC
+   if (thq->mpsc) return;
+#endif
    if (thq->fd >= 0)
      {
         char dummy = 0;
@@ -440,6 +764,10 @@ eina_thread_queue_wait(Eina_Thread_Queue *thq, void **allocref)
    Eina_Thread_Queue_Msg *msg;
    Eina_Thread_Queue_Msg_Block *blk;
 
+#ifdef ATOMIC
+   if (thq->mpsc)
+     return _eina_thread_queue_mpsc_msg_fetch(thq, EINA_TRUE, allocref);
+#endif
    _eina_thread_queue_wait(thq);
    RWLOCK_LOCK(&(thq->lock_read));
    msg = _eina_thread_queue_msg_fetch(thq, &blk);
@@ -456,8 +784,17 @@ eina_thread_queue_wait(Eina_Thread_Queue *thq, void **allocref)
 }
 
 EAPI void
-eina_thread_queue_wait_done(Eina_Thread_Queue *thq EINA_UNUSED, void *allocref)
+eina_thread_queue_wait_done(Eina_Thread_Queue *thq, void *allocref)
 {
+#ifdef ATOMIC
+   if (thq->mpsc)
+     {
+        _eina_thread_queue_mpsc_block_unref
+          (thq, ((Eina_Thread_Queue_Msg_Node *)allocref)->blk);
+        _eina_thread_queue_mpsc_reclaim(thq);
+        return;
+     }
+#endif
    _eina_thread_queue_msg_fetch_done(allocref);
 }
 
@@ -467,6 +804,10 @@ eina_thread_queue_poll(Eina_Thread_Queue *thq, void **allocref)
    Eina_Thread_Queue_Msg *msg;
    Eina_Thread_Queue_Msg_Block *blk;
 
+#ifdef ATOMIC
+   if (thq->mpsc)
+     return _eina_thread_queue_mpsc_msg_fetch(thq, EINA_FALSE, allocref);
+#endif
    RWLOCK_LOCK(&(thq->lock_read));
    msg = _eina_thread_queue_msg_fetch(thq, &blk);
    RWLOCK_UNLOCK(&(thq->lock_read));
@@ -76,6 +76,30 @@ struct _Eina_Thread_Queue_Msg_Sub
 EAPI Eina_Thread_Queue *
 eina_thread_queue_new(void);
 
+/**
+ * @brief Creates a new lock-free multiple producer, single consumer queue.
+ *
+ * @return A valid new thread queue, or NULL on failure
+ *
+ * This creates a thread queue that is used with the same API as one created
+ * with eina_thread_queue_new(), but where sending never takes a lock nor
+ * waits on other senders. Any number of threads may send messages, but only
+ * one thread at a time may fetch them. The reader is woken up once when the
+ * queue goes from empty to non-empty, not once per message, and so is the
+ * file descriptor set with eina_thread_queue_fd_set(): only one byte is
+ * written per batch, so the reader should call eina_thread_queue_poll()
+ * until it returns NULL on every wakeup.
+ *
+ * If the platform does not provide atomic operations, this returns a
+ * regular thread queue.
+ *
+ * @see eina_thread_queue_new()
+ *
+ * @since 1.23
+ */
+EAPI Eina_Thread_Queue *
+eina_thread_queue_mpsc_new(void);
+
 /**
  * @brief Frees a thread queue.
  *
@@ -885,14 +885,242 @@ extra_arguments_check(DBusMessage *msg, Eldbus_Signal_Handler *sh)
    return EINA_TRUE;
 }
 
+/* D-Bus names can not contain a newline, so it can separate the interface
+ * from the member in the index key. A NULL part is stored as "". */
+#define SIGNAL_INDEX_KEY_SIZE (2 * DBUS_MAXIMUM_NAME_LENGTH + 2)
+
+static const char *
+_signal_index_key(char *buf, const char *interface, const char *member)
+{
+   snprintf(buf, SIGNAL_INDEX_KEY_SIZE, "%s\n%s",
+            interface ? interface : "", member ? member : "");
+   return buf;
+}
+
+static void
+_signal_index_bucket_free(Eldbus_Signal_Index_Bucket *bucket)
+{
+   eina_hash_free(bucket->paths);
+   eina_list_free(bucket->any);
+   free(bucket);
+}
+
+static void
+_signal_index_bucket_add(Eldbus_Signal_Index_Bucket *bucket, Eldbus_Signal_Handler *sh)
+{
+   Eina_List *l, *nl;
+
+   if (!sh->path)
+     {
+        bucket->any = eina_list_append(bucket->any, sh);
+        return;
+     }
+
+   if (!bucket->paths)
+     bucket->paths = eina_hash_string_superfast_new(EINA_FREE_CB(eina_list_free));
+
+   l = eina_hash_find(bucket->paths, sh->path);
+   nl = eina_list_append(l, sh);
+   if (!l) eina_hash_add(bucket->paths, sh->path, nl);
+}
+
+static void
+_signal_index_bucket_del(Eldbus_Signal_Index_Bucket *bucket, Eldbus_Signal_Handler *sh)
+{
+   Eina_List *l, *nl;
+
+   if (!sh->path)
+     {
+        bucket->any = eina_list_remove(bucket->any, sh);
+        return;
+     }
+
+   if (!bucket->paths) return;
+   l = eina_hash_find(bucket->paths, sh->path);
+   if (!l) return;
+
+   if ((!eina_list_next(l)) && (eina_list_data_get(l) == sh))
+     {
+        // the free callback of the hash takes the list with it
+        eina_hash_del_by_key(bucket->paths, sh->path);
+        if (!eina_hash_population(bucket->paths))
+          {
+             eina_hash_free(bucket->paths);
+             bucket->paths = NULL;
+          }
+        return;
+     }
+
+   nl = eina_list_remove(l, sh);
+   if (nl != l) eina_hash_modify(bucket->paths, sh->path, nl);
+}
+
+static void
+_signal_index_add(Eldbus_Connection *conn, Eldbus_Signal_Handler *sh)
+{
+   Eldbus_Signal_Index_Bucket *bucket;
+   char buf[SIGNAL_INDEX_KEY_SIZE];
+   const char *key;
+
+   sh->serial = conn->signal_index.serial++;
+   if ((!sh->interface) && (!sh->member))
+     {
+        _signal_index_bucket_add(&conn->signal_index.wildcard, sh);
+        return;
+     }
+
+   if (!conn->signal_index.members)
+     conn->signal_index.members =
+       eina_hash_string_superfast_new(EINA_FREE_CB(_signal_index_bucket_free));
+
+   key = _signal_index_key(buf, sh->interface, sh->member);
+   bucket = eina_hash_find(conn->signal_index.members, key);
+   if (!bucket)
+     {
+        bucket = calloc(1, sizeof(Eldbus_Signal_Index_Bucket));
+        EINA_SAFETY_ON_NULL_RETURN(bucket);
+        eina_hash_add(conn->signal_index.members, key, bucket);
+     }
+   _signal_index_bucket_add(bucket, sh);
+}
+
+static void
+_signal_index_del(Eldbus_Connection *conn, Eldbus_Signal_Handler *sh)
+{
+   Eldbus_Signal_Index_Bucket *bucket;
+   char buf[SIGNAL_INDEX_KEY_SIZE];
+   const char *key;
+
+   if ((!sh->interface) && (!sh->member))
+     {
+        _signal_index_bucket_del(&conn->signal_index.wildcard, sh);
+        return;
+     }
+
+   if (!conn->signal_index.members) return;
+   key = _signal_index_key(buf, sh->interface, sh->member);
+   bucket = eina_hash_find(conn->signal_index.members, key);
+   if (!bucket) return;
+
+   _signal_index_bucket_del(bucket, sh);
+   if ((!bucket->paths) && (!bucket->any))
+     eina_hash_del_by_key(conn->signal_index.members, key);
+}
+
+typedef struct _Signal_Candidates
+{
+   Eldbus_Signal_Handler **handlers;
+   Eldbus_Signal_Handler **stack;
+   unsigned int count;
+   unsigned int size;
+   unsigned int buckets;
+} Signal_Candidates;
+
+static void
+_signal_candidates_append(Signal_Candidates *c, const Eina_List *list)
+{
+   const Eina_List *l;
+   Eldbus_Signal_Handler *sh;
+
+   if (!list) return;
+   c->buckets++;
+   EINA_LIST_FOREACH(list, l, sh)
+     {
+        if (sh->dangling) continue;
+        if (c->count == c->size)
+          {
+             Eldbus_Signal_Handler **tmp;
+
+             if (c->handlers == c->stack)
+               {
+                  tmp = malloc(c->size * 2 * sizeof(Eldbus_Signal_Handler *));
+                  if (tmp) memcpy(tmp, c->stack, c->size * sizeof(Eldbus_Signal_Handler *));
+               }
+             else
+               tmp = realloc(c->handlers, c->size * 2 * sizeof(Eldbus_Signal_Handler *));
+             EINA_SAFETY_ON_NULL_RETURN(tmp);
+             c->handlers = tmp;
+             c->size *= 2;
+          }
+        c->handlers[c->count++] = eldbus_signal_handler_ref(sh);
+     }
+}
+
+static void
+_signal_candidates_bucket_append(Signal_Candidates *c,
+                                 const Eldbus_Signal_Index_Bucket *bucket,
+                                 const char *path)
+{
+   if (!bucket) return;
+   if ((bucket->paths) && (path))
+     _signal_candidates_append(c, eina_hash_find(bucket->paths, path));
+   _signal_candidates_append(c, bucket->any);
+}
+
+static void
+_signal_candidates_release(Signal_Candidates *c)
+{
+   unsigned int i;
+
+   for (i = 0; i < c->count; i++)
+     eldbus_signal_handler_unref(c->handlers[i]);
+   if (c->handlers != c->stack) free(c->handlers);
+}
+
+static int
+_signal_candidates_cmp(const void *a, const void *b)
+{
+   const Eldbus_Signal_Handler *const *sa = a;
+   const Eldbus_Signal_Handler *const *sb = b;
+
+   if ((*sa)->serial < (*sb)->serial) return -1;
+   if ((*sa)->serial > (*sb)->serial) return 1;
+   return 0;
+}
+
 static void
 cb_signal_dispatcher(Eldbus_Connection *conn, DBusMessage *msg)
 {
    Eldbus_Message *eldbus_msg;
-   Eina_Inlist *next;
+   Eldbus_Signal_Handler *stack[64];
+   Signal_Candidates c = { stack, stack, 0, EINA_C_ARRAY_LENGTH(stack), 0 };
+   const char *interface, *member, *path;
+   char buf[SIGNAL_INDEX_KEY_SIZE];
+   unsigned int i;
+
+   interface = dbus_message_get_interface(msg);
+   member = dbus_message_get_member(msg);
+   path = dbus_message_get_path(msg);
+
+   /*
+    * Only look at the handlers that can match the signal: the ones listening
+    * to its interface and member, to its interface or to its member only,
+    * and the ones listening to neither. In each of these buckets, only the
+    * handlers listening to the signal path or to any path are taken.
+    */
+   if (conn->signal_index.members)
+     {
+        Eina_Hash *members = conn->signal_index.members;
+
+        _signal_candidates_bucket_append
+          (&c, eina_hash_find(members, _signal_index_key(buf, interface, member)), path);
+        if (interface && member)
+          {
+             _signal_candidates_bucket_append
+               (&c, eina_hash_find(members, _signal_index_key(buf, interface, NULL)), path);
+             _signal_candidates_bucket_append
+               (&c, eina_hash_find(members, _signal_index_key(buf, NULL, member)), path);
+          }
+     }
+   _signal_candidates_bucket_append(&c, &conn->signal_index.wildcard, path);
+
+   if (!c.count) goto end;
+   if (c.buckets > 1)
+     qsort(c.handlers, c.count, sizeof(Eldbus_Signal_Handler *),
+           _signal_candidates_cmp);
 
    eldbus_msg = eldbus_message_new(EINA_FALSE);
-   EINA_SAFETY_ON_NULL_RETURN(eldbus_msg);
+   EINA_SAFETY_ON_NULL_GOTO(eldbus_msg, end);
 
    eldbus_msg->dbus_msg = dbus_message_ref(msg);
    dbus_message_iter_init(eldbus_msg->dbus_msg,
@@ -901,17 +1129,13 @@ cb_signal_dispatcher(Eldbus_Connection *conn, DBusMessage *msg)
    eldbus_connection_ref(conn);
    eldbus_init();
    /*
-    * Do the walking open-coded so we don't crash if a callback
-    * removes other signal handlers from the list and we don't own
-    * yet a reference to them.
+    * The candidates are referenced, so a callback can delete any of them
+    * (they become dangling and are skipped) or add new ones (they will only
+    * see the next signals).
     */
-   next = conn->signal_handlers;
-   while (next != NULL)
+   for (i = 0; i < c.count; i++)
      {
-        Eldbus_Signal_Handler *sh;
-
-        sh = EINA_INLIST_CONTAINER_GET(next, Eldbus_Signal_Handler);
-        next = next->next;
+        Eldbus_Signal_Handler *sh = c.handlers[i];
 
         if (sh->dangling) continue;
         if (sh->sender)
@@ -926,17 +1150,9 @@ cb_signal_dispatcher(Eldbus_Connection *conn, DBusMessage *msg)
              else
                if (!dbus_message_has_sender(msg, sh->sender)) continue;
           }
-        if (sh->path && !dbus_message_has_path(msg, sh->path)) continue;
-        if (sh->interface && !dbus_message_has_interface(msg, sh->interface))
-          continue;
-        if (sh->member && !dbus_message_has_member(msg, sh->member)) continue;
         if (!extra_arguments_check(msg, sh)) continue;
 
-        eldbus_signal_handler_ref(sh);
         sh->cb((void *)sh->cb_data, eldbus_msg);
-        /* update next signal handler because the list may have changed */
-        next = EINA_INLIST_GET(sh)->next;
-        eldbus_signal_handler_unref(sh);
 
         /*
          * Rewind iterator so another signal handler matching the same signal
@@ -947,8 +1163,14 @@ cb_signal_dispatcher(Eldbus_Connection *conn, DBusMessage *msg)
      }
 
    eldbus_message_unref(eldbus_msg);
+   // release the handlers while the connection they point to is alive
+   _signal_candidates_release(&c);
    eldbus_connection_unref(conn);
    eldbus_shutdown();
+   return;
+
+ end:
+   _signal_candidates_release(&c);
 }
 
 static DBusHandlerResult
@@ -1258,6 +1480,9 @@ _eldbus_connection_free(Eldbus_Connection *conn)
           ERR("conn=%p alive signal=%p %s.%s path=%s", conn, h, h->interface,
               h->member, h->path);
      }
+   eina_hash_free(conn->signal_index.members);
+   eina_hash_free(conn->signal_index.wildcard.paths);
+   eina_list_free(conn->signal_index.wildcard.any);
 
    for (i = 0; i < ELDBUS_CONNECTION_EVENT_LAST; i++)
      {
@@ -1572,6 +1797,7 @@ eldbus_connection_signal_handler_add(Eldbus_Connection *conn, Eldbus_Signal_Hand
    EINA_SAFETY_ON_NULL_RETURN(handler);
    conn->signal_handlers = eina_inlist_append(conn->signal_handlers,
                                               EINA_INLIST_GET(handler));
+   _signal_index_add(conn, handler);
 }
 
 void
@@ -1590,6 +1816,7 @@ eldbus_connection_signal_handler_del(Eldbus_Connection *conn, Eldbus_Signal_Hand
    EINA_SAFETY_ON_NULL_RETURN(handler);
    conn->signal_handlers = eina_inlist_remove(conn->signal_handlers,
                                               EINA_INLIST_GET(handler));
+   _signal_index_del(conn, handler);
 }
 
 void
@@ -40,6 +40,12 @@ typedef struct _Eldbus_Connection_Context_Event
    Eina_List   *to_delete;
 } Eldbus_Connection_Context_Event;
 
+typedef struct _Eldbus_Signal_Index_Bucket
+{
+   Eina_Hash                     *paths; //path -> Eina_List of Eldbus_Signal_Handler
+   Eina_List                     *any; //handlers without path
+} Eldbus_Signal_Index_Bucket;
+
 struct _Eldbus_Connection
 {
    EINA_MAGIC;
@@ -51,6 +57,12 @@ struct _Eldbus_Connection
    Eina_Inlist                   *data;
    Eina_Inlist                   *cbs_free;
    Eina_Inlist                   *signal_handlers;
+   struct
+   {
+      Eina_Hash                  *members; //"interface\nmember" -> Eldbus_Signal_Index_Bucket
+      Eldbus_Signal_Index_Bucket  wildcard; //handlers without interface and member
+      unsigned long long          serial;
+   } signal_index;
    Eina_Inlist                   *pendings;
    Eina_Inlist                   *fd_handlers;
    Eina_Inlist                   *timeouts;
@@ -97,6 +109,7 @@ struct _Eldbus_Signal_Handler
    Eldbus_Connection_Name    *bus;
    const void               *cb_data;
    Eina_Inlist              *cbs_free;
+   unsigned long long        serial; //registration order, handlers are called in it
    Eina_Bool                 dangling;
 };
 
@@ -75,4 +75,33 @@ struct Elm_Gen_Item
    Eina_Bool                 callbacks : 1;
 };
 
+/* item cache shared by genlist/gengrid: realized item views are kept per
+ * key (item class plus style flags) for O(1) reuse, each key most recent
+ * first. when the cache is full, the key holding the most entries gives up
+ * its oldest one, so a flood of one item class does not evict the few
+ * views kept for the others. */
+
+typedef struct _Elm_Gen_Item_Cache       Elm_Gen_Item_Cache;
+typedef struct _Elm_Gen_Item_Cache_Entry Elm_Gen_Item_Cache_Entry;
+
+struct _Elm_Gen_Item_Cache_Entry
+{
+   const void  *klass; /**< item class (or style) the entry can be reused for */
+   unsigned int flags; /**< style flags the entry can be reused with */
+   unsigned int serial; /**< push order, to evict the oldest of equal keys */
+};
+
+struct _Elm_Gen_Item_Cache
+{
+   Eina_Hash   *keys; /**< (klass, flags) -> Eina_List of entries, most recent first */
+   int          count;
+   unsigned int serial;
+   unsigned int hits, misses;
+};
+
+void                      _elm_gen_item_cache_push(Elm_Gen_Item_Cache *cache, Elm_Gen_Item_Cache_Entry *entry, const void *klass, unsigned int flags);
+Elm_Gen_Item_Cache_Entry *_elm_gen_item_cache_take(Elm_Gen_Item_Cache *cache, const void *klass, unsigned int flags);
+Elm_Gen_Item_Cache_Entry *_elm_gen_item_cache_evict(Elm_Gen_Item_Cache *cache);
+void                      _elm_gen_item_cache_shutdown(Elm_Gen_Item_Cache *cache);
+
 #endif
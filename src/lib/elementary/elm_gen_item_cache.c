@@ -0,0 +1,174 @@
+#ifdef HAVE_CONFIG_H
+# include "elementary_config.h"
+#endif
+
+#include <Elementary.h>
+#include "elm_priv.h"
+#include "elm_gen_common.h"
+
+typedef struct _Elm_Gen_Item_Cache_Key
+{
+   const void  *klass;
+   unsigned int flags;
+} Elm_Gen_Item_Cache_Key;
+
+static unsigned int
+_key_length(const void *key EINA_UNUSED)
+{
+   return sizeof(Elm_Gen_Item_Cache_Key);
+}
+
+static int
+_key_cmp(const void *key1, int key1_length EINA_UNUSED,
+         const void *key2, int key2_length EINA_UNUSED)
+{
+   const Elm_Gen_Item_Cache_Key *k1 = key1, *k2 = key2;
+
+   if (k1->klass != k2->klass)
+     return (k1->klass < k2->klass) ? -1 : 1;
+   return (int)k1->flags - (int)k2->flags;
+}
+
+static int
+_key_hash(const void *key, int key_length EINA_UNUSED)
+{
+   const Elm_Gen_Item_Cache_Key *k = key;
+   unsigned long long v;
+
+   v = (unsigned long long)(uintptr_t)k->klass ^
+     ((unsigned long long)k->flags << 59);
+   return eina_hash_int64(&v, sizeof(v));
+}
+
+static void
+_key_set(Elm_Gen_Item_Cache_Key *key, const void *klass, unsigned int flags)
+{
+   key->klass = klass;
+   key->flags = flags;
+}
+
+void
+_elm_gen_item_cache_push(Elm_Gen_Item_Cache *cache,
+                         Elm_Gen_Item_Cache_Entry *entry,
+                         const void *klass, unsigned int flags)
+{
+   Elm_Gen_Item_Cache_Key key;
+   Eina_List *l, *nl;
+
+   if (!cache->keys)
+     cache->keys = eina_hash_new(_key_length, _key_cmp, _key_hash, NULL, 4);
+
+   entry->klass = klass;
+   entry->flags = flags;
+   entry->serial = cache->serial++;
+
+   _key_set(&key, klass, flags);
+   l = eina_hash_find(cache->keys, &key);
+   nl = eina_list_prepend(l, entry);
+   if (!l) eina_hash_add(cache->keys, &key, nl);
+   else eina_hash_modify(cache->keys, &key, nl);
+   cache->count++;
+}
+
+static void
+_entry_unlink(Elm_Gen_Item_Cache *cache, Elm_Gen_Item_Cache_Entry *entry,
+              Eina_List *l, Eina_List *node)
+{
+   Elm_Gen_Item_Cache_Key key;
+   Eina_List *nl;
+
+   _key_set(&key, entry->klass, entry->flags);
+   nl = eina_list_remove_list(l, node);
+   if (!nl)
+     eina_hash_del_by_key(cache->keys, &key);
+   else if (nl != l)
+     eina_hash_modify(cache->keys, &key, nl);
+   cache->count--;
+}
+
+Elm_Gen_Item_Cache_Entry *
+_elm_gen_item_cache_take(Elm_Gen_Item_Cache *cache,
+                         const void *klass, unsigned int flags)
+{
+   Elm_Gen_Item_Cache_Entry *entry;
+   Elm_Gen_Item_Cache_Key key;
+   Eina_List *l;
+
+   l = NULL;
+   if (cache->keys)
+     {
+        _key_set(&key, klass, flags);
+        l = eina_hash_find(cache->keys, &key);
+     }
+   if (!l)
+     {
+        cache->misses++;
+        return NULL;
+     }
+
+   entry = eina_list_data_get(l);
+   _entry_unlink(cache, entry, l, l);
+   cache->hits++;
+   return entry;
+}
+
+typedef struct _Elm_Gen_Item_Cache_Victim
+{
+   Eina_List   *l;
+   unsigned int count;
+} Elm_Gen_Item_Cache_Victim;
+
+static Eina_Bool
+_victim_find_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED,
+                void *data, void *fdata)
+{
+   Elm_Gen_Item_Cache_Victim *v = fdata;
+   Eina_List *l = data;
+   unsigned int count = eina_list_count(l);
+
+   if ((count > v->count) ||
+       ((count == v->count) &&
+        (((Elm_Gen_Item_Cache_Entry *)eina_list_last_data_get(l))->serial <
+         ((Elm_Gen_Item_Cache_Entry *)eina_list_last_data_get(v->l))->serial)))
+     {
+        v->l = l;
+        v->count = count;
+     }
+   return EINA_TRUE;
+}
+
+Elm_Gen_Item_Cache_Entry *
+_elm_gen_item_cache_evict(Elm_Gen_Item_Cache *cache)
+{
+   Elm_Gen_Item_Cache_Victim v = { NULL, 0 };
+   Elm_Gen_Item_Cache_Entry *entry;
+   Eina_List *node;
+
+   if (!cache->count) return NULL;
+
+   // there are few item classes, look at all of them
+   eina_hash_foreach(cache->keys, _victim_find_cb, &v);
+   if (!v.l) return NULL;
+
+   node = eina_list_last(v.l);
+   entry = eina_list_data_get(node);
+   _entry_unlink(cache, entry, v.l, node);
+   return entry;
+}
+
+static Eina_Bool
+_key_list_free_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED,
+                  void *data, void *fdata EINA_UNUSED)
+{
+   eina_list_free(data);
+   return EINA_TRUE;
+}
+
+void
+_elm_gen_item_cache_shutdown(Elm_Gen_Item_Cache *cache)
+{
+   if (cache->keys)
+     eina_hash_foreach(cache->keys, _key_list_free_cb, NULL);
+   ELM_SAFE_FREE(cache->keys, eina_hash_free);
+   cache->count = 0;
+}
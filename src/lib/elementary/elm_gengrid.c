@@ -125,35 +125,18 @@ _flush_focus_on_realization(Eo *widget, Elm_Gen_Item *it)
 
 
 //-- item cache handle routine --//
-// push item cache into caches
+// push item cache into caches, keyed by its item style
 static Eina_Bool
 _item_cache_push(Elm_Gengrid_Data *sd, Item_Cache *itc)
 {
    if (!itc || (sd->item_cache_max <= 0))
      return EINA_FALSE;
 
-   sd->item_cache_count++;
-   sd->item_cache =
-     eina_inlist_prepend(sd->item_cache, EINA_INLIST_GET(itc));
+   _elm_gen_item_cache_push(&sd->item_cache, &itc->entry, itc->item_style, 0);
 
    return EINA_TRUE;
 }
 
-// pop item cache from caches
-static Item_Cache *
-_item_cache_pop(Elm_Gengrid_Data *sd, Item_Cache *itc)
-{
-   if ((!itc) || (!sd->item_cache) ||
-       (sd->item_cache_count <= 0))
-     return NULL;
-
-   sd->item_cache =
-     eina_inlist_remove (sd->item_cache, EINA_INLIST_GET(itc));
-   sd->item_cache_count--;
-
-   return itc;
-}
-
 // free one item cache from caches
 static void
 _item_cache_free(Item_Cache *itc)
@@ -176,11 +159,12 @@ _item_cache_clean(Elm_Gengrid_Data *sd)
 {
    evas_event_freeze(evas_object_evas_get(sd->obj));
 
-   while ((sd->item_cache) && (sd->item_cache_count > sd->item_cache_max))
+   while (sd->item_cache.count > sd->item_cache_max)
      {
         Item_Cache *itc =
-           EINA_INLIST_CONTAINER_GET(sd->item_cache->last, Item_Cache);
-        _item_cache_free(_item_cache_pop(sd, itc));
+           (Item_Cache *)_elm_gen_item_cache_evict(&sd->item_cache);
+        if (!itc) break;
+        _item_cache_free(itc);
      }
    evas_event_thaw(evas_object_evas_get(sd->obj));
    evas_event_thaw_eval(evas_object_evas_get(sd->obj));
@@ -210,10 +194,18 @@ _item_cache_add(Elm_Gen_Item *it, Eina_List *contents)
 
    evas_event_freeze(evas_object_evas_get(obj));
    if (sd->item_cache_max > 0)
-     itc = ELM_NEW(Item_Cache);
+     {
+        itc = ELM_NEW(Item_Cache);
+        // stringshared, so the style pointer is the cache key
+        if (itc) itc->item_style = eina_stringshare_add(it->itc->item_style);
+     }
    if (!_item_cache_push(sd, itc))
      {
-        if (itc) ELM_SAFE_FREE(itc, free);
+        if (itc)
+          {
+             eina_stringshare_del(itc->item_style);
+             ELM_SAFE_FREE(itc, free);
+          }
 
         evas_event_thaw(evas_object_evas_get(obj));
         evas_event_thaw_eval(evas_object_evas_get(obj));
@@ -222,7 +214,6 @@ _item_cache_add(Elm_Gen_Item *it, Eina_List *contents)
 
    itc->spacer = it->spacer;
    efl_wref_add(VIEW(it), &itc->base_view);
-   itc->item_style = eina_stringshare_add(it->itc->item_style);
    itc->contents = contents;
 
    if (!it->group)
@@ -266,31 +257,24 @@ _item_cache_find(Elm_Gen_Item *it)
 {
    if (it->item->nocache_once || it->item->nocache) return EINA_FALSE;
 
-   Item_Cache *itc = NULL;
-   Eina_Inlist *l;
+   Item_Cache *itc;
+   Eina_Stringshare *style;
    ELM_GENGRID_DATA_GET_FROM_ITEM(it, sd);
 
-   EINA_INLIST_FOREACH_SAFE(sd->item_cache, l, itc)
-     {
-        if (((!it->itc->item_style) && (!itc->item_style)) ||
-            (it->itc->item_style && itc->item_style &&
-             (!strcmp(it->itc->item_style, itc->item_style))))
-          {
-             itc = _item_cache_pop(sd, itc);
-             if (!itc) continue;
+   style = eina_stringshare_add(it->itc->item_style);
+   itc = (Item_Cache *)_elm_gen_item_cache_take(&sd->item_cache, style, 0);
+   eina_stringshare_del(style);
+   if (!itc) return EINA_FALSE;
 
-             it->spacer = itc->spacer;
-             VIEW_SET(it, itc->base_view);
-             itc->spacer = NULL;
-             efl_wref_del(itc->base_view, &itc->base_view);
-             itc->base_view = NULL;
+   it->spacer = itc->spacer;
+   VIEW_SET(it, itc->base_view);
+   itc->spacer = NULL;
+   efl_wref_del(itc->base_view, &itc->base_view);
+   itc->base_view = NULL;
 
-             itc->contents = eina_list_free(itc->contents);
-             _item_cache_free(itc);
-             return EINA_TRUE;
-          }
-     }
-   return EINA_FALSE;
+   itc->contents = eina_list_free(itc->contents);
+   _item_cache_free(itc);
+   return EINA_TRUE;
 }
 
 //Calculate sum of widths or heights of all items in a row or column
@@ -4165,6 +4149,7 @@ _elm_gengrid_efl_canvas_group_group_del(Eo *obj, Elm_Gengrid_Data *sd)
    _cleanup_custom_size_mode(sd);
 
    _item_cache_zero(sd);
+   _elm_gen_item_cache_shutdown(&sd->item_cache);
    ecore_job_del(sd->calc_job);
 
    efl_canvas_group_del(efl_super(obj, MY_CLASS));
@@ -5546,6 +5531,18 @@ _elm_gengrid_item_efl_access_object_i18n_name_get(const Eo *eo_it, Elm_Gen_Item
    return it->base->accessible_name;
 }
 
+EAPI void
+elm_gengrid_item_cache_stats_get(const Evas_Object *obj, unsigned int *hits, unsigned int *misses)
+{
+   if (hits) *hits = 0;
+   if (misses) *misses = 0;
+   ELM_GENGRID_CHECK(obj);
+   ELM_GENGRID_DATA_GET(obj, sd);
+
+   if (hits) *hits = sd->item_cache.hits;
+   if (misses) *misses = sd->item_cache.misses;
+}
+
 EAPI Elm_Object_Item *
 elm_gengrid_nth_item_get(const Evas_Object *obj, unsigned int nth)
 {
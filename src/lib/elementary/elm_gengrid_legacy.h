@@ -18,6 +18,26 @@
  */
 EAPI Evas_Object                  *elm_gengrid_add(Evas_Object *parent);
 
+#ifdef EFL_BETA_API_SUPPORT
+/**
+ * Get the item cache statistics of a given gengrid widget
+ *
+ * Realized item views are cached when items are unrealized and reused for
+ * items of the same class. A hit is counted each time an item is realized
+ * from the cache, a miss each time the cache has no view for its class.
+ *
+ * This is meant for benchmarks and debugging, it is not part of the stable
+ * API and may change or go away.
+ *
+ * @param obj The gengrid object
+ * @param hits Where to store the number of cache hits, may be @c NULL
+ * @param misses Where to store the number of cache misses, may be @c NULL
+ *
+ * @ingroup Elm_Gengrid
+ */
+EAPI void elm_gengrid_item_cache_stats_get(const Evas_Object *obj, unsigned int *hits, unsigned int *misses);
+#endif
+
 /**
  * Get the nth item, in a given gengrid widget, placed at position @p nth, in
  * its internal items list
@@ -1511,35 +1511,19 @@ _contract_signal_cb(void *data,
 }
 
 //-- item cache handle routine --//
-// push item cache into caches
+// push item cache into caches, keyed by its item class and tree state
 static Eina_Bool
 _item_cache_push(Elm_Genlist_Data *sd, Item_Cache *itc)
 {
    if (!itc || (sd->item_cache_max <= 0))
      return EINA_FALSE;
 
-   sd->item_cache_count++;
-   sd->item_cache =
-     eina_inlist_prepend(sd->item_cache, EINA_INLIST_GET(itc));
+   _elm_gen_item_cache_push(&sd->item_cache, &itc->entry,
+                            itc->item_class, itc->tree);
 
    return EINA_TRUE;
 }
 
-// pop item cache from caches
-static Item_Cache *
-_item_cache_pop(Elm_Genlist_Data *sd, Item_Cache *itc)
-{
-   if (!itc || (!sd->item_cache) ||
-       (sd->item_cache_count <= 0))
-     return NULL;
-
-   sd->item_cache =
-     eina_inlist_remove (sd->item_cache, EINA_INLIST_GET(itc));
-   sd->item_cache_count--;
-
-   return itc;
-}
-
 // free one item cache
 static void
 _item_cache_free(Item_Cache *itc)
@@ -1569,11 +1553,12 @@ _item_cache_clean(Elm_Genlist_Data *sd)
    e = evas_object_evas_get(sd->obj);
    evas_event_freeze(e);
 
-   while ((sd->item_cache) && (sd->item_cache_count > sd->item_cache_max))
+   while (sd->item_cache.count > sd->item_cache_max)
      {
         Item_Cache *itc =
-           EINA_INLIST_CONTAINER_GET(sd->item_cache->last, Item_Cache);
-        _item_cache_free(_item_cache_pop(sd, itc));
+           (Item_Cache *)_elm_gen_item_cache_evict(&sd->item_cache);
+        if (!itc) break;
+        _item_cache_free(itc);
      }
    evas_event_thaw(e);
    evas_event_thaw_eval(e);
@@ -1605,7 +1590,14 @@ _item_cache_add(Elm_Gen_Item *it, Eina_List *contents)
    evas_event_freeze(e);
 
    if (sd->item_cache_max > 0)
-     itc = ELM_NEW(Item_Cache);
+     {
+        itc = ELM_NEW(Item_Cache);
+        if (itc)
+          {
+             itc->item_class = it->itc;
+             if (it->item->type & ELM_GENLIST_ITEM_TREE) itc->tree = 1;
+          }
+     }
 
    if (!_item_cache_push(sd, itc))
      {
@@ -1617,14 +1609,9 @@ _item_cache_add(Elm_Gen_Item *it, Eina_List *contents)
      }
    itc->spacer = it->spacer;
    efl_wref_add(VIEW(it), &itc->base_view);
-   itc->item_class = it->itc;
    itc->contents = contents;
-   if (it->item->type & ELM_GENLIST_ITEM_TREE)
-     {
-        itc->tree = 1;
-        if (it->item->expanded)
-          edje_object_signal_emit(itc->base_view, SIGNAL_CONTRACTED, "elm");
-     }
+   if ((itc->tree) && (it->item->expanded))
+     edje_object_signal_emit(itc->base_view, SIGNAL_CONTRACTED, "elm");
 
    if (it->selected)
      edje_object_signal_emit(itc->base_view, SIGNAL_UNSELECTED, "elm");
@@ -1673,37 +1660,25 @@ _item_cache_find(Elm_Gen_Item *it)
 {
    if (it->item->nocache_once || it->item->nocache) return EINA_FALSE;
 
-   Item_Cache *itc = NULL;
-   Eina_Inlist *l;
+   Item_Cache *itc;
+   Evas_Object *obj;
    Eina_Bool tree = 0;
    ELM_GENLIST_DATA_GET_FROM_ITEM(it, sd);
 
    if (it->item->type & ELM_GENLIST_ITEM_TREE) tree = 1;
-   EINA_INLIST_FOREACH_SAFE(sd->item_cache, l, itc)
-     {
-        Evas_Object *obj;
-
-        if ((itc->tree == tree) &&
-            (((!it->itc) && (!itc->item_class)) ||
-             (it->itc && itc->item_class &&
-              (it->itc == itc->item_class))))
-          {
-             itc = _item_cache_pop(sd, itc);
-             if (!itc) continue;
-
-             it->spacer = itc->spacer;
-             VIEW_SET(it, itc->base_view);
-             itc->spacer = NULL;
-             efl_wref_del(itc->base_view, &itc->base_view);
-             itc->base_view = NULL;
-             EINA_LIST_FREE(itc->contents, obj)
-               elm_widget_tree_unfocusable_set(obj, EINA_FALSE);
-             itc->contents = NULL;
-             _item_cache_free(itc);
-             return EINA_TRUE;
-          }
-     }
-   return EINA_FALSE;
+   itc = (Item_Cache *)_elm_gen_item_cache_take(&sd->item_cache, it->itc, tree);
+   if (!itc) return EINA_FALSE;
+
+   it->spacer = itc->spacer;
+   VIEW_SET(it, itc->base_view);
+   itc->spacer = NULL;
+   efl_wref_del(itc->base_view, &itc->base_view);
+   itc->base_view = NULL;
+   EINA_LIST_FREE(itc->contents, obj)
+     elm_widget_tree_unfocusable_set(obj, EINA_FALSE);
+   itc->contents = NULL;
+   _item_cache_free(itc);
+   return EINA_TRUE;
 }
 
 static Eina_List *
@@ -5866,6 +5841,7 @@ _elm_genlist_efl_canvas_group_group_del(Eo *obj, Elm_Genlist_Data *sd)
 
    elm_genlist_clear(obj);
    _item_cache_zero(sd);
+   _elm_gen_item_cache_shutdown(&sd->item_cache);
 
    efl_canvas_group_del(efl_super(obj, MY_CLASS));
 
@@ -8616,6 +8592,18 @@ _elm_genlist_focus_on_selection_get(const Eo *obj EINA_UNUSED, Elm_Genlist_Data
    return sd->focus_on_selection_enabled;
 }
 
+EAPI void
+elm_genlist_item_cache_stats_get(const Evas_Object *obj, unsigned int *hits, unsigned int *misses)
+{
+   if (hits) *hits = 0;
+   if (misses) *misses = 0;
+   ELM_GENLIST_CHECK(obj);
+   ELM_GENLIST_DATA_GET(obj, sd);
+
+   if (hits) *hits = sd->item_cache.hits;
+   if (misses) *misses = sd->item_cache.misses;
+}
+
 EAPI Elm_Object_Item *
 elm_genlist_nth_item_get(const Evas_Object *obj, unsigned int nth)
 {
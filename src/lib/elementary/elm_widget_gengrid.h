@@ -135,10 +135,9 @@ struct _Elm_Gengrid_Data
    /**< value whether item loop feature is enabled or not. */
    Eina_Bool                             item_loop_enable : 1;
 
-   Eina_Inlist                          *item_cache; /* an inlist of
-                                                      * edje object it
-                                                      * cache. */
-   int                                   item_cache_count;
+   Elm_Gen_Item_Cache                    item_cache; /* edje object it
+                                                      * cache, keyed by
+                                                      * item style. */
    int                                   item_cache_max;
 
    /* custom dimensions may be set for any item.
@@ -181,7 +180,7 @@ struct Elm_Gen_Item_Type
 typedef struct _Item_Cache Item_Cache;
 struct _Item_Cache
 {
-   EINA_INLIST;
+   Elm_Gen_Item_Cache_Entry entry; // must be first
    Evas_Object *base_view, *spacer;
    const char  *item_style; // it->itc->item_style
    Eina_List *contents;
@@ -84,9 +84,9 @@ struct _Elm_Genlist_Data
    Eina_List                            *queue;
    Elm_Gen_Item                         *show_item, *anchor_item, *mode_item,
                                         *reorder_rel, *expanded_item, *pin_item;
-   Eina_Inlist                          *item_cache; /* an inlist of
-                                                      * edje object it
-                                                      * cache. */
+   Elm_Gen_Item_Cache                    item_cache; /* edje object it
+                                                      * cache, keyed by
+                                                      * item class. */
    Evas_Coord                            anchor_y;
    Evas_Coord                            reorder_start_y; /* reorder
                                                            * it's
@@ -108,7 +108,6 @@ struct _Elm_Genlist_Data
    } history[SWIPE_MOVES];
 
    int                                   multi_device;
-   int                                   item_cache_count;
 
    /* maximum number of cached items. (max_items_per_block * 2) */
    int                                   item_cache_max;
@@ -281,7 +280,7 @@ struct _Item_Block
 
 struct _Item_Cache
 {
-   EINA_INLIST;
+   Elm_Gen_Item_Cache_Entry entry; // must be first
 
    Evas_Object *base_view, *spacer;
    const Elm_Genlist_Item_Class  *item_class; // it->itc
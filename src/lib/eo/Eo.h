@@ -1210,6 +1210,16 @@ typedef struct _Efl_Object_Op_Call_Data
    void         *extn4; // for future use to avoid ABI issues
 } Efl_Object_Op_Call_Data;
 
+// per call site cache of the last function resolved, keyed on the vtable
+typedef struct _Efl_Object_Call_Cache
+{
+   unsigned int  seq; // odd while being written
+   unsigned int  generation;
+   const void   *vtable;
+   void         *func;
+   unsigned long off; // data offset in the object, 0 if no data
+} Efl_Object_Call_Cache;
+
 // to pass the internal function call to EFL_FUNC_BODY (as Func parameter)
 #define EFL_FUNC_CALL(...) __VA_ARGS__
 
@@ -1230,14 +1240,15 @@ typedef struct _Efl_Object_Op_Call_Data
 #define EFL_FUNC_COMMON_OP(Obj, Name, DefRet) \
    static Efl_Object_Op ___op = 0; \
    static unsigned int ___generation = 0; \
+   static Efl_Object_Call_Cache ___cache = { 0, 0, NULL, NULL, 0 }; \
    Efl_Object_Op_Call_Data ___call; \
    _Eo_##Name##_func _func_;                                            \
    if (EINA_UNLIKELY((___op == EFL_NOOP) ||                       \
                      (___generation != _efl_object_init_generation))) \
      goto __##Name##_op_create; /* yes a goto - see below */ \
    __##Name##_op_create_done: EINA_HOT; \
-   if (EINA_UNLIKELY(!_efl_object_call_resolve( \
-      (Eo *) Obj, #Name, &___call, ___op, __FILE__, __LINE__))) \
+   if (EINA_UNLIKELY(!_efl_object_call_resolve_cached( \
+      (Eo *) Obj, #Name, &___call, &___cache, ___op, __FILE__, __LINE__))) \
       goto __##Name##_failed; \
    _func_ = (_Eo_##Name##_func) ___call.func;
 
@@ -1359,6 +1370,9 @@ EAPI Efl_Object_Op _efl_object_op_api_id_get(const void *api_func, const Eo *obj
 // gets the real function pointer and the object data
 EAPI Eina_Bool _efl_object_call_resolve(Eo *obj, const char *func_name, Efl_Object_Op_Call_Data *call, Efl_Object_Op op, const char *file, int line);
 
+// same as above, but skips the vtable lookup if the call site cache matches
+EAPI Eina_Bool _efl_object_call_resolve_cached(Eo *obj, const char *func_name, Efl_Object_Op_Call_Data *call, Efl_Object_Call_Cache *cache, Efl_Object_Op op, const char *file, int line);
+
 // end of the eo call barrier, unref the obj
 EAPI void _efl_object_call_end(Efl_Object_Op_Call_Data *call);
 
@@ -43,6 +43,8 @@ EAPI unsigned int _efl_object_init_generation = 1;
 int _eo_log_dom = -1;
 Eina_Thread _efl_object_main_thread;
 static unsigned int efl_del_api_generation = 0;
+/* Bumped whenever a vtable may change after creation, invalidates call caches */
+static unsigned int _efl_object_call_cache_generation = 1;
 static Efl_Object_Op _efl_del_api_op_id = 0;
 static Eina_Hash *class_overrides;
 
@@ -455,8 +457,76 @@ efl_cast(const Eo *eo_id, const Efl_Class *cur_klass)
    return _efl_super_cast(eo_id, cur_klass, EINA_FALSE);
 }
 
+/* The call site caches are shared by all threads, so they are written as a
+ * seqlock: a reader only trusts what it read if seq was even and did not
+ * change meanwhile, a writer that finds seq odd leaves the cache alone. */
+#ifdef __ATOMIC_RELAXED
+static inline Eina_Bool
+_efl_object_call_cache_get(Efl_Object_Call_Cache *cache, const Eo_Vtable *vtable,
+                           _Eo_Object *obj, Efl_Object_Op_Call_Data *call)
+{
+   unsigned int seq;
+   unsigned long off;
+   void *func;
+
+   seq = __atomic_load_n(&cache->seq, __ATOMIC_ACQUIRE);
+   if (EINA_UNLIKELY(seq & 1)) return EINA_FALSE;
+   if (__atomic_load_n(&cache->vtable, __ATOMIC_RELAXED) != vtable) return EINA_FALSE;
+   if (__atomic_load_n(&cache->generation, __ATOMIC_RELAXED) !=
+       __atomic_load_n(&_efl_object_call_cache_generation, __ATOMIC_RELAXED))
+     return EINA_FALSE;
+   func = __atomic_load_n(&cache->func, __ATOMIC_RELAXED);
+   off = __atomic_load_n(&cache->off, __ATOMIC_RELAXED);
+   __atomic_thread_fence(__ATOMIC_ACQUIRE);
+   if (EINA_UNLIKELY(__atomic_load_n(&cache->seq, __ATOMIC_RELAXED) != seq))
+     return EINA_FALSE;
+
+   call->func = func;
+   call->data = off ? ((char *) obj) + off : NULL;
+   return EINA_TRUE;
+}
+
+static inline void
+_efl_object_call_cache_set(Efl_Object_Call_Cache *cache, const Eo_Vtable *vtable,
+                           const _Eo_Object *obj, const Efl_Object_Op_Call_Data *call)
+{
+   unsigned int seq, generation;
+
+   generation = __atomic_load_n(&_efl_object_call_cache_generation, __ATOMIC_RELAXED);
+   seq = __atomic_load_n(&cache->seq, __ATOMIC_RELAXED);
+   if (seq & 1) return;
+   if (!__atomic_compare_exchange_n(&cache->seq, &seq, seq + 1, EINA_FALSE,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+     return;
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+   __atomic_store_n(&cache->vtable, vtable, __ATOMIC_RELAXED);
+   __atomic_store_n(&cache->generation, generation, __ATOMIC_RELAXED);
+   __atomic_store_n(&cache->func, call->func, __ATOMIC_RELAXED);
+   __atomic_store_n(&cache->off, call->data ?
+                    (unsigned long) ((char *) call->data - (char *) obj) : 0,
+                    __ATOMIC_RELAXED);
+   __atomic_store_n(&cache->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static inline void
+_efl_object_call_cache_invalidate(void)
+{
+   __atomic_add_fetch(&_efl_object_call_cache_generation, 1, __ATOMIC_RELAXED);
+}
+#else
+# define _efl_object_call_cache_get(cache, vtable, obj, call) EINA_FALSE
+# define _efl_object_call_cache_set(cache, vtable, obj, call) do {} while (0)
+# define _efl_object_call_cache_invalidate() do {} while (0)
+#endif
+
 EAPI Eina_Bool
 _efl_object_call_resolve(Eo *eo_id, const char *func_name, Efl_Object_Op_Call_Data *call, Efl_Object_Op op, const char *file, int line)
+{
+   return _efl_object_call_resolve_cached(eo_id, func_name, call, NULL, op, file, line);
+}
+
+EAPI Eina_Bool
+_efl_object_call_resolve_cached(Eo *eo_id, const char *func_name, Efl_Object_Op_Call_Data *call, Efl_Object_Call_Cache *cache, Efl_Object_Op op, const char *file, int line)
 {
    const _Efl_Class *klass, *main_klass;
    const _Efl_Class *cur_klass = NULL;
@@ -490,6 +560,10 @@ _efl_object_call_resolve(Eo *eo_id, const char *func_name, Efl_Object_Op_Call_Da
 obj_super_back:
         call->obj = obj;
         _efl_ref(_obj);
+        // super calls resolve from the middle of the hierarchy, never cached
+        if (cache && !cur_klass &&
+            _efl_object_call_cache_get(cache, vtable, obj, call))
+          return EINA_TRUE;
      }
    else
      {
@@ -524,7 +598,12 @@ ok_cur_klass_back:
      {
         call->func = func->func;
 
-        if (is_obj) call->data = _efl_data_scope_get(obj, func->src);
+        if (is_obj)
+          {
+             call->data = _efl_data_scope_get(obj, func->src);
+             if (cache && !cur_klass)
+               _efl_object_call_cache_set(cache, vtable, obj, call);
+          }
 
         return EINA_TRUE;
      }
@@ -1736,6 +1815,7 @@ efl_object_override(Eo *eo_id, const Efl_Object_Ops *ops)
                EO_OPTIONAL_COW_SET(obj, vtable, NULL);
              else
                _vtable_free(vtable);
+             _efl_object_call_cache_invalidate();
              goto err;
           }
 
@@ -1750,6 +1830,8 @@ efl_object_override(Eo *eo_id, const Efl_Object_Ops *ops)
           }
      }
 
+   // override vtables are changed in place, or may reuse a freed address
+   _efl_object_call_cache_invalidate();
    EO_OBJ_DONE(eo_id);
    return EINA_TRUE;
 
@@ -2454,6 +2536,7 @@ efl_object_shutdown(void)
    _eo_log_dom = -1;
 
    ++_efl_object_init_generation;
+   _efl_object_call_cache_invalidate();
 
    eina_shutdown();
    return EINA_FALSE;
@@ -54,6 +54,7 @@ struct _Efl_Object_Data
    Eo_Callback_Description  **callbacks;
    Eina_Inlist               *pending_futures;
    unsigned int               callbacks_count;
+   unsigned int               callbacks_mask[2]; // Bloom filter on event descriptions
 
    unsigned short             event_freeze_count;
    unsigned short             event_cb_efl_event_callback_add_count;
@@ -1203,6 +1204,60 @@ _special_event_count_dec(Eo *obj_id, Efl_Object_Data *pd, const Efl_Callback_Arr
      }
 }
 
+/* Each event description sets one bit of a 64 bits per object mask. As
+ * descriptions are static data, hashing the pointer is enough to spread
+ * them. If the bit of an event is not set, nobody is listening to it and
+ * emission can return without walking the callbacks. */
+static inline unsigned int
+_eo_callback_mask_bit(const Efl_Event_Description *desc)
+{
+   uintptr_t h = ((uintptr_t) desc) >> 3;
+
+   h ^= (h >> 6) ^ (h >> 12) ^ (h >> 18);
+   return h & 0x3f;
+}
+
+static inline void
+_eo_callback_mask_add(Efl_Object_Data *pd, const Efl_Event_Description *desc)
+{
+   unsigned int bit = _eo_callback_mask_bit(desc);
+
+   pd->callbacks_mask[bit >> 5] |= 1U << (bit & 0x1f);
+}
+
+static inline Eina_Bool
+_eo_callback_mask_has(const Efl_Object_Data *pd, const Efl_Event_Description *desc)
+{
+   unsigned int bit = _eo_callback_mask_bit(desc);
+
+   return !!(pd->callbacks_mask[bit >> 5] & (1U << (bit & 0x1f)));
+}
+
+static void
+_eo_callback_mask_update(Efl_Object_Data *pd, const Eo_Callback_Description *cb)
+{
+   const Efl_Callback_Array_Item *it;
+
+   if (cb->func_array)
+     {
+        for (it = cb->items.item_array; it->func; it++)
+          _eo_callback_mask_add(pd, it->desc);
+     }
+   else _eo_callback_mask_add(pd, cb->items.item.desc);
+}
+
+/* Bits can not be removed one by one as they are shared, so the mask is
+ * rebuilt from the remaining callbacks once they are actually removed. */
+static void
+_eo_callback_mask_rebuild(Efl_Object_Data *pd)
+{
+   unsigned int i;
+
+   pd->callbacks_mask[0] = pd->callbacks_mask[1] = 0;
+   for (i = 0; i < pd->callbacks_count; i++)
+     _eo_callback_mask_update(pd, pd->callbacks[i]);
+}
+
 /* Actually remove, doesn't care about walking list, or delete_me */
 static void
 _eo_callback_remove(Eo *obj, Efl_Object_Data *pd, Eo_Callback_Description **cb)
@@ -1245,6 +1300,7 @@ _eo_callback_remove_all(Efl_Object_Data *pd)
    eina_freeq_ptr_main_add(pd->callbacks, free, 0);
    pd->callbacks = NULL;
    pd->callbacks_count = 0;
+   pd->callbacks_mask[0] = pd->callbacks_mask[1] = 0;
    pd->has_destroyed_event_cb = EINA_FALSE;
    pd->event_cb_efl_event_callback_add_count = 0;
    pd->event_cb_efl_event_callback_del_count = 0;
@@ -1296,6 +1352,8 @@ _eo_callbacks_clear(Eo *obj, Efl_Object_Data *pd)
              i++;
           }
      }
+
+   if (remove_callbacks) _eo_callback_mask_rebuild(pd);
 }
 
 static inline unsigned int
@@ -1361,6 +1419,7 @@ _eo_callbacks_sorted_insert(Efl_Object_Data *pd, Eo_Callback_Description *cb)
    *itr = cb;
 
    pd->callbacks_count++;
+   _eo_callback_mask_update(pd, cb);
 
    // Update possible event emissions
    for (frame = pd->event_frame; frame; frame = frame->next)
@@ -1428,7 +1487,10 @@ _efl_object_event_callback_clean(Eo *obj, Efl_Object_Data *pd,
    if (pd->event_frame)
      pd->need_cleaning = EINA_TRUE;
    else
-     _eo_callback_remove(obj, pd, cb);
+     {
+        _eo_callback_remove(obj, pd, cb);
+        _eo_callback_mask_rebuild(pd);
+     }
 
    efl_event_callback_call(obj, EFL_EVENT_CALLBACK_DEL, (void *)array);
 }
@@ -1630,6 +1692,9 @@ _event_callback_call(Eo *obj_id, Efl_Object_Data *pd,
             (pd->event_cb_efl_event_del_count == 0)) return EINA_FALSE;
    else if ((desc == EFL_EVENT_NOREF) &&
             (pd->event_cb_efl_event_noref_count == 0)) return EINA_FALSE;
+   // Legacy comparison may match by name, so only trust the mask otherwise.
+   // No callback matches, which is what a full walk would have found.
+   else if (!legacy_compare && !_eo_callback_mask_has(pd, desc)) return EINA_TRUE;
 
    if (pd->event_frame)
      frame.generation = ((Efl_Event_Callback_Frame*)pd->event_frame)->generation + 1;
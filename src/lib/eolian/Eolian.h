@@ -874,6 +874,27 @@ EAPI const Eolian_Unit *eolian_state_file_parse(Eolian_State *state, const char
  */
 EAPI const Eolian_Unit *eolian_state_file_path_parse(Eolian_State *state, const char *filepath);
 
+/*
+ * @brief Set the directory to cache parsed files in.
+ *
+ * Every successfully parsed unit is written into the directory, keyed on
+ * the path and the contents of its file. Parsing a file again later, in
+ * this or another state, loads the unit from there instead when neither
+ * the file nor any of its dependencies changed in the meantime, which
+ * saves lexing and validating it all over again. Anything wrong with a
+ * cached unit makes it be parsed the usual way.
+ *
+ * The directory has to exist. Set NULL to stop using the cache.
+ *
+ * @param[in] state The Eolian state.
+ * @param[in] dir The cache directory or NULL.
+ *
+ * @see eolian_state_file_parse
+ *
+ * @ingroup Eolian
+ */
+EAPI void eolian_state_cache_dir_set(Eolian_State *state, const char *dir);
+
 /*
  * @brief Parse all known eo files.
  *
@@ -0,0 +1,1676 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <Eina.h>
+#include "eolian_database.h"
+
+/* Every unit gets a cache file of its own, named after the file of the
+ * unit and keyed on its path and contents. Units depending on each other
+ * can only be loaded together, so such a group is written as a whole into
+ * the file of each of its units. Validation resolves things out of the
+ * dependencies, so the entry also records the contents of all of them and
+ * is only used while none of them changed.
+ *
+ * Objects of the group refer to each other by their index in the object
+ * table plus one, zero standing for NULL. Objects of other units are
+ * looked up by name when loading, going through their owner for members
+ * like functions and implements; the units they belong to are loaded
+ * first. Numbers are in the host byte order and the header carries the
+ * sizes of the database structures, so a cache written by a different
+ * build is never used.
+ */
+
+#define CACHE_MAGIC "EOLCACHE"
+/* bump whenever the layout of the records changes */
+#define CACHE_VERSION 3
+#define CACHE_SUFFIX ".eoc"
+
+#define CACHE_NULL 0xFFFFFFFF
+/* the id refers to the external object table */
+#define CACHE_EXTERNAL 0x80000000
+
+#define HASH_INIT 0xcbf29ce484222325ULL
+
+typedef enum
+{
+   CACHE_MEMBER_NONE = 0,
+   CACHE_MEMBER_METHOD,
+   CACHE_MEMBER_PROPERTY,
+   CACHE_MEMBER_IMPLEMENT,
+   CACHE_MEMBER_ENUM_FIELD, /* value of the nth field of an enum */
+   CACHE_MEMBER_VALUE /* value of a constant or global */
+} Cache_Member;
+
+typedef struct _Cache_File
+{
+   uint64_t hash;
+} Cache_File;
+
+/* the same record functions write the objects out and read them back */
+typedef struct _Cache_Io
+{
+   /* writing */
+   Eina_Binbuf *buf;
+   Eina_Array *units;
+   Eina_Hash *deps;
+   Eina_Hash *ids;
+   Eina_Array *objs_w;
+   Eina_Array *exts_w;
+   /* reading */
+   const unsigned char *p;
+   const unsigned char *end;
+   Eolian_Object **objs;
+   unsigned char *kinds;
+   unsigned int nobjs;
+   const Eolian_Object **exts;
+   unsigned int nexts;
+   Eina_Bool fill; /* EINA_FALSE while only checking */
+   Eina_Bool fail;
+} Cache_Io;
+
+typedef union
+{
+   Eolian_Object base;
+   Eolian_Class cl;
+   Eolian_Typedecl tdecl;
+   Eolian_Struct_Type_Field sfield;
+   Eolian_Enum_Type_Field efield;
+   Eolian_Type tp;
+   Eolian_Variable var;
+   Eolian_Expression expr;
+   Eolian_Function fid;
+   Eolian_Function_Parameter param;
+   Eolian_Event ev;
+   Eolian_Part part;
+   Eolian_Implement impl;
+   Eolian_Constructor ctor;
+   Eolian_Documentation doc;
+} Cache_Scratch;
+
+static uint64_t
+_hash(uint64_t h, const void *data, size_t len)
+{
+   const unsigned char *p = data;
+   uint64_t w;
+   /* FNV-1a over whole words, with a shift so the high bits count too;
+    * it only has to notice changes, not resist anyone */
+   for (; len >= sizeof(w); len -= sizeof(w), p += sizeof(w))
+     {
+        memcpy(&w, p, sizeof(w));
+        h = (h ^ w) * 0x100000001b3ULL;
+        h ^= h >> 29;
+     }
+   while (len--)
+     {
+        h ^= *p++;
+        h *= 0x100000001b3ULL;
+     }
+   return h;
+}
+
+static Eina_Bool
+_file_hash(Eolian_State *state, const char *path, uint64_t *hash)
+{
+   /* the files are taken not to change while the state is in use, the
+    * same as the file names found when scanning, so each is read once */
+   Cache_File *cf = eina_hash_find(state->cache_files, path);
+   if (cf)
+     {
+        *hash = cf->hash;
+        return EINA_TRUE;
+     }
+
+   Eina_File *f = eina_file_open(path, EINA_FALSE);
+   if (!f)
+     return EINA_FALSE;
+
+   size_t size = eina_file_size_get(f);
+   void *data = size ? eina_file_map_all(f, EINA_FILE_SEQUENTIAL) : NULL;
+   if (size && !data)
+     {
+        eina_file_close(f);
+        return EINA_FALSE;
+     }
+   cf = malloc(sizeof(Cache_File));
+   if (cf)
+     {
+        cf->hash = _hash(HASH_INIT, data, size);
+        eina_hash_add(state->cache_files, path, cf);
+     }
+   if (data) eina_file_map_free(f, data);
+   eina_file_close(f);
+   if (!cf)
+     return EINA_FALSE;
+   *hash = cf->hash;
+   return EINA_TRUE;
+}
+
+static char *
+_cache_path(const Eolian_State *state, const char *fname, const char *path,
+            uint64_t hash)
+{
+   uint64_t key = _hash(HASH_INIT, path, strlen(path));
+   key = _hash(key, &hash, sizeof(hash));
+   Eina_Strbuf *buf = eina_strbuf_new();
+   eina_strbuf_append_printf(buf, "%s/%s-%016llx" CACHE_SUFFIX,
+                             state->cache_dir, fname, (unsigned long long)key);
+   return eina_strbuf_release(buf);
+}
+
+static const char *
+_file_path_get(const Eolian_State *state, const char *fname)
+{
+   if (eina_str_has_suffix(fname, ".eot"))
+     return eina_hash_find(state->filenames_eot, fname);
+   return eina_hash_find(state->filenames_eo, fname);
+}
+
+static size_t
+_object_size(Eolian_Object_Type kind)
+{
+   switch (kind)
+     {
+      case EOLIAN_OBJECT_CLASS:
+        return sizeof(Eolian_Class);
+      case EOLIAN_OBJECT_TYPEDECL:
+        return sizeof(Eolian_Typedecl);
+      case EOLIAN_OBJECT_STRUCT_FIELD:
+        return sizeof(Eolian_Struct_Type_Field);
+      case EOLIAN_OBJECT_ENUM_FIELD:
+        return sizeof(Eolian_Enum_Type_Field);
+      case EOLIAN_OBJECT_TYPE:
+        return sizeof(Eolian_Type);
+      case EOLIAN_OBJECT_VARIABLE:
+        return sizeof(Eolian_Variable);
+      case EOLIAN_OBJECT_EXPRESSION:
+        return sizeof(Eolian_Expression);
+      case EOLIAN_OBJECT_FUNCTION:
+        return sizeof(Eolian_Function);
+      case EOLIAN_OBJECT_FUNCTION_PARAMETER:
+        return sizeof(Eolian_Function_Parameter);
+      case EOLIAN_OBJECT_EVENT:
+        return sizeof(Eolian_Event);
+      case EOLIAN_OBJECT_PART:
+        return sizeof(Eolian_Part);
+      case EOLIAN_OBJECT_IMPLEMENT:
+        return sizeof(Eolian_Implement);
+      case EOLIAN_OBJECT_CONSTRUCTOR:
+        return sizeof(Eolian_Constructor);
+      case EOLIAN_OBJECT_DOCUMENTATION:
+        return sizeof(Eolian_Documentation);
+      default:
+        return 0;
+     }
+}
+
+static Eina_Bool
+_object_is_top(Eolian_Object_Type kind)
+{
+   return (kind == EOLIAN_OBJECT_CLASS) || (kind == EOLIAN_OBJECT_TYPEDECL)
+       || (kind == EOLIAN_OBJECT_VARIABLE);
+}
+
+static void
+_header_append(Eina_Binbuf *buf)
+{
+   unsigned int v[3 + EOLIAN_OBJECT_DOCUMENTATION];
+   int kind;
+
+   v[0] = CACHE_VERSION;
+   v[1] = sizeof(void *);
+   v[2] = sizeof(Eolian_Value_Union);
+   for (kind = EOLIAN_OBJECT_CLASS; kind <= EOLIAN_OBJECT_DOCUMENTATION; ++kind)
+     v[2 + kind] = _object_size(kind);
+
+   eina_binbuf_append_length(buf, (const unsigned char *)CACHE_MAGIC,
+                             sizeof(CACHE_MAGIC) - 1);
+   eina_binbuf_append_length(buf, (const unsigned char *)v, sizeof(v));
+}
+
+static void
+_io_raw(Cache_Io *io, void *data, size_t len)
+{
+   if (io->buf)
+     {
+        eina_binbuf_append_length(io->buf, data, len);
+        return;
+     }
+   if (io->fail || ((size_t)(io->end - io->p) < len))
+     {
+        io->fail = EINA_TRUE;
+        memset(data, 0, len);
+        return;
+     }
+   memcpy(data, io->p, len);
+   io->p += len;
+}
+
+static void
+_io_u32(Cache_Io *io, unsigned int *v)
+{
+   _io_raw(io, v, sizeof(*v));
+}
+
+/* never writes to the objects being written out */
+#define CACHE_IO_VAL(io, val) \
+   do { \
+      unsigned int v_ = (unsigned int)(val); \
+      _io_u32(io, &v_); \
+      if (!(io)->buf) (val) = v_; \
+   } while (0)
+
+/* written strings need not be shared, the file paths are not */
+static void
+_io_str(Cache_Io *io, Eina_Stringshare **str)
+{
+   unsigned int len;
+   if (io->buf)
+     {
+        len = *str ? (unsigned int)strlen(*str) : CACHE_NULL;
+        _io_u32(io, &len);
+        if (*str)
+          eina_binbuf_append_length(io->buf, (const unsigned char *)*str, len);
+        return;
+     }
+   *str = NULL;
+   _io_u32(io, &len);
+   if (io->fail || (len == CACHE_NULL))
+     return;
+   if ((size_t)(io->end - io->p) < len)
+     {
+        io->fail = EINA_TRUE;
+        return;
+     }
+   if (io->fill)
+     *str = eina_stringshare_add_length((const char *)io->p, len);
+   io->p += len;
+}
+
+/* expressions from other units are what a name in an expression refers
+ * to, that is the value of an enum field or of a variable */
+static Eina_Bool
+_ext_value(const Eolian_Object *obj, const Eolian_Object **owner,
+           Cache_Member *member, unsigned int *idx)
+{
+   const Eolian_Typedecl *tp;
+   const Eolian_Variable *var;
+   const Eina_List *l;
+   const Eolian_Enum_Type_Field *field;
+   Eina_Iterator *itr;
+   Eina_Bool found = EINA_FALSE;
+
+   itr = eina_hash_iterator_data_new(obj->unit->enums);
+   EINA_ITERATOR_FOREACH(itr, tp)
+     {
+        if (tp->base.unit != obj->unit)
+          continue;
+        *idx = 0;
+        EINA_LIST_FOREACH(tp->field_list, l, field)
+          {
+             if ((const Eolian_Object *)field->value == obj)
+               {
+                  *owner = &tp->base;
+                  *member = CACHE_MEMBER_ENUM_FIELD;
+                  found = EINA_TRUE;
+                  break;
+               }
+             ++*idx;
+          }
+        if (found)
+          break;
+     }
+   eina_iterator_free(itr);
+   if (found)
+     return EINA_TRUE;
+
+   *idx = 0;
+   itr = eina_hash_iterator_data_new(obj->unit->constants);
+   EINA_ITERATOR_FOREACH(itr, var)
+     if ((var->base.unit == obj->unit)
+         && ((const Eolian_Object *)var->value == obj))
+       {
+          *owner = &var->base;
+          *member = CACHE_MEMBER_VALUE;
+          found = EINA_TRUE;
+          break;
+       }
+   eina_iterator_free(itr);
+   return found;
+}
+
+static Eina_Bool
+_ext_member(const Eolian_Object *obj, const Eolian_Object **owner,
+            Cache_Member *member, unsigned int *idx)
+{
+   const Eolian_Class *cl;
+   const Eina_List *l, *ll;
+   const void *data;
+
+   *owner = NULL;
+   *member = CACHE_MEMBER_NONE;
+   *idx = 0;
+   switch (obj->type)
+     {
+      case EOLIAN_OBJECT_FUNCTION:
+        cl = ((const Eolian_Function *)obj)->klass;
+        if (!cl) return EINA_FALSE;
+        *member = CACHE_MEMBER_METHOD;
+        l = cl->methods;
+        if (!eina_list_data_find(l, obj))
+          {
+             *member = CACHE_MEMBER_PROPERTY;
+             l = cl->properties;
+          }
+        break;
+      case EOLIAN_OBJECT_IMPLEMENT:
+        cl = ((const Eolian_Implement *)obj)->implklass;
+        if (!cl) return EINA_FALSE;
+        *member = CACHE_MEMBER_IMPLEMENT;
+        l = cl->implements;
+        break;
+      case EOLIAN_OBJECT_EXPRESSION:
+        return _ext_value(obj, owner, member, idx);
+      default:
+        return _object_is_top(obj->type);
+     }
+   if (cl->base.unit != obj->unit)
+     return EINA_FALSE;
+   *owner = &cl->base;
+   EINA_LIST_FOREACH(l, ll, data)
+     {
+        if (data == obj)
+          return EINA_TRUE;
+        ++*idx;
+     }
+   return EINA_FALSE;
+}
+
+static int
+_group_idx(Eina_Array *units, const Eolian_Unit *unit)
+{
+   unsigned int i;
+   for (i = 0; i < eina_array_count(units); ++i)
+     if (eina_array_data_get(units, i) == unit)
+       return i;
+   return -1;
+}
+
+static unsigned int
+_io_id_get(Cache_Io *io, const Eolian_Object *obj)
+{
+   unsigned int id = (unsigned int)(uintptr_t)eina_hash_find(io->ids, &obj);
+   if (id)
+     return id;
+
+   if (_group_idx(io->units, obj->unit) >= 0)
+     {
+        eina_array_push(io->objs_w, obj);
+        id = eina_array_count(io->objs_w);
+     }
+   else
+     {
+        const Eolian_Object *owner;
+        Cache_Member member;
+        unsigned int idx;
+        /* only units loaded before this one can be referred to */
+        if (!obj->unit || !obj->unit->file
+            || (eina_hash_find(io->deps, obj->unit->file) != obj->unit)
+            || !_ext_member(obj, &owner, &member, &idx))
+          {
+             io->fail = EINA_TRUE;
+             return 0;
+          }
+        eina_array_push(io->exts_w, obj);
+        id = CACHE_EXTERNAL | (eina_array_count(io->exts_w) - 1);
+     }
+   eina_hash_add(io->ids, &obj, (void *)(uintptr_t)id);
+   return id;
+}
+
+static void
+_io_obj(Cache_Io *io, const Eolian_Object **obj, Eolian_Object_Type kind)
+{
+   unsigned int id = 0;
+   if (io->buf)
+     {
+        if (*obj && ((*obj)->type != kind))
+          io->fail = EINA_TRUE;
+        else if (*obj)
+          id = _io_id_get(io, *obj);
+        _io_u32(io, &id);
+        return;
+     }
+   *obj = NULL;
+   _io_u32(io, &id);
+   if (!id || io->fail)
+     return;
+   if (id & CACHE_EXTERNAL)
+     {
+        id &= ~CACHE_EXTERNAL;
+        if ((id >= io->nexts) || (io->exts[id]->type != kind))
+          io->fail = EINA_TRUE;
+        else
+          *obj = io->exts[id];
+        return;
+     }
+   if ((id > io->nobjs) || (io->kinds[id - 1] != kind))
+     io->fail = EINA_TRUE;
+   else if (io->fill)
+     *obj = io->objs[id - 1];
+}
+
+#define CACHE_IO_OBJ(io, field, tp) \
+   do { \
+      const Eolian_Object *o_ = (const Eolian_Object *)(field); \
+      _io_obj(io, &o_, EOLIAN_OBJECT_##tp); \
+      if (!(io)->buf) (field) = (void *)o_; \
+   } while (0)
+
+static void
+_io_list(Cache_Io *io, Eina_List **list, Eolian_Object_Type kind)
+{
+   const Eolian_Object *obj;
+   unsigned int n = eina_list_count(*list);
+   CACHE_IO_VAL(io, n);
+   if (io->buf)
+     {
+        Eina_List *l;
+        EINA_LIST_FOREACH(*list, l, obj)
+          _io_obj(io, &obj, kind);
+        return;
+     }
+   *list = NULL;
+   while (n-- && !io->fail)
+     {
+        _io_obj(io, &obj, kind);
+        if (io->fill)
+          *list = eina_list_append(*list, obj);
+     }
+}
+
+static void
+_io_base(Cache_Io *io, Eolian_Object *obj)
+{
+   unsigned int flags = obj->validated | (obj->is_beta << 1) | (!!obj->file << 2);
+   /* top level objects get referenced as they are registered again */
+   int refcount = _object_is_top(obj->type) ? 0 : obj->refcount;
+
+   if (io->buf && obj->file && (obj->file != obj->unit->file))
+     io->fail = EINA_TRUE;
+
+   _io_str(io, &obj->name);
+   _io_str(io, &obj->c_name);
+   CACHE_IO_VAL(io, obj->line);
+   CACHE_IO_VAL(io, obj->column);
+   CACHE_IO_VAL(io, refcount);
+   CACHE_IO_VAL(io, flags);
+   if (io->buf)
+     return;
+
+   obj->refcount = refcount;
+   obj->validated = !!(flags & 1);
+   obj->is_beta = !!(flags & 2);
+   if (!io->fill || !(flags & 4))
+     return;
+   /* documentation borrows the file name */
+   if (obj->type == EOLIAN_OBJECT_DOCUMENTATION)
+     obj->file = obj->unit->file;
+   else
+     obj->file = eina_stringshare_ref(obj->unit->file);
+}
+
+static void
+_io_doc(Cache_Io *io, Eolian_Documentation *doc)
+{
+   void *data;
+   unsigned int v, n = eina_list_count(doc->ref_dbg);
+
+   _io_str(io, &doc->summary);
+   _io_str(io, &doc->description);
+   _io_str(io, &doc->since);
+   CACHE_IO_VAL(io, n);
+   if (io->buf)
+     {
+        Eina_List *l;
+        EINA_LIST_FOREACH(doc->ref_dbg, l, data)
+          {
+             v = (unsigned int)(size_t)data;
+             _io_u32(io, &v);
+          }
+        return;
+     }
+   doc->ref_dbg = NULL;
+   while (n-- && !io->fail)
+     {
+        _io_u32(io, &v);
+        if (io->fill)
+          doc->ref_dbg = eina_list_append(doc->ref_dbg, (void *)(size_t)v);
+     }
+}
+
+static void
+_io_class(Cache_Io *io, Eolian_Class *cl)
+{
+   /* parent and inherits are still names otherwise */
+   if (io->buf && !cl->base.validated)
+     io->fail = EINA_TRUE;
+
+   CACHE_IO_VAL(io, cl->type);
+   CACHE_IO_OBJ(io, cl->doc, DOCUMENTATION);
+   _io_str(io, &cl->c_prefix);
+   _io_str(io, &cl->ev_prefix);
+   _io_str(io, &cl->data_type);
+   CACHE_IO_OBJ(io, cl->parent, CLASS);
+   _io_list(io, &cl->extends, EOLIAN_OBJECT_CLASS);
+   _io_list(io, &cl->properties, EOLIAN_OBJECT_FUNCTION);
+   _io_list(io, &cl->methods, EOLIAN_OBJECT_FUNCTION);
+   _io_list(io, &cl->implements, EOLIAN_OBJECT_IMPLEMENT);
+   _io_list(io, &cl->constructors, EOLIAN_OBJECT_CONSTRUCTOR);
+   _io_list(io, &cl->events, EOLIAN_OBJECT_EVENT);
+   _io_list(io, &cl->parts, EOLIAN_OBJECT_PART);
+   _io_list(io, &cl->composite, EOLIAN_OBJECT_CLASS);
+   _io_list(io, &cl->requires, EOLIAN_OBJECT_CLASS);
+   _io_list(io, &cl->callables, EOLIAN_OBJECT_IMPLEMENT);
+   CACHE_IO_VAL(io, cl->class_ctor_enable);
+   CACHE_IO_VAL(io, cl->class_dtor_enable);
+}
+
+static void
+_io_function(Cache_Io *io, Eolian_Function *fid)
+{
+   unsigned int has_set = !!fid->set_base.file;
+
+   CACHE_IO_VAL(io, has_set);
+   if (has_set)
+     {
+        CACHE_IO_VAL(io, fid->set_base.line);
+        CACHE_IO_VAL(io, fid->set_base.column);
+        if (io->fill)
+          {
+             fid->set_base.unit = fid->base.unit;
+             fid->set_base.file = eina_stringshare_ref(fid->base.unit->file);
+             fid->set_base.type = EOLIAN_OBJECT_FUNCTION;
+          }
+     }
+   _io_list(io, &fid->prop_values, EOLIAN_OBJECT_FUNCTION_PARAMETER);
+   _io_list(io, &fid->prop_values_get, EOLIAN_OBJECT_FUNCTION_PARAMETER);
+   _io_list(io, &fid->prop_values_set, EOLIAN_OBJECT_FUNCTION_PARAMETER);
+   _io_list(io, &fid->prop_keys, EOLIAN_OBJECT_FUNCTION_PARAMETER);
+   _io_list(io, &fid->prop_keys_get, EOLIAN_OBJECT_FUNCTION_PARAMETER);
+   _io_list(io, &fid->prop_keys_set, EOLIAN_OBJECT_FUNCTION_PARAMETER);
+   CACHE_IO_VAL(io, fid->type);
+   CACHE_IO_VAL(io, fid->get_scope);
+   CACHE_IO_VAL(io, fid->set_scope);
+   CACHE_IO_OBJ(io, fid->get_ret_type, TYPE);
+   CACHE_IO_OBJ(io, fid->set_ret_type, TYPE);
+   CACHE_IO_OBJ(io, fid->get_ret_val, EXPRESSION);
+   CACHE_IO_OBJ(io, fid->set_ret_val, EXPRESSION);
+   CACHE_IO_OBJ(io, fid->impl, IMPLEMENT);
+   CACHE_IO_OBJ(io, fid->get_return_doc, DOCUMENTATION);
+   CACHE_IO_OBJ(io, fid->set_return_doc, DOCUMENTATION);
+   CACHE_IO_VAL(io, fid->obj_is_const);
+   CACHE_IO_VAL(io, fid->get_return_no_unused);
+   CACHE_IO_VAL(io, fid->set_return_no_unused);
+   CACHE_IO_VAL(io, fid->is_class);
+   /* ctor_of is filled in as the classes using the function come in */
+   CACHE_IO_OBJ(io, fid->klass, CLASS);
+}
+
+static void
+_io_part(Cache_Io *io, Eolian_Part *part)
+{
+   /* the class is still a name otherwise */
+   if (io->buf && !part->base.validated)
+     io->fail = EINA_TRUE;
+
+   CACHE_IO_OBJ(io, part->klass, CLASS);
+   CACHE_IO_OBJ(io, part->doc, DOCUMENTATION);
+}
+
+static void
+_io_param(Cache_Io *io, Eolian_Function_Parameter *param)
+{
+   CACHE_IO_OBJ(io, param->type, TYPE);
+   CACHE_IO_OBJ(io, param->value, EXPRESSION);
+   CACHE_IO_OBJ(io, param->doc, DOCUMENTATION);
+   CACHE_IO_VAL(io, param->param_dir);
+   CACHE_IO_VAL(io, param->optional);
+}
+
+static void
+_io_type(Cache_Io *io, Eolian_Type *tp)
+{
+   CACHE_IO_VAL(io, tp->type);
+   CACHE_IO_VAL(io, tp->btype);
+   CACHE_IO_OBJ(io, tp->base_type, TYPE);
+   CACHE_IO_OBJ(io, tp->next_type, TYPE);
+   _io_str(io, &tp->freefunc);
+   if (tp->type == EOLIAN_TYPE_CLASS)
+     CACHE_IO_OBJ(io, tp->klass, CLASS);
+   else
+     CACHE_IO_OBJ(io, tp->tdecl, TYPEDECL);
+   CACHE_IO_VAL(io, tp->is_const);
+   CACHE_IO_VAL(io, tp->is_ptr);
+   CACHE_IO_VAL(io, tp->owned);
+}
+
+static void
+_io_typedecl(Cache_Io *io, Eolian_Typedecl *tp)
+{
+   CACHE_IO_VAL(io, tp->type);
+   CACHE_IO_OBJ(io, tp->base_type, TYPE);
+   /* the field hash is rebuilt from the list once the fields are read */
+   _io_list(io, &tp->field_list, (tp->type == EOLIAN_TYPEDECL_ENUM)
+            ? EOLIAN_OBJECT_ENUM_FIELD : EOLIAN_OBJECT_STRUCT_FIELD);
+   CACHE_IO_OBJ(io, tp->function_pointer, FUNCTION);
+   CACHE_IO_OBJ(io, tp->doc, DOCUMENTATION);
+   _io_str(io, &tp->legacy);
+   _io_str(io, &tp->freefunc);
+   CACHE_IO_VAL(io, tp->is_extern);
+   if (!io->buf && ((tp->type < EOLIAN_TYPEDECL_STRUCT)
+                    || (tp->type > EOLIAN_TYPEDECL_FUNCTION_POINTER)))
+     io->fail = EINA_TRUE;
+}
+
+static void
+_io_implement(Cache_Io *io, Eolian_Implement *impl)
+{
+   CACHE_IO_OBJ(io, impl->klass, CLASS);
+   CACHE_IO_OBJ(io, impl->implklass, CLASS);
+   CACHE_IO_OBJ(io, impl->foo_id, FUNCTION);
+   CACHE_IO_OBJ(io, impl->common_doc, DOCUMENTATION);
+   CACHE_IO_OBJ(io, impl->get_doc, DOCUMENTATION);
+   CACHE_IO_OBJ(io, impl->set_doc, DOCUMENTATION);
+   CACHE_IO_VAL(io, impl->is_prop_get);
+   CACHE_IO_VAL(io, impl->is_prop_set);
+   CACHE_IO_VAL(io, impl->get_pure_virtual);
+   CACHE_IO_VAL(io, impl->set_pure_virtual);
+   CACHE_IO_VAL(io, impl->get_auto);
+   CACHE_IO_VAL(io, impl->set_auto);
+   CACHE_IO_VAL(io, impl->get_empty);
+   CACHE_IO_VAL(io, impl->set_empty);
+}
+
+static void
+_io_constructor(Cache_Io *io, Eolian_Constructor *ctor)
+{
+   CACHE_IO_OBJ(io, ctor->klass, CLASS);
+   CACHE_IO_VAL(io, ctor->is_optional);
+   CACHE_IO_VAL(io, ctor->is_ctor_param);
+}
+
+static void
+_io_event(Cache_Io *io, Eolian_Event *ev)
+{
+   CACHE_IO_OBJ(io, ev->doc, DOCUMENTATION);
+   CACHE_IO_OBJ(io, ev->type, TYPE);
+   CACHE_IO_OBJ(io, ev->klass, CLASS);
+   CACHE_IO_VAL(io, ev->scope);
+   CACHE_IO_VAL(io, ev->is_hot);
+   CACHE_IO_VAL(io, ev->is_restart);
+}
+
+static void
+_io_struct_field(Cache_Io *io, Eolian_Struct_Type_Field *field)
+{
+   CACHE_IO_OBJ(io, field->type, TYPE);
+   CACHE_IO_OBJ(io, field->doc, DOCUMENTATION);
+}
+
+static void
+_io_enum_field(Cache_Io *io, Eolian_Enum_Type_Field *field)
+{
+   CACHE_IO_OBJ(io, field->base_enum, TYPEDECL);
+   CACHE_IO_OBJ(io, field->value, EXPRESSION);
+   CACHE_IO_OBJ(io, field->doc, DOCUMENTATION);
+   CACHE_IO_VAL(io, field->is_public_value);
+}
+
+static void
+_io_expr(Cache_Io *io, Eolian_Expression *expr)
+{
+   CACHE_IO_VAL(io, expr->type);
+   switch (expr->type)
+     {
+      case EOLIAN_EXPR_BINARY:
+        CACHE_IO_VAL(io, expr->binop);
+        CACHE_IO_OBJ(io, expr->lhs, EXPRESSION);
+        CACHE_IO_OBJ(io, expr->rhs, EXPRESSION);
+        break;
+      case EOLIAN_EXPR_UNARY:
+        CACHE_IO_VAL(io, expr->unop);
+        CACHE_IO_OBJ(io, expr->expr, EXPRESSION);
+        break;
+      case EOLIAN_EXPR_STRING:
+        _io_str(io, &expr->value.s);
+        break;
+      case EOLIAN_EXPR_NAME:
+        _io_str(io, &expr->value.s);
+        /* what the name was resolved to by the validation */
+        CACHE_IO_OBJ(io, expr->expr, EXPRESSION);
+        break;
+      default:
+        _io_raw(io, &expr->value, sizeof(expr->value));
+        break;
+     }
+   CACHE_IO_VAL(io, expr->weak_lhs);
+   CACHE_IO_VAL(io, expr->weak_rhs);
+}
+
+static void
+_io_var(Cache_Io *io, Eolian_Variable *var)
+{
+   CACHE_IO_VAL(io, var->type);
+   CACHE_IO_OBJ(io, var->base_type, TYPE);
+   CACHE_IO_OBJ(io, var->value, EXPRESSION);
+   CACHE_IO_OBJ(io, var->doc, DOCUMENTATION);
+   CACHE_IO_VAL(io, var->is_extern);
+   if (!io->buf && (var->type != EOLIAN_VAR_CONSTANT)
+       && (var->type != EOLIAN_VAR_GLOBAL))
+     io->fail = EINA_TRUE;
+}
+
+static void
+_io_object(Cache_Io *io, Eolian_Object *obj)
+{
+   _io_base(io, obj);
+   switch (obj->type)
+     {
+      case EOLIAN_OBJECT_CLASS:
+        _io_class(io, (Eolian_Class *)obj);
+        break;
+      case EOLIAN_OBJECT_TYPEDECL:
+        _io_typedecl(io, (Eolian_Typedecl *)obj);
+        break;
+      case EOLIAN_OBJECT_STRUCT_FIELD:
+        _io_struct_field(io, (Eolian_Struct_Type_Field *)obj);
+        break;
+      case EOLIAN_OBJECT_ENUM_FIELD:
+        _io_enum_field(io, (Eolian_Enum_Type_Field *)obj);
+        break;
+      case EOLIAN_OBJECT_TYPE:
+        _io_type(io, (Eolian_Type *)obj);
+        break;
+      case EOLIAN_OBJECT_VARIABLE:
+        _io_var(io, (Eolian_Variable *)obj);
+        break;
+      case EOLIAN_OBJECT_EXPRESSION:
+        _io_expr(io, (Eolian_Expression *)obj);
+        break;
+      case EOLIAN_OBJECT_FUNCTION:
+        _io_function(io, (Eolian_Function *)obj);
+        break;
+      case EOLIAN_OBJECT_FUNCTION_PARAMETER:
+        _io_param(io, (Eolian_Function_Parameter *)obj);
+        break;
+      case EOLIAN_OBJECT_EVENT:
+        _io_event(io, (Eolian_Event *)obj);
+        break;
+      case EOLIAN_OBJECT_PART:
+        _io_part(io, (Eolian_Part *)obj);
+        break;
+      case EOLIAN_OBJECT_IMPLEMENT:
+        _io_implement(io, (Eolian_Implement *)obj);
+        break;
+      case EOLIAN_OBJECT_CONSTRUCTOR:
+        _io_constructor(io, (Eolian_Constructor *)obj);
+        break;
+      case EOLIAN_OBJECT_DOCUMENTATION:
+        _io_doc(io, (Eolian_Documentation *)obj);
+        break;
+      default:
+        io->fail = EINA_TRUE;
+        break;
+     }
+}
+
+/* what validation does for the class in _db_fill_implements and
+ * _db_fill_ctors, for the functions to know the classes they construct
+ */
+static void
+_class_ctors_register(Eolian_Class *cl)
+{
+   Eolian_Implement *impl;
+   Eolian_Constructor *ctor;
+   Eina_List *l;
+
+   EINA_LIST_FOREACH(cl->implements, l, impl)
+     if ((impl->klass != cl)
+         && eolian_function_is_constructor(impl->foo_id, impl->klass))
+       database_function_constructor_add((Eolian_Function *)impl->foo_id, cl);
+
+   EINA_LIST_FOREACH(cl->constructors, l, ctor)
+     {
+        const Eolian_Function *cfunc = eolian_constructor_function_get(ctor);
+        if (cfunc)
+          database_function_constructor_add((Eolian_Function *)cfunc,
+                                            ctor->klass);
+     }
+}
+
+typedef struct _Deps_Data
+{
+   Eina_Array *units;
+   Eina_Hash *deps;
+} Deps_Data;
+
+static Eina_Bool
+_deps_collect_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED,
+                 void *data, void *fdata)
+{
+   Deps_Data *dd = fdata;
+   Eolian_Unit *unit = data;
+   if ((_group_idx(dd->units, unit) >= 0) || eina_hash_find(dd->deps, unit->file))
+     return EINA_TRUE;
+   eina_hash_add(dd->deps, unit->file, unit);
+   eina_hash_foreach(unit->children, _deps_collect_cb, dd);
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_deps_write_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED,
+               void *data, void *fdata)
+{
+   Cache_Io *io = fdata;
+   Eolian_Unit *dep = data;
+   Eina_Stringshare *file = dep->file, *path;
+   uint64_t fhash;
+
+   path = _file_path_get(dep->state, dep->file);
+   if (!path || !_file_hash(dep->state, path, &fhash))
+     {
+        io->fail = EINA_TRUE;
+        return EINA_FALSE;
+     }
+   _io_str(io, &file);
+   _io_str(io, &path);
+   _io_raw(io, &fhash, sizeof(fhash));
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_cache_write(const char *cpath, Eina_Binbuf *buf)
+{
+   Eina_Tmpstr *tmp = NULL;
+   Eina_Strbuf *tmpl = eina_strbuf_new();
+   const unsigned char *data = eina_binbuf_string_get(buf);
+   size_t len = eina_binbuf_length_get(buf);
+   int fd;
+
+   /* written aside and renamed, so readers never see a partial file */
+   eina_strbuf_append_printf(tmpl, "%s.XXXXXX", cpath);
+   fd = eina_file_mkstemp(eina_strbuf_string_get(tmpl), &tmp);
+   eina_strbuf_free(tmpl);
+   if (fd < 0)
+     return EINA_FALSE;
+
+   while (len)
+     {
+        ssize_t w = write(fd, data, len);
+        if (w < 0)
+          {
+             if (errno == EINTR) continue;
+             break;
+          }
+        data += w;
+        len -= w;
+     }
+   if (close(fd) || len || rename(tmp, cpath))
+     {
+        unlink(tmp);
+        eina_tmpstr_del(tmp);
+        return EINA_FALSE;
+     }
+   eina_tmpstr_del(tmp);
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_group_save(Eina_Array *units)
+{
+   Eolian_State *state = ((Eolian_Unit *)eina_array_data_get(units, 0))->state;
+   Eina_Stringshare *file, *path, *str;
+   const Eolian_Object *obj;
+   Eolian_Unit *unit, *child;
+   Eina_Iterator *itr;
+   Eina_List *tops, *l;
+   uint64_t hash, sum;
+   unsigned int i, n, u;
+   Eina_Bool ret = EINA_FALSE;
+
+   Cache_Io io;
+   memset(&io, 0, sizeof(io));
+   io.units = units;
+   io.deps = eina_hash_stringshared_new(NULL);
+   io.ids = eina_hash_pointer_new(NULL);
+   io.objs_w = eina_array_new(64);
+   io.exts_w = eina_array_new(16);
+   Eina_Binbuf *records = eina_binbuf_new();
+   Eina_Binbuf *table = eina_binbuf_new();
+   Eina_Binbuf *payload = eina_binbuf_new();
+   Eina_Binbuf *out = eina_binbuf_new();
+
+   Deps_Data dd = { units, io.deps };
+   for (u = 0; u < eina_array_count(units); ++u)
+     {
+        unit = eina_array_data_get(units, u);
+        eina_hash_foreach(unit->children, _deps_collect_cb, &dd);
+     }
+
+   /* the top level objects come first, in the order they were declared */
+   for (u = 0; u < eina_array_count(units); ++u)
+     {
+        unit = eina_array_data_get(units, u);
+        tops = eina_hash_find(state->main.objects_f, unit->file);
+        EINA_LIST_FOREACH(tops, l, obj)
+          {
+             if ((obj->unit != unit) || !obj->validated)
+               goto end;
+             _io_id_get(&io, obj);
+          }
+     }
+
+   io.buf = records;
+   for (i = 0; !io.fail && (i < eina_array_count(io.objs_w)); ++i)
+     {
+        Eolian_Object *wobj = eina_array_data_get(io.objs_w, i);
+        unsigned int v[3] = { wobj->type, _group_idx(units, wobj->unit),
+                              eina_binbuf_length_get(records) };
+        eina_binbuf_append_length(table, (const unsigned char *)v, sizeof(v));
+        _io_object(&io, wobj);
+     }
+   if (io.fail)
+     goto end;
+
+   io.buf = payload;
+   n = eina_array_count(units);
+   _io_u32(&io, &n);
+   for (u = 0; u < eina_array_count(units); ++u)
+     {
+        unit = eina_array_data_get(units, u);
+        file = unit->file;
+        path = _file_path_get(state, unit->file);
+        if (!path || !_file_hash(state, path, &hash))
+          goto end;
+        _io_str(&io, &file);
+        _io_str(&io, &path);
+        _io_raw(&io, &hash, sizeof(hash));
+        n = unit->version;
+        _io_u32(&io, &n);
+        n = eina_list_count(unit->deferred);
+        _io_u32(&io, &n);
+        EINA_LIST_FOREACH(unit->deferred, l, str)
+          _io_str(&io, &str);
+        n = eina_hash_population(unit->children);
+        _io_u32(&io, &n);
+        itr = eina_hash_iterator_data_new(unit->children);
+        EINA_ITERATOR_FOREACH(itr, child)
+          _io_str(&io, &child->file);
+        eina_iterator_free(itr);
+     }
+
+   n = eina_hash_population(io.deps);
+   _io_u32(&io, &n);
+   eina_hash_foreach(io.deps, _deps_write_cb, &io);
+   if (io.fail)
+     goto end;
+
+   n = eina_array_count(io.exts_w);
+   _io_u32(&io, &n);
+   for (i = 0; i < n; ++i)
+     {
+        const Eolian_Object *owner;
+        Cache_Member member;
+        unsigned int idx, kind;
+        Eina_Stringshare *efile, *name;
+        obj = eina_array_data_get(io.exts_w, i);
+        _ext_member(obj, &owner, &member, &idx);
+        efile = obj->unit->file;
+        name = owner ? owner->name : obj->name;
+        kind = obj->type;
+        _io_str(&io, &efile);
+        _io_u32(&io, &kind);
+        _io_str(&io, &name);
+        CACHE_IO_VAL(&io, member);
+        _io_u32(&io, &idx);
+     }
+
+   for (u = 0; u < eina_array_count(units); ++u)
+     {
+        unit = eina_array_data_get(units, u);
+        tops = eina_hash_find(state->main.objects_f, unit->file);
+        n = eina_list_count(tops);
+        _io_u32(&io, &n);
+        EINA_LIST_FOREACH(tops, l, obj)
+          _io_obj(&io, &obj, obj->type);
+     }
+
+   n = eina_array_count(io.objs_w);
+   _io_u32(&io, &n);
+   eina_binbuf_append_buffer(payload, table);
+   eina_binbuf_append_buffer(payload, records);
+
+   sum = _hash(HASH_INIT, eina_binbuf_string_get(payload),
+               eina_binbuf_length_get(payload));
+   _header_append(out);
+   eina_binbuf_append_length(out, (const unsigned char *)&sum, sizeof(sum));
+   eina_binbuf_append_buffer(out, payload);
+
+   ret = EINA_TRUE;
+   for (u = 0; u < eina_array_count(units); ++u)
+     {
+        unit = eina_array_data_get(units, u);
+        path = _file_path_get(state, unit->file);
+        _file_hash(state, path, &hash);
+        char *cpath = _cache_path(state, unit->file, path, hash);
+        ret = _cache_write(cpath, out) && ret;
+        free(cpath);
+     }
+
+end:
+   eina_binbuf_free(out);
+   eina_binbuf_free(payload);
+   eina_binbuf_free(table);
+   eina_binbuf_free(records);
+   eina_array_free(io.exts_w);
+   eina_array_free(io.objs_w);
+   eina_hash_free(io.ids);
+   eina_hash_free(io.deps);
+   return ret;
+}
+
+/* the groups are found with Tarjan's algorithm over the dependencies */
+typedef struct _Group_Node
+{
+   unsigned int index;
+   unsigned int low;
+   Eina_Bool on_stack;
+} Group_Node;
+
+typedef struct _Group_Data
+{
+   Eina_Hash *nodes;
+   Eina_Array *stack;
+   unsigned int index;
+} Group_Data;
+
+static void
+_group_found(Group_Data *gd, Eolian_Unit *root)
+{
+   Eina_Array *units = eina_array_new(4);
+   Eolian_Unit *unit;
+   Group_Node *node;
+   unsigned int i;
+
+   do
+     {
+        unit = eina_array_pop(gd->stack);
+        node = eina_hash_find(gd->nodes, &unit);
+        node->on_stack = EINA_FALSE;
+        eina_array_push(units, unit);
+     }
+   while (unit != root);
+
+   /* whatever the outcome, it is not tried again */
+   for (i = 0; i < eina_array_count(units); ++i)
+     ((Eolian_Unit *)eina_array_data_get(units, i))->cached = EINA_TRUE;
+   if (!_group_save(units))
+     DBG("unit '%s' not cached", root->file);
+   eina_array_free(units);
+}
+
+static Group_Node *
+_group_visit(Group_Data *gd, Eolian_Unit *unit)
+{
+   Group_Node *node = calloc(1, sizeof(Group_Node)), *cnode;
+   Eolian_Unit *child;
+   Eina_Iterator *itr;
+
+   if (!node)
+     return NULL;
+   node->index = node->low = gd->index++;
+   node->on_stack = EINA_TRUE;
+   eina_hash_add(gd->nodes, &unit, node);
+   eina_array_push(gd->stack, unit);
+
+   itr = eina_hash_iterator_data_new(unit->children);
+   EINA_ITERATOR_FOREACH(itr, child)
+     {
+        if (child->cached)
+          continue;
+        cnode = eina_hash_find(gd->nodes, &child);
+        if (!cnode)
+          {
+             if (!(cnode = _group_visit(gd, child)))
+               break;
+             if (cnode->low < node->low)
+               node->low = cnode->low;
+          }
+        else if (cnode->on_stack && (cnode->index < node->low))
+          node->low = cnode->index;
+     }
+   eina_iterator_free(itr);
+
+   if (node->low == node->index)
+     _group_found(gd, unit);
+   return node;
+}
+
+void
+database_cache_save(Eolian_State *state)
+{
+   Group_Data gd = { eina_hash_pointer_new(free), eina_array_new(16), 0 };
+   Eolian_Unit *unit;
+
+   /* a group is loaded or saved as a whole, so the cached units are never
+    * in a cycle with the others and can be left out of the search */
+   Eina_Iterator *itr = eina_hash_iterator_data_new(state->main.units);
+   EINA_ITERATOR_FOREACH(itr, unit)
+     if (!unit->cached && !eina_hash_find(gd.nodes, &unit)
+         && !_group_visit(&gd, unit))
+       break;
+   eina_iterator_free(itr);
+
+   eina_array_free(gd.stack);
+   eina_hash_free(gd.nodes);
+}
+
+static Eina_Bool
+_deferred_cb(const Eina_Hash *hash EINA_UNUSED, const void *key,
+             void *data, void *fdata)
+{
+   Eolian_Unit *unit = fdata;
+   /* the dependencies end up in the children already */
+   if ((size_t)data <= 1)
+     unit->deferred = eina_list_append(unit->deferred, eina_stringshare_add(key));
+   return EINA_TRUE;
+}
+
+void
+database_cache_deferred_set(Eolian_Unit *unit)
+{
+   eina_hash_foreach(unit->state->defer, _deferred_cb, unit);
+}
+
+typedef struct _Load_Data
+{
+   Eolian_State *state;
+   Eina_Hash *loading; /* against dependency cycles */
+} Load_Data;
+
+static Eolian_Unit *_unit_load(Load_Data *ld, const char *path, Eina_Stringshare *fname);
+
+static const Eolian_Object *
+_ext_resolve(Eolian_State *state, Eina_Stringshare *file, unsigned int kind,
+             Eina_Stringshare *name, unsigned int member, unsigned int idx)
+{
+   const Eolian_Object *obj;
+   const Eolian_Class *cl;
+   Eina_List *l;
+
+   Eolian_Unit *unit = eina_hash_find(state->main.units, file);
+   if (!unit && (unit = eina_hash_find(state->staging.units, file))
+       && !unit->cached)
+     return NULL;
+   if (!unit)
+     return NULL;
+
+   obj = eina_hash_find(unit->objects, name);
+   if (!obj || (obj->unit != unit))
+     return NULL;
+   if (member == CACHE_MEMBER_NONE)
+     return (obj->type == kind) ? obj : NULL;
+   if (member == CACHE_MEMBER_VALUE)
+     {
+        if (obj->type != EOLIAN_OBJECT_VARIABLE)
+          return NULL;
+        obj = (const Eolian_Object *)((const Eolian_Variable *)obj)->value;
+        return (obj && (obj->type == kind)) ? obj : NULL;
+     }
+   if (member == CACHE_MEMBER_ENUM_FIELD)
+     {
+        const Eolian_Enum_Type_Field *field;
+        if ((obj->type != EOLIAN_OBJECT_TYPEDECL)
+            || (((const Eolian_Typedecl *)obj)->type != EOLIAN_TYPEDECL_ENUM))
+          return NULL;
+        field = eina_list_nth(((const Eolian_Typedecl *)obj)->field_list, idx);
+        obj = field ? (const Eolian_Object *)field->value : NULL;
+        return (obj && (obj->type == kind)) ? obj : NULL;
+     }
+   if (obj->type != EOLIAN_OBJECT_CLASS)
+     return NULL;
+
+   cl = (const Eolian_Class *)obj;
+   switch (member)
+     {
+      case CACHE_MEMBER_METHOD:
+        l = cl->methods;
+        break;
+      case CACHE_MEMBER_PROPERTY:
+        l = cl->properties;
+        break;
+      case CACHE_MEMBER_IMPLEMENT:
+        l = cl->implements;
+        break;
+      default:
+        return NULL;
+     }
+   obj = eina_list_nth(l, idx);
+   return (obj && (obj->type == kind)) ? obj : NULL;
+}
+
+static Eolian_Unit *
+_dep_get(Load_Data *ld, Eina_Stringshare *file)
+{
+   const char *path;
+   Eolian_Unit *unit = eina_hash_find(ld->state->main.units, file);
+   if (unit)
+     return unit;
+   /* only units coming from the cache are complete before validation */
+   unit = eina_hash_find(ld->state->staging.units, file);
+   if (unit)
+     return unit->cached ? unit : NULL;
+   if (eina_hash_find(ld->loading, file)
+       || !(path = _file_path_get(ld->state, file)))
+     return NULL;
+   return _unit_load(ld, path, file);
+}
+
+static void
+_fields_hash_fill(Eolian_Typedecl *tp)
+{
+   Eolian_Object *field;
+   Eina_List *l;
+
+   if (tp->type == EOLIAN_TYPEDECL_STRUCT)
+     tp->fields = eina_hash_string_small_new(EINA_FREE_CB(database_struct_field_del));
+   else if (tp->type == EOLIAN_TYPEDECL_ENUM)
+     tp->fields = eina_hash_string_small_new(EINA_FREE_CB(database_enum_field_del));
+   else
+     return;
+   EINA_LIST_FOREACH(tp->field_list, l, field)
+     eina_hash_add(tp->fields, field->name, field);
+}
+
+typedef struct _Group_Unit
+{
+   Eina_Stringshare *file;
+   unsigned int version;
+   Eina_Array *deferred;
+   Eina_Array *children;
+   unsigned int ntops;
+   unsigned int *tops;
+   Eolian_Unit *unit;
+} Group_Unit;
+
+static Eolian_Unit *
+_group_read(Load_Data *ld, const unsigned char *data, size_t size,
+            Eina_Stringshare *fname)
+{
+   Eolian_State *state = ld->state;
+   Eolian_Unit *ret = NULL;
+   Eina_Array *strs = eina_array_new(16);
+   Group_Unit *gunits = NULL;
+   unsigned int *offsets = NULL, *owners = NULL;
+   unsigned char *is_top = NULL;
+   Eina_Stringshare *str;
+   Eina_Array_Iterator it;
+   unsigned int i, j, n, nunits = 0;
+   Eina_Bool found = EINA_FALSE;
+   uint64_t sum;
+   size_t rlen;
+   Cache_Io io;
+
+   memset(&io, 0, sizeof(io));
+
+   Eina_Binbuf *hdr = eina_binbuf_new();
+   _header_append(hdr);
+   size_t hlen = eina_binbuf_length_get(hdr);
+   Eina_Bool hok = (size >= (hlen + sizeof(sum)))
+      && !memcmp(data, eina_binbuf_string_get(hdr), hlen);
+   eina_binbuf_free(hdr);
+   if (!hok)
+     goto end;
+   memcpy(&sum, data + hlen, sizeof(sum));
+   data += hlen + sizeof(sum);
+   size -= hlen + sizeof(sum);
+   if (_hash(HASH_INIT, data, size) != sum)
+     goto end;
+
+   io.p = data;
+   io.end = data + size;
+   io.fill = EINA_TRUE;
+
+#define READ_STR(var) \
+   do { \
+      _io_str(&io, &var); \
+      if (var) eina_array_push(strs, var); \
+      else io.fail = EINA_TRUE; \
+   } while (0)
+
+   /* the units of the group have to be the same as when they were written,
+    * and none of them can be around already
+    */
+   _io_u32(&io, &nunits);
+   if (io.fail || !nunits || (nunits > (size_t)(io.end - io.p)))
+     goto end;
+   gunits = calloc(nunits, sizeof(Group_Unit));
+   for (i = 0; !io.fail && (i < nunits); ++i)
+     {
+        Group_Unit *gu = &gunits[i];
+        Eina_Stringshare *upath;
+        const char *rpath;
+        uint64_t uhash, chash;
+        gu->deferred = eina_array_new(4);
+        gu->children = eina_array_new(8);
+        READ_STR(gu->file);
+        READ_STR(upath);
+        _io_raw(&io, &uhash, sizeof(uhash));
+        _io_u32(&io, &gu->version);
+        if (io.fail || !(rpath = _file_path_get(state, gu->file))
+            || strcmp(rpath, upath) || !_file_hash(state, rpath, &chash)
+            || (chash != uhash)
+            || eina_hash_find(state->main.units, gu->file)
+            || eina_hash_find(state->staging.units, gu->file)
+            || ((gu->file != fname) && eina_hash_find(ld->loading, gu->file)))
+          io.fail = EINA_TRUE;
+        /* files the unit refers to, they are parsed once it is loaded */
+        _io_u32(&io, &n);
+        while (n-- && !io.fail)
+          {
+             READ_STR(str);
+             if (!io.fail && !_file_path_get(state, str))
+               io.fail = EINA_TRUE;
+             eina_array_push(gu->deferred, str);
+          }
+        _io_u32(&io, &n);
+        while (n-- && !io.fail)
+          {
+             READ_STR(str);
+             eina_array_push(gu->children, str);
+          }
+        found = found || (gu->file == fname);
+     }
+   if (io.fail || !found)
+     goto end;
+
+   /* every dependency has to be the same as when it was written... */
+   _io_u32(&io, &n);
+   while (n-- && !io.fail)
+     {
+        Eina_Stringshare *dfile, *dpath;
+        const char *rpath;
+        uint64_t dhash, chash;
+        READ_STR(dfile);
+        READ_STR(dpath);
+        _io_raw(&io, &dhash, sizeof(dhash));
+        if (io.fail || !(rpath = _file_path_get(state, dfile))
+            || strcmp(rpath, dpath) || !_file_hash(state, dpath, &chash)
+            || (chash != dhash))
+          io.fail = EINA_TRUE;
+     }
+   if (io.fail)
+     goto end;
+
+   /* ...and loaded before the group can be */
+   for (i = 0; i < nunits; ++i)
+     if (gunits[i].file != fname)
+       eina_hash_add(ld->loading, gunits[i].file, gunits[i].file);
+   for (i = 0; !io.fail && (i < nunits); ++i)
+     EINA_ARRAY_ITER_NEXT(gunits[i].children, j, str, it)
+       {
+          unsigned int k;
+          for (k = 0; k < nunits; ++k)
+            if (gunits[k].file == str)
+              break;
+          if ((k == nunits) && !_dep_get(ld, str))
+            {
+               io.fail = EINA_TRUE;
+               break;
+            }
+       }
+   for (i = 0; i < nunits; ++i)
+     if (gunits[i].file != fname)
+       eina_hash_del_by_key(ld->loading, gunits[i].file);
+   if (io.fail)
+     goto end;
+
+   _io_u32(&io, &io.nexts);
+   if (io.nexts > (size_t)(io.end - io.p))
+     goto end;
+   io.exts = calloc(io.nexts + 1, sizeof(Eolian_Object *));
+   for (i = 0; !io.fail && (i < io.nexts); ++i)
+     {
+        Eina_Stringshare *efile, *name;
+        unsigned int kind, member, idx;
+        READ_STR(efile);
+        _io_u32(&io, &kind);
+        READ_STR(name);
+        _io_u32(&io, &member);
+        _io_u32(&io, &idx);
+        if (io.fail
+            || !(io.exts[i] = _ext_resolve(state, efile, kind, name, member, idx)))
+          io.fail = EINA_TRUE;
+     }
+   if (io.fail)
+     goto end;
+
+#undef READ_STR
+
+   for (i = 0; !io.fail && (i < nunits); ++i)
+     {
+        Group_Unit *gu = &gunits[i];
+        _io_u32(&io, &gu->ntops);
+        if (io.fail || (gu->ntops > (size_t)(io.end - io.p)))
+          goto end;
+        gu->tops = calloc(gu->ntops + 1, sizeof(unsigned int));
+        for (j = 0; j < gu->ntops; ++j)
+          _io_u32(&io, &gu->tops[j]);
+     }
+
+   _io_u32(&io, &io.nobjs);
+   if (io.fail || (io.nobjs > (size_t)(io.end - io.p)))
+     goto end;
+   io.kinds = calloc(io.nobjs + 1, 1);
+   is_top = calloc(io.nobjs + 1, 1);
+   offsets = calloc(io.nobjs + 1, sizeof(unsigned int));
+   owners = calloc(io.nobjs + 1, sizeof(unsigned int));
+   io.objs = calloc(io.nobjs + 1, sizeof(Eolian_Object *));
+   for (i = 0; i < io.nobjs; ++i)
+     {
+        unsigned int kind;
+        _io_u32(&io, &kind);
+        _io_u32(&io, &owners[i]);
+        _io_u32(&io, &offsets[i]);
+        if (!_object_size(kind) || (owners[i] >= nunits))
+          io.fail = EINA_TRUE;
+        io.kinds[i] = kind;
+     }
+   if (io.fail)
+     goto end;
+   const unsigned char *records = io.p;
+   rlen = io.end - records;
+
+   /* top level objects are registered with their unit, so they must all be
+    * listed as such, once
+    */
+   for (i = 0; i < nunits; ++i)
+     for (j = 0; j < gunits[i].ntops; ++j)
+       {
+          unsigned int id = gunits[i].tops[j];
+          if (!id || (id > io.nobjs) || is_top[id - 1] || (owners[id - 1] != i)
+              || !_object_is_top(io.kinds[id - 1]))
+            goto end;
+          is_top[id - 1] = 1;
+       }
+   for (i = 0; i < io.nobjs; ++i)
+     if (_object_is_top(io.kinds[i]) && !is_top[i])
+       goto end;
+
+   /* a pass to check it all before anything gets allocated */
+   io.fill = EINA_FALSE;
+   for (i = 0; !io.fail && (i < io.nobjs); ++i)
+     {
+        Cache_Scratch scratch;
+        if (offsets[i] >= rlen)
+          goto end;
+        memset(&scratch, 0, sizeof(scratch));
+        scratch.base.type = io.kinds[i];
+        io.p = records + offsets[i];
+        _io_object(&io, &scratch.base);
+     }
+   if (io.fail)
+     goto end;
+
+   for (i = 0; i < nunits; ++i)
+     {
+        Eolian_Unit *unit = calloc(1, sizeof(Eolian_Unit));
+        if (!unit)
+          eolian_state_panic(state, "out of memory");
+        database_unit_init(state, unit, gunits[i].file);
+        unit->version = (unsigned short)gunits[i].version;
+        unit->cached = EINA_TRUE;
+        gunits[i].unit = unit;
+        if (gunits[i].file == fname)
+          ret = unit;
+     }
+   for (i = 0; i < io.nobjs; ++i)
+     {
+        io.objs[i] = calloc(1, _object_size(io.kinds[i]));
+        if (!io.objs[i])
+          eolian_state_panic(state, "out of memory");
+        io.objs[i]->unit = gunits[owners[i]].unit;
+        io.objs[i]->type = io.kinds[i];
+     }
+   io.fill = EINA_TRUE;
+   for (i = 0; i < io.nobjs; ++i)
+     {
+        io.p = records + offsets[i];
+        _io_object(&io, io.objs[i]);
+     }
+   for (i = 0; i < io.nobjs; ++i)
+     if (io.kinds[i] == EOLIAN_OBJECT_TYPEDECL)
+       _fields_hash_fill((Eolian_Typedecl *)io.objs[i]);
+
+   for (i = 0; i < nunits; ++i)
+     eina_hash_add(state->staging.units, gunits[i].file, gunits[i].unit);
+   for (i = 0; i < nunits; ++i)
+     EINA_ARRAY_ITER_NEXT(gunits[i].children, j, str, it)
+       {
+          Eolian_Unit *dep = eina_hash_find(state->main.units, str);
+          if (!dep)
+            dep = eina_hash_find(state->staging.units, str);
+          if (!eina_hash_find(gunits[i].unit->children, str))
+            eina_hash_add(gunits[i].unit->children, dep->file, dep);
+       }
+
+   /* register the same way the parser does */
+   for (i = 0; i < io.nobjs; ++i)
+     {
+        Eolian_Object *obj = io.objs[i];
+        Eolian_Unit *unit = obj->unit;
+        Eolian_Typedecl *tp = (Eolian_Typedecl *)obj;
+        if (!is_top[i])
+          continue;
+        switch (obj->type)
+          {
+           case EOLIAN_OBJECT_CLASS:
+             database_object_add(unit, obj);
+             break;
+           case EOLIAN_OBJECT_VARIABLE:
+             database_var_add(unit, (Eolian_Variable *)obj);
+             break;
+           default:
+             if ((tp->type == EOLIAN_TYPEDECL_STRUCT)
+                 || (tp->type == EOLIAN_TYPEDECL_STRUCT_OPAQUE))
+               database_struct_add(unit, tp);
+             else if (tp->type == EOLIAN_TYPEDECL_ENUM)
+               database_enum_add(unit, tp);
+             else
+               database_type_add(unit, tp);
+             break;
+          }
+     }
+   for (i = 0; i < io.nobjs; ++i)
+     {
+        Eolian_Class *cl = (Eolian_Class *)io.objs[i];
+        if (!is_top[i] || (cl->base.type != EOLIAN_OBJECT_CLASS))
+          continue;
+        EOLIAN_OBJECT_ADD(cl->base.unit, cl->base.name, cl, classes);
+        eina_hash_set(state->staging.classes_f, cl->base.file, cl);
+        _class_ctors_register(cl);
+     }
+
+   for (i = 0; i < nunits; ++i)
+     EINA_ARRAY_ITER_NEXT(gunits[i].deferred, j, str, it)
+       {
+          Eolian_Unit *unit = gunits[i].unit;
+          unit->deferred = eina_list_append(unit->deferred, eina_stringshare_ref(str));
+          database_defer(state, str, EINA_FALSE);
+       }
+
+end:
+   for (i = 0; gunits && (i < nunits); ++i)
+     {
+        if (gunits[i].deferred) eina_array_free(gunits[i].deferred);
+        if (gunits[i].children) eina_array_free(gunits[i].children);
+        free(gunits[i].tops);
+     }
+   free(gunits);
+   EINA_ARRAY_ITER_NEXT(strs, i, str, it)
+     eina_stringshare_del(str);
+   eina_array_free(strs);
+   free(io.objs);
+   free(io.exts);
+   free(io.kinds);
+   free(offsets);
+   free(owners);
+   free(is_top);
+   return ret;
+}
+
+static Eolian_Unit *
+_unit_load(Load_Data *ld, const char *path, Eina_Stringshare *fname)
+{
+   Eolian_Unit *ret = NULL;
+   uint64_t hash;
+
+   if (!_file_hash(ld->state, path, &hash))
+     return NULL;
+
+   char *cpath = _cache_path(ld->state, fname, path, hash);
+   Eina_File *f = eina_file_open(cpath, EINA_FALSE);
+   free(cpath);
+   if (!f)
+     return NULL;
+
+   const unsigned char *data = eina_file_map_all(f, EINA_FILE_SEQUENTIAL);
+   if (data)
+     {
+        eina_hash_add(ld->loading, fname, fname);
+        ret = _group_read(ld, data, eina_file_size_get(f), fname);
+        eina_hash_del_by_key(ld->loading, fname);
+        eina_file_map_free(f, (void *)data);
+     }
+   eina_file_close(f);
+   if (!ret)
+     DBG("unit '%s' not loaded from the cache", fname);
+   return ret;
+}
+
+Eolian_Unit *
+database_cache_load(Eolian_State *state, const char *path,
+                    Eina_Stringshare *fname)
+{
+   Load_Data ld = { state, eina_hash_stringshared_new(NULL) };
+   Eolian_Unit *ret = _unit_load(&ld, path, fname);
+   eina_hash_free(ld.loading);
+   return ret;
+}
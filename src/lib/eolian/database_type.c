@@ -33,6 +33,26 @@ database_typedecl_del(Eolian_Typedecl *tp)
    free(tp);
 }
 
+void
+database_struct_field_del(Eolian_Struct_Type_Field *def)
+{
+   eina_stringshare_del(def->base.file);
+   eina_stringshare_del(def->base.name);
+   database_type_del(def->type);
+   database_doc_del(def->doc);
+   free(def);
+}
+
+void
+database_enum_field_del(Eolian_Enum_Type_Field *def)
+{
+   eina_stringshare_del(def->base.file);
+   eina_stringshare_del(def->base.name);
+   database_expr_del(def->value);
+   database_doc_del(def->doc);
+   free(def);
+}
+
 void
 database_type_add(Eolian_Unit *unit, Eolian_Typedecl *tp)
 {
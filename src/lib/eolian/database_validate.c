@@ -1068,6 +1068,10 @@ _db_fill_inherits(Validate_State *vals, Eolian_Class *cl, Eina_Hash *fhash,
    if (eina_hash_find(cl->base.unit->state->main.unit.classes, cl->base.name))
      return EINA_TRUE;
 
+   /* loaded from the cache, filled in already */
+   if (cl->base.validated)
+     return EINA_TRUE;
+
    Eina_List *il = cl->extends, *rl = cl->requires;
    Eina_Stringshare *inn = NULL;
    cl->extends = NULL;
@@ -433,16 +433,6 @@ parse_type(Eo_Lexer *ls, Eina_Bool allow_ptr)
    return ret;
 }
 
-static void
-_struct_field_free(Eolian_Struct_Type_Field *def)
-{
-   eina_stringshare_del(def->base.file);
-   eina_stringshare_del(def->base.name);
-   database_type_del(def->type);
-   database_doc_del(def->doc);
-   free(def);
-}
-
 static Eolian_Typedecl *
 parse_struct(Eo_Lexer *ls, const char *name, Eina_Bool is_extern,
              Eina_Bool is_beta, int line, int column, const char *freefunc)
@@ -454,7 +444,7 @@ parse_struct(Eo_Lexer *ls, const char *name, Eina_Bool is_extern,
    def->base.name = name;
    def->base.c_name = make_c_name(name);
    def->type = EOLIAN_TYPEDECL_STRUCT;
-   def->fields = eina_hash_string_small_new(EINA_FREE_CB(_struct_field_free));
+   def->fields = eina_hash_string_small_new(EINA_FREE_CB(database_struct_field_del));
    if (freefunc)
      {
         def->freefunc = eina_stringshare_ref(freefunc);
@@ -493,16 +483,6 @@ parse_struct(Eo_Lexer *ls, const char *name, Eina_Bool is_extern,
    return def;
 }
 
-static void
-_enum_field_free(Eolian_Enum_Type_Field *def)
-{
-   eina_stringshare_del(def->base.file);
-   eina_stringshare_del(def->base.name);
-   database_expr_del(def->value);
-   database_doc_del(def->doc);
-   free(def);
-}
-
 static Eolian_Typedecl *
 parse_enum(Eo_Lexer *ls, const char *name, Eina_Bool is_extern,
            Eina_Bool is_beta, int line, int column)
@@ -514,7 +494,7 @@ parse_enum(Eo_Lexer *ls, const char *name, Eina_Bool is_extern,
    def->base.name = name;
    def->base.c_name = make_c_name(name);
    def->type = EOLIAN_TYPEDECL_ENUM;
-   def->fields = eina_hash_string_small_new(EINA_FREE_CB(_enum_field_free));
+   def->fields = eina_hash_string_small_new(EINA_FREE_CB(database_enum_field_del));
    check_next(ls, '{');
    FILL_DOC(ls, def, doc);
    if (ls->t.token == TOK_VALUE && ls->t.kw == KW_legacy)
@@ -2338,6 +2318,14 @@ eo_parser_database_fill(Eolian_Unit *parent, const char *filename, Eina_Bool eot
         return ret;
      }
 
+   if (parent->state->cache_dir
+       && (ret = database_cache_load(parent->state, filename, fname)))
+     {
+        eina_hash_add(parent->children, fname, ret);
+        eina_stringshare_del(fname);
+        return ret;
+     }
+
    Eo_Lexer *ls = eo_lexer_new(parent->state, filename);
    if (!ls)
      {
@@ -2368,6 +2356,8 @@ eo_parser_database_fill(Eolian_Unit *parent, const char *filename, Eina_Bool eot
 
 done:
    ret = ls->unit;
+   if (parent->state->cache_dir)
+     database_cache_deferred_set(ret);
    eina_hash_add(parent->children, fname, ret);
    eina_stringshare_del(fname);
 
@@ -589,6 +589,10 @@ _unit_contents_del(Eolian_Unit *unit)
    eina_hash_free(unit->structs);
    eina_hash_free(unit->enums);
    eina_hash_free(unit->objects);
+
+   Eina_Stringshare *dfile;
+   EINA_LIST_FREE(unit->deferred, dfile)
+     eina_stringshare_del(dfile);
 }
 
 void
@@ -707,6 +711,8 @@ eolian_state_new(void)
 
    state->defer = eina_hash_string_small_new(NULL);
 
+   state->cache_files = eina_hash_string_superfast_new(free);
+
    return state;
 }
 
@@ -724,6 +730,9 @@ eolian_state_free(Eolian_State *state)
 
    eina_hash_free(state->defer);
 
+   eina_stringshare_del(state->cache_dir);
+   eina_hash_free(state->cache_files);
+
    free(state);
 }
 
@@ -751,6 +760,13 @@ eolian_state_error_data_set(Eolian_State *state, void *data)
    return old_data;
 }
 
+EAPI void
+eolian_state_cache_dir_set(Eolian_State *state, const char *dir)
+{
+   if (!state) return;
+   eina_stringshare_replace(&state->cache_dir, dir);
+}
+
 #define EO_SUFFIX ".eo"
 #define EOT_SUFFIX ".eot"
 
@@ -1071,6 +1087,8 @@ eolian_state_file_parse(Eolian_State *state, const char *filename)
    if (!database_validate(&state->staging.unit))
      return NULL;
    _merge_staging(state);
+   if (state->cache_dir)
+     database_cache_save(state);
    return ret;
 }
 
@@ -1097,12 +1115,24 @@ eolian_state_file_path_parse(Eolian_State *state, const char *filepath)
    else
      *fname++ = '\0';
 
-   if (!eolian_state_directory_add(state, toscan))
+   /* generating from many files of one directory in the same state does
+    * not need to scan that directory again and again */
+   Eina_Bool is_eo = eina_str_has_suffix(fname, EO_SUFFIX);
+   const char *origpath = eina_hash_find(is_eo ? state->filenames_eo
+                                               : state->filenames_eot, fname);
+   char *newpath = origpath ? join_path(toscan, fname) : NULL;
+   Eina_Bool scan = !newpath || strcmp(origpath, newpath);
+   free(newpath);
+
+   if (scan && !eolian_state_directory_add(state, toscan))
      {
         eolian_state_log(state, "could not scan directory '%s'", toscan);
+        free(mpath);
         return NULL;
      }
-   return eolian_state_file_parse(state, fname);
+   const Eolian_Unit *ret = eolian_state_file_parse(state, fname);
+   free(mpath);
+   return ret;
 }
 
 typedef struct _Parse_Data
@@ -1138,6 +1168,8 @@ eolian_state_all_eot_files_parse(Eolian_State *state)
      return EINA_FALSE;
 
    _merge_staging(state);
+   if (pd.ret && state->cache_dir)
+     database_cache_save(state);
 
    return pd.ret;
 }
@@ -1169,6 +1201,8 @@ eolian_state_all_eo_files_parse(Eolian_State *state)
      return EINA_FALSE;
 
    _merge_staging(state);
+   if (pd.ret && state->cache_dir)
+     database_cache_save(state);
 
    return pd.ret;
 }
@@ -45,7 +45,9 @@ struct _Eolian_Unit
    Eina_Hash     *structs;
    Eina_Hash     *enums;
    Eina_Hash     *objects;
+   Eina_List     *deferred; /* files referred to without depending on them */
    unsigned short version;
+   Eina_Bool      cached: 1; /* loaded from or written to the cache */
 };
 
 typedef struct _Eolian_State_Area
@@ -79,6 +81,9 @@ struct _Eolian_State
    Eina_Hash *filenames_eot;
 
    Eina_Hash *defer;
+
+   Eina_Stringshare *cache_dir;
+   Eina_Hash *cache_files; /* path to the hash of its contents */
 };
 
 struct _Eolian_Object
@@ -403,6 +408,8 @@ void database_struct_add(Eolian_Unit *unit, Eolian_Typedecl *tp);
 void database_enum_add(Eolian_Unit *unit, Eolian_Typedecl *tp);
 void database_type_del(Eolian_Type *tp);
 void database_typedecl_del(Eolian_Typedecl *tp);
+void database_struct_field_del(Eolian_Struct_Type_Field *def);
+void database_enum_field_del(Eolian_Enum_Type_Field *def);
 
 void database_type_to_str(const Eolian_Type *tp, Eina_Strbuf *buf, const char *name, Eolian_C_Type_Type ctype);
 void database_typedecl_to_str(const Eolian_Typedecl *tp, Eina_Strbuf *buf);
@@ -448,4 +455,9 @@ void database_event_del(Eolian_Event *event);
 /* parts */
 void database_part_del(Eolian_Part *part);
 
+/* cache */
+Eolian_Unit *database_cache_load(Eolian_State *state, const char *path, Eina_Stringshare *fname);
+void database_cache_save(Eolian_State *state);
+void database_cache_deferred_set(Eolian_Unit *unit);
+
 #endif
@@ -163,6 +163,7 @@ EAPI void                     evas_cache_engine_image_load_data(Engine_Image_Ent
 
 EAPI void                     evas_cache_image_preload_data(Image_Entry *im, const Eo *target, void (*preloaded_cb)(void *data), void *preloaded_data);
 EAPI void                     evas_cache_image_preload_cancel(Image_Entry *im, const Eo *target, Eina_Bool force);
+EAPI void                     evas_cache_image_frames_preload(Image_Entry *im);
 
 EAPI int                      evas_cache_async_frozen_get(void);
 EAPI void                     evas_cache_async_freeze(void);
@@ -24,6 +24,11 @@ struct _Evas_Cache_Preload
 static SLK(engine_lock);
 static int _evas_cache_mutex_init = 0;
 
+/* how many frames of an animated image get decoded ahead of the one
+ * being shown, in the preload thread */
+#define EVAS_CACHE_FRAMES_AHEAD 2
+static int _evas_cache_frames_ahead = EVAS_CACHE_FRAMES_AHEAD;
+
 static void _evas_cache_image_entry_preload_remove(Image_Entry *ie, const Eo *target, Eina_Bool force);
 
 #define FREESTRC(Var)             \
@@ -172,6 +177,12 @@ _evas_cache_image_entry_delete(Evas_Cache_Image *cache, Image_Entry *ie)
         _evas_cache_image_entry_preload_remove(ie, NULL, EINA_TRUE);
         return;
      }
+   if (ie->frames.preload)
+     {
+        evas_preload_thread_cancel(ie->frames.preload);
+        while (ie->frames.preload)
+          evas_preload_pthread_wait(ie->frames.preload, 0.1);
+     }
    _evas_cache_image_dirty_del(ie);
    _evas_cache_image_activ_del(ie);
    _evas_cache_image_lru_del(ie);
@@ -374,6 +385,62 @@ _evas_cache_image_async_heavy(void *data)
    SLKU(current->lock);
 }
 
+static void
+_evas_cache_image_frames_heavy(void *data)
+{
+   Image_Entry *ie = data;
+   int i, index, count;
+
+   eina_thread_name_set(eina_thread_self(), "Evas-preload");
+
+   count = ie->animated.frame_count;
+   for (i = 0; (i <= _evas_cache_frames_ahead) && (i < count); i++)
+     {
+        if (evas_preload_thread_cancelled_is(ie->frames.preload)) break;
+        // the lock is let go between frames so that a frame wanted now
+        // does not wait for the whole window
+        SLKL(ie->lock);
+        index = ((ie->animated.cur_frame - 1 + i) % count) + 1;
+        evas_common_load_rgba_image_frame_decode(ie, index);
+        SLKU(ie->lock);
+     }
+}
+
+static void
+_evas_cache_image_frames_end(void *data)
+{
+   Image_Entry *ie = data;
+
+   ie->frames.preload = NULL;
+}
+
+// decode the current and next frames of an animated image in the preload
+// thread, so that rendering finds them ready
+EAPI void
+evas_cache_image_frames_preload(Image_Entry *ie)
+{
+   Image_Entry_Frame *frame;
+   int count, index;
+
+   if ((_evas_cache_frames_ahead <= 0) || (ie->frames.preload)) return;
+   if (!eina_main_loop_is()) return;
+   if (!ie->frames.managed) return;
+   if ((!ie->info.loader) || (!ie->info.loader->threadable)) return;
+   count = ie->animated.frame_count;
+   if (count < 2) return;
+
+   // only start when the end of the window is not decoded yet
+   index = MIN(_evas_cache_frames_ahead, count - 1);
+   index = ((ie->animated.cur_frame - 1 + index) % count) + 1;
+   frame = evas_common_load_animated_frame_get(&ie->animated, index);
+   if ((!frame) || (frame->data)) return;
+
+   ie->frames.preload = evas_preload_thread_run(_evas_cache_image_frames_heavy,
+                                                _evas_cache_image_frames_end,
+                                                _evas_cache_image_frames_end,
+                                                ie);
+}
+
 static void
 _evas_cache_image_preloaded_notify(Image_Entry *ie)
 {
@@ -576,7 +643,11 @@ evas_cache_image_init(const Evas_Cache_Image_Func *cb)
 
    if (_evas_cache_mutex_init++ == 0)
      {
+        const char *s;
+
         SLKI(engine_lock);
+        s = getenv("EVAS_ANIMATED_DECODE_AHEAD");
+        if (s) _evas_cache_frames_ahead = atoi(s);
      }
 
    cache = calloc(1, sizeof(Evas_Cache_Image));
@@ -1163,6 +1234,8 @@ evas_cache_image_load_data(Image_Entry *im)
         _evas_cache_image_entry_surface_alloc(im->cache, im, im->w, im->h);
         im->flags.loaded = 0;
      }
+   else if (im->animated.animated)
+     evas_cache_image_frames_preload(im);
    if (preload) _evas_cache_image_async_end(im);
    evas_cache_image_drop(im);
    return error;
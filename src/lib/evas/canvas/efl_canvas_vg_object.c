@@ -141,9 +141,11 @@ _efl_canvas_vg_object_root_node_set(Eo *eo_obj, Efl_Canvas_Vg_Object_Data *pd, E
         pd->vg_entry = NULL;
      }
 
-   // detach/free the old root_node
+   // detach/free the old root_node and drop any surface cache attached to it.
    if (pd->user_entry && pd->user_entry->root)
      {
+        if (obj && obj->layer)
+          ENFN->ector_surface_cache_del(ENC, pd->user_entry->root);
         efl_canvas_vg_node_vg_obj_set(pd->user_entry->root, NULL, NULL);
         efl_parent_set(pd->user_entry->root, NULL);
      }
@@ -168,8 +170,6 @@ _efl_canvas_vg_object_root_node_set(Eo *eo_obj, Efl_Canvas_Vg_Object_Data *pd, E
      }
    else if (pd->user_entry)
      {
-        // drop any surface cache attached to it.
-        ENFN->ector_surface_cache_drop(_evas_engine_context(obj->layer->evas), pd->user_entry->root);
         free(pd->user_entry);
         pd->user_entry = NULL;
      }
@@ -342,7 +342,14 @@ _efl_canvas_vg_object_efl_object_destructor(Eo *eo_obj, Efl_Canvas_Vg_Object_Dat
    efl_unref(pd->root);
    pd->root = NULL;
 
-   if (pd->user_entry) free(pd->user_entry);
+   if (pd->user_entry)
+     {
+        Evas_Object_Protected_Data *obj = pd->obj;
+
+        if (obj && obj->layer)
+          ENFN->ector_surface_cache_del(ENC, pd->user_entry->root);
+        free(pd->user_entry);
+     }
    pd->user_entry = NULL;
    evas_cache_vg_entry_del(pd->vg_entry);
 
@@ -414,8 +421,8 @@ _evas_vg_render(Evas_Object_Protected_Data *obj, Efl_Canvas_Vg_Object_Data *pd,
 //renders a vg_tree to an offscreen buffer and push it to the cache.
 static void *
 _render_to_buffer(Evas_Object_Protected_Data *obj, Efl_Canvas_Vg_Object_Data *pd,
-                  void *engine, Efl_VG *root, int w, int h, void *buffer,
-                  Eina_Bool do_async)
+                  void *engine, Efl_VG *root, int w, int h, void *key,
+                  void *buffer, Eina_Bool do_async)
 {
    Ector_Surface *ector;
    RGBA_Draw_Context *context;
@@ -457,11 +464,9 @@ _render_to_buffer(Evas_Object_Protected_Data *obj, Efl_Canvas_Vg_Object_Data *pd
    ENFN->ector_end(engine, buffer, context, ector, do_async);
    evas_common_draw_context_free(context);
 
+   //The cache holds a reference for us until the buffer is drawn.
    if (buffer_created)
-     {
-        //Use root as a cache key.
-        ENFN->ector_surface_cache_set(engine, root, buffer);
-     }
+     ENFN->ector_surface_cache_set(engine, key, buffer);
 
    return buffer;
 }
@@ -497,6 +502,7 @@ _cache_vg_entry_render(Evas_Object_Protected_Data *obj,
 {
    Vg_Cache_Entry *vg_entry = pd->vg_entry;
    Efl_VG *root;
+   void *buffer;
 
    // if the size changed in between path set and the draw call;
 
@@ -506,23 +512,27 @@ _cache_vg_entry_render(Evas_Object_Protected_Data *obj,
          vg_entry = evas_cache_vg_entry_resize(vg_entry, w, h);
          evas_cache_vg_entry_del(pd->vg_entry);
          pd->vg_entry = vg_entry;
+         if (!vg_entry) return;
      }
    root = evas_cache_vg_tree_get(vg_entry);
    if (!root) return;
 
-   void *buffer = ENFN->ector_surface_cache_get(engine, root);
-
+   // the entry stands for (file, key, size) and its tree never changes, so
+   // a cached raster stays valid as long as the entry lives.
+   buffer = ENFN->ector_surface_cache_get(engine, vg_entry);
    if (!buffer)
-     buffer = _render_to_buffer(obj, pd, engine, root, w, h, NULL, do_async);
-   else
-     //cache reference was increased when we get the cache.
-     ENFN->ector_surface_cache_drop(engine, root);
+     buffer = _render_to_buffer(obj, pd, engine, root, w, h, vg_entry,
+                                NULL, do_async);
+   if (!buffer) return;
 
    _render_buffer_to_screen(obj,
                             engine, output, context, surface,
                             buffer,
                             x, y, w, h,
                             do_async);
+
+   //cache reference was increased when we got or set the cache.
+   ENFN->ector_surface_cache_drop(engine, vg_entry);
 }
 
 static void
@@ -532,43 +542,39 @@ _user_vg_entry_render(Evas_Object_Protected_Data *obj,
                       int x, int y, int w, int h, Eina_Bool do_async)
 {
    Vg_User_Entry *user_entry = pd->user_entry;
+   void *buffer;
 
    //if the size doesn't match, drop previous cache surface.
    if ((user_entry->w != w ) ||
        (user_entry->h != h))
      {
-         ENFN->ector_surface_cache_drop(engine, user_entry->root);
+         ENFN->ector_surface_cache_del(engine, user_entry->root);
          user_entry->w = w;
          user_entry->h = h;
      }
 
    //if the buffer is not created yet
-   void *buffer = ENFN->ector_surface_cache_get(engine, user_entry->root);
+   buffer = ENFN->ector_surface_cache_get(engine, user_entry->root);
 
+   // render to the buffer, again only if the node tree changed since.
    if (!buffer)
-     {
-        // render to the buffer
-        buffer = _render_to_buffer(obj, pd, engine, user_entry->root,
-                                   w, h, buffer, do_async);
-     }
-   else
-     {
-        // render to the buffer
-        if (pd->changed)
-          buffer = _render_to_buffer(obj, pd, engine,
-                                     user_entry->root,
-                                     w, h,
-                                     buffer,
-                                     do_async);
-        //cache reference was increased when we get the cache.
-        ENFN->ector_surface_cache_drop(engine, user_entry->root);
-     }
+     buffer = _render_to_buffer(obj, pd, engine, user_entry->root,
+                                w, h, user_entry->root,
+                                NULL, do_async);
+   else if (pd->changed)
+     _render_to_buffer(obj, pd, engine, user_entry->root,
+                       w, h, user_entry->root,
+                       buffer, do_async);
+   if (!buffer) return;
 
    _render_buffer_to_screen(obj,
                             engine, output, context, surface,
                             buffer,
                             x, y, w, h,
                             do_async);
+
+   //cache reference was increased when we got or set the cache.
+   ENFN->ector_surface_cache_drop(engine, user_entry->root);
 }
 
 static void
@@ -1,104 +1,169 @@
 #include "evas_common_private.h"
 
+/* Keeps rendered surfaces (vector graphics rasters) around by key pointer.
+ * A reference is held from _data_set or _data_get until _data_drop; entries
+ * nobody references stay cached and are evicted least recently used first
+ * once the cache grows over its item count or byte size. _data_del is for
+ * when the content behind a key changes, generic_cache_key_del() for when
+ * the key itself goes away and may be reused, in whatever cache holds it. */
+
+#define GENERIC_CACHE_MAX_COUNT 50
+#define GENERIC_CACHE_MAX_SIZE (32 * 1024 * 1024)
+
+// every cache generic_cache_key_del() has to look into
+static Eina_List *_generic_caches = NULL;
+
+static void
+_generic_cache_entry_free(Generic_Cache *cache, Generic_Cache_Entry *entry)
+{
+   eina_hash_del(cache->hash, &entry->key, entry);
+   cache->lru = eina_inlist_remove(cache->lru, EINA_INLIST_GET(entry));
+   cache->size -= entry->size;
+   cache->count--;
+   cache->free_func(cache->user_data, entry->data);
+   free(entry);
+}
+
+static void
+_generic_cache_trim(Generic_Cache *cache)
+{
+   Generic_Cache_Entry *entry;
+   Eina_Inlist *l;
+
+   if (!cache->lru) return;
+   l = cache->lru->last;
+   while (l && ((cache->count > cache->max_count) ||
+                (cache->size > cache->max_size)))
+     {
+        entry = EINA_INLIST_CONTAINER_GET(l, Generic_Cache_Entry);
+        l = l->prev;
+        // if its still being ref.
+        if (entry->ref) continue;
+        _generic_cache_entry_free(cache, entry);
+     }
+}
+
 EAPI Generic_Cache*
 generic_cache_new(void *user_data, Generic_Cache_Free func)
 {
    Generic_Cache *cache;
+   const char *s;
+
    cache = calloc(1, sizeof(Generic_Cache));
-   cache->hash = eina_hash_int32_new(NULL);
+   if (!cache) return NULL;
+   cache->hash = eina_hash_pointer_new(NULL);
    cache->user_data = user_data;
    cache->free_func = func;
+   cache->max_count = GENERIC_CACHE_MAX_COUNT;
+   cache->max_size = GENERIC_CACHE_MAX_SIZE;
+   s = getenv("EVAS_VG_CACHE_SIZE");
+   if (s) cache->max_size = (size_t)atoi(s) * 1024;
+   s = getenv("EVAS_VG_CACHE_MAX_ITEMS");
+   if (s) cache->max_count = atoi(s);
+   _generic_caches = eina_list_append(_generic_caches, cache);
    return cache;
 }
 
 EAPI void
 generic_cache_destroy(Generic_Cache *cache)
 {
+   if (!cache) return;
+   generic_cache_detach(cache);
    generic_cache_dump(cache);
    eina_hash_free(cache->hash);
+   free(cache);
+}
+
+// For a cache its owner goes away without destroying: its entries can not
+// be freed any more, so keys going away must not reach it.
+EAPI void
+generic_cache_detach(Generic_Cache *cache)
+{
+   if (!cache) return;
+   _generic_caches = eina_list_remove(_generic_caches, cache);
 }
 
 EAPI void
 generic_cache_dump(Generic_Cache *cache)
 {
    Generic_Cache_Entry *entry;
-   if (cache)
+
+   if (!cache) return;
+   while (cache->lru)
      {
-        eina_hash_free_buckets(cache->hash);
-        EINA_LIST_FREE(cache->lru_list, entry)
-          {
-             cache->free_func(cache->user_data, entry->data);
-             free(entry);
-          }
+        entry = EINA_INLIST_CONTAINER_GET(cache->lru, Generic_Cache_Entry);
+        _generic_cache_entry_free(cache, entry);
      }
 }
 
 EAPI void
-generic_cache_data_set(Generic_Cache *cache, void *key, void *surface)
+generic_cache_data_set(Generic_Cache *cache, void *key, void *surface, size_t size)
 {
-   Generic_Cache_Entry *entry = NULL;
-   int count;
+   Generic_Cache_Entry *entry;
+
+   entry = eina_hash_find(cache->hash, &key);
+   if (entry)
+     {
+        if (entry->data == surface) return;
+        _generic_cache_entry_free(cache, entry);
+     }
 
    entry = calloc(1, sizeof(Generic_Cache_Entry));
+   if (!entry) return;
    entry->key = key;
    entry->data = surface;
+   entry->size = size;
    entry->ref = 1;
-   eina_hash_add(cache->hash, &key, entry);
-   cache->lru_list = eina_list_prepend(cache->lru_list, entry);
-   count = eina_list_count(cache->lru_list);
-   if (count > 50)
-   {
-      entry = eina_list_data_get(eina_list_last(cache->lru_list));
-      // if its still being ref.
-      if (entry->ref) return;
-      eina_hash_del(cache->hash, &entry->key, entry);
-      cache->lru_list = eina_list_remove_list(cache->lru_list, eina_list_last(cache->lru_list));
-      cache->free_func(cache->user_data, entry->data);
-      free(entry);
-   }
+   eina_hash_add(cache->hash, &entry->key, entry);
+   cache->lru = eina_inlist_prepend(cache->lru, EINA_INLIST_GET(entry));
+   cache->size += size;
+   cache->count++;
+   _generic_cache_trim(cache);
 }
 
 EAPI void *
 generic_cache_data_get(Generic_Cache *cache, void *key)
 {
-   Generic_Cache_Entry *entry = NULL, *lru_data;
-   Eina_List *l;
+   Generic_Cache_Entry *entry;
 
-   entry =  eina_hash_find(cache->hash, &key);
-   if (entry)
-     {
-        // update the ref
-        entry->ref += 1;
-        // promote in lru
-        EINA_LIST_FOREACH(cache->lru_list, l, lru_data)
-          {
-            if (lru_data == entry)
-              {
-                 cache->lru_list = eina_list_promote_list(cache->lru_list, l);
-                 break;
-              }
-          }
-        return entry->data;
-     }
-   return NULL;
+   entry = eina_hash_find(cache->hash, &key);
+   if (!entry) return NULL;
+
+   // update the ref
+   entry->ref += 1;
+   // promote in lru
+   cache->lru = eina_inlist_promote(cache->lru, EINA_INLIST_GET(entry));
+   return entry->data;
 }
 
 EAPI void
 generic_cache_data_drop(Generic_Cache *cache, void *key)
 {
-   Generic_Cache_Entry *entry = NULL;
+   Generic_Cache_Entry *entry;
 
-   entry =  eina_hash_find(cache->hash, &key);
-   if (entry)
-     {
-        entry->ref -= 1;
-        // if its still being ref.
-        if (entry->ref) return;
-        eina_hash_del(cache->hash, &entry->key, entry);
-        // find and remove from lru list
-        cache->lru_list = eina_list_remove(cache->lru_list, entry);
-        cache->free_func(cache->user_data, entry->data);
-        free(entry);
-     }
+   entry = eina_hash_find(cache->hash, &key);
+   if (!entry || (entry->ref <= 0)) return;
+
+   entry->ref -= 1;
+   // keep it for the next user unless the cache is over its limits
+   if (!entry->ref) _generic_cache_trim(cache);
 }
 
+EAPI void
+generic_cache_data_del(Generic_Cache *cache, void *key)
+{
+   Generic_Cache_Entry *entry;
+
+   entry = eina_hash_find(cache->hash, &key);
+   if (entry) _generic_cache_entry_free(cache, entry);
+}
+
+EAPI void
+generic_cache_key_del(void *key)
+{
+   Generic_Cache *cache;
+   Eina_List *l;
+
+   EINA_LIST_FOREACH(_generic_caches, l, cache)
+     generic_cache_data_del(cache, key);
+}
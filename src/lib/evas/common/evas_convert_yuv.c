@@ -1,10 +1,15 @@
 #include "evas_common_private.h"
 #include "evas_convert_yuv.h"
+#include "evas_convert_yuv_private.h"
 
 #ifdef BUILD_MMX
 # include "evas_mmx.h"
 #endif
 
+#ifdef BUILD_NEON_INTRINSICS
+# include <arm_neon.h>
+#endif
+
 #ifdef HAVE_ALTIVEC_H
 # include <altivec.h>
 #ifdef CONFIG_DARWIN
@@ -32,20 +37,6 @@ static void _evas_yuy2torgb_raster (unsigned char **yuv, unsigned char *rgb, int
 static void _evas_nv12torgb_raster (unsigned char **yuv, unsigned char *rgb, int w, int h);
 static void _evas_nv12tiledtorgb_raster(unsigned char **yuv, unsigned char *rgb, int w, int h);
 
-#define CRV    104595
-#define CBU    132251
-#define CGU    25624
-#define CGV    53280
-
-#define YMUL   76283
-#define OFF    32768
-#define BITRES 16
-
-#define CRV709 117504
-#define CBU709 138607
-#define CGU709  13959
-#define CGV709  34996
-
 
 /* calculation float resolution in bits */
 /* ie RES = 6 is 10.6 fixed point */
@@ -152,11 +143,129 @@ static unsigned char _clip_lut[1024];
 
 static int initted = 0;
 
+#ifdef BUILD_NEON_INTRINSICS
+# define YUV_USING_NEON
+# define YUV_SIMD_FUNC(Name) Name##_neon
+# include "evas_convert_yuv_simd.c"
+#endif
+
+/* Frames are converted row by row by the best SIMD row converters the CPU
+ * has, and split in bands over the evas worker threads when
+ * EVAS_YUV_THREADS is set and the frame is big enough. Without SIMD the
+ * whole frame converters below are used. */
+#define YUV_THREADS_MIN_PIXELS (640 * 480)
+#define YUV_THREADS_MIN_ROWS 16
+
+typedef struct _Evas_YUV_Row_Funcs Evas_YUV_Row_Funcs;
+typedef struct _Evas_YUV_Rows_Job  Evas_YUV_Rows_Job;
+
+typedef enum
+{
+   EVAS_YUV_ROWS_420P_601,
+   EVAS_YUV_ROWS_420P_709,
+   EVAS_YUV_ROWS_NV12,
+   EVAS_YUV_ROWS_YUY2
+} Evas_YUV_Rows_Format;
+
+struct _Evas_YUV_Row_Funcs
+{
+   void (*planar) (const DATA8 *yp, const DATA8 *up, const DATA8 *vp, DATA32 *dst, int w, Eina_Bool bt709);
+   void (*nv12)   (const DATA8 *yp, const DATA8 *uvp, DATA32 *dst, int w);
+   void (*yuy2)   (const DATA8 *p, DATA32 *dst, int w);
+};
+
+struct _Evas_YUV_Rows_Job
+{
+   Evas_YUV_Rows_Format format;
+   DATA8 **src;
+   DATA32 *dst;
+   int w, h;
+};
+
+#ifdef BUILD_AVX2
+static const Evas_YUV_Row_Funcs _yuv_rows_avx2 =
+{
+   evas_common_convert_yuv_420p_row_avx2,
+   evas_common_convert_yuv_nv12_row_avx2,
+   evas_common_convert_yuv_yuy2_row_avx2
+};
+#endif
+#ifdef BUILD_SSE3
+static const Evas_YUV_Row_Funcs _yuv_rows_sse3 =
+{
+   evas_common_convert_yuv_420p_row_sse3,
+   evas_common_convert_yuv_nv12_row_sse3,
+   evas_common_convert_yuv_yuy2_row_sse3
+};
+#endif
+#ifdef BUILD_NEON_INTRINSICS
+static const Evas_YUV_Row_Funcs _yuv_rows_neon =
+{
+   evas_common_convert_yuv_420p_row_neon,
+   evas_common_convert_yuv_nv12_row_neon,
+   evas_common_convert_yuv_yuy2_row_neon
+};
+#endif
+
+static const Evas_YUV_Row_Funcs *_yuv_rows = NULL;
+static Eina_Bool _yuv_threads = EINA_FALSE;
+
+static void
+_evas_yuv_rows_do(void *data, int start, int end)
+{
+   Evas_YUV_Rows_Job *job = data;
+   DATA8 **yuv = job->src;
+   DATA32 *dst;
+   int w = job->w, h = job->h;
+   int y;
+
+   for (y = start; y < end; y++)
+     {
+        dst = job->dst + (y * w);
+        switch (job->format)
+          {
+           case EVAS_YUV_ROWS_420P_601:
+           case EVAS_YUV_ROWS_420P_709:
+             _yuv_rows->planar(yuv[y], yuv[h + (y / 2)],
+                               yuv[h + (h / 2) + (y / 2)], dst, w,
+                               job->format == EVAS_YUV_ROWS_420P_709);
+             break;
+           case EVAS_YUV_ROWS_NV12:
+             _yuv_rows->nv12(yuv[y], yuv[h + (y / 2)], dst, w);
+             break;
+           case EVAS_YUV_ROWS_YUY2:
+             _yuv_rows->yuy2(yuv[y], dst, w);
+             break;
+          }
+     }
+}
+
+static void
+_evas_yuv_rows_convert(Evas_YUV_Rows_Format format, DATA8 **src, DATA8 *dst, int w, int h)
+{
+   Evas_YUV_Rows_Job job;
+
+   job.format = format;
+   job.src = src;
+   job.dst = (DATA32 *)dst;
+   job.w = w;
+   job.h = h;
+   if (_yuv_threads && ((w * h) >= YUV_THREADS_MIN_PIXELS))
+     evas_common_parallel_run(_evas_yuv_rows_do, &job, h, YUV_THREADS_MIN_ROWS);
+   else
+     _evas_yuv_rows_do(&job, 0, h);
+}
+
 void
 evas_common_convert_yuv_422p_709_rgba(DATA8 **src, DATA8 *dst, int w, int h)
 {
    if (!initted) _evas_yuv_init();
    initted = 1;
+   if (_yuv_rows)
+     {
+        _evas_yuv_rows_convert(EVAS_YUV_ROWS_420P_709, src, dst, w, h);
+        return;
+     }
 /* Broken atm - the sse and mmx get math.. wrong :(
    if (evas_common_cpu_has_feature(CPU_FEATURE_MMX2))
      _evas_yv12_709torgb_sse(src, dst, w, h);
@@ -173,7 +282,9 @@ evas_common_convert_yuv_422p_601_rgba(DATA8 **src, DATA8 *dst, int w, int h)
 {
    if (!initted) _evas_yuv_init();
    initted = 1;
-   if (evas_common_cpu_has_feature(CPU_FEATURE_MMX2))
+   if (_yuv_rows)
+     _evas_yuv_rows_convert(EVAS_YUV_ROWS_420P_601, src, dst, w, h);
+   else if (evas_common_cpu_has_feature(CPU_FEATURE_MMX2))
      _evas_yv12torgb_sse(src, dst, w, h);
    else if (evas_common_cpu_has_feature(CPU_FEATURE_MMX))
      _evas_yv12torgb_mmx(src, dst, w, h);
@@ -1097,6 +1208,20 @@ _evas_yuv_init(void)
      {
 	_clip_lut[i+384] = i < 0 ? 0 : (i > 255) ? 255 : i;
      }
+
+#ifdef BUILD_NEON_INTRINSICS
+   if (evas_common_cpu_has_feature(CPU_FEATURE_NEON))
+     _yuv_rows = &_yuv_rows_neon;
+#endif
+#ifdef BUILD_SSE3
+   if (evas_common_cpu_has_feature(CPU_FEATURE_SSE3))
+     _yuv_rows = &_yuv_rows_sse3;
+#endif
+#ifdef BUILD_AVX2
+   if (evas_common_cpu_has_feature(CPU_FEATURE_AVX2))
+     _yuv_rows = &_yuv_rows_avx2;
+#endif
+   _yuv_threads = !!getenv("EVAS_YUV_THREADS");
 }
 
 #ifdef BUILD_ALTIVEC
@@ -1309,7 +1434,10 @@ evas_common_convert_yuv_422_601_rgba(DATA8 **src, DATA8 *dst, int w, int h)
 {
    if (!initted) _evas_yuv_init();
    initted = 1;
-   _evas_yuy2torgb_raster(src, dst, w, h);
+   if (_yuv_rows)
+     _evas_yuv_rows_convert(EVAS_YUV_ROWS_YUY2, src, dst, w, h);
+   else
+     _evas_yuy2torgb_raster(src, dst, w, h);
 }
 
 void
@@ -1317,13 +1445,16 @@ evas_common_convert_yuv_420_601_rgba(DATA8 **src, DATA8 *dst, int w, int h)
 {
    if (!initted) _evas_yuv_init();
    initted = 1;
-   _evas_nv12torgb_raster(src, dst, w, h);
+   if (_yuv_rows)
+     _evas_yuv_rows_convert(EVAS_YUV_ROWS_NV12, src, dst, w, h);
+   else
+     _evas_nv12torgb_raster(src, dst, w, h);
 }
 
 void
 evas_common_convert_yuv_420T_601_rgba(DATA8 **src, DATA8 *dst, int w, int h)
 {
-   if (initted) _evas_yuv_init();
+   if (!initted) _evas_yuv_init();
    initted = 1;
    _evas_nv12tiledtorgb_raster(src, dst, w, h);
 }
@@ -1471,15 +1602,25 @@ _evas_nv12tiledtorgb_raster(unsigned char **yuv, unsigned char *rgb, int w, int
                                                                         \
      for (i = 0; i < 32; i += 2)                                        \
        {                                                                \
-          for (j = 0; j < 64; j += 2)                                   \
+          if (_yuv_rows)                                                \
+            {                                                           \
+               _yuv_rows->nv12(YP1, UP, (DATA32 *)DP1, 64);             \
+               _yuv_rows->nv12(YP2, UP, (DATA32 *)DP2, 64);             \
+               DP1 += 64 * 4; DP2 += 64 * 4;                            \
+               YP1 += 64; YP2 += 64; UP += 64; VP += 64;                \
+            }                                                           \
+          else                                                          \
             {                                                           \
-               _evas_yuv2rgb_420_raster(YP1, YP2, UP, VP, DP1, DP2);    \
+               for (j = 0; j < 64; j += 2)                              \
+                 {                                                      \
+                    _evas_yuv2rgb_420_raster(YP1, YP2, UP, VP, DP1, DP2); \
                                                                         \
-               /* the previous call just rendered 2 pixels per lines */ \
-               DP1 += 8; DP2 += 8;                                      \
+                    /* the previous call just rendered 2 pixels per lines */ \
+                    DP1 += 8; DP2 += 8;                                 \
                                                                         \
-               /* and took for that 2 lines with 2 Y, 1 U and 1 V. Don't forget U & V are in the same plane */ \
-               YP1 += 2; YP2 += 2; UP += 2; VP += 2;                    \
+                    /* and took for that 2 lines with 2 Y, 1 U and 1 V. Don't forget U & V are in the same plane */ \
+                    YP1 += 2; YP2 += 2; UP += 2; VP += 2;               \
+                 }                                                      \
             }                                                           \
                                                                         \
           DP1 += sizeof (int) * ((w << 1) - 64);			\
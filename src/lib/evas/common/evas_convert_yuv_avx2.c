@@ -0,0 +1,13 @@
+#include "evas_common_private.h"
+#include "evas_convert_yuv_private.h"
+
+/* YUV row converters built with -mavx2, see evas_convert_yuv_simd.c. They
+ * are only called when the CPU has AVX2. */
+
+#ifdef BUILD_AVX2
+# include <immintrin.h>
+
+# define YUV_USING_AVX2
+# define YUV_SIMD_FUNC(Name) Name##_avx2
+# include "evas_convert_yuv_simd.c"
+#endif
@@ -0,0 +1,36 @@
+#ifndef _EVAS_CONVERT_YUV_PRIVATE_H
+#define _EVAS_CONVERT_YUV_PRIVATE_H
+
+/* 16.16 fixed point YUV to RGB constants */
+#define CRV    104595
+#define CBU    132251
+#define CGU    25624
+#define CGV    53280
+
+#define YMUL   76283
+#define OFF    32768
+#define BITRES 16
+
+#define CRV709 117504
+#define CBU709 138607
+#define CGU709  13959
+#define CGV709  34996
+
+/* Row converters, see evas_convert_yuv_simd.c */
+#ifdef BUILD_SSE3
+void evas_common_convert_yuv_420p_row_sse3(const DATA8 *yp, const DATA8 *up, const DATA8 *vp, DATA32 *dst, int w, Eina_Bool bt709);
+void evas_common_convert_yuv_nv12_row_sse3(const DATA8 *yp, const DATA8 *uvp, DATA32 *dst, int w);
+void evas_common_convert_yuv_yuy2_row_sse3(const DATA8 *p, DATA32 *dst, int w);
+#endif
+#ifdef BUILD_AVX2
+void evas_common_convert_yuv_420p_row_avx2(const DATA8 *yp, const DATA8 *up, const DATA8 *vp, DATA32 *dst, int w, Eina_Bool bt709);
+void evas_common_convert_yuv_nv12_row_avx2(const DATA8 *yp, const DATA8 *uvp, DATA32 *dst, int w);
+void evas_common_convert_yuv_yuy2_row_avx2(const DATA8 *p, DATA32 *dst, int w);
+#endif
+#ifdef BUILD_NEON_INTRINSICS
+void evas_common_convert_yuv_420p_row_neon(const DATA8 *yp, const DATA8 *up, const DATA8 *vp, DATA32 *dst, int w, Eina_Bool bt709);
+void evas_common_convert_yuv_nv12_row_neon(const DATA8 *yp, const DATA8 *uvp, DATA32 *dst, int w);
+void evas_common_convert_yuv_yuy2_row_neon(const DATA8 *p, DATA32 *dst, int w);
+#endif
+
+#endif /* _EVAS_CONVERT_YUV_PRIVATE_H */
@@ -0,0 +1,407 @@
+/* YUV to RGBA row converters, included by the SSE3, AVX2 and NEON builds.
+ *
+ * They all compute the 16.16 fixed point formula of the C NV12 path:
+ *   Y' = (Y - 16) * YMUL
+ *   R  = (Y' + V * CRV) >> 16
+ *   G  = (Y' - (V * CGV + U * CGU) + OFF) >> 16
+ *   B  = (Y' + U * CBU + OFF) >> 16
+ * with U and V centered on 0, and give the same pixels as it for every
+ * format. The x86 kernels only have 16 bit multiplies, so each constant
+ * K is split in K == (hi << s) + lo and applied with one madd:
+ *   x * K == ((x << s) * hi) + (x * lo)
+ * The shifts are the same for BT.601 and BT.709, only hi/lo differ.
+ *
+ * YUV_SIMD_FUNC(Name) names the exported row functions of the build.
+ */
+
+typedef struct _Evas_YUV_Simd_Coefs Evas_YUV_Simd_Coefs;
+
+struct _Evas_YUV_Simd_Coefs
+{
+   int   crv, cbu, cgu, cgv;
+   short crv_hi, crv_lo;   /* (v << 2) * hi + v * lo */
+   short cbu_hi, cbu_lo;   /* (u << 3) * hi + u * lo */
+   short cgv_hi, cgu_lo;   /* (v << 1) * hi + u * lo */
+};
+
+static const Evas_YUV_Simd_Coefs _yuv_simd_601 =
+{
+   CRV, CBU, CGU, CGV,
+   CRV >> 2, CRV & 3,
+   CBU >> 3, CBU & 7,
+   CGV >> 1, CGU
+};
+
+static const Evas_YUV_Simd_Coefs _yuv_simd_709 =
+{
+   CRV709, CBU709, CGU709, CGV709,
+   CRV709 >> 2, CRV709 & 3,
+   CBU709 >> 3, CBU709 & 7,
+   CGV709 >> 1, CGU709
+};
+
+#define YUV_SIMD_YMUL_HI (YMUL >> 2)
+#define YUV_SIMD_YMUL_LO (YMUL & 3)
+
+static inline int
+_yuv_simd_clip(int v)
+{
+   return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+static inline DATA32
+_yuv_simd_pixel(const Evas_YUV_Simd_Coefs *k, int y, int u, int v)
+{
+   int r, g, b;
+
+   y = (y - 16) * YMUL;
+   u -= 128;
+   v -= 128;
+   r = (y + (v * k->crv)) >> 16;
+   g = (y - ((v * k->cgv) + (u * k->cgu)) + OFF) >> 16;
+   b = (y + (u * k->cbu) + OFF) >> 16;
+   return 0xff000000 + RGB_JOIN(_yuv_simd_clip(r), _yuv_simd_clip(g), _yuv_simd_clip(b));
+}
+
+#if defined(YUV_USING_AVX2) || defined(YUV_USING_SSE2)
+
+# define YUV_SIMD_PAIR(Hi, Lo) \
+   (int)(((unsigned int)(unsigned short)(Lo) << 16) | (unsigned short)(Hi))
+
+static inline __m128i
+_yuv_simd_load32(const DATA8 *p)
+{
+   int v;
+
+   memcpy(&v, p, sizeof(v));
+   return _mm_cvtsi32_si128(v);
+}
+
+/* 16 bit lanes holding U0 V0 U1 V1 ... to U0 U0 U1 U1 ... and V0 V0 ... */
+static inline void
+_yuv_simd_split_uv(__m128i uv, __m128i *u, __m128i *v)
+{
+   const __m128i lo = _mm_set1_epi32(0xffff);
+   __m128i t;
+
+   t = _mm_and_si128(uv, lo);
+   *u = _mm_or_si128(t, _mm_slli_epi32(t, 16));
+   t = _mm_srli_epi32(uv, 16);
+   *v = _mm_or_si128(t, _mm_slli_epi32(t, 16));
+}
+
+#endif
+
+#ifdef YUV_USING_SSE2
+
+/* 8 pixels, Y, U and V as 16 bit lanes, U and V already doubled */
+static inline void
+_yuv_simd_block(const Evas_YUV_Simd_Coefs *k, DATA32 *dst,
+                __m128i y, __m128i u, __m128i v)
+{
+   const __m128i ky = _mm_set1_epi32(YUV_SIMD_PAIR(YUV_SIMD_YMUL_HI, YUV_SIMD_YMUL_LO));
+   const __m128i kr = _mm_set1_epi32(YUV_SIMD_PAIR(k->crv_hi, k->crv_lo));
+   const __m128i kb = _mm_set1_epi32(YUV_SIMD_PAIR(k->cbu_hi, k->cbu_lo));
+   const __m128i kg = _mm_set1_epi32(YUV_SIMD_PAIR(k->cgv_hi, k->cgu_lo));
+   const __m128i off = _mm_set1_epi32(OFF);
+   const __m128i alpha = _mm_set1_epi16(0xff);
+   __m128i yl, yh, rl, rh, gl, gh, bl, bh, r, g, b, bg, ra;
+
+   y = _mm_sub_epi16(y, _mm_set1_epi16(16));
+   u = _mm_sub_epi16(u, _mm_set1_epi16(128));
+   v = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+   yl = _mm_madd_epi16(_mm_unpacklo_epi16(_mm_slli_epi16(y, 2), y), ky);
+   yh = _mm_madd_epi16(_mm_unpackhi_epi16(_mm_slli_epi16(y, 2), y), ky);
+
+   rl = _mm_add_epi32(yl, _mm_madd_epi16(_mm_unpacklo_epi16(_mm_slli_epi16(v, 2), v), kr));
+   rh = _mm_add_epi32(yh, _mm_madd_epi16(_mm_unpackhi_epi16(_mm_slli_epi16(v, 2), v), kr));
+   gl = _mm_sub_epi32(_mm_add_epi32(yl, off),
+                      _mm_madd_epi16(_mm_unpacklo_epi16(_mm_slli_epi16(v, 1), u), kg));
+   gh = _mm_sub_epi32(_mm_add_epi32(yh, off),
+                      _mm_madd_epi16(_mm_unpackhi_epi16(_mm_slli_epi16(v, 1), u), kg));
+   bl = _mm_add_epi32(_mm_add_epi32(yl, off),
+                      _mm_madd_epi16(_mm_unpacklo_epi16(_mm_slli_epi16(u, 3), u), kb));
+   bh = _mm_add_epi32(_mm_add_epi32(yh, off),
+                      _mm_madd_epi16(_mm_unpackhi_epi16(_mm_slli_epi16(u, 3), u), kb));
+
+   r = _mm_packs_epi32(_mm_srai_epi32(rl, 16), _mm_srai_epi32(rh, 16));
+   g = _mm_packs_epi32(_mm_srai_epi32(gl, 16), _mm_srai_epi32(gh, 16));
+   b = _mm_packs_epi32(_mm_srai_epi32(bl, 16), _mm_srai_epi32(bh, 16));
+
+   bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+   ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(alpha, alpha));
+   _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(bg, ra));
+   _mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(bg, ra));
+}
+
+# define YUV_SIMD_STEP 8
+
+static inline void
+_yuv_simd_planar(const Evas_YUV_Simd_Coefs *k, DATA32 *dst,
+                 const DATA8 *yp, const DATA8 *up, const DATA8 *vp)
+{
+   const __m128i zero = _mm_setzero_si128();
+   __m128i y, u, v;
+
+   y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)yp), zero);
+   u = _mm_unpacklo_epi8(_yuv_simd_load32(up), zero);
+   v = _mm_unpacklo_epi8(_yuv_simd_load32(vp), zero);
+   _yuv_simd_block(k, dst, y, _mm_unpacklo_epi16(u, u), _mm_unpacklo_epi16(v, v));
+}
+
+static inline void
+_yuv_simd_nv12(DATA32 *dst, const DATA8 *yp, const DATA8 *uvp)
+{
+   const __m128i zero = _mm_setzero_si128();
+   __m128i y, u, v;
+
+   y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)yp), zero);
+   _yuv_simd_split_uv(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)uvp), zero), &u, &v);
+   _yuv_simd_block(&_yuv_simd_601, dst, y, u, v);
+}
+
+static inline void
+_yuv_simd_yuy2(DATA32 *dst, const DATA8 *p)
+{
+   __m128i x, u, v;
+
+   x = _mm_loadu_si128((const __m128i *)p);
+   _yuv_simd_split_uv(_mm_srli_epi16(x, 8), &u, &v);
+   _yuv_simd_block(&_yuv_simd_601, dst,
+                   _mm_and_si128(x, _mm_set1_epi16(0xff)), u, v);
+}
+
+#endif
+
+#ifdef YUV_USING_AVX2
+
+/* 16 pixels, Y, U and V as 16 bit lanes, U and V already doubled */
+static inline void
+_yuv_simd_block(const Evas_YUV_Simd_Coefs *k, DATA32 *dst,
+                __m256i y, __m256i u, __m256i v)
+{
+   const __m256i ky = _mm256_set1_epi32(YUV_SIMD_PAIR(YUV_SIMD_YMUL_HI, YUV_SIMD_YMUL_LO));
+   const __m256i kr = _mm256_set1_epi32(YUV_SIMD_PAIR(k->crv_hi, k->crv_lo));
+   const __m256i kb = _mm256_set1_epi32(YUV_SIMD_PAIR(k->cbu_hi, k->cbu_lo));
+   const __m256i kg = _mm256_set1_epi32(YUV_SIMD_PAIR(k->cgv_hi, k->cgu_lo));
+   const __m256i off = _mm256_set1_epi32(OFF);
+   const __m256i alpha = _mm256_set1_epi16(0xff);
+   __m256i yl, yh, rl, rh, gl, gh, bl, bh, r, g, b, bg, ra, p0, p1;
+
+   y = _mm256_sub_epi16(y, _mm256_set1_epi16(16));
+   u = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+   v = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+
+   /* the unpacks work inside 128 bit lanes and the packs below undo them */
+   yl = _mm256_madd_epi16(_mm256_unpacklo_epi16(_mm256_slli_epi16(y, 2), y), ky);
+   yh = _mm256_madd_epi16(_mm256_unpackhi_epi16(_mm256_slli_epi16(y, 2), y), ky);
+
+   rl = _mm256_add_epi32(yl, _mm256_madd_epi16(_mm256_unpacklo_epi16(_mm256_slli_epi16(v, 2), v), kr));
+   rh = _mm256_add_epi32(yh, _mm256_madd_epi16(_mm256_unpackhi_epi16(_mm256_slli_epi16(v, 2), v), kr));
+   gl = _mm256_sub_epi32(_mm256_add_epi32(yl, off),
+                         _mm256_madd_epi16(_mm256_unpacklo_epi16(_mm256_slli_epi16(v, 1), u), kg));
+   gh = _mm256_sub_epi32(_mm256_add_epi32(yh, off),
+                         _mm256_madd_epi16(_mm256_unpackhi_epi16(_mm256_slli_epi16(v, 1), u), kg));
+   bl = _mm256_add_epi32(_mm256_add_epi32(yl, off),
+                         _mm256_madd_epi16(_mm256_unpacklo_epi16(_mm256_slli_epi16(u, 3), u), kb));
+   bh = _mm256_add_epi32(_mm256_add_epi32(yh, off),
+                         _mm256_madd_epi16(_mm256_unpackhi_epi16(_mm256_slli_epi16(u, 3), u), kb));
+
+   r = _mm256_packs_epi32(_mm256_srai_epi32(rl, 16), _mm256_srai_epi32(rh, 16));
+   g = _mm256_packs_epi32(_mm256_srai_epi32(gl, 16), _mm256_srai_epi32(gh, 16));
+   b = _mm256_packs_epi32(_mm256_srai_epi32(bl, 16), _mm256_srai_epi32(bh, 16));
+
+   bg = _mm256_unpacklo_epi8(_mm256_packus_epi16(b, b), _mm256_packus_epi16(g, g));
+   ra = _mm256_unpacklo_epi8(_mm256_packus_epi16(r, r), _mm256_packus_epi16(alpha, alpha));
+   p0 = _mm256_unpacklo_epi16(bg, ra);
+   p1 = _mm256_unpackhi_epi16(bg, ra);
+   _mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(p0, p1, 0x20));
+   _mm256_storeu_si256((__m256i *)(dst + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+}
+
+# define YUV_SIMD_STEP 16
+
+static inline __m256i
+_yuv_simd_double(__m128i c)
+{
+   return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(c, c)),
+                                  _mm_unpackhi_epi16(c, c), 1);
+}
+
+static inline void
+_yuv_simd_planar(const Evas_YUV_Simd_Coefs *k, DATA32 *dst,
+                 const DATA8 *yp, const DATA8 *up, const DATA8 *vp)
+{
+   __m256i y;
+
+   y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)yp));
+   _yuv_simd_block(k, dst, y,
+                   _yuv_simd_double(_mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)up))),
+                   _yuv_simd_double(_mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)vp))));
+}
+
+static inline void
+_yuv_simd_nv12(DATA32 *dst, const DATA8 *yp, const DATA8 *uvp)
+{
+   __m128i u0, v0, u1, v1, uv;
+   __m256i y;
+
+   y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)yp));
+   uv = _mm_loadu_si128((const __m128i *)uvp);
+   _yuv_simd_split_uv(_mm_cvtepu8_epi16(uv), &u0, &v0);
+   _yuv_simd_split_uv(_mm_cvtepu8_epi16(_mm_srli_si128(uv, 8)), &u1, &v1);
+   _yuv_simd_block(&_yuv_simd_601, dst, y,
+                   _mm256_inserti128_si256(_mm256_castsi128_si256(u0), u1, 1),
+                   _mm256_inserti128_si256(_mm256_castsi128_si256(v0), v1, 1));
+}
+
+static inline void
+_yuv_simd_yuy2(DATA32 *dst, const DATA8 *p)
+{
+   __m128i x0, x1, u0, v0, u1, v1;
+   __m256i y;
+
+   x0 = _mm_loadu_si128((const __m128i *)p);
+   x1 = _mm_loadu_si128((const __m128i *)(p + 16));
+   _yuv_simd_split_uv(_mm_srli_epi16(x0, 8), &u0, &v0);
+   _yuv_simd_split_uv(_mm_srli_epi16(x1, 8), &u1, &v1);
+   y = _mm256_and_si256(_mm256_inserti128_si256(_mm256_castsi128_si256(x0), x1, 1),
+                        _mm256_set1_epi16(0xff));
+   _yuv_simd_block(&_yuv_simd_601, dst, y,
+                   _mm256_inserti128_si256(_mm256_castsi128_si256(u0), u1, 1),
+                   _mm256_inserti128_si256(_mm256_castsi128_si256(v0), v1, 1));
+}
+
+#endif
+
+#ifdef YUV_USING_NEON
+
+static inline uint8x8_t
+_yuv_simd_channel(int32x4_t l, int32x4_t h)
+{
+   return vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(l, 16)),
+                                   vqmovn_s32(vshrq_n_s32(h, 16))));
+}
+
+/* 8 pixels, Y, U and V as 16 bit lanes, U and V already doubled */
+static inline void
+_yuv_simd_block(const Evas_YUV_Simd_Coefs *k, DATA32 *dst,
+                uint16x8_t y16, uint16x8_t u16, uint16x8_t v16)
+{
+   int16x8_t y, u, v;
+   int32x4_t yl, yh, ul, uh, vl, vh, off;
+   uint8x8x4_t px;
+
+   y = vsubq_s16(vreinterpretq_s16_u16(y16), vdupq_n_s16(16));
+   u = vsubq_s16(vreinterpretq_s16_u16(u16), vdupq_n_s16(128));
+   v = vsubq_s16(vreinterpretq_s16_u16(v16), vdupq_n_s16(128));
+   off = vdupq_n_s32(OFF);
+
+   yl = vmulq_n_s32(vmovl_s16(vget_low_s16(y)), YMUL);
+   yh = vmulq_n_s32(vmovl_s16(vget_high_s16(y)), YMUL);
+   ul = vmovl_s16(vget_low_s16(u));
+   uh = vmovl_s16(vget_high_s16(u));
+   vl = vmovl_s16(vget_low_s16(v));
+   vh = vmovl_s16(vget_high_s16(v));
+
+   px.val[2] = _yuv_simd_channel(vmlaq_n_s32(yl, vl, k->crv),
+                                 vmlaq_n_s32(yh, vh, k->crv));
+   px.val[1] = _yuv_simd_channel(vsubq_s32(vaddq_s32(yl, off),
+                                           vmlaq_n_s32(vmulq_n_s32(vl, k->cgv), ul, k->cgu)),
+                                 vsubq_s32(vaddq_s32(yh, off),
+                                           vmlaq_n_s32(vmulq_n_s32(vh, k->cgv), uh, k->cgu)));
+   px.val[0] = _yuv_simd_channel(vmlaq_n_s32(vaddq_s32(yl, off), ul, k->cbu),
+                                 vmlaq_n_s32(vaddq_s32(yh, off), uh, k->cbu));
+   px.val[3] = vdup_n_u8(0xff);
+   vst4_u8((uint8_t *)dst, px);
+}
+
+# define YUV_SIMD_STEP 8
+
+static inline void
+_yuv_simd_planar(const Evas_YUV_Simd_Coefs *k, DATA32 *dst,
+                 const DATA8 *yp, const DATA8 *up, const DATA8 *vp)
+{
+   uint32_t cu, cv;
+   uint8x8_t u, v;
+
+   memcpy(&cu, up, sizeof(cu));
+   memcpy(&cv, vp, sizeof(cv));
+   u = vcreate_u8(cu);
+   v = vcreate_u8(cv);
+   _yuv_simd_block(k, dst, vmovl_u8(vld1_u8(yp)),
+                   vmovl_u8(vzip_u8(u, u).val[0]),
+                   vmovl_u8(vzip_u8(v, v).val[0]));
+}
+
+static inline void
+_yuv_simd_nv12(DATA32 *dst, const DATA8 *yp, const DATA8 *uvp)
+{
+   uint16x4x2_t uv;
+   uint16x8_t c;
+
+   /* U0 V0 U1 V1 ... widened to 16 bit lanes, then split and doubled */
+   c = vmovl_u8(vld1_u8(uvp));
+   uv = vuzp_u16(vget_low_u16(c), vget_high_u16(c));
+   _yuv_simd_block(&_yuv_simd_601, dst, vmovl_u8(vld1_u8(yp)),
+                   vcombine_u16(vzip_u16(uv.val[0], uv.val[0]).val[0],
+                                vzip_u16(uv.val[0], uv.val[0]).val[1]),
+                   vcombine_u16(vzip_u16(uv.val[1], uv.val[1]).val[0],
+                                vzip_u16(uv.val[1], uv.val[1]).val[1]));
+}
+
+static inline void
+_yuv_simd_yuy2(DATA32 *dst, const DATA8 *p)
+{
+   uint8x8x2_t x;
+
+   /* even bytes are Y, odd bytes are U0 V0 U1 V1 ... */
+   x = vld2_u8(p);
+   _yuv_simd_block(&_yuv_simd_601, dst, vmovl_u8(x.val[0]),
+                   vmovl_u8(vtrn_u8(x.val[1], x.val[1]).val[0]),
+                   vmovl_u8(vtrn_u8(x.val[1], x.val[1]).val[1]));
+}
+
+#endif
+
+void
+YUV_SIMD_FUNC(evas_common_convert_yuv_420p_row)(const DATA8 *yp, const DATA8 *up, const DATA8 *vp,
+                                                DATA32 *dst, int w, Eina_Bool bt709)
+{
+   const Evas_YUV_Simd_Coefs *k = bt709 ? &_yuv_simd_709 : &_yuv_simd_601;
+   int x;
+
+   for (x = 0; x + YUV_SIMD_STEP <= w; x += YUV_SIMD_STEP)
+     _yuv_simd_planar(k, dst + x, yp + x, up + (x / 2), vp + (x / 2));
+   for (; x < w; x++)
+     dst[x] = _yuv_simd_pixel(k, yp[x], up[x / 2], vp[x / 2]);
+}
+
+void
+YUV_SIMD_FUNC(evas_common_convert_yuv_nv12_row)(const DATA8 *yp, const DATA8 *uvp,
+                                                DATA32 *dst, int w)
+{
+   int x;
+
+   for (x = 0; x + YUV_SIMD_STEP <= w; x += YUV_SIMD_STEP)
+     _yuv_simd_nv12(dst + x, yp + x, uvp + x);
+   for (; x < w; x++)
+     dst[x] = _yuv_simd_pixel(&_yuv_simd_601, yp[x],
+                              uvp[x & ~1], uvp[(x & ~1) + 1]);
+}
+
+void
+YUV_SIMD_FUNC(evas_common_convert_yuv_yuy2_row)(const DATA8 *p, DATA32 *dst, int w)
+{
+   int x;
+
+   for (x = 0; x + YUV_SIMD_STEP <= w; x += YUV_SIMD_STEP)
+     _yuv_simd_yuy2(dst + x, p + (x * 2));
+   for (; x < w; x++)
+     {
+        const DATA8 *c = p + ((x & ~1) * 2);
+
+        dst[x] = _yuv_simd_pixel(&_yuv_simd_601, p[x * 2], c[1], c[3]);
+     }
+}
@@ -0,0 +1,13 @@
+#include "evas_common_private.h"
+#include "evas_convert_yuv_private.h"
+
+/* YUV row converters built with -msse3 (SSE2 code), see
+ * evas_convert_yuv_simd.c. They are only called when the CPU has SSE3. */
+
+#ifdef BUILD_SSE3
+# include <emmintrin.h>
+
+# define YUV_USING_SSE2
+# define YUV_SIMD_FUNC(Name) Name##_sse3
+# include "evas_convert_yuv_simd.c"
+#endif
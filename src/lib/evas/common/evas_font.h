@@ -127,6 +127,7 @@ typedef struct _RGBA_Font_Int         RGBA_Font_Int;
 typedef struct _RGBA_Font_Source      RGBA_Font_Source;
 typedef struct _RGBA_Font_Glyph       RGBA_Font_Glyph;
 typedef struct _RGBA_Font_Glyph_Out   RGBA_Font_Glyph_Out;
+typedef struct _RGBA_Font_Glyph_Cache RGBA_Font_Glyph_Cache;
 
 typedef struct _Fash_Item_Index_Map Fash_Item_Index_Map;
 typedef struct _Fash_Int_Map        Fash_Int_Map;
@@ -246,6 +247,7 @@ struct _RGBA_Font_Int
    RGBA_Font_Source *src;
    Eina_Hash        *kerning;
    Fash_Glyph       *fash;
+   RGBA_Font_Glyph_Cache *glyph_cache;
    unsigned int      size;
    float             scale_factor;
    int               real_size;
@@ -313,6 +315,7 @@ struct _RGBA_Font_Glyph
    Evas_Coord      width;
    Evas_Coord      x_bear;
    Evas_Coord      y_bear;
+   FT_Vector       advance; /* 16.16, NULL glyph if loaded from the disk cache */
    FT_Glyph        glyph;
    RGBA_Font_Glyph_Out *glyph_out;
    /* this is a problem - only 1 engine at a time can extend such a font... grrr */
@@ -0,0 +1,470 @@
+#include "evas_font_private.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* On-disk glyph cache.
+ *
+ * When EVAS_FONT_GLYPH_CACHE_DIR is set, the compressed (RLE/4bpp) bitmaps
+ * rendered for a font instance are written to a file in that directory
+ * when the instance is freed. Other processes using the same font file,
+ * size, hinting and rendering flags map that file read-only and point their
+ * glyphs straight to it, skipping FT_Load_Glyph() and the rasterization.
+ *
+ * A cache file is never modified in place: new glyphs are merged with the
+ * existing ones in a temporary file that is then renamed over the old one,
+ * so mappings held by other processes stay valid.
+ *
+ * File layout (native byte order, 4 bytes aligned):
+ *   Glyph_Cache_Header
+ *   key (key_size bytes, nul terminated, padded)
+ *   Glyph_Cache_Entry[count], sorted by glyph index
+ *   compressed bitmaps
+ */
+
+#define GLYPH_CACHE_MAGIC 0x45474331 /* EGC1 */
+#define GLYPH_CACHE_VERSION 1
+#define GLYPH_CACHE_HINTINGS 3
+#define GLYPH_CACHE_ALIGN(x) (((x) + 3) & ~3)
+
+typedef struct _Glyph_Cache_Header Glyph_Cache_Header;
+typedef struct _Glyph_Cache_Entry Glyph_Cache_Entry;
+typedef struct _Glyph_Cache_Pending Glyph_Cache_Pending;
+typedef struct _Glyph_Cache_Map Glyph_Cache_Map;
+
+struct _Glyph_Cache_Header
+{
+   unsigned int magic;
+   unsigned int version;
+   unsigned int key_size;
+   unsigned int count;
+};
+
+struct _Glyph_Cache_Entry
+{
+   unsigned int   index;
+   int            width;
+   int            x_bear;
+   int            y_bear;
+   int            advance_x;
+   int            advance_y;
+   unsigned short rows;
+   unsigned short bitmap_width;
+   unsigned short pitch;
+   unsigned short pad;
+   unsigned int   offset;
+   unsigned int   rle_size;
+};
+
+struct _Glyph_Cache_Pending
+{
+   Glyph_Cache_Entry entry;
+   const unsigned char *rle;
+};
+
+struct _Glyph_Cache_Map
+{
+   Eina_File                *f;
+   const Glyph_Cache_Header *header;
+   const Glyph_Cache_Entry  *entries;
+   size_t                    size;
+   Eina_Inarray             *pending;
+   char                     *key;
+   char                     *path;
+   Eina_Bool                 opened : 1;
+};
+
+struct _RGBA_Font_Glyph_Cache
+{
+   Glyph_Cache_Map hint[GLYPH_CACHE_HINTINGS];
+   char           *id;
+};
+
+static LK(lock_glyph_cache);
+
+void
+evas_common_font_glyph_cache_init(void)
+{
+   LKI(lock_glyph_cache);
+}
+
+void
+evas_common_font_glyph_cache_shutdown(void)
+{
+   LKD(lock_glyph_cache);
+}
+
+/* Identifies the font instance: font file (or data), face, size and
+ * rendering flags. The hinting is added per map. */
+static char *
+_glyph_cache_id_get(RGBA_Font_Int *fi)
+{
+   RGBA_Font_Source *fs = fi->src;
+   FT_Size_Metrics *m;
+   char buf[PATH_MAX + 256];
+   struct stat st;
+   int len;
+
+   if ((!fs) || (!fs->ft.face) || (!fi->ft.size)) return NULL;
+   if (FT_HAS_COLOR(fs->ft.face)) return NULL;
+
+   if (fs->file)
+     {
+        if (stat(fs->file, &st) != 0) return NULL;
+        len = snprintf(buf, sizeof(buf), "file:%s:%lld:%lld",
+                       fs->file, (long long)st.st_size,
+                       (long long)st.st_mtime);
+     }
+   else if (fs->data)
+     len = snprintf(buf, sizeof(buf), "data:%d:%08x:%08x", fs->data_size,
+                    eina_hash_superfast(fs->data, fs->data_size),
+                    eina_hash_murmur3(fs->data, fs->data_size));
+   else return NULL;
+   if ((len < 0) || (len >= (int)sizeof(buf))) return NULL;
+
+   m = &fi->ft.size->metrics;
+   len += snprintf(buf + len, sizeof(buf) - len, ":%ld:%u:%d:%ld:%ld:%u:%u:%d",
+                   (long)fs->ft.face->face_index, fi->size, fi->real_size,
+                   (long)m->x_scale, (long)m->y_scale,
+                   m->x_ppem, m->y_ppem, fi->runtime_rend);
+   if (len >= (int)sizeof(buf)) return NULL;
+
+   return strdup(buf);
+}
+
+static void
+_glyph_cache_map_open(Glyph_Cache_Map *map, const char *dir, const char *id,
+                      Font_Hint_Flags hinting)
+{
+   const Glyph_Cache_Header *header;
+   char buf[PATH_MAX];
+   size_t size, entries;
+   int len;
+
+   map->opened = EINA_TRUE;
+
+   len = snprintf(buf, sizeof(buf), "%s:%d", id, hinting);
+   if ((len < 0) || (len >= (int)sizeof(buf))) return;
+   map->key = strdup(buf);
+   if (!map->key) return;
+
+   len = snprintf(buf, sizeof(buf), "%s/%08x%08x.glyphs", dir,
+                  eina_hash_superfast(map->key, strlen(map->key)),
+                  eina_hash_murmur3(map->key, strlen(map->key)));
+   if ((len < 0) || (len >= (int)sizeof(buf))) return;
+   map->path = strdup(buf);
+   if (!map->path) return;
+
+   map->f = eina_file_open(map->path, EINA_FALSE);
+   if (!map->f) return;
+
+   size = eina_file_size_get(map->f);
+   header = eina_file_map_all(map->f, EINA_FILE_RANDOM);
+   if (!header) goto on_error;
+
+   if ((size < sizeof(Glyph_Cache_Header)) ||
+       (header->magic != GLYPH_CACHE_MAGIC) ||
+       (header->version != GLYPH_CACHE_VERSION) ||
+       (header->key_size != GLYPH_CACHE_ALIGN(strlen(map->key) + 1)) ||
+       (size < sizeof(Glyph_Cache_Header) + header->key_size) ||
+       (strcmp((const char *)(header + 1), map->key)))
+     goto on_error;
+
+   entries = (size - sizeof(Glyph_Cache_Header) - header->key_size) /
+     sizeof(Glyph_Cache_Entry);
+   if (header->count > entries) goto on_error;
+
+   map->header = header;
+   map->size = size;
+   map->entries = (const Glyph_Cache_Entry *)
+     ((const char *)(header + 1) + header->key_size);
+   return;
+
+on_error:
+   INF("Ignoring invalid glyph cache '%s'", map->path);
+   if (header) eina_file_map_free(map->f, (void *)header);
+   eina_file_close(map->f);
+   map->f = NULL;
+}
+
+static Glyph_Cache_Map *
+_glyph_cache_map_get(RGBA_Font_Int *fi)
+{
+   RGBA_Font_Glyph_Cache *gc;
+   const char *dir;
+
+   if ((unsigned int)fi->hinting >= GLYPH_CACHE_HINTINGS) return NULL;
+
+   gc = fi->glyph_cache;
+   if (!gc)
+     {
+        dir = getenv("EVAS_FONT_GLYPH_CACHE_DIR");
+        if ((!dir) || (!dir[0])) return NULL;
+
+        gc = calloc(1, sizeof(RGBA_Font_Glyph_Cache));
+        if (!gc) return NULL;
+        gc->id = _glyph_cache_id_get(fi);
+        fi->glyph_cache = gc;
+        mkdir(dir, S_IRWXU);
+     }
+   if (!gc->id) return NULL;
+
+   if (!gc->hint[fi->hinting].opened)
+     {
+        dir = getenv("EVAS_FONT_GLYPH_CACHE_DIR");
+        if ((!dir) || (!dir[0])) return NULL;
+        _glyph_cache_map_open(&gc->hint[fi->hinting], dir, gc->id, fi->hinting);
+     }
+
+   return &gc->hint[fi->hinting];
+}
+
+RGBA_Font_Glyph *
+evas_common_font_glyph_cache_find(RGBA_Font_Int *fi, FT_UInt idx)
+{
+   const Glyph_Cache_Entry *e = NULL;
+   RGBA_Font_Glyph *fg = NULL;
+   Glyph_Cache_Map *map;
+   int lo, hi;
+
+   LKL(lock_glyph_cache);
+   map = _glyph_cache_map_get(fi);
+   if ((!map) || (!map->header)) goto end;
+
+   lo = 0;
+   hi = (int)map->header->count - 1;
+   while (lo <= hi)
+     {
+        int mid = (lo + hi) / 2;
+
+        if (map->entries[mid].index == idx)
+          {
+             e = &map->entries[mid];
+             break;
+          }
+        if (map->entries[mid].index < idx) lo = mid + 1;
+        else hi = mid - 1;
+     }
+   if (!e) goto end;
+
+   if ((e->rle_size < sizeof(int)) || (e->offset & 3) ||
+       (e->offset > map->size) || (e->rle_size > map->size - e->offset))
+     goto end;
+
+   fg = calloc(1, sizeof(RGBA_Font_Glyph));
+   if (!fg) goto end;
+   fg->glyph_out = calloc(1, sizeof(RGBA_Font_Glyph_Out));
+   if (!fg->glyph_out)
+     {
+        free(fg);
+        fg = NULL;
+        goto end;
+     }
+
+   fg->index = idx;
+   fg->fi = fi;
+   fg->width = e->width;
+   fg->x_bear = e->x_bear;
+   fg->y_bear = e->y_bear;
+   fg->advance.x = e->advance_x;
+   fg->advance.y = e->advance_y;
+
+   // The bitmap points to the mapped file, rle_alloc is not set so it is
+   // never freed
+   fg->glyph_out->rle = (unsigned char *)map->header + e->offset;
+   fg->glyph_out->rle_size = e->rle_size;
+   fg->glyph_out->bitmap.rows = e->rows;
+   fg->glyph_out->bitmap.width = e->bitmap_width;
+   fg->glyph_out->bitmap.pitch = e->pitch;
+
+end:
+   LKU(lock_glyph_cache);
+   return fg;
+}
+
+void
+evas_common_font_glyph_cache_add(RGBA_Font_Int *fi, RGBA_Font_Glyph *fg)
+{
+   RGBA_Font_Glyph_Out *fgo = fg->glyph_out;
+   Glyph_Cache_Pending p;
+   Glyph_Cache_Map *map;
+   unsigned char *rle;
+
+   if ((!fgo) || (!fgo->rle) || (fgo->rle_size < (int)sizeof(int))) return;
+
+   LKL(lock_glyph_cache);
+   map = _glyph_cache_map_get(fi);
+   if ((!map) || (!map->path)) goto end;
+
+   if (!map->pending)
+     {
+        map->pending = eina_inarray_new(sizeof(Glyph_Cache_Pending), 64);
+        if (!map->pending) goto end;
+     }
+
+   rle = malloc(fgo->rle_size);
+   if (!rle) goto end;
+   memcpy(rle, fgo->rle, fgo->rle_size);
+
+   memset(&p, 0, sizeof(p));
+   p.entry.index = fg->index;
+   p.entry.width = fg->width;
+   p.entry.x_bear = fg->x_bear;
+   p.entry.y_bear = fg->y_bear;
+   p.entry.advance_x = fg->advance.x;
+   p.entry.advance_y = fg->advance.y;
+   p.entry.rows = fgo->bitmap.rows;
+   p.entry.bitmap_width = fgo->bitmap.width;
+   p.entry.pitch = fgo->bitmap.pitch;
+   p.entry.rle_size = fgo->rle_size;
+   p.rle = rle;
+   if (eina_inarray_push(map->pending, &p) < 0) free(rle);
+
+end:
+   LKU(lock_glyph_cache);
+}
+
+static int
+_glyph_cache_pending_cmp(const void *a, const void *b)
+{
+   const Glyph_Cache_Pending *pa = a, *pb = b;
+
+   if (pa->entry.index < pb->entry.index) return -1;
+   if (pa->entry.index > pb->entry.index) return 1;
+   return 0;
+}
+
+static void
+_glyph_cache_map_save(Glyph_Cache_Map *map)
+{
+   Glyph_Cache_Header header;
+   Glyph_Cache_Pending *all, *p;
+   char tmp[PATH_MAX];
+   unsigned int count = 0, i, n, offset;
+   static const char zero[4] = { 0 };
+   FILE *f;
+   int fd;
+
+   n = eina_inarray_count(map->pending);
+   if (map->header) n += map->header->count;
+   all = malloc(n * sizeof(Glyph_Cache_Pending));
+   if (!all) return;
+
+   EINA_INARRAY_FOREACH(map->pending, p)
+     all[count++] = *p;
+   for (i = 0; map->header && (i < map->header->count); i++)
+     {
+        const Glyph_Cache_Entry *e = &map->entries[i];
+
+        if ((e->rle_size < sizeof(int)) || (e->offset > map->size) ||
+            (e->rle_size > map->size - e->offset))
+          continue;
+        all[count].entry = *e;
+        all[count].rle = (const unsigned char *)map->header + e->offset;
+        count++;
+     }
+
+   // A glyph rendered twice gives the same bitmap, keep only one of them
+   qsort(all, count, sizeof(Glyph_Cache_Pending), _glyph_cache_pending_cmp);
+   for (i = 0, n = 0; i < count; i++)
+     {
+        if ((n > 0) && (all[n - 1].entry.index == all[i].entry.index))
+          continue;
+        all[n++] = all[i];
+     }
+   count = n;
+
+   header.magic = GLYPH_CACHE_MAGIC;
+   header.version = GLYPH_CACHE_VERSION;
+   header.key_size = GLYPH_CACHE_ALIGN(strlen(map->key) + 1);
+   header.count = count;
+
+   offset = sizeof(header) + header.key_size + count * sizeof(Glyph_Cache_Entry);
+   for (i = 0; i < count; i++)
+     {
+        all[i].entry.offset = offset;
+        all[i].entry.pad = 0;
+        offset += GLYPH_CACHE_ALIGN(all[i].entry.rle_size);
+     }
+
+   snprintf(tmp, sizeof(tmp), "%s.%d.tmp", map->path, (int)getpid());
+   fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+   if (fd < 0) goto end;
+   f = fdopen(fd, "wb");
+   if (!f)
+     {
+        close(fd);
+        unlink(tmp);
+        goto end;
+     }
+
+   if (fwrite(&header, sizeof(header), 1, f) != 1) goto on_error;
+   if (fwrite(map->key, strlen(map->key), 1, f) != 1) goto on_error;
+   if (fwrite(zero, header.key_size - strlen(map->key), 1, f) != 1) goto on_error;
+   for (i = 0; i < count; i++)
+     if (fwrite(&all[i].entry, sizeof(Glyph_Cache_Entry), 1, f) != 1)
+       goto on_error;
+   for (i = 0; i < count; i++)
+     {
+        unsigned int size = all[i].entry.rle_size;
+
+        if (fwrite(all[i].rle, size, 1, f) != 1) goto on_error;
+        if ((GLYPH_CACHE_ALIGN(size) != size) &&
+            (fwrite(zero, GLYPH_CACHE_ALIGN(size) - size, 1, f) != 1))
+          goto on_error;
+     }
+
+   if (fclose(f) != 0)
+     {
+        unlink(tmp);
+        goto end;
+     }
+   if (rename(tmp, map->path) != 0)
+     {
+        WRN("Could not write glyph cache '%s'", map->path);
+        unlink(tmp);
+     }
+   goto end;
+
+on_error:
+   fclose(f);
+   unlink(tmp);
+end:
+   free(all);
+}
+
+void
+evas_common_font_glyph_cache_free(RGBA_Font_Int *fi)
+{
+   RGBA_Font_Glyph_Cache *gc = fi->glyph_cache;
+   Glyph_Cache_Pending *p;
+   int i;
+
+   if (!gc) return;
+
+   LKL(lock_glyph_cache);
+   for (i = 0; i < GLYPH_CACHE_HINTINGS; i++)
+     {
+        Glyph_Cache_Map *map = &gc->hint[i];
+
+        if (map->pending)
+          {
+             if (eina_inarray_count(map->pending) && map->path)
+               _glyph_cache_map_save(map);
+             EINA_INARRAY_FOREACH(map->pending, p)
+               free((void *)p->rle);
+             eina_inarray_free(map->pending);
+          }
+        if (map->header)
+          eina_file_map_free(map->f, (void *)map->header);
+        if (map->f) eina_file_close(map->f);
+        free(map->key);
+        free(map->path);
+     }
+   free(gc->id);
+   free(gc);
+   fi->glyph_cache = NULL;
+   LKU(lock_glyph_cache);
+}
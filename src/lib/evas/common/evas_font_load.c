@@ -92,6 +92,7 @@ _evas_common_font_int_free(RGBA_Font_Int *fi)
    evas_common_font_source_free(fi->src);
    if (fi->references <= 0) fonts_lru = eina_list_remove(fonts_lru, fi);
    if (fi->fash) fi->fash->freeme(fi->fash);
+   evas_common_font_glyph_cache_free(fi);
    if (fi->inuse)
     {
       fonts_use_lru = eina_inlist_remove(fonts_use_lru, EINA_INLIST_GET(fi));
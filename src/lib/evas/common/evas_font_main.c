@@ -41,6 +41,7 @@ evas_common_font_init(void)
                    &interpreter_version);
    evas_common_font_load_init();
    evas_common_font_draw_init();
+   evas_common_font_glyph_cache_init();
    s = getenv("EVAS_FONT_DPI");
    if (s)
      {
@@ -66,6 +67,7 @@ evas_common_font_shutdown(void)
    evas_common_font_load_shutdown();
    evas_common_font_cache_set(0);
    evas_common_font_flush();
+   evas_common_font_glyph_cache_shutdown();
 
    FT_Done_FreeType(evas_ft_lib);
    evas_ft_lib = 0;
@@ -537,6 +539,15 @@ evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt idx)
 //   if (fg) return fg;
 
    evas_common_font_int_reload(fi);
+
+   fg = evas_common_font_glyph_cache_find(fi, idx);
+   if (fg)
+     {
+        if (!fi->fash) fi->fash = _fash_gl_new();
+        if (fi->fash) _fash_gl_add(fi->fash, idx, fg);
+        return fg;
+     }
+
    FTLOCK();
    error = FT_Load_Glyph(fi->src->ft.face, idx,
                          (FT_HAS_COLOR(fi->src->ft.face) ?
@@ -596,6 +607,7 @@ evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt idx)
           }
      }
 
+   fg->advance = fg->glyph->advance;
    fg->index = idx;
    fg->fi = fi;
 
@@ -661,6 +673,8 @@ evas_common_font_int_cache_glyph_render(RGBA_Font_Glyph *fg)
         // this may be technically incorrect as we go and free a bitmap buffer
         // behind the ftglyph's back...
         FT_Bitmap_Done(evas_ft_lib, &(fbg->bitmap));
+
+        evas_common_font_glyph_cache_add(fi, fg);
      }
    else
      {
@@ -188,7 +188,7 @@ _evas_common_font_ot_hb_get_glyph_advance(hb_font_t *font,
    fg = evas_common_font_int_cache_glyph_get(fi, glyph);
    if (fg)
      {
-        return fg->glyph->advance.x >> 10;
+        return fg->advance.x >> 10;
      }
    return 0;
 }
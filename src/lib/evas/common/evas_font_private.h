@@ -64,6 +64,12 @@ void evas_common_font_int_use_trim(void);
 void evas_common_font_int_unload(RGBA_Font_Int *fi);
 void evas_common_font_int_reload(RGBA_Font_Int *fi);
 
+void evas_common_font_glyph_cache_init(void);
+void evas_common_font_glyph_cache_shutdown(void);
+RGBA_Font_Glyph *evas_common_font_glyph_cache_find(RGBA_Font_Int *fi, FT_UInt idx);
+void evas_common_font_glyph_cache_add(RGBA_Font_Int *fi, RGBA_Font_Glyph *fg);
+void evas_common_font_glyph_cache_free(RGBA_Font_Int *fi);
+
 /* 6th bit is on is the same as frac part >= 0.5 */
 # define EVAS_FONT_ROUND_26_6_TO_INT(x) \
    (((x + 0x20) & -0x40) >> 6)
@@ -42,6 +42,8 @@ EAPI unsigned int evas_common_rgba_image_scalecache_size_get(void);
 EAPI void evas_common_rgba_image_scalecache_flush(void);
 EAPI void evas_common_rgba_image_scalecache_dump(void);
 EAPI void evas_common_rgba_image_scalecache_prune(void);
+/* Splits big smooth downscales in bands, as EVAS_SCALECACHE_THREADS=1 does */
+EAPI void evas_common_rgba_image_scalecache_threads_set(Eina_Bool threads);
 EAPI Eina_Bool
   evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst,
                                             RGBA_Draw_Context *dc, int smooth,
@@ -70,6 +72,15 @@ EAPI Eina_Bool
 EAPI int evas_common_load_rgba_image_module_from_file (Image_Entry *im);
 EAPI int evas_common_load_rgba_image_data_from_file   (Image_Entry *im);
 EAPI double evas_common_load_rgba_image_frame_duration_from_file(Image_Entry *im, int start_frame, int frame_num);
+EAPI Eina_Bool evas_common_load_rgba_image_frame_decode(Image_Entry *im, int index);
+
+void evas_common_load_animated_init(void);
+void evas_common_load_animated_shutdown(void);
+void evas_common_load_animated_frames_free(Image_Entry *ie);
+EAPI Image_Entry_Frame *evas_common_load_animated_frame_get(Evas_Image_Animated *animated, int index);
+EAPI int evas_common_load_animated_frame_wanted(Evas_Image_Animated *animated);
+EAPI void evas_common_load_animated_frame_data_set(Evas_Image_Animated *animated, Image_Entry_Frame *frame, DATA32 *data, size_t size, const Image_Entry_Frame *keep);
+EAPI void evas_common_load_animated_frame_used(Evas_Image_Animated *animated, Image_Entry_Frame *frame);
 
 void _evas_common_rgba_image_post_surface(Image_Entry *ie);
 EAPI int _evas_common_rgba_image_surface_size(unsigned int w, unsigned int h, Evas_Colorspace cspace, /* inout */ int *l, int *r, int *t, int *b);
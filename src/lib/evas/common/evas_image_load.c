@@ -166,6 +166,21 @@ static const char *loaders_name[] =
   "bmp", "tga", "wbmp", "ico", "psd", "jp2k", "dds", "generic"
 };
 
+/* Animated images: loaders append their Image_Entry_Frame to
+ * animated->frames in file_head, evas then indexes them by number. Frames
+ * a loader decodes are handed to one lru shared by all images, so the least
+ * recently used frames are dropped first whatever image they belong to,
+ * except for the frames of images whose loader is running. Loaders that
+ * hand their frames over can also be asked to decode a frame ahead of
+ * playback, with no pixels to fill. */
+#define ANIMATED_FRAMES_MAX_SIZE (64 * 1024 * 1024)
+
+static SLK(frames_lock);
+static size_t frames_size = 0;
+static size_t frames_max_size = ANIMATED_FRAMES_MAX_SIZE;
+static Eina_Inlist *frames_lru = NULL; // most recently used first
+static int frames_init = 0;
+
 struct evas_image_foreach_loader_data
 {
    Image_Entry *ie;
@@ -173,6 +188,50 @@ struct evas_image_foreach_loader_data
    Evas_Module *em;
 };
 
+// the loaders are given &ie->animated
+static inline Image_Entry *
+_animated_entry_get(Evas_Image_Animated *animated)
+{
+   return (Image_Entry *)((char *)animated - offsetof(Image_Entry, animated));
+}
+
+// while a loader runs, other images do not drop the frames it reads
+static void
+_animated_busy_set(Image_Entry *ie, Eina_Bool busy)
+{
+   SLKL(frames_lock);
+   if (busy) ie->frames.busy++;
+   else ie->frames.busy--;
+   SLKU(frames_lock);
+}
+
+static void
+_animated_frames_index(Image_Entry *ie)
+{
+   Image_Entry_Frame *frame;
+   Eina_List *l;
+   int count = 0;
+
+   free(ie->frames.index);
+   ie->frames.index = NULL;
+   ie->frames.count = 0;
+
+   EINA_LIST_FOREACH(ie->animated.frames, l, frame)
+     {
+        if (frame->index > count) count = frame->index;
+     }
+   if (count < 1) return;
+
+   ie->frames.index = calloc(count + 1, sizeof(Image_Entry_Frame *));
+   if (!ie->frames.index) return;
+   ie->frames.count = count;
+   EINA_LIST_FOREACH(ie->animated.frames, l, frame)
+     {
+        if ((frame->index > 0) && (!ie->frames.index[frame->index]))
+          ie->frames.index[frame->index] = frame;
+     }
+}
+
 static Eina_Bool
 _evas_image_file_header(Evas_Module *em, Image_Entry *ie, int *error)
 {
@@ -226,6 +285,7 @@ _evas_image_file_header(Evas_Module *em, Image_Entry *ie, int *error)
              if (property.cspaces) ie->cspaces = property.cspaces;
              ie->flags.rotated = property.rotated;
              ie->flags.flipped = property.flipped;
+             if (ie->animated.frames) _animated_frames_index(ie);
              r = EINA_FALSE;
           }
         else
@@ -470,7 +530,9 @@ end:
         return EVAS_LOAD_ERROR_RESOURCE_ALLOCATION_FAILED;
      }
 
+   _animated_busy_set(ie, EINA_TRUE);
    evas_image_load_func->file_data(ie->loader_data, &property, pixels, &ret);
+   _animated_busy_set(ie, EINA_FALSE);
 
    ie->flags.alpha_sparse = property.alpha_sparse;
 
@@ -496,6 +558,187 @@ evas_common_load_rgba_image_frame_duration_from_file(Image_Entry *ie, const int
    return -1;
 }
 
+EAPI Eina_Bool
+evas_common_load_rgba_image_frame_decode(Image_Entry *ie, int index)
+{
+   Evas_Image_Load_Func *evas_image_load_func = NULL;
+   Evas_Image_Property property;
+   Image_Entry_Frame *frame;
+   int ret = EVAS_LOAD_ERROR_NONE;
+
+   if ((!ie->info.module) || (!ie->loader_data) || (!ie->f)) return EINA_FALSE;
+   // only loaders handing their frames to us know about decode
+   if (!ie->frames.managed) return EINA_FALSE;
+
+   frame = evas_common_load_animated_frame_get(&ie->animated, index);
+   if (!frame) return EINA_FALSE;
+
+   // nothing drops the frames of a busy image, frame->data stays valid
+   _animated_busy_set(ie, EINA_TRUE);
+   if (frame->data)
+     {
+        _animated_busy_set(ie, EINA_FALSE);
+        return EINA_TRUE;
+     }
+
+   evas_image_load_func = ie->info.loader;
+   evas_module_use(ie->info.module);
+
+   memset(&property, 0, sizeof (property));
+   property.w = ie->w;
+   property.h = ie->h;
+   property.scale = ie->scale;
+   property.rotated = ie->flags.rotated;
+   property.flipped = ie->flags.flipped;
+   property.cspace = ie->space;
+
+   ie->frames.decode = index;
+   evas_image_load_func->file_data(ie->loader_data, &property, NULL, &ret);
+   ie->frames.decode = 0;
+   _animated_busy_set(ie, EINA_FALSE);
+
+   return (ret == EVAS_LOAD_ERROR_NONE);
+}
+
+void
+evas_common_load_animated_init(void)
+{
+   const char *s;
+
+   frames_init++;
+   if (frames_init > 1) return;
+   SLKI(frames_lock);
+   s = getenv("EVAS_ANIMATED_CACHE_SIZE");
+   if (s) frames_max_size = (size_t)atoi(s) * 1024;
+}
+
+void
+evas_common_load_animated_shutdown(void)
+{
+   frames_init--;
+   if (frames_init == 0)
+     SLKD(frames_lock);
+}
+
+// frames_lock held
+static void
+_animated_frame_data_free(Image_Entry_Frame *frame)
+{
+   if (frame->size)
+     {
+        frames_lru = eina_inlist_remove(frames_lru, EINA_INLIST_GET(frame));
+        frame->ie->frames.size -= frame->size;
+        frames_size -= frame->size;
+        frame->size = 0;
+        frame->ie = NULL;
+     }
+   free(frame->data);
+   frame->data = NULL;
+}
+
+// frames_lock held, drop the least recently used frames of all images
+// while over the budget
+static void
+_animated_frames_trim(Image_Entry *ie, const Image_Entry_Frame *keep1,
+                      const Image_Entry_Frame *keep2)
+{
+   Image_Entry_Frame *frame;
+   Eina_Inlist *l;
+
+   if (!frames_lru) return;
+   l = frames_lru->last;
+   while ((l) && (frames_size > frames_max_size))
+     {
+        frame = EINA_INLIST_CONTAINER_GET(l, Image_Entry_Frame);
+        l = l->prev;
+        if ((frame == keep1) || (frame == keep2)) continue;
+        // another loader may be reading the frames of its image
+        if ((frame->ie != ie) && (frame->ie->frames.busy)) continue;
+        _animated_frame_data_free(frame);
+     }
+}
+
+void
+evas_common_load_animated_frames_free(Image_Entry *ie)
+{
+   Image_Entry_Frame *frame;
+
+   SLKL(frames_lock);
+   EINA_LIST_FREE(ie->animated.frames, frame)
+     {
+        _animated_frame_data_free(frame);
+        if (frame->info) free(frame->info);
+        free(frame);
+     }
+   SLKU(frames_lock);
+   free(ie->frames.index);
+   ie->frames.index = NULL;
+   ie->frames.count = 0;
+}
+
+EAPI Image_Entry_Frame *
+evas_common_load_animated_frame_get(Evas_Image_Animated *animated, int index)
+{
+   Image_Entry *ie = _animated_entry_get(animated);
+   Image_Entry_Frame *frame;
+   Eina_List *l;
+
+   if (ie->frames.index)
+     {
+        if ((index < 1) || (index > ie->frames.count)) return NULL;
+        return ie->frames.index[index];
+     }
+   // not indexed yet, still reading the header
+   EINA_LIST_FOREACH(animated->frames, l, frame)
+     {
+        if (frame->index == index) return frame;
+     }
+   return NULL;
+}
+
+EAPI int
+evas_common_load_animated_frame_wanted(Evas_Image_Animated *animated)
+{
+   Image_Entry *ie = _animated_entry_get(animated);
+
+   if (ie->frames.decode > 0) return ie->frames.decode;
+   return animated->cur_frame;
+}
+
+EAPI void
+evas_common_load_animated_frame_data_set(Evas_Image_Animated *animated,
+                                         Image_Entry_Frame *frame,
+                                         DATA32 *data, size_t size,
+                                         const Image_Entry_Frame *keep)
+{
+   Image_Entry *ie = _animated_entry_get(animated);
+
+   SLKL(frames_lock);
+   if (frame->data) _animated_frame_data_free(frame);
+   frame->data = data;
+   if (data)
+     {
+        frame->ie = ie;
+        frame->size = size;
+        frames_lru = eina_inlist_prepend(frames_lru, EINA_INLIST_GET(frame));
+        ie->frames.size += size;
+        ie->frames.managed = EINA_TRUE;
+        frames_size += size;
+        _animated_frames_trim(ie, frame, keep);
+     }
+   SLKU(frames_lock);
+}
+
+EAPI void
+evas_common_load_animated_frame_used(Evas_Image_Animated *animated EINA_UNUSED,
+                                     Image_Entry_Frame *frame)
+{
+   SLKL(frames_lock);
+   if (frame->size)
+     frames_lru = eina_inlist_promote(frames_lru, EINA_INLIST_GET(frame));
+   SLKU(frames_lock);
+}
+
 EAPI Eina_Bool
 evas_common_extension_can_load_get(const char *file)
 {
@@ -437,6 +437,8 @@ evas_common_image_init(void)
    reference++;
 
    evas_common_scalecache_init();
+   evas_common_load_animated_init();
+   evas_common_parallel_init();
 }
 
 EAPI void
@@ -463,6 +465,8 @@ evas_common_image_shutdown(void)
        evas_cache_image_shutdown(eci);
        eci = NULL;
      }
+   evas_common_parallel_shutdown();
+   evas_common_load_animated_shutdown();
    evas_common_scalecache_shutdown();
 }
 
@@ -507,17 +511,7 @@ _evas_common_rgba_image_delete(Image_Entry *ie)
    evas_common_rgba_image_scalecache_shutdown(&im->cache_entry);
    if (ie->info.module) evas_module_unref((Evas_Module *)ie->info.module);
 
-   if (ie->animated.frames)
-     {
-        Image_Entry_Frame *frame;
-
-        EINA_LIST_FREE(ie->animated.frames, frame)
-          {
-             if (frame->data) free(frame->data);
-             if (frame->info) free(frame->info);
-             free(frame);
-          }
-     }
+   if (ie->animated.frames) evas_common_load_animated_frames_free(ie);
    if (ie->f && !ie->flags.given_mmap) eina_file_close(ie->f);
    eina_freeq_ptr_add(eina_freeq_main_get(), im, free, sizeof(*im));
 }
@@ -22,6 +22,8 @@
 #define MAX_FLOP_COUNT 16
 #define FLOP_DEL 1
 #define SCALE_CACHE_SIZE 4 * 1024 * 1024
+#define MIN_BAND_SRC_SIZE (512 * 512)
+#define MIN_BAND_ROWS 16
 //#define SCALE_CACHE_SIZE 0
 
 typedef struct _ScaleitemKey ScaleitemKey;
@@ -64,6 +66,7 @@ static unsigned int max_dimension = MAX_SCALECACHE_DIM;
 static unsigned int max_flop_count = MAX_FLOP_COUNT;
 static unsigned int max_scale_items = MAX_SCALEITEMS;
 static unsigned int min_scale_uses = MIN_SCALE_USES;
+static Eina_Bool band_threads = EINA_FALSE;
 #endif
 
 static int
@@ -129,6 +132,8 @@ evas_common_scalecache_init(void)
    if (s) max_scale_items = atoi(s);
    s = getenv("EVAS_SCALECACHE_MIN_USES");
    if (s) min_scale_uses = atoi(s);
+   s = getenv("EVAS_SCALECACHE_THREADS");
+   if (s) band_threads = !!atoi(s);
 #endif
 }
 
@@ -456,6 +461,14 @@ evas_common_rgba_image_scalecache_size_get(void)
 #endif   
 }
 
+EAPI void
+evas_common_rgba_image_scalecache_threads_set(Eina_Bool threads)
+{
+#ifdef SCALECACHE
+   band_threads = !!threads;
+#endif
+}
+
 EAPI void
 evas_common_rgba_image_scalecache_prune(void)
 {
@@ -622,6 +635,112 @@ evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst EINA_
 }
 
 #ifdef SCALECACHE
+typedef struct _Scale_Band Scale_Band;
+
+struct _Scale_Band
+{
+   Evas_Common_Scale_In_To_Out_Clip_Cb cb;
+   RGBA_Image *src, *dst;
+   RGBA_Draw_Context *dc;
+   int src_region_x, src_region_y, src_region_w, src_region_h;
+   int dst_region_x, dst_region_y, dst_region_w, dst_region_h;
+   int y;
+   // set by whichever band draws, from several threads
+   Eina_Bool ret;
+#ifndef __ATOMIC_RELAXED
+   Eina_Spinlock lock;
+#endif
+};
+
+static void
+_scale_band_run(void *data, int start, int end)
+{
+   Scale_Band *b = data;
+   RGBA_Draw_Context dc;
+
+   dc = *b->dc;
+   evas_common_draw_context_clip_clip(&dc, b->dst_region_x, b->y + start,
+                                      b->dst_region_w, end - start);
+   if (b->cb(b->src, b->dst, &dc,
+             b->src_region_x, b->src_region_y,
+             b->src_region_w, b->src_region_h,
+             b->dst_region_x, b->dst_region_y,
+             b->dst_region_w, b->dst_region_h))
+     {
+#ifdef __ATOMIC_RELAXED
+        __atomic_store_n(&b->ret, EINA_TRUE, __ATOMIC_RELAXED);
+#else
+        eina_spinlock_take(&b->lock);
+        b->ret = EINA_TRUE;
+        eina_spinlock_release(&b->lock);
+#endif
+     }
+}
+
+/* Big downscales that miss the cache are split into horizontal bands of
+ * the destination and scaled on the worker threads. The smooth scaler
+ * derives every row from the region alone, so a band gives exactly the
+ * pixels the whole call would have drawn there.
+ */
+static Eina_Bool
+_scale_smooth(Evas_Common_Scale_In_To_Out_Clip_Cb cb_smooth,
+              RGBA_Image *im, RGBA_Image *dst, RGBA_Draw_Context *dc,
+              int src_region_x, int src_region_y,
+              int src_region_w, int src_region_h,
+              int dst_region_x, int dst_region_y,
+              int dst_region_w, int dst_region_h)
+{
+   Scale_Band b;
+   int y1, y2;
+
+   if ((!band_threads) || (dc->cutout.active) ||
+       ((src_region_w * src_region_h) < MIN_BAND_SRC_SIZE) ||
+       ((dst_region_w >= src_region_w) && (dst_region_h >= src_region_h)))
+     goto serial;
+
+   y1 = dst_region_y;
+   y2 = dst_region_y + dst_region_h;
+   if (dc->clip.use)
+     {
+        if (y1 < dc->clip.y) y1 = dc->clip.y;
+        if (y2 > (dc->clip.y + dc->clip.h)) y2 = dc->clip.y + dc->clip.h;
+     }
+   if (y1 < 0) y1 = 0;
+   if (y2 > (int)dst->cache_entry.h) y2 = dst->cache_entry.h;
+   if ((y2 - y1) < (2 * MIN_BAND_ROWS)) goto serial;
+
+   b.cb = cb_smooth;
+   b.src = im;
+   b.dst = dst;
+   b.dc = dc;
+   b.src_region_x = src_region_x;
+   b.src_region_y = src_region_y;
+   b.src_region_w = src_region_w;
+   b.src_region_h = src_region_h;
+   b.dst_region_x = dst_region_x;
+   b.dst_region_y = dst_region_y;
+   b.dst_region_w = dst_region_w;
+   b.dst_region_h = dst_region_h;
+   b.y = y1;
+   b.ret = EINA_FALSE;
+#ifdef __ATOMIC_RELAXED
+   evas_common_parallel_run(_scale_band_run, &b, y2 - y1, MIN_BAND_ROWS);
+#else
+   eina_spinlock_new(&b.lock);
+   evas_common_parallel_run(_scale_band_run, &b, y2 - y1, MIN_BAND_ROWS);
+   eina_spinlock_free(&b.lock);
+#endif
+   // the pool is done with every band, they all happened before this
+   return b.ret;
+
+serial:
+   return cb_smooth(im, dst, dc,
+                    src_region_x, src_region_y,
+                    src_region_w, src_region_h,
+                    dst_region_x, dst_region_y,
+                    dst_region_w, dst_region_h);
+}
+
 //static int pops = 0;
 //static int hits = 0;
 //static int misses = 0;
@@ -689,11 +808,11 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
         if (im->image.data)
           {
              if (smooth)
-               return cb_smooth(im, dst, dc,
-                                src_region_x, src_region_y,
-                                src_region_w, src_region_h,
-                                dst_region_x, dst_region_y,
-                                dst_region_w, dst_region_h);
+               return _scale_smooth(cb_smooth, im, dst, dc,
+                                    src_region_x, src_region_y,
+                                    src_region_w, src_region_h,
+                                    dst_region_x, dst_region_y,
+                                    dst_region_w, dst_region_h);
              else
                return cb_sample(im, dst, dc,
                                 src_region_x, src_region_y,
@@ -780,11 +899,11 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
              if (im->image.data)
                {
                   if (smooth)
-                    ret = cb_smooth(im, sci->im, ct,
-                                    src_region_x, src_region_y,
-                                    src_region_w, src_region_h,
-                                    0, 0,
-                                    dst_region_w, dst_region_h);
+                    ret = _scale_smooth(cb_smooth, im, sci->im, ct,
+                                        src_region_x, src_region_y,
+                                        src_region_w, src_region_h,
+                                        0, 0,
+                                        dst_region_w, dst_region_h);
                   else
                     ret = cb_sample(im, sci->im, ct,
                                     src_region_x, src_region_y,
@@ -893,11 +1012,11 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
         if (im->image.data)
           {
              if (smooth)
-               ret |= cb_smooth(im, dst, dc,
-                                src_region_x, src_region_y,
-                                src_region_w, src_region_h,
-                                dst_region_x, dst_region_y,
-                                dst_region_w, dst_region_h);
+               ret |= _scale_smooth(cb_smooth, im, dst, dc,
+                                    src_region_x, src_region_y,
+                                    src_region_w, src_region_h,
+                                    dst_region_x, dst_region_y,
+                                    dst_region_w, dst_region_h);
              else
                ret |= cb_sample(im, dst, dc,
                                src_region_x, src_region_y,
@@ -0,0 +1,64 @@
+/* blend mask x color -> dst */
+
+#ifdef BUILD_AVX2
+
+/* MUL_SYM(255, c) == c and MUL_SYM(0, c) == 0, so the generic formula
+ * covers the 0 and 255 special cases of the C version exactly */
+static void
+_op_blend_mas_c_dp_avx2(DATA32 *s EINA_UNUSED, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(c);
+   int alpha = 256 - (c >> 24);
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         DATA32 a = *m;
+         switch(a)
+           {
+           case 0:
+              break;
+           case 255:
+              *d = c + MUL_256(alpha, *d);
+              break;
+           default:
+                {
+                   DATA32 mc = MUL_SYM(a, c);
+                   a = 256 - (mc >> 24);
+                   *d = mc + MUL_256(a, *d);
+                }
+              break;
+           }
+         m++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i m0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *)m));
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         __m256i mc0 = mul_sym_avx2(m0, c0);
+         __m256i a0 = sub4_alpha_avx2(mc0);
+         d0 = _mm256_add_epi32(mc0, mul_256_avx2(a0, d0));
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         m += 8; d += 8; l -= 8;
+      })
+}
+
+#define _op_blend_mas_caa_dp_avx2 _op_blend_mas_c_dp_avx2
+
+#define _op_blend_mas_c_dpan_avx2 _op_blend_mas_c_dp_avx2
+#define _op_blend_mas_caa_dpan_avx2 _op_blend_mas_caa_dp_avx2
+
+static void
+init_blend_mask_color_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP][CPU_AVX2] = _op_blend_mas_c_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP][CPU_AVX2] = _op_blend_mas_caa_dp_avx2;
+
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP_AN][CPU_AVX2] = _op_blend_mas_c_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP_AN][CPU_AVX2] = _op_blend_mas_caa_dpan_avx2;
+}
+
+#endif
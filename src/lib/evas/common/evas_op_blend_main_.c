@@ -94,6 +94,9 @@ evas_common_gfx_compositor_blend_rel_get(void)
 #ifdef BUILD_SSE3
 void evas_common_op_blend_init_sse3(void);
 #endif
+#ifdef BUILD_AVX2
+void evas_common_op_blend_init_avx2(void);
+#endif
 
 static void
 op_blend_init(void)
@@ -104,6 +107,10 @@ op_blend_init(void)
    if (evas_common_cpu_has_feature(CPU_FEATURE_SSE3))
      evas_common_op_blend_init_sse3();
 #endif
+#ifdef BUILD_AVX2
+   if (evas_common_cpu_has_feature(CPU_FEATURE_AVX2))
+     evas_common_op_blend_init_avx2();
+#endif
 #ifdef BUILD_MMX
    if (evas_common_cpu_has_feature(CPU_FEATURE_MMX))
      {
@@ -159,6 +166,14 @@ blend_gfx_span_func_cpu(int s, int m, int c, int d)
 {
    RGBA_Gfx_Func func = NULL;
    int cpu = CPU_N;
+#ifdef BUILD_AVX2
+   if (evas_common_cpu_has_feature(CPU_FEATURE_AVX2))
+      {
+         cpu = CPU_AVX2;
+         func = op_blend_span_funcs[s][m][c][d][cpu];
+         if(func) return func;
+      }
+#endif
 #ifdef BUILD_SSE3
    if (evas_common_cpu_has_feature(CPU_FEATURE_SSE3))
       {
@@ -0,0 +1,50 @@
+#define NEED_AVX2 1
+
+#include "Eina.h"
+
+#include "evas_common_types.h"
+
+#include "config.h"
+#include "evas_blend_ops.h"
+
+extern RGBA_Gfx_Func     op_blend_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+extern RGBA_Gfx_Func     op_copy_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+extern RGBA_Gfx_Func     op_mul_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+
+# include "evas_op_blend/op_blend_pixel_avx2.c"
+# include "evas_op_blend/op_blend_color_avx2.c"
+# include "evas_op_blend/op_blend_pixel_color_avx2.c"
+# include "evas_op_blend/op_blend_mask_color_avx2.c"
+
+# include "evas_op_copy/op_copy_color_avx2.c"
+
+# include "evas_op_mul/op_mul_pixel_avx2.c"
+# include "evas_op_mul/op_mul_color_avx2.c"
+
+void
+evas_common_op_blend_init_avx2(void)
+{
+#ifdef BUILD_AVX2
+   init_blend_pixel_span_funcs_avx2();
+   init_blend_color_span_funcs_avx2();
+   init_blend_pixel_color_span_funcs_avx2();
+   init_blend_mask_color_span_funcs_avx2();
+#endif
+}
+
+void
+evas_common_op_copy_init_avx2(void)
+{
+#ifdef BUILD_AVX2
+   init_copy_color_span_funcs_avx2();
+#endif
+}
+
+void
+evas_common_op_mul_init_avx2(void)
+{
+#ifdef BUILD_AVX2
+   init_mul_pixel_span_funcs_avx2();
+   init_mul_color_span_funcs_avx2();
+#endif
+}
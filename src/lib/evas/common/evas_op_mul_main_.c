@@ -1,6 +1,6 @@
 #include "evas_common_private.h"
 
-static RGBA_Gfx_Func     op_mul_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+RGBA_Gfx_Func     op_mul_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
 static RGBA_Gfx_Pt_Func  op_mul_pt_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
 
 static void op_mul_init(void);
@@ -49,11 +49,19 @@ evas_common_gfx_compositor_mul_get(void)
 # include "./evas_op_mul/op_mul_mask_color_i386.c"
 // # include "./evas_op_mul/op_mul_pixel_mask_color_i386.c"
 
+#ifdef BUILD_AVX2
+void evas_common_op_mul_init_avx2(void);
+#endif
+
 static void
 op_mul_init(void)
 {
    memset(op_mul_span_funcs, 0, sizeof(op_mul_span_funcs));
    memset(op_mul_pt_funcs, 0, sizeof(op_mul_pt_funcs));
+#ifdef BUILD_AVX2
+   if (evas_common_cpu_has_feature(CPU_FEATURE_AVX2))
+     evas_common_op_mul_init_avx2();
+#endif
 #ifdef BUILD_MMX
    if (evas_common_cpu_has_feature(CPU_FEATURE_MMX))
      {
@@ -93,6 +101,14 @@ mul_gfx_span_func_cpu(int s, int m, int c, int d)
 {
    RGBA_Gfx_Func func = NULL;
    int cpu = CPU_N;
+#ifdef BUILD_AVX2
+   if (evas_common_cpu_has_feature(CPU_FEATURE_AVX2))
+     {
+        cpu = CPU_AVX2;
+        func = op_mul_span_funcs[s][m][c][d][cpu];
+        if (func) return func;
+     }
+#endif
 #ifdef BUILD_MMX
    if (evas_common_cpu_has_feature(CPU_FEATURE_MMX))
      {
@@ -0,0 +1,203 @@
+#include "evas_common_private.h"
+#include "evas_private.h"
+
+/* A small pool of worker threads for the software paths that can split a
+ * job into independent row bands (big downscales, colorspace conversion,
+ * software filter stripes).
+ * The calling thread takes bands too and returns once all of them are done.
+ * Threads are only started on first use; EVAS_COMMON_THREADS caps them.
+ */
+
+#define PARALLEL_THREADS_MAX 16
+#define PARALLEL_BANDS_PER_THREAD 4
+
+typedef struct _Parallel_Job Parallel_Job;
+
+struct _Parallel_Job
+{
+   Evas_Common_Parallel_Func func;
+   void                     *data;
+   int                       count;
+   int                       size;
+   int                       next;
+   int                       remaining;
+};
+
+static Eina_Lock _parallel_run_lock;
+static Eina_Lock _parallel_lock;
+static Eina_Condition _parallel_cond;
+static Eina_Condition _parallel_done_cond;
+static Eina_Thread _parallel_threads[PARALLEL_THREADS_MAX];
+static int _parallel_thread_count = -1;
+static unsigned int _parallel_generation = 0;
+static Parallel_Job *_parallel_job = NULL;
+static Eina_Bool _parallel_quit = EINA_FALSE;
+static Eina_Bool _parallel_serial = EINA_FALSE;
+static int _parallel_init = 0;
+
+// Must be called with _parallel_lock held, returns with it held
+static void
+_parallel_job_process(Parallel_Job *job)
+{
+   int start, end;
+
+   while (job->next < job->count)
+     {
+        start = job->next;
+        end = start + job->size;
+        if (end > job->count) end = job->count;
+        job->next = end;
+
+        eina_lock_release(&_parallel_lock);
+        job->func(job->data, start, end);
+        eina_lock_take(&_parallel_lock);
+
+        job->remaining -= end - start;
+        if (!job->remaining)
+          eina_condition_broadcast(&_parallel_done_cond);
+     }
+}
+
+static void *
+_parallel_thread(void *data EINA_UNUSED, Eina_Thread t EINA_UNUSED)
+{
+   unsigned int generation = 0;
+
+   eina_lock_take(&_parallel_lock);
+   while (1)
+     {
+        while (!_parallel_quit && (generation == _parallel_generation))
+          eina_condition_wait(&_parallel_cond);
+        if (_parallel_quit) break;
+
+        generation = _parallel_generation;
+        if (_parallel_job)
+          _parallel_job_process(_parallel_job);
+     }
+   eina_lock_release(&_parallel_lock);
+
+   return NULL;
+}
+
+static void
+_parallel_threads_start(void)
+{
+   const char *s;
+   int max, i;
+
+   max = eina_cpu_count();
+   s = getenv("EVAS_COMMON_THREADS");
+   if (s) max = atoi(s);
+   if (max > PARALLEL_THREADS_MAX) max = PARALLEL_THREADS_MAX;
+
+   _parallel_thread_count = 0;
+   for (i = 0; i < max - 1; i++)
+     {
+        if (!eina_thread_create(&_parallel_threads[i], EINA_THREAD_NORMAL, -1,
+                                _parallel_thread, NULL))
+          {
+             ERR("Failed to create worker thread %d", i);
+             break;
+          }
+        eina_thread_name_set(_parallel_threads[i], "Evas-worker");
+        _parallel_thread_count++;
+     }
+}
+
+EAPI int
+evas_common_parallel_threads_get(void)
+{
+   if (!_parallel_init) return 1;
+   if (_parallel_thread_count < 0)
+     {
+        eina_lock_take(&_parallel_run_lock);
+        if (_parallel_thread_count < 0)
+          _parallel_threads_start();
+        eina_lock_release(&_parallel_run_lock);
+     }
+   return _parallel_thread_count + 1;
+}
+
+EAPI void
+evas_common_parallel_run(Evas_Common_Parallel_Func func, void *data,
+                         int count, int min_size)
+{
+   Parallel_Job job;
+   int bands;
+
+   if (count <= 0) return;
+   if (min_size < 1) min_size = 1;
+
+   // Called from one of our own bands or by another user: don't wait
+   if (!_parallel_init || _parallel_serial || (count < 2 * min_size) ||
+       (evas_common_parallel_threads_get() < 2) ||
+       (eina_lock_take_try(&_parallel_run_lock) != EINA_LOCK_SUCCEED))
+     {
+        func(data, 0, count);
+        return;
+     }
+
+   bands = (_parallel_thread_count + 1) * PARALLEL_BANDS_PER_THREAD;
+   job.func = func;
+   job.data = data;
+   job.count = count;
+   job.size = (count + bands - 1) / bands;
+   if (job.size < min_size) job.size = min_size;
+   job.next = 0;
+   job.remaining = count;
+
+   eina_lock_take(&_parallel_lock);
+   _parallel_job = &job;
+   _parallel_generation++;
+   eina_condition_broadcast(&_parallel_cond);
+
+   _parallel_job_process(&job);
+   while (job.remaining)
+     eina_condition_wait(&_parallel_done_cond);
+   _parallel_job = NULL;
+   eina_lock_release(&_parallel_lock);
+
+   eina_lock_release(&_parallel_run_lock);
+}
+
+EAPI void
+evas_common_parallel_serial_set(Eina_Bool serial)
+{
+   _parallel_serial = !!serial;
+}
+
+void
+evas_common_parallel_init(void)
+{
+   if (_parallel_init++) return;
+
+   eina_lock_new(&_parallel_run_lock);
+   eina_lock_new(&_parallel_lock);
+   eina_condition_new(&_parallel_cond, &_parallel_lock);
+   eina_condition_new(&_parallel_done_cond, &_parallel_lock);
+   _parallel_thread_count = -1;
+   _parallel_quit = EINA_FALSE;
+}
+
+void
+evas_common_parallel_shutdown(void)
+{
+   int i;
+
+   if (_parallel_init <= 0) return;
+   if (--_parallel_init) return;
+
+   eina_lock_take(&_parallel_lock);
+   _parallel_quit = EINA_TRUE;
+   eina_condition_broadcast(&_parallel_cond);
+   eina_lock_release(&_parallel_lock);
+
+   for (i = 0; i < _parallel_thread_count; i++)
+     eina_thread_join(_parallel_threads[i]);
+
+   eina_condition_free(&_parallel_done_cond);
+   eina_condition_free(&_parallel_cond);
+   eina_lock_free(&_parallel_lock);
+   eina_lock_free(&_parallel_run_lock);
+   _parallel_thread_count = -1;
+}
@@ -0,0 +1,14 @@
+#ifndef _EVAS_PARALLEL_H
+#define _EVAS_PARALLEL_H
+
+/* Processes the rows [start, end) of a job */
+typedef void (*Evas_Common_Parallel_Func) (void *data, int start, int end);
+
+void evas_common_parallel_init     (void);
+void evas_common_parallel_shutdown (void);
+EAPI int  evas_common_parallel_threads_get(void);
+EAPI void evas_common_parallel_run      (Evas_Common_Parallel_Func func, void *data, int count, int min_size);
+/* Runs every job on the calling thread, to compare with the banded output */
+EAPI void evas_common_parallel_serial_set(Eina_Bool serial);
+
+#endif /* _EVAS_PARALLEL_H */
@@ -9,14 +9,44 @@ typedef struct _Thinfo
    int                    thread_num;
    Eina_Thread            thread_id;
    Eina_Barrier          *barrier;
-   const Eina_Inlist     *tasks;
    Eina_Array             cutout_trash;
    Eina_Array             rects_task;
+
+   /* tile deque of a render thread: the owner pops from head, idle
+    * threads steal from tail */
+   Eina_Spinlock          tiles_lock;
+   RGBA_Pipe_Thread_Info **tiles;
+   unsigned int           head, tail;
+
+   /* per frame statistics, only filled when EVAS_PIPE_STATS is set */
+   unsigned int           done;
+   unsigned int           stolen;
+   double                 busy;
 } Thinfo;
 
 static RGBA_Pipe *evas_common_pipe_add(RGBA_Pipe *pipe, RGBA_Pipe_Op **op);
 static void evas_common_pipe_draw_context_copy(RGBA_Draw_Context *dc, RGBA_Pipe_Op *op);
 static void evas_common_pipe_op_free(RGBA_Pipe_Op *op);
+static void evas_common_pipe_rectangle_draw_do(RGBA_Image *dst, const RGBA_Pipe_Op *op, const RGBA_Pipe_Thread_Info *info);
+static void evas_common_pipe_line_draw_do(RGBA_Image *dst, const RGBA_Pipe_Op *op, const RGBA_Pipe_Thread_Info *info);
+static void evas_common_pipe_poly_draw_do(RGBA_Image *dst, const RGBA_Pipe_Op *op, const RGBA_Pipe_Thread_Info *info);
+static void evas_common_pipe_text_draw_do(RGBA_Image *dst, const RGBA_Pipe_Op *op, const RGBA_Pipe_Thread_Info *info);
+static void evas_common_pipe_image_draw_do(RGBA_Image *dst, const RGBA_Pipe_Op *op, const RGBA_Pipe_Thread_Info *info);
+static void evas_common_pipe_map_draw_do(RGBA_Image *dst, const RGBA_Pipe_Op *op, const RGBA_Pipe_Thread_Info *info);
+
+static int               thread_num = 0;
+static Thinfo            thinfo[TH_MAX];
+static Eina_Barrier      thbarrier[2];
+static Eina_Bool         pipe_stats = EINA_FALSE;
+
+static double
+evas_pipe_time_get(void)
+{
+   struct timeval tv;
+
+   gettimeofday(&tv, NULL);
+   return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
 
 /* utils */
 static RGBA_Pipe *
@@ -70,6 +100,56 @@ evas_common_pipe_op_free(RGBA_Pipe_Op *op)
 }
 
 /* main api calls */
+static RGBA_Pipe_Thread_Info *
+evas_pipe_tile_pop(Thinfo *info)
+{
+   RGBA_Pipe_Thread_Info *tile = NULL;
+
+   eina_spinlock_take(&info->tiles_lock);
+   if (info->head < info->tail)
+     tile = info->tiles[info->head++];
+   eina_spinlock_release(&info->tiles_lock);
+
+   return tile;
+}
+
+static RGBA_Pipe_Thread_Info *
+evas_pipe_tile_steal(Thinfo *info)
+{
+   RGBA_Pipe_Thread_Info *tile = NULL;
+
+   for (;;)
+     {
+        Thinfo *victim = NULL;
+        unsigned int left = 0;
+        int i;
+
+        /* pick the thread with the most pending tiles, the counts are only
+         * a hint and are checked again under the victim lock */
+        for (i = 0; i < thread_num; i++)
+          {
+             unsigned int n;
+
+             if (&(thinfo[i]) == info) continue;
+             n = thinfo[i].tail - thinfo[i].head;
+             if (thinfo[i].tail < thinfo[i].head) n = 0;
+             if (n > left)
+               {
+                  left = n;
+                  victim = &(thinfo[i]);
+               }
+          }
+        if (!victim) return NULL;
+
+        eina_spinlock_take(&victim->tiles_lock);
+        if (victim->head < victim->tail)
+          tile = victim->tiles[--victim->tail];
+        eina_spinlock_release(&victim->tiles_lock);
+
+        if (tile) return tile;
+     }
+}
+
 static void *
 evas_common_pipe_thread(void *data, Eina_Thread t EINA_UNUSED)
 {
@@ -80,15 +160,28 @@ evas_common_pipe_thread(void *data, Eina_Thread t EINA_UNUSED)
    thinfo = data;
    for (;;)
      {
-        const RGBA_Pipe_Thread_Info *info;
+        RGBA_Pipe_Thread_Info *info;
         RGBA_Pipe *p;
 
         /* wait for start signal */
 // INF(" TH %i START...", thinfo->thread_num);
         eina_barrier_wait(&(thinfo->barrier[0]));
 
-        EINA_INLIST_FOREACH(thinfo->tasks, info)
+        for (;;)
           {
+             Eina_Bool stolen = EINA_FALSE;
+             double t0 = 0.0;
+
+             info = evas_pipe_tile_pop(thinfo);
+             if (!info)
+               {
+                  info = evas_pipe_tile_steal(thinfo);
+                  if (!info) break;
+                  stolen = EINA_TRUE;
+               }
+
+             if (pipe_stats) t0 = evas_pipe_time_get();
+
              EINA_INLIST_FOREACH(EINA_INLIST_GET(thinfo->im->cache_entry.pipe), p)
                {
                   int i;
@@ -99,9 +192,16 @@ evas_common_pipe_thread(void *data, Eina_Thread t EINA_UNUSED)
                          p->op[i].op_func(thinfo->im, &(p->op[i]), info);
                     }
                }
-          }
 
-        thinfo->tasks = NULL;
+             if (pipe_stats)
+               {
+                  info->time = evas_pipe_time_get() - t0;
+                  info->thread = thinfo->thread_num;
+                  thinfo->busy += info->time;
+                  thinfo->done++;
+                  if (stolen) thinfo->stolen++;
+               }
+          }
 
         eina_barrier_wait(&(thinfo->barrier[1]));
      }
@@ -115,12 +215,10 @@ static Eina_Barrier task_thbarrier[2];
 static LK(im_task_mutex);
 static LK(text_task_mutex);
 
-static int               thread_num = 0;
-static Thinfo            thinfo[TH_MAX];
-static Eina_Barrier      thbarrier[2];
-
-static RGBA_Pipe_Thread_Info *buf = NULL;
-static unsigned int           buf_size = 0;
+static RGBA_Pipe_Thread_Info  *buf = NULL;
+static RGBA_Pipe_Thread_Info **buf_queue = NULL;
+static unsigned int            buf_size = 0;
+static unsigned int            buf_count = 0;
 
 static Cutout_Rects *
 evas_pipe_cutout_rects_pop(Thinfo *info)
@@ -160,14 +258,113 @@ evas_pipe_prepare_push(RGBA_Pipe_Op *op)
    current++;
 }
 
+/* Rough relative cost of one pixel for each kind of operation, it only has
+ * to be good enough to start the most expensive tiles first. */
+static unsigned int
+evas_pipe_op_cost_get(const RGBA_Pipe_Op *op, RGBA_Image *im, Eina_Rectangle *r)
+{
+   unsigned int weight = 1;
+
+   EINA_RECTANGLE_SET(r, 0, 0, im->cache_entry.w, im->cache_entry.h);
+   if (op->op_func == evas_common_pipe_rectangle_draw_do)
+     {
+        EINA_RECTANGLE_SET(r, op->op.rect.x, op->op.rect.y,
+                           op->op.rect.w, op->op.rect.h);
+     }
+   else if (op->op_func == evas_common_pipe_line_draw_do)
+     {
+        int x0 = MIN(op->op.line.x0, op->op.line.x1);
+        int y0 = MIN(op->op.line.y0, op->op.line.y1);
+
+        EINA_RECTANGLE_SET(r, x0, y0,
+                           MAX(op->op.line.x0, op->op.line.x1) - x0 + 1,
+                           MAX(op->op.line.y0, op->op.line.y1) - y0 + 1);
+     }
+   else if (op->op_func == evas_common_pipe_image_draw_do)
+     {
+        EINA_RECTANGLE_SET(r, op->op.image.dx, op->op.image.dy,
+                           op->op.image.dw, op->op.image.dh);
+        weight = op->op.image.smooth ? 4 : 2;
+     }
+   else if (op->op_func == evas_common_pipe_poly_draw_do)
+     weight = 2;
+   else if (op->op_func == evas_common_pipe_text_draw_do)
+     weight = 8;
+   else if (op->op_func == evas_common_pipe_map_draw_do)
+     weight = 8;
+
+   if (op->context.clip.use)
+     {
+        Eina_Rectangle clip;
+
+        EINA_RECTANGLE_SET(&clip, op->context.clip.x, op->context.clip.y,
+                           op->context.clip.w, op->context.clip.h);
+        if (!eina_rectangle_intersection(r, &clip)) return 0;
+     }
+
+   return weight;
+}
+
+static void
+evas_pipe_tiles_cost_estimate(RGBA_Image *im,
+                              unsigned int tilew, unsigned int tileh,
+                              unsigned int tilesx)
+{
+   Eina_Rectangle r, bounds;
+   RGBA_Pipe *p;
+   int i;
+
+   EINA_RECTANGLE_SET(&bounds, 0, 0, im->cache_entry.w, im->cache_entry.h);
+   for (p = im->cache_entry.pipe; p; p = (RGBA_Pipe *)(EINA_INLIST_GET(p))->next)
+     {
+        for (i = 0; i < p->op_num; i++)
+          {
+             unsigned int tx, ty, tx0, ty0, tx1, ty1, weight;
+
+             if (!p->op[i].render || !p->op[i].op_func) continue;
+             weight = evas_pipe_op_cost_get(&(p->op[i]), im, &r);
+             if (!weight) continue;
+             if (!eina_rectangle_intersection(&r, &bounds)) continue;
+
+             tx0 = r.x / tilew;
+             ty0 = r.y / tileh;
+             tx1 = (r.x + r.w - 1) / tilew;
+             ty1 = (r.y + r.h - 1) / tileh;
+             for (ty = ty0; ty <= ty1; ty++)
+               for (tx = tx0; tx <= tx1; tx++)
+                 {
+                    RGBA_Pipe_Thread_Info *info = &(buf[ty * tilesx + tx]);
+                    Eina_Rectangle area = info->area;
+
+                    /* every op costs a little, even when it draws nothing */
+                    if (eina_rectangle_intersection(&area, &r))
+                      info->cost += 64 + (unsigned long long)area.w * area.h * weight;
+                 }
+          }
+     }
+}
+
+static int
+evas_pipe_tile_cmp(const void *a, const void *b)
+{
+   const RGBA_Pipe_Thread_Info *ta = *(const RGBA_Pipe_Thread_Info **)a;
+   const RGBA_Pipe_Thread_Info *tb = *(const RGBA_Pipe_Thread_Info **)b;
+
+   if (ta->cost > tb->cost) return -1;
+   if (ta->cost < tb->cost) return 1;
+   return 0;
+}
+
 static void
 evas_common_pipe_begin(RGBA_Image *im)
 {
 #define SZ 128
-   unsigned int x, y, cpu;
+   unsigned int x, y, cpu, i, tilesx;
    RGBA_Pipe_Thread_Info *info;
+   RGBA_Pipe_Thread_Info **queue;
    unsigned int estimatex, estimatey;
    unsigned int needed_size;
+   unsigned int start;
 
    if (!im->cache_entry.pipe) return;
    if (thread_num == 1) return;
@@ -184,40 +381,106 @@ evas_common_pipe_begin(RGBA_Image *im)
         estimatey = SZ;
      }
 
-   needed_size = ((im->cache_entry.w / estimatex) + 1 ) * ((im->cache_entry.h /  estimatey) + 1);
+   tilesx = (im->cache_entry.w + estimatex - 1) / estimatex;
+   needed_size = tilesx * ((im->cache_entry.h + estimatey - 1) / estimatey);
    if (buf_size < needed_size)
      {
         RGBA_Pipe_Thread_Info *temp;
+        RGBA_Pipe_Thread_Info **tempq;
 
         temp = realloc(buf, sizeof (RGBA_Pipe_Thread_Info) * needed_size);
-        if (temp)
+        if (temp) buf = temp;
+        /* first half is sorted by cost, second half holds the deques */
+        tempq = realloc(buf_queue, sizeof (RGBA_Pipe_Thread_Info *) * needed_size * 2);
+        if (tempq) buf_queue = tempq;
+        if (temp && tempq) buf_size = needed_size;
+     }
+   if (buf_size < needed_size)
+     {
+        ERR("Could not allocate %u pipe render tiles", needed_size);
+        for (cpu = 0; cpu < (unsigned int) thread_num; cpu++)
           {
-             buf = temp;
-             buf_size = needed_size;
+             thinfo[cpu].im = im;
+             thinfo[cpu].head = thinfo[cpu].tail = 0;
           }
+        buf_count = 0;
+        eina_barrier_wait(&(thbarrier[0]));
+        return;
      }
 
    info = buf;
-   cpu = 0;
    for (y = 0; y < im->cache_entry.h; y += estimatey)
      for (x = 0; x < im->cache_entry.w; x += estimatex)
        {
           EINA_RECTANGLE_SET(&info->area, x, y,
                              (x + estimatex > im->cache_entry.w) ? im->cache_entry.w - x : estimatex,
                              (y + estimatey > im->cache_entry.h) ? im->cache_entry.h - y : estimatey);
-
-	  thinfo[cpu].im = im;
-          thinfo[cpu].tasks = eina_inlist_prepend((void*) thinfo[cpu].tasks, EINA_INLIST_GET(info));
-          cpu++;
-          if (cpu >= (unsigned int) thread_num) cpu = 0;
-
+          info->cost = 0;
+          info->time = 0.0;
+          info->thread = -1;
           info++;
        }
+   buf_count = needed_size;
+
+   /* order tiles by estimated cost so the expensive ones start first and
+    * the cheap ones are left at the tail for idle threads to steal */
+   evas_pipe_tiles_cost_estimate(im, estimatex, estimatey, tilesx);
+   queue = buf_queue;
+   for (i = 0; i < needed_size; i++) queue[i] = &(buf[i]);
+   qsort(queue, needed_size, sizeof (RGBA_Pipe_Thread_Info *), evas_pipe_tile_cmp);
+
+   /* deal tiles round-robin in cost order, each thread owning a slice */
+   start = 0;
+   for (cpu = 0; cpu < (unsigned int) thread_num; cpu++)
+     {
+        unsigned int count;
+
+        count = needed_size / thread_num;
+        if (cpu < needed_size % thread_num) count++;
+
+        thinfo[cpu].im = im;
+        thinfo[cpu].tiles = buf_queue + needed_size + start;
+        thinfo[cpu].head = 0;
+        thinfo[cpu].tail = count;
+        thinfo[cpu].done = 0;
+        thinfo[cpu].stolen = 0;
+        thinfo[cpu].busy = 0.0;
+        for (i = 0; i < count; i++)
+          thinfo[cpu].tiles[i] = queue[cpu + i * thread_num];
+        start += count;
+     }
 
    /* tell worker threads to start */
    eina_barrier_wait(&(thbarrier[0]));
 }
 
+static void
+evas_common_pipe_stats_dump(RGBA_Image *im)
+{
+   const RGBA_Pipe_Thread_Info *slowest = NULL;
+   double total = 0.0;
+   unsigned int i;
+   int cpu;
+
+   for (i = 0; i < buf_count; i++)
+     {
+        const RGBA_Pipe_Thread_Info *info = &(buf[i]);
+
+        DBG("pipe %p tile %i,%i %ix%i cost %llu time %1.6f thread %i",
+            im, info->area.x, info->area.y, info->area.w, info->area.h,
+            info->cost, info->time, info->thread);
+        if (!slowest || (info->time > slowest->time)) slowest = info;
+        total += info->time;
+     }
+   if (!slowest) return;
+
+   for (cpu = 0; cpu < thread_num; cpu++)
+     INF("pipe %p thread %i: %u tiles (%u stolen) busy %1.6f",
+         im, cpu, thinfo[cpu].done, thinfo[cpu].stolen, thinfo[cpu].busy);
+   INF("pipe %p: %u tiles, total %1.6f, slowest %1.6f at %i,%i",
+       im, buf_count, total, slowest->time, slowest->area.x, slowest->area.y);
+}
+
 EAPI void
 evas_common_pipe_flush(RGBA_Image *im)
 {
@@ -226,6 +489,7 @@ evas_common_pipe_flush(RGBA_Image *im)
      {
        /* sync worker threads */
        eina_barrier_wait(&(thbarrier[1]));
+       if (pipe_stats) evas_common_pipe_stats_dump(im);
      }
    else
      {
@@ -861,6 +1125,8 @@ evas_common_pipe_init(void)
 
 	cpunum = eina_cpu_count();
 	thread_num = cpunum;
+	if (thread_num > TH_MAX) thread_num = TH_MAX;
+	if (getenv("EVAS_PIPE_STATS")) pipe_stats = EINA_TRUE;
 // on  single cpu we still want this initted.. otherwise we block forever
 // waiting onm pthread barriers for async rendering on a single core!
 //	if (thread_num == 1) return EINA_FALSE;
@@ -875,8 +1141,8 @@ evas_common_pipe_init(void)
 	for (i = 0; i < thread_num; i++)
 	  {
 	     thinfo[i].thread_num = i;
-	     thinfo[i].tasks = NULL;
 	     thinfo[i].barrier = thbarrier;
+	     eina_spinlock_new(&(thinfo[i].tiles_lock));
 
              eina_thread_create(&(thinfo[i].thread_id), EINA_THREAD_NORMAL, i,
                                 evas_common_pipe_thread, &(thinfo[i]));
@@ -887,7 +1153,6 @@ evas_common_pipe_init(void)
 	for (i = 0; i < thread_num; i++)
 	  {
 	     task_thinfo[i].thread_num = i;
-	     task_thinfo[i].tasks = NULL;
 	     task_thinfo[i].barrier = task_thbarrier;
              eina_array_step_set(&task_thinfo[i].cutout_trash, sizeof (Eina_Array), 8);
              eina_array_step_set(&task_thinfo[i].rects_task, sizeof (Eina_Array), 8);
@@ -0,0 +1,59 @@
+#include "evas_common_private.h"
+#include "evas_scale_smooth.h"
+#include "evas_blend_private.h"
+
+/* Smooth scaler built with -mavx2, see evas_scale_smooth_simd.c. It is
+ * only called when the CPU has AVX2. */
+
+#ifdef BUILD_AVX2
+# include <immintrin.h>
+
+// before the row helpers, they only have their 256 bit loops with it
+# define SCALE_USING_AVX2
+# include "evas_scale_smooth_points.c"
+# include "evas_scale_smooth_simd.c"
+
+# undef SCALE_FUNC
+# define SCALE_FUNC _evas_common_scale_rgba_in_to_out_clip_smooth_avx2
+# define SCALE_USING_SIMD
+# include "evas_scale_smooth_scaler.c"
+
+EAPI Eina_Bool
+evas_common_scale_rgba_in_to_out_clip_smooth_avx2(RGBA_Image *src, RGBA_Image *dst,
+                                                  RGBA_Draw_Context *dc,
+                                                  int src_region_x, int src_region_y,
+                                                  int src_region_w, int src_region_h,
+                                                  int dst_region_x, int dst_region_y,
+                                                  int dst_region_w, int dst_region_h)
+{
+   int clip_x, clip_y, clip_w, clip_h;
+   DATA32 mul_col;
+
+   if (dc->clip.use)
+     {
+        clip_x = dc->clip.x;
+        clip_y = dc->clip.y;
+        clip_w = dc->clip.w;
+        clip_h = dc->clip.h;
+     }
+   else
+     {
+        clip_x = 0;
+        clip_y = 0;
+        clip_w = dst->cache_entry.w;
+        clip_h = dst->cache_entry.h;
+     }
+
+   mul_col = dc->mul.use ? dc->mul.col : 0xffffffff;
+
+   _evas_common_scale_rgba_in_to_out_clip_smooth_avx2
+     (src, dst,
+      clip_x, clip_y, clip_w, clip_h,
+      mul_col, dc->render_op,
+      src_region_x, src_region_y, src_region_w, src_region_h,
+      dst_region_x, dst_region_y, dst_region_w, dst_region_h,
+      dc->clip.mask, dc->clip.mask_x, dc->clip.mask_y);
+
+   return EINA_TRUE;
+}
+#endif
@@ -0,0 +1,86 @@
+#define SCALE_CALC_X_POINTS(P, SW, DW, CX, CW) \
+  P = alloca((CW + 1) * sizeof (int));         \
+  scale_calc_x_points(P, SW, DW, CX, CW);
+
+#define SCALE_CALC_Y_POINTS(P, SRC, SW, SH, DH, CY, CH) \
+  P = alloca((CH + 1) * sizeof (DATA32 *));             \
+  scale_calc_y_points(P, SRC, SW, SH, DH, CY, CH);
+
+#define SCALE_CALC_A_POINTS(P, S, D, C, CC) \
+  P = alloca(CC * sizeof (int));            \
+  scale_calc_a_points(P, S, D, C, CC);
+
+static void scale_calc_y_points(DATA32 **p, DATA32 *src, int sw, int sh, int dh, int cy, int ch);
+static void scale_calc_x_points(int *p, int sw, int dw, int cx, int cw);
+static void scale_calc_a_points(int *p, int s, int d, int c, int cc);
+
+static void
+scale_calc_y_points(DATA32** p, DATA32 *src, int sw, int sh, int dh, int cy, int ch)
+{
+   int i, val, inc;
+   if (sh > SCALE_SIZE_MAX) return;
+   val = 0;
+   inc = (sh << 16) / dh;
+   for (i = 0; i < dh; i++)
+     {
+        if ((i >= cy) && (i < (cy + ch)))
+           p[i - cy] = src + ((val >> 16) * sw);
+	val += inc;
+     }
+   if ((i >= cy) && (i < (cy + ch)))
+      p[i - cy] = p[i - cy - 1];
+}
+
+static void
+scale_calc_x_points(int *p, int sw, int dw, int cx, int cw)
+{
+   int i, val, inc;
+   if (sw > SCALE_SIZE_MAX) return;
+   val = 0;
+   inc = (sw << 16) / dw;
+   for (i = 0; i < dw; i++)
+     {
+        if ((i >= cx) && (i < (cx + cw)))
+           p[i - cx] = val >> 16;
+	val += inc;
+     }
+   if ((i >= cx) && (i < (cx + cw)))
+      p[i - cx] = p[i - cx - 1];
+}
+
+static void
+scale_calc_a_points(int *p, int s, int d, int c, int cc)
+{
+   int i, val, inc;
+
+   if (s > SCALE_SIZE_MAX) return;
+   if (d >= s)
+     {
+	val = 0;
+	inc = (s << 16) / d;
+	for (i = 0; i < d; i++)
+	  {
+             if ((i >= c) && (i < (c + cc)))
+               {
+                  p[i - c] = (val >> 8) - ((val >> 8) & 0xffffff00);
+                  if ((val >> 16) >= (s - 1)) p[i - c] = 0;
+               }
+	     val += inc;
+	  }
+     }
+   else
+     {
+	int ap, Cp;
+
+	val = 0;
+	inc = (s << 16) / d;
+	Cp = ((d << 14) / s) + 1;
+	for (i = 0; i < d; i++)
+	  {
+	     ap = ((0x100 - ((val >> 8) & 0xff)) * Cp) >> 8;
+             if ((i >= c) && (i < (c + cc)))
+                p[i - c] = ap | (Cp << 16);
+	     val += inc;
+	  }
+     }
+}
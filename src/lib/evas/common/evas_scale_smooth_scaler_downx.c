@@ -24,6 +24,10 @@
         y = 0;
 	while (dst_clip_h--)
 	  {
+#ifdef SCALE_USING_SIMD
+	    _scale_simd_downx_row(pbuf, dst_clip_w, *yp + pos, src_w,
+				  xp, xapp, *yapp, 0);
+#else
 	    while (dst_clip_w--)
 	      {
 		Cx = *xapp >> 16;
@@ -84,6 +88,7 @@
 				    ((b + (1 << 3)) >> 4));
 		xp++;  xapp++;
 	      }
+#endif
 
             if (!mask_ie)
               func(buf, NULL, mul_col, dptr, w);
@@ -183,6 +188,10 @@
              y = 0;
 	     while (dst_clip_h--)
 	       {
+#ifdef SCALE_USING_SIMD
+		 _scale_simd_downx_row(pbuf, dst_clip_w, *yp + pos, src_w,
+				       xp, xapp, *yapp, 0xff000000);
+#else
 		 while (dst_clip_w--)
 		   {
 		     Cx = *xapp >> 16;
@@ -236,6 +245,7 @@
 					 ((b + (1 << 3)) >> 4));
 		     xp++;  xapp++;
 		   }
+#endif
 
                  if (!mask_ie)
                    func(buf, NULL, mul_col, dptr, w);
@@ -62,6 +62,12 @@
                   xpos = (dst_clip_x - dst_region_x) * xstep;
                   lptr = pix + ((ypos >> 16) * src_w);
 
+#ifdef SCALE_USING_SIMD
+                  _scale_simd_bilinear_row(pbuf, dst_clip_w, lptr,
+                                           ((ypos >> 16) < ((unsigned int)src_h - 1)) ?
+                                           lptr + src_w : lptr,
+                                           xpos, xstep, ypos & 0xffff, 0);
+#else
                   if ((ypos >> 16) < ((unsigned int)src_h - 1))
                     {
                        yfrac = ypos & 0xffff;
@@ -135,6 +141,7 @@
                             xpos += xstep;
                          }
                     }
+#endif
                   if (!mask_ie)
                     func(buf, NULL, mul_col, dptr, w);
                   else
@@ -162,6 +169,10 @@
                   Cy = *yapp >> 16;
                   yap = *yapp & 0xffff;
 
+#ifdef SCALE_USING_SIMD
+                  _scale_simd_box_row(pbuf, dst_clip_w, *yp + pos, src_w,
+                                      xp, xapp, Cy, yap, 0);
+#else
                   while (dst_clip_w--)
                     {
                        Cx = *xapp >> 16;
@@ -263,6 +274,7 @@
                                            ((b + (1 << 4)) >> 5));
                        xp++;  xapp++;
                     }
+#endif
 
                   if (!mask_ie)
                     func(buf, NULL, mul_col, dptr, w);
@@ -514,6 +526,12 @@
                        xpos = (dst_clip_x - dst_region_x) * xstep;
                        lptr = pix + ((ypos >> 16) * src_w);
 
+#ifdef SCALE_USING_SIMD
+                       _scale_simd_bilinear_row(pbuf, dst_clip_w, lptr,
+                                                ((ypos >> 16) < ((unsigned int)src_h - 1)) ?
+                                                lptr + src_w : lptr,
+                                                xpos, xstep, ypos & 0xffff, 0xff000000);
+#else
                        if ((ypos >> 16) < ((unsigned int)src_h - 1))
                          {
                             yfrac = ypos & 0xffff;
@@ -580,6 +598,7 @@
                                  xpos += xstep;
                               }
                          }
+#endif
                        if (!mask_ie)
                          func(buf, NULL, mul_col, dptr, w);
                        else
@@ -607,6 +626,10 @@
                        Cy = *yapp >> 16;
                        yap = *yapp & 0xffff;
 
+#ifdef SCALE_USING_SIMD
+                       _scale_simd_box_row(pbuf, dst_clip_w, *yp + pos, src_w,
+                                           xp, xapp, Cy, yap, 0xff000000);
+#else
                        while (dst_clip_w--)
                          {
                             Cx = *xapp >> 16;
@@ -696,6 +719,7 @@
                                                 ((b + (1 << 4)) >> 5));
                             xp++;  xapp++;
                          }
+#endif
 
                        if (!mask_ie)
                          func(buf, NULL, mul_col, dptr, w);
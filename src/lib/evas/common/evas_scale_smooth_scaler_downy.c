@@ -27,6 +27,10 @@
 	    Cy = *yapp >> 16;
 	    yap = *yapp & 0xffff;
 
+#ifdef SCALE_USING_SIMD
+	    _scale_simd_downy_row(pbuf, dst_clip_w, *yp + pos, src_w,
+				  xp, xapp, Cy, yap, 0);
+#else
 	    while (dst_clip_w--)
 	      {
 		pix = *yp + *xp + pos;
@@ -85,6 +89,7 @@
 				    ((b + (1 << 3)) >> 4));
 		xp++;  xapp++;
 	      }
+#endif
 
             if (!mask_ie)
               func(buf, NULL, mul_col, dptr, w);
@@ -187,6 +192,10 @@
 		 Cy = *yapp >> 16;
 		 yap = *yapp & 0xffff;
 
+#ifdef SCALE_USING_SIMD
+		 _scale_simd_downy_row(pbuf, dst_clip_w, *yp + pos, src_w,
+				       xp, xapp, Cy, yap, 0xff000000);
+#else
 		 while (dst_clip_w--)
 		   {
 		     pix = *yp + *xp + pos;
@@ -238,6 +247,7 @@
 					 ((b + (1 << 3)) >> 4));
 		     xp++;  xapp++;
 		   }
+#endif
 
                  if (!mask_ie)
                    func(buf, NULL, mul_col, dptr, w);
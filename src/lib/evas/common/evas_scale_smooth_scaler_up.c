@@ -81,6 +81,9 @@
 	  {
 	    pbuf = buf;  pbuf_end = buf + dst_clip_w;
 	    sxx = sxx0;
+#ifdef SCALE_USING_SIMD
+	    _scale_simd_up_row(pbuf, dst_clip_w, psrc, psrc, srw, sxx, dsxx, 0);
+#else
 #ifdef SCALE_USING_MMX
 	    pxor_r2r(mm0, mm0);
 	    MOV_A2R(ALPHA_255, mm5)
@@ -112,6 +115,7 @@
 #endif
 		  sxx += dsxx;
 		}
+#endif
 	    /* * blend here [clip_w *] buf -> dptr * */
 	    if (!direct_scale)
               {
@@ -148,6 +152,10 @@
 	    sy = syy >> 16;
 	    psrc = ps + (sy * src_w);
 	    ay = 1 + ((syy - (sy << 16)) >> 8);
+#ifdef SCALE_USING_SIMD
+	    _scale_simd_up_col(buf, dst_clip_w, psrc,
+	                       ((sy + 1) < srh) ? psrc + src_w : psrc, ay);
+#else
 #ifdef SCALE_USING_MMX
 	    pxor_r2r(mm0, mm0);
 	    MOV_A2R(ALPHA_255, mm5)
@@ -176,6 +184,7 @@
 #endif
 		psrc++;
 	      }
+#endif
 	    /* * blend here [clip_w *] buf -> dptr * */
 	    if (!direct_scale)
               {
@@ -211,6 +220,11 @@
 	    sy = syy >> 16;
 	    psrc = ps + (sy * src_w);
 	    ay = 1 + ((syy - (sy << 16)) >> 8);
+#ifdef SCALE_USING_SIMD
+	    _scale_simd_up_row(buf, dst_clip_w, psrc,
+	                       ((sy + 1) < srh) ? psrc + src_w : psrc,
+	                       srw, sxx0, dsxx, ay);
+#else
 #ifdef SCALE_USING_MMX
 	    MOV_A2R(ay, mm4)
 	    pxor_r2r(mm0, mm0);
@@ -356,6 +370,7 @@
                   *pbuf++ = p0;
                   sxx += dsxx;
                 }
+#endif
 #endif
 	    /* * blend here [clip_w *] buf -> dptr * */
 	    if (!direct_scale)
@@ -0,0 +1,600 @@
+/* SSE4.1 and AVX2 row kernels for the smooth scaler.
+ *
+ * This file is included by evas_scale_smooth_sse41.c and
+ * evas_scale_smooth_avx2.c before evas_scale_smooth_scaler.c, which calls
+ * the _scale_simd_*() functions instead of its C loops when
+ * SCALE_USING_SIMD is defined. SCALE_USING_AVX2 selects the 256 bit
+ * variants where there is one.
+ *
+ * The downscaling kernels do the same integer math as the C loops, in 16
+ * or 32 bit lanes, and give the exact same pixels. The upscaling kernels
+ * interpolate each channel on its own, while INTERP_256 lets the borrow of
+ * a channel run into the next one, so they may differ from the C by 1 like
+ * the MMX and NEON code.
+ */
+
+/* c1 + (((c0 - c1) * a) >> 8) on 8 bit channels in 16 bit lanes, a in
+ * [0, 256]. The product wraps at 16 bits, but its bits 8 to 15 are still
+ * the right ones, the same trick as the NEON code. */
+static inline __m128i
+_scale_simd_interp_256(__m128i a, __m128i c0, __m128i c1)
+{
+   __m128i d;
+
+   d = _mm_mullo_epi16(_mm_sub_epi16(c0, c1), a);
+   d = _mm_add_epi16(c1, _mm_srli_epi16(d, 8));
+   return _mm_and_si128(d, _mm_set1_epi16(0xff));
+}
+
+/* c0 + (((c1 - c0) * f) >> 16) on 8 bit channels in 16 bit lanes, f an
+ * unsigned 16 bit fraction. mulhi is signed, so when the top bit of f is
+ * set the result is missing d, which is added back. Exact. */
+static inline __m128i
+_scale_simd_lerp_16(__m128i f, __m128i c0, __m128i c1)
+{
+   __m128i d, hi;
+
+   d = _mm_sub_epi16(c1, c0);
+   hi = _mm_mulhi_epi16(f, d);
+   hi = _mm_add_epi16(hi, _mm_and_si128(_mm_srai_epi16(f, 15), d));
+   return _mm_add_epi16(c0, hi);
+}
+
+/* one pixel, one 32 bit lane per channel */
+static inline __m128i
+_scale_simd_pixel_epi32(const DATA32 *p)
+{
+   return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*p));
+}
+
+/* (c * w) >> Shift for the 4 channels of a pixel, w < (1 << 15) */
+#define SCALE_SIMD_MUL_SHIFT(C, W, Shift) \
+   _mm_srli_epi32(_mm_madd_epi16(C, W), Shift)
+
+static inline DATA32
+_scale_simd_pixel_pack(__m128i v)
+{
+   v = _mm_packus_epi32(v, v);
+   v = _mm_packus_epi16(v, v);
+   return _mm_cvtsi128_si32(v);
+}
+
+#ifdef SCALE_USING_AVX2
+static inline __m256i
+_scale_simd_interp_256_avx2(__m256i a, __m256i c0, __m256i c1)
+{
+   __m256i d;
+
+   d = _mm256_mullo_epi16(_mm256_sub_epi16(c0, c1), a);
+   d = _mm256_add_epi16(c1, _mm256_srli_epi16(d, 8));
+   return _mm256_and_si256(d, _mm256_set1_epi16(0xff));
+}
+
+static inline __m256i
+_scale_simd_lerp_16_avx2(__m256i f, __m256i c0, __m256i c1)
+{
+   __m256i d, hi;
+
+   d = _mm256_sub_epi16(c1, c0);
+   hi = _mm256_mulhi_epi16(f, d);
+   hi = _mm256_add_epi16(hi, _mm256_and_si256(_mm256_srai_epi16(f, 15), d));
+   return _mm256_add_epi16(c0, hi);
+}
+
+/* two pixels, the first one in the low 128 bits */
+static inline __m256i
+_scale_simd_pixel2_epi32(const DATA32 *p0, const DATA32 *p1)
+{
+   __m128i v;
+
+   v = _mm_unpacklo_epi32(_mm_cvtsi32_si128(*p0), _mm_cvtsi32_si128(*p1));
+   return _mm256_cvtepu8_epi32(v);
+}
+#endif
+
+/* Bilinear upscale of a row: pixel x of dst is interpolated between
+ * p[sx], p[sx + 1], q[sx] and q[sx + 1], sx being the integer part of
+ * sxx + x * dsxx. q is p for the last source row, and for rows that are
+ * not scaled vertically. */
+static void
+_scale_simd_up_row(DATA32 *dst, int w, const DATA32 *p, const DATA32 *q,
+                   int srw, int sxx, int dsxx, int ay)
+{
+   const __m128i vay4 = _mm_set1_epi16(ay);
+   const __m128i zero4 = _mm_setzero_si128();
+#ifdef SCALE_USING_AVX2
+   const __m256i one = _mm256_set1_epi32(1);
+   const __m256i last = _mm256_set1_epi32(srw - 1);
+   const __m256i low = _mm256_set1_epi32(0xffff);
+   const __m256i step = _mm256_set1_epi32(dsxx * 8);
+   const __m256i vay = _mm256_set1_epi16(ay);
+   const __m256i zero = _mm256_setzero_si256();
+   __m256i vsxx;
+
+   vsxx = _mm256_add_epi32(_mm256_set1_epi32(sxx),
+                           _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                              _mm256_set1_epi32(dsxx)));
+   for (; w >= 8; w -= 8, dst += 8)
+     {
+        __m256i vsx, vsx1, vax, ax_lo, ax_hi;
+        __m256i p0, p1, p2, p3, t, b, lo, hi;
+
+        vsx = _mm256_srai_epi32(vsxx, 16);
+        vsx1 = _mm256_min_epi32(_mm256_add_epi32(vsx, one), last);
+        vax = _mm256_add_epi32(one, _mm256_srli_epi32(_mm256_and_si256(vsxx, low), 8));
+        vax = _mm256_or_si256(vax, _mm256_slli_epi32(vax, 16));
+        ax_lo = _mm256_unpacklo_epi32(vax, vax);
+        ax_hi = _mm256_unpackhi_epi32(vax, vax);
+
+        p0 = _mm256_i32gather_epi32((const int *)p, vsx, 4);
+        p1 = _mm256_i32gather_epi32((const int *)p, vsx1, 4);
+        p2 = _mm256_i32gather_epi32((const int *)q, vsx, 4);
+        p3 = _mm256_i32gather_epi32((const int *)q, vsx1, 4);
+
+        t = _scale_simd_interp_256_avx2(ax_lo, _mm256_unpacklo_epi8(p1, zero),
+                                        _mm256_unpacklo_epi8(p0, zero));
+        b = _scale_simd_interp_256_avx2(ax_lo, _mm256_unpacklo_epi8(p3, zero),
+                                        _mm256_unpacklo_epi8(p2, zero));
+        lo = _scale_simd_interp_256_avx2(vay, b, t);
+        t = _scale_simd_interp_256_avx2(ax_hi, _mm256_unpackhi_epi8(p1, zero),
+                                        _mm256_unpackhi_epi8(p0, zero));
+        b = _scale_simd_interp_256_avx2(ax_hi, _mm256_unpackhi_epi8(p3, zero),
+                                        _mm256_unpackhi_epi8(p2, zero));
+        hi = _scale_simd_interp_256_avx2(vay, b, t);
+
+        _mm256_storeu_si256((__m256i *)dst, _mm256_packus_epi16(lo, hi));
+        vsxx = _mm256_add_epi32(vsxx, step);
+        sxx += dsxx * 8;
+     }
+#endif
+
+   while (w > 0)
+     {
+        DATA32 out[4];
+        int sx[4], sx1[4], ax[4];
+        __m128i p0, p1, p2, p3, t, b, lo, hi, ax_lo, ax_hi;
+        int k, n = (w < 4) ? w : 4;
+
+        for (k = 0; k < 4; k++)
+          {
+             /* pad a short tail with the last pixel */
+             if (k < n)
+               {
+                  sx[k] = sxx >> 16;
+                  ax[k] = 1 + ((sxx - (sx[k] << 16)) >> 8);
+                  sx1[k] = ((sx[k] + 1) < srw) ? sx[k] + 1 : sx[k];
+                  sxx += dsxx;
+               }
+             else
+               {
+                  sx[k] = sx[k - 1];
+                  sx1[k] = sx1[k - 1];
+                  ax[k] = ax[k - 1];
+               }
+          }
+        p0 = _mm_setr_epi32(p[sx[0]], p[sx[1]], p[sx[2]], p[sx[3]]);
+        p1 = _mm_setr_epi32(p[sx1[0]], p[sx1[1]], p[sx1[2]], p[sx1[3]]);
+        p2 = _mm_setr_epi32(q[sx[0]], q[sx[1]], q[sx[2]], q[sx[3]]);
+        p3 = _mm_setr_epi32(q[sx1[0]], q[sx1[1]], q[sx1[2]], q[sx1[3]]);
+        ax_lo = _mm_setr_epi16(ax[0], ax[0], ax[0], ax[0], ax[1], ax[1], ax[1], ax[1]);
+        ax_hi = _mm_setr_epi16(ax[2], ax[2], ax[2], ax[2], ax[3], ax[3], ax[3], ax[3]);
+
+        t = _scale_simd_interp_256(ax_lo, _mm_unpacklo_epi8(p1, zero4),
+                                   _mm_unpacklo_epi8(p0, zero4));
+        b = _scale_simd_interp_256(ax_lo, _mm_unpacklo_epi8(p3, zero4),
+                                   _mm_unpacklo_epi8(p2, zero4));
+        lo = _scale_simd_interp_256(vay4, b, t);
+        t = _scale_simd_interp_256(ax_hi, _mm_unpackhi_epi8(p1, zero4),
+                                   _mm_unpackhi_epi8(p0, zero4));
+        b = _scale_simd_interp_256(ax_hi, _mm_unpackhi_epi8(p3, zero4),
+                                   _mm_unpackhi_epi8(p2, zero4));
+        hi = _scale_simd_interp_256(vay4, b, t);
+
+        if (n == 4)
+          _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+        else
+          {
+             _mm_storeu_si128((__m128i *)out, _mm_packus_epi16(lo, hi));
+             for (k = 0; k < n; k++) dst[k] = out[k];
+          }
+        dst += n;
+        w -= n;
+     }
+}
+
+/* Vertical only upscale of a row: dst[x] is interpolated between p[x] and
+ * q[x]. */
+static void
+_scale_simd_up_col(DATA32 *dst, int w, const DATA32 *p, const DATA32 *q,
+                   int ay)
+{
+   const __m128i vay4 = _mm_set1_epi16(ay);
+   const __m128i zero4 = _mm_setzero_si128();
+#ifdef SCALE_USING_AVX2
+   const __m256i vay = _mm256_set1_epi16(ay);
+   const __m256i zero = _mm256_setzero_si256();
+
+   for (; w >= 8; w -= 8, dst += 8, p += 8, q += 8)
+     {
+        __m256i p0, p2, lo, hi;
+
+        p0 = _mm256_loadu_si256((const __m256i *)p);
+        p2 = _mm256_loadu_si256((const __m256i *)q);
+        lo = _scale_simd_interp_256_avx2(vay, _mm256_unpacklo_epi8(p2, zero),
+                                         _mm256_unpacklo_epi8(p0, zero));
+        hi = _scale_simd_interp_256_avx2(vay, _mm256_unpackhi_epi8(p2, zero),
+                                         _mm256_unpackhi_epi8(p0, zero));
+        _mm256_storeu_si256((__m256i *)dst, _mm256_packus_epi16(lo, hi));
+     }
+#endif
+
+   for (; w >= 4; w -= 4, dst += 4, p += 4, q += 4)
+     {
+        __m128i p0, p2, lo, hi;
+
+        p0 = _mm_loadu_si128((const __m128i *)p);
+        p2 = _mm_loadu_si128((const __m128i *)q);
+        lo = _scale_simd_interp_256(vay4, _mm_unpacklo_epi8(p2, zero4),
+                                    _mm_unpacklo_epi8(p0, zero4));
+        hi = _scale_simd_interp_256(vay4, _mm_unpackhi_epi8(p2, zero4),
+                                    _mm_unpackhi_epi8(p0, zero4));
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+     }
+   for (; w > 0; w--, dst++, p++, q++)
+     {
+        __m128i lo;
+
+        lo = _scale_simd_interp_256(vay4, _mm_cvtepu8_epi16(_mm_cvtsi32_si128(*q)),
+                                    _mm_cvtepu8_epi16(_mm_cvtsi32_si128(*p)));
+        *dst = _mm_cvtsi128_si32(_mm_packus_epi16(lo, lo));
+     }
+}
+
+/* Bilinear downscale of a row, for scales between 50% and 100%: pixel x of
+ * dst is interpolated between p[sx], p[sx + 1], q[sx] and q[sx + 1] with
+ * 16 bit fractions, sx being the integer part of xpos + x * xstep. q is p
+ * for the last source row. The pixel right of p[sx] is not read when the
+ * fraction is 0, as it may be past the end of the image. */
+static void
+_scale_simd_bilinear_row(DATA32 *dst, int w, const DATA32 *p, const DATA32 *q,
+                         unsigned int xpos, unsigned int xstep,
+                         unsigned int yfrac, DATA32 amask)
+{
+   const __m128i vyf4 = _mm_set1_epi16(yfrac);
+   const __m128i va4 = _mm_set1_epi32(amask);
+   const __m128i zero4 = _mm_setzero_si128();
+#ifdef SCALE_USING_AVX2
+   const __m256i one = _mm256_set1_epi32(1);
+   const __m256i low = _mm256_set1_epi32(0xffff);
+   const __m256i step = _mm256_set1_epi32(xstep * 8);
+   const __m256i vyf = _mm256_set1_epi16(yfrac);
+   const __m256i va = _mm256_set1_epi32(amask);
+   const __m256i zero = _mm256_setzero_si256();
+   __m256i vxpos;
+
+   vxpos = _mm256_add_epi32(_mm256_set1_epi32(xpos),
+                            _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                               _mm256_set1_epi32(xstep)));
+   for (; w >= 8; w -= 8, dst += 8)
+     {
+        __m256i vsx, vsx1, vxf, xf_lo, xf_hi;
+        __m256i p0, p1, p2, p3, t, b, lo, hi;
+
+        vsx = _mm256_srli_epi32(vxpos, 16);
+        vxf = _mm256_and_si256(vxpos, low);
+        vsx1 = _mm256_add_epi32(vsx, _mm256_andnot_si256(_mm256_cmpeq_epi32(vxf, zero), one));
+        vxf = _mm256_or_si256(vxf, _mm256_slli_epi32(vxf, 16));
+        xf_lo = _mm256_unpacklo_epi32(vxf, vxf);
+        xf_hi = _mm256_unpackhi_epi32(vxf, vxf);
+
+        p0 = _mm256_i32gather_epi32((const int *)p, vsx, 4);
+        p1 = _mm256_i32gather_epi32((const int *)p, vsx1, 4);
+        p2 = _mm256_i32gather_epi32((const int *)q, vsx, 4);
+        p3 = _mm256_i32gather_epi32((const int *)q, vsx1, 4);
+
+        t = _scale_simd_lerp_16_avx2(xf_lo, _mm256_unpacklo_epi8(p0, zero),
+                                     _mm256_unpacklo_epi8(p1, zero));
+        b = _scale_simd_lerp_16_avx2(xf_lo, _mm256_unpacklo_epi8(p2, zero),
+                                     _mm256_unpacklo_epi8(p3, zero));
+        lo = _scale_simd_lerp_16_avx2(vyf, t, b);
+        t = _scale_simd_lerp_16_avx2(xf_hi, _mm256_unpackhi_epi8(p0, zero),
+                                     _mm256_unpackhi_epi8(p1, zero));
+        b = _scale_simd_lerp_16_avx2(xf_hi, _mm256_unpackhi_epi8(p2, zero),
+                                     _mm256_unpackhi_epi8(p3, zero));
+        hi = _scale_simd_lerp_16_avx2(vyf, t, b);
+
+        _mm256_storeu_si256((__m256i *)dst,
+                            _mm256_or_si256(_mm256_packus_epi16(lo, hi), va));
+        vxpos = _mm256_add_epi32(vxpos, step);
+        xpos += xstep * 8;
+     }
+#endif
+
+   while (w > 0)
+     {
+        DATA32 out[4];
+        unsigned int sx[4], sx1[4], xf[4];
+        __m128i p0, p1, p2, p3, t, b, lo, hi, xf_lo, xf_hi;
+        int k, n = (w < 4) ? w : 4;
+
+        for (k = 0; k < 4; k++)
+          {
+             if (k < n)
+               {
+                  sx[k] = xpos >> 16;
+                  xf[k] = xpos & 0xffff;
+                  sx1[k] = xf[k] ? sx[k] + 1 : sx[k];
+                  xpos += xstep;
+               }
+             else
+               {
+                  sx[k] = sx[k - 1];
+                  sx1[k] = sx1[k - 1];
+                  xf[k] = xf[k - 1];
+               }
+          }
+        p0 = _mm_setr_epi32(p[sx[0]], p[sx[1]], p[sx[2]], p[sx[3]]);
+        p1 = _mm_setr_epi32(p[sx1[0]], p[sx1[1]], p[sx1[2]], p[sx1[3]]);
+        p2 = _mm_setr_epi32(q[sx[0]], q[sx[1]], q[sx[2]], q[sx[3]]);
+        p3 = _mm_setr_epi32(q[sx1[0]], q[sx1[1]], q[sx1[2]], q[sx1[3]]);
+        xf_lo = _mm_setr_epi16(xf[0], xf[0], xf[0], xf[0], xf[1], xf[1], xf[1], xf[1]);
+        xf_hi = _mm_setr_epi16(xf[2], xf[2], xf[2], xf[2], xf[3], xf[3], xf[3], xf[3]);
+
+        t = _scale_simd_lerp_16(xf_lo, _mm_unpacklo_epi8(p0, zero4),
+                                _mm_unpacklo_epi8(p1, zero4));
+        b = _scale_simd_lerp_16(xf_lo, _mm_unpacklo_epi8(p2, zero4),
+                                _mm_unpacklo_epi8(p3, zero4));
+        lo = _scale_simd_lerp_16(vyf4, t, b);
+        t = _scale_simd_lerp_16(xf_hi, _mm_unpackhi_epi8(p0, zero4),
+                                _mm_unpackhi_epi8(p1, zero4));
+        b = _scale_simd_lerp_16(xf_hi, _mm_unpackhi_epi8(p2, zero4),
+                                _mm_unpackhi_epi8(p3, zero4));
+        hi = _scale_simd_lerp_16(vyf4, t, b);
+
+        lo = _mm_or_si128(_mm_packus_epi16(lo, hi), va4);
+        if (n == 4)
+          _mm_storeu_si128((__m128i *)dst, lo);
+        else
+          {
+             _mm_storeu_si128((__m128i *)out, lo);
+             for (k = 0; k < n; k++) dst[k] = out[k];
+          }
+        dst += n;
+        w -= n;
+     }
+}
+
+/* Horizontal box filter of one source row for a dst pixel, with the 9 bit
+ * shift of the downx_downy C code. */
+static inline __m128i
+_scale_simd_box_span(const DATA32 *pix, int xap, int Cx)
+{
+   __m128i acc, vcx;
+   int i;
+
+   acc = SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(xap), 9);
+   pix++;
+   vcx = _mm_set1_epi32(Cx);
+   for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+     {
+        acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), vcx, 9));
+        pix++;
+     }
+   if (i > 0)
+     acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(i), 9));
+   return acc;
+}
+
+/* Box filter downscale of a row, both directions scaled down. src points
+ * at the first source row used by this dst row, the xp and xapp tables
+ * are the ones of evas_scale_smooth_scaler_down.c. */
+static void
+_scale_simd_box_row(DATA32 *dst, int w, const DATA32 *src, int src_w,
+                    const int *xp, const int *xapp, int Cy, int yap,
+                    DATA32 amask)
+{
+   const __m128i vyap = _mm_set1_epi32(yap);
+   const __m128i vcy = _mm_set1_epi32(Cy);
+   const __m128i round = _mm_set1_epi32(1 << 4);
+
+   while (w--)
+     {
+        const DATA32 *sptr;
+        __m128i acc;
+        int Cx, xap, j;
+
+        Cx = *xapp >> 16;
+        xap = *xapp & 0xffff;
+        sptr = src + *xp;
+
+        acc = SCALE_SIMD_MUL_SHIFT(_scale_simd_box_span(sptr, xap, Cx), vyap, 14);
+        sptr += src_w;
+        for (j = (1 << 14) - yap; j > Cy; j -= Cy)
+          {
+             acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_box_span(sptr, xap, Cx), vcy, 14));
+             sptr += src_w;
+          }
+        if (j > 0)
+          acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_box_span(sptr, xap, Cx), _mm_set1_epi32(j), 14));
+
+        acc = _mm_srli_epi32(_mm_add_epi32(acc, round), 5);
+        *dst++ = _scale_simd_pixel_pack(acc) | amask;
+        xp++;  xapp++;
+     }
+}
+
+/* a + (((b - a) * f) >> 8) on 32 bit lanes, |b - a| < (1 << 15) */
+static inline __m128i
+_scale_simd_mix_256(__m128i a, __m128i b, __m128i f)
+{
+   return _mm_add_epi32(a, _mm_srai_epi32(_mm_madd_epi16(_mm_sub_epi32(b, a), f), 8));
+}
+
+/* Downscale of a row scaled down horizontally only: the box filtered
+ * spans of two source rows are mixed by yap. */
+static void
+_scale_simd_downx_row(DATA32 *dst, int w, const DATA32 *src, int src_w,
+                      const int *xp, const int *xapp, int yap, DATA32 amask)
+{
+   const __m128i vyap = _mm_set1_epi32(yap);
+   const __m128i round = _mm_set1_epi32(1 << 3);
+
+   while (w--)
+     {
+        const DATA32 *pix;
+        __m128i acc;
+        int Cx, xap, j;
+
+        Cx = *xapp >> 16;
+        xap = *xapp & 0xffff;
+        pix = src + *xp;
+
+#ifdef SCALE_USING_AVX2
+        if (yap > 0)
+          {
+             /* both rows at once, the second one in the high 128 bits */
+             __m256i acc2, vcx;
+
+             acc2 = _mm256_srli_epi32(_mm256_madd_epi16(_scale_simd_pixel2_epi32(pix, pix + src_w),
+                                                         _mm256_set1_epi32(xap)), 10);
+             vcx = _mm256_set1_epi32(Cx);
+             for (j = (1 << 14) - xap; j > Cx; j -= Cx)
+               {
+                  pix++;
+                  acc2 = _mm256_add_epi32(acc2, _mm256_srli_epi32(_mm256_madd_epi16(_scale_simd_pixel2_epi32(pix, pix + src_w), vcx), 10));
+               }
+             if (j > 0)
+               {
+                  pix++;
+                  acc2 = _mm256_add_epi32(acc2, _mm256_srli_epi32(_mm256_madd_epi16(_scale_simd_pixel2_epi32(pix, pix + src_w),
+                                                                                    _mm256_set1_epi32(j)), 10));
+               }
+             acc = _scale_simd_mix_256(_mm256_castsi256_si128(acc2),
+                                       _mm256_extracti128_si256(acc2, 1), vyap);
+          }
+        else
+#endif
+          {
+             __m128i vcx;
+
+             acc = SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(xap), 10);
+             vcx = _mm_set1_epi32(Cx);
+             for (j = (1 << 14) - xap; j > Cx; j -= Cx)
+               {
+                  pix++;
+                  acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), vcx, 10));
+               }
+             if (j > 0)
+               {
+                  pix++;
+                  acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(j), 10));
+               }
+             if (yap > 0)
+               {
+                  __m128i acc2;
+
+                  pix = src + *xp + src_w;
+                  acc2 = SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(xap), 10);
+                  for (j = (1 << 14) - xap; j > Cx; j -= Cx)
+                    {
+                       pix++;
+                       acc2 = _mm_add_epi32(acc2, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), vcx, 10));
+                    }
+                  if (j > 0)
+                    {
+                       pix++;
+                       acc2 = _mm_add_epi32(acc2, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(j), 10));
+                    }
+                  acc = _scale_simd_mix_256(acc, acc2, vyap);
+               }
+          }
+
+        acc = _mm_srli_epi32(_mm_add_epi32(acc, round), 4);
+        *dst++ = _scale_simd_pixel_pack(acc) | amask;
+        xp++;  xapp++;
+     }
+}
+
+/* Downscale of a row scaled down vertically only: the box filtered
+ * columns at sx and sx + 1 are mixed by the x fraction. */
+static void
+_scale_simd_downy_row(DATA32 *dst, int w, const DATA32 *src, int src_w,
+                      const int *xp, const int *xapp, int Cy, int yap,
+                      DATA32 amask)
+{
+   const __m128i vyap = _mm_set1_epi32(yap);
+   const __m128i vcy = _mm_set1_epi32(Cy);
+   const __m128i round = _mm_set1_epi32(1 << 3);
+
+   while (w--)
+     {
+        const DATA32 *pix;
+        __m128i acc;
+        int xap, j;
+
+        xap = *xapp;
+        pix = src + *xp;
+
+#ifdef SCALE_USING_AVX2
+        if (xap > 0)
+          {
+             /* both columns at once, the right one in the high 128 bits */
+             __m256i acc2, vcy2;
+
+             acc2 = _mm256_srli_epi32(_mm256_madd_epi16(_scale_simd_pixel2_epi32(pix, pix + 1),
+                                                         _mm256_set1_epi32(yap)), 10);
+             vcy2 = _mm256_set1_epi32(Cy);
+             for (j = (1 << 14) - yap; j > Cy; j -= Cy)
+               {
+                  pix += src_w;
+                  acc2 = _mm256_add_epi32(acc2, _mm256_srli_epi32(_mm256_madd_epi16(_scale_simd_pixel2_epi32(pix, pix + 1), vcy2), 10));
+               }
+             if (j > 0)
+               {
+                  pix += src_w;
+                  acc2 = _mm256_add_epi32(acc2, _mm256_srli_epi32(_mm256_madd_epi16(_scale_simd_pixel2_epi32(pix, pix + 1),
+                                                                                    _mm256_set1_epi32(j)), 10));
+               }
+             acc = _scale_simd_mix_256(_mm256_castsi256_si128(acc2),
+                                       _mm256_extracti128_si256(acc2, 1),
+                                       _mm_set1_epi32(xap));
+          }
+        else
+#endif
+          {
+             acc = SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), vyap, 10);
+             for (j = (1 << 14) - yap; j > Cy; j -= Cy)
+               {
+                  pix += src_w;
+                  acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), vcy, 10));
+               }
+             if (j > 0)
+               {
+                  pix += src_w;
+                  acc = _mm_add_epi32(acc, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(j), 10));
+               }
+             if (xap > 0)
+               {
+                  __m128i acc2;
+
+                  pix = src + *xp + 1;
+                  acc2 = SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), vyap, 10);
+                  for (j = (1 << 14) - yap; j > Cy; j -= Cy)
+                    {
+                       pix += src_w;
+                       acc2 = _mm_add_epi32(acc2, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), vcy, 10));
+                    }
+                  if (j > 0)
+                    {
+                       pix += src_w;
+                       acc2 = _mm_add_epi32(acc2, SCALE_SIMD_MUL_SHIFT(_scale_simd_pixel_epi32(pix), _mm_set1_epi32(j), 10));
+                    }
+                  acc = _scale_simd_mix_256(acc, acc2, _mm_set1_epi32(xap));
+               }
+          }
+
+        acc = _mm_srli_epi32(_mm_add_epi32(acc, round), 4);
+        *dst++ = _scale_simd_pixel_pack(acc) | amask;
+        xp++;  xapp++;
+     }
+}
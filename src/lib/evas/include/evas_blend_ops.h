@@ -13,6 +13,12 @@
 # endif
 #endif
 
+#ifdef NEED_AVX2
+# if defined BUILD_AVX2
+#  include <immintrin.h>
+# endif
+#endif
+
 /* src pixel flags: */
 
 /* pixels none */
@@ -77,8 +83,10 @@
 #define CPU_NEON 5
 /* CPU SSE3 */
 #define CPU_SSE3 6
+/* CPU AVX2 */
+#define CPU_AVX2 7
 /* cpu flags count */
-#define CPU_LAST 7
+#define CPU_LAST 8
 
 
 /* some useful constants */
@@ -413,6 +421,93 @@ mul3_sym_sse3(__m128i x, __m128i y) {
 #endif
 #endif
 
+/* some useful AVX2 inline functions, working on 8 pixels at once and
+ * giving the exact same results as the C macros above */
+
+#ifdef NEED_AVX2
+#ifdef BUILD_AVX2
+
+#ifndef EFL_ALWAYS_INLINE
+# define EFL_ALWAYS_INLINE inline
+#endif
+
+/* spread one 32bit value per pixel to the 4 words of each channel, in the
+ * same order as _mm256_unpack{lo,hi}_epi8() spreads the pixels */
+static EFL_ALWAYS_INLINE void
+spread_a_avx2(__m256i a, __m256i *a_l, __m256i *a_h)
+{
+   __m256i a16 = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+
+   *a_l = _mm256_unpacklo_epi32(a16, a16);
+   *a_h = _mm256_unpackhi_epi32(a16, a16);
+}
+
+/* MUL_256(a, c), a in [0, 256] per pixel */
+static EFL_ALWAYS_INLINE __m256i
+mul_256_avx2(__m256i a, __m256i c)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   __m256i a_l, a_h;
+
+   spread_a_avx2(a, &a_l, &a_h);
+
+   __m256i c_l = _mm256_unpacklo_epi8(c, zero);
+   __m256i c_h = _mm256_unpackhi_epi8(c, zero);
+
+   c_l = _mm256_srli_epi16(_mm256_mullo_epi16(c_l, a_l), 8);
+   c_h = _mm256_srli_epi16(_mm256_mullo_epi16(c_h, a_h), 8);
+
+   return _mm256_packus_epi16(c_l, c_h);
+}
+
+/* MUL_SYM(a, c), a in [0, 255] per pixel */
+static EFL_ALWAYS_INLINE __m256i
+mul_sym_avx2(__m256i a, __m256i c)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i ff = _mm256_set1_epi16(0xff);
+   __m256i a_l, a_h;
+
+   spread_a_avx2(a, &a_l, &a_h);
+
+   __m256i c_l = _mm256_unpacklo_epi8(c, zero);
+   __m256i c_h = _mm256_unpackhi_epi8(c, zero);
+
+   c_l = _mm256_add_epi16(_mm256_mullo_epi16(c_l, a_l), ff);
+   c_h = _mm256_add_epi16(_mm256_mullo_epi16(c_h, a_h), ff);
+
+   return _mm256_packus_epi16(_mm256_srli_epi16(c_l, 8),
+                              _mm256_srli_epi16(c_h, 8));
+}
+
+/* MUL4_SYM(x, y) */
+static EFL_ALWAYS_INLINE __m256i
+mul4_sym_avx2(__m256i x, __m256i y)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i ff = _mm256_set1_epi16(0xff);
+
+   __m256i r_l = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero),
+                                    _mm256_unpacklo_epi8(y, zero));
+   __m256i r_h = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero),
+                                    _mm256_unpackhi_epi8(y, zero));
+
+   r_l = _mm256_srli_epi16(_mm256_add_epi16(r_l, ff), 8);
+   r_h = _mm256_srli_epi16(_mm256_add_epi16(r_h, ff), 8);
+
+   return _mm256_packus_epi16(r_l, r_h);
+}
+
+/* 256 - alpha */
+static EFL_ALWAYS_INLINE __m256i
+sub4_alpha_avx2(__m256i c)
+{
+   return _mm256_sub_epi32(_mm256_set1_epi32(256), _mm256_srli_epi32(c, 24));
+}
+
+#endif
+#endif
+
 #define LOOP_ALIGNED_U1_A48(DEST, LENGTH, UOP, A4OP, A8OP) \
   {                                                        \
       while((uintptr_t)DEST & 0xF && LENGTH) UOP \
@@ -439,4 +534,13 @@ mul3_sym_sse3(__m128i x, __m128i y) {
       } \
    }
 
+#define LOOP_ALIGNED_U1_A8(DEST, LENGTH, UOP, A8OP) \
+  {                                                        \
+      while((uintptr_t)DEST & 0x1F && LENGTH) UOP \
+   \
+      while(LENGTH >= 8) A8OP \
+   \
+      while(LENGTH) UOP \
+   }
+
 #endif
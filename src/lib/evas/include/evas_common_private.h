@@ -217,7 +217,7 @@ extern EAPI int _evas_log_dom_global;
 
 # define TH(x)  pthread_t x
 # define THI(x) int x
-# define TH_MAX 8
+# define TH_MAX 32
 
 #ifdef __GNUC__
 # if __GNUC__ >= 4
@@ -500,7 +500,9 @@ typedef enum _CPU_Features
    CPU_FEATURE_VIS2    = (1 << 5),
    CPU_FEATURE_NEON    = (1 << 6),
    CPU_FEATURE_SSE3    = (1 << 7),
-   CPU_FEATURE_SVE     = (1 << 8)
+   CPU_FEATURE_SVE     = (1 << 8),
+   CPU_FEATURE_AVX2    = (1 << 9),
+   CPU_FEATURE_SSE41   = (1 << 10)
 } CPU_Features;
 
 /*****************************************************************************/
@@ -535,9 +537,12 @@ struct _Image_Entry_Flags
 
 struct _Image_Entry_Frame
 {
+   EINA_INLIST;        /* decoded frames lru, shared by all images */
    int       index;
    DATA32   *data;     /* frame decoding data */
    void     *info;     /* special image type info */
+   Image_Entry *ie;    /* image of the frame, when given to the frame lru */
+   size_t    size;     /* bytes of data, when given to the frame lru */
    Eina_Bool loaded       : 1;
 };
 
@@ -622,6 +627,18 @@ struct _Image_Entry
    /* for animation feature */
    Evas_Image_Animated   animated;
 
+   /* frames of the animation, see evas_common_load_animated_frame_*() */
+   struct
+     {
+        Image_Entry_Frame   **index; // frame by number, built after the header
+        int                   count;
+        size_t                size; // bytes of the frames in the lru
+        int                   busy; // loader running, its frames are not dropped
+        int                   decode; // frame to decode instead of cur_frame
+        Evas_Preload_Pthread *preload; // decoding ahead of cur_frame
+        Eina_Bool             managed : 1; // loader gives its frames to the lru
+     } frames;
+
    /* Reference to the file */
    Eina_File             *f;
    void                  *loader_data;
@@ -785,8 +802,10 @@ struct _RGBA_Pipe
 
 struct _RGBA_Pipe_Thread_Info
 {
-   EINA_INLIST;
-   Eina_Rectangle area;
+   Eina_Rectangle     area;
+   unsigned long long cost; // estimated cost, used to order tiles
+   double             time; // render time, only set when EVAS_PIPE_STATS is on
+   int                thread; // thread that rendered the tile
 };
 #endif
 
@@ -1112,6 +1131,7 @@ Tilebuf_Rect *evas_common_regionbuf_rects_get (Regionbuf *rb);
 
 /****/
 #include "../common/evas_draw.h"
+#include "../common/evas_parallel.h"
 
 #include "../common/evas_map_image.h"
 
@@ -1148,8 +1168,10 @@ typedef struct _Generic_Cache_Entry    Generic_Cache_Entry;
 
 struct _Generic_Cache_Entry
 {
+   EINA_INLIST;
    void         *key;     // pointer
    void         *data; // engine image
+   size_t        size;
    int           ref;
 };
 
@@ -1158,17 +1180,22 @@ typedef void (*Generic_Cache_Free)(void *user_data, void *data);
 struct _Generic_Cache
 {
    Eina_Hash          *hash;
-   Eina_List          *lru_list;
+   Eina_Inlist        *lru; // most recently used first
    void               *user_data;
    Generic_Cache_Free  free_func;
+   size_t              size, max_size;
+   int                 count, max_count;
 };
 
 EAPI Generic_Cache* generic_cache_new(void *user_data, Generic_Cache_Free func);
 EAPI void generic_cache_destroy(Generic_Cache *cache);
 EAPI void generic_cache_dump(Generic_Cache *cache);
-EAPI void generic_cache_data_set(Generic_Cache *cache, void *key, void *data);
+EAPI void generic_cache_data_set(Generic_Cache *cache, void *key, void *data, size_t size);
 EAPI void *generic_cache_data_get(Generic_Cache *cache, void *key);
 EAPI void generic_cache_data_drop(Generic_Cache *cache, void *key);
+EAPI void generic_cache_data_del(Generic_Cache *cache, void *key);
+EAPI void generic_cache_detach(Generic_Cache *cache);
+EAPI void generic_cache_key_del(void *key);
 
 /*****************************************************************************/
 
@@ -1498,6 +1498,7 @@ struct _Evas_Func
    void  (*ector_surface_cache_set)      (void *engine, void *key, void *surface);
    void *(*ector_surface_cache_get)      (void *engine, void *key);
    void  (*ector_surface_cache_drop)     (void *engine, void *key);
+   void  (*ector_surface_cache_del)      (void *engine, void *key);
 
    Evas_Filter_Support (*gfx_filter_supports) (void *engine, Evas_Filter_Command *cmd);
    Eina_Bool (*gfx_filter_process)       (void *engine, Evas_Filter_Command *cmd);
@@ -147,6 +147,9 @@ _evas_cache_vg_entry_free_cb(void *data)
 {
    Vg_Cache_Entry *vg_entry = data;
 
+   // rasters are cached under the entry, a new one could get its address
+   generic_cache_key_del(vg_entry);
+
    if (vg_entry->vfd)
      {
         vg_entry->vfd->ref--;
@@ -45,6 +45,7 @@
 #include "eina_lock.h"
 #include "eina_thread.h"
 #include "eina_cpu.h"
+#include "eina_log.h"
 
 #include "eina_private.h"
 
@@ -54,7 +55,6 @@
 
 #if defined DEBUG || defined EINA_DEBUG_MALLOC
 #include <assert.h>
-#include "eina_log.h"
 
 static int _eina_chained_mp_log_dom = -1;
 
@@ -70,9 +70,58 @@ static int _eina_chained_mp_log_dom = -1;
 
 #endif
 
+/* Every thread keeps a small LIFO of free items per mempool (a magazine) so
+ * that most alloc/free do not touch the shared spinlock. A magazine is
+ * refilled from and spilled to the shared pool CHAINED_MAGAZINE_BATCH items
+ * at a time. */
+#define CHAINED_MAGAZINE_SIZE 32
+#define CHAINED_MAGAZINE_BATCH 16
+
 static int aligned_chained_pool = 0;
 static int page_size = 0;
 
+typedef struct _Chained_Stats Chained_Stats;
+struct _Chained_Stats
+{
+   unsigned long alloc; // served under the shared lock
+   unsigned long free;
+   unsigned long alloc_hit; // served by a magazine
+   unsigned long free_hit;
+   unsigned long refill;
+   unsigned long spill;
+};
+
+typedef struct _Chained_Mempool Chained_Mempool;
+
+typedef struct _Chained_Magazine Chained_Magazine;
+struct _Chained_Magazine
+{
+   Chained_Mempool *pool;
+   unsigned int serial;
+   int count;
+   Chained_Stats stats;
+   void *items[CHAINED_MAGAZINE_SIZE];
+};
+
+typedef struct _Chained_Thread Chained_Thread;
+struct _Chained_Thread
+{
+   EINA_INLIST;
+   Chained_Magazine *magazines; // indexed by Chained_Mempool slot
+   unsigned int count;
+};
+
+/* The lock protects the thread list, the slot registry and the growth of
+ * the magazines array of each thread. It is always taken before a
+ * Chained_Mempool mutex, never after. */
+static Eina_Lock _chained_magazine_lock;
+static Eina_TLS _chained_magazine_key;
+static Eina_Bool _chained_magazine_enabled = EINA_FALSE;
+static Eina_Inlist *_chained_threads = NULL;
+static Chained_Mempool **_chained_slots = NULL;
+static unsigned int _chained_slots_count = 0;
+static unsigned int _chained_serial = 0;
+
 typedef struct _Chained_Pool Chained_Pool;
 struct _Chained_Pool
 {
@@ -85,7 +134,6 @@ struct _Chained_Pool
    unsigned char *limit;
 };
 
-typedef struct _Chained_Mempool Chained_Mempool;
 struct _Chained_Mempool
 {
    Eina_Inlist *first;
@@ -97,6 +145,9 @@ struct _Chained_Mempool
    int group_size;
    int usage;
    Chained_Pool* first_fill; //All allocation will happen in this chain,unless it is filled
+   unsigned int slot;
+   unsigned int serial; // 0 if this pool does not use magazines
+   Chained_Stats stats;
 #ifdef EINA_DEBUG_MALLOC
    int minimal_size;
 #endif
@@ -269,18 +320,9 @@ _eina_chained_mempool_free_in(Chained_Mempool *pool, Chained_Pool *p, void *ptr)
 }
 
 static void *
-eina_chained_mempool_malloc(void *data, EINA_UNUSED unsigned int size)
+_eina_chained_mempool_alloc_locked(Chained_Mempool *pool)
 {
-   Chained_Mempool *pool = data;
    Chained_Pool *p = NULL;
-   void *mem;
-
-   if (!eina_spinlock_take(&pool->mutex))
-     {
-#ifdef EINA_HAVE_DEBUG_THREADS
-        assert(eina_thread_equal(pool->self, eina_thread_self()));
-#endif
-     }
 
    //we have some free space in first fill chain
    if (pool->first_fill) p = pool->first_fill;
@@ -309,65 +351,248 @@ eina_chained_mempool_malloc(void *data, EINA_UNUSED unsigned int size)
      {
        //new chain created ,point it to be the first_fill chain
         pool->first_fill = _eina_chained_mp_pool_new(pool);
-        if (!pool->first_fill)
-          {
-             eina_spinlock_release(&pool->mutex);
-             return NULL;
-          }
+        if (!pool->first_fill) return NULL;
 
         pool->first = eina_inlist_prepend(pool->first, EINA_INLIST_GET(pool->first_fill));
         pool->root = eina_rbtree_inline_insert(pool->root, EINA_RBTREE_GET(pool->first_fill),
                                                _eina_chained_mp_pool_cmp, NULL);
      }
 
-   mem = _eina_chained_mempool_alloc_in(pool, pool->first_fill);
-
-   eina_spinlock_release(&pool->mutex);
-
-   return mem;
+   return _eina_chained_mempool_alloc_in(pool, pool->first_fill);
 }
 
 static void
-eina_chained_mempool_free(void *data, void *ptr)
+_eina_chained_mempool_free_locked(Chained_Mempool *pool, void *ptr)
 {
-   Chained_Mempool *pool = data;
    Eina_Rbtree *r;
-   Chained_Pool *p;
 
-   // look 4 pool
+   // searching for the right mempool
+   r = eina_rbtree_inline_lookup(pool->root, ptr, 0, _eina_chained_mp_pool_key_cmp, NULL);
+
+   if (r)
+     _eina_chained_mempool_free_in(pool, EINA_RBTREE_CONTAINER_GET(r, Chained_Pool), ptr);
+#ifdef DEBUG
+   // related mempool not found
+   else
+     ERR("%p is not the property of %p Chained_Mempool", ptr, pool);
+#endif
+
+#ifndef NVALGRIND
+   if (ptr)
+     {
+        VALGRIND_MEMPOOL_FREE(pool, ptr);
+     }
+#endif
+}
+
+static inline void
+_eina_chained_mempool_lock(Chained_Mempool *pool)
+{
    if (!eina_spinlock_take(&pool->mutex))
      {
 #ifdef EINA_HAVE_DEBUG_THREADS
         assert(eina_thread_equal(pool->self, eina_thread_self()));
 #endif
      }
+}
 
-   // searching for the right mempool
-   r = eina_rbtree_inline_lookup(pool->root, ptr, 0, _eina_chained_mp_pool_key_cmp, NULL);
+static void
+_eina_chained_magazine_stats_add(Chained_Stats *dst, const Chained_Stats *src)
+{
+   dst->alloc += src->alloc;
+   dst->free += src->free;
+   dst->alloc_hit += src->alloc_hit;
+   dst->free_hit += src->free_hit;
+   dst->refill += src->refill;
+   dst->spill += src->spill;
+}
 
-   // related mempool not found
-   if (!r)
+static void
+_eina_chained_magazine_refill(Chained_Mempool *pool, Chained_Magazine *mag)
+{
+   void *mem;
+
+   _eina_chained_mempool_lock(pool);
+   while (mag->count < CHAINED_MAGAZINE_BATCH)
      {
-#ifdef DEBUG
-        ERR("%p is not the property of %p Chained_Mempool", ptr, pool);
-#endif
-        goto on_error;
+        mem = _eina_chained_mempool_alloc_locked(pool);
+        if (!mem) break;
+        mag->items[mag->count++] = mem;
      }
+   eina_spinlock_release(&pool->mutex);
 
-   p = EINA_RBTREE_CONTAINER_GET(r, Chained_Pool);
+   mag->stats.refill++;
+}
 
-   _eina_chained_mempool_free_in(pool, p, ptr);
+// give back the n oldest items of the magazine to the shared pool
+static void
+_eina_chained_magazine_spill(Chained_Mempool *pool, Chained_Magazine *mag, int n)
+{
+   int i;
 
- on_error:
-#ifndef NVALGRIND
-   if (ptr)
+   _eina_chained_mempool_lock(pool);
+   for (i = 0; i < n; i++)
+     _eina_chained_mempool_free_locked(pool, mag->items[i]);
+   eina_spinlock_release(&pool->mutex);
+
+   mag->count -= n;
+   memmove(mag->items, mag->items + n, mag->count * sizeof (void *));
+   mag->stats.spill++;
+}
+
+// the magazine of the calling thread for pool if it has one already
+static inline Chained_Magazine *
+_eina_chained_magazine_find(Chained_Mempool *pool)
+{
+   Chained_Thread *th;
+   Chained_Magazine *mag;
+
+   if (!pool->serial) return NULL;
+
+   th = eina_tls_get(_chained_magazine_key);
+   if (!th || pool->slot >= th->count) return NULL;
+
+   mag = &th->magazines[pool->slot];
+   if (mag->serial != pool->serial) return NULL;
+   return mag;
+}
+
+static Chained_Magazine *
+_eina_chained_magazine_attach(Chained_Mempool *pool)
+{
+   Chained_Thread *th;
+   Chained_Magazine *mag = NULL;
+
+   eina_lock_take(&_chained_magazine_lock);
+
+   th = eina_tls_get(_chained_magazine_key);
+   if (!th)
      {
-        VALGRIND_MEMPOOL_FREE(pool, ptr);
+        th = calloc(1, sizeof (Chained_Thread));
+        if (!th) goto end;
+        if (!eina_tls_set(_chained_magazine_key, th))
+          {
+             free(th);
+             goto end;
+          }
+        _chained_threads = eina_inlist_append(_chained_threads, EINA_INLIST_GET(th));
      }
-#endif
 
+   if (pool->slot >= th->count)
+     {
+        Chained_Magazine *tmp;
+
+        tmp = realloc(th->magazines, _chained_slots_count * sizeof (Chained_Magazine));
+        if (!tmp) goto end;
+        memset(tmp + th->count, 0, (_chained_slots_count - th->count) * sizeof (Chained_Magazine));
+        th->magazines = tmp;
+        th->count = _chained_slots_count;
+     }
+
+   mag = &th->magazines[pool->slot];
+   if (mag->serial != pool->serial)
+     {
+        // left over from a dead mempool that used the same slot, its
+        // items are gone with it
+        memset(mag, 0, sizeof (Chained_Magazine));
+        mag->pool = pool;
+        mag->serial = pool->serial;
+     }
+
+ end:
+   eina_lock_release(&_chained_magazine_lock);
+   return mag;
+}
+
+static inline Chained_Magazine *
+_eina_chained_magazine_get(Chained_Mempool *pool)
+{
+   Chained_Magazine *mag;
+
+   if (!pool->serial) return NULL;
+
+   mag = _eina_chained_magazine_find(pool);
+   if (EINA_LIKELY(mag != NULL)) return mag;
+   return _eina_chained_magazine_attach(pool);
+}
+
+static void
+_eina_chained_magazine_thread_free(void *data)
+{
+   Chained_Thread *th = data;
+   unsigned int i;
+
+   eina_lock_take(&_chained_magazine_lock);
+   for (i = 0; i < th->count; i++)
+     {
+        Chained_Magazine *mag = &th->magazines[i];
+        Chained_Mempool *pool = mag->pool;
+
+        // only touch the mempool if it is still alive
+        if (!mag->serial || i >= _chained_slots_count ||
+            _chained_slots[i] != pool || pool->serial != mag->serial)
+          continue;
+
+        if (mag->count)
+          _eina_chained_magazine_spill(pool, mag, mag->count);
+
+        _eina_chained_mempool_lock(pool);
+        _eina_chained_magazine_stats_add(&pool->stats, &mag->stats);
+        eina_spinlock_release(&pool->mutex);
+     }
+   _chained_threads = eina_inlist_remove(_chained_threads, EINA_INLIST_GET(th));
+   eina_lock_release(&_chained_magazine_lock);
+
+   free(th->magazines);
+   free(th);
+}
+
+static void *
+eina_chained_mempool_malloc(void *data, EINA_UNUSED unsigned int size)
+{
+   Chained_Mempool *pool = data;
+   Chained_Magazine *mag;
+   void *mem;
+
+   mag = _eina_chained_magazine_get(pool);
+   if (mag)
+     {
+        if (!mag->count) _eina_chained_magazine_refill(pool, mag);
+        if (mag->count)
+          {
+             mag->stats.alloc_hit++;
+             return mag->items[--mag->count];
+          }
+     }
+
+   _eina_chained_mempool_lock(pool);
+   mem = _eina_chained_mempool_alloc_locked(pool);
+   pool->stats.alloc++;
+   eina_spinlock_release(&pool->mutex);
+
+   return mem;
+}
+
+static void
+eina_chained_mempool_free(void *data, void *ptr)
+{
+   Chained_Mempool *pool = data;
+   Chained_Magazine *mag;
+
+   mag = _eina_chained_magazine_get(pool);
+   if (mag)
+     {
+        if (mag->count == CHAINED_MAGAZINE_SIZE)
+          _eina_chained_magazine_spill(pool, mag, CHAINED_MAGAZINE_BATCH);
+        mag->items[mag->count++] = ptr;
+        mag->stats.free_hit++;
+        return;
+     }
+
+   _eina_chained_mempool_lock(pool);
+   _eina_chained_mempool_free_locked(pool, ptr);
+   pool->stats.free++;
    eina_spinlock_release(&pool->mutex);
-   return;
 }
 
 static Eina_Bool
@@ -380,8 +605,17 @@ eina_chained_mempool_from(void *data, void *ptr)
 #ifndef NVALGRIND
    Eina_Trash *last = NULL;
 #endif
+   Chained_Magazine *mag;
    void *pmem;
    Eina_Bool ret = EINA_FALSE;
+   int i;
+
+   // freed in this thread but not given back to the shared pool yet, other
+   // threads magazines can not be looked at without racing with them
+   mag = _eina_chained_magazine_find(pool);
+   if (mag)
+     for (i = 0; i < mag->count; i++)
+       if (mag->items[i] == ptr) return EINA_FALSE;
 
    // look 4 pool
    if (!eina_spinlock_take(&pool->mutex))
@@ -453,6 +687,21 @@ eina_chained_mempool_repack(void *data,
   Chained_Pool *start;
   Chained_Pool *tail;
 
+  if (pool->serial)
+    {
+       Chained_Magazine *mag;
+
+       /* items sitting in a magazine look alive to the shared pool, moving
+          them around would hand free memory to cb. Other threads fill their
+          magazines without any lock, so there is no telling which items
+          they hold: only give ours back, which releases the chunks that
+          it leaves empty, and move nothing. */
+       mag = _eina_chained_magazine_find(pool);
+       if (mag && mag->count)
+         _eina_chained_magazine_spill(pool, mag, mag->count);
+       return;
+    }
+
   /* FIXME: Improvement - per Chained_Pool lock */
    if (!eina_spinlock_take(&pool->mutex))
      {
@@ -538,6 +787,48 @@ eina_chained_mempool_realloc(EINA_UNUSED void *data,
    return NULL;
 }
 
+static void
+_eina_chained_magazine_register(Chained_Mempool *mp)
+{
+   unsigned int i;
+
+   eina_lock_take(&_chained_magazine_lock);
+   for (i = 0; i < _chained_slots_count; i++)
+     if (!_chained_slots[i]) break;
+
+   if (i == _chained_slots_count)
+     {
+        Chained_Mempool **tmp;
+        unsigned int count;
+
+        count = _chained_slots_count ? _chained_slots_count * 2 : 16;
+        tmp = realloc(_chained_slots, count * sizeof (Chained_Mempool *));
+        if (!tmp) goto end;
+        memset(tmp + _chained_slots_count, 0,
+               (count - _chained_slots_count) * sizeof (Chained_Mempool *));
+        _chained_slots = tmp;
+        _chained_slots_count = count;
+     }
+
+   _chained_slots[i] = mp;
+   mp->slot = i;
+   // never 0, that is how a pool without magazine is told apart
+   if (!++_chained_serial) ++_chained_serial;
+   mp->serial = _chained_serial;
+
+ end:
+   eina_lock_release(&_chained_magazine_lock);
+}
+
+static void
+_eina_chained_magazine_unregister(Chained_Mempool *mp)
+{
+   // magazines left in other threads are recognized as stale by their serial
+   eina_lock_take(&_chained_magazine_lock);
+   _chained_slots[mp->slot] = NULL;
+   eina_lock_release(&_chained_magazine_lock);
+}
+
 static void *
 eina_chained_mempool_init(const char *context,
                           EINA_UNUSED const char *option,
@@ -585,6 +876,9 @@ eina_chained_mempool_init(const char *context,
    mp->first_fill = NULL;
    eina_spinlock_new(&mp->mutex);
 
+   if (_chained_magazine_enabled)
+     _eina_chained_magazine_register(mp);
+
    return mp;
 }
 
@@ -595,6 +889,9 @@ eina_chained_mempool_shutdown(void *data)
 
    mp = (Chained_Mempool *)data;
 
+   if (mp->serial)
+     _eina_chained_magazine_unregister(mp);
+
    while (mp->first)
      {
         Chained_Pool *p = (Chained_Pool *)mp->first;
@@ -626,6 +923,55 @@ eina_chained_mempool_shutdown(void *data)
    free(mp);
 }
 
+static void
+eina_chained_mempool_statistics(void *data)
+{
+   Chained_Mempool *pool = data;
+   Chained_Stats stats;
+   Chained_Thread *th;
+   Chained_Pool *p;
+   unsigned int threads = 0;
+   int cached = 0;
+   int chunks = 0;
+
+   memset(&stats, 0, sizeof (Chained_Stats));
+
+   // the counters of other threads are read while they run, close enough
+   eina_lock_take(&_chained_magazine_lock);
+   if (pool->serial)
+     EINA_INLIST_FOREACH(_chained_threads, th)
+       {
+          Chained_Magazine *mag;
+
+          if (pool->slot >= th->count) continue;
+          mag = &th->magazines[pool->slot];
+          if (mag->serial != pool->serial) continue;
+
+          _eina_chained_magazine_stats_add(&stats, &mag->stats);
+          cached += mag->count;
+          threads++;
+       }
+
+   _eina_chained_mempool_lock(pool);
+   _eina_chained_magazine_stats_add(&stats, &pool->stats);
+   EINA_INLIST_FOREACH(pool->first, p)
+     chunks++;
+
+   EINA_LOG_DBG("DDD: chained mempool '%s' %p: %i items of %i bytes in use in %i chunks of %i items",
+                 pool->name ? pool->name : "", pool, pool->usage - cached,
+                 pool->item_alloc, chunks, pool->pool_size);
+   EINA_LOG_DBG("DDD:   %i items cached by %u thread magazines", cached, threads);
+   EINA_LOG_DBG("DDD:   alloc: %lu from magazines, %lu locked",
+                 stats.alloc_hit, stats.alloc);
+   EINA_LOG_DBG("DDD:   free: %lu to magazines, %lu locked",
+                 stats.free_hit, stats.free);
+   EINA_LOG_DBG("DDD:   magazines: %lu refills, %lu spills",
+                 stats.refill, stats.spill);
+
+   eina_spinlock_release(&pool->mutex);
+   eina_lock_release(&_chained_magazine_lock);
+}
+
 static Eina_Mempool_Backend _eina_chained_mp_backend = {
    "chained_mempool",
    &eina_chained_mempool_init,
@@ -633,7 +979,7 @@ static Eina_Mempool_Backend _eina_chained_mp_backend = {
    &eina_chained_mempool_malloc,
    &eina_chained_mempool_realloc,
    NULL,
-   NULL,
+   &eina_chained_mempool_statistics,
    &eina_chained_mempool_shutdown,
    &eina_chained_mempool_repack,
    &eina_chained_mempool_from
@@ -654,12 +1000,51 @@ Eina_Bool chained_init(void)
    aligned_chained_pool = eina_mempool_alignof(sizeof(Chained_Pool));
    page_size = eina_cpu_page_size();
 
+   /* Magazines defer the validation of freed pointers and hide which items
+      are really free from valgrind, leave them out when debugging. */
+   _chained_magazine_enabled = !getenv("EINA_MEMPOOL_NO_MAGAZINE");
+#ifdef DEBUG
+   _chained_magazine_enabled = EINA_FALSE;
+#endif
+#ifndef NVALGRIND
+   if (RUNNING_ON_VALGRIND) _chained_magazine_enabled = EINA_FALSE;
+#endif
+   if (_chained_magazine_enabled)
+     {
+        if (!eina_lock_new(&_chained_magazine_lock))
+          _chained_magazine_enabled = EINA_FALSE;
+        else if (!eina_tls_cb_new(&_chained_magazine_key,
+                                  _eina_chained_magazine_thread_free))
+          {
+             eina_lock_free(&_chained_magazine_lock);
+             _chained_magazine_enabled = EINA_FALSE;
+          }
+     }
+
    return eina_mempool_register(&_eina_chained_mp_backend);
 }
 
 void chained_shutdown(void)
 {
    eina_mempool_unregister(&_eina_chained_mp_backend);
+   if (_chained_magazine_enabled)
+     {
+        Chained_Thread *th;
+
+        // the threads still running will not call the TLS destructor
+        EINA_INLIST_FREE(_chained_threads, th)
+          {
+             _chained_threads = eina_inlist_remove(_chained_threads, EINA_INLIST_GET(th));
+             free(th->magazines);
+             free(th);
+          }
+        free(_chained_slots);
+        _chained_slots = NULL;
+        _chained_slots_count = 0;
+        eina_tls_free(_chained_magazine_key);
+        eina_lock_free(&_chained_magazine_lock);
+        _chained_magazine_enabled = EINA_FALSE;
+     }
 #if defined DEBUG || defined EINA_DEBUG_MALLOC
    eina_log_domain_unregister(_eina_chained_mp_log_dom);
    _eina_chained_mp_log_dom = -1;
@@ -170,6 +170,7 @@ eng_engine_free(void *engine)
 
    //@FIXME this causes some deadlock while freeing the engine image.
    //generic_cache_destroy(e->software.surface_cache);
+   generic_cache_detach(e->software.surface_cache);
 
    EINA_LIST_FREE(e->software.outputs, output)
      ERR("Output %p not properly cleaned before engine destruction.", output);
@@ -2142,6 +2143,7 @@ eng_image_animated_frame_set(void *engine EINA_UNUSED, void *image, int frame_in
    if (im->animated.cur_frame == frame_index) return EINA_FALSE;
 
    im->animated.cur_frame = frame_index;
+   evas_cache_image_frames_preload(im);
    return EINA_TRUE;
 }
 
@@ -2695,9 +2697,11 @@ static void
 eng_ector_surface_cache_set(void *engine, void *key , void *surface)
 {
    Render_Engine_GL_Generic *e = engine;
+   int w = 0, h = 0;
 
-   generic_cache_data_set(e->software.surface_cache, key, surface);
-
+   eng_image_size_get(engine, surface, &w, &h);
+   generic_cache_data_set(e->software.surface_cache, key, surface,
+                          (size_t)w * h * sizeof(DATA32));
 }
 
 static void *
@@ -2716,6 +2720,14 @@ eng_ector_surface_cache_drop(void *engine, void *key)
    generic_cache_data_drop(e->software.surface_cache, key);
 }
 
+static void
+eng_ector_surface_cache_del(void *engine, void *key)
+{
+   Render_Engine_GL_Generic *e = engine;
+
+   generic_cache_data_del(e->software.surface_cache, key);
+}
+
 static void
 eng_ector_begin(void *engine, void *surface,
                 void *context EINA_UNUSED, Ector_Surface *ector,
@@ -3333,6 +3345,7 @@ module_open(Evas_Module *em)
    ORD(ector_surface_cache_set);
    ORD(ector_surface_cache_get);
    ORD(ector_surface_cache_drop);
+   ORD(ector_surface_cache_del);
    ORD(gfx_filter_supports);
    ORD(gfx_filter_process);
 
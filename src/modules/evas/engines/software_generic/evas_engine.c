@@ -2829,6 +2829,7 @@ eng_image_animated_frame_set(void *data EINA_UNUSED, void *image, int frame_inde
    if (!im->animated.animated) return EINA_FALSE;
    if (im->animated.cur_frame == frame_index) return EINA_FALSE;
    im->animated.cur_frame = frame_index;
+   evas_cache_image_frames_preload(im);
    return EINA_TRUE;
 }
 
@@ -4199,9 +4200,10 @@ static void
 eng_ector_surface_cache_set(void *engine, void *key , void *surface)
 {
    Render_Engine_Software_Generic *e = engine;
+   Image_Entry *im = surface;
 
-   generic_cache_data_set(e->surface_cache, key, surface);
-
+   generic_cache_data_set(e->surface_cache, key, surface,
+                          (size_t)im->w * im->h * sizeof(DATA32));
 }
 
 static void *
@@ -4220,6 +4222,14 @@ eng_ector_surface_cache_drop(void *engine, void *key)
    generic_cache_data_drop(e->surface_cache, key);
 }
 
+static void
+eng_ector_surface_cache_del(void *engine, void *key)
+{
+   Render_Engine_Software_Generic *e = engine;
+
+   generic_cache_data_del(e->surface_cache, key);
+}
+
 static void
 eng_ector_destroy(void *data EINA_UNUSED, Ector_Surface *ector)
 {
@@ -4730,6 +4740,7 @@ static Evas_Func func =
      eng_ector_surface_cache_set,
      eng_ector_surface_cache_get,
      eng_ector_surface_cache_drop,
+     eng_ector_surface_cache_del,
      eng_gfx_filter_supports,
      eng_gfx_filter_process,
    /* FUTURE software generic calls go here */
@@ -5855,6 +5866,7 @@ module_open(Evas_Module *em)
 //   init_gl();
    ector_glsym_set(dlsym, RTLD_DEFAULT);
    evas_common_pipe_init();
+   eng_filter_parallel_init();
 
    em->functions = (void *)(&func);
    cpunum = eina_cpu_count();
@@ -5864,6 +5876,7 @@ module_open(Evas_Module *em)
 static void
 module_close(Evas_Module *em EINA_UNUSED)
 {
+   eng_filter_parallel_shutdown();
    ector_shutdown();
    eina_mempool_del(_mp_command_rect);
    eina_mempool_del(_mp_command_line);
@@ -2,15 +2,115 @@
  * Should define the functions:
  * - _box_blur_horiz_rgba_step
  * - _box_blur_vert_rgba_step
+ *
+ * The SIMD variants only need to provide a span function, see
+ * _box_blur_rgba_span().
  */
 
 #include "evas_filter_private.h"
 
+typedef void (*Box_Blur_Rgba_Span_Func)(const DATA32* restrict src,
+                                        DATA32* restrict dst,
+                                        const int len, const int radius,
+                                        const int pow2, const int numerator);
+
+// Apply one box blur run on a contiguous span of len pixels
 static inline void
-_box_blur_rgba_horiz_step(const uint32_t* restrict srcdata, int src_stride,
-                          uint32_t* restrict dstdata, int dst_stride,
-                          const int* restrict const radii,
-                          Eina_Rectangle region)
+_box_blur_rgba_span(const DATA32* restrict src, DATA32* restrict dst,
+                    const int len, const int radius,
+                    const int pow2 EINA_UNUSED, const int numerator EINA_UNUSED)
+{
+   const int left = MIN(radius, len);
+
+#if !DIV_USING_BITSHIFT
+   const int divider = 2 * radius + 1;
+#endif
+
+   const DATA8* restrict sl = (DATA8 *) src;
+   const DATA8* restrict sr = (DATA8 *) src;
+   const DATA8* restrict sre = (DATA8 *) (src + len);
+   const DATA8* restrict sle = (DATA8 *) (src + len - radius);
+   DATA8* restrict d = (DATA8 *) dst;
+   int acc[4] = {0};
+   int count = 0;
+
+   // Read-ahead
+   for (int x = left; x > 0; x--)
+     {
+        for (int k = 0; k < 4; k++)
+          acc[k] += sr[k];
+        sr += sizeof(DATA32);
+        count++;
+     }
+
+   // Left
+   for (int x = left; x > 0; x--)
+     {
+        if (sr < sre)
+          {
+             for (int k = 0; k < 4; k++)
+               acc[k] += sr[k];
+             sr += sizeof(DATA32);
+             count++;
+          }
+
+        d[ALPHA] = acc[ALPHA] / count;
+        d[RED]   = acc[RED]   / count;
+        d[GREEN] = acc[GREEN] / count;
+        d[BLUE]  = acc[BLUE]  / count;
+        d += sizeof(DATA32);
+     }
+
+   // Main part
+   for (; sr < sre; sr += sizeof(DATA32), sl += sizeof(DATA32))
+     {
+        for (int k = 0; k < 4; k++)
+          acc[k] += sr[k];
+
+        d[ALPHA] = DIVIDE(acc[ALPHA]);
+        d[RED]   = DIVIDE(acc[RED]);
+        d[GREEN] = DIVIDE(acc[GREEN]);
+        d[BLUE]  = DIVIDE(acc[BLUE]);
+        d += sizeof(DATA32);
+
+        for (int k = 0; k < 4; k++)
+          acc[k] -= sl[k];
+     }
+
+   // Right part
+   count = 2 * radius + 1;
+   for (; sl < sle; sl += sizeof(DATA32))
+     {
+        const int div = --count;
+        d[ALPHA] = acc[ALPHA] / div;
+        d[RED]   = acc[RED]   / div;
+        d[GREEN] = acc[GREEN] / div;
+        d[BLUE]  = acc[BLUE]  / div;
+        d += sizeof(DATA32);
+
+        for (int k = 0; k < 4; k++)
+          acc[k] -= sl[k];
+     }
+}
+
+static inline void
+_box_blur_rgba_divider_init(const int* restrict const radii,
+                            int *pow2_shifts, int *numerators)
+{
+   for (int run = 0; radii[run]; run++)
+     {
+        const int div = radii[run] * 2 + 1;
+        pow2_shifts[run] = evas_filter_smallest_pow2_larger_than(div << 10);
+        numerators[run] = (1 << pow2_shifts[run]) / (div);
+     }
+}
+
+static inline void
+_box_blur_rgba_horiz_step_do(const uint32_t* restrict srcdata, int src_stride,
+                             uint32_t* restrict dstdata, int dst_stride,
+                             const int* restrict const radii,
+                             Eina_Rectangle region,
+                             Box_Blur_Rgba_Span_Func span_func)
 {
    const int len = region.w;
    const int loops = region.h;
@@ -20,16 +120,9 @@ _box_blur_rgba_horiz_step(const uint32_t* restrict srcdata, int src_stride,
    DATA32* restrict span1;
    DATA32* restrict span2;
 
-#if DIV_USING_BITSHIFT
    int pow2_shifts[6] = {0};
    int numerators[6] = {0};
-   for (int run = 0; radii[run]; run++)
-     {
-        const int div = radii[run] * 2 + 1;
-        pow2_shifts[run] = evas_filter_smallest_pow2_larger_than(div << 10);
-        numerators[run] = (1 << pow2_shifts[run]) / (div);
-     }
-#endif
+   _box_blur_rgba_divider_init(radii, pow2_shifts, numerators);
 
    srcdata += region.x + src_stride * region.y;
    dstdata += region.x + dst_stride * region.y;
@@ -54,81 +147,8 @@ _box_blur_rgba_horiz_step(const uint32_t* restrict srcdata, int src_stride,
         // Apply blur with current radius
         for (run = 0; radii[run]; run++)
           {
-             const int radius = radii[run];
-             const int left = MIN(radius, len);
-
-#if DIV_USING_BITSHIFT
-             const int pow2 = pow2_shifts[run];
-             const int numerator = numerators[run];
-#else
-             const int divider = 2 * radius + 1;
-#endif
-
-             const DATA8* restrict sl = (DATA8 *) src;
-             const DATA8* restrict sr = (DATA8 *) src;
-             const DATA8* restrict sre = (DATA8 *) (src + len);
-             const DATA8* restrict sle = (DATA8 *) (src + len - radius);
-             DATA8* restrict d = (DATA8 *) dst;
-             int acc[4] = {0};
-             int count = 0;
-
-             // Read-ahead
-             for (int x = left; x > 0; x--)
-               {
-                  for (int k = 0; k < 4; k++)
-                    acc[k] += sr[k];
-                  sr += sizeof(DATA32);
-                  count++;
-               }
-
-             // Left
-             for (int x = left; x > 0; x--)
-               {
-                  if (sr < sre)
-                    {
-                       for (int k = 0; k < 4; k++)
-                         acc[k] += sr[k];
-                       sr += sizeof(DATA32);
-                       count++;
-                    }
-
-                  d[ALPHA] = acc[ALPHA] / count;
-                  d[RED]   = acc[RED]   / count;
-                  d[GREEN] = acc[GREEN] / count;
-                  d[BLUE]  = acc[BLUE]  / count;
-                  d += sizeof(DATA32);
-               }
-
-             // Main part
-             for (; sr < sre; sr += sizeof(DATA32), sl += sizeof(DATA32))
-               {
-                  for (int k = 0; k < 4; k++)
-                    acc[k] += sr[k];
-
-                  d[ALPHA] = DIVIDE(acc[ALPHA]);
-                  d[RED]   = DIVIDE(acc[RED]);
-                  d[GREEN] = DIVIDE(acc[GREEN]);
-                  d[BLUE]  = DIVIDE(acc[BLUE]);
-                  d += sizeof(DATA32);
-
-                  for (int k = 0; k < 4; k++)
-                    acc[k] -= sl[k];
-               }
-
-             // Right part
-             count = 2 * radius + 1;
-             for (; sl < sle; sl += sizeof(DATA32))
-               {
-                  const int divider = --count;
-                  d[ALPHA] = acc[ALPHA] / divider;
-                  d[RED]   = acc[RED]   / divider;
-                  d[GREEN] = acc[GREEN] / divider;
-                  d[BLUE]  = acc[BLUE]  / divider;
-                  d += sizeof(DATA32);
-
-                  for (int k = 0; k < 4; k++)
-                    acc[k] -= sl[k];
-               }
+             span_func(src, dst, len, radii[run],
+                       pow2_shifts[run], numerators[run]);
 
              // More runs to go: swap spans
              if (radii[run + 1])
@@ -153,10 +173,11 @@ _box_blur_rgba_horiz_step(const uint32_t* restrict srcdata, int src_stride,
 }
 
 static inline void
-_box_blur_rgba_vert_step(const uint32_t* restrict srcdata, int src_stride,
-                         uint32_t* restrict dstdata, int dst_stride,
-                         const int* restrict const radii,
-                         Eina_Rectangle region)
+_box_blur_rgba_vert_step_do(const uint32_t* restrict srcdata, int src_stride,
+                            uint32_t* restrict dstdata, int dst_stride,
+                            const int* restrict const radii,
+                            Eina_Rectangle region,
+                            Box_Blur_Rgba_Span_Func span_func)
 {
    /* Note: This function tries to optimize cache hits by working on
     * contiguous horizontal spans.
@@ -170,16 +191,9 @@ _box_blur_rgba_vert_step(const uint32_t* restrict srcdata, int src_stride,
    DATA32* restrict span1;
    DATA32* restrict span2;
 
-#if DIV_USING_BITSHIFT
    int pow2_shifts[6] = {0};
    int numerators[6] = {0};
-   for (int run = 0; radii[run]; run++)
-     {
-        const int div = radii[run] * 2 + 1;
-        pow2_shifts[run] = evas_filter_smallest_pow2_larger_than(div << 10);
-        numerators[run] = (1 << pow2_shifts[run]) / (div);
-     }
-#endif
+   _box_blur_rgba_divider_init(radii, pow2_shifts, numerators);
 
    srcdata += region.x + src_stride * region.y;
    dstdata += region.x + dst_stride * region.y;
@@ -209,81 +223,8 @@ _box_blur_rgba_vert_step(const uint32_t* restrict srcdata, int src_stride,
         // Apply blur with current radius
         for (run = 0; radii[run]; run++)
           {
-             const int radius = radii[run];
-             const int left = MIN(radius, len);
-
-#if DIV_USING_BITSHIFT
-             const int pow2 = pow2_shifts[run];
-             const int numerator = numerators[run];
-#else
-             const int divider = 2 * radius + 1;
-#endif
-
-             const DATA8* restrict sl = (DATA8 *) src;
-             const DATA8* restrict sr = (DATA8 *) src;
-             const DATA8* restrict sre = (DATA8 *) (src + len);
-             const DATA8* restrict sle = (DATA8 *) (src + len - radius);
-             DATA8* restrict d = (DATA8 *) dst;
-             int acc[4] = {0};
-             int count = 0;
-
-             // Read-ahead
-             for (int x = left; x > 0; x--)
-               {
-                  for (int k = 0; k < 4; k++)
-                    acc[k] += sr[k];
-                  sr += sizeof(DATA32);
-                  count++;
-               }
-
-             // Left
-             for (int x = left; x > 0; x--)
-               {
-                  if (sr < sre)
-                    {
-                       for (int k = 0; k < 4; k++)
-                         acc[k] += sr[k];
-                       sr += sizeof(DATA32);
-                       count++;
-                    }
-
-                  d[ALPHA] = acc[ALPHA] / count;
-                  d[RED]   = acc[RED]   / count;
-                  d[GREEN] = acc[GREEN] / count;
-                  d[BLUE]  = acc[BLUE]  / count;
-                  d += sizeof(DATA32);
-               }
-
-             // Main part
-             for (; sr < sre; sr += sizeof(DATA32), sl += sizeof(DATA32))
-               {
-                  for (int k = 0; k < 4; k++)
-                    acc[k] += sr[k];
-
-                  d[ALPHA] = DIVIDE(acc[ALPHA]);
-                  d[RED]   = DIVIDE(acc[RED]);
-                  d[GREEN] = DIVIDE(acc[GREEN]);
-                  d[BLUE]  = DIVIDE(acc[BLUE]);
-                  d += sizeof(DATA32);
-
-                  for (int k = 0; k < 4; k++)
-                    acc[k] -= sl[k];
-               }
-
-             // Right part
-             count = 2 * radius + 1;
-             for (; sl < sle; sl += sizeof(DATA32))
-               {
-                  const int divider = --count;
-                  d[ALPHA] = acc[ALPHA] / divider;
-                  d[RED]   = acc[RED]   / divider;
-                  d[GREEN] = acc[GREEN] / divider;
-                  d[BLUE]  = acc[BLUE]  / divider;
-                  d += sizeof(DATA32);
-
-                  for (int k = 0; k < 4; k++)
-                    acc[k] -= sl[k];
-               }
+             span_func(src, dst, len, radii[run],
+                       pow2_shifts[run], numerators[run]);
 
              // More runs to go: swap spans
              if (radii[run + 1])
@@ -303,3 +244,23 @@ _box_blur_rgba_vert_step(const uint32_t* restrict srcdata, int src_stride,
           }
      }
 }
+
+static inline void
+_box_blur_rgba_horiz_step(const uint32_t* restrict srcdata, int src_stride,
+                          uint32_t* restrict dstdata, int dst_stride,
+                          const int* restrict const radii,
+                          Eina_Rectangle region)
+{
+   _box_blur_rgba_horiz_step_do(srcdata, src_stride, dstdata, dst_stride,
+                                radii, region, _box_blur_rgba_span);
+}
+
+static inline void
+_box_blur_rgba_vert_step(const uint32_t* restrict srcdata, int src_stride,
+                         uint32_t* restrict dstdata, int dst_stride,
+                         const int* restrict const radii,
+                         Eina_Rectangle region)
+{
+   _box_blur_rgba_vert_step_do(srcdata, src_stride, dstdata, dst_stride,
+                               radii, region, _box_blur_rgba_span);
+}
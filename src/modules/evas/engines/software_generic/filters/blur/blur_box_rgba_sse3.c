@@ -1,13 +1,99 @@
 #ifdef BUILD_SSE3
 
+#include <immintrin.h>
+
+static inline __m128i
+_box_blur_rgba_unpack_sse3(const DATA32 *p)
+{
+   const __m128i zero = _mm_setzero_si128();
+   __m128i v = _mm_cvtsi32_si128(*p);
+
+   v = _mm_unpacklo_epi8(v, zero);
+   return _mm_unpacklo_epi16(v, zero);
+}
+
+static inline void
+_box_blur_rgba_span_sse3(const DATA32* restrict src, DATA32* restrict dst,
+                         const int len, const int radius,
+                         const int pow2, const int numerator)
+{
+   const int left = MIN(radius, len);
+   const DATA32* restrict sl = src;
+   const DATA32* restrict sr = src;
+   const DATA32* restrict sre = src + len;
+   DATA32* restrict d = dst;
+   const __m128i num = _mm_set1_epi32(numerator);
+   const __m128i shift = _mm_cvtsi32_si128(pow2);
+   __m128i acc, q, even, odd;
+   int count;
+
+   // Only the main part is vectorized, the edges need a real division and
+   // (val * numerator) must fit in 32 bits to match the C version.
+   if (!DIV_USING_BITSHIFT || (pow2 >= 23) || (len <= 2 * left))
+     {
+        _box_blur_rgba_span(src, dst, len, radius, pow2, numerator);
+        return;
+     }
+
+   acc = _mm_setzero_si128();
+
+   // Read-ahead
+   for (int x = left; x > 0; x--)
+     acc = _mm_add_epi32(acc, _box_blur_rgba_unpack_sse3(sr++));
+
+   // Left
+   count = left;
+   for (int x = left; x > 0; x--)
+     {
+        const int div = ++count;
+        int v[4];
+
+        acc = _mm_add_epi32(acc, _box_blur_rgba_unpack_sse3(sr++));
+        _mm_storeu_si128((__m128i *) v, acc);
+        for (int k = 0; k < 4; k++)
+          ((DATA8 *) d)[k] = v[k] / div;
+        d++;
+     }
+
+   // Main part: 4 channels per pixel, divide by multiply & shift
+   for (; sr < sre; sr++, sl++)
+     {
+        acc = _mm_add_epi32(acc, _box_blur_rgba_unpack_sse3(sr));
+
+        even = _mm_srl_epi64(_mm_mul_epu32(acc, num), shift);
+        odd = _mm_srl_epi64(_mm_mul_epu32(_mm_srli_epi64(acc, 32), num), shift);
+        q = _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+        q = _mm_packs_epi32(q, q);
+        q = _mm_packus_epi16(q, q);
+        *d++ = _mm_cvtsi128_si32(q);
+
+        acc = _mm_sub_epi32(acc, _box_blur_rgba_unpack_sse3(sl));
+     }
+
+   // Right part
+   count = 2 * radius + 1;
+   for (; sl < sre - radius; sl++)
+     {
+        const int div = --count;
+        int v[4];
+
+        _mm_storeu_si128((__m128i *) v, acc);
+        for (int k = 0; k < 4; k++)
+          ((DATA8 *) d)[k] = v[k] / div;
+        d++;
+
+        acc = _mm_sub_epi32(acc, _box_blur_rgba_unpack_sse3(sl));
+     }
+}
+
 static inline void
 _box_blur_rgba_horiz_step_sse3(const uint32_t* restrict src, int src_stride,
                                uint32_t* restrict dst, int dst_stride,
                                const int* restrict const radii,
                                Eina_Rectangle region)
 {
-   // TODO: implement optimized code here and remove the following line:
-   _box_blur_rgba_horiz_step(src, src_stride, dst, dst_stride, radii, region);
+   _box_blur_rgba_horiz_step_do(src, src_stride, dst, dst_stride, radii,
+                                region, _box_blur_rgba_span_sse3);
 }
 
 static inline void
@@ -16,8 +102,8 @@ _box_blur_rgba_vert_step_sse3(const uint32_t* restrict src, int src_stride,
                               const int* restrict const radii,
                               Eina_Rectangle region)
 {
-   // TODO: implement optimized code here and remove the following line:
-   _box_blur_rgba_vert_step(src, src_stride, dst, dst_stride, radii, region);
+   _box_blur_rgba_vert_step_do(src, src_stride, dst, dst_stride, radii,
+                               region, _box_blur_rgba_span_sse3);
 }
 
 #endif
@@ -7,14 +7,14 @@
 /* Datatypes and MIN macro */
 #include "evas_filter_private.h"
 
-#if !defined (FUNCTION_NAME) || !defined (STEP)
-# error Must define FUNCTION_NAME and STEP
+#if !defined (FUNCTION_NAME) || !defined (STEP) || !defined (LOOPSTEP)
+# error Must define FUNCTION_NAME, STEP and LOOPSTEP
 #endif
 
 static inline void
 FUNCTION_NAME(const DATA8* restrict srcdata, DATA8* restrict dstdata,
               const int radius, const int len,
-              const int loops, const int loopstep,
+              const int loops, const int stride,
               const int* restrict weights, const int pow2_divider)
 {
    int i, j, k, acc, divider;
@@ -70,8 +70,8 @@ FUNCTION_NAME(const DATA8* restrict srcdata, DATA8* restrict dstdata,
              *dst = acc / divider;
           }
 
-        dstdata += loopstep;
-        srcdata += loopstep;
+        dstdata += LOOPSTEP;
+        srcdata += LOOPSTEP;
      }
 
    return;
@@ -82,3 +82,4 @@ error:
 
 #undef FUNCTION_NAME
 #undef STEP
+#undef LOOPSTEP
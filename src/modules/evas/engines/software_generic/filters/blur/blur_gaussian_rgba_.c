@@ -6,14 +6,14 @@
 
 #include "evas_filter_private.h"
 
-#if !defined (FUNCTION_NAME) || !defined (STEP)
-# error Must define FUNCTION_NAME and STEP
+#if !defined (FUNCTION_NAME) || !defined (STEP) || !defined (LOOPSTEP)
+# error Must define FUNCTION_NAME, STEP and LOOPSTEP
 #endif
 
 static inline void
 FUNCTION_NAME(const DATA32* restrict srcdata, DATA32* restrict dstdata,
               const int radius, const int len,
-              const int loops, const int loopstep,
+              const int loops, const int stride,
               const int* restrict weights, const int pow2_divider)
 {
    const int diameter = 2 * radius + 1;
@@ -89,8 +89,8 @@ FUNCTION_NAME(const DATA32* restrict srcdata, DATA32* restrict dstdata,
              B_VAL(dst) = acc[BLUE]  / divider;
           }
 
-        dstdata += loopstep;
-        srcdata += loopstep;
+        dstdata += LOOPSTEP;
+        srcdata += LOOPSTEP;
      }
 
    return;
@@ -101,3 +101,4 @@ error:
 
 #undef FUNCTION_NAME
 #undef STEP
+#undef LOOPSTEP
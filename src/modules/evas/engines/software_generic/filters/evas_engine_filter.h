@@ -14,4 +14,13 @@ Software_Filter_Func eng_filter_fill_func_get(Evas_Filter_Command *cmd);
 Software_Filter_Func eng_filter_mask_func_get(Evas_Filter_Command *cmd);
 Software_Filter_Func eng_filter_transform_func_get(Evas_Filter_Command *cmd);
 
+// Minimum number of pixels in a stripe worth running on another thread
+#define STRIPE_PIXELS_MIN 16384
+
+// Stripes run on the evas common worker pool
+typedef Evas_Common_Parallel_Func Software_Filter_Stripe_Func;
+void eng_filter_parallel_init(void);
+void eng_filter_parallel_shutdown(void);
+void eng_filter_parallel_run(Software_Filter_Stripe_Func func, void *data, int count, int min_size);
+
 #endif // EVAS_ENGINE_FILTER_H
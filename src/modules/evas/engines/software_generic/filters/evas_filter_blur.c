@@ -229,6 +229,49 @@ _rect(int x, int y, int w, int h, int maxw, int maxh)
 
 #define RECT(_x, _y, _w, _h) _rect(_x, _y, _w, _h, w, h)
 
+typedef struct _Box_Blur_Stripe
+{
+   void *src, *dst;
+   int src_stride, dst_stride;
+   int *radii;
+   Eina_Rectangle region;
+   Eina_Bool vert, rgba;
+} Box_Blur_Stripe;
+
+static void
+_box_blur_stripe(void *data, int start, int end)
+{
+   Box_Blur_Stripe *bs = data;
+   Eina_Rectangle r = bs->region;
+
+   // Horizontal passes are split by rows, vertical passes by columns
+   if (!bs->vert)
+     {
+        r.y += start;
+        r.h = end - start;
+     }
+   else
+     {
+        r.x += start;
+        r.w = end - start;
+     }
+
+   if (bs->rgba)
+     {
+        if (!bs->vert)
+          _box_blur_horiz_rgba(bs->src, bs->src_stride, bs->dst, bs->dst_stride, bs->radii, r);
+        else
+          _box_blur_vert_rgba(bs->src, bs->src_stride, bs->dst, bs->dst_stride, bs->radii, r);
+     }
+   else
+     {
+        if (!bs->vert)
+          _box_blur_horiz_alpha(bs->src, bs->src_stride, bs->dst, bs->dst_stride, bs->radii, r);
+        else
+          _box_blur_vert_alpha(bs->src, bs->src_stride, bs->dst, bs->dst_stride, bs->radii, r);
+     }
+}
+
 static Eina_Bool
 _box_blur_apply(Evas_Filter_Command *cmd, Eina_Bool vert, Eina_Bool rgba)
 {
@@ -279,21 +322,19 @@ _box_blur_apply(Evas_Filter_Command *cmd, Eina_Bool vert, Eina_Bool rgba)
    XDBG("Box blur on image %dx%d obscured by %d,%d %dx%d", w, h, o.x, o.y, o.w, o.h);
    for (int k = 0; k < regions; k++)
      {
+        Box_Blur_Stripe bs = {
+           src, dst,
+           rgba ? src_stride / 4 : src_stride,
+           rgba ? dst_stride / 4 : dst_stride,
+           radii, region[k], vert, rgba
+        };
+        int len = vert ? region[k].h : region[k].w;
+
         XDBG("Box blur in region %d,%d %dx%d", region[k].x, region[k].y, region[k].w, region[k].h);
-        if (rgba)
-          {
-             if (!vert)
-               _box_blur_horiz_rgba(src, src_stride / 4, dst, dst_stride / 4, radii, region[k]);
-             else
-               _box_blur_vert_rgba(src, src_stride / 4, dst, dst_stride / 4, radii, region[k]);
-          }
-        else
-          {
-             if (!vert)
-               _box_blur_horiz_alpha(src, src_stride, dst, dst_stride, radii, region[k]);
-             else
-               _box_blur_vert_alpha(src, src_stride, dst, dst_stride, radii, region[k]);
-          }
+        if (!len) continue;
+        eng_filter_parallel_run(_box_blur_stripe, &bs,
+                                vert ? region[k].w : region[k].h,
+                                STRIPE_PIXELS_MIN / len + 1);
      }
 
    ret = EINA_TRUE;
@@ -370,21 +411,63 @@ _sin_blur_weights_get(int *weights, int *pow2_divider, int radius)
 
 #define FUNCTION_NAME _gaussian_blur_horiz_alpha_step
 #define STEP 1
+#define LOOPSTEP stride
 #include "./blur/blur_gaussian_alpha_.c"
 
-// Step size is w (row by row), loops = w, so STEP = 'loops'
+// Step size is the stride (row by row), next loop is the next column
 #define FUNCTION_NAME _gaussian_blur_vert_alpha_step
-#define STEP loops
+#define STEP stride
+#define LOOPSTEP 1
 #include "./blur/blur_gaussian_alpha_.c"
 
 #define FUNCTION_NAME _gaussian_blur_horiz_rgba_step
 #define STEP 1
+#define LOOPSTEP stride
 #include "./blur/blur_gaussian_rgba_.c"
 
 #define FUNCTION_NAME _gaussian_blur_vert_rgba_step
-#define STEP loops
+#define STEP stride
+#define LOOPSTEP 1
 #include "./blur/blur_gaussian_rgba_.c"
 
+typedef struct _Gaussian_Blur_Stripe
+{
+   void *src, *dst;
+   int radius, w, h;
+   int *weights;
+   int pow2_div;
+   Eina_Bool vert, rgba;
+} Gaussian_Blur_Stripe;
+
+static void
+_gaussian_blur_stripe(void *data, int start, int end)
+{
+   Gaussian_Blur_Stripe *gs = data;
+   // Offset of the first row (horizontal) or column (vertical) in pixels
+   const int offset = gs->vert ? start : start * gs->w;
+
+   if (gs->rgba)
+     {
+        DATA32 *src = (DATA32 *) gs->src + offset;
+        DATA32 *dst = (DATA32 *) gs->dst + offset;
+
+        if (!gs->vert)
+          _gaussian_blur_horiz_rgba_step(src, dst, gs->radius, gs->w, end - start, gs->w, gs->weights, gs->pow2_div);
+        else
+          _gaussian_blur_vert_rgba_step(src, dst, gs->radius, gs->h, end - start, gs->w, gs->weights, gs->pow2_div);
+     }
+   else
+     {
+        DATA8 *src = (DATA8 *) gs->src + offset;
+        DATA8 *dst = (DATA8 *) gs->dst + offset;
+
+        if (!gs->vert)
+          _gaussian_blur_horiz_alpha_step(src, dst, gs->radius, gs->w, end - start, gs->w, gs->weights, gs->pow2_div);
+        else
+          _gaussian_blur_vert_alpha_step(src, dst, gs->radius, gs->h, end - start, gs->w, gs->weights, gs->pow2_div);
+     }
+}
+
 static Eina_Bool
 _gaussian_blur_apply(Evas_Filter_Command *cmd, Eina_Bool vert, Eina_Bool rgba)
 {
@@ -405,21 +488,15 @@ _gaussian_blur_apply(Evas_Filter_Command *cmd, Eina_Bool vert, Eina_Bool rgba)
 
    if (src && dst)
      {
+        Gaussian_Blur_Stripe gs = {
+           src, dst, radius, w, h, weights, pow2_div, vert, rgba
+        };
+        const int len = vert ? h : w;
+
         DEBUG_TIME_BEGIN();
-        if (rgba)
-          {
-             if (!vert)
-               _gaussian_blur_horiz_rgba_step(src, dst, radius, w, h, w, weights, pow2_div);
-             else
-               _gaussian_blur_vert_rgba_step(src, dst, radius, h, w, 1, weights, pow2_div);
-          }
-        else
-          {
-             if (!vert)
-               _gaussian_blur_horiz_alpha_step(src, dst, radius, w, h, w, weights, pow2_div);
-             else
-               _gaussian_blur_vert_alpha_step(src, dst, radius, h, w, 1, weights, pow2_div);
-          }
+        if (len > 0)
+          eng_filter_parallel_run(_gaussian_blur_stripe, &gs, vert ? w : h,
+                                  STRIPE_PIXELS_MIN / (len * (2 * radius + 1)) + 1);
         DEBUG_TIME_END();
      }
    else ret = EINA_FALSE;
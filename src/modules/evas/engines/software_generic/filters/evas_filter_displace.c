@@ -1,10 +1,18 @@
 #include "evas_engine_filter.h"
 
+typedef struct _Displace_Stripe
+{
+   int w, h, map_w, map_h, intensity;
+   void *src, *dst;
+   uint32_t *map_start;
+   Eina_Bool stretch, smooth, blend;
+} Displace_Stripe;
+
 static void
 _filter_displace_cpu_alpha_do(int w, int h, int map_w, int map_h, int intensity,
                               uint8_t *src, uint8_t *dst, uint32_t *map_start,
                               Eina_Bool stretch, Eina_Bool smooth,
-                              Eina_Bool blend)
+                              Eina_Bool blend, int y_start, int y_end)
 {
    int x, y, map_x, map_y;
    const int dx = RED;
@@ -13,7 +21,9 @@ _filter_displace_cpu_alpha_do(int w, int h, int map_w, int map_h, int intensity,
 
    // FIXME: Add stride support
 
-   for (y = 0, map_y = 0; y < h; y++, map_y++)
+   src += y_start * w;
+   dst += y_start * w;
+   for (y = y_start, map_y = map_h ? y_start % map_h : 0; y < y_end; y++, map_y++)
      {
         if (map_y >= map_h) map_y = 0;
         map = (uint8_t *) (map_start + map_y * map_w);
@@ -75,19 +85,30 @@ _filter_displace_cpu_alpha_do(int w, int h, int map_w, int map_h, int intensity,
      }
 }
 
+static void
+_filter_displace_cpu_alpha_stripe(void *data, int start, int end)
+{
+   Displace_Stripe *ds = data;
+
+   _filter_displace_cpu_alpha_do(ds->w, ds->h, ds->map_w, ds->map_h,
+                                 ds->intensity, ds->src, ds->dst, ds->map_start,
+                                 ds->stretch, ds->smooth, ds->blend, start, end);
+}
+
 static void
 _filter_displace_cpu_rgba_do(int w, int h, int map_w, int map_h, int intensity,
                              uint32_t *src, uint32_t *dst, uint32_t *map_start,
                              Eina_Bool stretch, Eina_Bool smooth,
-                             Eina_Bool blend)
+                             Eina_Bool blend, int y_start, int y_end)
 {
    int x, y, map_x, map_y;
    const int dx = RED;
    const int dy = GREEN;
-   Eina_Bool unpremul = EINA_FALSE;
    uint8_t *map;
 
-   for (y = 0, map_y = 0; y < h; y++, map_y++)
+   src += y_start * w;
+   dst += y_start * w;
+   for (y = y_start, map_y = map_h ? y_start % map_h : 0; y < y_end; y++, map_y++)
      {
         if (map_y >= map_h) map_y = 0;
         map = (uint8_t *) (map_start + map_y * map_w);
@@ -107,11 +128,6 @@ _filter_displace_cpu_rgba_do(int w, int h, int map_w, int map_h, int intensity,
                }
 
              if (!map[ALPHA]) continue;
-             if (!unpremul && map[ALPHA] != 0xFF)
-               {
-                  unpremul = EINA_TRUE;
-                  evas_data_argb_unpremul(map_start, map_w * map_h);
-               }
 
              // x
              val = ((int) map[dx] - 128) * intensity;
@@ -180,9 +196,42 @@ _filter_displace_cpu_rgba_do(int w, int h, int map_w, int map_h, int intensity,
                *dst = col;
           }
      }
+}
 
-   if (unpremul)
-     evas_data_argb_premul(map_start, map_w * map_h);
+static void
+_filter_displace_cpu_rgba_stripe(void *data, int start, int end)
+{
+   Displace_Stripe *ds = data;
+
+   _filter_displace_cpu_rgba_do(ds->w, ds->h, ds->map_w, ds->map_h,
+                                ds->intensity, ds->src, ds->dst, ds->map_start,
+                                ds->stretch, ds->smooth, ds->blend, start, end);
+}
+
+/* The map is unpremultiplied before being used, but only if a translucent
+ * pixel is actually read from it. This is checked once before splitting the
+ * work in stripes, as the map is shared by all of them.
+ */
+static Eina_Bool
+_filter_displace_map_is_translucent(const uint32_t *map_start, int map_w, int map_h,
+                                    int w, int h)
+{
+   const int mw = MIN(w, map_w);
+   const int mh = MIN(h, map_h);
+   int x, y;
+
+   for (y = 0; y < mh; y++)
+     {
+        const uint32_t *map = map_start + y * map_w;
+
+        for (x = 0; x < mw; x++)
+          {
+             const int a = ALPHA_OF(map[x]);
+             if (a && (a != 0xFF)) return EINA_TRUE;
+          }
+     }
+
+   return EINA_FALSE;
 }
 
 /**
@@ -200,6 +249,7 @@ _filter_displace_cpu_alpha(Evas_Filter_Command *cmd)
    uint32_t *map_start;
    Eina_Bool stretch, smooth, blend;
    Evas_Filter_Buffer *map_fb;
+   Displace_Stripe ds;
    Eina_Bool ret = EINA_FALSE;
 
    w = cmd->input->w;
@@ -236,8 +286,11 @@ _filter_displace_cpu_alpha(Evas_Filter_Command *cmd)
    map_start = (uint32_t *) _buffer_map_all(map_fb->buffer, &map_len, E_READ, E_ARGB, &map_stride);
    EINA_SAFETY_ON_FALSE_GOTO(src && dst && map_start, end);
 
-   _filter_displace_cpu_alpha_do(w, h, map_w, map_h, intensity,
-                                 src, dst, map_start, stretch, smooth, blend);
+   ds = (Displace_Stripe) {
+      w, h, map_w, map_h, intensity, src, dst, map_start, stretch, smooth, blend
+   };
+   eng_filter_parallel_run(_filter_displace_cpu_alpha_stripe, &ds, h,
+                           STRIPE_PIXELS_MIN / MAX(w, 1) + 1);
 
    ret = EINA_TRUE;
 end:
@@ -259,8 +312,9 @@ _filter_displace_cpu_rgba(Evas_Filter_Command *cmd)
    unsigned int src_len, src_stride, map_len, map_stride, dst_len, dst_stride;
    int w, h, map_w, map_h, intensity;
    uint32_t *dst, *src, *map_start;
-   Eina_Bool stretch, smooth, blend;
+   Eina_Bool stretch, smooth, blend, unpremul;
    Evas_Filter_Buffer *map_fb;
+   Displace_Stripe ds;
    Eina_Bool ret = EINA_FALSE;
 
    w = cmd->input->w;
@@ -297,8 +351,18 @@ _filter_displace_cpu_rgba(Evas_Filter_Command *cmd)
    map_start = _buffer_map_all(map_fb->buffer, &map_len, E_READ, E_ARGB, &map_stride);
    EINA_SAFETY_ON_FALSE_GOTO(src && dst && map_start, end);
 
-   _filter_displace_cpu_rgba_do(w, h, map_w, map_h, intensity,
-                                src, dst, map_start, stretch, smooth, blend);
+   unpremul = _filter_displace_map_is_translucent(map_start, map_w, map_h, w, h);
+   if (unpremul)
+     evas_data_argb_unpremul(map_start, map_w * map_h);
+
+   ds = (Displace_Stripe) {
+      w, h, map_w, map_h, intensity, src, dst, map_start, stretch, smooth, blend
+   };
+   eng_filter_parallel_run(_filter_displace_cpu_rgba_stripe, &ds, h,
+                           STRIPE_PIXELS_MIN / MAX(w, 1) + 1);
+
+   if (unpremul)
+     evas_data_argb_premul(map_start, map_w * map_h);
 
    ret = EINA_TRUE;
 end:
@@ -0,0 +1,40 @@
+#include "evas_engine_filter.h"
+
+/* Splits the work of a filter command into stripes (rows or columns) that
+ * run on the evas common worker pool, shared with the banded downscales and
+ * the colorspace conversion. EVAS_COMMON_THREADS sets the size of the pool;
+ * EVAS_FILTER_THREADS=1 (or 0) still keeps the filters on the calling
+ * thread, other values are left to the pool.
+ */
+
+static Eina_Bool _parallel_serial = EINA_FALSE;
+
+void
+eng_filter_parallel_run(Software_Filter_Stripe_Func func, void *data,
+                        int count, int min_size)
+{
+   if (count <= 0) return;
+
+   if (_parallel_serial)
+     {
+        func(data, 0, count);
+        return;
+     }
+
+   evas_common_parallel_run(func, data, count, min_size);
+}
+
+void
+eng_filter_parallel_init(void)
+{
+   const char *s;
+
+   s = getenv("EVAS_FILTER_THREADS");
+   _parallel_serial = s && (atoi(s) < 2);
+}
+
+void
+eng_filter_parallel_shutdown(void)
+{
+   _parallel_serial = EINA_FALSE;
+}
@@ -31,6 +31,7 @@ struct _Loader_Info
 struct _Frame_Info
 {
    int x, y, w, h;
+   int pos; // file offset of the image record, to seek to it
    unsigned short delay; // delay time in 1/100ths of a sec
    short transparent : 10; // -1 == not, anything else == index 
    short dispose : 6; // 0, 1, 2, 3 (others invalid)
@@ -48,19 +49,29 @@ do { \
 
 // utility funcs...
 
-// brute force find frame index - gifs are normally saml so ok for now
-static Image_Entry_Frame *
-_find_frame(Evas_Image_Animated *animated, int index)
+// find where to start decoding to get frame index: right after the closest
+// decoded frame before it (and the one before that if it restores to it)
+// or at the first frame. frames are indexed by evas once the header is read
+static int
+_find_decode_start(Evas_Image_Animated *animated, int index)
 {
-   Eina_List *l;
-   Image_Entry_Frame *frame;
+   Image_Entry_Frame *frame, *prevframe;
+   Frame_Info *finfo;
+   int i;
 
-   if (!animated->frames) return NULL;
-   EINA_LIST_FOREACH(animated->frames, l, frame)
+   for (i = index - 1; i > 0; i--)
      {
-        if (frame->index == index) return frame;
+        frame = evas_common_load_animated_frame_get(animated, i);
+        if ((!frame) || (!frame->data)) continue;
+        finfo = frame->info;
+        if (finfo->dispose == 3) // GIF_DISPOSE_RESTORE
+          {
+             prevframe = evas_common_load_animated_frame_get(animated, i - 1);
+             if ((!prevframe) || (!prevframe->data)) continue;
+          }
+        return i + 1;
      }
-   return NULL;
+   return 1;
 }
 
 // fill in am image with a specific rgba color value
@@ -148,8 +159,9 @@ _fill_frame(DATA32 *data, int rowpix, GifFileType *gif, Frame_Info *finfo,
 
 // store common fields from gif file info into frame info
 static void
-_store_frame_info(GifFileType *gif, Frame_Info *finfo)
+_store_frame_info(GifFileType *gif, Frame_Info *finfo, int pos)
 {
+   finfo->pos = pos;
    finfo->x = gif->Image.Left;
    finfo->y = gif->Image.Top;
    finfo->w = gif->Image.Width;
@@ -331,60 +343,6 @@ on_error:
    return ret;
 }
 
-// flush out older rgba frame images to save memory but skip current frame
-// and previous frame (prev needed for dispose mode 3)
-static void
-_flush_older_frames(Evas_Image_Animated *animated,
-                    int w, int h,
-                    Image_Entry_Frame *thisframe,
-                    Image_Entry_Frame *prevframe)
-{
-   Eina_List *l;
-   Image_Entry_Frame *frame;
-   // target is the amount of memory we want to be under for stored frames
-   int total = 0, target = 512 * 1024;
-
-   // total up the amount of memory used by stored frames for this image
-   EINA_LIST_FOREACH(animated->frames, l, frame)
-     {
-        if (frame->data) total++;
-     }
-   total *= (w * h * sizeof(DATA32));
-   // if we use less than target (512k) for frames - dont flush
-   if (total < target) return;
-   // clean oldest frames first and go until below target or until we loop
-   // around back to this frame (curent)
-   EINA_LIST_FOREACH(animated->frames, l, frame)
-     {
-        if (frame == thisframe) break;
-     }
-   if (!l) return;
-   // start on next frame after thisframe
-   l = l->next;
-   // handle wrap to start
-   if (!l) l = animated->frames;
-   // now walk until we hit thisframe again... then stop walk.
-   while (l)
-     {
-        frame = l->data;
-        if (frame == thisframe) break;
-        if (frame->data)
-          {
-             if ((frame != thisframe) && (frame != prevframe))
-               {
-                  free(frame->data);
-                  frame->data = NULL;
-                  // subtract memory used and if below target - stop flush
-                  total -= (w * h * sizeof(DATA32));
-                  if (total < target) break;
-               }
-          }
-        // go to next - handle wrap to start
-        l = l->next;
-        if (!l) l = animated->frames;
-     }
-}
-                    
 static int
 _file_read(GifFileType *gft, GifByteType *buf, int len)
 {
@@ -413,6 +371,7 @@ evas_image_load_file_head_gif2(void *loader_data,
    // in that case we should play gif file until meet error frame.
    int imgnum = 0;
    int loop_count = -1;
+   int pos;
    Frame_Info *finfo = NULL;
    Eina_Bool full = EINA_TRUE;
 
@@ -448,6 +407,7 @@ evas_image_load_file_head_gif2(void *loader_data,
    // walk through gif records in file to figure out info
    do
      {
+        pos = fi.pos;
         if (DGifGetRecordType(gif, &rec) == GIF_ERROR)
           {
              // if we have a gif that ends part way through a sequence
@@ -476,7 +436,7 @@ evas_image_load_file_head_gif2(void *loader_data,
              // store geometry in the last frame info data
              if (finfo)
                {
-                  _store_frame_info(gif, finfo);
+                  _store_frame_info(gif, finfo, pos);
                   _check_transparency(&full, finfo, prop->w, prop->h);
                }
              // or if we dont have a finfo entry - create one even for stills
@@ -487,7 +447,7 @@ evas_image_load_file_head_gif2(void *loader_data,
                   if (!finfo)
                     LOADERR(EVAS_LOAD_ERROR_RESOURCE_ALLOCATION_FAILED);
                   // store geometry info from gif image
-                  _store_frame_info(gif, finfo);
+                  _store_frame_info(gif, finfo, pos);
                   // check for transparency/alpha
                   _check_transparency(&full, finfo, prop->w, prop->h);
                }
@@ -580,7 +540,7 @@ evas_image_load_file_data_gif2(void *loader_data,
    GifRecordType rec;
    GifFileType *gif = NULL;
    Image_Entry_Frame *frame;
-   int index = 0, imgnum = 0;
+   int index = 0, imgnum = 0, start = 1;
    Frame_Info *finfo;
 
    // XXX: this is so wrong - storing current frame IN the image
@@ -588,14 +548,15 @@ evas_image_load_file_data_gif2(void *loader_data,
    // same image is shared/loaded in 2 ore more places AND animated
    // there?
    
-   // use index stored in image (XXX: yuk!)
-   index = animated->cur_frame;
+   // use index stored in image (XXX: yuk!), or the one evas wants decoded
+   // ahead of playback - then there are no pixels to fill
+   index = evas_common_load_animated_frame_wanted(animated);
    // if index is invalid for animated image - error out
    if ((animated->animated) &&
        ((index <= 0) || (index > animated->frame_count)))
      LOADERR(EVAS_LOAD_ERROR_GENERIC);
    // find the given frame index
-   frame = _find_frame(animated, index);
+   frame = evas_common_load_animated_frame_get(animated, index);
    if (frame)
      {
         if ((frame->loaded) && (frame->data))
@@ -606,6 +567,8 @@ evas_image_load_file_data_gif2(void *loader_data,
      }
    else
      LOADERR(EVAS_LOAD_ERROR_CORRUPT_FILE);
+   // every frame from start up to index gets decoded on the way
+   if (animated->animated) start = _find_decode_start(animated, index);
 
 open_file:
    // actually ask libgif to open the file
@@ -636,9 +599,9 @@ open_file:
         loader->imgnum = 1;
      }
 
-   // if we want to go backwards, we likely need/want to re-decode from the
-   // start as we have nothnig to build on
-   if ((index > 0) && (index < loader->imgnum) && (animated->animated))
+   // if we want to go backwards, we need a fresh libgif state to
+   // re-decode from, then jump to the start frame below
+   if ((start < loader->imgnum) && (animated->animated))
      {
 #if (GIFLIB_MAJOR > 5) || ((GIFLIB_MAJOR == 5) && (GIFLIB_MINOR >= 1))
         if (loader->gif) DGifCloseFile(loader->gif, NULL);
@@ -653,6 +616,21 @@ open_file:
         goto open_file;
      }
 
+   // skip over frames we still have decoded by seeking to the image record
+   // of the start frame - records are read straight from the file map
+   if ((start > loader->imgnum) && (animated->animated))
+     {
+        Image_Entry_Frame *startframe;
+
+        startframe = evas_common_load_animated_frame_get(animated, start);
+        finfo = startframe ? startframe->info : NULL;
+        if ((finfo) && (finfo->pos > 0))
+          {
+             loader->fi.pos = finfo->pos;
+             loader->imgnum = start;
+          }
+     }
+
    // our current position is the previous frame we decoded from the file
    imgnum = loader->imgnum;
 
@@ -687,25 +665,24 @@ open_file:
              if (DGifGetImageDesc(gif) == GIF_ERROR)
                LOADERR(EVAS_LOAD_ERROR_UNKNOWN_FORMAT);
              // get the previous frame entry AND the current one to fill in
-             prevframe = _find_frame(animated, imgnum - 1);
-             thisframe = _find_frame(animated, imgnum);
+             prevframe = evas_common_load_animated_frame_get(animated, imgnum - 1);
+             thisframe = evas_common_load_animated_frame_get(animated, imgnum);
              // if we have a frame AND we're animated AND we have no data...
              if ((thisframe) && (!thisframe->data) && (animated->animated))
                {
                   Eina_Bool first = EINA_FALSE;
+                  DATA32 *data;
 
                   // allocate it
-                  thisframe->data =
-                    malloc(prop->w * prop->h * sizeof(DATA32));
-                  if (!thisframe->data)
+                  data = malloc(prop->w * prop->h * sizeof(DATA32));
+                  if (!data)
                     LOADERR(EVAS_LOAD_ERROR_RESOURCE_ALLOCATION_FAILED);
                   // if we have no prior frame OR prior frame data... empty
                   if ((!prevframe) || (!prevframe->data))
                     {
                        first = EINA_TRUE;
                        finfo = thisframe->info;
-                       memset(thisframe->data, 0,
-                              prop->w * prop->h * sizeof(DATA32));
+                       memset(data, 0, prop->w * prop->h * sizeof(DATA32));
                     }
                   // we have a prior frame to copy data from...
                   else
@@ -718,11 +695,11 @@ open_file:
                                     &x, &y, &w, &h);
                        // if dispose mode is not restore - then copy pre frame
                        if (finfo->dispose != 3) // GIF_DISPOSE_RESTORE
-                         memcpy(thisframe->data, prevframe->data,
+                         memcpy(data, prevframe->data,
                               prop->w * prop->h * sizeof(DATA32));
                        // if dispose mode is "background" then fill with bg
                        if (finfo->dispose == 2) // GIF_DISPOSE_BACKGND
-                         _fill_frame(thisframe->data, prop->w, gif,
+                         _fill_frame(data, prop->w, gif,
                                      finfo, x, y, w, h);
                        else if (finfo->dispose == 3) // GIF_DISPOSE_RESTORE
                          {
@@ -733,9 +710,9 @@ open_file:
                             // (copy the whole image - at least the sample
                             // GifWin.cpp from libgif indicates this is what
                             // needs doing
-                            prevframe2 = _find_frame(animated, imgnum - 2);
-                            if (prevframe2)
-                              memcpy(thisframe->data, prevframe2->data,
+                            prevframe2 = evas_common_load_animated_frame_get(animated, imgnum - 2);
+                            if ((prevframe2) && (prevframe2->data))
+                              memcpy(data, prevframe2->data,
                                      prop->w * prop->h * sizeof(DATA32));
                          }
                        finfo = thisframe->info;
@@ -744,16 +721,21 @@ open_file:
                   _clip_coords(prop->w, prop->h, &xin, &yin,
                                finfo->x, finfo->y, finfo->w, finfo->h,
                                &x, &y, &w, &h);
-                  if (!_decode_image(gif, thisframe->data, prop->w,
+                  if (!_decode_image(gif, data, prop->w,
                                      xin, yin, finfo->transparent,
                                      finfo->w, finfo->h,
                                      x, y, w, h, first))
-                    LOADERR(EVAS_LOAD_ERROR_CORRUPT_FILE);
+                    {
+                       free(data);
+                       LOADERR(EVAS_LOAD_ERROR_CORRUPT_FILE);
+                    }
                   // mark as loaded and done
                   thisframe->loaded = EINA_TRUE;
-                  // and flush old memory if needed (too much)
-                  _flush_older_frames(animated, prop->w, prop->h,
-                                      thisframe, prevframe);
+                  // hand it to the frame lru, which flushes older frames if
+                  // needed (too much) but keeps the previous one we build on
+                  evas_common_load_animated_frame_data_set
+                    (animated, thisframe, data,
+                     prop->w * prop->h * sizeof(DATA32), prevframe);
                }
              // if we hve a frame BUT the image is not animated... different
              // path
@@ -823,8 +805,11 @@ on_ok:
    
    // if it was an animated image we need to copy the data to the
    // pixels for the image from the frame holding the data
-   if (animated->animated && frame->data)
-     memcpy(pixels, frame->data, prop->w * prop->h * sizeof(DATA32));
+   if (animated->animated && frame->data && pixels)
+     {
+        memcpy(pixels, frame->data, prop->w * prop->h * sizeof(DATA32));
+        evas_common_load_animated_frame_used(animated, frame);
+     }
    prop->premul = EINA_TRUE;
    
 on_error: // jump here on any errors to clean up
@@ -854,7 +839,7 @@ evas_image_load_frame_duration_gif2(void *loader_data,
         Frame_Info *finfo;
         
         // find the frame
-        frame = _find_frame(animated, i);
+        frame = evas_common_load_animated_frame_get(animated, i);
         // no frame? barf - bad file or i/o?
         if (!frame) return -1.0;
         // get delay and total it up
@@ -164,31 +164,245 @@ on_error:
    return 0;
 }
 
+typedef struct _Tgv_Encode Tgv_Encode;
+struct _Tgv_Encode
+{
+   rg_etc1_pack_params param;
+   Evas_Colorspace cspace;
+   uint32_t *data;
+   uint8_t *blocks; // raw ETC data, one macro block after the other
+   uint8_t **comp; // LZ4 data of each macro block
+   int *comp_len;
+   int image_stride, image_height;
+   int macro_block_width, macro_block_height;
+   int macro_block_cols, macro_block_rows;
+   int macro_block_size, etc_block_size;
+   Eina_Bool compress;
+   Eina_Bool error;
+#ifdef DEBUG_STATS
+   Eina_Bool alpha;
+   int plane;
+   long long mse, mse_div, mse_alpha, pixels_count;
+   double mean_x, mean_y, var_x, var_y, cov_xy;
+#endif
+};
+
+static Eina_Bool
+_tgv_macro_block_encode(Tgv_Encode *enc, int x, int y, uint8_t *offset)
+{
+   uint32_t *data = enc->data;
+   uint32_t *input, *last_col, *last_row, *last_pix;
+   int image_stride = enc->image_stride;
+   int image_height = enc->image_height;
+   int macro_block_width = enc->macro_block_width;
+   int macro_block_height = enc->macro_block_height;
+   int real_x = x, real_y;
+
+   if (y == 0) real_y = 0;
+   else if (y < image_height + 1) real_y = y - 1;
+   else real_y = image_height - 1;
+
+   if (x == 0) real_x = 0;
+   else if (x < image_stride + 1) real_x = x - 1;
+   else real_x = image_stride - 1;
+
+   input = data + real_y * image_stride + real_x;
+   last_row = data + image_stride * (image_height - 1) + real_x;
+   last_col = data + (real_y + 1) * image_stride - 1;
+   last_pix = data + image_height * image_stride - 1;
+
+   for (int by = 0; by < macro_block_height; by += 4)
+     {
+        int dup_top = ((y + by) == 0) ? 1 : 0;
+        int max_row = MAX(0, MIN(4, image_height - real_y - by));
+        int oy = (y == 0) ? 1 : 0;
+
+        for (int bx = 0; bx < macro_block_width; bx += 4)
+          {
+             int dup_left = ((x + bx) == 0) ? 1 : 0;
+             int max_col = MAX(0, MIN(4, image_stride - real_x - bx));
+             uint32_t todo[16] = { 0 };
+             int row, col;
+             int ox = (x == 0) ? 1 : 0;
+
+             if (dup_left)
+               {
+                  // Duplicate left column
+                  for (row = 0; row < max_row; row++)
+                    todo[row * 4] = input[row * image_stride];
+                  for (row = max_row; row < 4; row++)
+                    todo[row * 4] = last_row[0];
+               }
+
+             if (dup_top)
+               {
+                  // Duplicate top row
+                  for (col = 0; col < max_col; col++)
+                    todo[col] = input[MAX(col + bx - ox, 0)];
+                  for (col = max_col; col < 4; col++)
+                    todo[col] = last_col[0];
+               }
+
+             for (row = dup_top; row < 4; row++)
+               {
+                  for (col = dup_left; col < max_col; col++)
+                    {
+                       if (row < max_row)
+                         {
+                            // Normal copy
+                            todo[row * 4 + col] = input[(row + by - oy) * image_stride + bx + col - ox];
+                         }
+                       else
+                         {
+                            // Copy last line
+                            todo[row * 4 + col] = last_row[col + bx - ox];
+                         }
+                    }
+                  for (col = max_col; col < 4; col++)
+                    {
+                       // Right edge
+                       if (row < max_row)
+                         {
+                            // Duplicate last column
+                            todo[row * 4 + col] = last_col[MAX(row + by - oy, 0) * image_stride];
+                         }
+                       else
+                         {
+                            // Duplicate very last pixel again and again
+                            todo[row * 4 + col] = *last_pix;
+                         }
+                    }
+               }
+
+             switch (enc->cspace)
+               {
+                case EVAS_COLORSPACE_ETC1:
+                case EVAS_COLORSPACE_ETC1_ALPHA:
+                  rg_etc1_pack_block(offset, (uint32_t *) todo, &enc->param);
+                  break;
+                case EVAS_COLORSPACE_RGB8_ETC2:
+                  etc2_rgb8_block_pack(offset, (uint32_t *) todo, &enc->param);
+                  break;
+                case EVAS_COLORSPACE_RGBA8_ETC2_EAC:
+                  etc2_rgba8_block_pack(offset, (uint32_t *) todo, &enc->param);
+                  break;
+                default: return EINA_FALSE;
+               }
+
+#ifdef DEBUG_STATS
+             if (enc->plane == 0)
+               {
+                  // Decode to compute PSNR, this is slow.
+                  uint32_t done[16];
+
+                  if (enc->alpha)
+                    rg_etc2_rgba8_decode_block(offset, done);
+                  else
+                     rg_etc2_rgb8_decode_block(offset, done);
+
+                  for (int k = 0; k < 16; k++)
+                    {
+                       const int r = (R_VAL(&(todo[k])) - R_VAL(&(done[k])));
+                       const int g = (G_VAL(&(todo[k])) - G_VAL(&(done[k])));
+                       const int b = (B_VAL(&(todo[k])) - B_VAL(&(done[k])));
+                       const int a = (A_VAL(&(todo[k])) - A_VAL(&(done[k])));
+                       enc->mse += r*r + g*g + b*b;
+
+                       /*refer http://planetmath.org/onepassalgorithmtocomputesamplevariance*/
+                       const double delta_x = (double)todo[k] - enc->mean_x;
+                       const double delta_y = (double)done[k] - enc->mean_y;
+                       enc->mean_x = enc->mean_x + (double)(delta_x / (enc->pixels_count + 1));
+                       enc->mean_y = enc->mean_y + (double)(delta_y / (enc->pixels_count + 1));
+                       enc->var_x = enc->var_x + ((double)(todo[k] - enc->mean_x) * delta_x);
+                       enc->var_y = enc->var_y + ((double)(done[k] - enc->mean_y) * delta_y);
+                       enc->cov_xy = enc->cov_xy + ((double)(todo[k] - enc->mean_x) * (double)(done[k] - enc->mean_y));
+                       enc->pixels_count++;
+
+                       if (enc->alpha) enc->mse_alpha += a*a;
+                       enc->mse_div++;
+                    }
+               }
+#endif
+
+             offset += enc->etc_block_size;
+          }
+     }
+
+   return EINA_TRUE;
+}
+
+static void
+_tgv_stripe_encode(void *data, unsigned int stripe)
+{
+   Tgv_Encode *enc = data;
+   int y = stripe * enc->macro_block_height;
+
+   for (int col = 0; col < enc->macro_block_cols; col++)
+     {
+        int idx = stripe * enc->macro_block_cols + col;
+        uint8_t *offset = enc->blocks + (size_t)idx * enc->macro_block_size;
+
+        if (!_tgv_macro_block_encode(enc, col * enc->macro_block_width, y, offset))
+          {
+             enc->error = EINA_TRUE;
+             return;
+          }
+        if (enc->compress)
+          {
+             int bound = LZ4_compressBound(enc->macro_block_size);
+
+             enc->comp[idx] = malloc(bound);
+             if (!enc->comp[idx])
+               {
+                  enc->error = EINA_TRUE;
+                  return;
+               }
+             enc->comp_len[idx] = LZ4_compress_HC
+               ((char *)offset, (char *)enc->comp[idx],
+                enc->macro_block_size, bound, 16);
+          }
+     }
+}
+
+static void
+_tgv_encode_free(Tgv_Encode *enc, int macro_block_num)
+{
+   if (enc->comp)
+     {
+        for (int idx = 0; idx < macro_block_num; idx++)
+          free(enc->comp[idx]);
+     }
+   free(enc->comp);
+   free(enc->comp_len);
+   free(enc->blocks);
+}
+
 static int
 evas_image_save_file_tgv(RGBA_Image *im,
                          const char *file, const char *key EINA_UNUSED,
                          int quality, int compress, const char *encoding)
 {
    rg_etc1_pack_params param;
+   Tgv_Encode enc;
    FILE *f;
-   uint8_t *comp = NULL;
-   uint8_t *buffer;
    uint32_t *data = NULL;
    uint32_t nl_width, nl_height;
    uint8_t header[8] = "TGV1";
    int block_width, block_height, macro_block_width, macro_block_height;
    int block_count, image_stride, image_height, etc_block_size;
+   int macro_block_num = 0;
    Evas_Colorspace cspace;
    Eina_Bool alpha, alpha_texture = EINA_FALSE, unpremul = EINA_FALSE;
    int num_planes = 1;
 
 #ifdef DEBUG_STATS
    struct timespec ts1, ts2;
-   long long tsdiff, mse = 0, mse_div = 0, mse_alpha = 0, pixels_count = 0;
-   double mean_x = 0, mean_y = 0, var_x = 0, var_y = 0, cov_xy = 0;
+   long long tsdiff;
    clock_gettime(CLOCK_MONOTONIC, &ts1);
 #endif
 
+   memset(&enc, 0, sizeof(enc));
+
    if (!im || !im->image.data || !file)
      return 0;
 
@@ -307,10 +521,30 @@ evas_image_save_file_tgv(RGBA_Image *im,
 
    // Number of ETC1 blocks in a compressed block
    block_count = (macro_block_width * macro_block_height) / (4 * 4);
-   buffer = alloca(block_count * etc_block_size);
 
+   enc.param = param;
+   enc.cspace = cspace;
+   enc.image_stride = image_stride;
+   enc.image_height = image_height;
+   enc.macro_block_width = macro_block_width;
+   enc.macro_block_height = macro_block_height;
+   enc.macro_block_cols = (image_stride + 2 + macro_block_width - 1) / macro_block_width;
+   enc.macro_block_rows = (image_height + 2 + macro_block_height - 1) / macro_block_height;
+   enc.macro_block_size = block_count * etc_block_size;
+   enc.etc_block_size = etc_block_size;
+   enc.compress = compress;
+#ifdef DEBUG_STATS
+   enc.alpha = alpha;
+#endif
+   macro_block_num = enc.macro_block_cols * enc.macro_block_rows;
+   enc.blocks = malloc((size_t)macro_block_num * enc.macro_block_size);
+   if (!enc.blocks) goto on_error;
    if (compress)
-     comp = alloca(LZ4_compressBound(block_count * etc_block_size));
+     {
+        enc.comp = calloc(macro_block_num, sizeof(uint8_t *));
+        enc.comp_len = calloc(macro_block_num, sizeof(int));
+        if (!enc.comp || !enc.comp_len) goto on_error;
+     }
 
    // Write a whole plane (RGB or Alpha)
    for (int plane = 0; plane < num_planes; plane++)
@@ -335,195 +569,70 @@ evas_image_save_file_tgv(RGBA_Image *im,
              _alpha_to_greyscale_convert(data, image_stride * image_height);
           }
 
-        // Write macro block
-        for (int y = 0; y < image_height + 2; y += macro_block_height)
+        // Encode the macro block rows in parallel, the stats need them in order
+        enc.data = data;
+#ifdef DEBUG_STATS
+        enc.plane = plane;
+        rg_etc_jobs_run(enc.macro_block_rows, 1, _tgv_stripe_encode, &enc);
+#else
+        rg_etc_jobs_run(enc.macro_block_rows, 0, _tgv_stripe_encode, &enc);
+#endif
+        if (enc.error) goto on_error;
+
+        // Write macro blocks, in the same order they were always written
+        for (int idx = 0; idx < macro_block_num; idx++)
           {
-             uint32_t *input, *last_col, *last_row, *last_pix;
-             int real_y;
+             uint8_t *comp;
              int wlen;
 
-             if (y == 0) real_y = 0;
-             else if (y < image_height + 1) real_y = y - 1;
-             else real_y = image_height - 1;
-
-             for (int x = 0; x < image_stride + 2; x += macro_block_width)
+             if (compress)
                {
-                  uint8_t *offset = buffer;
-                  int real_x = x;
-
-                  if (x == 0) real_x = 0;
-                  else if (x < image_stride + 1) real_x = x - 1;
-                  else real_x = image_stride - 1;
-
-                  input = data + real_y * image_stride + real_x;
-                  last_row = data + image_stride * (image_height - 1) + real_x;
-                  last_col = data + (real_y + 1) * image_stride - 1;
-                  last_pix = data + image_height * image_stride - 1;
-
-                  for (int by = 0; by < macro_block_height; by += 4)
-                    {
-                       int dup_top = ((y + by) == 0) ? 1 : 0;
-                       int max_row = MAX(0, MIN(4, image_height - real_y - by));
-                       int oy = (y == 0) ? 1 : 0;
-
-                       for (int bx = 0; bx < macro_block_width; bx += 4)
-                         {
-                            int dup_left = ((x + bx) == 0) ? 1 : 0;
-                            int max_col = MAX(0, MIN(4, image_stride - real_x - bx));
-                            uint32_t todo[16] = { 0 };
-                            int row, col;
-                            int ox = (x == 0) ? 1 : 0;
-
-                            if (dup_left)
-                              {
-                                 // Duplicate left column
-                                 for (row = 0; row < max_row; row++)
-                                   todo[row * 4] = input[row * image_stride];
-                                 for (row = max_row; row < 4; row++)
-                                   todo[row * 4] = last_row[0];
-                              }
-
-                            if (dup_top)
-                              {
-                                 // Duplicate top row
-                                 for (col = 0; col < max_col; col++)
-                                   todo[col] = input[MAX(col + bx - ox, 0)];
-                                 for (col = max_col; col < 4; col++)
-                                   todo[col] = last_col[0];
-                              }
-
-                            for (row = dup_top; row < 4; row++)
-                              {
-                                 for (col = dup_left; col < max_col; col++)
-                                   {
-                                      if (row < max_row)
-                                        {
-                                           // Normal copy
-                                           todo[row * 4 + col] = input[(row + by - oy) * image_stride + bx + col - ox];
-                                        }
-                                      else
-                                        {
-                                           // Copy last line
-                                           todo[row * 4 + col] = last_row[col + bx - ox];
-                                        }
-                                   }
-                                 for (col = max_col; col < 4; col++)
-                                   {
-                                      // Right edge
-                                      if (row < max_row)
-                                        {
-                                           // Duplicate last column
-                                           todo[row * 4 + col] = last_col[MAX(row + by - oy, 0) * image_stride];
-                                        }
-                                      else
-                                        {
-                                           // Duplicate very last pixel again and again
-                                           todo[row * 4 + col] = *last_pix;
-                                        }
-                                   }
-                              }
-
-                            switch (cspace)
-                              {
-                               case EVAS_COLORSPACE_ETC1:
-                               case EVAS_COLORSPACE_ETC1_ALPHA:
-                                 rg_etc1_pack_block(offset, (uint32_t *) todo, &param);
-                                 break;
-                               case EVAS_COLORSPACE_RGB8_ETC2:
-                                 etc2_rgb8_block_pack(offset, (uint32_t *) todo, &param);
-                                 break;
-                               case EVAS_COLORSPACE_RGBA8_ETC2_EAC:
-                                 etc2_rgba8_block_pack(offset, (uint32_t *) todo, &param);
-                                 break;
-                               default: goto on_error;
-                              }
-
-#ifdef DEBUG_STATS
-                            if (plane == 0)
-                              {
-                                 // Decode to compute PSNR, this is slow.
-                                 uint32_t done[16];
-
-                                 if (alpha)
-                                   rg_etc2_rgba8_decode_block(offset, done);
-                                 else
-                                    rg_etc2_rgb8_decode_block(offset, done);
-
-                                 for (int k = 0; k < 16; k++)
-                                   {
-                                      const int r = (R_VAL(&(todo[k])) - R_VAL(&(done[k])));
-                                      const int g = (G_VAL(&(todo[k])) - G_VAL(&(done[k])));
-                                      const int b = (B_VAL(&(todo[k])) - B_VAL(&(done[k])));
-                                      const int a = (A_VAL(&(todo[k])) - A_VAL(&(done[k])));
-                                      mse += r*r + g*g + b*b;
-
-                                      /*refer http://planetmath.org/onepassalgorithmtocomputesamplevariance*/
-                                      const double delta_x = (double)todo[k] - mean_x;
-                                      const double delta_y = (double)done[k] - mean_y;
-                                      mean_x = mean_x + (double)(delta_x / (pixels_count + 1));
-                                      mean_y = mean_y + (double)(delta_y / (pixels_count + 1));
-                                      var_x = var_x + ((double)(todo[k] - mean_x) * delta_x);
-                                      var_y = var_y + ((double)(done[k] - mean_y) * delta_y);
-                                      cov_xy = cov_xy + ((double)(todo[k] - mean_x) * (double)(done[k] - mean_y));
-                                      pixels_count++;
-
-                                      if (alpha) mse_alpha += a*a;
-                                      mse_div++;
-                                   }
-                              }
-#endif
-
-                            offset += etc_block_size;
-                         }
-                    }
+                  comp = enc.comp[idx];
+                  wlen = enc.comp_len[idx];
+               }
+             else
+               {
+                  comp = enc.blocks + (size_t)idx * enc.macro_block_size;
+                  wlen = enc.macro_block_size;
+               }
 
-                  if (compress)
-                    {
-                       wlen = LZ4_compress_HC
-                         ((char *)buffer, (char *)comp,
-                          block_count * etc_block_size,
-                          LZ4_compressBound(block_count * etc_block_size),
-                          16);
-                    }
-                  else
-                    {
-                       comp = buffer;
-                       wlen = block_count * etc_block_size;
-                    }
+             if (wlen > 0)
+               {
+                  unsigned int blen = wlen;
 
-                  if (wlen > 0)
+                  while (blen)
                     {
-                       unsigned int blen = wlen;
-
-                       while (blen)
-                         {
-                            unsigned char plen;
+                       unsigned char plen;
 
-                            plen = blen & 0x7F;
-                            blen = blen >> 7;
+                       plen = blen & 0x7F;
+                       blen = blen >> 7;
 
-                            if (blen) plen = 0x80 | plen;
-                            if (fwrite(&plen, 1, 1, f) != 1) goto on_error;
-                         }
-                       if (fwrite(comp, wlen, 1, f) != 1) goto on_error;
+                       if (blen) plen = 0x80 | plen;
+                       if (fwrite(&plen, 1, 1, f) != 1) goto on_error;
                     }
-               } // 4 rows
+                  if (fwrite(comp, wlen, 1, f) != 1) goto on_error;
+               }
+             if (compress)
+               {
+                  free(enc.comp[idx]);
+                  enc.comp[idx] = NULL;
+               }
           } // macroblocks
      } // planes
    fclose(f);
 
 #ifdef DEBUG_STATS
-   if (mse_div && mse)
+   if (enc.mse_div && enc.mse)
      {
         /* Calculating dssim http://en.wikipedia.org/wiki/Structural_similarity */
         double c1 = 0.01 * 255.0;
         double c2 = 0.03 * 255.0;
-        double temp = (mean_x * mean_x + mean_y * mean_y + c1) * (var_x * var_x + var_y * var_y + c2);
-        double ssim = (2 * mean_x * mean_y + c1) * ( 2 * cov_xy + c2) / temp;
+        double temp = (enc.mean_x * enc.mean_x + enc.mean_y * enc.mean_y + c1) * (enc.var_x * enc.var_x + enc.var_y * enc.var_y + c2);
+        double ssim = (2 * enc.mean_x * enc.mean_y + c1) * ( 2 * enc.cov_xy + c2) / temp;
         double dssim = (1 - ssim) / 2.0;
-        double dmse = (double) mse / (double) (mse_div * 3.0);
+        double dmse = (double) enc.mse / (double) (enc.mse_div * 3.0);
         double psnr = 20 * log10(255.0) - 10 * log10(dmse);
-        double dmse_alpha = (double) mse_alpha / (double) mse_div;
+        double dmse_alpha = (double) enc.mse_alpha / (double) enc.mse_div;
         double psnr_alpha = (dmse_alpha > 0.0) ? (20 * log10(255.0) - 10 * log10(dmse_alpha)) : 0;
         clock_gettime(CLOCK_MONOTONIC, &ts2);
         tsdiff = ((ts2.tv_sec - ts1.tv_sec) * 1000LL) + ((ts2.tv_nsec - ts1.tv_nsec) / 1000000LL);
@@ -540,10 +649,12 @@ evas_image_save_file_tgv(RGBA_Image *im,
      }
 #endif
 
+   _tgv_encode_free(&enc, macro_block_num);
    if (alpha_texture) free(data);
    return 1;
 
 on_error:
+   _tgv_encode_free(&enc, macro_block_num);
    if (alpha_texture) free(data);
    fclose(f);
    return 0;
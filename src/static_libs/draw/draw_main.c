@@ -342,6 +342,7 @@ efl_draw_init(void)
      {
         _draw_log_dom = eina_log_domain_register("efl_draw", EINA_COLOR_ORANGE);
         efl_draw_sse2_init();
+        efl_draw_avx2_init();
         efl_draw_neon_init();
      }
    return i;
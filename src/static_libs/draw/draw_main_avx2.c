@@ -0,0 +1,232 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "draw_private.h"
+
+#ifdef BUILD_AVX2
+#include <immintrin.h>
+
+/* Same results as the C functions in draw_main.c, 8 pixels at a time.
+ * Loads and stores are unaligned, the tail is done with the C code. */
+
+// Each 32bits components of a must be in the form 0x00AA00AA, AA <= 256
+static inline __m256i
+v8_byte_mul_avx2(__m256i c, __m256i a)
+{
+   const __m256i ag_mask = _mm256_set1_epi32(0xFF00FF00);
+   const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+
+   /* for AG */
+   __m256i v_ag = _mm256_srli_epi32(_mm256_and_si256(ag_mask, c), 8);
+   v_ag = _mm256_and_si256(ag_mask, _mm256_mullo_epi16(a, v_ag));
+
+   /* for RB */
+   __m256i v_rb = _mm256_and_si256(rb_mask, c);
+   v_rb = _mm256_srli_epi16(_mm256_mullo_epi16(a, v_rb), 8);
+
+   /* combine */
+   return _mm256_or_si256(v_ag, v_rb);
+}
+
+// 255 - alpha of each pixel, in the form 0x00AA00AA
+static inline __m256i
+v8_ialpha_avx2(__m256i c)
+{
+   __m256i a = _mm256_sub_epi32(_mm256_set1_epi32(0xff), _mm256_srli_epi32(c, 24));
+
+   return _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+}
+
+// DRAW_MUL4_SYM(): (x * y + 0xff) >> 8 on every channel
+static inline __m256i
+v8_mul_color_avx2(__m256i x, __m256i y)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i v_round = _mm256_set1_epi16(0xff);
+
+   __m256i r_l = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero),
+                                    _mm256_unpacklo_epi8(y, zero));
+   __m256i r_h = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero),
+                                    _mm256_unpackhi_epi8(y, zero));
+
+   r_l = _mm256_srli_epi16(_mm256_add_epi16(r_l, v_round), 8);
+   r_h = _mm256_srli_epi16(_mm256_add_epi16(r_h, v_round), 8);
+
+   return _mm256_packus_epi16(r_l, r_h);
+}
+
+// draw_interpolate_256(): x * a + y * b with a + b <= 256
+static inline __m256i
+v8_interpolate_color_avx2(__m256i x, __m256i a, __m256i y, __m256i b)
+{
+   const __m256i ag_mask = _mm256_set1_epi32(0xFF00FF00);
+   const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+
+   __m256i v_rb = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(x, rb_mask), a),
+                                   _mm256_mullo_epi16(_mm256_and_si256(y, rb_mask), b));
+   __m256i v_ag = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(x, 8), a),
+                                   _mm256_mullo_epi16(_mm256_srli_epi16(y, 8), b));
+
+   return _mm256_or_si256(_mm256_srli_epi16(v_rb, 8),
+                          _mm256_and_si256(v_ag, ag_mask));
+}
+
+// dest = color + (dest * alpha)
+static inline void
+comp_func_helper_avx2(uint32_t *dest, int length, uint32_t color, uint32_t alpha)
+{
+   const __m256i v_color = _mm256_set1_epi32(color);
+   const __m256i v_a = _mm256_set1_epi16(alpha);
+
+   for (; length >= 8; length -= 8, dest += 8)
+     {
+        __m256i v_dest = _mm256_loadu_si256((__m256i *)dest);
+
+        v_dest = _mm256_add_epi32(v8_byte_mul_avx2(v_dest, v_a), v_color);
+        _mm256_storeu_si256((__m256i *)dest, v_dest);
+     }
+   for (; length; length--, dest++)
+     *dest = color + DRAW_BYTE_MUL(*dest, alpha);
+}
+
+static void
+comp_func_solid_source_avx2(uint32_t *dest, int length, uint32_t color, uint32_t const_alpha)
+{
+   if (const_alpha == 255)
+     {
+        draw_memset32(dest, color, length);
+     }
+   else
+     {
+        int ialpha;
+
+        ialpha = 255 - const_alpha;
+        color = DRAW_BYTE_MUL(color, const_alpha);
+        comp_func_helper_avx2(dest, length, color, ialpha);
+     }
+}
+
+static void
+comp_func_solid_source_over_avx2(uint32_t *dest, int length, uint32_t color, uint32_t const_alpha)
+{
+   int ialpha;
+
+   if (const_alpha != 255)
+     color = DRAW_BYTE_MUL(color, const_alpha);
+   ialpha = alpha_inverse(color);
+   comp_func_helper_avx2(dest, length, color, ialpha);
+}
+
+static void
+comp_func_source_avx2(uint32_t *dest, const uint32_t *src, int length, uint32_t color, uint32_t const_alpha)
+{
+   const __m256i v_color = _mm256_set1_epi32(color);
+   const __m256i v_ca = _mm256_set1_epi16(const_alpha);
+   const __m256i v_cia = _mm256_set1_epi16(255 - const_alpha);
+   int ialpha = 255 - const_alpha;
+   uint32_t src_color;
+
+   if ((color == 0xffffffff) && (const_alpha == 255))
+     {
+        memcpy(dest, src, length * sizeof(uint32_t));
+        return;
+     }
+
+   for (; length >= 8; length -= 8, dest += 8, src += 8)
+     {
+        __m256i v_src = _mm256_loadu_si256((__m256i *)src);
+
+        if (color != 0xffffffff)
+          v_src = v8_mul_color_avx2(v_src, v_color);
+        if (const_alpha != 255)
+          v_src = v8_interpolate_color_avx2(v_src, v_ca,
+                                            _mm256_loadu_si256((__m256i *)dest),
+                                            v_cia);
+        _mm256_storeu_si256((__m256i *)dest, v_src);
+     }
+   for (; length; length--, dest++, src++)
+     {
+        src_color = *src;
+        if (color != 0xffffffff)
+          src_color = DRAW_MUL4_SYM(src_color, color);
+        if (const_alpha != 255)
+          src_color = draw_interpolate_256(src_color, const_alpha, *dest, ialpha);
+        *dest = src_color;
+     }
+}
+
+static void
+comp_func_source_over_avx2(uint32_t *dest, const uint32_t *src, int length, uint32_t color, uint32_t const_alpha)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   __m256i v_color;
+   uint32_t s, sia;
+
+   if (const_alpha != 255)
+     color = DRAW_BYTE_MUL(color, const_alpha);
+   v_color = _mm256_set1_epi32(color);
+
+   if (color == 0xffffffff) // No color multiplier
+     {
+        for (; length >= 8; length -= 8, dest += 8, src += 8)
+          {
+             __m256i v_src = _mm256_loadu_si256((__m256i *)src);
+             __m256i v_dest = _mm256_loadu_si256((__m256i *)dest);
+             __m256i v_res;
+
+             // a transparent source leaves dest as is
+             v_res = _mm256_add_epi32(v_src, v8_byte_mul_avx2(v_dest, v8_ialpha_avx2(v_src)));
+             v_res = _mm256_blendv_epi8(v_res, v_dest, _mm256_cmpeq_epi32(v_src, zero));
+             _mm256_storeu_si256((__m256i *)dest, v_res);
+          }
+        for (; length; length--, dest++, src++)
+          {
+             s = *src;
+             if (s >= 0xff000000)
+               *dest = s;
+             else if (s != 0)
+               {
+                  sia = alpha_inverse(s);
+                  *dest = s + DRAW_BYTE_MUL(*dest, sia);
+               }
+          }
+     }
+   else
+     {
+        for (; length >= 8; length -= 8, dest += 8, src += 8)
+          {
+             __m256i v_src = _mm256_loadu_si256((__m256i *)src);
+             __m256i v_dest = _mm256_loadu_si256((__m256i *)dest);
+
+             v_src = v8_mul_color_avx2(v_color, v_src);
+             v_dest = v8_byte_mul_avx2(v_dest, v8_ialpha_avx2(v_src));
+             _mm256_storeu_si256((__m256i *)dest, _mm256_add_epi32(v_src, v_dest));
+          }
+        for (; length; length--, dest++, src++)
+          {
+             s = DRAW_MUL4_SYM(color, *src);
+             sia = alpha_inverse(s);
+             *dest = s + DRAW_BYTE_MUL(*dest, sia);
+          }
+     }
+}
+
+#endif
+
+void
+efl_draw_avx2_init(void)
+{
+#ifdef BUILD_AVX2
+   if (eina_cpu_features_get() & EINA_CPU_AVX2)
+     {
+        // update the comp_function table for solid color
+        func_for_mode_solid[EFL_GFX_RENDER_OP_COPY] = comp_func_solid_source_avx2;
+        func_for_mode_solid[EFL_GFX_RENDER_OP_BLEND] = comp_func_solid_source_over_avx2;
+
+        // update the comp_function table for source data
+        func_for_mode[EFL_GFX_RENDER_OP_COPY] = comp_func_source_avx2;
+        func_for_mode[EFL_GFX_RENDER_OP_BLEND] = comp_func_source_over_avx2;
+     }
+#endif
+}
@@ -43,6 +43,7 @@ extern RGBA_Comp_Func func_for_mode[EFL_GFX_RENDER_OP_LAST];
 extern int _draw_log_dom;
 
 void efl_draw_sse2_init(void);
+void efl_draw_avx2_init(void);
 void efl_draw_neon_init(void);
 
 #ifdef ERR
@@ -22,6 +22,12 @@
 
 #include "rg_etc1.h"
 
+// RG_ETC1_NO_SSE2 builds the scalar error metric only, the tests compare both
+#if defined(__SSE2__) && !defined(RG_ETC1_NO_SSE2)
+# define RG_ETC1_SSE2
+# include <emmintrin.h>
+#endif
+
 #if defined(_DEBUG) || defined(DEBUG)
 #define RG_ETC1_BUILD_DEBUG
 #endif
@@ -1958,14 +1964,87 @@ rg_etc1_optimizer_init(rg_etc1_optimizer *optimizer, const rg_etc1_optimizer_par
    optimizer->m_best_solution.m_error = cUINT64_MAX;
 }
 
+#ifdef RG_ETC1_SSE2
+// RGB squared distance of 4 pixels (as 16 bit r,g,b,0 pairs in px0 and px1) to color
+static inline __m128i
+rg_etc1_sse2_distance4(__m128i px0, __m128i px1, __m128i color)
+{
+   __m128i d0, d1;
+   __m128 m0, m1;
+
+   d0 = _mm_sub_epi16(px0, color);
+   d1 = _mm_sub_epi16(px1, color);
+   // (r*r + g*g, b*b) for each pixel
+   m0 = _mm_castsi128_ps(_mm_madd_epi16(d0, d0));
+   m1 = _mm_castsi128_ps(_mm_madd_epi16(d1, d1));
+   return _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(m0, m1, _MM_SHUFFLE(2, 0, 2, 0))),
+                        _mm_castps_si128(_mm_shuffle_ps(m0, m1, _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
+// Picks the closest of the 4 block colors for each of the 8 source pixels,
+// keeping the lowest index on ties like the scalar loop does.
+static inline uint64
+rg_etc1_sse2_selectors_get(const __m128i px[4], const color_quad_u8 block_colors[4], uint8 selectors[8])
+{
+   __m128i best_lo, best_hi, sel_lo, sel_hi, sum;
+   int sel[8];
+   uint c;
+
+   best_lo = best_hi = _mm_setzero_si128();
+   sel_lo = sel_hi = _mm_setzero_si128();
+   for (c = 0; c < 4; c++)
+     {
+        const color_quad_u8 *bc = &block_colors[c];
+        __m128i color, err_lo, err_hi, index;
+
+        color = _mm_set_epi16(0, bc->comp.b, bc->comp.g, bc->comp.r,
+                              0, bc->comp.b, bc->comp.g, bc->comp.r);
+        err_lo = rg_etc1_sse2_distance4(px[0], px[1], color);
+        err_hi = rg_etc1_sse2_distance4(px[2], px[3], color);
+        if (!c)
+          {
+             best_lo = err_lo;
+             best_hi = err_hi;
+          }
+        else
+          {
+             __m128i lt_lo = _mm_cmplt_epi32(err_lo, best_lo);
+             __m128i lt_hi = _mm_cmplt_epi32(err_hi, best_hi);
+
+             index = _mm_set1_epi32(c);
+             best_lo = _mm_or_si128(_mm_and_si128(lt_lo, err_lo), _mm_andnot_si128(lt_lo, best_lo));
+             best_hi = _mm_or_si128(_mm_and_si128(lt_hi, err_hi), _mm_andnot_si128(lt_hi, best_hi));
+             sel_lo = _mm_or_si128(_mm_and_si128(lt_lo, index), _mm_andnot_si128(lt_lo, sel_lo));
+             sel_hi = _mm_or_si128(_mm_and_si128(lt_hi, index), _mm_andnot_si128(lt_hi, sel_hi));
+          }
+     }
+
+   _mm_storeu_si128((__m128i *)sel, sel_lo);
+   _mm_storeu_si128((__m128i *)(sel + 4), sel_hi);
+   for (c = 0; c < 8; c++)
+     selectors[c] = (uint8)sel[c];
+
+   sum = _mm_add_epi32(best_lo, best_hi);
+   sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+   sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+   return (uint)_mm_cvtsi128_si32(sum);
+}
+#endif
+
 static bool
 rg_etc1_optimizer_evaluate_solution(rg_etc1_optimizer *optimizer, const Etc1_Solution_Coordinates* coords,
                                     rg_etc1_potential_solution* trial_solution, rg_etc1_potential_solution* pBest_solution)
 {
    color_quad_u8 base_color;
-   const uint n = 8;
    uint inten_table;
    bool success = EINA_FALSE;
+#ifndef RG_ETC1_SSE2
+   const uint n = 8;
+#else
+   const __m128i rgb_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+   const __m128i zero = _mm_setzero_si128();
+   __m128i px[4], p;
+#endif
 
    trial_solution->m_valid = EINA_FALSE;
 
@@ -1983,12 +2062,24 @@ rg_etc1_optimizer_evaluate_solution(rg_etc1_optimizer *optimizer, const Etc1_Sol
    rg_etc1_solution_coordinates_get_scaled_color(&base_color, coords);
    trial_solution->m_error = cUINT64_MAX;
 
+#ifdef RG_ETC1_SSE2
+   // Widen the 8 source pixels once to 16 bit r,g,b,0 for all the tables
+   p = _mm_loadu_si128((const __m128i *)optimizer->m_pParams->m_pSrc_pixels);
+   px[0] = _mm_and_si128(_mm_unpacklo_epi8(p, zero), rgb_mask);
+   px[1] = _mm_and_si128(_mm_unpackhi_epi8(p, zero), rgb_mask);
+   p = _mm_loadu_si128((const __m128i *)(optimizer->m_pParams->m_pSrc_pixels + 4));
+   px[2] = _mm_and_si128(_mm_unpacklo_epi8(p, zero), rgb_mask);
+   px[3] = _mm_and_si128(_mm_unpackhi_epi8(p, zero), rgb_mask);
+#endif
+
    for (inten_table = 0; inten_table < cETC1IntenModifierValues; inten_table++)
      {
         const int* pInten_table = rg_etc1_inten_tables[inten_table];
         uint64 total_error = 0;
         color_quad_u8 block_colors[4];
+#ifndef RG_ETC1_SSE2
         const color_quad_u8* pSrc_pixels = optimizer->m_pParams->m_pSrc_pixels;
+#endif
 
         uint c;
         for (c = 0; c < 4; c++)
@@ -1997,6 +2088,11 @@ rg_etc1_optimizer_evaluate_solution(rg_etc1_optimizer *optimizer, const Etc1_Sol
              rg_etc1_color_quad_u8_init(&block_colors[c], base_color.comp.r+yd, base_color.comp.g+yd, base_color.comp.b+yd, 0);
           }
 
+#ifdef RG_ETC1_SSE2
+        // Same result as the scalar loop: its early exit only skips
+        // tables that can not beat the current best anyway.
+        total_error = rg_etc1_sse2_selectors_get(px, block_colors, optimizer->m_temp_selectors);
+#else
         for (c = 0; c < n; c++)
           {
              uint best_selector_index = 0, best_error, trial_error;
@@ -2038,6 +2134,7 @@ rg_etc1_optimizer_evaluate_solution(rg_etc1_optimizer *optimizer, const Etc1_Sol
              if (total_error >= trial_solution->m_error)
                break;
           }
+#endif
 
         if (total_error < trial_solution->m_error)
           {
@@ -2873,3 +2970,77 @@ rg_etc1_pack_block(void* pETC1_block, const unsigned int* pSrc_pixels_BGRA, rg_e
    dst_block[6] = (uint8)(selector0 >> 8); dst_block[7] = (uint8)(selector0 & 0xFF);
    return (unsigned int)(best_error);
 }
+
+typedef struct
+{
+   rg_etc_job_cb job_cb;
+   void *data;
+   Eina_Spinlock lock;
+   unsigned int next;
+   unsigned int count;
+} rg_etc_jobs;
+
+static void *
+rg_etc_jobs_worker(void *data, Eina_Thread t EINA_UNUSED)
+{
+   rg_etc_jobs *jobs = data;
+
+   for (;;)
+     {
+        unsigned int job;
+
+        eina_spinlock_take(&jobs->lock);
+        job = jobs->next++;
+        eina_spinlock_release(&jobs->lock);
+        if (job >= jobs->count) break;
+
+        jobs->job_cb(jobs->data, job);
+     }
+   return NULL;
+}
+
+void
+rg_etc_jobs_run(unsigned int count, unsigned int max_threads, rg_etc_job_cb job_cb, void *data)
+{
+   Eina_Thread *workers;
+   rg_etc_jobs jobs;
+   unsigned int i, n = 0, nthreads;
+
+   if (!count) return;
+
+   // The lookup tables are lazily built, do it before any thread packs.
+   if (!rg_etc1_inverse_lookup[0][255])
+     rg_etc1_pack_block_init();
+
+   nthreads = max_threads ? max_threads : (unsigned int)eina_cpu_count();
+   nthreads = MIN(nthreads, count);
+   if (nthreads <= 1)
+     {
+        for (i = 0; i < count; i++)
+          job_cb(data, i);
+        return;
+     }
+
+   jobs.job_cb = job_cb;
+   jobs.data = data;
+   jobs.next = 0;
+   jobs.count = count;
+   eina_spinlock_new(&jobs.lock);
+
+   workers = malloc((nthreads - 1) * sizeof(Eina_Thread));
+   for (i = 0; workers && (i < nthreads - 1); i++)
+     {
+        if (!eina_thread_create(&workers[n], EINA_THREAD_NORMAL, -1,
+                                rg_etc_jobs_worker, &jobs))
+          break;
+        n++;
+     }
+
+   // The caller takes its share too, and finishes alone if no thread started.
+   rg_etc_jobs_worker(&jobs, 0);
+
+   for (i = 0; i < n; i++)
+     eina_thread_join(workers[i]);
+   free(workers);
+   eina_spinlock_free(&jobs.lock);
+}
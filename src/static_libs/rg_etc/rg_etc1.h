@@ -43,6 +43,13 @@ unsigned int etc2_rgba8_block_pack(unsigned char *etc2, const unsigned int *bgra
 // Pack a 4x4 block of 32bpp BGRA pixels to a 8-byte RGB8_ETC2 block (opaque).
 unsigned int etc2_rgb8_block_pack(unsigned char *etc2, const unsigned int *bgra, rg_etc1_pack_params *params);
 
+// Calls job_cb(data, job) for every job in [0, count), spreading the jobs
+// over up to max_threads threads (0 means one per CPU) including the caller.
+// Returns once all the jobs are done. Jobs must be independent of each other,
+// the packing functions above can safely run from them.
+typedef void (*rg_etc_job_cb)(void *data, unsigned int job);
+void rg_etc_jobs_run(unsigned int count, unsigned int max_threads, rg_etc_job_cb job_cb, void *data);
+
 // ETC2 support: RGB8_ETC2
 void rg_etc2_rgb8_decode_block(const unsigned char *etc_block, unsigned int *bgra);
 
@@ -0,0 +1,8 @@
+#!/bin/sh
+
+# the fd handler and Efl.Io test cases again, on the io_uring backend of
+# the main loop, run from the build directory like the suites themselves
+ECORE_IO_URING=1
+export ECORE_IO_URING
+./tests/ecore/ecore_suite Ecore Ecore_Pipe && \
+./tests/ecore/efl_app_suite Loop_FD Io_Copier
@@ -675,6 +675,80 @@ EFL_START_TEST(ecore_test_ecore_thread_eina_thread_queue_t7)
 }
 EFL_END_TEST
 
+/////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+   Eina_Thread_Queue_Msg  head;
+   int                    sender;
+   int                    value;
+   char                   pad[1];
+} Msg8;
+
+#define MSG8_SENDERS 4
+#define MSG8_COUNT 10000
+
+static void
+thmpsc8_do(void *data, Ecore_Thread *th EINA_UNUSED)
+{
+   int sender = (int)(uintptr_t)data, i;
+
+   for (i = 0; i < MSG8_COUNT; i++)
+     {
+        Msg8 *msg;
+        void *ref;
+        // vary the size so some messages need blocks of their own
+        int size = sizeof(Msg8) + ((i % 100) == 0 ? 8000 : (i % 64));
+
+        msg = eina_thread_queue_send(thq1, size, &ref);
+        if (!msg) fail();
+        msg->sender = sender;
+        msg->value = i;
+        eina_thread_queue_send_done(thq1, ref);
+     }
+}
+
+EFL_START_TEST(ecore_test_ecore_thread_eina_thread_queue_t8)
+{
+   int last[MSG8_SENDERS];
+   int i, msgcnt;
+   Ecore_Thread *eth[MSG8_SENDERS];
+
+   thq1 = eina_thread_queue_mpsc_new();
+   if (!thq1) fail();
+   for (i = 0; i < MSG8_SENDERS; i++)
+     {
+        last[i] = -1;
+        eth[i] = ecore_thread_feedback_run(thmpsc8_do, (void *)(uintptr_t)i,
+                                           NULL, NULL, NULL, EINA_TRUE);
+     }
+   for (msgcnt = 0; msgcnt < (MSG8_SENDERS * MSG8_COUNT); msgcnt++)
+     {
+        Msg8 *msg;
+        void *ref;
+
+        // mix blocking and non blocking reads
+        if (msgcnt & 1) msg = eina_thread_queue_wait(thq1, &ref);
+        else
+          {
+             while (!(msg = eina_thread_queue_poll(thq1, &ref)))
+               usleep(10);
+          }
+        if (!msg) fail();
+        fail_if((msg->sender < 0) || (msg->sender >= MSG8_SENDERS));
+        // messages of a single sender are read in order
+        if (msg->value != (last[msg->sender] + 1))
+          ck_abort_msg("ERR %i not next after %i from sender %i\n",
+                       msg->value, last[msg->sender], msg->sender);
+        last[msg->sender] = msg->value;
+        eina_thread_queue_wait_done(thq1, ref);
+     }
+   for (i = 0; i < MSG8_SENDERS; i++)
+     ecore_thread_wait(eth[i], 0.1);
+   fail_if(eina_thread_queue_pending_get(thq1) != 0);
+   eina_thread_queue_free(thq1);
+}
+EFL_END_TEST
+
 void ecore_test_ecore_thread_eina_thread_queue(TCase *tc EINA_UNUSED)
 {
    tcase_add_test(tc, ecore_test_ecore_thread_eina_thread_queue_t1);
@@ -688,4 +762,5 @@ void ecore_test_ecore_thread_eina_thread_queue2(TCase *tc EINA_UNUSED)
    tcase_add_test(tc, ecore_test_ecore_thread_eina_thread_queue_t5);
    tcase_add_test(tc, ecore_test_ecore_thread_eina_thread_queue_t6);
    tcase_add_test(tc, ecore_test_ecore_thread_eina_thread_queue_t7);
+   tcase_add_test(tc, ecore_test_ecore_thread_eina_thread_queue_t8);
 }
@@ -5,6 +5,7 @@
 #include <Ecore.h>
 
 #include <math.h>
+#include <unistd.h>
 
 #include "ecore_suite.h"
 
@@ -288,6 +289,182 @@ EFL_START_TEST(ecore_test_timer_in_order)
 }
 EFL_END_TEST
 
+#define HEAP_TIMERS 500
+#define HEAP_DEADLINES 50
+
+typedef struct _Heap_Timer Heap_Timer;
+struct _Heap_Timer
+{
+   Ecore_Timer *timer;
+   int          index;
+   int          deadline;
+   Eina_Bool    called;
+};
+
+typedef struct _Heap_Test Heap_Test;
+struct _Heap_Test
+{
+   Heap_Timer timers[HEAP_TIMERS];
+   Heap_Timer *last;
+   int         called;
+   int         expected;
+};
+
+static Heap_Test *heap_test = NULL;
+
+/* Timers go off by deadline, and by creation order for the same deadline */
+static void
+_heap_timer_order_check(Heap_Timer *ht)
+{
+   Heap_Timer *last = heap_test->last;
+
+   fail_if(ht->called, "Timer %d called twice", ht->index);
+   ht->called = EINA_TRUE;
+   if (last)
+     {
+        fail_if(last->deadline > ht->deadline,
+                "Timer %d (deadline %d) called after timer %d (deadline %d)",
+                ht->index, ht->deadline, last->index, last->deadline);
+        fail_if((last->deadline == ht->deadline) && (last->index > ht->index),
+                "Timer %d called after timer %d with the same deadline",
+                ht->index, last->index);
+     }
+   heap_test->last = ht;
+   if (++heap_test->called == heap_test->expected)
+     ecore_main_loop_quit();
+}
+
+static Eina_Bool
+_heap_timer_cb(void *data)
+{
+   _heap_timer_order_check(data);
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_heap_timers_add(Ecore_Task_Cb func)
+{
+   int i;
+
+   heap_test = calloc(1, sizeof(Heap_Test));
+   fail_if(!heap_test);
+   heap_test->expected = HEAP_TIMERS;
+
+   for (i = 0; i < HEAP_TIMERS; i++)
+     {
+        Heap_Timer *ht = &heap_test->timers[i];
+
+        ht->index = i;
+        ht->deadline = (i * 37) % HEAP_DEADLINES;
+        ht->timer = ecore_timer_loop_add(0.001 * (ht->deadline + 1), func, ht);
+        fail_if(!ht->timer);
+     }
+   // Restarted from the same loop time, timers sharing an interval get the
+   // exact same deadline. They were queued again in creation order.
+   ecore_loop_time_set(ecore_time_get());
+   for (i = 0; i < HEAP_TIMERS; i++)
+     ecore_timer_loop_reset(heap_test->timers[i].timer);
+   ecore_timer_add(5.0, timeout_timer_cb, NULL);
+}
+
+EFL_START_TEST(ecore_test_timer_heap_order)
+{
+   _heap_timers_add(_heap_timer_cb);
+
+   ecore_main_loop_begin();
+   ck_assert_int_eq(heap_test->called, HEAP_TIMERS);
+
+   free(heap_test);
+   heap_test = NULL;
+}
+EFL_END_TEST
+
+/* The first timer deletes every odd timer: some expire with it, in the same
+ * pass over the heap, the others later */
+static Eina_Bool
+_heap_timer_del_cb(void *data)
+{
+   Heap_Timer *ht = data;
+   int i;
+
+   fail_if(ht->index & 1, "Deleted timer %d was called", ht->index);
+   if (!heap_test->called)
+     {
+        for (i = 1; i < HEAP_TIMERS; i += 2)
+          {
+             ecore_timer_del(heap_test->timers[i].timer);
+             heap_test->timers[i].timer = NULL;
+          }
+        heap_test->expected = (HEAP_TIMERS + 1) / 2;
+     }
+   _heap_timer_order_check(ht);
+   return ECORE_CALLBACK_CANCEL;
+}
+
+EFL_START_TEST(ecore_test_timer_heap_del)
+{
+   int i;
+
+   _heap_timers_add(_heap_timer_del_cb);
+   // Let all of them expire at once before the loop runs them
+   usleep(0.001 * (HEAP_DEADLINES + 10) * 1000000);
+
+   ecore_main_loop_begin();
+   ck_assert_int_eq(heap_test->called, (HEAP_TIMERS + 1) / 2);
+   for (i = 0; i < HEAP_TIMERS; i++)
+     fail_if(heap_test->timers[i].called != !(i & 1));
+
+   free(heap_test);
+   heap_test = NULL;
+}
+EFL_END_TEST
+
+/* Timers re-armed or delayed from a callback leave the current pass */
+static Eina_Bool
+_heap_timer_rearm_cb(void *data)
+{
+   Heap_Timer *ht = data;
+   Heap_Timer *next = &heap_test->timers[1];
+
+   if (ht->index == 0)
+     {
+        // Already expired, but delayed past the others
+        ecore_timer_delay(next->timer, 0.02);
+        next->deadline += 20;
+     }
+   _heap_timer_order_check(ht);
+   return ECORE_CALLBACK_CANCEL;
+}
+
+EFL_START_TEST(ecore_test_timer_heap_delay)
+{
+   int i;
+
+   heap_test = calloc(1, sizeof(Heap_Test));
+   fail_if(!heap_test);
+   heap_test->expected = 3;
+   for (i = 0; i < 3; i++)
+     {
+        Heap_Timer *ht = &heap_test->timers[i];
+
+        ht->index = i;
+        ht->deadline = i;
+        ht->timer = ecore_timer_loop_add(0.001 * (i + 1), _heap_timer_rearm_cb, ht);
+        fail_if(!ht->timer);
+     }
+   ecore_timer_add(5.0, timeout_timer_cb, NULL);
+   usleep(10000);
+
+   ecore_main_loop_begin();
+   ck_assert_int_eq(heap_test->called, 3);
+   // timer 1 went off after timer 2
+   ck_assert_ptr_eq(heap_test->last, &heap_test->timers[1]);
+
+   free(heap_test);
+   heap_test = NULL;
+}
+EFL_END_TEST
+
 void ecore_test_timer(TCase *tc)
 {
   tcase_add_test(tc, ecore_test_timers);
@@ -295,4 +472,7 @@ void ecore_test_timer(TCase *tc)
   tcase_add_test(tc, ecore_test_timer_valid_callbackfunc);
   tcase_add_test(tc, ecore_test_ecore_main_loop_timer);
   tcase_add_test(tc, ecore_test_timer_in_order);
+  tcase_add_test(tc, ecore_test_timer_heap_order);
+  tcase_add_test(tc, ecore_test_timer_heap_del);
+  tcase_add_test(tc, ecore_test_timer_heap_delay);
 }
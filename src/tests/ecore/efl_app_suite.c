@@ -48,6 +48,7 @@ static const Efl_Test_Case etc[] = {
   { "Loop", efl_app_test_efl_loop },
   { "Loop_Timer", efl_app_test_efl_loop_timer },
   { "Loop_FD", efl_app_test_efl_loop_fd },
+  { "Io_Copier", efl_app_test_efl_io_copier },
   { "Promise", efl_app_test_promise },
   { "Promise", efl_app_test_promise_2 },
   { "Promise", efl_app_test_promise_3 },
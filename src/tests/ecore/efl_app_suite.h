@@ -7,6 +7,7 @@ void efl_app_test_efl_app(TCase *tc);
 void efl_app_test_efl_loop(TCase *tc);
 void efl_app_test_efl_loop_fd(TCase *tc);
 void efl_app_test_efl_loop_timer(TCase *tc);
+void efl_app_test_efl_io_copier(TCase *tc);
 void efl_app_test_promise(TCase *tc);
 void efl_app_test_promise_2(TCase *tc);
 void efl_app_test_promise_3(TCase *tc);
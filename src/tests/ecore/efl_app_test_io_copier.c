@@ -0,0 +1,370 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#define EFL_NOLEGACY_API_SUPPORT
+#include <Efl_Core.h>
+#include "efl_app_suite.h"
+#include "../efl_check.h"
+
+// more than the copier's splice pipe, so it has to go round many times
+#define COPY_SIZE (1024 * 1024 + 123)
+
+typedef struct
+{
+   int fd;
+   unsigned char *buf;
+   size_t len;
+} Fd_Job;
+
+static unsigned char *
+_data_new(void)
+{
+   unsigned char *data = malloc(COPY_SIZE);
+   size_t i;
+
+   fail_if(!data);
+   for (i = 0; i < COPY_SIZE; i++)
+     data[i] = (unsigned char)((i * 31) + (i >> 12));
+   return data;
+}
+
+static void
+_data_check(const unsigned char *data, const unsigned char *got, size_t len)
+{
+   size_t i;
+
+   ck_assert_int_eq(len, COPY_SIZE);
+   for (i = 0; i < len; i++)
+     {
+        if (data[i] != got[i])
+          ck_abort_msg("byte %zu differs: %#x != %#x", i, got[i], data[i]);
+     }
+}
+
+static void *
+_fd_writer(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Fd_Job *job = data;
+   size_t done = 0;
+
+   while (done < job->len)
+     {
+        ssize_t r = write(job->fd, job->buf + done, job->len - done);
+        if (r < 0) return (void *)1;
+        done += r;
+     }
+   close(job->fd);
+   return NULL;
+}
+
+static void *
+_fd_reader(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Fd_Job *job = data;
+   size_t size = COPY_SIZE * 2;
+
+   job->buf = malloc(size);
+   job->len = 0;
+   for (;;)
+     {
+        ssize_t r = read(job->fd, job->buf + job->len, size - job->len);
+        if (r < 0) return (void *)1;
+        if (r == 0) break;
+        job->len += r;
+        if (job->len == size) return (void *)1;
+     }
+   return NULL;
+}
+
+static void
+_copier_done(void *data EINA_UNUSED, const Efl_Event *ev EINA_UNUSED)
+{
+   efl_loop_quit(efl_main_loop_get(), EINA_VALUE_EMPTY);
+}
+
+static void
+_copier_error(void *data, const Efl_Event *ev)
+{
+   Eina_Error *err = data;
+
+   *err = *(Eina_Error *)ev->info;
+   efl_loop_quit(efl_main_loop_get(), EINA_VALUE_EMPTY);
+}
+
+static void
+_copy(Eo *source, Eo *destination)
+{
+   Eina_Error err = 0;
+   Eo *copier;
+
+   copier = efl_add(EFL_IO_COPIER_CLASS, efl_main_loop_get(),
+                    efl_io_copier_source_set(efl_added, source),
+                    efl_io_copier_destination_set(efl_added, destination),
+                    efl_event_callback_add(efl_added, EFL_IO_COPIER_EVENT_DONE, _copier_done, NULL),
+                    efl_event_callback_add(efl_added, EFL_IO_COPIER_EVENT_ERROR, _copier_error, &err));
+   fail_if(!copier);
+
+   efl_loop_begin(efl_main_loop_get());
+
+   ck_assert_int_eq(err, 0);
+   fail_if(!efl_io_copier_done_get(copier));
+   ck_assert_int_eq(efl_io_copier_pending_size_get(copier), 0);
+   efl_del(copier);
+}
+
+static char *
+_file_new(void)
+{
+   Eina_Tmpstr *tmp;
+   char *path;
+   int fd;
+
+   fd = eina_file_mkstemp("efl_io_copier_test_XXXXXX", &tmp);
+   fail_if(fd < 0);
+   close(fd);
+   path = strdup(tmp);
+   eina_tmpstr_del(tmp);
+   return path;
+}
+
+static unsigned char *
+_file_read(const char *path, size_t *len)
+{
+   unsigned char *buf = malloc(COPY_SIZE * 2);
+   int fd;
+
+   fd = open(path, O_RDONLY);
+   fail_if(fd < 0);
+   *len = 0;
+   for (;;)
+     {
+        ssize_t r = read(fd, buf + *len, (COPY_SIZE * 2) - *len);
+        fail_if(r < 0);
+        if (r == 0) break;
+        *len += r;
+     }
+   close(fd);
+   return buf;
+}
+
+// Efl.Io.Stdin and Efl.Io.Stdout always use fds 0 and 1, so put the
+// pipe or socket there for the copy
+static int
+_fd_swap(int fd, int std_fd)
+{
+   int saved = dup(std_fd);
+
+   fail_if(saved < 0);
+   fail_if(dup2(fd, std_fd) < 0);
+   close(fd);
+   return saved;
+}
+
+static void
+_fd_restore(int saved, int std_fd)
+{
+   fail_if(dup2(saved, std_fd) < 0);
+   close(saved);
+}
+
+static void
+_pipe_to_file(uint32_t flags)
+{
+   unsigned char *data, *got;
+   Eo *source, *destination;
+   Eina_Thread th;
+   Fd_Job job;
+   char *path;
+   size_t len;
+   int fds[2], saved;
+
+   data = _data_new();
+   path = _file_new();
+   fail_if(pipe(fds) != 0);
+
+   job.fd = fds[1];
+   job.buf = data;
+   job.len = COPY_SIZE;
+   fail_if(!eina_thread_create(&th, EINA_THREAD_NORMAL, -1, _fd_writer, &job));
+
+   saved = _fd_swap(fds[0], STDIN_FILENO);
+   source = efl_add(EFL_IO_STDIN_CLASS, efl_main_loop_get());
+   fail_if(!source);
+   destination = efl_add(EFL_IO_FILE_CLASS, efl_main_loop_get(),
+                         efl_file_set(efl_added, path),
+                         efl_io_file_flags_set(efl_added, flags),
+                         efl_io_file_mode_set(efl_added, 0600));
+   fail_if(!destination);
+
+   _copy(source, destination);
+   fail_if(eina_thread_join(th) != NULL);
+   efl_del(source);
+   efl_del(destination);
+   _fd_restore(saved, STDIN_FILENO);
+
+   got = _file_read(path, &len);
+   _data_check(data, got, len);
+
+   unlink(path);
+   free(path);
+   free(got);
+   free(data);
+}
+
+EFL_START_TEST(efl_app_test_io_copier_pipe_file)
+{
+   _pipe_to_file(O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC);
+}
+EFL_END_TEST
+
+EFL_START_TEST(efl_app_test_io_copier_pipe_file_append)
+{
+   // splice() into a file opened with O_APPEND fails with EINVAL, the
+   // copier has to empty its pipe and go on with read()/write()
+   _pipe_to_file(O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC);
+}
+EFL_END_TEST
+
+EFL_START_TEST(efl_app_test_io_copier_file_socket)
+{
+   unsigned char *data;
+   Eo *source, *destination;
+   Eina_Thread th;
+   Fd_Job job;
+   char *path;
+   int fd, sv[2], saved;
+
+   data = _data_new();
+   path = _file_new();
+   fd = open(path, O_WRONLY | O_TRUNC);
+   fail_if(fd < 0);
+   ck_assert_int_eq(write(fd, data, COPY_SIZE), COPY_SIZE);
+   close(fd);
+
+   fail_if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0);
+   job.fd = sv[1];
+   fail_if(!eina_thread_create(&th, EINA_THREAD_NORMAL, -1, _fd_reader, &job));
+
+   source = efl_add(EFL_IO_FILE_CLASS, efl_main_loop_get(),
+                    efl_file_set(efl_added, path));
+   fail_if(!source);
+   saved = _fd_swap(sv[0], STDOUT_FILENO);
+   destination = efl_add(EFL_IO_STDOUT_CLASS, efl_main_loop_get());
+   fail_if(!destination);
+
+   _copy(source, destination);
+   efl_del(source);
+   efl_del(destination);
+   // closes the socket, so the reader sees the end of the stream
+   _fd_restore(saved, STDOUT_FILENO);
+   fail_if(eina_thread_join(th) != NULL);
+   close(sv[1]);
+
+   _data_check(data, job.buf, job.len);
+
+   unlink(path);
+   free(path);
+   free(job.buf);
+   free(data);
+}
+EFL_END_TEST
+
+// no fd on the other side keeps the copier off splice(), so with
+// ECORE_IO_URING=1 the fd side goes through the loop's ring
+EFL_START_TEST(efl_app_test_io_copier_pipe_binbuf)
+{
+   unsigned char *data;
+   Eo *source, *copier;
+   Eina_Thread th;
+   Eina_Binbuf *got;
+   Eina_Error err = 0;
+   Fd_Job job;
+   int fds[2], saved;
+
+   data = _data_new();
+   fail_if(pipe(fds) != 0);
+
+   job.fd = fds[1];
+   job.buf = data;
+   job.len = COPY_SIZE;
+   fail_if(!eina_thread_create(&th, EINA_THREAD_NORMAL, -1, _fd_writer, &job));
+
+   saved = _fd_swap(fds[0], STDIN_FILENO);
+   source = efl_add(EFL_IO_STDIN_CLASS, efl_main_loop_get());
+   fail_if(!source);
+
+   // without a destination the copier keeps the data in its binbuf
+   copier = efl_add(EFL_IO_COPIER_CLASS, efl_main_loop_get(),
+                    efl_io_copier_source_set(efl_added, source),
+                    efl_event_callback_add(efl_added, EFL_IO_COPIER_EVENT_DONE, _copier_done, NULL),
+                    efl_event_callback_add(efl_added, EFL_IO_COPIER_EVENT_ERROR, _copier_error, &err));
+   fail_if(!copier);
+
+   efl_loop_begin(efl_main_loop_get());
+
+   ck_assert_int_eq(err, 0);
+   fail_if(!efl_io_copier_done_get(copier));
+   got = efl_io_copier_binbuf_steal(copier);
+   fail_if(!got);
+   _data_check(data, eina_binbuf_string_get(got), eina_binbuf_length_get(got));
+
+   efl_del(copier);
+   fail_if(eina_thread_join(th) != NULL);
+   efl_del(source);
+   _fd_restore(saved, STDIN_FILENO);
+
+   eina_binbuf_free(got);
+   free(data);
+}
+EFL_END_TEST
+
+EFL_START_TEST(efl_app_test_io_copier_buffer_socket)
+{
+   unsigned char *data;
+   Eo *source, *destination;
+   Eina_Thread th;
+   Fd_Job job;
+   int sv[2], saved;
+
+   data = _data_new();
+   source = efl_add(EFL_IO_BUFFER_CLASS, efl_main_loop_get(),
+                    efl_io_buffer_adopt_readonly(efl_added, (Eina_Slice){.mem = data, .len = COPY_SIZE}));
+   fail_if(!source);
+
+   fail_if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0);
+   job.fd = sv[1];
+   fail_if(!eina_thread_create(&th, EINA_THREAD_NORMAL, -1, _fd_reader, &job));
+
+   saved = _fd_swap(sv[0], STDOUT_FILENO);
+   destination = efl_add(EFL_IO_STDOUT_CLASS, efl_main_loop_get());
+   fail_if(!destination);
+
+   _copy(source, destination);
+   efl_del(source);
+   efl_del(destination);
+   _fd_restore(saved, STDOUT_FILENO);
+   fail_if(eina_thread_join(th) != NULL);
+   close(sv[1]);
+
+   _data_check(data, job.buf, job.len);
+
+   free(job.buf);
+   free(data);
+}
+EFL_END_TEST
+
+void efl_app_test_efl_io_copier(TCase *tc)
+{
+   tcase_add_test(tc, efl_app_test_io_copier_pipe_file);
+   tcase_add_test(tc, efl_app_test_io_copier_pipe_file_append);
+   tcase_add_test(tc, efl_app_test_io_copier_file_socket);
+   tcase_add_test(tc, efl_app_test_io_copier_pipe_binbuf);
+   tcase_add_test(tc, efl_app_test_io_copier_buffer_socket);
+}
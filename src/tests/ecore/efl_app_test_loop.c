@@ -93,6 +93,52 @@ EFL_START_TEST(efl_app_test_efl_loop_concentric)
 }
 EFL_END_TEST
 
+static void
+_loop_del_promise_cancel(void *data EINA_UNUSED, const Eina_Promise *dead_ptr EINA_UNUSED)
+{
+   ck_abort_msg("a resolved promise was cancelled");
+}
+
+static Eina_Value
+_loop_del_future_cb(void *data, const Eina_Value v, const Eina_Future *dead_future EINA_UNUSED)
+{
+   int *cancelled = data;
+   Eina_Error err;
+
+   ck_assert_ptr_eq(v.type, EINA_VALUE_TYPE_ERROR);
+   fail_if(!eina_value_get(&v, &err));
+   ck_assert_int_eq(err, ECANCELED);
+   (*cancelled)++;
+   return v;
+}
+
+EFL_START_TEST(efl_app_test_efl_loop_del_futures)
+{
+   Eo *loop;
+   int i, cancelled = 0;
+
+   ecore_init();
+
+   loop = efl_add(efl_loop_realized_class_get(), efl_main_loop_get());
+   for (i = 0; i < 3; i++)
+     {
+        Eina_Promise *p;
+
+        p = eina_promise_new(efl_loop_future_scheduler_get(loop), _loop_del_promise_cancel, NULL);
+        fail_if(!p);
+        fail_if(!eina_future_then(eina_future_new(p), _loop_del_future_cb, &cancelled));
+        eina_promise_resolve(p, EINA_VALUE_EMPTY);
+     }
+
+   /* The loop cancels the futures still queued on it when it goes away,
+      and each cancel recalls an entry the loop already took out */
+   efl_del(loop);
+   ck_assert_int_eq(cancelled, 3);
+
+   ecore_shutdown();
+}
+EFL_END_TEST
+
 EFL_START_TEST(efl_loop_test_realized_name)
 {
    ck_assert_str_eq(efl_class_name_get(efl_loop_realized_class_get()), "Efl.Loop_Realized");
@@ -103,5 +149,6 @@ void efl_app_test_efl_loop(TCase *tc)
 {
    tcase_add_test(tc, efl_app_test_efl_loop_register);
    tcase_add_test(tc, efl_app_test_efl_loop_concentric);
+   tcase_add_test(tc, efl_app_test_efl_loop_del_futures);
    tcase_add_test(tc, efl_loop_test_realized_name);
 }
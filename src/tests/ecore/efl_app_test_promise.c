@@ -640,6 +640,103 @@ EFL_START_TEST(efl_test_promise_future_cancel)
 }
 EFL_END_TEST
 
+typedef struct _Recall_Ctx {
+   Eina_Future *queued;
+   Eina_Bool cancel_called;
+   int success;
+   int cancelled;
+} Recall_Ctx;
+
+static Eina_Value
+_recall_count(void *data, const Eina_Value v, const Eina_Future *dead_future EINA_UNUSED)
+{
+   Recall_Ctx *ctx = data;
+
+   if (v.type == EINA_VALUE_TYPE_ERROR)
+     {
+        ERROR_CHECK(v, ECANCELED);
+        ctx->cancelled++;
+     }
+   else ctx->success++;
+   return v;
+}
+
+static Eina_Value
+_recall_first(void *data, const Eina_Value v, const Eina_Future *dead_future EINA_UNUSED)
+{
+   Recall_Ctx *ctx = data;
+   Eina_Promise *p;
+   Eina_Future *f;
+
+   VALUE_TYPE_CHECK(v, NULL);
+   ctx->success++;
+
+   /* Still queued in the batch being dispatched */
+   eina_future_cancel(ctx->queued);
+   ck_assert_int_eq(ctx->cancelled, 1);
+
+   /* Queued behind the batch being dispatched */
+   p = eina_promise_new(_future_scheduler_get(), _promise_cancel_test, &ctx->cancel_called);
+   fail_if(!p);
+   f = eina_future_then(eina_future_new(p), _recall_count, ctx);
+   fail_if(!f);
+   eina_promise_resolve(p, EINA_VALUE_EMPTY);
+   eina_future_cancel(f);
+   ck_assert_int_eq(ctx->cancelled, 2);
+   return v;
+}
+
+static Eina_Value
+_recall_last(void *data, const Eina_Value v, const Eina_Future *dead_future EINA_UNUSED)
+{
+   Recall_Ctx *ctx = data;
+
+   VALUE_TYPE_CHECK(v, NULL);
+   ctx->success++;
+   ecore_main_loop_quit();
+   return v;
+}
+
+EFL_START_TEST(efl_test_promise_future_recall)
+{
+   Recall_Ctx ctx = { 0 };
+   Eina_Promise *p[3];
+   Eina_Future *f;
+   int i;
+
+   fail_if(!ecore_init());
+
+   for (i = 0; i < 3; i++)
+     {
+        p[i] = eina_promise_new(_future_scheduler_get(), _promise_cancel_test, &ctx.cancel_called);
+        fail_if(!p[i]);
+     }
+   f = eina_future_then(eina_future_new(p[0]), _recall_first, &ctx);
+   fail_if(!f);
+   ctx.queued = eina_future_then(eina_future_new(p[1]), _recall_count, &ctx);
+   fail_if(!ctx.queued);
+   f = eina_future_then(eina_future_new(p[2]), _recall_last, &ctx);
+   fail_if(!f);
+   /* All three are dispatched in the same idle round */
+   for (i = 0; i < 3; i++)
+     eina_promise_resolve(p[i], EINA_VALUE_EMPTY);
+
+   ecore_main_loop_begin();
+   ck_assert_int_eq(ctx.success, 2);
+   ck_assert_int_eq(ctx.cancelled, 2);
+
+   /* The recalled entries are gone, nothing is delivered twice */
+   for (i = 0; i < 3; i++)
+     ecore_main_loop_iterate();
+   ck_assert_int_eq(ctx.success, 2);
+   ck_assert_int_eq(ctx.cancelled, 2);
+   /* The promises were resolved, so they were not cancelled */
+   fail_if(ctx.cancel_called);
+
+   ecore_shutdown();
+}
+EFL_END_TEST
+
 EFL_START_TEST(efl_test_promise_future_inner_promise)
 {
    Eina_Future *f;
@@ -1458,6 +1555,7 @@ void efl_app_test_promise_2(TCase *tc)
    tcase_add_test(tc, efl_test_promise_future_implicit_cancel);
    tcase_add_test(tc, efl_test_promise_future_inner_promise);
    tcase_add_test(tc, efl_test_promise_future_inner_promise_fail);
+   tcase_add_test(tc, efl_test_promise_future_recall);
 }
 
 void efl_app_test_promise_3(TCase *tc)
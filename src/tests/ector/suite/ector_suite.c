@@ -26,6 +26,7 @@
 
 static const Efl_Test_Case etc[] = {
   { "init", ector_test_init },
+  { "software", ector_test_software },
   { NULL, NULL }
 };
 
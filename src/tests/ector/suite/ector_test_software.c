@@ -0,0 +1,296 @@
+/* ECTOR - EFL retained mode drawing library
+ * Copyright (C) 2014 Cedric Bail
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library;
+ * if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <Ector.h>
+#include <software/Ector_Software.h>
+
+#include "../../../lib/ector/software/ector_software_private.h"
+#include "draw_private.h"
+
+#include "ector_suite.h"
+
+// premultiplied pixels, with transparent and opaque ones
+static uint32_t
+_pixel_random(unsigned int *seed)
+{
+   unsigned int a, r;
+
+   *seed = *seed * 1103515245 + 12345;
+   r = *seed ^ (*seed >> 13);
+   switch ((r >> 8) % 4)
+     {
+      case 0: return 0;
+      case 1: a = 0xff; break;
+      default: a = r >> 24; break;
+     }
+   return (a << 24) | (((r & 0xff) * a / 255) << 16) |
+          ((((r >> 8) & 0xff) * a / 255) << 8) | (((r >> 16) & 0xff) * a / 255);
+}
+
+static void
+_pixels_random(uint32_t *p, int len, unsigned int seed)
+{
+   int i;
+
+   for (i = 0; i < len; i++)
+     p[i] = _pixel_random(&seed);
+}
+
+// long enough for the 8 pixel loops and their tails, at any alignment
+#define COMP_LEN 203
+#define COMP_RUNS 64
+
+#ifdef BUILD_AVX2
+static void
+_comp_alpha_check(Ector_Comp_Alpha_Func ref, Ector_Comp_Alpha_Func func, const char *name)
+{
+   uint32_t src[COMP_LEN], mask[COMP_LEN], d0[COMP_LEN], d1[COMP_LEN];
+   int run, i;
+
+   for (run = 0; run < COMP_RUNS; run++)
+     {
+        int off = run % 8, len = COMP_LEN - 1 - (run * 3);
+
+        _pixels_random(src, COMP_LEN, run);
+        _pixels_random(mask, COMP_LEN, run + 1000);
+        _pixels_random(d0, COMP_LEN, run + 2000);
+        memcpy(d1, d0, sizeof(d0));
+
+        ref(d0 + off, src + 1, mask + off, len - off);
+        func(d1 + off, src + 1, mask + off, len - off);
+        for (i = 0; i < COMP_LEN; i++)
+          if (d0[i] != d1[i])
+            ck_abort_msg("%s differs at %d (length %d): %#x, %#x in C",
+                         name, i - off, len - off, d1[i], d0[i]);
+     }
+}
+
+static void
+_comp_mask_check(Ector_Comp_Mask_Func ref, Ector_Comp_Mask_Func func, const char *name)
+{
+   uint32_t src[COMP_LEN], m0[COMP_LEN], m1[COMP_LEN];
+   int run, i;
+
+   for (run = 0; run < COMP_RUNS; run++)
+     {
+        int off = run % 8, len = COMP_LEN - 1 - (run * 3);
+
+        _pixels_random(src, COMP_LEN, run);
+        _pixels_random(m0, COMP_LEN, run + 1000);
+        memcpy(m1, m0, sizeof(m0));
+
+        ref(m0 + off, src + 1, len - off);
+        func(m1 + off, src + 1, len - off);
+        for (i = 0; i < COMP_LEN; i++)
+          if (m0[i] != m1[i])
+            ck_abort_msg("%s differs at %d (length %d): %#x, %#x in C",
+                         name, i - off, len - off, m1[i], m0[i]);
+     }
+}
+#endif
+
+EFL_START_TEST(ector_software_comp_avx2)
+{
+#ifdef BUILD_AVX2
+   if (!(eina_cpu_features_get() & EINA_CPU_AVX2)) return;
+
+   _comp_alpha_check(_comp_alpha_generic, _comp_alpha_avx2, "alpha");
+   _comp_alpha_check(_comp_alpha_inv_generic, _comp_alpha_inv_avx2, "alpha inv");
+   _comp_mask_check(_comp_mask_add_generic, _comp_mask_add_avx2, "mask add");
+   _comp_mask_check(_comp_mask_sub_generic, _comp_mask_sub_avx2, "mask sub");
+   _comp_mask_check(_comp_mask_ins_generic, _comp_mask_ins_avx2, "mask ins");
+   _comp_mask_check(_comp_mask_diff_generic, _comp_mask_diff_avx2, "mask diff");
+#endif
+}
+EFL_END_TEST
+
+// the draw static lib linked in this suite, not the copy inside ector
+EFL_START_TEST(ector_software_draw_avx2)
+{
+#ifdef BUILD_AVX2
+   static const Efl_Gfx_Render_Op ops[] = { EFL_GFX_RENDER_OP_BLEND, EFL_GFX_RENDER_OP_COPY };
+   static const uint32_t colors[] = { 0xffffffff, 0xff3080c0, 0x80402010, 0 };
+   static const uint32_t alphas[] = { 255, 170, 0 };
+   RGBA_Comp_Func_Solid solid[EINA_C_ARRAY_LENGTH(ops)];
+   RGBA_Comp_Func span[EINA_C_ARRAY_LENGTH(ops)];
+   uint32_t src[COMP_LEN], d0[COMP_LEN], d1[COMP_LEN];
+   unsigned int o, c, a;
+   int len;
+
+   if (!(eina_cpu_features_get() & EINA_CPU_AVX2)) return;
+
+   // the C compositors, before efl_draw_init() replaces them
+   for (o = 0; o < EINA_C_ARRAY_LENGTH(ops); o++)
+     {
+        solid[o] = func_for_mode_solid[ops[o]];
+        span[o] = func_for_mode[ops[o]];
+     }
+   efl_draw_init();
+
+   _pixels_random(src, COMP_LEN, 42);
+   for (o = 0; o < EINA_C_ARRAY_LENGTH(ops); o++)
+     for (c = 0; c < EINA_C_ARRAY_LENGTH(colors); c++)
+       for (a = 0; a < EINA_C_ARRAY_LENGTH(alphas); a++)
+         for (len = 0; len < COMP_LEN - 8; len += 13)
+           {
+              _pixels_random(d0, COMP_LEN, len);
+              memcpy(d1, d0, sizeof(d0));
+              solid[o](d0 + 3, len, colors[c], alphas[a]);
+              func_for_mode_solid[ops[o]](d1 + 3, len, colors[c], alphas[a]);
+              if (memcmp(d0, d1, sizeof(d0)))
+                ck_abort_msg("solid op %d color %#x alpha %u length %d differs",
+                             ops[o], colors[c], alphas[a], len);
+
+              _pixels_random(d0, COMP_LEN, len);
+              memcpy(d1, d0, sizeof(d0));
+              span[o](d0 + 3, src + 5, len, colors[c], alphas[a]);
+              func_for_mode[ops[o]](d1 + 3, src + 5, len, colors[c], alphas[a]);
+              if (memcmp(d0, d1, sizeof(d0)))
+                ck_abort_msg("span op %d color %#x alpha %u length %d differs",
+                             ops[o], colors[c], alphas[a], len);
+           }
+#endif
+}
+EFL_END_TEST
+
+// a circle that has more spans than the bands need
+#define DRAW_W 640
+#define DRAW_H 640
+#define DRAW_BANDS 4
+
+typedef struct _Draw_Case Draw_Case;
+struct _Draw_Case
+{
+   const char *name;
+   Eina_Bool gradient;
+   int mask_op;   // the blend types of the rasterizer, 0 without mask
+};
+
+static const Draw_Case _draw_cases[] = {
+   { "solid", EINA_FALSE, 0 },
+   { "gradient", EINA_TRUE, 0 },
+   { "solid alpha mask", EINA_FALSE, 1 },
+   { "gradient alpha mask", EINA_TRUE, 1 },
+   { "solid inverse alpha mask", EINA_FALSE, 2 },
+   { "solid add mask", EINA_FALSE, 3 },
+   { "solid difference mask", EINA_FALSE, 6 },
+};
+
+static Ector_Surface *
+_draw_surface_new(uint32_t *pixels)
+{
+   Ector_Surface *surface;
+
+   surface = efl_add_ref(ECTOR_SOFTWARE_SURFACE_CLASS, NULL);
+   fail_if(!surface);
+   ector_buffer_pixels_set(surface, pixels, DRAW_W, DRAW_H, 0,
+                           EFL_GFX_COLORSPACE_ARGB8888, EINA_TRUE);
+   ector_surface_reference_point_set(surface, 0, 0);
+   return surface;
+}
+
+// the target and the mask after drawing, one after the other
+static uint32_t *
+_draw_run(const Draw_Case *dc, int bands)
+{
+   static const Efl_Gfx_Gradient_Stop stops[] = {
+      { 0.0, 255, 0, 0, 255 },
+      { 0.5, 0, 96, 0, 128 },
+      { 1.0, 0, 0, 200, 200 },
+   };
+   Ector_Surface *surface, *mask = NULL;
+   Ector_Renderer *shape, *grad = NULL;
+   uint32_t *pixels;
+
+   pixels = malloc(2 * DRAW_W * DRAW_H * sizeof(uint32_t));
+   fail_if(!pixels);
+   _pixels_random(pixels, 2 * DRAW_W * DRAW_H, 7);
+
+   ector_software_rasterizer_draw_bands_set(bands);
+   surface = _draw_surface_new(pixels);
+   if (dc->mask_op)
+     mask = _draw_surface_new(pixels + (DRAW_W * DRAW_H));
+
+   shape = ector_surface_renderer_factory_new(surface, ECTOR_RENDERER_SHAPE_MIXIN);
+   fail_if(!shape);
+   if (dc->gradient)
+     {
+        grad = ector_surface_renderer_factory_new(surface, ECTOR_RENDERER_GRADIENT_LINEAR_MIXIN);
+        fail_if(!grad);
+        ector_renderer_color_set(grad, 255, 255, 255, 255);
+        efl_gfx_gradient_stop_set(grad, stops, EINA_C_ARRAY_LENGTH(stops));
+        efl_gfx_gradient_spread_set(grad, EFL_GFX_GRADIENT_SPREAD_REFLECT);
+        efl_gfx_gradient_linear_start_set(grad, 40, 10);
+        efl_gfx_gradient_linear_end_set(grad, 300, 500);
+        ector_renderer_prepare(grad);
+        ector_renderer_shape_fill_set(shape, grad);
+     }
+   ector_renderer_color_set(shape, 40, 100, 160, 200);
+   efl_gfx_path_append_circle(shape, DRAW_W / 2 + 0.3, DRAW_H / 2 - 0.6,
+                              DRAW_W / 2 - 17.2);
+   ector_renderer_prepare(shape);
+   if (mask) ector_renderer_mask_set(shape, mask, dc->mask_op);
+   ector_renderer_draw(shape, EFL_GFX_RENDER_OP_BLEND, NULL, 0xffffffff);
+
+   efl_unref(shape);
+   if (grad) efl_unref(grad);
+   if (mask) efl_unref(mask);
+   efl_unref(surface);
+   ector_software_rasterizer_draw_bands_set(0);
+   return pixels;
+}
+
+// the bands are drawn inline without threads, so the split is also checked
+// on a single cpu
+EFL_START_TEST(ector_software_draw_banded)
+{
+   uint32_t *serial, *banded;
+   unsigned int k;
+   int i;
+
+   for (k = 0; k < EINA_C_ARRAY_LENGTH(_draw_cases); k++)
+     {
+        serial = _draw_run(&_draw_cases[k], 1);
+        banded = _draw_run(&_draw_cases[k], DRAW_BANDS);
+        for (i = 0; i < 2 * DRAW_W * DRAW_H; i++)
+          if (serial[i] != banded[i])
+            ck_abort_msg("%s differs in the %s at %d,%d: %#x in the bands, "
+                         "%#x serially", _draw_cases[k].name,
+                         (i < DRAW_W * DRAW_H) ? "target" : "mask",
+                         i % DRAW_W, (i / DRAW_W) % DRAW_H,
+                         banded[i], serial[i]);
+        free(banded);
+        free(serial);
+     }
+}
+EFL_END_TEST
+
+void
+ector_test_software(TCase *tc)
+{
+   tcase_add_test(tc, ector_software_comp_avx2);
+   tcase_add_test(tc, ector_software_draw_avx2);
+   tcase_add_test(tc, ector_software_draw_banded);
+}
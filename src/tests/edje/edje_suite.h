@@ -13,6 +13,7 @@ void edje_test_features(TCase *tc);
 void edje_test_signal(TCase *tc);
 void edje_test_swallow(TCase *tc);
 void edje_test_text(TCase *tc);
+void edje_test_incremental(TCase *tc);
 
 
 #endif /* _EDJE_SUITE_H */
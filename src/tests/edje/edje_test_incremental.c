@@ -0,0 +1,178 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <Eet.h>
+
+#include "edje_suite.h"
+
+#define EMOTION_DATA_DIR TESTS_SRC_DIR "/../emotion/data"
+
+/* two groups with an image and scripts each, only "b" changes with
+ * value */
+static const char *edc_template =
+  "images { image: \"e_logo.png\" COMP; }\n"
+  "collections {\n"
+  "   group { name: \"a\";\n"
+  "      script { public a_val; }\n"
+  "      parts {\n"
+  "         part { name: \"img\"; type: IMAGE;\n"
+  "            description { state: \"default\" 0.0;\n"
+  "               image.normal: \"e_logo.png\";\n"
+  "            }\n"
+  "         }\n"
+  "      }\n"
+  "      programs {\n"
+  "         program { signal: \"go\"; source: \"*\";\n"
+  "            script { set_int(a_val, 1); }\n"
+  "         }\n"
+  "      }\n"
+  "   }\n"
+  "   group { name: \"b\";\n"
+  "      script { public b_val; }\n"
+  "      parts {\n"
+  "         part { name: \"rect\"; type: RECT;\n"
+  "            description { state: \"default\" 0.0;\n"
+  "               color: %i 0 0 255;\n"
+  "            }\n"
+  "         }\n"
+  "      }\n"
+  "      programs {\n"
+  "         program { signal: \"go\"; source: \"*\";\n"
+  "            script { set_int(b_val, %i); }\n"
+  "         }\n"
+  "      }\n"
+  "   }\n"
+  "}\n";
+
+static void
+_edc_write(const char *path, int value)
+{
+   FILE *f = fopen(path, "wb");
+
+   fail_if(!f);
+   fail_if(fprintf(f, edc_template, value, value) <= 0);
+   fclose(f);
+}
+
+static void
+_edje_cc(const char *flags, const char *edc, const char *edj)
+{
+   char command[PATH_MAX * 3];
+
+   snprintf(command, sizeof(command),
+            EDJE_CC" -id \""EMOTION_DATA_DIR"\" %s %s %s", flags, edc, edj);
+   fail_if(system(command) != 0);
+}
+
+static void
+_dump_cb(void *data, const char *str)
+{
+   eina_strbuf_append(data, str);
+}
+
+/* entries written with eet_data_write() refer to the file dictionary, whose
+ * order depends on the order the threads wrote in, so compare their text
+ * dump when their bytes differ */
+static Eina_Bool
+_entry_same(Eet_File *ef1, Eet_File *ef2, const char *key)
+{
+   Eina_Strbuf *dump1, *dump2;
+   Eina_Bool found, ret;
+   void *dat1, *dat2;
+   int size1, size2;
+
+   dat1 = eet_read(ef1, key, &size1);
+   dat2 = eet_read(ef2, key, &size2);
+   found = dat1 && dat2;
+   ret = found && (size1 == size2) && !memcmp(dat1, dat2, size1);
+   free(dat1);
+   free(dat2);
+   if (ret || !found) return ret;
+
+   dump1 = eina_strbuf_new();
+   dump2 = eina_strbuf_new();
+   ret = eet_data_dump(ef1, key, _dump_cb, dump1) &&
+         eet_data_dump(ef2, key, _dump_cb, dump2) &&
+         !strcmp(eina_strbuf_string_get(dump1), eina_strbuf_string_get(dump2));
+   eina_strbuf_free(dump1);
+   eina_strbuf_free(dump2);
+   return ret;
+}
+
+/* everything a clean build writes has to be the same in the incremental
+ * output, which only adds the digests it keeps for the next build */
+static void
+_edj_compare(const char *clean, const char *incremental)
+{
+   Eet_File *ef1, *ef2;
+   char **keys;
+   int i, n1 = 0, n2 = 0, extra = 0;
+
+   ef1 = eet_open(clean, EET_FILE_MODE_READ);
+   fail_if(!ef1);
+   ef2 = eet_open(incremental, EET_FILE_MODE_READ);
+   fail_if(!ef2);
+
+   keys = eet_list(ef1, "*", &n1);
+   fail_if(n1 <= 0);
+   for (i = 0; i < n1; i++)
+     {
+        if (!_entry_same(ef1, ef2, keys[i]))
+          ck_abort_msg("entry \"%s\" differs from the clean build", keys[i]);
+     }
+   free(keys);
+
+   keys = eet_list(ef2, "*", &n2);
+   for (i = 0; i < n2; i++)
+     {
+        if (!strncmp(keys[i], "edje/incremental/", strlen("edje/incremental/")))
+          extra++;
+     }
+   free(keys);
+   fail_if(extra == 0);
+   ck_assert_int_eq(n2 - extra, n1);
+
+   eet_close(ef1);
+   eet_close(ef2);
+}
+
+EFL_START_TEST(edje_test_incremental_rebuild)
+{
+   Eina_Tmpstr *dir;
+   char edc[PATH_MAX], clean[PATH_MAX], inc[PATH_MAX];
+
+   fail_if(!eina_file_mkdtemp("edje_test_incremental_XXXXXX", &dir));
+   snprintf(edc, sizeof(edc), "%s/test.edc", dir);
+   snprintf(clean, sizeof(clean), "%s/clean.edj", dir);
+   snprintf(inc, sizeof(inc), "%s/incremental.edj", dir);
+
+   _edc_write(edc, 1);
+   _edje_cc("", edc, clean);
+   // the first run has nothing to reuse, the second reuses everything
+   _edje_cc("-incremental", edc, inc);
+   _edje_cc("-incremental", edc, inc);
+   _edj_compare(clean, inc);
+
+   // only group "b" and its script change
+   _edc_write(edc, 2);
+   _edje_cc("", edc, clean);
+   _edje_cc("-incremental", edc, inc);
+   _edj_compare(clean, inc);
+
+   unlink(edc);
+   unlink(clean);
+   unlink(inc);
+   rmdir(dir);
+   eina_tmpstr_del(dir);
+}
+EFL_END_TEST
+
+void edje_test_incremental(TCase *tc)
+{
+   tcase_add_test(tc, edje_test_incremental_rebuild);
+}
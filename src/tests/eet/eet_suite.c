@@ -15,6 +15,7 @@ static const Efl_Test_Case etc[] = {
   { "Eet Data Encoding/Decoding", eet_test_data },
   { "Eet File", eet_test_file },
   { "Eet Image", eet_test_image },
+  { "Eet Etc", eet_test_etc },
 #ifdef HAVE_SIGNATURE
   { "Eet Identity", eet_test_identity },
 #endif
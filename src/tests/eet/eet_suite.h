@@ -7,6 +7,7 @@ void eet_test_init(TCase *tc);
 void eet_test_data(TCase *tc);
 void eet_test_file(TCase *tc);
 void eet_test_image(TCase *tc);
+void eet_test_etc(TCase *tc);
 void eet_test_identity(TCase *tc);
 void eet_test_cipher(TCase *tc);
 void eet_test_cache(TCase *tc);
@@ -0,0 +1,122 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <Eina.h>
+
+#include "rg_etc1.h"
+
+#include "eet_suite.h"
+
+/* A second, scalar only copy of the ETC1 packer, renamed so that it can sit
+ * beside the one eet uses, which takes the SSE2 path where available */
+#define RG_ETC1_NO_SSE2
+#define rg_etc1_optimizer_init _scalar_rg_etc1_optimizer_init
+#define rg_etc1_pack_block_init _scalar_rg_etc1_pack_block_init
+#define rg_etc1_pack_block _scalar_rg_etc1_pack_block
+#define rg_etc1_unpack_block _scalar_rg_etc1_unpack_block
+#define rg_etc_jobs_run _scalar_rg_etc_jobs_run
+#include "rg_etc1.c"
+#undef rg_etc1_optimizer_init
+#undef rg_etc1_pack_block_init
+#undef rg_etc1_pack_block
+#undef rg_etc1_unpack_block
+#undef rg_etc_jobs_run
+
+#define BLOCK_COUNT 384
+
+typedef struct _Eet_Test_Etc Eet_Test_Etc;
+struct _Eet_Test_Etc
+{
+   rg_etc1_pack_params param;
+   const unsigned int *pixels;
+   unsigned char *blocks;
+   unsigned int *errors;
+};
+
+// random blocks, blocks of two close tones and smooth gradients
+static void
+_etc_pixels_fill(unsigned int *pixels)
+{
+   unsigned int seed = 42;
+   int i, k;
+
+   for (i = 0; i < BLOCK_COUNT; i++)
+     for (k = 0; k < 16; k++)
+       {
+          unsigned int v;
+
+          seed = seed * 1103515245 + 12345;
+          v = seed >> 8;
+          if ((i % 3) == 1) v = (v & 0x0f0f0f) + 0x606060 * (k / 8);
+          else if ((i % 3) == 2) v = 0x102030 + (i & 0x3f) * 0x010203 + k * 0x030201;
+          pixels[i * 16 + k] = v | 0xff000000;
+       }
+}
+
+static void
+_etc_block_pack(void *data, unsigned int job)
+{
+   Eet_Test_Etc *t = data;
+
+   t->errors[job] = rg_etc1_pack_block(t->blocks + job * 8,
+                                       t->pixels + job * 16, &t->param);
+}
+
+EFL_START_TEST(eet_test_etc_scalar_parallel)
+{
+   unsigned char *ref, *blocks;
+   unsigned int *pixels, *ref_errors, *errors;
+   Eet_Test_Etc t;
+   int quality, i;
+
+   pixels = malloc(BLOCK_COUNT * 16 * sizeof(unsigned int));
+   ref = malloc(BLOCK_COUNT * 8);
+   blocks = malloc(BLOCK_COUNT * 8);
+   ref_errors = malloc(BLOCK_COUNT * sizeof(unsigned int));
+   errors = malloc(BLOCK_COUNT * sizeof(unsigned int));
+   fail_if(!pixels || !ref || !blocks || !ref_errors || !errors);
+   _etc_pixels_fill(pixels);
+
+   _scalar_rg_etc1_pack_block_init();
+   rg_etc1_pack_block_init();
+
+   for (quality = rg_etc1_low_quality; quality <= rg_etc1_high_quality; quality++)
+     {
+        memset(&t, 0, sizeof(t));
+        t.param.m_quality = quality;
+        t.param.m_dithering = 0;
+
+        for (i = 0; i < BLOCK_COUNT; i++)
+          ref_errors[i] = _scalar_rg_etc1_pack_block(ref + i * 8, pixels + i * 16,
+                                                     &t.param);
+
+        memset(blocks, 0, BLOCK_COUNT * 8);
+        t.pixels = pixels;
+        t.blocks = blocks;
+        t.errors = errors;
+        rg_etc_jobs_run(BLOCK_COUNT, 4, _etc_block_pack, &t);
+
+        for (i = 0; i < BLOCK_COUNT; i++)
+          {
+             if (memcmp(ref + i * 8, blocks + i * 8, 8))
+               ck_abort_msg("quality %i: block %i differs from the scalar one", quality, i);
+             ck_assert_int_eq(ref_errors[i], errors[i]);
+          }
+     }
+
+   free(errors);
+   free(ref_errors);
+   free(blocks);
+   free(ref);
+   free(pixels);
+}
+EFL_END_TEST
+
+void eet_test_etc(TCase *tc)
+{
+   tcase_add_test(tc, eet_test_etc_scalar_parallel);
+}
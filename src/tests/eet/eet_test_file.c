@@ -2,8 +2,11 @@
 # include "config.h"
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 #include <Eina.h>
 #include <Eet.h>
@@ -448,10 +451,375 @@ EFL_START_TEST(eet_test_file_fp)
 }
 EFL_END_TEST
 
+#define EET_TEST_BASE_SIZE (64 * 1024)
+
+static long
+_eet_test_file_size(const char *file)
+{
+   struct stat st;
+
+   fail_if(stat(file, &st) != 0);
+   return (long)st.st_size;
+}
+
+static void
+_eet_test_file_entry_check(Eet_File *ef, const char *name, const char *expected)
+{
+   char *data;
+   int size;
+
+   data = eet_read(ef, name, &size);
+   if (!expected)
+     {
+        fail_if(data != NULL);
+        return;
+     }
+   fail_if(!data);
+   ck_assert_int_eq(size, strlen(expected) + 1);
+   ck_assert_str_eq(data, expected);
+   free(data);
+}
+
+/* a big incompressible entry, so journals stay smaller than the base */
+static char *
+_eet_test_file_base_create(const char *file)
+{
+   Eet_File *ef;
+   char *base;
+   int i;
+
+   base = malloc(EET_TEST_BASE_SIZE);
+   fail_if(!base);
+   for (i = 0; i < EET_TEST_BASE_SIZE; i++)
+     base[i] = (char)((i * 7919) ^ (i >> 5));
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_write(ef, "base", base, EET_TEST_BASE_SIZE, 0));
+   fail_if(!eet_write(ef, "keys/a", "a0", 3, 0));
+   fail_if(!eet_write(ef, "keys/b", "b0", 3, 0));
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+
+   return base;
+}
+
+static void
+_eet_test_file_base_check(Eet_File *ef, const char *base)
+{
+   void *data;
+   int size;
+
+   data = eet_read(ef, "base", &size);
+   fail_if(!data);
+   ck_assert_int_eq(size, EET_TEST_BASE_SIZE);
+   fail_if(memcmp(data, base, EET_TEST_BASE_SIZE) != 0);
+   free(data);
+}
+
+EFL_START_TEST(eet_test_file_journal)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+   Eet_5FP origin, *build;
+   Eet_File *ef;
+   char *file, *base;
+   long size, size2;
+   int tmpfd;
+
+   file = strdup("/tmp/eet_suite_testXXXXXX");
+   fail_if(-1 == (tmpfd = mkstemp(file)));
+   fail_if(!!close(tmpfd));
+
+   EET_EINA_FILE_DATA_DESCRIPTOR_CLASS_SET(&eddc, Eet_5FP);
+   edd = eet_data_descriptor_file_new(&eddc);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_5FP, "fp32", fp32, EET_T_F32P32);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_5FP, "f1", f1, EET_T_F32P32);
+   memset(&origin, 0, sizeof (origin));
+   origin.fp32 = eina_f32p32_double_from(1.125);
+   origin.f1 = eina_f32p32_int_from(1);
+
+   base = _eet_test_file_base_create(file);
+   size = _eet_test_file_size(file);
+
+   /* replace, add and delete, all appended to the file */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_journal_set(ef, EINA_TRUE));
+   fail_if(!eet_write(ef, "keys/a", "a1", 3, 0));
+   fail_if(!eet_write(ef, "keys/c", "c1", 3, 1));
+   fail_if(!eet_delete(ef, "keys/b"));
+   fail_if(!eet_data_write(ef, edd, "data", &origin, 1));
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+
+   size2 = _eet_test_file_size(file);
+   fail_if(size2 <= size);
+   fail_if(size2 - size > EET_TEST_BASE_SIZE / 4);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   _eet_test_file_base_check(ef, base);
+   _eet_test_file_entry_check(ef, "keys/a", "a1");
+   _eet_test_file_entry_check(ef, "keys/b", NULL);
+   _eet_test_file_entry_check(ef, "keys/c", "c1");
+   ck_assert_int_eq(eet_num_entries(ef), 4);
+   build = eet_data_read(ef, edd, "data");
+   fail_if(!build);
+   fail_if(build->fp32 != origin.fp32);
+   fail_if(build->f1 != origin.f1);
+   free(build);
+   eet_close(ef);
+
+   /* a second segment goes on top of the first one */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_journal_set(ef, EINA_TRUE));
+   _eet_test_file_entry_check(ef, "keys/a", "a1");
+   fail_if(!eet_write(ef, "keys/a", "a2", 3, 0));
+   fail_if(!eet_write(ef, "keys/b", "b2", 3, 0));
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+   fail_if(_eet_test_file_size(file) <= size2);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   _eet_test_file_base_check(ef, base);
+   _eet_test_file_entry_check(ef, "keys/a", "a2");
+   _eet_test_file_entry_check(ef, "keys/b", "b2");
+   _eet_test_file_entry_check(ef, "keys/c", "c1");
+   build = eet_data_read(ef, edd, "data");
+   fail_if(!build);
+   fail_if(build->fp32 != origin.fp32);
+   free(build);
+   eet_close(ef);
+
+   eet_data_descriptor_free(edd);
+   free(base);
+   fail_if(unlink(file) != 0);
+   free(file);
+}
+EFL_END_TEST
+
+EFL_START_TEST(eet_test_file_compact)
+{
+   Eet_File *ef;
+   char *file, *base;
+   char buf[32];
+   long size, size2;
+   int tmpfd, i;
+
+   file = strdup("/tmp/eet_suite_testXXXXXX");
+   fail_if(-1 == (tmpfd = mkstemp(file)));
+   fail_if(!!close(tmpfd));
+
+   base = _eet_test_file_base_create(file);
+   size = _eet_test_file_size(file);
+
+   for (i = 0; i < 8; i++)
+     {
+        ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+        fail_if(!ef);
+        fail_if(!eet_journal_set(ef, EINA_TRUE));
+        snprintf(buf, sizeof (buf), "a%i", i + 1);
+        fail_if(!eet_write(ef, "keys/a", buf, strlen(buf) + 1, 0));
+        fail_if(eet_close(ef) != EET_ERROR_NONE);
+     }
+   size2 = _eet_test_file_size(file);
+   fail_if(size2 <= size);
+
+   /* compaction drops the journal and the replaced entries */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(eet_compact(ef) != EET_ERROR_NONE);
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+   fail_if(_eet_test_file_size(file) >= size2);
+   ck_assert_int_eq(_eet_test_file_size(file), size);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   _eet_test_file_base_check(ef, base);
+   _eet_test_file_entry_check(ef, "keys/a", "a8");
+   _eet_test_file_entry_check(ef, "keys/b", "b0");
+   ck_assert_int_eq(eet_num_entries(ef), 3);
+   eet_close(ef);
+
+   free(base);
+   fail_if(unlink(file) != 0);
+   free(file);
+}
+EFL_END_TEST
+
+EFL_START_TEST(eet_test_file_compression_defer)
+{
+   Eet_File *ef;
+   char *file, *text, *noise, *data;
+   int tmpfd, size, i;
+
+   file = strdup("/tmp/eet_suite_testXXXXXX");
+   fail_if(-1 == (tmpfd = mkstemp(file)));
+   fail_if(!!close(tmpfd));
+
+   text = malloc(EET_TEST_BASE_SIZE);
+   noise = malloc(EET_TEST_BASE_SIZE);
+   fail_if(!text || !noise);
+   for (i = 0; i < EET_TEST_BASE_SIZE; i++)
+     {
+        text[i] = "deferred compression "[i % 21];
+        noise[i] = (char)((i * 7919) ^ (i >> 5));
+     }
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_compression_defer_set(ef, EINA_TRUE));
+   /* the data is not compressed yet, so its own size is returned */
+   ck_assert_int_eq(eet_write(ef, "text/zlib", text, EET_TEST_BASE_SIZE,
+                              EET_COMPRESSION_DEFAULT), EET_TEST_BASE_SIZE);
+   ck_assert_int_eq(eet_write(ef, "text/lz4", text, EET_TEST_BASE_SIZE,
+                              EET_COMPRESSION_VERYFAST), EET_TEST_BASE_SIZE);
+   ck_assert_int_eq(eet_write(ef, "noise", noise, EET_TEST_BASE_SIZE,
+                              EET_COMPRESSION_DEFAULT), EET_TEST_BASE_SIZE);
+   fail_if(!eet_write(ef, "small", "small", 6, EET_COMPRESSION_DEFAULT));
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+
+   /* both copies of the text shrank, the noise did not grow */
+   fail_if(_eet_test_file_size(file) > (EET_TEST_BASE_SIZE * 3) / 2);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   data = eet_read(ef, "text/zlib", &size);
+   fail_if(!data);
+   ck_assert_int_eq(size, EET_TEST_BASE_SIZE);
+   fail_if(memcmp(data, text, EET_TEST_BASE_SIZE) != 0);
+   free(data);
+   data = eet_read(ef, "text/lz4", &size);
+   fail_if(!data);
+   ck_assert_int_eq(size, EET_TEST_BASE_SIZE);
+   fail_if(memcmp(data, text, EET_TEST_BASE_SIZE) != 0);
+   free(data);
+   data = eet_read(ef, "noise", &size);
+   fail_if(!data);
+   ck_assert_int_eq(size, EET_TEST_BASE_SIZE);
+   fail_if(memcmp(data, noise, EET_TEST_BASE_SIZE) != 0);
+   free(data);
+   _eet_test_file_entry_check(ef, "small", "small");
+   eet_close(ef);
+
+   free(text);
+   free(noise);
+   fail_if(unlink(file) != 0);
+   free(file);
+}
+EFL_END_TEST
+
+static void
+_eet_test_file_journal_tail_check(const char *file, const char *base)
+{
+   Eet_File *ef;
+
+   eet_clearcache();
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   _eet_test_file_base_check(ef, base);
+   _eet_test_file_entry_check(ef, "keys/a", "a1");
+   _eet_test_file_entry_check(ef, "keys/b", NULL);
+   _eet_test_file_entry_check(ef, "keys/c", NULL);
+   eet_close(ef);
+}
+
+EFL_START_TEST(eet_test_file_journal_corrupt_tail)
+{
+   Eet_File *ef;
+   FILE *f;
+   char *file, *base;
+   char garbage[64];
+   unsigned int *hdr;
+   long size, size2;
+   int tmpfd;
+
+   file = strdup("/tmp/eet_suite_testXXXXXX");
+   fail_if(-1 == (tmpfd = mkstemp(file)));
+   fail_if(!!close(tmpfd));
+
+   base = _eet_test_file_base_create(file);
+
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_journal_set(ef, EINA_TRUE));
+   fail_if(!eet_write(ef, "keys/a", "a1", 3, 0));
+   fail_if(!eet_delete(ef, "keys/b"));
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+   size = _eet_test_file_size(file);
+
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_journal_set(ef, EINA_TRUE));
+   fail_if(!eet_write(ef, "keys/a", "a2", 3, 0));
+   fail_if(!eet_write(ef, "keys/c", "c2", 3, 0));
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+   size2 = _eet_test_file_size(file);
+   fail_if(size2 <= size);
+
+   /* a segment cut short is dropped, the previous one still applies */
+   fail_if(truncate(file, size2 - 5) != 0);
+   _eet_test_file_journal_tail_check(file, base);
+
+   /* same for a damaged header and for trailing garbage */
+   fail_if(truncate(file, size) != 0);
+   f = fopen(file, "ab");
+   fail_if(!f);
+   memset(garbage, 0xff, sizeof (garbage));
+   fail_if(fwrite(garbage, sizeof (garbage), 1, f) != 1);
+   fclose(f);
+   _eet_test_file_journal_tail_check(file, base);
+
+   /* a complete segment with one entry whose name is out of bounds */
+   fail_if(truncate(file, size) != 0);
+   f = fopen(file, "ab");
+   fail_if(!f);
+   memset(garbage, 0, sizeof (garbage));
+   hdr = (unsigned int *)garbage;
+   hdr[0] = eina_htonl(0x1ee7a9e1); /* segment magic */
+   hdr[1] = eina_htonl(1); /* directory entries */
+   hdr[2] = eina_htonl(0); /* dictionary entries */
+   hdr[3] = eina_htonl(sizeof (garbage)); /* segment size */
+   hdr[4] = eina_htonl(size + 48); /* data offset */
+   hdr[5] = eina_htonl(3); /* data size */
+   hdr[6] = eina_htonl(3);
+   hdr[7] = eina_htonl(0x7fff0000); /* name offset */
+   hdr[8] = eina_htonl(7); /* name size */
+   fail_if(size % 8); /* segments are aligned */
+   fail_if(fwrite(garbage, sizeof (garbage), 1, f) != 1);
+   fclose(f);
+   _eet_test_file_journal_tail_check(file, base);
+
+   /* writing again drops the damaged tail */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_journal_set(ef, EINA_TRUE));
+   fail_if(!eet_write(ef, "keys/c", "c3", 3, 0));
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+
+   eet_clearcache();
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+   _eet_test_file_base_check(ef, base);
+   _eet_test_file_entry_check(ef, "keys/a", "a1");
+   _eet_test_file_entry_check(ef, "keys/b", NULL);
+   _eet_test_file_entry_check(ef, "keys/c", "c3");
+   eet_close(ef);
+
+   free(base);
+   fail_if(unlink(file) != 0);
+   free(file);
+}
+EFL_END_TEST
+
 void eet_test_file(TCase *tc)
 {
    tcase_add_test(tc, eet_test_file_simple_write);
    tcase_add_test(tc, eet_test_file_data);
    tcase_add_test(tc, eet_test_file_data_dump);
    tcase_add_test(tc, eet_test_file_fp);
+   tcase_add_test(tc, eet_test_file_journal);
+   tcase_add_test(tc, eet_test_file_compact);
+   tcase_add_test(tc, eet_test_file_compression_defer);
+   tcase_add_test(tc, eet_test_file_journal_corrupt_tail);
 }
@@ -420,6 +420,245 @@ EFL_START_TEST(eina_test_hash_add_del_by_hash)
 }
 EFL_END_TEST
 
+EFL_START_TEST(eina_test_hash_flat_simple)
+{
+   Eina_Hash *hash = NULL;
+   int *test;
+   int array[] = { 1, 42, 4, 5, 6 };
+
+   hash = eina_hash_string_flat_new(NULL);
+   fail_if(hash == NULL);
+
+   fail_if(eina_hash_add(hash, "1", &array[0]) != EINA_TRUE);
+   fail_if(eina_hash_add(hash, "42", &array[1]) != EINA_TRUE);
+   fail_if(eina_hash_direct_add(hash, "4", &array[2]) != EINA_TRUE);
+   fail_if(eina_hash_direct_add(hash, "5", &array[3]) != EINA_TRUE);
+   fail_if(eina_hash_add(hash, "", "") != EINA_TRUE);
+
+   test = eina_hash_find(hash, "4");
+   fail_if(!test);
+   fail_if(*test != 4);
+
+   test = eina_hash_find(hash, "42");
+   fail_if(!test);
+   fail_if(*test != 42);
+
+   eina_hash_foreach(hash, eina_foreach_check, NULL);
+
+   test = eina_hash_modify(hash, "5", &array[4]);
+   fail_if(!test);
+   fail_if(*test != 5);
+
+   test = eina_hash_find(hash, "5");
+   fail_if(!test);
+   fail_if(*test != 6);
+
+   test = eina_hash_set(hash, "1", &array[2]);
+   fail_if(!test);
+   fail_if(*test != 1);
+   fail_if(eina_hash_find(hash, "1") != &array[2]);
+
+   fail_if(eina_hash_population(hash) != 5);
+
+   fail_if(eina_hash_find(hash, "120") != NULL);
+
+   fail_if(eina_hash_del(hash, "5", NULL) != EINA_TRUE);
+   fail_if(eina_hash_find(hash, "5") != NULL);
+
+   fail_if(eina_hash_del(hash, "4", NULL) != EINA_TRUE);
+   fail_if(eina_hash_find(hash, "4") != NULL);
+
+   fail_if(eina_hash_del(hash, NULL, &array[2]) != EINA_TRUE);
+   fail_if(eina_hash_find(hash, "1") != NULL);
+
+   fail_if(eina_hash_del(hash, NULL, &array[2]) != EINA_FALSE);
+
+   fail_if(eina_hash_del(hash, "42", NULL) != EINA_TRUE);
+   fail_if(eina_hash_del(hash, "", NULL) != EINA_TRUE);
+   fail_if(eina_hash_population(hash) != 0);
+
+   /* the table is released once empty, it has to come back on add */
+   fail_if(eina_hash_add(hash, "42", &array[1]) != EINA_TRUE);
+   fail_if(eina_hash_find(hash, "42") != &array[1]);
+
+   eina_hash_free(hash);
+}
+EFL_END_TEST
+
+EFL_START_TEST(eina_test_hash_flat_by_hash)
+{
+   Eina_Hash *hash = NULL;
+   int array[] = { 1, 42, 4, 5, 6 };
+   int key_len, key_hash;
+
+   hash = eina_hash_flat_new(EINA_KEY_LENGTH(_eina_string_key_length),
+                             EINA_KEY_CMP(_eina_string_key_cmp),
+                             EINA_KEY_HASH(eina_hash_crc),
+                             NULL);
+   fail_if(hash == NULL);
+   fail_if(eina_hash_add(hash, "1", &array[0]) != EINA_TRUE);
+   fail_if(eina_hash_add(hash, "42", &array[1]) != EINA_TRUE);
+
+   key_len = _eina_string_key_length("4");
+   key_hash = eina_hash_crc("4", key_len);
+
+   fail_if(eina_hash_add_by_hash(hash, "4", key_len, key_hash, &array[2]) != EINA_TRUE);
+   fail_if(eina_hash_find_by_hash(hash, "4", key_len, key_hash) != &array[2]);
+   fail_if(eina_hash_find(hash, "4") != &array[2]);
+   fail_if(eina_hash_modify_by_hash(hash, "4", key_len, key_hash, &array[3]) != &array[2]);
+   fail_if(eina_hash_del_by_hash(hash, "4", key_len, key_hash, &array[3]) != EINA_TRUE);
+   fail_if(eina_hash_del_by_hash(hash, "4", key_len, key_hash, &array[3]) != EINA_FALSE);
+   fail_if(eina_hash_find(hash, "4") != NULL);
+
+   fail_if(eina_hash_population(hash) != 2);
+   eina_hash_free(hash);
+}
+EFL_END_TEST
+
+#define FLAT_KEYS 50000
+
+static void
+_eina_test_hash_flat_key(char *buf, unsigned int i)
+{
+   snprintf(buf, 16, "k%u", i);
+}
+
+EFL_START_TEST(eina_test_hash_flat_grow)
+{
+   Eina_Hash *hash = NULL;
+   Eina_Iterator *it;
+   char key[16];
+   unsigned int i, count;
+   void *data;
+   uintptr_t sum, expected;
+
+   hash = eina_hash_string_flat_new(NULL);
+   fail_if(hash == NULL);
+
+   /* grow through many rehashes and check nothing got lost on the way */
+   for (i = 0; i < FLAT_KEYS; i++)
+     {
+        _eina_test_hash_flat_key(key, i);
+        fail_if(eina_hash_add(hash, key, (void *)(uintptr_t)(i + 1)) != EINA_TRUE);
+        if ((i & (i + 1)) == 0)
+          {
+             unsigned int j;
+
+             for (j = 0; j <= i; j++)
+               {
+                  _eina_test_hash_flat_key(key, j);
+                  fail_if(eina_hash_find(hash, key) != (void *)(uintptr_t)(j + 1));
+               }
+          }
+     }
+   ck_assert_int_eq(eina_hash_population(hash), FLAT_KEYS);
+
+   it = eina_hash_iterator_data_new(hash);
+   count = 0;
+   sum = 0;
+   EINA_ITERATOR_FOREACH(it, data)
+     {
+        count++;
+        sum += (uintptr_t)data;
+     }
+   eina_iterator_free(it);
+   expected = ((uintptr_t)FLAT_KEYS * (FLAT_KEYS + 1)) / 2;
+   ck_assert_int_eq(count, FLAT_KEYS);
+   fail_if(sum != expected);
+
+   /* churn so the table fills with tombstones and rehashes in place */
+   for (i = 0; i < FLAT_KEYS; i += 2)
+     {
+        _eina_test_hash_flat_key(key, i);
+        fail_if(eina_hash_del_by_key(hash, key) != EINA_TRUE);
+     }
+   ck_assert_int_eq(eina_hash_population(hash), FLAT_KEYS / 2);
+   for (i = FLAT_KEYS; i < FLAT_KEYS + (FLAT_KEYS / 2); i++)
+     {
+        _eina_test_hash_flat_key(key, i);
+        fail_if(eina_hash_add(hash, key, (void *)(uintptr_t)(i + 1)) != EINA_TRUE);
+     }
+   ck_assert_int_eq(eina_hash_population(hash), FLAT_KEYS);
+   for (i = 0; i < FLAT_KEYS + (FLAT_KEYS / 2); i++)
+     {
+        _eina_test_hash_flat_key(key, i);
+        if ((i < FLAT_KEYS) && !(i & 1))
+          fail_if(eina_hash_find(hash, key) != NULL);
+        else
+          fail_if(eina_hash_find(hash, key) != (void *)(uintptr_t)(i + 1));
+     }
+
+   eina_hash_free(hash);
+}
+EFL_END_TEST
+
+static Eina_Bool
+_eina_test_hash_flat_del_cb(const Eina_Hash *hash, const void *key,
+                            void *data, void *fdata)
+{
+   unsigned int *seen = fdata;
+
+   (*seen)++;
+   /* drop every odd value, the one being visited included */
+   if ((uintptr_t)data & 1)
+     fail_if(eina_hash_del_by_key((Eina_Hash *)hash, key) != EINA_TRUE);
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eina_test_hash_flat_del_all_cb(const Eina_Hash *hash, const void *key,
+                                void *data EINA_UNUSED, void *fdata)
+{
+   unsigned int *seen = fdata;
+
+   (*seen)++;
+   fail_if(eina_hash_del_by_key((Eina_Hash *)hash, key) != EINA_TRUE);
+   return EINA_TRUE;
+}
+
+EFL_START_TEST(eina_test_hash_flat_del_iterate)
+{
+   Eina_Hash *hash = NULL;
+   Eina_Iterator *it;
+   Eina_Hash_Tuple *t;
+   char key[16];
+   unsigned int i, seen;
+
+   hash = eina_hash_string_flat_new(NULL);
+   fail_if(hash == NULL);
+   for (i = 1; i <= 1000; i++)
+     {
+        _eina_test_hash_flat_key(key, i);
+        fail_if(eina_hash_add(hash, key, (void *)(uintptr_t)i) != EINA_TRUE);
+     }
+
+   seen = 0;
+   eina_hash_foreach(hash, _eina_test_hash_flat_del_cb, &seen);
+   ck_assert_int_eq(seen, 1000);
+   ck_assert_int_eq(eina_hash_population(hash), 500);
+
+   seen = 0;
+   it = eina_hash_iterator_tuple_new(hash);
+   EINA_ITERATOR_FOREACH(it, t)
+     {
+        fail_if((uintptr_t)t->data & 1);
+        _eina_test_hash_flat_key(key, (uintptr_t)t->data);
+        ck_assert_str_eq(t->key, key);
+        seen++;
+     }
+   eina_iterator_free(it);
+   ck_assert_int_eq(seen, 500);
+
+   /* emptying the table from the callback releases it under the iterator */
+   seen = 0;
+   eina_hash_foreach(hash, _eina_test_hash_flat_del_all_cb, &seen);
+   ck_assert_int_eq(seen, 500);
+   ck_assert_int_eq(eina_hash_population(hash), 0);
+
+   eina_hash_free(hash);
+}
+EFL_END_TEST
+
 void
 eina_test_hash(TCase *tc)
 {
@@ -433,5 +672,9 @@ eina_test_hash(TCase *tc)
    tcase_add_test(tc, eina_test_hash_int64_fuzze);
    tcase_add_test(tc, eina_test_hash_string_fuzze);
    tcase_add_test(tc, eina_test_hash_add_del_by_hash);
+   tcase_add_test(tc, eina_test_hash_flat_simple);
+   tcase_add_test(tc, eina_test_hash_flat_by_hash);
+   tcase_add_test(tc, eina_test_hash_flat_grow);
+   tcase_add_test(tc, eina_test_hash_flat_del_iterate);
 }
 
@@ -75,6 +75,66 @@ EFL_START_TEST(eina_mempool_chained_mempool)
    _eina_mempool_test(mp, EINA_FALSE, EINA_FALSE, EINA_TRUE);
 }
 EFL_END_TEST
+
+typedef struct _Eina_Mempool_Thread_Job
+{
+   Eina_Mempool *mp;
+   int **tbl;
+} Eina_Mempool_Thread_Job;
+
+static void *
+_eina_mempool_thread_free(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Eina_Mempool_Thread_Job *job = data;
+   int i;
+
+   for (i = 0; i < 512; ++i)
+     eina_mempool_free(job->mp, job->tbl[i]);
+   return NULL;
+}
+
+EFL_START_TEST(eina_mempool_chained_mempool_threads)
+{
+   Eina_Mempool_Thread_Job job;
+   Eina_Mempool *mp;
+   Eina_Thread t;
+   int *tbl[512];
+   int i;
+
+   mp = eina_mempool_add("chained_mempool", "test", NULL, sizeof (int), 256);
+   fail_if(!mp);
+
+   for (i = 0; i < 512; ++i)
+     {
+        tbl[i] = eina_mempool_malloc(mp, sizeof (int));
+        fail_if(!tbl[i]);
+        *tbl[i] = i;
+     }
+   job.mp = mp;
+   job.tbl = tbl;
+
+   // freed by another thread, that gives them back to the pool when it exits
+   fail_if(!eina_thread_create(&t, EINA_THREAD_NORMAL, -1,
+                               _eina_mempool_thread_free, &job));
+   eina_thread_join(t);
+
+   for (i = 0; i < 512; ++i)
+     fail_if(eina_mempool_from(mp, tbl[i]) != EINA_FALSE);
+
+   for (i = 0; i < 512; ++i)
+     {
+        tbl[i] = eina_mempool_malloc(mp, sizeof (int));
+        fail_if(!tbl[i]);
+        fail_if(eina_mempool_from(mp, tbl[i]) != EINA_TRUE);
+     }
+   eina_mempool_statistics(mp);
+
+   for (i = 0; i < 512; ++i)
+     eina_mempool_free(mp, tbl[i]);
+
+   eina_mempool_del(mp);
+}
+EFL_END_TEST
 #endif
 
 #ifdef EINA_BUILD_PASS_THROUGH
@@ -93,6 +153,7 @@ eina_test_mempool(TCase *tc)
 {
 #ifdef EINA_BUILD_CHAINED_POOL
    tcase_add_test(tc, eina_mempool_chained_mempool);
+   tcase_add_test(tc, eina_mempool_chained_mempool_threads);
 #endif
 #ifdef EINA_BUILD_PASS_THROUGH
    tcase_add_test(tc, eina_mempool_pass_through);
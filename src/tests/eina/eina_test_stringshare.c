@@ -240,3 +240,25 @@ EINA_TEST_START(eina_stringshare_print)
    eina_stringshare_del(t3);
 }
 EINA_TEST_END
+
+EINA_TEST_START(eina_stringshare_stats)
+{
+   Eina_Stringshare_Stats before, after;
+   const char *t0;
+
+   fail_if(!eina_stringshare_stats_get(&before));
+   fail_if(before.shards == 0);
+   fail_if(before.shard_max > before.strings);
+
+   t0 = eina_stringshare_add("stats/" TEST0);
+   fail_if(!eina_stringshare_stats_get(&after));
+   fail_if(after.strings != before.strings + 1);
+   fail_if(after.lookups <= before.lookups);
+   fail_if(after.shard_max > after.strings);
+   fail_if(after.contended > after.lookups);
+
+   fail_if(t0 != eina_stringshare_add("stats/" TEST0));
+   eina_stringshare_del(t0);
+   eina_stringshare_del(t0);
+}
+EINA_TEST_END
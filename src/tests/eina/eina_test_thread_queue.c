@@ -0,0 +1,130 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <Eina.h>
+
+#include "eina_suite.h"
+
+#define MPSC_SENDERS 16
+#define MPSC_COUNT 20000
+
+typedef struct
+{
+   Eina_Thread_Queue_Msg head;
+   int                   sender;
+   int                   value;
+   int                   len;
+   unsigned char         payload[1];
+} Msg;
+
+static Eina_Thread_Queue *thq;
+static Eina_Barrier barrier;
+
+static unsigned char
+_payload_byte(int sender, int value, int i)
+{
+   return (unsigned char)((sender * 31) + (value * 7) + i);
+}
+
+static void *
+_mpsc_sender(void *data, Eina_Thread t EINA_UNUSED)
+{
+   int sender = (int)(uintptr_t)data, i, j;
+
+   eina_barrier_wait(&barrier);
+   for (i = 0; i < MPSC_COUNT; i++)
+     {
+        Msg *msg;
+        void *ref;
+        // mostly small messages so blocks fill up and get swapped all the
+        // time, with the odd big one that needs a block of its own
+        int len = ((i % 257) == 0) ? 6000 : ((i * 13 + sender) % 96);
+
+        msg = eina_thread_queue_send(thq, sizeof(Msg) + len, &ref);
+        if (!msg) return (void *)1;
+        msg->sender = sender;
+        msg->value = i;
+        msg->len = len;
+        for (j = 0; j < len; j++)
+          msg->payload[j] = _payload_byte(sender, i, j);
+        eina_thread_queue_send_done(thq, ref);
+        if ((i % 1000) == 0) usleep(1);
+     }
+   return NULL;
+}
+
+static void
+_mpsc_read(Eina_Bool blocking)
+{
+   Eina_Thread th[MPSC_SENDERS];
+   int last[MPSC_SENDERS];
+   int i, j, msgcnt;
+
+   thq = eina_thread_queue_mpsc_new();
+   fail_if(!thq);
+   fail_if(!eina_barrier_new(&barrier, MPSC_SENDERS + 1));
+   for (i = 0; i < MPSC_SENDERS; i++)
+     {
+        last[i] = -1;
+        fail_if(!eina_thread_create(&(th[i]), EINA_THREAD_NORMAL, -1,
+                                    _mpsc_sender, (void *)(uintptr_t)i));
+     }
+   eina_barrier_wait(&barrier);
+   for (msgcnt = 0; msgcnt < (MPSC_SENDERS * MPSC_COUNT); msgcnt++)
+     {
+        Msg *msg;
+        void *ref;
+
+        if (blocking) msg = eina_thread_queue_wait(thq, &ref);
+        else
+          {
+             while (!(msg = eina_thread_queue_poll(thq, &ref)))
+               usleep(1);
+          }
+        fail_if(!msg);
+        fail_if((msg->sender < 0) || (msg->sender >= MPSC_SENDERS));
+        ck_assert_int_eq(msg->value, last[msg->sender] + 1);
+        last[msg->sender] = msg->value;
+        // a message written into a block that was freed and reused
+        // under the sender shows up as a damaged payload
+        for (j = 0; j < msg->len; j++)
+          {
+             if (msg->payload[j] != _payload_byte(msg->sender, msg->value, j))
+               ck_abort_msg("payload of msg %i from sender %i damaged at %i",
+                            msg->value, msg->sender, j);
+          }
+        eina_thread_queue_wait_done(thq, ref);
+     }
+   for (i = 0; i < MPSC_SENDERS; i++)
+     {
+        fail_if(eina_thread_join(th[i]) != NULL);
+        ck_assert_int_eq(last[i], MPSC_COUNT - 1);
+     }
+   fail_if(eina_thread_queue_pending_get(thq) != 0);
+   eina_barrier_free(&barrier);
+   eina_thread_queue_free(thq);
+   thq = NULL;
+}
+
+EFL_START_TEST(eina_thread_queue_test_mpsc_stress_wait)
+{
+   _mpsc_read(EINA_TRUE);
+}
+EFL_END_TEST
+
+EFL_START_TEST(eina_thread_queue_test_mpsc_stress_poll)
+{
+   _mpsc_read(EINA_FALSE);
+}
+EFL_END_TEST
+
+void
+eina_test_thread_queue(TCase *tc)
+{
+   tcase_add_test(tc, eina_thread_queue_test_mpsc_stress_wait);
+   tcase_add_test(tc, eina_thread_queue_test_mpsc_stress_poll);
+}
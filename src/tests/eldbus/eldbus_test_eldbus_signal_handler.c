@@ -447,6 +447,244 @@ EFL_START_TEST(utc_eldbus_signal_handler_free_cb_add_del_p)
 }
 EFL_END_TEST
 
+/* more handlers than the dispatcher keeps on its stack, spread over the
+ * (interface, member), (interface, *) and wildcard buckets and over a path
+ * and no path */
+#define DISPATCH_HANDLERS 70
+
+static const char *dispatch_path = "/org/enlightenment/eldbus/test";
+static const char *dispatch_interface = "org.enlightenment.eldbus.Test";
+static const char *dispatch_signal = "Dispatch";
+
+static Eldbus_Signal_Handler *dispatch_handlers[DISPATCH_HANDLERS];
+static int dispatch_calls[DISPATCH_HANDLERS];
+static int dispatch_last;
+static Eina_Bool dispatch_ordered;
+static Eldbus_Signal_Handler *dispatch_added;
+static int dispatch_added_calls;
+
+static Eina_Bool
+_dispatch_signal_is(const Eldbus_Message *msg)
+{
+   // the wildcard handlers also get what the bus itself sends
+   return !strcmp(eldbus_message_member_get(msg), dispatch_signal);
+}
+
+static void
+_dispatch_cb(void *data, const Eldbus_Message *msg)
+{
+   int i = (int)(intptr_t)data;
+
+   if (!_dispatch_signal_is(msg)) return;
+   if (i <= dispatch_last) dispatch_ordered = EINA_FALSE;
+   dispatch_last = i;
+   dispatch_calls[i]++;
+   // the last one, the others of this signal were called before
+   if (i == DISPATCH_HANDLERS - 1) ecore_main_loop_quit();
+}
+
+static void
+_dispatch_del_cb(void *data, const Eldbus_Message *msg)
+{
+   int i;
+
+   if (!_dispatch_signal_is(msg)) return;
+   _dispatch_cb(data, msg);
+   // the handlers after this one in this very dispatch, and itself
+   for (i = 0; i < DISPATCH_HANDLERS / 2; i++)
+     {
+        eldbus_signal_handler_del(dispatch_handlers[i]);
+        dispatch_handlers[i] = NULL;
+     }
+}
+
+static void
+_dispatch_added_cb(void *data EINA_UNUSED, const Eldbus_Message *msg)
+{
+   if (!_dispatch_signal_is(msg)) return;
+   // added last, so called last
+   if (dispatch_last != DISPATCH_HANDLERS - 1) dispatch_ordered = EINA_FALSE;
+   dispatch_added_calls++;
+}
+
+static void
+_dispatch_add_cb(void *data, const Eldbus_Message *msg)
+{
+   Eldbus_Connection *conn;
+
+   if (!_dispatch_signal_is(msg)) return;
+   _dispatch_cb(data, msg);
+   if (dispatch_added) return;
+   conn = eldbus_signal_handler_connection_get(dispatch_handlers[0]);
+   dispatch_added = eldbus_signal_handler_add(conn, NULL, dispatch_path,
+                                              dispatch_interface, dispatch_signal,
+                                              _dispatch_added_cb, NULL);
+}
+
+static void
+_dispatch_handlers_add(Eldbus_Connection *conn, Eldbus_Signal_Cb first_cb)
+{
+   int i;
+
+   memset(dispatch_calls, 0, sizeof(dispatch_calls));
+   dispatch_added = NULL;
+   dispatch_added_calls = 0;
+   for (i = 0; i < DISPATCH_HANDLERS; i++)
+     {
+        Eldbus_Signal_Cb cb = i ? _dispatch_cb : first_cb;
+        void *data = (void *)(intptr_t)i;
+
+        switch (i % 4)
+          {
+           case 0:
+             dispatch_handlers[i] = eldbus_signal_handler_add
+               (conn, NULL, dispatch_path, dispatch_interface, dispatch_signal, cb, data);
+             break;
+           case 1:
+             dispatch_handlers[i] = eldbus_signal_handler_add
+               (conn, NULL, NULL, dispatch_interface, dispatch_signal, cb, data);
+             break;
+           case 2:
+             dispatch_handlers[i] = eldbus_signal_handler_add
+               (conn, NULL, NULL, dispatch_interface, NULL, cb, data);
+             break;
+           default:
+             dispatch_handlers[i] = eldbus_signal_handler_add
+               (conn, NULL, NULL, NULL, NULL, cb, data);
+             break;
+          }
+        ck_assert_ptr_ne(NULL, dispatch_handlers[i]);
+     }
+}
+
+static void
+_dispatch_handlers_del(void)
+{
+   int i;
+
+   for (i = 0; i < DISPATCH_HANDLERS; i++)
+     {
+        if (dispatch_handlers[i]) eldbus_signal_handler_del(dispatch_handlers[i]);
+        dispatch_handlers[i] = NULL;
+     }
+   if (dispatch_added) eldbus_signal_handler_del(dispatch_added);
+   dispatch_added = NULL;
+}
+
+static void
+_dispatch_signal_send(Eldbus_Connection *conn)
+{
+   Eldbus_Message *msg;
+
+   dispatch_last = -1;
+   dispatch_ordered = EINA_TRUE;
+
+   msg = eldbus_message_signal_new(dispatch_path, dispatch_interface, dispatch_signal);
+   ck_assert_ptr_ne(NULL, msg);
+   // no reply to wait for, so there is no pending either
+   eldbus_connection_send(conn, msg, NULL, NULL, -1);
+
+   timeout = ecore_timer_add(5.0, _ecore_loop_close, NULL);
+   ck_assert_ptr_ne(NULL, timeout);
+   ecore_main_loop_begin();
+   if (timeout) ecore_timer_del(timeout);
+   timeout = NULL;
+
+   ck_assert_msg(dispatch_ordered, "Handlers were not called in the order they were added");
+}
+
+/**
+ * @addtogroup eldbus_signal_handler
+ * @{
+ * @defgroup eldbus_signal_handler_del_dispatch eldbus_signal_handler_del() from a callback
+ * @{
+ * @objective Positive test case checks that a signal handler callback can delete
+ * handlers of the signal being dispatched, itself included.
+ *
+ * @procedure
+ * @step 1 Add more handlers than the dispatcher keeps on its stack for one signal,
+ * with and without path, interface or member. The first one deletes the first half.
+ * @step 2 Send the signal, check the deleted handlers after the first one were not
+ * called, the others once and in the order they were added.
+ * @step 3 Send the signal again, check only the remaining handlers were called.
+ *
+ * @passcondition Deleted handlers are never called, the others are called in order.
+ * @}
+ * @}
+ */
+EFL_START_TEST(utc_eldbus_signal_handler_del_dispatch_p)
+{
+   int i;
+
+   Eldbus_Connection *conn = eldbus_connection_get(ELDBUS_CONNECTION_TYPE_SESSION);
+   ck_assert_ptr_ne(NULL, conn);
+
+   _dispatch_handlers_add(conn, _dispatch_del_cb);
+
+   _dispatch_signal_send(conn);
+   for (i = 0; i < DISPATCH_HANDLERS; i++)
+     {
+        int expected = ((i > 0) && (i < DISPATCH_HANDLERS / 2)) ? 0 : 1;
+        ck_assert_msg(dispatch_calls[i] == expected,
+                      "handler %d called %d times", i, dispatch_calls[i]);
+     }
+
+   _dispatch_signal_send(conn);
+   for (i = 0; i < DISPATCH_HANDLERS; i++)
+     {
+        int expected = (i == 0) ? 1 : (i < DISPATCH_HANDLERS / 2) ? 0 : 2;
+        ck_assert_msg(dispatch_calls[i] == expected,
+                      "handler %d called %d times", i, dispatch_calls[i]);
+     }
+
+   _dispatch_handlers_del();
+   eldbus_connection_unref(conn);
+}
+EFL_END_TEST
+
+/**
+ * @addtogroup eldbus_signal_handler
+ * @{
+ * @defgroup eldbus_signal_handler_add_dispatch eldbus_signal_handler_add() from a callback
+ * @{
+ * @objective Positive test case checks that a handler added by a signal handler
+ * callback only gets the next signals.
+ *
+ * @procedure
+ * @step 1 Add handlers for one signal, the first one adds another handler for it.
+ * @step 2 Send the signal, check the added handler was not called.
+ * @step 3 Send the signal again, check the added handler was called once, after
+ * all the others.
+ *
+ * @passcondition The added handler does not see the signal being dispatched.
+ * @}
+ * @}
+ */
+EFL_START_TEST(utc_eldbus_signal_handler_add_dispatch_p)
+{
+   int i;
+
+   Eldbus_Connection *conn = eldbus_connection_get(ELDBUS_CONNECTION_TYPE_SESSION);
+   ck_assert_ptr_ne(NULL, conn);
+
+   _dispatch_handlers_add(conn, _dispatch_add_cb);
+
+   _dispatch_signal_send(conn);
+   ck_assert_ptr_ne(NULL, dispatch_added);
+   ck_assert_int_eq(dispatch_added_calls, 0);
+   for (i = 0; i < DISPATCH_HANDLERS; i++)
+     ck_assert_int_eq(dispatch_calls[i], 1);
+
+   _dispatch_signal_send(conn);
+   ck_assert_int_eq(dispatch_added_calls, 1);
+   for (i = 0; i < DISPATCH_HANDLERS; i++)
+     ck_assert_int_eq(dispatch_calls[i], 2);
+
+   _dispatch_handlers_del();
+   eldbus_connection_unref(conn);
+}
+EFL_END_TEST
+
 /**
  *@}
  */
@@ -458,4 +696,6 @@ eldbus_test_eldbus_signal_handler(TCase *tc)
    tcase_add_test(tc, utc_eldbus_signal_handler_get_p);
    tcase_add_test(tc, utc_eldbus_signal_handler_ref_unref_p);
    tcase_add_test(tc, utc_eldbus_signal_handler_free_cb_add_del_p);
+   tcase_add_test(tc, utc_eldbus_signal_handler_del_dispatch_p);
+   tcase_add_test(tc, utc_eldbus_signal_handler_add_dispatch_p);
 }
@@ -203,12 +203,81 @@ EFL_START_TEST(elm_gengrid_item_content)
 }
 EFL_END_TEST
 
+static void
+_item_cache_stats_quit(void *data EINA_UNUSED)
+{
+   ecore_main_loop_quit();
+}
+
+static void
+_item_cache_stats_realized(void *data, Evas_Object *obj EINA_UNUSED, void *event_info)
+{
+   Elm_Object_Item **wanted = data;
+
+   if (event_info != *wanted) return;
+   *wanted = NULL;
+   // the other items of this pass are realized by then
+   ecore_job_add(_item_cache_stats_quit, NULL);
+}
+
+EFL_START_TEST(elm_gengrid_item_cache_stats)
+{
+   Evas_Object *win, *gengrid;
+   Elm_Gengrid_Item_Class *gtc;
+   Elm_Object_Item *first = NULL, *last = NULL, *wanted;
+   unsigned int hits, misses;
+   int i;
+
+   gtc = elm_gengrid_item_class_new();
+   gtc->item_style = "default";
+
+   win = win_add(NULL, "gengrid", ELM_WIN_BASIC);
+
+   gengrid = elm_gengrid_add(win);
+   elm_gengrid_item_size_set(gengrid, 50, 50);
+   for (i = 0; i < 200; i++)
+     {
+        last = elm_gengrid_item_append(gengrid, gtc, NULL, NULL, NULL);
+        if (!first) first = last;
+     }
+   evas_object_smart_callback_add(gengrid, "realized", _item_cache_stats_realized, &wanted);
+
+   elm_gengrid_item_cache_stats_get(gengrid, &hits, &misses);
+   ck_assert_int_eq(hits, 0);
+   ck_assert_int_eq(misses, 0);
+
+   evas_object_resize(gengrid, 100, 100);
+   evas_object_resize(win, 100, 100);
+   evas_object_show(gengrid);
+   evas_object_show(win);
+
+   // nothing cached yet, every view is created
+   wanted = first;
+   ecore_main_loop_begin();
+   elm_gengrid_item_cache_stats_get(gengrid, &hits, &misses);
+   ck_assert_int_gt(misses, 0);
+
+   // the views of the first items go to the cache
+   wanted = last;
+   elm_gengrid_item_show(last, ELM_GENGRID_ITEM_SCROLLTO_TOP);
+   ecore_main_loop_begin();
+
+   // and come back from it
+   wanted = first;
+   elm_gengrid_item_show(first, ELM_GENGRID_ITEM_SCROLLTO_TOP);
+   ecore_main_loop_begin();
+   elm_gengrid_item_cache_stats_get(gengrid, &hits, NULL);
+   ck_assert_int_gt(hits, 0);
+}
+EFL_END_TEST
+
 void elm_test_gengrid(TCase *tc)
 {
    tcase_add_test(tc, elm_gengrid_legacy_type_check);
    tcase_add_test(tc, elm_atspi_role_get);
    tcase_add_test(tc, elm_gengrid_focus);
    tcase_add_test(tc, elm_gengrid_item_content);
+   tcase_add_test(tc, elm_gengrid_item_cache_stats);
 #if 0
    tcase_add_test(tc, elm_atspi_children_parent);
 #endif
@@ -565,6 +565,69 @@ EFL_START_TEST(elm_genlist_test_focus_state)
 }
 EFL_END_TEST
 
+static void
+_cache_stats_quit(void *data EINA_UNUSED)
+{
+   ecore_main_loop_quit();
+}
+
+static void
+_cache_stats_realized(void *data, Evas_Object *obj EINA_UNUSED, void *event_info)
+{
+   Elm_Object_Item **wanted = data;
+
+   if (event_info != *wanted) return;
+   *wanted = NULL;
+   // the other items of this pass are realized by then
+   ecore_job_add(_cache_stats_quit, NULL);
+}
+
+EFL_START_TEST(elm_genlist_test_item_cache_stats)
+{
+   Elm_Object_Item *first = NULL, *last = NULL, *wanted;
+   unsigned int hits, misses;
+   int i;
+
+   win = win_add(NULL, "genlist", ELM_WIN_BASIC);
+
+   genlist = elm_genlist_add(win);
+   elm_genlist_homogeneous_set(genlist, EINA_TRUE);
+   for (i = 0; i < 200; i++)
+     {
+        last = elm_genlist_item_append(genlist, &itc, NULL, NULL, 0, NULL, NULL);
+        if (!first) first = last;
+     }
+   evas_object_smart_callback_add(genlist, "realized", _cache_stats_realized, &wanted);
+
+   elm_genlist_item_cache_stats_get(genlist, &hits, &misses);
+   ck_assert_int_eq(hits, 0);
+   ck_assert_int_eq(misses, 0);
+
+   evas_object_resize(genlist, 100, 100);
+   evas_object_show(genlist);
+   evas_object_resize(win, 100, 100);
+   evas_object_show(win);
+
+   // nothing cached yet, every view is created
+   wanted = first;
+   ecore_main_loop_begin();
+   elm_genlist_item_cache_stats_get(genlist, &hits, &misses);
+   ck_assert_int_gt(misses, 0);
+
+   // the views of the first items go to the cache
+   wanted = last;
+   elm_genlist_item_show(last, ELM_GENLIST_ITEM_SCROLLTO_TOP);
+   ecore_main_loop_begin();
+
+   // and come back from it
+   wanted = first;
+   elm_genlist_item_show(first, ELM_GENLIST_ITEM_SCROLLTO_TOP);
+   ecore_main_loop_begin();
+   elm_genlist_item_cache_stats_get(genlist, &hits, NULL);
+   ck_assert_int_gt(hits, 0);
+}
+EFL_END_TEST
+
 void elm_test_genlist(TCase *tc)
 {
    tcase_add_test(tc, elm_genlist_test_legacy_type_check);
@@ -580,4 +643,5 @@ void elm_test_genlist(TCase *tc)
 
    tcase_add_test(tc, elm_genlist_test_focus_state);
    tcase_add_test(tc, elm_genlist_test_tree_expand);
+   tcase_add_test(tc, elm_genlist_test_item_cache_stats);
 }
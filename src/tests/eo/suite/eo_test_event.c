@@ -185,12 +185,61 @@ EFL_START_TEST(eo_event_generation_bug)
 }
 EFL_END_TEST
 
+static void
+_cb_count(void *data, const Efl_Event *event EINA_UNUSED)
+{
+   int *called = data;
+
+   (*called)++;
+}
+
+EFL_START_TEST(eo_event_call_no_match)
+{
+   Eo *obj;
+   int called = 0;
+
+   obj = efl_add_ref(efl_test_event_class_get(), NULL);
+   efl_event_callback_add(obj, EFL_TEST_EVENT_EVENT_TESTER_SUBSCRIBE, _cb_count, &called);
+
+   // nobody listens to this event, the emission was not stopped either
+   ck_assert_int_eq(efl_event_callback_call(obj, EFL_TEST_EVENT_EVENT_TESTER, NULL), EINA_TRUE);
+   ck_assert_int_eq(called, 0);
+   ck_assert_int_eq(efl_event_callback_call(obj, EFL_TEST_EVENT_EVENT_TESTER_SUBSCRIBE, NULL), EINA_TRUE);
+   ck_assert_int_eq(called, 1);
+
+   efl_unref(obj);
+}
+EFL_END_TEST
+
+EFL_START_TEST(eo_event_forwarder_no_match)
+{
+   Eo *src, *dst;
+   int called = 0, after = 0;
+
+   src = efl_add_ref(efl_test_event_class_get(), NULL);
+   dst = efl_add_ref(efl_test_event_class_get(), NULL);
+
+   // dst has callbacks, but none for the forwarded event
+   efl_event_callback_add(dst, EFL_TEST_EVENT_EVENT_TESTER_SUBSCRIBE, _cb_count, &called);
+   efl_event_callback_forwarder_add(src, EFL_TEST_EVENT_EVENT_TESTER, dst);
+   efl_event_callback_priority_add(src, EFL_TEST_EVENT_EVENT_TESTER, EFL_CALLBACK_PRIORITY_AFTER, _cb_count, &after);
+
+   ck_assert_int_eq(efl_event_callback_call(src, EFL_TEST_EVENT_EVENT_TESTER, NULL), EINA_TRUE);
+   ck_assert_int_eq(after, 1);
+   ck_assert_int_eq(called, 0);
+
+   efl_unref(dst);
+   efl_unref(src);
+}
+EFL_END_TEST
 
 void eo_test_event(TCase *tc)
 {
    tcase_add_test(tc, eo_event);
    tcase_add_test(tc, eo_event_call_in_call);
    tcase_add_test(tc, eo_event_generation_bug);
+   tcase_add_test(tc, eo_event_call_no_match);
+   tcase_add_test(tc, eo_event_forwarder_no_match);
 }
 
 
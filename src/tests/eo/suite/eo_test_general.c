@@ -145,6 +145,127 @@ EFL_START_TEST(efl_object_override_tests)
 }
 EFL_END_TEST
 
+typedef struct
+{
+   int v;
+} Cache_Mixin_Data;
+
+EAPI void cache_mixin_v_set(Eo *obj, int v);
+EAPI int cache_mixin_v_get(const Eo *obj);
+
+EFL_VOID_FUNC_BODYV(cache_mixin_v_set, EFL_FUNC_CALL(v), int v);
+EFL_FUNC_BODY_CONST(cache_mixin_v_get, int, -1);
+
+static void
+_cache_mixin_v_set(Eo *obj EINA_UNUSED, void *class_data, int v)
+{
+   Cache_Mixin_Data *pd = class_data;
+
+   pd->v = v;
+}
+
+static int
+_cache_mixin_v_get(const Eo *obj EINA_UNUSED, void *class_data)
+{
+   Cache_Mixin_Data *pd = class_data;
+
+   return pd->v;
+}
+
+static Eina_Bool
+_cache_mixin_class_initializer(Efl_Class *klass)
+{
+   EFL_OPS_DEFINE(ops,
+         EFL_OBJECT_OP_FUNC(cache_mixin_v_set, _cache_mixin_v_set),
+         EFL_OBJECT_OP_FUNC(cache_mixin_v_get, _cache_mixin_v_get),
+   );
+
+   return efl_class_functions_set(klass, &ops, NULL);
+}
+
+EFL_START_TEST(efl_object_call_cache_tests)
+{
+   const Efl_Class *mixin, *klass1, *klass2;
+   Eo *objs[4];
+   int i, j;
+
+     {
+        static const Efl_Class_Description class_desc = {
+             EO_VERSION,
+             "Cache_Mixin",
+             EFL_CLASS_TYPE_MIXIN,
+             sizeof(Cache_Mixin_Data),
+             _cache_mixin_class_initializer,
+             NULL,
+             NULL
+        };
+
+        mixin = efl_class_new(&class_desc, NULL, NULL);
+        fail_if(!mixin);
+     }
+
+     {
+        static const Efl_Class_Description class_desc = {
+             EO_VERSION,
+             "Cache_Simple",
+             EFL_CLASS_TYPE_REGULAR,
+             24,
+             NULL,
+             NULL,
+             NULL
+        };
+
+        /* The mixin data ends up at different offsets in both classes */
+        klass1 = efl_class_new(&class_desc, EO_CLASS, mixin, NULL);
+        fail_if(!klass1);
+        klass2 = efl_class_new(&class_desc, SIMPLE_CLASS, mixin, NULL);
+        fail_if(!klass2);
+     }
+
+   objs[0] = efl_add_ref(klass1, NULL);
+   objs[1] = efl_add_ref(klass2, NULL);
+   objs[2] = efl_add_ref(klass1, NULL);
+   objs[3] = efl_add_ref(SIMPLE_CLASS, NULL);
+
+   /* The same functions are called on objects of alternating classes, each
+    * call has to use the function and data of its own object. */
+   for (i = 0; i < 3; i++)
+     {
+        for (j = 0; j < 3; j++)
+          cache_mixin_v_set(objs[j], (10 * i) + j);
+        for (j = 0; j < 3; j++)
+          {
+             Cache_Mixin_Data *pd = efl_data_scope_get(objs[j], mixin);
+
+             ck_assert_int_eq(pd->v, (10 * i) + j);
+             ck_assert_int_eq(cache_mixin_v_get(objs[j]), (10 * i) + j);
+          }
+     }
+
+   /* Overriding one object changes its calls only, until it is reset. */
+   EFL_OPS_DEFINE(
+            overrides,
+            EFL_OBJECT_OP_FUNC(simple_a_get, _simple_obj_override_a_get));
+   simple_a_set(objs[1], 1);
+   simple_a_set(objs[3], 3);
+   ck_assert_int_eq(simple_a_get(objs[1]), 1);
+   ck_assert_int_eq(simple_a_get(objs[3]), 3);
+   fail_if(!efl_object_override(objs[3], &overrides));
+   ck_assert_int_eq(simple_a_get(objs[1]), 1);
+   ck_assert_int_eq(simple_a_get(objs[3]), OVERRIDE_A + 3);
+   ck_assert_int_eq(simple_a_get(objs[3]), OVERRIDE_A + 3);
+   fail_if(!efl_object_override(objs[3], NULL));
+   ck_assert_int_eq(simple_a_get(objs[3]), 3);
+   ck_assert_int_eq(simple_a_get(objs[1]), 1);
+
+   /* Not implemented by the class, the cache must not make it work. */
+   ck_assert_int_eq(cache_mixin_v_get(objs[3]), -1);
+
+   for (i = 0; i < 4; i++)
+     efl_unref(objs[i]);
+}
+EFL_END_TEST
+
 static int _eo_signals_cb_current = 0;
 static int _eo_signals_cb_flag = 0;
 
@@ -1853,6 +1974,7 @@ void eo_test_general(TCase *tc)
    tcase_add_test(tc, eo_simple);
    tcase_add_test(tc, eo_singleton);
    tcase_add_test(tc, efl_object_override_tests);
+   tcase_add_test(tc, efl_object_call_cache_tests);
    tcase_add_test(tc, eo_test_class_replacement);
    tcase_add_test(tc, eo_signals);
    tcase_add_test(tc, efl_data_fetch);
@@ -4,6 +4,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #ifdef _WIN32
 #include "Evil.h"
@@ -231,6 +233,143 @@ EFL_START_TEST(owning)
 }
 EFL_END_TEST
 
+EFL_START_TEST(eolian_multiple_inputs)
+{
+   char dirpath[PATH_MAX] = "", command[3 * PATH_MAX] = "";
+   const char *names[] = { "typedef", "struct" };
+   unsigned int i;
+
+   snprintf(dirpath, sizeof(dirpath), "%s/eolian_multiple_inputs",
+            eina_environment_tmp_get());
+   mkdir(dirpath, S_IRWXU);
+
+   /* reference outputs, one input at a time */
+   for (i = 0; i < EINA_C_ARRAY_LENGTH(names); i++)
+     {
+        const char *base = eina_slstr_printf("%s/%s", dirpath, names[i]);
+
+        _remove_ref(base, "eo.h");
+        snprintf(command, sizeof(command),
+                 EOLIAN_GEN" -gh -S -I \""TESTS_SRC_DIR"/data\" -o %s "
+                 TESTS_SRC_DIR"/data/%s.eo", base, names[i]);
+        fail_if(0 != system(command));
+        /* the include guard comes from the output name, so rename after */
+        fail_if(0 != rename(eina_slstr_printf("%s.eo.h", base),
+                            eina_slstr_printf("%s.ref.h", base)));
+     }
+
+   snprintf(command, sizeof(command),
+            EOLIAN_GEN" -gh -S -I \""TESTS_SRC_DIR"/data\" -O %s "
+            TESTS_SRC_DIR"/data/%s.eo "TESTS_SRC_DIR"/data/%s.eo",
+            dirpath, names[0], names[1]);
+   fail_if(0 != system(command));
+   for (i = 0; i < EINA_C_ARRAY_LENGTH(names); i++)
+     {
+        const char *base = eina_slstr_printf("%s/%s", dirpath, names[i]);
+
+        fail_if(!_files_compare(eina_slstr_printf("%s.ref.h", base), base, "eo.h"));
+     }
+
+   /* a named dependency file holds a single rule for all of them */
+   snprintf(command, sizeof(command),
+            EOLIAN_GEN" -ghd -S -I \""TESTS_SRC_DIR"/data\" -O %s -o d:%s/all.d "
+            TESTS_SRC_DIR"/data/%s.eo "TESTS_SRC_DIR"/data/%s.eo",
+            dirpath, dirpath, names[0], names[1]);
+   fail_if(0 != system(command));
+   Eina_File *f = eina_file_open(eina_slstr_printf("%s/all.d", dirpath), EINA_FALSE);
+   fail_if(!f);
+   const char *deps = eina_file_map_all(f, EINA_FILE_POPULATE);
+   fail_if(!deps);
+   const char *target = eina_slstr_printf("%s/%s.eo.h:", dirpath, names[0]);
+   fail_if(strncmp(deps, target, strlen(target)));
+   eina_file_map_free(f, (void *)deps);
+   eina_file_close(f);
+
+   /* output names are ambiguous with several inputs */
+   snprintf(command, sizeof(command),
+            EOLIAN_GEN" -gh -S -I \""TESTS_SRC_DIR"/data\" -o %s/out "
+            TESTS_SRC_DIR"/data/%s.eo "TESTS_SRC_DIR"/data/%s.eo",
+            dirpath, names[0], names[1]);
+   fail_if(0 == system(command));
+}
+EFL_END_TEST
+
+static unsigned int
+_cache_files_damage(const char *dirpath)
+{
+   Eina_Iterator *itr = eina_file_direct_ls(dirpath);
+   const Eina_File_Direct_Info *info;
+   unsigned int count = 0;
+   FILE *f;
+
+   fail_if(!itr);
+   EINA_ITERATOR_FOREACH(itr, info)
+     {
+        fail_if(!(f = fopen(info->path, "r+b")));
+        fseek(f, 0, SEEK_END);
+        fseek(f, ftell(f) / 2, SEEK_SET);
+        fputs("garbage", f);
+        fclose(f);
+        count++;
+     }
+   eina_iterator_free(itr);
+   return count;
+}
+
+static void
+_cache_files_remove(const char *dirpath)
+{
+   Eina_Iterator *itr = eina_file_direct_ls(dirpath);
+   const Eina_File_Direct_Info *info;
+
+   if (!itr) return;
+   EINA_ITERATOR_FOREACH(itr, info)
+     remove(info->path);
+   eina_iterator_free(itr);
+}
+
+EFL_START_TEST(eolian_cache)
+{
+   char dirpath[PATH_MAX] = "", cachepath[PATH_MAX + 8] = "";
+   const char *options, *base;
+   int pass;
+
+   snprintf(dirpath, sizeof(dirpath), "%s/eolian_cache",
+            eina_environment_tmp_get());
+   mkdir(dirpath, S_IRWXU);
+   snprintf(cachepath, sizeof(cachepath), "%s/cache", dirpath);
+   _cache_files_remove(cachepath);
+
+   /* nothing cached, then all of it, then all of it broken */
+   for (pass = 0; pass < 3; pass++)
+     {
+        if (pass == 2)
+          fail_if(!_cache_files_damage(cachepath));
+
+        options = eina_slstr_printf("-gc -C %s", cachepath);
+        base = eina_slstr_printf("%s/eolian_override", dirpath);
+        _remove_ref(base, "eo.c");
+        fail_if(0 != _eolian_gen_execute(TESTS_SRC_DIR"/data/override.eo", options, base));
+        fail_if(!_files_compare(TESTS_SRC_DIR"/data/override_ref.c", base, "eo.c"));
+
+        base = eina_slstr_printf("%s/eolian_class_simple", dirpath);
+        _remove_ref(base, "eo.c");
+        fail_if(0 != _eolian_gen_execute(TESTS_SRC_DIR"/data/class_simple.eo", options, base));
+        fail_if(!_files_compare(TESTS_SRC_DIR"/data/class_simple_ref.c", base, "eo.c"));
+
+        /* the include guard comes from the output name */
+        options = eina_slstr_printf("-gh -C %s", cachepath);
+        base = eina_slstr_printf("%s/eolian_docs", dirpath);
+        _remove_ref(base, "eo.h");
+        fail_if(0 != _eolian_gen_execute(TESTS_SRC_DIR"/data/eo_docs.eo", options, base));
+        fail_if(!_files_compare(TESTS_SRC_DIR"/data/docs_ref.h", base, "eo.h"));
+     }
+
+   _cache_files_remove(cachepath);
+   rmdir(cachepath);
+}
+EFL_END_TEST
+
 void eolian_generation_test(TCase *tc)
 {
    tcase_add_test(tc, eolian_types_generation);
@@ -242,4 +381,6 @@ void eolian_generation_test(TCase *tc)
    tcase_add_test(tc, eolian_docs);
    tcase_add_test(tc, eolian_function_pointers);
    tcase_add_test(tc, owning);
+   tcase_add_test(tc, eolian_multiple_inputs);
+   tcase_add_test(tc, eolian_cache);
 }
@@ -19,6 +19,10 @@ static const Efl_Test_Case etc[] = {
   { "Filters", evas_test_filters },
   { "Images", evas_test_image_object },
   { "Images", evas_test_image_object2 },
+  { "Images Animated", evas_test_image_animated },
+  { "Scale", evas_test_scale },
+  { "YUV", evas_test_yuv },
+  { "Vector Graphics", evas_test_vg },
   { "Meshes", evas_test_mesh },
   { "Meshes", evas_test_mesh1 },
   { "Meshes", evas_test_mesh2 },
@@ -13,6 +13,10 @@ void evas_test_render_engines(TCase *tc);
 void evas_test_filters(TCase *tc);
 void evas_test_image_object(TCase *tc);
 void evas_test_image_object2(TCase *tc);
+void evas_test_image_animated(TCase *tc);
+void evas_test_scale(TCase *tc);
+void evas_test_yuv(TCase *tc);
+void evas_test_vg(TCase *tc);
 void evas_test_mesh(TCase *tc);
 void evas_test_mesh1(TCase *tc);
 void evas_test_mesh2(TCase *tc);
@@ -458,10 +458,107 @@ EFL_START_TEST(evas_filter_state_test)
 }
 EFL_END_TEST
 
+/* Neither size splits evenly in stripes, with the rows being split in the
+ * first pass of a blur and the columns in the second one. */
+#define PARALLEL_W 517
+#define PARALLEL_H 389
+
+static unsigned int *
+_filter_parallel_render(const char *code, Eina_Bool serial)
+{
+   Ecore_Evas *ee;
+   Evas *evas;
+   Evas_Object *o;
+   const unsigned int *pixels;
+   unsigned int *data, *ret;
+   size_t size = PARALLEL_W * PARALLEL_H * sizeof(unsigned int);
+   int x, y;
+
+   evas_common_parallel_serial_set(serial);
+
+   setenv("EVAS_DATA_DIR", EVAS_DATA_DIR, 1);
+   ee = ecore_evas_buffer_new(PARALLEL_W, PARALLEL_H);
+   ecore_evas_alpha_set(ee, EINA_TRUE);
+   ecore_evas_transparent_set(ee, EINA_TRUE);
+   ecore_evas_show(ee);
+   ecore_evas_manual_render_set(ee, EINA_TRUE);
+   evas = ecore_evas_get(ee);
+
+   o = evas_object_image_filled_add(evas);
+   evas_object_image_alpha_set(o, EINA_TRUE);
+   evas_object_image_size_set(o, PARALLEL_W, PARALLEL_H);
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   fail_if(!data);
+   for (y = 0; y < PARALLEL_H; y++)
+     for (x = 0; x < PARALLEL_W; x++)
+       {
+          if ((x / 13 + y / 7) & 1)
+            data[(y * PARALLEL_W) + x] = 0xff000000 | ((x & 0xff) << 16) |
+               ((y & 0xff) << 8) | ((x + y) & 0xff);
+          else
+            data[(y * PARALLEL_W) + x] = 0;
+       }
+   evas_object_image_data_set(o, data);
+   evas_object_image_data_update_add(o, 0, 0, PARALLEL_W, PARALLEL_H);
+   evas_object_move(o, 0, 0);
+   evas_object_resize(o, PARALLEL_W, PARALLEL_H);
+   evas_object_show(o);
+   efl_gfx_filter_program_set(o, code, "evas_test_filter_parallel");
+
+   ecore_evas_manual_render(ee);
+   pixels = ecore_evas_buffer_pixels_get(ee);
+   fail_if(!pixels);
+   ret = malloc(size);
+   fail_if(!ret);
+   memcpy(ret, pixels, size);
+
+   evas_object_del(o);
+   ecore_evas_free(ee);
+   evas_common_parallel_serial_set(EINA_FALSE);
+
+   return ret;
+}
+
+EFL_START_TEST(evas_filter_parallel_test)
+{
+   static const char *codes[] = {
+      "blur ({ 9, type = 'gaussian' })",
+      "blur ({ 12, 5, type = 'box' })",
+      "grow ({ 7 })",
+      "grow ({ -5 })",
+      "curve ({ '0:0-128:255-255:0' })",
+      "a = buffer ({ 'alpha' }) blend ({ dst = a }) blur ({ 6, src = a, dst = a }) blend ({ a })",
+      "a = buffer ({ 'rgba' }) grow ({ 10, dst = a }) blur ({ 5, src = a })",
+   };
+   unsigned int *serial, *parallel;
+   unsigned int k;
+   int i;
+
+   // Workers are started on first use, so there are some to split the
+   // stripes between even on a single cpu.
+   setenv("EVAS_COMMON_THREADS", "4", 1);
+   unsetenv("EVAS_FILTER_THREADS");
+
+   for (k = 0; k < EINA_C_ARRAY_LENGTH(codes); k++)
+     {
+        serial = _filter_parallel_render(codes[k], EINA_TRUE);
+        parallel = _filter_parallel_render(codes[k], EINA_FALSE);
+        for (i = 0; i < PARALLEL_W * PARALLEL_H; i++)
+          if (serial[i] != parallel[i])
+            ck_abort_msg("'%s' differs at %d,%d: %#x in the stripes, %#x "
+                         "serially", codes[k], i % PARALLEL_W, i / PARALLEL_W,
+                         parallel[i], serial[i]);
+        free(serial);
+        free(parallel);
+     }
+}
+EFL_END_TEST
+
 void evas_test_filters(TCase *tc)
 {
    tcase_add_test(tc, evas_filter_parser);
    tcase_add_test(tc, evas_filter_text_padding_test);
    tcase_add_test(tc, evas_filter_text_render_test);
    tcase_add_test(tc, evas_filter_state_test);
+   tcase_add_test(tc, evas_filter_parallel_test);
 }
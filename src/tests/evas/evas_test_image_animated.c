@@ -0,0 +1,148 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include "../../lib/evas/include/evas_common_private.h"
+#include <Ecore_Evas.h>
+
+#include "evas_suite.h"
+#include "evas_tests_helpers.h"
+
+#ifdef BUILD_LOADER_GIF
+static RGBA_Image *
+_animated_load(Eina_File *f, const char *key)
+{
+   RGBA_Image *im;
+   int error = EVAS_LOAD_ERROR_NONE;
+
+   im = evas_common_load_image_from_mmap(f, key, NULL, &error);
+   fail_if(!im);
+   fail_if(error != EVAS_LOAD_ERROR_NONE);
+   fail_if(!im->cache_entry.animated.animated);
+   return im;
+}
+
+// decode the given frame into the pixels of the image
+static DATA32 *
+_animated_frame_decode(RGBA_Image *im, int index)
+{
+   im->cache_entry.animated.cur_frame = index;
+   fail_if(evas_cache_image_load_data(&im->cache_entry) != EVAS_LOAD_ERROR_NONE);
+   fail_if(!im->image.data);
+   return im->image.data;
+}
+
+EFL_START_TEST(evas_image_animated_frame_index)
+{
+   Evas *e = _setup_evas();
+   Evas_Image_Animated *animated;
+   Image_Entry_Frame *frame;
+   RGBA_Image *im;
+   Eina_File *f;
+   int i, count;
+
+   f = eina_file_open(TESTS_SRC_DIR"/../../../data/elementary/images/fire.gif", EINA_FALSE);
+   fail_if(!f);
+   im = _animated_load(f, NULL);
+   animated = &im->cache_entry.animated;
+
+   count = animated->frame_count;
+   ck_assert_int_eq(count, 20);
+   ck_assert_int_eq(im->cache_entry.frames.count, count);
+   ck_assert_int_eq(eina_list_count(animated->frames), count);
+   for (i = 1; i <= count; i++)
+     {
+        frame = evas_common_load_animated_frame_get(animated, i);
+        fail_if(!frame);
+        fail_if(frame != im->cache_entry.frames.index[i]);
+        ck_assert_int_eq(frame->index, i);
+     }
+   fail_if(evas_common_load_animated_frame_get(animated, 0));
+   fail_if(evas_common_load_animated_frame_get(animated, count + 1));
+
+   evas_cache_image_drop(&im->cache_entry);
+   eina_file_close(f);
+   evas_free(e);
+}
+EFL_END_TEST
+
+EFL_START_TEST(evas_image_animated_gif_seek)
+{
+   Evas *e = _setup_evas();
+   Image_Entry_Frame *frame;
+   RGBA_Image *seq, *seek;
+   Image_Entry *ie;
+   Eina_File *f;
+   DATA32 **ref, *d;
+   int i, count, kept;
+   size_t size;
+
+   f = eina_file_open(TESTS_SRC_DIR"/../../../data/elementary/images/fire.gif", EINA_FALSE);
+   fail_if(!f);
+
+   // every frame decoded one after the other
+   seq = _animated_load(f, NULL);
+   count = seq->cache_entry.animated.frame_count;
+   fail_if(count < 4);
+   size = seq->cache_entry.w * seq->cache_entry.h * sizeof(DATA32);
+   ref = calloc(count + 1, sizeof(DATA32 *));
+   fail_if(!ref);
+   for (i = 1; i <= count; i++)
+     {
+        d = _animated_frame_decode(seq, i);
+        ref[i] = malloc(size);
+        fail_if(!ref[i]);
+        memcpy(ref[i], d, size);
+     }
+
+   // the key makes it another cache entry of the same file, the loader
+   // does not use it
+   seek = _animated_load(f, "seek");
+   ie = &seek->cache_entry;
+   d = _animated_frame_decode(seek, count);
+   fail_if(memcmp(d, ref[count], size));
+
+   // drop the second half, the loader is past it now so going back there
+   // starts from the image record of the first dropped frame
+   kept = count / 2;
+   SLKL(ie->lock);
+   for (i = kept + 1; i <= count; i++)
+     {
+        frame = evas_common_load_animated_frame_get(&ie->animated, i);
+        fail_if(!frame);
+        evas_common_load_animated_frame_data_set(&ie->animated, frame,
+                                                 NULL, 0, NULL);
+     }
+   SLKU(ie->lock);
+
+   d = _animated_frame_decode(seek, count - 1);
+   fail_if(memcmp(d, ref[count - 1], size));
+   for (i = kept + 1; i <= count; i++)
+     {
+        d = _animated_frame_decode(seek, i);
+        if (memcmp(d, ref[i], size))
+          ck_abort_msg("frame %i differs from the sequential decode", i);
+     }
+
+   for (i = 1; i <= count; i++)
+     free(ref[i]);
+   free(ref);
+   evas_cache_image_drop(&seek->cache_entry);
+   evas_cache_image_drop(&seq->cache_entry);
+   eina_file_close(f);
+   evas_free(e);
+}
+EFL_END_TEST
+#endif
+
+void evas_test_image_animated(TCase *tc)
+{
+#ifdef BUILD_LOADER_GIF
+   tcase_add_test(tc, evas_image_animated_frame_index);
+   tcase_add_test(tc, evas_image_animated_gif_seek);
+#else
+   (void)tc;
+#endif
+}
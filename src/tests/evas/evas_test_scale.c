@@ -0,0 +1,208 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../lib/evas/include/evas_common_private.h"
+
+#include "evas_suite.h"
+
+typedef struct _Scale_Size Scale_Size;
+struct _Scale_Size
+{
+   const char *name;
+   int w, h;
+};
+
+// 92x58 of a 97x61 source are scaled, one size per path of the smooth scaler
+static const Scale_Size _scale_sizes[] = {
+   { "up", 211, 143 },
+   { "down", 41, 29 },
+   { "downx", 41, 143 },
+   { "downy", 211, 29 },
+   { "noscale", 92, 58 },
+};
+
+#define SCALE_SRC_W 97
+#define SCALE_SRC_H 61
+
+// premultiplied pixels, the alpha ones may have any coverage
+static RGBA_Image *
+_scale_image_new(int w, int h, Eina_Bool alpha, unsigned int seed)
+{
+   RGBA_Image *im;
+   DATA32 *p;
+   int i;
+
+   im = evas_common_image_new(w, h, alpha);
+   fail_if(!im);
+   fail_if(!im->image.data);
+   p = im->image.data;
+   for (i = 0; i < w * h; i++)
+     {
+        unsigned int a, r, g, b;
+
+        seed = seed * 1103515245 + 12345;
+        a = alpha ? ((seed >> 24) & 0xff) : 0xff;
+        r = ((seed >> 16) & 0xff) * a / 255;
+        g = ((seed >> 8) & 0xff) * a / 255;
+        b = ((seed >> 4) & 0xff) * a / 255;
+        // some fully transparent and opaque runs too
+        if (alpha && ((i / 37) % 5 == 1)) a = r = g = b = 0;
+        else if (alpha && ((i / 37) % 5 == 3)) a = 0xff;
+        p[i] = (a << 24) | (r << 16) | (g << 8) | b;
+     }
+   return im;
+}
+
+static RGBA_Image *
+_scale_run(Evas_Common_Scale_In_To_Out_Clip_Cb cb, RGBA_Image *src,
+           RGBA_Draw_Context *dc, int w, int h)
+{
+   RGBA_Image *dst;
+
+   // the same translucent background every time, for the blend op
+   dst = _scale_image_new(w + 6, h + 4, EINA_TRUE, 7);
+   cb(src, dst, dc, 3, 2, SCALE_SRC_W - 5, SCALE_SRC_H - 3, 3, 2, w, h);
+   return dst;
+}
+
+static void
+_scale_compare(RGBA_Image *ref, RGBA_Image *im, const char *path,
+               const Scale_Size *size, Eina_Bool alpha, int op, Eina_Bool mul)
+{
+   DATA32 *a = ref->image.data, *b = im->image.data;
+   int i, c, len = ref->cache_entry.w * ref->cache_entry.h;
+
+   for (i = 0; i < len; i++)
+     for (c = 0; c < 32; c += 8)
+       {
+          int d = (int)((a[i] >> c) & 0xff) - (int)((b[i] >> c) & 0xff);
+
+          if ((d > 1) || (d < -1))
+            ck_abort_msg("%s %s (alpha %i, op %i, mul %i) differs by %i at "
+                         "%d,%d: %#x, %#x in C", path, size->name, alpha, op,
+                         mul, d, i % ref->cache_entry.w,
+                         i / ref->cache_entry.w, b[i], a[i]);
+       }
+}
+
+static void
+_scale_simd_check(Evas_Common_Scale_In_To_Out_Clip_Cb cb, const char *path)
+{
+   static const int ops[] = { EVAS_RENDER_BLEND, EVAS_RENDER_COPY };
+   RGBA_Draw_Context *dc;
+   RGBA_Image *src, *ref, *im;
+   unsigned int k, o;
+   int alpha, mul;
+
+   for (alpha = 0; alpha <= 1; alpha++)
+     {
+        src = _scale_image_new(SCALE_SRC_W, SCALE_SRC_H, alpha, 42);
+        for (o = 0; o < EINA_C_ARRAY_LENGTH(ops); o++)
+          for (mul = 0; mul <= 1; mul++)
+            for (k = 0; k < EINA_C_ARRAY_LENGTH(_scale_sizes); k++)
+              {
+                 dc = evas_common_draw_context_new();
+                 evas_common_draw_context_set_render_op(dc, ops[o]);
+                 if (mul)
+                   evas_common_draw_context_set_multiplier(dc, 200, 120, 90, 210);
+                 // cuts into the scaled region on the left and bottom
+                 evas_common_draw_context_set_clip(dc, 9, 0,
+                                                   _scale_sizes[k].w,
+                                                   _scale_sizes[k].h - 1);
+
+                 ref = _scale_run(evas_common_scale_rgba_in_to_out_clip_smooth_c,
+                                  src, dc, _scale_sizes[k].w, _scale_sizes[k].h);
+                 im = _scale_run(cb, src, dc, _scale_sizes[k].w, _scale_sizes[k].h);
+                 _scale_compare(ref, im, path, &_scale_sizes[k], alpha, ops[o], mul);
+
+                 evas_common_rgba_image_free(&im->cache_entry);
+                 evas_common_rgba_image_free(&ref->cache_entry);
+                 evas_common_draw_context_free(dc);
+              }
+        evas_common_rgba_image_free(&src->cache_entry);
+     }
+}
+
+EFL_START_TEST(evas_scale_smooth_simd)
+{
+   Eina_Cpu_Features features EINA_UNUSED = eina_cpu_features_get();
+
+#ifdef BUILD_SSE41
+   if (features & EINA_CPU_SSE41)
+     _scale_simd_check(evas_common_scale_rgba_in_to_out_clip_smooth_sse41, "sse4.1");
+#endif
+#ifdef BUILD_AVX2
+   if (features & EINA_CPU_AVX2)
+     _scale_simd_check(evas_common_scale_rgba_in_to_out_clip_smooth_avx2, "avx2");
+#endif
+}
+EFL_END_TEST
+
+// more than MIN_BAND_SRC_SIZE source pixels, the destination rows are not
+// a multiple of the bands
+#define BAND_SRC_W 1031
+#define BAND_SRC_H 977
+#define BAND_DST_W 517
+#define BAND_DST_H 389
+
+static RGBA_Image *
+_scale_banded_run(RGBA_Image *src, Eina_Bool threads, int clip_y, int clip_h)
+{
+   RGBA_Draw_Context *dc;
+   RGBA_Image *dst;
+
+   evas_common_rgba_image_scalecache_threads_set(threads);
+   // nothing scaled before may be reused
+   evas_common_rgba_image_scalecache_flush();
+
+   dc = evas_common_draw_context_new();
+   evas_common_draw_context_set_render_op(dc, EVAS_RENDER_BLEND);
+   evas_common_draw_context_set_clip(dc, 0, clip_y, BAND_DST_W, clip_h);
+   dst = _scale_image_new(BAND_DST_W, BAND_DST_H + 3, EINA_TRUE, 7);
+   evas_common_rgba_image_scalecache_do(&src->cache_entry, dst, dc, 1,
+                                        0, 0, BAND_SRC_W, BAND_SRC_H,
+                                        0, 1, BAND_DST_W, BAND_DST_H);
+   evas_common_draw_context_free(dc);
+
+   evas_common_rgba_image_scalecache_threads_set(EINA_FALSE);
+   return dst;
+}
+
+EFL_START_TEST(evas_scale_smooth_banded)
+{
+   // whole region, then a clip that starts and ends in the middle of bands
+   static const int clips[][2] = { { 0, BAND_DST_H + 3 }, { 23, 331 } };
+   RGBA_Image *src, *serial, *banded;
+   unsigned int k;
+   int i, len = BAND_DST_W * (BAND_DST_H + 3);
+
+   // Workers are started on first use, so there are some to split the
+   // bands between even on a single cpu.
+   setenv("EVAS_COMMON_THREADS", "4", 1);
+
+   src = _scale_image_new(BAND_SRC_W, BAND_SRC_H, EINA_TRUE, 42);
+   for (k = 0; k < EINA_C_ARRAY_LENGTH(clips); k++)
+     {
+        serial = _scale_banded_run(src, EINA_FALSE, clips[k][0], clips[k][1]);
+        banded = _scale_banded_run(src, EINA_TRUE, clips[k][0], clips[k][1]);
+        for (i = 0; i < len; i++)
+          if (serial->image.data[i] != banded->image.data[i])
+            ck_abort_msg("clip %i differs at %d,%d: %#x in the bands, %#x "
+                         "serially", k, i % BAND_DST_W, i / BAND_DST_W,
+                         banded->image.data[i], serial->image.data[i]);
+        evas_common_rgba_image_free(&banded->cache_entry);
+        evas_common_rgba_image_free(&serial->cache_entry);
+     }
+   evas_common_rgba_image_free(&src->cache_entry);
+}
+EFL_END_TEST
+
+void evas_test_scale(TCase *tc)
+{
+   tcase_add_test(tc, evas_scale_smooth_simd);
+   tcase_add_test(tc, evas_scale_smooth_banded);
+}
@@ -4,6 +4,7 @@
 #endif
 
 #include <stdio.h>
+#include <unistd.h>
 
 #include <Evas.h>
 #include <Ecore_Evas.h>
@@ -681,6 +682,199 @@ EFL_START_TEST(evas_text_font_load)
 }
 EFL_END_TEST
 
+#define GLYPH_CACHE_W 300
+#define GLYPH_CACHE_H 40
+
+/* Renders a line of text, the font instance is freed before returning so
+ * that its glyphs are saved to the cache */
+static unsigned int *
+_glyph_cache_render(void)
+{
+   Ecore_Evas *ee;
+   Evas *evas;
+   Evas_Object *bg, *to;
+   const unsigned int *pixels;
+   unsigned int *ret;
+   size_t size = GLYPH_CACHE_W * GLYPH_CACHE_H * sizeof(unsigned int);
+
+   ee = ecore_evas_buffer_new(GLYPH_CACHE_W, GLYPH_CACHE_H);
+   ecore_evas_show(ee);
+   ecore_evas_manual_render_set(ee, EINA_TRUE);
+   evas = ecore_evas_get(ee);
+   evas_font_hinting_set(evas, EVAS_FONT_HINTING_AUTO);
+
+   bg = evas_object_rectangle_add(evas);
+   evas_object_resize(bg, GLYPH_CACHE_W, GLYPH_CACHE_H);
+   evas_object_show(bg);
+
+   to = evas_object_text_add(evas);
+   evas_object_text_font_source_set(to, TEST_FONT_SOURCE);
+   evas_object_text_font_set(to, TEST_FONT_NAME, 20);
+   evas_object_text_text_set(to, "Glyph cache: 0123456789 QWERTY");
+   evas_object_color_set(to, 0, 0, 0, 255);
+   evas_object_move(to, 2, 2);
+   evas_object_show(to);
+
+   ecore_evas_manual_render(ee);
+   pixels = ecore_evas_buffer_pixels_get(ee);
+   fail_if(!pixels);
+   ret = malloc(size);
+   fail_if(!ret);
+   memcpy(ret, pixels, size);
+
+   // the objects are only freed by the next render
+   evas_object_del(to);
+   evas_object_del(bg);
+   ecore_evas_manual_render(ee);
+   evas_font_cache_flush(evas);
+   ecore_evas_free(ee);
+
+   return ret;
+}
+
+static void
+_glyph_cache_render_check(const unsigned int *ref, const char *what)
+{
+   unsigned int *pixels;
+   int i;
+
+   pixels = _glyph_cache_render();
+   for (i = 0; i < GLYPH_CACHE_W * GLYPH_CACHE_H; i++)
+     if (pixels[i] != ref[i])
+       ck_abort_msg("%s: text differs at %d,%d (%#x instead of %#x)", what,
+                    i % GLYPH_CACHE_W, i / GLYPH_CACHE_W, pixels[i], ref[i]);
+   free(pixels);
+}
+
+/* Only one font instance is rendered, with one hinting, so one file */
+static char *
+_glyph_cache_file_get(const char *dir)
+{
+   Eina_Iterator *it;
+   const char *path;
+   char *file = NULL;
+   int count = 0;
+
+   it = eina_file_ls(dir);
+   fail_if(!it);
+   EINA_ITERATOR_FOREACH(it, path)
+     {
+        if (eina_str_has_extension(path, ".glyphs"))
+          {
+             free(file);
+             file = strdup(path);
+             count++;
+          }
+        eina_stringshare_del(path);
+     }
+   eina_iterator_free(it);
+   ck_assert_int_eq(count, 1);
+
+   return file;
+}
+
+/* The header is magic, version, key size and glyph count */
+static void
+_glyph_cache_header_get(const char *file, unsigned int header[4])
+{
+   FILE *f;
+
+   f = fopen(file, "rb");
+   fail_if(!f);
+   fail_if(fread(header, sizeof(unsigned int), 4, f) != 4);
+   fclose(f);
+}
+
+static void
+_glyph_cache_write(const char *file, long offset, const void *data, size_t size)
+{
+   FILE *f;
+
+   f = fopen(file, "r+b");
+   fail_if(!f);
+   fail_if(fseek(f, offset, SEEK_SET));
+   fail_if(fwrite(data, size, 1, f) != 1);
+   fclose(f);
+}
+
+/* A broken file is ignored, the glyphs are rendered again and the file is
+ * replaced by a valid one */
+static void
+_glyph_cache_valid_check(const char *file, unsigned int version, unsigned int count)
+{
+   unsigned int header[4];
+
+   _glyph_cache_header_get(file, header);
+   ck_assert_int_eq(header[1], version);
+   ck_assert_int_eq(header[3], count);
+}
+
+EFL_START_TEST(evas_text_glyph_cache)
+{
+   unsigned int header[4], garbage[64];
+   unsigned int *ref;
+   Eina_Tmpstr *dir;
+   Eina_File *f;
+   char *file;
+   size_t size;
+
+   unsetenv("EVAS_FONT_GLYPH_CACHE_DIR");
+   ref = _glyph_cache_render();
+
+   fail_if(!eina_file_mkdtemp("evas_glyph_cache_XXXXXX", &dir));
+   setenv("EVAS_FONT_GLYPH_CACHE_DIR", dir, 1);
+
+   // Round trip: rendered and saved, then drawn from the mapped file
+   _glyph_cache_render_check(ref, "empty cache");
+   file = _glyph_cache_file_get(dir);
+   _glyph_cache_header_get(file, header);
+   fail_if(header[3] == 0);
+   _glyph_cache_render_check(ref, "filled cache");
+   _glyph_cache_valid_check(file, header[1], header[3]);
+
+   // Written by another version
+   header[1]++;
+   _glyph_cache_write(file, 0, header, sizeof(header));
+   _glyph_cache_render_check(ref, "other version");
+   _glyph_cache_valid_check(file, header[1] - 1, header[3]);
+   header[1]--;
+
+   // Stale: the key is of another font (or an older one at that path)
+   _glyph_cache_write(file, sizeof(header), "stale", 5);
+   _glyph_cache_render_check(ref, "stale key");
+   _glyph_cache_valid_check(file, header[1], header[3]);
+
+   // Corrupt: the entries do not fit in the file anymore
+   f = eina_file_open(file, EINA_FALSE);
+   fail_if(!f);
+   size = eina_file_size_get(f);
+   eina_file_close(f);
+   fail_if(truncate(file, sizeof(header) + header[2] + 8));
+   _glyph_cache_render_check(ref, "truncated");
+   _glyph_cache_valid_check(file, header[1], header[3]);
+
+   // Corrupt: garbage instead of the glyph entries
+   memset(garbage, 0xff, sizeof(garbage));
+   _glyph_cache_write(file, sizeof(header) + header[2], garbage, sizeof(garbage));
+   _glyph_cache_render_check(ref, "garbage entries");
+   _glyph_cache_valid_check(file, header[1], header[3]);
+
+   // And it is still the same file as the first one saved
+   f = eina_file_open(file, EINA_FALSE);
+   fail_if(!f);
+   ck_assert_int_eq(eina_file_size_get(f), size);
+   eina_file_close(f);
+   _glyph_cache_render_check(ref, "rewritten cache");
+
+   unsetenv("EVAS_FONT_GLYPH_CACHE_DIR");
+   unlink(file);
+   free(file);
+   rmdir(dir);
+   eina_tmpstr_del(dir);
+   free(ref);
+}
+EFL_END_TEST
+
 void evas_test_text(TCase *tc)
 {
    tcase_add_test(tc, evas_text_simple);
@@ -696,4 +890,5 @@ void evas_test_text(TCase *tc)
    tcase_add_test(tc, evas_text_unrelated);
    tcase_add_test(tc, evas_text_render);
    tcase_add_test(tc, evas_text_font_load);
+   tcase_add_test(tc, evas_text_glyph_cache);
 }
@@ -0,0 +1,86 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include "../../lib/evas/include/evas_common_private.h"
+#include "../../lib/evas/include/evas_private.h"
+#include "../../lib/evas/canvas/evas_vg_private.h"
+
+#include "evas_suite.h"
+#include "evas_tests_helpers.h"
+
+#define TESTS_IMG_DIR TESTS_SRC_DIR"/images"
+
+static void
+_vg_raster_free(void *data, void *raster EINA_UNUSED)
+{
+   int *freed = data;
+
+   (*freed)++;
+}
+
+static Evas_Object *
+_vg_file_add(Evas *e)
+{
+   Evas_Object *o;
+
+   o = evas_object_vg_add(e);
+   evas_object_resize(o, 48, 48);
+   fail_if(!efl_file_simple_load(o, TESTS_IMG_DIR"/vg_rect.svg", NULL));
+   return o;
+}
+
+static Vg_Cache_Entry *
+_vg_entry_get(Evas_Object *o)
+{
+   Efl_Canvas_Vg_Object_Data *pd;
+
+   pd = efl_data_scope_get(o, EFL_CANVAS_VG_OBJECT_CLASS);
+   fail_if(!pd || !pd->vg_entry);
+   return pd->vg_entry;
+}
+
+// Rasters are cached under the vg entry they were drawn from, they must go
+// with the entry whoever releases it last, or a new entry at the same
+// address would be drawn with them.
+EFL_START_TEST(evas_vg_raster_cache_entry_free)
+{
+   Evas *e = _setup_evas();
+   Generic_Cache *cache;
+   Evas_Object *o1, *o2;
+   Vg_Cache_Entry *entry;
+   int raster, freed = 0;
+
+   cache = generic_cache_new(&freed, _vg_raster_free);
+   fail_if(!cache);
+
+   // same file at the same size, the objects share the entry
+   o1 = _vg_file_add(e);
+   o2 = _vg_file_add(e);
+   entry = _vg_entry_get(o1);
+   fail_if(_vg_entry_get(o2) != entry);
+
+   generic_cache_data_set(cache, entry, &raster, 48 * 48 * 4);
+   generic_cache_data_drop(cache, entry);
+
+   evas_object_del(o1);
+   ck_assert_int_eq(freed, 0);
+   fail_if(generic_cache_data_get(cache, entry) != &raster);
+   generic_cache_data_drop(cache, entry);
+
+   evas_object_del(o2);
+   ck_assert_int_eq(freed, 1);
+   fail_if(generic_cache_data_get(cache, entry));
+
+   generic_cache_destroy(cache);
+   ck_assert_int_eq(freed, 1);
+   evas_free(e);
+}
+EFL_END_TEST
+
+void evas_test_vg(TCase *tc)
+{
+   tcase_add_test(tc, evas_vg_raster_cache_entry_free);
+}
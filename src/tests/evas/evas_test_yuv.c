@@ -0,0 +1,326 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../../lib/evas/include/evas_common_private.h"
+
+#include "evas_suite.h"
+
+/* Largest difference per channel with the exact formula below. The SIMD
+ * row converters work in 16.16 fixed point and are off by one at most.
+ * The whole frame converters used without them are not checked: their
+ * lookup tables truncate each term, the MMX one only has 10.6 bits. */
+#define YUV_TOLERANCE 1
+
+// not a multiple of the 8 or 16 pixels of the SIMD loops
+#define YUV_W 46
+#define YUV_H 14
+
+typedef enum
+{
+   YUV_YV12,
+   YUV_YV12_709,
+   YUV_NV12,
+   YUV_YUY2
+} Yuv_Format;
+
+static const char *_yuv_names[] = { "yv12", "yv12 709", "nv12", "yuy2" };
+
+typedef struct _Yuv_Frame Yuv_Frame;
+struct _Yuv_Frame
+{
+   Yuv_Format format;
+   int w, h;
+   DATA8 **rows;
+   DATA8 *y, *u, *v;   // the planes, u and v are interleaved for nv12
+   DATA8 *data;
+};
+
+static Eina_Bool
+_yuv_rows_available(void)
+{
+   Eina_Cpu_Features features EINA_UNUSED = eina_cpu_features_get();
+
+#ifdef BUILD_AVX2
+   if (features & EINA_CPU_AVX2) return EINA_TRUE;
+#endif
+#ifdef BUILD_SSE3
+   if (features & EINA_CPU_SSE3) return EINA_TRUE;
+#endif
+#ifdef BUILD_NEON_INTRINSICS
+   if (features & EINA_CPU_NEON) return EINA_TRUE;
+#endif
+   return EINA_FALSE;
+}
+
+static int
+_yuv_channel(double c)
+{
+   c = floor(c + 0.5);
+   if (c < 0) return 0;
+   if (c > 255) return 255;
+   return c;
+}
+
+static DATA32
+_yuv_pixel_ref(int y, int u, int v, Eina_Bool bt709)
+{
+   double yy = 1.164 * (y - 16);
+   int r, g, b;
+
+   u -= 128;
+   v -= 128;
+   if (bt709)
+     {
+        r = _yuv_channel(yy + 1.793 * v);
+        g = _yuv_channel(yy - 0.534 * v - 0.213 * u);
+        b = _yuv_channel(yy + 2.115 * u);
+     }
+   else
+     {
+        r = _yuv_channel(yy + 1.596 * v);
+        g = _yuv_channel(yy - 0.813 * v - 0.391 * u);
+        b = _yuv_channel(yy + 2.018 * u);
+     }
+   return 0xff000000 | (r << 16) | (g << 8) | b;
+}
+
+// every value of Y and ramps of U and V, then noise
+static void
+_yuv_frame_fill(Yuv_Frame *f, unsigned int seed)
+{
+   int x, y, i = 0;
+
+   for (y = 0; y < f->h; y++)
+     for (x = 0; x < f->w; x++, i++)
+       {
+          seed = seed * 1103515245 + 12345;
+          f->y[(y * f->w) + x] = (i < 256) ? i : (seed >> 16);
+          if ((y & 1) || (x & 1)) continue;
+          if (f->format == YUV_NV12)
+            {
+               f->u[(y / 2) * f->w + x] = (i < 256) ? 255 - i : (seed >> 8);
+               f->u[(y / 2) * f->w + x + 1] = (i < 256) ? i : (seed >> 24);
+            }
+          else
+            {
+               f->u[(y / 2) * (f->w / 2) + (x / 2)] = (i < 256) ? 255 - i : (seed >> 8);
+               f->v[(y / 2) * (f->w / 2) + (x / 2)] = (i < 256) ? i : (seed >> 24);
+            }
+       }
+}
+
+static void
+_yuv_frame_new(Yuv_Frame *f, Yuv_Format format, int w, int h)
+{
+   int i;
+
+   f->format = format;
+   f->w = w;
+   f->h = h;
+   f->data = malloc(w * h * 2);
+   f->rows = malloc(2 * h * sizeof(DATA8 *));
+   fail_if(!f->data || !f->rows);
+   f->y = f->data;
+   f->u = f->y + (w * h);
+   f->v = f->u + ((w / 2) * (h / 2));
+   if (format == YUV_YUY2) return;
+
+   for (i = 0; i < h; i++)
+     f->rows[i] = f->y + (i * w);
+   for (i = 0; i < h / 2; i++)
+     {
+        if (format == YUV_NV12)
+          f->rows[h + i] = f->u + (i * w);
+        else
+          {
+             f->rows[h + i] = f->u + (i * (w / 2));
+             f->rows[h + (h / 2) + i] = f->v + (i * (w / 2));
+          }
+     }
+}
+
+// yuy2 is made of the planes once they are filled
+static void
+_yuv_frame_pack(Yuv_Frame *f)
+{
+   DATA8 *p, *yuy2;
+   int x, y;
+
+   if (f->format != YUV_YUY2) return;
+   yuy2 = malloc(f->w * f->h * 2);
+   fail_if(!yuy2);
+   for (y = 0; y < f->h; y++)
+     {
+        p = yuy2 + (y * f->w * 2);
+        f->rows[y] = p;
+        for (x = 0; x < f->w; x += 2, p += 4)
+          {
+             p[0] = f->y[(y * f->w) + x];
+             p[1] = f->u[(y / 2) * (f->w / 2) + (x / 2)];
+             p[2] = f->y[(y * f->w) + x + 1];
+             p[3] = f->v[(y / 2) * (f->w / 2) + (x / 2)];
+          }
+     }
+   free(f->data);
+   f->data = yuy2;
+}
+
+static void
+_yuv_frame_free(Yuv_Frame *f)
+{
+   free(f->rows);
+   free(f->data);
+}
+
+static DATA32 *
+_yuv_convert(Yuv_Frame *f)
+{
+   DATA32 *rgba;
+
+   rgba = malloc(f->w * f->h * sizeof(DATA32));
+   fail_if(!rgba);
+   switch (f->format)
+     {
+      case YUV_YV12:
+        evas_common_convert_yuv_422p_601_rgba(f->rows, (DATA8 *)rgba, f->w, f->h);
+        break;
+      case YUV_YV12_709:
+        evas_common_convert_yuv_422p_709_rgba(f->rows, (DATA8 *)rgba, f->w, f->h);
+        break;
+      case YUV_NV12:
+        evas_common_convert_yuv_420_601_rgba(f->rows, (DATA8 *)rgba, f->w, f->h);
+        break;
+      case YUV_YUY2:
+        evas_common_convert_yuv_422_601_rgba(f->rows, (DATA8 *)rgba, f->w, f->h);
+        break;
+     }
+   return rgba;
+}
+
+// only valid before _yuv_frame_pack(), which frees the planes of yuy2
+static DATA32 *
+_yuv_reference(Yuv_Frame *f)
+{
+   DATA32 *rgba;
+   int x, y, u, v;
+
+   rgba = malloc(f->w * f->h * sizeof(DATA32));
+   fail_if(!rgba);
+   for (y = 0; y < f->h; y++)
+     for (x = 0; x < f->w; x++)
+       {
+          if (f->format == YUV_NV12)
+            {
+               u = f->u[(y / 2) * f->w + (x & ~1)];
+               v = f->u[(y / 2) * f->w + (x & ~1) + 1];
+            }
+          else
+            {
+               u = f->u[(y / 2) * (f->w / 2) + (x / 2)];
+               v = f->v[(y / 2) * (f->w / 2) + (x / 2)];
+            }
+          rgba[(y * f->w) + x] = _yuv_pixel_ref(f->y[(y * f->w) + x], u, v,
+                                                f->format == YUV_YV12_709);
+       }
+   return rgba;
+}
+
+static void
+_yuv_compare(const Yuv_Frame *f, const DATA32 *ref, const DATA32 *rgba)
+{
+   Eina_Bool checked = _yuv_rows_available();
+   int i, c;
+
+   for (i = 0; i < f->w * f->h; i++)
+     {
+        if ((rgba[i] >> 24) != 0xff)
+          ck_abort_msg("%s: pixel %d,%d is not opaque: %#x",
+                       _yuv_names[f->format], i % f->w, i / f->w, rgba[i]);
+        if (!checked) continue;
+        for (c = 0; c < 24; c += 8)
+          {
+             int d = (int)((ref[i] >> c) & 0xff) - (int)((rgba[i] >> c) & 0xff);
+
+             if ((d > YUV_TOLERANCE) || (d < -YUV_TOLERANCE))
+               ck_abort_msg("%s: pixel %d,%d is off by %d: %#x, %#x expected",
+                            _yuv_names[f->format], i % f->w, i / f->w, d,
+                            rgba[i], ref[i]);
+          }
+     }
+}
+
+EFL_START_TEST(evas_yuv_convert)
+{
+   Yuv_Frame f;
+   DATA32 *ref, *rgba;
+   int format;
+
+   for (format = YUV_YV12; format <= YUV_YUY2; format++)
+     {
+        _yuv_frame_new(&f, format, YUV_W, YUV_H);
+        _yuv_frame_fill(&f, 42);
+        ref = _yuv_reference(&f);
+        _yuv_frame_pack(&f);
+
+        rgba = _yuv_convert(&f);
+        _yuv_compare(&f, ref, rgba);
+
+        free(rgba);
+        free(ref);
+        _yuv_frame_free(&f);
+     }
+}
+EFL_END_TEST
+
+// enough pixels to be split, the rows are not a multiple of the bands
+#define YUV_BIG_W 662
+#define YUV_BIG_H 494
+
+EFL_START_TEST(evas_yuv_convert_parallel)
+{
+   Yuv_Frame f;
+   DATA32 *ref, *serial, *parallel;
+   int format, i;
+
+   // Read on the first conversion. Workers are started on first use, so
+   // there are some to split the rows between even on a single cpu.
+   setenv("EVAS_YUV_THREADS", "1", 1);
+   setenv("EVAS_COMMON_THREADS", "4", 1);
+
+   for (format = YUV_YV12; format <= YUV_YUY2; format++)
+     {
+        _yuv_frame_new(&f, format, YUV_BIG_W, YUV_BIG_H);
+        _yuv_frame_fill(&f, 7);
+        ref = _yuv_reference(&f);
+        _yuv_frame_pack(&f);
+
+        evas_common_parallel_serial_set(EINA_TRUE);
+        serial = _yuv_convert(&f);
+        evas_common_parallel_serial_set(EINA_FALSE);
+        parallel = _yuv_convert(&f);
+
+        _yuv_compare(&f, ref, parallel);
+        for (i = 0; i < f.w * f.h; i++)
+          if (serial[i] != parallel[i])
+            ck_abort_msg("%s differs at %d,%d: %#x in the bands, %#x "
+                         "serially", _yuv_names[format], i % f.w, i / f.w,
+                         parallel[i], serial[i]);
+
+        free(parallel);
+        free(serial);
+        free(ref);
+        _yuv_frame_free(&f);
+     }
+}
+EFL_END_TEST
+
+void evas_test_yuv(TCase *tc)
+{
+   tcase_add_test(tc, evas_yuv_convert);
+   tcase_add_test(tc, evas_yuv_convert_parallel);
+}